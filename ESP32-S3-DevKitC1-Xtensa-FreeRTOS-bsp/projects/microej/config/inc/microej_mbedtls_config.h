@@ -9,6 +9,9 @@
 // Define maximum certificate length to 4 (2 intermediate + 1 leaf + 1 root)
 #define MBEDTLS_X509_MAX_INTERMEDIATE_CA 2
 
+// HKDF (RFC 5869) for the session key schedules, see LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract/expand
+#define MBEDTLS_HKDF_C
+
 // Use microej allocator to allocate SSL contextes in external ram
 #include <time.h>
 
@@ -227,6 +227,9 @@ static int32_t LLECOM_NETWORK_async_exec_netif_context(int8_t* netifName, int32_
  */
 static int32_t LLECOM_NETWORK_async_exec_netif_context_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_netif_context_t* params = (ECOM_NETWORK_netif_context_t*)job->params;
 
 	(void)netifName;
@@ -316,6 +319,9 @@ static int32_t LLECOM_NETWORK_async_exec_dns_context(int8_t* netifName, int32_t
  */
 static int32_t LLECOM_NETWORK_async_exec_get_dns_context_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t* address, int32_t addressOffset, int32_t addressLength, int32_t index, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_dns_context_t* params = (ECOM_NETWORK_dns_context_t*)job->params;
 
 	(void)netifName;
@@ -353,6 +359,9 @@ static int32_t LLECOM_NETWORK_async_exec_get_dns_context_on_done(int8_t* netifNa
  */
 static int32_t LLECOM_NETWORK_async_exec_set_dns_context_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t* address, int32_t addressOffset, int32_t addressLength, int32_t index, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_dns_context_t* params = (ECOM_NETWORK_dns_context_t*)job->params;
 
 	(void)netifName;
@@ -445,6 +454,9 @@ static int32_t LLECOM_NETWORK_async_exec_ip_context(int8_t* netifName, int32_t n
  */
 static int32_t LLECOM_NETWORK_async_exec_get_ip_context_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t* address, int32_t addressOffset, int32_t addressLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_ip_context_t* params = (ECOM_NETWORK_ip_context_t*)job->params;
 
 	(void)netifName;
@@ -482,6 +494,9 @@ static int32_t LLECOM_NETWORK_async_exec_get_ip_context_on_done(int8_t* netifNam
  */
 static int32_t LLECOM_NETWORK_async_exec_set_ip_context_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t* address, int32_t addressOffset, int32_t addressLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_ip_context_t* params = (ECOM_NETWORK_ip_context_t*)job->params;
 
 	(void)netifName;
@@ -562,6 +577,9 @@ static int32_t LLECOM_NETWORK_async_exec_ip_config(int8_t* netifName, int32_t ne
  */
 static int32_t LLECOM_NETWORK_async_exec_ip_config_on_done(int8_t* netifName, int32_t netifNameOffset, int32_t netifNameLength, int8_t use, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_NETWORK_ERROR;
+	}
 	ECOM_NETWORK_ip_config_t* params = (ECOM_NETWORK_ip_config_t*)job->params;
 
 	(void)netifName;
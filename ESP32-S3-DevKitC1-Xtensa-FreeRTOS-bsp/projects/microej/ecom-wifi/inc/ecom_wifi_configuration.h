@@ -31,7 +31,7 @@
  * This value must not be changed by the user of the CCO.
  * This value must be incremented by the implementor of the CCO when a configuration define is added, deleted or modified.
  */
-#define ECOM_WIFI_CONFIGURATION_VERSION (2)
+#define ECOM_WIFI_CONFIGURATION_VERSION (3)
 
 /**
  * @brief Use this macro to define the initialization function of the wifi stack.
@@ -82,6 +82,13 @@ extern MICROEJ_ASYNC_WORKER_handle_t ecom_wifi_worker;
  */
 #define ECOM_WIFI_WORKER_PRIORITY (6)
 
+/**
+ * @brief Maximum time in milliseconds a Java thread waits for the count of the scanned access points.
+ * When the scan does not complete in time, a NativeIOException is thrown and the job is released by the
+ * worker when the driver returns. Set to 0 to wait without timeout.
+ */
+#define ECOM_WIFI_SCAN_TIMEOUT (30000)
+
 /**
  * @brief Generic error returned by native functions.
  */
@@ -33,7 +33,7 @@
  * the configuration ecom_wifi_configuration.h must be updated based on the one provided
  * by the new CCO version.
  */
-#if ECOM_WIFI_CONFIGURATION_VERSION != 2
+#if ECOM_WIFI_CONFIGURATION_VERSION != 3
 
 	#error "Version of the configuration file ecom_wifi_configuration.h is not compatible with this implementation."
 
@@ -214,6 +214,9 @@ int32_t LLECOM_WIFI_IMPL_scanAPCount(int8_t active, int8_t getResult) {
 
 	params->active = active;
 
+	// A stuck scan must not hold the Java thread forever.
+	(void)MICROEJ_ASYNC_WORKER_set_job_timeout(job, ECOM_WIFI_SCAN_TIMEOUT);
+
 	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&ecom_wifi_worker, job, LLECOM_WIFI_IMPL_scanAPCount_action, (SNI_callback)LLECOM_WIFI_IMPL_scanAPCount_on_done);
 	if (status == MICROEJ_ASYNC_WORKER_OK) {
 		// Wait for the action to be done
@@ -323,6 +326,9 @@ static int32_t LLECOM_WIFI_async_exec_get_info(SNI_callback retry_function, MICR
  */
 static int32_t LLECOM_WIFI_async_exec_get_info_on_done(int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_get_info_t* params = (ECOM_WIFI_get_info_t*)job->params;
 
 	int32_t result = params->result;
@@ -348,6 +354,9 @@ static int32_t LLECOM_WIFI_async_exec_get_info_on_done(int8_t getResult) {
  */
 static int32_t LLECOM_WIFI_IMPL_enableSoftAP_on_done(int8_t* ssid, int32_t ssidOffset, int32_t ssidLength, int8_t* passphrase, int32_t passphraseOffset, int32_t passphraseLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_enable_softap_t* params = (ECOM_WIFI_enable_softap_t*)job->params;
 
 	int32_t result = params->result;
@@ -370,6 +379,9 @@ static int32_t LLECOM_WIFI_IMPL_enableSoftAP_on_done(int8_t* ssid, int32_t ssidO
  */
 static int32_t LLECOM_WIFI_IMPL_setNameSoftAP_on_done(int8_t* name, int32_t nameOffset, int32_t nameLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_set_name_t* params = (ECOM_WIFI_set_name_t*)job->params;
 
 	int32_t result = params->result;
@@ -431,6 +443,9 @@ static int32_t LLECOM_WIFI_IMPL_getXSSID(int8_t* xssid, int32_t xssidOffset, int
  */
 static int32_t LLECOM_WIFI_IMPL_getXSSID_on_done(int8_t* xssid, int32_t xssidOffset, int32_t xssidLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_get_xssid_t* params = (ECOM_WIFI_get_xssid_t*)job->params;
 
 	int32_t result = params->result;
@@ -458,6 +473,9 @@ static int32_t LLECOM_WIFI_IMPL_getXSSID_on_done(int8_t* xssid, int32_t xssidOff
  */
 static int32_t LLECOM_WIFI_IMPL_getRSSI_on_done(float* rssi, int32_t rssiOffset, int32_t rssiLength, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_get_rssi_t* params = (ECOM_WIFI_get_rssi_t*)job->params;
 
 	int32_t result = params->result;
@@ -568,6 +586,10 @@ static int32_t LLECOM_WIFI_IMPL_joinWithSecurityMode_on_done(int8_t* ssid, int32
  */
 static int32_t LLECOM_WIFI_IMPL_scanAPCount_on_done(int8_t active, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		// Timeout: an exception is pending, or the thread waits again for the end of the scan
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_scanAP_count_t* params = (ECOM_WIFI_scanAP_count_t*)job->params;
 
 	int32_t result = params->result;
@@ -633,6 +655,9 @@ static int32_t LLECOM_WIFI_IMPL_scanAPxssidAt(int8_t* xssid, int32_t xssidOffset
  */
 static int32_t LLECOM_WIFI_IMPL_scanAPxssidAt_on_done(int8_t* xssid, int32_t xssidOffset, int32_t xssidLength, int32_t index, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_scanAP_xssid_t* params = (ECOM_WIFI_scanAP_xssid_t*)job->params;
 
 	int32_t result = params->result;
@@ -697,6 +722,9 @@ static int32_t LLECOM_WIFI_async_exec_scanAP(int32_t index, SNI_callback retry_f
  */
 static int32_t LLECOM_WIFI_async_exec_scanAP_on_done(int32_t index, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_scanAP_channel_t* params = (ECOM_WIFI_scanAP_channel_t*)job->params;
 
 	int32_t result = params->result;
@@ -720,6 +748,9 @@ static int32_t LLECOM_WIFI_async_exec_scanAP_on_done(int32_t index, int8_t getRe
  */
 static int32_t LLECOM_WIFI_IMPL_scanAPrssiAt_on_done(float* rssi, int32_t rssiOffset, int32_t rssiLength, int32_t index, int8_t getResult) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_scanAP_rssi_t* params = (ECOM_WIFI_scanAP_rssi_t*)job->params;
 
 	int32_t result = params->result;
@@ -741,6 +772,9 @@ static int32_t LLECOM_WIFI_IMPL_scanAPrssiAt_on_done(float* rssi, int32_t rssiOf
  */
 static int32_t LLECOM_WIFI_joinWithSecurityMode_on_done(void) {
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if (job == NULL) {
+		return ECOM_WIFI_ERROR;
+	}
 	ECOM_WIFI_join_security_mode_t* params = (ECOM_WIFI_join_security_mode_t*)job->params;
 
 	int32_t result = params->result;
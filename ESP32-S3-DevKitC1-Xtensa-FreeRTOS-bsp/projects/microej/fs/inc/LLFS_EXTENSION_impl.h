@@ -0,0 +1,401 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ FS low level API: extensions.
+ * @author MicroEJ Developer Team
+ * @version 2.2.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLFS_EXTENSION_IMPL_H
+#define LLFS_EXTENSION_IMPL_H
+
+#include <sni.h>
+#include <stdint.h>
+
+#define LLFS_IMPL_stat                      Java_com_microej_support_fs_NativeFileExtension_nativeStat
+#define LLFS_IMPL_stat_batch                Java_com_microej_support_fs_NativeFileExtension_nativeStatBatch
+#define LLFS_IMPL_read_directory_entries    Java_com_microej_support_fs_NativeFileExtension_nativeReadDirectoryEntries
+#define LLFS_File_IMPL_read_at              Java_com_microej_support_fs_NativeFileExtension_nativeReadAt
+#define LLFS_File_IMPL_write_at             Java_com_microej_support_fs_NativeFileExtension_nativeWriteAt
+#define LLFS_File_IMPL_read_extents         Java_com_microej_support_fs_NativeFileExtension_nativeReadExtents
+#define LLFS_File_IMPL_write_extents        Java_com_microej_support_fs_NativeFileExtension_nativeWriteExtents
+#define LLFS_LOG_IMPL_open                  Java_com_microej_support_fs_NativeAppendLog_nativeOpen
+#define LLFS_LOG_IMPL_append                Java_com_microej_support_fs_NativeAppendLog_nativeAppend
+#define LLFS_LOG_IMPL_commit                Java_com_microej_support_fs_NativeAppendLog_nativeCommit
+#define LLFS_LOG_IMPL_read                  Java_com_microej_support_fs_NativeAppendLog_nativeRead
+#define LLFS_LOG_IMPL_close                 Java_com_microej_support_fs_NativeAppendLog_nativeClose
+#define LLFS_IMPL_get_flash_statistics      Java_com_microej_support_fs_NativeFileExtension_nativeGetFlashStatistics
+#define LLFS_RESOURCE_IMPL_open             Java_com_microej_support_fs_NativeResourceImage_nativeOpen
+#define LLFS_RESOURCE_IMPL_read             Java_com_microej_support_fs_NativeResourceImage_nativeRead
+
+/** @brief Index of the flags (<code>LLFS_STAT_FLAG_*</code>) in the attributes array. */
+#define LLFS_STAT_FLAGS (0)
+/** @brief Index of the length in bytes in the attributes array. */
+#define LLFS_STAT_LENGTH (1)
+/** @brief Index of the year of the last modification in the attributes array. */
+#define LLFS_STAT_YEAR (2)
+/** @brief Index of the month of the last modification in the attributes array. */
+#define LLFS_STAT_MONTH (3)
+/** @brief Index of the day of the last modification in the attributes array. */
+#define LLFS_STAT_DAY (4)
+/** @brief Index of the hour of the last modification in the attributes array. */
+#define LLFS_STAT_HOUR (5)
+/** @brief Index of the minute of the last modification in the attributes array. */
+#define LLFS_STAT_MINUTE (6)
+/** @brief Index of the second of the last modification in the attributes array. */
+#define LLFS_STAT_SECOND (7)
+/** @brief Minimum length of the attributes array. */
+#define LLFS_STAT_ATTRIBUTES_LENGTH (8)
+
+/** @brief The path exists. */
+#define LLFS_STAT_FLAG_EXISTS (0x1)
+/** @brief The path is a directory. */
+#define LLFS_STAT_FLAG_DIRECTORY (0x2)
+/** @brief The path is hidden. */
+#define LLFS_STAT_FLAG_HIDDEN (0x4)
+/** @brief The path is read only. */
+#define LLFS_STAT_FLAG_READ_ONLY (0x8)
+
+/*
+ * Layout of an entry returned by LLFS_IMPL_read_directory_entries(). Multi-byte values are little-endian.
+ */
+/** @brief Offset of the length in bytes (int64). */
+#define LLFS_DIRECTORY_ENTRY_LENGTH_OFFSET (0)
+/** @brief Offset of the year of the last modification (uint16). */
+#define LLFS_DIRECTORY_ENTRY_YEAR_OFFSET (8)
+/** @brief Offset of the month of the last modification (uint8). */
+#define LLFS_DIRECTORY_ENTRY_MONTH_OFFSET (10)
+/** @brief Offset of the day of the last modification (uint8). */
+#define LLFS_DIRECTORY_ENTRY_DAY_OFFSET (11)
+/** @brief Offset of the hour of the last modification (uint8). */
+#define LLFS_DIRECTORY_ENTRY_HOUR_OFFSET (12)
+/** @brief Offset of the minute of the last modification (uint8). */
+#define LLFS_DIRECTORY_ENTRY_MINUTE_OFFSET (13)
+/** @brief Offset of the second of the last modification (uint8). */
+#define LLFS_DIRECTORY_ENTRY_SECOND_OFFSET (14)
+/** @brief Offset of the flags, <code>LLFS_STAT_FLAG_*</code> (uint8). */
+#define LLFS_DIRECTORY_ENTRY_FLAGS_OFFSET (15)
+/** @brief Offset of the length of the name in bytes (uint16). */
+#define LLFS_DIRECTORY_ENTRY_NAME_LENGTH_OFFSET (16)
+/** @brief Offset of the name, not null terminated. Also the size of the fixed part of an entry. */
+#define LLFS_DIRECTORY_ENTRY_NAME_OFFSET (18)
+/** @brief Maximum length of a name in bytes. */
+#define LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH (255)
+/** @brief Maximum size of an entry in bytes, and minimum size of the entries array. */
+#define LLFS_DIRECTORY_ENTRY_MAX_LENGTH (LLFS_DIRECTORY_ENTRY_NAME_OFFSET + LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH)
+
+/*
+ * Flash statistics. Reads and writes are counted in sectors with FatFs and in cache lines
+ * (FS_LITTLEFS_CACHE_SIZE bytes at most) with LittleFS. Erases are counted in 4 KB sectors.
+ */
+/** @brief Index of the number of sectors read by the file system. */
+#define LLFS_FLASH_STAT_LOGICAL_READS (0)
+/** @brief Index of the number of sectors written by the file system. */
+#define LLFS_FLASH_STAT_LOGICAL_WRITES (1)
+/** @brief Index of the number of sector reads and writes served by the sector cache. */
+#define LLFS_FLASH_STAT_CACHE_HITS (2)
+/** @brief Index of the number of sectors written to the wear-leveling layer. */
+#define LLFS_FLASH_STAT_PHYSICAL_WRITES (3)
+/** @brief Index of the number of sectors erased by the wear-leveling layer, not including its own metadata. */
+#define LLFS_FLASH_STAT_PHYSICAL_ERASES (4)
+/** @brief Index of the number of sector cache flushes. */
+#define LLFS_FLASH_STAT_FLUSHES (5)
+/** @brief Minimum length of the statistics array. */
+#define LLFS_FLASH_STAT_COUNT (6)
+
+/*
+ * Layout of a resource image, flashed in the FS_RESOURCE_PARTITION_LABEL partition. Multi-byte values are
+ * little-endian. The image starts with a header followed by <code>count</code> entries. The data of the
+ * resources is stored anywhere after the entries, at offsets relative to the start of the partition.
+ */
+/** @brief Magic value of a resource image header ("MJRI"). */
+#define LLFS_RESOURCE_IMAGE_MAGIC (0x49524A4DU)
+/** @brief Version of the resource image format. */
+#define LLFS_RESOURCE_IMAGE_VERSION (1U)
+/** @brief Maximum length of a resource name, including the terminating null byte. */
+#define LLFS_RESOURCE_NAME_LENGTH (56)
+
+/** @brief Header of a resource image. */
+typedef struct {
+	uint32_t magic; /*!< <code>LLFS_RESOURCE_IMAGE_MAGIC</code>. */
+	uint32_t version; /*!< <code>LLFS_RESOURCE_IMAGE_VERSION</code>. */
+	uint32_t count; /*!< Number of entries following the header. */
+	uint32_t reserved; /*!< Reserved, 0. */
+} LLFS_resource_image_header_t;
+
+/** @brief Entry of a resource image. */
+typedef struct {
+	char name[LLFS_RESOURCE_NAME_LENGTH]; /*!< Null terminated name of the resource. */
+	uint32_t offset; /*!< Offset of the data in the partition. */
+	uint32_t length; /*!< Length of the data in bytes. */
+} LLFS_resource_image_entry_t;
+
+/** @brief Index of the address of the mapped data in the info array of <code>LLFS_RESOURCE_IMPL_open</code>. */
+#define LLFS_RESOURCE_INFO_ADDRESS (0)
+/** @brief Index of the length of the data in the info array of <code>LLFS_RESOURCE_IMPL_open</code>. */
+#define LLFS_RESOURCE_INFO_LENGTH (1)
+/** @brief Minimum length of the info array of <code>LLFS_RESOURCE_IMPL_open</code>. */
+#define LLFS_RESOURCE_INFO_SIZE (2)
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Reads all the attributes of a path at once: existence, type, length and last modification date.
+ *
+ * Replaces a sequence of <code>exist</code>, <code>isDirectory</code>, <code>length</code> and
+ * <code>lastModified</code> calls by a single file system access. The result is kept in the stat cache.
+ *
+ * @param[in] path                          Null terminated absolute path.
+ * @param[out] attributes                   The array receiving the attributes, indexed by <code>LLFS_STAT_*</code>.
+ *                                          Its length must be at least <code>LLFS_STAT_ATTRIBUTES_LENGTH</code>.
+ *
+ * @return <code>LLFS_OK</code> if the path exists, else <code>LLFS_NOK</code>.
+ *
+ * @throws NativeIOException if the attributes array is too small.
+ */
+int32_t LLFS_IMPL_stat(uint8_t* path, int64_t* attributes);
+
+/**
+ * @brief Reads all the attributes of several paths at once.
+ *
+ * The paths missing from the stat cache are read by a single batch of jobs, so the Java thread is suspended
+ * and resumed only once. At most <code>FS_STAT_BATCH_SIZE</code> paths are read by a call: the caller calls
+ * it again for the remaining ones.
+ *
+ * @param[in] paths                         The null terminated absolute paths, one after the other.
+ * @param[in] count                         The number of paths, greater than 0.
+ * @param[out] attributes                   The array receiving the attributes, <code>LLFS_STAT_ATTRIBUTES_LENGTH</code>
+ *                                          entries per path read, indexed by <code>LLFS_STAT_*</code> from the
+ *                                          first entry of the path. The flags of a missing path are 0.
+ *
+ * @return The number of paths read.
+ *
+ * @throws NativeIOException if the count is not valid, a path is not null terminated or the attributes array
+ * is too small.
+ * @throws NativeException if a path is too long.
+ */
+int32_t LLFS_IMPL_stat_batch(uint8_t* paths, int32_t count, int64_t* attributes);
+
+/**
+ * @brief Reads as many entries of an open directory as fit in a buffer, with their attributes.
+ *
+ * Replaces a <code>readdir</code> call per entry followed by attribute queries. Entries are packed one after
+ * the other with the layout given by the <code>LLFS_DIRECTORY_ENTRY_*</code> offsets. An entry starts at
+ * the offset of the previous one plus <code>LLFS_DIRECTORY_ENTRY_NAME_OFFSET</code> plus its name length.
+ *
+ * @param[in] directory_ID                  The directory ID returned by <code>LLFS_IMPL_open_directory</code>.
+ * @param[in] pattern                       Null terminated glob pattern (<code>*</code> and <code>?</code>,
+ *                                          case insensitive) that names must match, empty to read all the entries.
+ * @param[out] entries                      The array receiving the packed entries. Its length must be at least
+ *                                          <code>LLFS_DIRECTORY_ENTRY_MAX_LENGTH</code>.
+ *
+ * @return The number of entries read, 0 at the end of the directory.
+ *
+ * @throws NativeIOException on error.
+ */
+int32_t LLFS_IMPL_read_directory_entries(int32_t directory_ID, uint8_t* pattern, uint8_t* entries);
+
+/**
+ * @brief Reads data at a given position of a file without moving its file pointer.
+ *
+ * Replaces a <code>seek</code> followed by a <code>read</code> with a single file system job.
+ *
+ * @param[in] file_id                       The file identifier returned by <code>LLFS_File_IMPL_open</code>.
+ * @param[in] position                      The position in the file.
+ * @param[out] data                         The array receiving the data.
+ * @param[in] offset                        The offset in the array.
+ * @param[in] length                        The maximum number of bytes to read.
+ *
+ * @return The number of bytes read, <code>LLFS_EOF</code> if the position is at or after the end of the file.
+ *
+ * @throws NativeIOException on error.
+ */
+int32_t LLFS_File_IMPL_read_at(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length);
+
+/**
+ * @brief Writes data at a given position of a file without moving its file pointer.
+ *
+ * Writing after the end of the file extends it.
+ *
+ * @param[in] file_id                       The file identifier returned by <code>LLFS_File_IMPL_open</code>.
+ * @param[in] position                      The position in the file.
+ * @param[in] data                          The data to write.
+ * @param[in] offset                        The offset in the array.
+ * @param[in] length                        The number of bytes to write.
+ *
+ * @return The number of bytes written, which may be less than <code>length</code>.
+ *
+ * @throws NativeIOException on error.
+ */
+int32_t LLFS_File_IMPL_write_at(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length);
+
+/**
+ * @brief Reads several extents of a file in a single file system job without moving its file pointer.
+ *
+ * The extents are read in order and stored one after the other in <code>data</code>, starting at
+ * <code>offset</code>. Reading stops at the end of the file or when the job buffer is full.
+ *
+ * @param[in] file_id                       The file identifier returned by <code>LLFS_File_IMPL_open</code>.
+ * @param[in] positions                     The position in the file of each extent.
+ * @param[in] lengths                       The length of each extent, same array length as <code>positions</code>.
+ * @param[out] data                         The array receiving the data.
+ * @param[in] offset                        The offset in the array.
+ *
+ * @return The total number of bytes read, <code>LLFS_EOF</code> if the first extent is at or after the end of the file.
+ *
+ * @throws NativeIOException on error or if there are too many extents.
+ */
+int32_t LLFS_File_IMPL_read_extents(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset);
+
+/**
+ * @brief Writes several extents of a file in a single file system job without moving its file pointer.
+ *
+ * The data of the extents is taken one after the other in <code>data</code>, starting at <code>offset</code>.
+ * Writing stops when the volume is full or when the job buffer is full.
+ *
+ * @param[in] file_id                       The file identifier returned by <code>LLFS_File_IMPL_open</code>.
+ * @param[in] positions                     The position in the file of each extent.
+ * @param[in] lengths                       The length of each extent, same array length as <code>positions</code>.
+ * @param[in] data                          The data to write.
+ * @param[in] offset                        The offset in the array.
+ *
+ * @return The total number of bytes written.
+ *
+ * @throws NativeIOException on error or if there are too many extents.
+ */
+int32_t LLFS_File_IMPL_write_extents(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset);
+
+/**
+ * @brief Opens an append log, creating it if it does not exist.
+ *
+ * An append log is a file preallocated once, in which records framed with a CRC are written sequentially.
+ * Committing the log does not change the size nor the allocation of the file, so the file system metadata
+ * is not rewritten. When an existing log is opened, its records are checked and the log is truncated after
+ * the last complete record, discarding the records that were not entirely written before a power loss.
+ *
+ * A log must not be used by several threads at the same time.
+ *
+ * @param[in] path                          Null terminated absolute path.
+ * @param[in] capacity                      The size of the file to preallocate when the log is created. Ignored
+ *                                          when the log already exists.
+ *
+ * @return The log ID.
+ *
+ * @throws NativeIOException on error, if the file is not an append log or if too many logs are open.
+ */
+int32_t LLFS_LOG_IMPL_open(uint8_t* path, int64_t capacity);
+
+/**
+ * @brief Appends a record to a log.
+ *
+ * The record is kept in memory until the log is committed, or written without commit when the group commit
+ * buffer is full.
+ *
+ * @param[in] log_id                        The log ID returned by <code>LLFS_LOG_IMPL_open</code>.
+ * @param[in] data                          The payload of the record.
+ * @param[in] offset                        The offset of the payload in the array.
+ * @param[in] length                        The length of the payload.
+ *
+ * @return The sequence number of the record.
+ *
+ * @throws NativeIOException on error, if the record is too large or if the log is full.
+ */
+int32_t LLFS_LOG_IMPL_append(int32_t log_id, uint8_t* data, int32_t offset, int32_t length);
+
+/**
+ * @brief Writes the appended records and commits them to the volume.
+ *
+ * @param[in] log_id                        The log ID returned by <code>LLFS_LOG_IMPL_open</code>.
+ *
+ * @throws NativeIOException on error.
+ */
+void LLFS_LOG_IMPL_commit(int32_t log_id);
+
+/**
+ * @brief Reads a record of a log.
+ *
+ * @param[in] log_id                        The log ID returned by <code>LLFS_LOG_IMPL_open</code>.
+ * @param[in,out] position                  A single element array containing the position of the record, 0 for the
+ *                                          first record. Set to the position of the next record.
+ * @param[out] data                         The array receiving the payload of the record.
+ * @param[in] offset                        The offset in the array.
+ * @param[in] length                        The maximum length of the payload.
+ *
+ * @return The length of the payload, <code>LLFS_EOF</code> after the last record.
+ *
+ * @throws NativeIOException on error, if the record is corrupted or larger than <code>length</code>.
+ */
+int32_t LLFS_LOG_IMPL_read(int32_t log_id, int64_t* position, uint8_t* data, int32_t offset, int32_t length);
+
+/**
+ * @brief Commits and closes a log.
+ *
+ * @param[in] log_id                        The log ID returned by <code>LLFS_LOG_IMPL_open</code>.
+ *
+ * @throws NativeIOException on error.
+ */
+void LLFS_LOG_IMPL_close(int32_t log_id);
+
+/**
+ * @brief Gets the flash statistics: sectors read and written by the file system, sector cache hits and sectors
+ * written and erased on the flash.
+ *
+ * The counters are cumulated since the start or since the last reset.
+ *
+ * @param[out] statistics                   The array receiving the statistics, indexed by <code>LLFS_FLASH_STAT_*</code>.
+ *                                          Its length must be at least <code>LLFS_FLASH_STAT_COUNT</code>.
+ * @param[in] reset                         <code>true</code> to reset the counters after reading them.
+ *
+ * @throws NativeIOException if the statistics array is too small.
+ */
+void LLFS_IMPL_get_flash_statistics(int64_t* statistics, jboolean reset);
+
+/**
+ * @brief Looks up a resource of the resource image and returns the address where it is memory-mapped.
+ *
+ * The resource image is mapped in the data address space once, on first use, and stays mapped. Only the
+ * range used by the image is mapped, not the whole partition. The Java side can wrap the returned address in a byte buffer (<code>SNI.mapByteBuffer</code>) to
+ * read the resource in place, without copying it to the Java heap.
+ *
+ * @param[in] name                          Null terminated name of the resource.
+ * @param[out] info                         The array receiving the address and the length of the resource,
+ *                                          indexed by <code>LLFS_RESOURCE_INFO_*</code>.
+ *
+ * @return The resource ID, or <code>LLFS_NOK</code> if there is no resource with this name.
+ *
+ * @throws NativeIOException if the resource image is not available or invalid, or if the info array is too small.
+ */
+int32_t LLFS_RESOURCE_IMPL_open(uint8_t* name, int64_t* info);
+
+/**
+ * @brief Copies data of a resource to a Java array.
+ *
+ * For Java code that can not use the mapped address directly. The copy is done from the flash cache on the
+ * calling thread, without file system job.
+ *
+ * @param[in] resource_id                   The resource ID returned by <code>LLFS_RESOURCE_IMPL_open</code>.
+ * @param[in] position                      The position in the resource.
+ * @param[out] data                         The array receiving the data.
+ * @param[in] offset                        The offset in the array.
+ * @param[in] length                        The maximum number of bytes to read.
+ *
+ * @return The number of bytes read, <code>LLFS_EOF</code> if the position is at or after the end of the resource.
+ *
+ * @throws NativeIOException on invalid arguments.
+ */
+int32_t LLFS_RESOURCE_IMPL_read(int32_t resource_id, int32_t position, uint8_t* data, int32_t offset, int32_t length);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLFS_EXTENSION_IMPL_H */
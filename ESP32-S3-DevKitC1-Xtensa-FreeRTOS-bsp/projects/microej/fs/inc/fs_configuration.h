@@ -16,8 +16,11 @@
  * @date 26 April 2023
  */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include "microej_async_worker.h"
+#include "sdkconfig.h"
 
 #ifdef __cplusplus
 	extern "C" {
@@ -31,19 +34,97 @@
  * This value must not be changed by the user of the CCO.
  * This value must be incremented by the implementor of the CCO when a configuration define is added, deleted or modified.
  */
-#define FS_CONFIGURATION_VERSION (1)
+#define FS_CONFIGURATION_VERSION (2)
+
+/**
+ * @brief Set this define to use LittleFS instead of FatFs on the SPI flash.
+ * LittleFS is power-loss resilient and does not rewrite a FAT for each small write. The littlefs library
+ * must be added to the project (for example the <code>joltwallet/littlefs</code> component of the
+ * ESP-IDF component registry). The storage partition is formatted on the first mount, when it is blank.
+ */
+//#define FS_USE_LITTLEFS
 
 /**
  * @brief Initialization function for ESP32 SPI flash.
  */
 void LLFS_ESP32_init_spiflash(void);
 
+/**
+ * @brief Initialization function for ESP32 SPI flash with LittleFS.
+ */
+void LLFS_ESP32_init_littlefs(void);
+
 /**
  * @brief Use this macro to define the initialization function of the file system stack.
  * Called from LLFS_IMPL_initialize().
  * By default this macro does nothing.
  */
+#ifdef FS_USE_LITTLEFS
+#define llfs_init()	(LLFS_ESP32_init_littlefs())
+#else
 #define llfs_init()	(LLFS_ESP32_init_spiflash())
+#endif
+
+/**
+ * @brief Gets the flash statistics of the ESP32 SPI flash, indexed by <code>LLFS_FLASH_STAT_*</code>.
+ *
+ * @param[out] statistics array of <code>LLFS_FLASH_STAT_COUNT</code> elements receiving the statistics.
+ * @param[in] reset true to reset the statistics.
+ */
+void LLFS_ESP32_get_flash_statistics(int64_t* statistics, bool reset);
+
+/**
+ * @brief Use this macro to define the function that gets the flash statistics of the file system stack.
+ * Called from LLFS_IMPL_get_flash_statistics().
+ */
+#define llfs_get_flash_statistics(statistics, reset)	(LLFS_ESP32_get_flash_statistics((statistics), (reset)))
+
+/**
+ * @brief Number of sectors of the write-back cache between FatFs and the wear-leveling layer.
+ * Sectors written by FatFs are kept in this cache and written to the flash only when they are evicted or
+ * when the volume is synced (a file is flushed or closed), so repeated writes of the same FAT or directory
+ * sector between two syncs cost a single flash erase. Single sector reads are also served from the cache.
+ * Each entry uses one wear-leveling sector (4 KB by default). Set to 0 to disable the cache.
+ */
+#define FS_SECTOR_CACHE_COUNT (4)
+
+/**
+ * @brief Heap capabilities of the sector cache entries (see esp_heap_caps.h).
+ */
+#define FS_SECTOR_CACHE_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+/**
+ * @brief Label of the partition mounted with LittleFS.
+ */
+#define FS_LITTLEFS_PARTITION_LABEL ("storage")
+
+/**
+ * @brief Size in bytes of the LittleFS read and program caches, and of the cache of each open file.
+ * Must be a multiple of 16 and a divisor of the flash sector size (4096).
+ */
+#define FS_LITTLEFS_CACHE_SIZE (256)
+
+/**
+ * @brief Size in bytes of the LittleFS lookahead buffer, each byte tracks 8 blocks. Must be a multiple of 8.
+ */
+#define FS_LITTLEFS_LOOKAHEAD_SIZE (32)
+
+/**
+ * @brief Number of erase cycles before LittleFS moves a metadata block for wear leveling.
+ */
+#define FS_LITTLEFS_BLOCK_CYCLES (500)
+
+/**
+ * @brief Maximum number of files and of directories open at the same time with LittleFS.
+ */
+#define FS_LITTLEFS_MAX_OPEN_FILES (8)
+
+/**
+ * @brief Set this define to format the LittleFS partition when it cannot be mounted, for example after
+ * a corruption or a change of the LittleFS configuration. All the files of the partition are lost.
+ * By default a partition that is not blank is never formatted and the initialization fails.
+ */
+//#define FS_LITTLEFS_FORMAT_IF_MOUNT_FAILED
 
 /**
  * @brief Set this define to use a custom worker to handle FS asynchronous jobs.
@@ -62,17 +143,33 @@ extern MICROEJ_ASYNC_WORKER_handle_t fs_worker;
 #endif
 
 /**
- * @brief Number of workers dedicated to the FS in async_worker.
+ * @brief Number of FS worker tasks, from 1 to 4.
+ * Operations on the same file or directory are always executed by the same worker, in order.
+ * Operations on different files and path operations (metadata, open, ...) run in parallel on
+ * the other workers. FatFs serializes the accesses to a volume (FF_FS_REENTRANT).
+ * Each worker costs about 16 KB of internal RAM with the default configuration: the stack of its task
+ * (<code>FS_WORKER_STACK_SIZE</code>), <code>FS_WORKER_JOB_COUNT</code> job parameters of about 2.3 KB each
+ * (<code>sizeof(FS_worker_param_t)</code>, a bit more than <code>FS_IO_BUFFER_SIZE</code>) and its waiting list.
+ * Must be 1 when <code>FS_CUSTOM_WORKER</code> is defined.
+ */
+#define FS_WORKER_COUNT (2)
+
+#if defined(FS_CUSTOM_WORKER) && (FS_WORKER_COUNT != 1)
+#error "FS_WORKER_COUNT must be 1 when using a custom worker."
+#endif
+
+/**
+ * @brief Number of jobs of each FS worker in async_worker.
  */
 #define FS_WORKER_JOB_COUNT (4)
 
 /**
- * @brief Size of the waiting list for FS jobs in async_worker.
+ * @brief Size of the waiting list for FS jobs of each FS worker in async_worker.
  */
 #define FS_WAITING_LIST_SIZE (16)
 
 /**
- * @brief Size of the FS stack in bytes.
+ * @brief Size of the stack of each FS worker in bytes.
  */
 #define FS_WORKER_STACK_SIZE (1024*6)
 
@@ -88,6 +185,18 @@ extern MICROEJ_ASYNC_WORKER_handle_t fs_worker;
  */
 #define FS_WORKER_PRIORITY (6)
 
+/**
+ * @brief Core that runs the FS workers, <code>OSAL_NO_AFFINITY</code> to let FreeRTOS run them on any core.
+ * The WiFi and Bluetooth tasks are pinned to core 0 (<code>CONFIG_ESP32_WIFI_TASK_PINNED_TO_CORE_0</code>,
+ * <code>CONFIG_BT_BLUEDROID_PINNED_TO_CORE</code>): the FS workers run on core 1 so file accesses are not preempted
+ * by network traffic. A single core build runs them on any core.
+ */
+#if CONFIG_FREERTOS_UNICORE
+#define FS_WORKER_CORE (OSAL_NO_AFFINITY)
+#else
+#define FS_WORKER_CORE (1)
+#endif
+
 /**
  * @brief Maximum path length.
  */
@@ -98,6 +207,123 @@ extern MICROEJ_ASYNC_WORKER_handle_t fs_worker;
  */
 #define FS_IO_BUFFER_SIZE (2048)
 
+/**
+ * @brief Size in bytes of the bounce buffer used for large transfers.
+ * A read or write of more than <code>FS_IO_BUFFER_SIZE</code> bytes on a Java array that is not immortal is
+ * copied through this buffer instead of the job IO buffer, so it needs fewer async_worker jobs.
+ * Immortal arrays are always passed directly to the file system without any copy.
+ * The buffer is allocated on first use and shared by all files. Set to 0 to disable it.
+ */
+#define FS_LARGE_IO_BUFFER_SIZE (32*1024)
+
+/**
+ * @brief Heap capabilities of the large transfer bounce buffer (see esp_heap_caps.h).
+ */
+#define FS_LARGE_IO_BUFFER_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+/**
+ * @brief Size in bytes of the read-ahead/write-behind buffer attached to an open file.
+ * Single-byte and small reads/writes are served from this buffer on the VM task instead of
+ * posting one async_worker job per call. Reads and writes larger than this size bypass the buffer.
+ */
+#define FS_FILE_BUFFER_SIZE (512)
+
+/**
+ * @brief Number of files that can be buffered at the same time.
+ * Files opened while all buffers are in use, and files opened in a synchronous mode
+ * (<code>LLFS_FILE_MODE_READ_WRITE_SYNC</code> or <code>LLFS_FILE_MODE_READ_WRITE_DATA_SYNC</code>),
+ * are not buffered. Set to 0 to disable file buffering.
+ */
+#define FS_FILE_BUFFER_COUNT (4)
+
+/**
+ * @brief Delay in milliseconds before a Java thread retries to access a buffered file or an append log
+ * while another thread is waiting for a job on it. The thread is suspended during this delay instead of
+ * getting an exception, and the native is executed again once the delay expires.
+ */
+#define FS_CONCURRENT_ACCESS_RETRY_DELAY (1)
+
+/**
+ * @brief Maximum time in milliseconds a Java thread waits for a metadata query: the stat natives
+ * (<code>exist</code>, <code>length</code>, <code>LLFS_IMPL_stat</code>, ...) and the space size natives.
+ * The time includes the wait behind the jobs already queued on the FS worker. When it expires, a
+ * NativeIOException is thrown and the job is released by the worker when the file system returns.
+ * Jobs that open files or modify the file system have no timeout: they are never abandoned.
+ * Set to 0 to wait without timeout.
+ */
+#define FS_JOB_TIMEOUT (10000)
+
+/**
+ * @brief Maximum length of the glob pattern given to <code>LLFS_IMPL_read_directory_entries</code>,
+ * including the terminating null byte.
+ */
+#define FS_DIRECTORY_PATTERN_LENGTH (64)
+
+/**
+ * @brief Number of entries of the stat cache.
+ * The attributes of the last queried paths (existence, type, length, last modification date, ...) are
+ * kept in this cache so repeated queries on the same paths are answered on the VM task without posting
+ * an async_worker job. The whole cache is cleared each time the file system is modified.
+ * Set to 0 to disable the cache.
+ */
+#define FS_STAT_CACHE_SIZE (4)
+
+/**
+ * @brief Maximum number of paths read by a single <code>LLFS_IMPL_stat_batch</code> call.
+ * The paths missing from the stat cache are read by one async_worker batch: a single queue entry and a
+ * single Java thread resume for all of them. Must not be greater than <code>FS_WORKER_JOB_COUNT</code>.
+ */
+#define FS_STAT_BATCH_SIZE (4)
+
+/**
+ * @brief Maximum number of extents of <code>LLFS_File_IMPL_read_extents</code> and
+ * <code>LLFS_File_IMPL_write_extents</code>.
+ */
+#define FS_FILE_EXTENT_COUNT (8)
+
+/**
+ * @brief Maximum number of append logs open at the same time (see <code>LLFS_LOG_IMPL_open</code>).
+ * Set to 0 to disable append logs.
+ */
+#define FS_LOG_COUNT (2)
+
+/**
+ * @brief Size in bytes of the group commit buffer of each append log.
+ * Appended records are kept in this buffer until the log is committed or the buffer is full, so a single
+ * write and a single <code>f_sync</code> are done for all of them. This is also the maximum size of a record,
+ * including its 16-byte header. Must be at most <code>FS_IO_BUFFER_SIZE - 16</code>.
+ */
+#define FS_LOG_BUFFER_SIZE (1024)
+
+/**
+ * @brief Number of files opened for reading that are kept open by the FatFs helper after they are closed.
+ * When the same path is opened again for reading, the kept file is rewound and reused: FatFs does not walk
+ * the directories of the path again. Kept files are closed as soon as the file system is modified by the
+ * helper (file created or opened for writing, delete, rename, attribute change, ...) or when their file slot
+ * or their FatFs lock is needed to open another file or directory. A file opened before the end of a modification
+ * or closed during one, by another FS worker, is not kept. A kept file holds a FatFs lock
+ * (<code>FF_FS_LOCK</code>): other C code opening the same file for writing through the VFS may get EBUSY.
+ * Set to 0 to disable the cache.
+ */
+#define FS_OPEN_CACHE_SIZE (2)
+
+/**
+ * @brief Number of items of the fast seek cluster link map of each file opened for reading, used when FatFs
+ * is configured with <code>FF_USE_FASTSEEK</code> (<code>CONFIG_FATFS_USE_FASTSEEK</code>). A file made of
+ * N fragments needs 2 * N + 1 items; files with more fragments are read without link map.
+ */
+#define FS_FASTSEEK_TABLE_SIZE (32)
+
+/**
+ * @brief Label of the raw partition holding the resource image (see <code>LLFS_RESOURCE_IMPL_open</code>).
+ * partitions_ota_systemview.csv defines a 32 KB partition with this label in the flash left after "storage":
+ * shrink the application partitions or "storage" for larger images. The single application partition table
+ * of sdkconfig_no_ota_no_systemview has no such partition.
+ * Generate the image with <code>scripts/make_resource_image.py</code> and flash it with
+ * <code>parttool.py write_partition --partition-name resources --input resources.bin</code>.
+ */
+#define FS_RESOURCE_PARTITION_LABEL ("resources")
+
 /**
  * @brief Copies a file path from an input buffer to another buffer that will be sent to
  * the async_worker job, checking against path size constraints.
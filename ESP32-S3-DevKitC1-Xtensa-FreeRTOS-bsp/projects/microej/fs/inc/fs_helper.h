@@ -18,7 +18,9 @@
 
 #include "fs_configuration.h"
 #include "microej_async_worker.h"
+#include "microej_pool.h"
 #include "LLFS_impl.h"
+#include "LLFS_EXTENSION_impl.h"
 
 #ifdef __cplusplus
 	extern "C" {
@@ -42,9 +44,8 @@
  * @brief Data structure for path operations.
  *
  * This structure is used by <code>LLFS_IMPL_create</code>, <code>LLFS_IMPL_set_read_only</code>,
- * <code>LLFS_IMPL_open_directory</code>, <code>LLFS_IMPL_exist</code>,
- * <code>LLFS_IMPL_make_directory</code>, <code>LLFS_IMPL_is_directory</code>,
- * <code>LLFS_IMPL_is_file</code> and <code>LLFS_IMPL_delete</code>.
+ * <code>LLFS_IMPL_open_directory</code>, <code>LLFS_IMPL_make_directory</code> and
+ * <code>LLFS_IMPL_delete</code>.
  *
  * Fields defined in this structure correspond to the parameters of these functions, and
  * <code>result</code> field corresponds to the value returned by them.
@@ -55,26 +56,46 @@ typedef struct {
 } FS_path_operation_t;
 
 /**
- * @brief Data structure for path operations that return a 64-bit result.
+ * @brief Attributes of a file or a directory.
+ */
+typedef struct {
+	int32_t result; /*!< <code>LLFS_OK</code> if the path exists, else <code>LLFS_NOK</code>. */
+	bool no_file; /*!< true if the path does not exist but its parent directory does. */
+	bool directory; /*!< true if the path is a directory. */
+	bool hidden; /*!< true if the path is hidden. */
+	bool read_only; /*!< true if the path is read only. */
+	int64_t length; /*!< Length of the file in bytes. */
+	LLFS_date_t last_modified; /*!< Date of the last modification. */
+} FS_stat_info_t;
+
+/**
+ * @brief Data structure for operations reading the attributes of a path.
  *
- * This structure is used by <code>LLFS_IMPL_get_length</code>.
+ * This structure is used by <code>LLFS_IMPL_get_last_modified</code>, <code>LLFS_IMPL_get_length</code>,
+ * <code>LLFS_IMPL_exist</code>, <code>LLFS_IMPL_is_hidden</code>, <code>LLFS_IMPL_is_directory</code>,
+ * <code>LLFS_IMPL_is_file</code>, <code>LLFS_IMPL_is_accessible</code>, <code>LLFS_IMPL_stat</code> and
+ * <code>LLFS_IMPL_stat_batch</code>.
  *
- * Fields defined in this structure correspond to the parameters of this function, and
- * <code>result</code> field corresponds to the value returned by it.
+ * All the attributes are read at once so that they can be kept in the stat cache.
+ *
+ * @warning <code>path</code> and <code>result</code> fields must be declared in the same way as in
+ * <code>FS_path_operation_t</code> structure.
  */
 typedef struct {
 	uint8_t path[FS_PATH_LENGTH]; /*!< [IN] Path of the operation. */
-	int64_t result; /*!< [OUT] Result of the operation. */
-} FS_path64_operation_t;
+	int32_t result; /*!< [OUT] Result of the operation, same as <code>info.result</code>. */
+	FS_stat_info_t info; /*!< [OUT] Attributes of the path. */
+	uint32_t generation; /*!< [IN] Stat cache generation when the job is started. Not used by the action. */
+	int32_t index; /*!< [IN] Index of the path in the <code>LLFS_IMPL_stat_batch</code> paths. Not used by the action. */
+} FS_stat_t;
 
 /**
- * @brief Data structure for operations getting/setting the last modification of a file.
+ * @brief Data structure for operations setting the last modification of a file.
  *
- * This structure is used by <code>LLFS_IMPL_get_last_modified()</code> and
- * <code>LLFS_IMPL_set_last_modified()</code>.
+ * This structure is used by <code>LLFS_IMPL_set_last_modified()</code>.
  *
- * Fields defined in this structure correspond to the parameters of these functions, and
- * <code>result</code> field corresponds to the value returned by them.
+ * Fields defined in this structure correspond to the parameters of this function, and
+ * <code>result</code> field corresponds to the value returned by it.
  *
  * @warning <code>path</code> and <code>result</code> fields must be declared in the same way as in
  * <code>FS_path_operation_t</code> structure.
@@ -82,7 +103,7 @@ typedef struct {
 typedef struct {
 	uint8_t path[FS_PATH_LENGTH]; /*!< [IN] Path of the operation. */
 	int32_t result; /*!< [OUT] Result of the operation. */
-	LLFS_date_t date; /*!< [IN/OUT] Date of the last modification. Input for the date setting, output for the date getting. */
+	LLFS_date_t date; /*!< [IN] Date of the last modification. */
 } FS_last_modified_t;
 
 /**
@@ -128,8 +149,8 @@ typedef struct {
  * Fields defined in this structure correspond to the parameters of this function, and
  * <code>result</code> field corresponds to the value returned by it.
  *
- * @warning <code>path</code> and <code>result</code> fields must be declared in the same way as in
- * <code>FS_path64_operation_t</code> structure.
+ * @warning <code>path</code> field must be declared in the same way as in
+ * <code>FS_path_operation_t</code> structure.
  */
 typedef struct {
 	uint8_t path[FS_PATH_LENGTH]; /*!< [IN] Path of the operation. */
@@ -137,23 +158,6 @@ typedef struct {
 	int32_t space_type; /*!< [IN] Type of space. */
 } FS_get_space_size;
 
-/**
- * @brief Data structure for operations about file accessibility.
- *
- * This structure is used by <code>LLFS_IMPL_is_accessible</code>.
- *
- * Fields defined in this structure correspond to the parameters of this function, and
- * <code>result</code> field corresponds to the value returned by it.
- *
- * @warning <code>path</code> and <code>result</code> fields must be declared in the same way as in
- * <code>FS_path_operation_t</code> structure.
- */
-typedef struct {
-	uint8_t path[FS_PATH_LENGTH]; /*!< [IN] Path of the operation. */
-	int32_t result; /*!< [OUT] Result of the operation. */
-	int32_t access; /*!< [IN] Type of access. */
-} FS_is_accessible_t;
-
 /**
  * @brief Data structure for permission operations.
  *
@@ -233,6 +237,26 @@ typedef struct {
 	int32_t result; /*!< [OUT] Result of the operation. */
 } FS_close_directory_t;
 
+/**
+ * @brief Data structure for directory bulk read operations.
+ *
+ * This structure is used by <code>LLFS_IMPL_read_directory_entries</code>.
+ *
+ * Entries are packed in <code>buffer</code> as described in <code>LLFS_EXTENSION_impl.h</code>.
+ *
+ * @warning <code>directory_ID</code> field must be declared in the same way as in
+ * <code>FS_directory_operation_t</code> structure.
+ */
+typedef struct {
+	int32_t directory_ID; /*!< [IN] ID of the directory on which to perform the operation. */
+	int32_t result; /*!< [OUT] Number of entries read, 0 at the end of the directory. */
+	int32_t length; /*!< [IN/OUT] Available bytes in <code>buffer</code> as input, used bytes as output. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	uint8_t pattern[FS_DIRECTORY_PATTERN_LENGTH]; /*!< [IN] Null terminated glob pattern, empty to read all the entries. */
+	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< [OUT] Packed entries. */
+} FS_read_directory_entries_t;
+
 /**
  * @brief Data structure for read/write operations.
  *
@@ -252,6 +276,61 @@ typedef struct {
 	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< Internal buffer. Content must not be modified. */
 } FS_write_read_t;
 
+/**
+ * @brief Data structure for positional read/write operations.
+ *
+ * This structure is used by <code>LLFS_File_IMPL_read_at</code>, <code>LLFS_File_IMPL_write_at</code>,
+ * <code>LLFS_File_IMPL_read_extents</code> and <code>LLFS_File_IMPL_write_extents</code>.
+ *
+ * The extents are transferred in order from or to <code>data</code>, one after the other. The file pointer is
+ * not moved.
+ */
+typedef struct {
+	int32_t file_id; /*!< [IN] ID of the file on which to perform the operation. */
+	uint8_t* data; /*!< [IN/OUT] Data read (output) or data to write (input) for all the extents. */
+	int32_t length; /*!< [IN] Length of the data. Extents that do not fit are truncated. */
+	int32_t result; /*!< [OUT] Number of bytes transferred, <code>LLFS_EOF</code> or <code>LLFS_NOK</code>. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	int32_t count; /*!< [IN] Number of extents. */
+	int64_t positions[FS_FILE_EXTENT_COUNT]; /*!< [IN] Position in the file of each extent. */
+	int32_t lengths[FS_FILE_EXTENT_COUNT]; /*!< [IN] Length of each extent. */
+	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< Internal buffer. Content must not be modified. */
+} FS_extents_t;
+
+/**
+ * @brief Function receiving the data read by <code>LLFS_File_IMPL_read_range_action</code>.
+ * Called from the FS worker task: must not use SNI.
+ *
+ * @param[in] context the <code>context</code> field of <code>FS_read_range_t</code>.
+ * @param[in] data the data read.
+ * @param[in] length the number of bytes read.
+ *
+ * @return 0 to continue, else a value that stops the reading and is stored in <code>consumer_result</code>.
+ */
+typedef int32_t (*FS_read_range_consumer_t)(void* context, const uint8_t* data, int32_t length);
+
+/**
+ * @brief Data structure for the reading of a file range by native code.
+ *
+ * This structure is used by <code>LLFS_File_read_range</code>.
+ *
+ * The range is read <code>FS_IO_BUFFER_SIZE</code> bytes at a time and each chunk is passed to <code>consumer</code>.
+ * The file pointer is not moved.
+ */
+typedef struct {
+	int32_t file_id; /*!< [IN] ID of the file to read. */
+	int64_t position; /*!< [IN] Position of the range in the file. */
+	int64_t length; /*!< [IN] Length of the range. */
+	FS_read_range_consumer_t consumer; /*!< [IN] Function receiving the data read. */
+	void* context; /*!< [IN] Context given to <code>consumer</code>. */
+	int32_t consumer_result; /*!< [OUT] Value returned by <code>consumer</code> if it stopped the reading, else 0. */
+	int32_t result; /*!< [OUT] <code>LLFS_OK</code> if the whole range has been consumed, <code>LLFS_EOF</code> if the file ends before, else <code>LLFS_NOK</code>. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< Internal buffer. Content must not be modified. */
+} FS_read_range_t;
+
 /**
  * @brief Data structure for file closing operations.
  *
@@ -358,23 +437,107 @@ typedef struct {
 	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
 	char* error_message; /*!< [OUT] Error message related to the error code. */
 } FS_flush_t;
+/**
+ * @brief Header at the beginning of an append log file.
+ */
+typedef struct {
+	uint32_t magic; /*!< <code>FS_LOG_FILE_MAGIC</code>. */
+	uint32_t version; /*!< <code>FS_LOG_FILE_VERSION</code>. */
+	uint32_t epoch; /*!< Random value chosen when the log is created, seeds the CRC of the records. */
+	uint32_t reserved; /*!< Reserved, 0. */
+} FS_log_file_header_t;
+
+/**
+ * @brief Header of a record of an append log, followed by <code>length</code> bytes of payload.
+ */
+typedef struct {
+	uint32_t magic; /*!< <code>FS_LOG_RECORD_MAGIC</code>. */
+	uint32_t length; /*!< Length of the payload in bytes. */
+	uint32_t sequence; /*!< Index of the record in the log, starting at 0. */
+	uint32_t crc; /*!< CRC-32 of <code>length</code>, <code>sequence</code> and the payload, seeded with the log epoch. */
+} FS_log_record_header_t;
+
+/** @brief Magic value of an append log file header ("MJLG"). */
+#define FS_LOG_FILE_MAGIC (0x474C4A4DU)
+/** @brief Version of the append log file format. */
+#define FS_LOG_FILE_VERSION (1U)
+/** @brief Magic value of an append log record header ("MJLR"). */
+#define FS_LOG_RECORD_MAGIC (0x524C4A4DU)
+
+/**
+ * @brief Data structure for append log opening operations.
+ *
+ * This structure is used by <code>LLFS_LOG_IMPL_open</code>.
+ *
+ * @warning <code>path</code> and <code>result</code> fields must be declared in the same way as in
+ * <code>FS_path_operation_t</code> structure.
+ */
+typedef struct {
+	uint8_t path[FS_PATH_LENGTH]; /*!< [IN] Path of the log file. */
+	int32_t result; /*!< [OUT] ID of the log file or <code>LLFS_NOK</code>. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	int32_t slot; /*!< [IN] Index of the log slot reserved for the log. Not used by the action. */
+	int64_t capacity; /*!< [IN/OUT] Size preallocated when the log is created, actual size of the log file as output. */
+	int64_t end; /*!< [OUT] Position after the last valid record. */
+	uint32_t sequence; /*!< [OUT] Sequence number of the next record. */
+	uint32_t epoch; /*!< [OUT] Epoch of the log. */
+	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< Internal buffer used to check the records. */
+} FS_log_open_t;
+
+/**
+ * @brief Data structure for append log write operations.
+ *
+ * This structure is used by <code>LLFS_LOG_IMPL_append</code>, <code>LLFS_LOG_IMPL_commit</code>,
+ * <code>LLFS_LOG_IMPL_read</code> and <code>LLFS_LOG_IMPL_close</code>.
+ */
+typedef struct {
+	int32_t log_id; /*!< [IN] ID of the log file. */
+	int32_t result; /*!< [OUT] Result of the operation. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	uint8_t* data; /*!< [IN] Records to write. */
+	int32_t length; /*!< [IN] Length of the data. */
+	int64_t position; /*!< [IN] Position of the data in the file. */
+	bool sync; /*!< [IN] true to commit the log file after the write. */
+} FS_log_write_t;
+
+/**
+ * @brief Data structure for append log read operations.
+ *
+ * This structure is used by <code>LLFS_LOG_IMPL_read</code>.
+ */
+typedef struct {
+	int32_t log_id; /*!< [IN] ID of the log file. */
+	int32_t result; /*!< [OUT] Length of the payload of the record, or <code>LLFS_NOK</code>. */
+	int32_t error_code; /*!< [OUT] Error code returned in case of error. */
+	char* error_message; /*!< [OUT] Error message related to the error code. */
+	int64_t position; /*!< [IN] Position of the record. */
+	uint32_t epoch; /*!< [IN] Epoch of the log. */
+	uint8_t buffer[FS_IO_BUFFER_SIZE]; /*!< [OUT] Payload of the record. */
+} FS_log_read_t;
+
 /**
  * @union FS_worker_param_t
  */
 typedef union {
 	FS_path_operation_t path_operation;
-	FS_path64_operation_t path64_operation;
-	FS_last_modified_t get_last_modified;
+	FS_stat_t stat;
 	FS_create_t create;
 	FS_rename_to_t rename_to;
 	FS_directory_operation_t directory_operation;
 	FS_read_directory_t read_directory;
+	FS_read_directory_entries_t read_directory_entries;
 	FS_close_directory_t close_directory;
 	FS_last_modified_t set_last_modified;
-	FS_is_accessible_t is_accessible;
 	FS_set_permission_t set_permission;
 	FS_open_t open;
 	FS_write_read_t write;
+	FS_extents_t extents;
+	FS_read_range_t read_range;
+	FS_log_open_t log_open;
+	FS_log_write_t log_write;
+	FS_log_read_t log_read;
 	FS_close_t close;
 	FS_seek_t seek;
 	FS_getfp_t getfp;
@@ -385,123 +548,241 @@ typedef union {
 } FS_worker_param_t;
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_get_last_modified</code> and executed asynchronously via async_worker.
+ * @brief State of a file buffer.
+ */
+typedef enum {
+	LLFS_FILE_BUFFER_EMPTY, /*!< No buffered data: the file pointer is the logical position. */
+	LLFS_FILE_BUFFER_READ, /*!< Read-ahead data: the file pointer is <code>count - position</code> bytes after the logical position. */
+	LLFS_FILE_BUFFER_WRITE /*!< Write-behind data: <code>count</code> bytes must be written at the file pointer. */
+} LLFS_File_buffer_state_t;
+
+/**
+ * @brief Kind of the async_worker job started on a file buffer, or needed to go on with a buffered transfer.
+ */
+typedef enum {
+	LLFS_FILE_BUFFER_JOB_REFILL, /*!< Read up to <code>FS_FILE_BUFFER_SIZE</code> bytes into the buffer. */
+	LLFS_FILE_BUFFER_JOB_FLUSH, /*!< Write the write-behind data. */
+	LLFS_FILE_BUFFER_JOB_REWIND, /*!< Move the file pointer back to the logical position. */
+	LLFS_FILE_BUFFER_JOB_DIRECT, /*!< Transfer the data directly in the file: the transfer is too large for the buffer. */
+	LLFS_FILE_BUFFER_JOB_NONE /*!< No job: the transfer has been done in the buffer. */
+} LLFS_File_buffer_job_kind_t;
+
+/**
+ * @brief Read-ahead/write-behind buffer attached to an open file.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * Buffers are only accessed from the VM task. While a job is pending on a buffer, the worker
+ * owns <code>data</code> and the Java thread that started the job is suspended.
  */
-void LLFS_IMPL_get_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job);
+typedef struct {
+	int32_t file_id; /*!< ID of the buffered file, 0 if the buffer is free. */
+	LLFS_File_buffer_state_t state; /*!< State of the buffer. */
+	int32_t position; /*!< Offset in <code>data</code> of the next byte to read. */
+	int32_t count; /*!< Number of valid bytes in <code>data</code>. */
+	MICROEJ_ASYNC_WORKER_job_t* job; /*!< Pending job, NULL if none. */
+	LLFS_File_buffer_job_kind_t job_kind; /*!< Kind of the pending job. */
+	int32_t thread_id; /*!< Java thread waiting for the pending job. */
+	int32_t error_code; /*!< Error code of a failed flush, reported when the file is closed. */
+	char* error_message; /*!< Error message of a failed flush, NULL if none. */
+	uint8_t data[FS_FILE_BUFFER_SIZE]; /*!< Buffered data. */
+} LLFS_File_buffer_t;
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_set_read_only</code> and executed asynchronously via async_worker.
+ * @brief Returns the FS worker that executes the operations on a file or a directory.
+ * All the operations on the same file or directory are executed in order by the same worker.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @param[in] file_id the file or directory ID.
+ *
+ * @return the worker to allocate the job from.
  */
-void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job);
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_for_file(int32_t file_id);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_create</code> and executed asynchronously via async_worker.
+ * @brief Returns the FS worker that executes the next operation on a path (metadata, open, ...).
+ * The worker with the fewest queued jobs is selected, equally loaded workers are selected in turn.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @return the worker to allocate the job from.
  */
-void LLFS_IMPL_create_action(MICROEJ_ASYNC_WORKER_job_t* job);
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_for_path(void);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_open_directory</code> and executed asynchronously via async_worker.
+ * @brief Returns the FS worker a job has been allocated from.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @param[in] job a job allocated from one of the FS workers.
+ *
+ * @return the worker to execute and free the job with.
  */
-void LLFS_IMPL_open_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_of_job(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_read_directory</code> and executed asynchronously via async_worker.
+ * @brief Starts the reading of a range of an open file by native code, on the FS worker of the file
+ * (see <code>FS_read_range_t</code>). Must be called from a native, in the VM task.
+ *
+ * The write-behind data of the file is written first. The calling Java thread is suspended until the job is done,
+ * then <code>on_done</code> is called: it gets the job with <code>MICROEJ_ASYNC_WORKER_get_job_done</code> and frees
+ * it with <code>LLFS_worker_of_job</code>.
+ *
+ * @param[in] file_id the file ID.
+ * @param[in] position the position of the range in the file.
+ * @param[in] length the length of the range.
+ * @param[in] consumer the function receiving the data read, called from the FS worker task.
+ * @param[in] context the context given to <code>consumer</code>.
+ * @param[in] native the calling native, executed again when a job is available or the write-behind data is written.
+ * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
+ *
+ * @return <code>LLFS_OK</code> if the job has been started, else <code>LLFS_NOK</code>: the native will be executed
+ * again or an exception is pending.
+ */
+int32_t LLFS_File_read_range(int32_t file_id, int64_t position, int64_t length, FS_read_range_consumer_t consumer, void* context, SNI_callback native, SNI_callback on_done);
+
+/**
+ * @brief Initializes the file system helper. Called from <code>LLFS_IMPL_initialize</code> before the
+ * FS workers are started.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code>.
  */
-void LLFS_IMPL_read_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
+int32_t LLFS_helper_initialize(void);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_close_directory</code> and executed asynchronously via async_worker.
+ * @brief Locks the file and directory pools of the file system helper, and the other states of the helper shared
+ * by the FS workers.
+ */
+void LLFS_pool_lock(void);
+
+/**
+ * @brief Unlocks the pools locked by <code>LLFS_pool_lock</code>.
+ */
+void LLFS_pool_unlock(void);
+
+/**
+ * @brief Reserves an item of a pool of the file system helper, with the pools locked.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @param[in] pool_ctx the pool.
+ * @param[out] item the reserved item.
+ *
+ * @return the status of <code>POOL_reserve_f</code>.
  */
-void LLFS_IMPL_close_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
+POOL_status_t LLFS_pool_reserve(POOL_ctx_t* pool_ctx, void** item);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_rename_to</code> and executed asynchronously via async_worker.
+ * @brief Frees an item of a pool of the file system helper, with the pools locked.
  *
- * @param[in] job the context of the job, containing input/output parameters
+ * @param[in] pool_ctx the pool.
+ * @param[in] item the item to free.
+ *
+ * @return the status of <code>POOL_free_f</code>.
  */
-void LLFS_IMPL_rename_to_action(MICROEJ_ASYNC_WORKER_job_t* job);
+POOL_status_t LLFS_pool_free(POOL_ctx_t* pool_ctx, void* item);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_get_length</code> and executed asynchronously via async_worker.
+ * @brief Matches a name against a glob pattern, ignoring ASCII case like FatFs does.
+ *
+ * @param[in] pattern null terminated pattern, <code>*</code> matches any sequence and <code>?</code> any character.
+ * @param[in] name null terminated name.
+ *
+ * @return true if the name matches the pattern.
+ */
+bool LLFS_glob_match(const char* pattern, const char* name);
+
+/**
+ * @brief Writes a 16-bit value of a packed directory entry, in little endian.
+ */
+void LLFS_put_uint16(uint8_t* buffer, uint32_t value);
+
+/**
+ * @brief Writes a 64-bit value of a packed directory entry, in little endian.
+ */
+void LLFS_put_int64(uint8_t* buffer, int64_t value);
+
+/**
+ * @brief Action requested by <code>LLFS_IMPL_stat</code> and the other natives reading the attributes of a path,
+ * executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_stat_t</code>)
+ */
+void LLFS_IMPL_stat_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Invalidates the stat cache. Called on the VM task when an operation that modifies the
+ * file system is done.
+ */
+void LLFS_stat_cache_invalidate(void);
+
+/**
+ * @brief Action requested by <code>LLFS_IMPL_set_read_only</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_get_length_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_exist</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_create</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_exist_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_create_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_get_space_size</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_open_directory</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_get_space_size_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_open_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_make_directory</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_read_directory</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_make_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_read_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_is_hidden</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_read_directory_entries</code> and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_read_directory_entries_t</code>)
+ */
+void LLFS_IMPL_read_directory_entries_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested by <code>LLFS_IMPL_close_directory</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_is_hidden_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_close_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_is_directory</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_rename_to</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_is_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_rename_to_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_is_file</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_get_space_size</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_is_file_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_get_space_size_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_set_last_modified</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_make_directory</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_set_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_make_directory_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_delete</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_set_last_modified</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_delete_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_set_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
- * @brief Action requested by <code>LLFS_IMPL_is_accessible</code> and executed asynchronously via async_worker.
+ * @brief Action requested by <code>LLFS_IMPL_delete</code> and executed asynchronously via async_worker.
  *
  * @param[in] job the context of the job, containing input/output parameters
  */
-void LLFS_IMPL_is_accessible_action(MICROEJ_ASYNC_WORKER_job_t* job);
+void LLFS_IMPL_delete_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
 /**
  * @brief Action requested by <code>LLFS_IMPL_set_permission</code> and executed asynchronously via async_worker.
@@ -580,6 +861,321 @@ void LLFS_File_IMPL_available_action(MICROEJ_ASYNC_WORKER_job_t* job);
  */
 void LLFS_File_IMPL_flush_action(MICROEJ_ASYNC_WORKER_job_t* job);
 
+/**
+ * @brief Action requested by <code>LLFS_File_IMPL_read_at</code> and <code>LLFS_File_IMPL_read_extents</code>
+ * and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_extents_t</code>)
+ */
+void LLFS_File_IMPL_read_extents_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested by <code>LLFS_File_read_range</code> and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_read_range_t</code>)
+ */
+void LLFS_File_IMPL_read_range_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested by <code>LLFS_File_IMPL_write_at</code> and <code>LLFS_File_IMPL_write_extents</code>
+ * and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_extents_t</code>)
+ */
+void LLFS_File_IMPL_write_extents_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Computes the CRC of an append log record.
+ *
+ * @param[in] epoch the epoch of the log.
+ * @param[in] header the header of the record, its <code>length</code> and <code>sequence</code> fields are used.
+ * @param[in] payload the payload of the record, <code>header->length</code> bytes.
+ *
+ * @return the CRC-32 of the record.
+ */
+uint32_t LLFS_log_record_crc(uint32_t epoch, const FS_log_record_header_t* header, const uint8_t* payload);
+
+/**
+ * @brief Operations on an append log file, implemented by the file system helper for the append log framing
+ * functions below. The operations return 0 on success, else an error code of the file system.
+ */
+typedef struct {
+	int32_t (*read_at)(void* file, int64_t position, void* data, uint32_t length, uint32_t* count); /*!< Reads at a position, <code>count</code> is less than <code>length</code> at the end of the file. */
+	int32_t (*write_at)(void* file, int64_t position, const void* data, uint32_t length); /*!< Writes at a position, a short write is an error. */
+	int32_t (*preallocate)(void* file, int64_t capacity); /*!< Sets the size of an empty file. */
+	int32_t (*sync)(void* file); /*!< Commits the file. */
+	int64_t (*size)(void* file); /*!< Returns the size of the file. */
+	int32_t not_a_log; /*!< Error code returned by <code>LLFS_log_recover</code> when the file is not an append log. */
+} LLFS_log_file_ops_t;
+
+/**
+ * @brief Creates an append log in an empty file: preallocates it, writes the log file header and an end marker.
+ *
+ * @param[in] file the log file.
+ * @param[in] ops the operations on the log file.
+ * @param[in,out] param the parameters of the open operation.
+ *
+ * @return 0 on success, else the error code of the last failed operation.
+ */
+int32_t LLFS_log_create(void* file, const LLFS_log_file_ops_t* ops, FS_log_open_t* param);
+
+/**
+ * @brief Checks the records of an existing append log and finds the end of the last valid one.
+ *
+ * @param[in] file the log file.
+ * @param[in] ops the operations on the log file.
+ * @param[in,out] param the parameters of the open operation.
+ *
+ * @return 0 on success, <code>ops->not_a_log</code> if the file is not an append log, else the error code of the
+ * last failed operation.
+ */
+int32_t LLFS_log_recover(void* file, const LLFS_log_file_ops_t* ops, FS_log_open_t* param);
+
+/**
+ * @brief Reads and checks the record of an append log at <code>param->position</code>, sets the result of the
+ * read operation.
+ *
+ * @param[in] file the log file.
+ * @param[in] ops the operations on the log file.
+ * @param[in,out] param the parameters of the read operation.
+ *
+ * @return 0 if the record has been read or is corrupted, else the error code of the failed operation.
+ */
+int32_t LLFS_log_read_record(void* file, const LLFS_log_file_ops_t* ops, FS_log_read_t* param);
+
+/**
+ * @brief Action requested by <code>LLFS_LOG_IMPL_open</code> and executed asynchronously via async_worker.
+ * Creates and preallocates the log file, or recovers the valid records of an existing one.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_log_open_t</code>)
+ */
+void LLFS_LOG_IMPL_open_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested by <code>LLFS_LOG_IMPL_append</code>, <code>LLFS_LOG_IMPL_commit</code>,
+ * <code>LLFS_LOG_IMPL_read</code> and <code>LLFS_LOG_IMPL_close</code> and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_log_write_t</code>)
+ */
+void LLFS_LOG_IMPL_write_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested by <code>LLFS_LOG_IMPL_read</code> and executed asynchronously via async_worker.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_log_read_t</code>)
+ */
+void LLFS_LOG_IMPL_read_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Action requested when the read-ahead buffer of a file is dropped and executed asynchronously via async_worker.
+ * Moves the file pointer <code>n</code> bytes backward, <code>n</code> being the number of buffered bytes not yet consumed.
+ *
+ * @param[in] job the context of the job, containing input/output parameters (<code>FS_seek_t</code>)
+ */
+void LLFS_File_IMPL_rewind_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Resets a file buffer and attaches it to a file. The functions below implement the
+ * read-ahead/write-behind logic of the buffer, independent of SNI: the natives of <code>LLFS_File_impl.c</code>
+ * start and complete the jobs they request.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] file_id the file ID, 0 to free the buffer.
+ */
+void LLFS_File_buffer_initialize(LLFS_File_buffer_t* buffer, int32_t file_id);
+
+/**
+ * @brief Returns the number of read-ahead bytes not consumed yet.
+ *
+ * @param[in] buffer the file buffer.
+ *
+ * @return the number of bytes that can be read from the buffer.
+ */
+int32_t LLFS_File_buffer_unread(const LLFS_File_buffer_t* buffer);
+
+/**
+ * @brief Reads data from the read-ahead data of a file buffer.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[out] data the buffer where the data is copied.
+ * @param[in] length the maximum number of bytes to read.
+ * @param[out] read the number of bytes read, set when <code>LLFS_FILE_BUFFER_JOB_NONE</code> is returned.
+ *
+ * @return <code>LLFS_FILE_BUFFER_JOB_NONE</code> if the data has been read, <code>LLFS_FILE_BUFFER_JOB_DIRECT</code>
+ * if the data must be read directly in the file (at least <code>FS_FILE_BUFFER_SIZE</code> bytes), else the job to
+ * run on the buffer before reading again.
+ */
+LLFS_File_buffer_job_kind_t LLFS_File_buffer_read_data(LLFS_File_buffer_t* buffer, uint8_t* data, int32_t length, int32_t* read);
+
+/**
+ * @brief Appends data to the write-behind data of a file buffer.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] data the data to write.
+ * @param[in] length the number of bytes to write.
+ *
+ * @return <code>LLFS_FILE_BUFFER_JOB_NONE</code> if the data has been appended, <code>LLFS_FILE_BUFFER_JOB_DIRECT</code>
+ * if the data must be written directly in the file (at least <code>FS_FILE_BUFFER_SIZE</code> bytes), else the job to
+ * run on the buffer before writing again.
+ */
+LLFS_File_buffer_job_kind_t LLFS_File_buffer_write_data(LLFS_File_buffer_t* buffer, const uint8_t* data, int32_t length);
+
+/**
+ * @brief Sets the parameters of a job on a file buffer.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] kind the kind of job: <code>LLFS_FILE_BUFFER_JOB_REFILL</code>, <code>LLFS_FILE_BUFFER_JOB_FLUSH</code>
+ * or <code>LLFS_FILE_BUFFER_JOB_REWIND</code>.
+ * @param[out] params the parameters of the job.
+ *
+ * @return the action to execute with the job.
+ */
+MICROEJ_ASYNC_WORKER_action_t LLFS_File_buffer_set_job_params(LLFS_File_buffer_t* buffer, LLFS_File_buffer_job_kind_t kind, FS_worker_param_t* params);
+
+/**
+ * @brief Updates a file buffer with the result of a job set by <code>LLFS_File_buffer_set_job_params</code>.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] kind the kind of the job.
+ * @param[in] params the parameters of the done job.
+ * @param[out] error_code the error code, set when <code>LLFS_NOK</code> is returned.
+ * @param[out] error_message the error message, set when <code>LLFS_NOK</code> is returned.
+ *
+ * @return <code>LLFS_OK</code> on success, <code>LLFS_EOF</code> if a refill reached the end of the file,
+ * else <code>LLFS_NOK</code>.
+ */
+int32_t LLFS_File_buffer_job_done(LLFS_File_buffer_t* buffer, LLFS_File_buffer_job_kind_t kind, const FS_worker_param_t* params, int32_t* error_code, char** error_message);
+
+/**
+ * @brief Takes the bounce buffer for large transfers. Must be called from the VM task.
+ *
+ * @return the buffer of <code>FS_LARGE_IO_BUFFER_SIZE</code> bytes, allocated on first use, or NULL if it is used
+ * by another job or cannot be allocated.
+ */
+uint8_t* LLFS_large_io_buffer_take(void);
+
+/**
+ * @brief Releases the bounce buffer for large transfers if it is the given job data buffer. Must be called from
+ * the VM task.
+ *
+ * @param[in] data the data buffer of a read or write job.
+ */
+void LLFS_large_io_buffer_release(uint8_t* data);
+
+/**
+ * @brief Selects the bounce buffer of a read or write job on a Java array that is not immortal: the bounce buffer
+ * for large transfers if the data does not fit in the IO buffer of the job and it is free, else the IO buffer of
+ * the job. Must be called from the VM task.
+ *
+ * @param[in] job_buffer the IO buffer of the job.
+ * @param[in,out] buffer_length the length of <code>job_buffer</code>, set to the length of the selected buffer.
+ * @param[in] length the length of the data to transfer.
+ *
+ * @return the bounce buffer, released with <code>LLFS_large_io_buffer_release</code> when the job is done.
+ */
+uint8_t* LLFS_bounce_buffer_select(uint8_t* job_buffer, uint32_t* buffer_length, int64_t length);
+
+/**
+ * @brief Encodes an append log record in a group commit buffer: its header, with the CRC computed by
+ * <code>LLFS_log_record_crc</code>, followed by its payload.
+ *
+ * @param[out] record the buffer receiving the record, <code>sizeof(FS_log_record_header_t) + length</code> bytes.
+ * @param[in] epoch the epoch of the log.
+ * @param[in] sequence the sequence number of the record.
+ * @param[in] payload the payload of the record, must not overlap <code>record</code>.
+ * @param[in] length the length of the payload in bytes.
+ *
+ * @return the length of the encoded record in bytes.
+ */
+int32_t LLFS_log_encode_record(uint8_t* record, uint32_t epoch, uint32_t sequence, const uint8_t* payload, int32_t length);
+
+/**
+ * @brief Writes an end marker after the records of a group commit buffer, so that data left after the records by an
+ * interrupted write is never read. The buffer must have room for a <code>FS_log_record_header_t</code> after the records.
+ *
+ * @param[in,out] records the encoded records.
+ * @param[in] length the length of the records in bytes.
+ *
+ * @return the length of the records followed by the end marker.
+ */
+int32_t LLFS_log_append_end_marker(uint8_t* records, int32_t length);
+
+/**
+ * @brief A resource image mapped in the data address space by <code>LLFS_resource_image_map</code>.
+ */
+typedef struct {
+	const uint8_t* data; /*!< Start of the mapped image, NULL if the image is not mapped. */
+	uint32_t size; /*!< Mapped size: the header, the entries and the data of the resources. */
+	uint32_t count; /*!< Number of resources. */
+	void* handle; /*!< Handle of the mapping, given by <code>LLFS_resource_storage_map</code>. */
+} LLFS_resource_image_t;
+
+/**
+ * @brief Gets the size of the storage of the resource image: the FS_RESOURCE_PARTITION_LABEL partition on the
+ * ESP32, a file on a host.
+ *
+ * @return the size in bytes, 0 if there is no resource image storage.
+ */
+uint32_t LLFS_resource_storage_size(void);
+
+/**
+ * @brief Maps the beginning of the resource image storage in the data address space.
+ *
+ * @param[in] size the number of bytes to map, at most <code>LLFS_resource_storage_size()</code>.
+ * @param[out] data the address of the mapped bytes.
+ * @param[out] handle the handle of the mapping.
+ *
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code>.
+ */
+int32_t LLFS_resource_storage_map(uint32_t size, const uint8_t** data, void** handle);
+
+/**
+ * @brief Unmaps a mapping done by <code>LLFS_resource_storage_map</code>.
+ */
+void LLFS_resource_storage_unmap(void* handle);
+
+/**
+ * @brief Replaces the resource image, for example with an image downloaded by the application. Must not be called
+ * while the image is mapped: the new image is used after a restart.
+ *
+ * @param[in] image the image, as generated by <code>scripts/make_resource_image.py</code>.
+ * @param[in] size the size of the image in bytes.
+ *
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code>.
+ */
+int32_t LLFS_resource_storage_write(const uint8_t* image, uint32_t size);
+
+/**
+ * @brief Maps a resource image and validates its header and entries. The header is mapped first, then the entries,
+ * then only the range used by the image instead of the whole storage.
+ *
+ * @param[out] image the mapped image.
+ * @param[out] error_message the reason of the failure.
+ *
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code>.
+ */
+int32_t LLFS_resource_image_map(LLFS_resource_image_t* image, const char** error_message);
+
+/**
+ * @brief Unmaps a resource image mapped by <code>LLFS_resource_image_map</code>. The addresses of its resources must
+ * no longer be used.
+ */
+void LLFS_resource_image_unmap(LLFS_resource_image_t* image);
+
+/**
+ * @brief Looks up a resource of a mapped resource image by name.
+ *
+ * @return the resource ID, or <code>LLFS_NOK</code> if there is no resource with this name.
+ */
+int32_t LLFS_resource_image_find(const LLFS_resource_image_t* image, const char* name);
+
+/**
+ * @brief Gets an entry of a mapped resource image.
+ *
+ * @return the entry, NULL if <code>resource_id</code> is not valid.
+ */
+const LLFS_resource_image_entry_t* LLFS_resource_image_get_entry(const LLFS_resource_image_t* image, int32_t resource_id);
+
 #ifdef __cplusplus
 	}
 #endif
@@ -0,0 +1,165 @@
+/*
+ * C
+ *
+ * Copyright 2021-2023 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "fs_configuration.h"
+#include "LLFS_EXTENSION_impl.h"
+
+#ifdef FS_USE_LITTLEFS
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "spi_flash_mmap.h"
+#include "lfs.h"
+
+// LittleFS instance used by fs_helper_littlefs.c
+lfs_t LLFS_ESP32_lfs;
+
+static const esp_partition_t* LLFS_ESP32_partition;
+static struct lfs_config LLFS_ESP32_lfs_config;
+
+#ifdef LFS_THREADSAFE
+static SemaphoreHandle_t LLFS_ESP32_lfs_mutex;
+#endif
+
+// Tag of the log messages
+#define LLFS_ESP32_LOG_TAG "LLFS"
+
+// Number of blocks that hold the LittleFS superblock, at the beginning of the partition
+#define LLFS_ESP32_SUPERBLOCK_COUNT (2)
+
+// Flash statistics, indexed by LLFS_FLASH_STAT_*
+static int64_t LLFS_ESP32_statistics[LLFS_FLASH_STAT_COUNT];
+static portMUX_TYPE LLFS_ESP32_statistics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void LLFS_ESP32_count(int32_t statistic, uint32_t count) {
+	taskENTER_CRITICAL(&LLFS_ESP32_statistics_lock);
+	LLFS_ESP32_statistics[statistic] += count;
+	taskEXIT_CRITICAL(&LLFS_ESP32_statistics_lock);
+}
+
+static int LLFS_ESP32_lfs_read(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size) {
+	LLFS_ESP32_count(LLFS_FLASH_STAT_LOGICAL_READS, 1);
+	esp_err_t err = esp_partition_read(LLFS_ESP32_partition, (block * c->block_size) + off, buffer, size);
+	return (err == ESP_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int LLFS_ESP32_lfs_prog(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
+	// LittleFS programs whole cache lines, the file system and the flash see the same writes
+	LLFS_ESP32_count(LLFS_FLASH_STAT_LOGICAL_WRITES, 1);
+	LLFS_ESP32_count(LLFS_FLASH_STAT_PHYSICAL_WRITES, 1);
+	esp_err_t err = esp_partition_write(LLFS_ESP32_partition, (block * c->block_size) + off, buffer, size);
+	return (err == ESP_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int LLFS_ESP32_lfs_erase(const struct lfs_config* c, lfs_block_t block) {
+	LLFS_ESP32_count(LLFS_FLASH_STAT_PHYSICAL_ERASES, 1);
+	esp_err_t err = esp_partition_erase_range(LLFS_ESP32_partition, block * c->block_size, c->block_size);
+	return (err == ESP_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int LLFS_ESP32_lfs_sync(const struct lfs_config* c) {
+	(void)c;
+	// Writes to the SPI flash are not buffered
+	LLFS_ESP32_count(LLFS_FLASH_STAT_FLUSHES, 1);
+	return LFS_ERR_OK;
+}
+
+#ifdef LFS_THREADSAFE
+static int LLFS_ESP32_lfs_lock(const struct lfs_config* c) {
+	(void)c;
+	return (xSemaphoreTake(LLFS_ESP32_lfs_mutex, portMAX_DELAY) == pdTRUE) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int LLFS_ESP32_lfs_unlock(const struct lfs_config* c) {
+	(void)c;
+	return (xSemaphoreGive(LLFS_ESP32_lfs_mutex) == pdTRUE) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+#endif
+
+/**
+ * @brief Checks whether the superblocks of the partition are erased, i.e. the partition has never been formatted.
+ */
+static bool LLFS_ESP32_is_blank(void) {
+	uint32_t chunk[16];
+	size_t size = LLFS_ESP32_SUPERBLOCK_COUNT * SPI_FLASH_SEC_SIZE;
+	for (size_t address = 0; address < size; address += sizeof(chunk)) {
+		if (esp_partition_read(LLFS_ESP32_partition, address, chunk, sizeof(chunk)) != ESP_OK) {
+			return false;
+		}
+		for (size_t i = 0; i < (sizeof(chunk) / sizeof(chunk[0])); i++) {
+			if (chunk[i] != 0xFFFFFFFFu) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void LLFS_ESP32_init_littlefs(void) {
+	LLFS_ESP32_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FS_LITTLEFS_PARTITION_LABEL);
+	ESP_ERROR_CHECK((LLFS_ESP32_partition != NULL) ? ESP_OK : ESP_ERR_NOT_FOUND);
+
+#ifdef LFS_THREADSAFE
+	LLFS_ESP32_lfs_mutex = xSemaphoreCreateMutex();
+	ESP_ERROR_CHECK((LLFS_ESP32_lfs_mutex != NULL) ? ESP_OK : ESP_ERR_NO_MEM);
+	LLFS_ESP32_lfs_config.lock = &LLFS_ESP32_lfs_lock;
+	LLFS_ESP32_lfs_config.unlock = &LLFS_ESP32_lfs_unlock;
+#endif
+	LLFS_ESP32_lfs_config.read = &LLFS_ESP32_lfs_read;
+	LLFS_ESP32_lfs_config.prog = &LLFS_ESP32_lfs_prog;
+	LLFS_ESP32_lfs_config.erase = &LLFS_ESP32_lfs_erase;
+	LLFS_ESP32_lfs_config.sync = &LLFS_ESP32_lfs_sync;
+	LLFS_ESP32_lfs_config.read_size = 16;
+	LLFS_ESP32_lfs_config.prog_size = 16;
+	LLFS_ESP32_lfs_config.block_size = SPI_FLASH_SEC_SIZE;
+	LLFS_ESP32_lfs_config.block_count = LLFS_ESP32_partition->size / SPI_FLASH_SEC_SIZE;
+	LLFS_ESP32_lfs_config.block_cycles = FS_LITTLEFS_BLOCK_CYCLES;
+	LLFS_ESP32_lfs_config.cache_size = FS_LITTLEFS_CACHE_SIZE;
+	LLFS_ESP32_lfs_config.lookahead_size = FS_LITTLEFS_LOOKAHEAD_SIZE;
+
+	int res = lfs_mount(&LLFS_ESP32_lfs, &LLFS_ESP32_lfs_config);
+	if (res != LFS_ERR_OK) {
+		bool format;
+		if ((res == LFS_ERR_CORRUPT) && LLFS_ESP32_is_blank()) {
+			// First mount: the partition has never been formatted
+			ESP_LOGW(LLFS_ESP32_LOG_TAG, "partition '%s' is blank, formatting it", FS_LITTLEFS_PARTITION_LABEL);
+			format = true;
+		}
+		else {
+#ifdef FS_LITTLEFS_FORMAT_IF_MOUNT_FAILED
+			ESP_LOGE(LLFS_ESP32_LOG_TAG, "mount of partition '%s' failed (%d), FORMATTING IT: ALL ITS FILES ARE LOST", FS_LITTLEFS_PARTITION_LABEL, res);
+			format = true;
+#else
+			ESP_LOGE(LLFS_ESP32_LOG_TAG, "mount of partition '%s' failed (%d), define FS_LITTLEFS_FORMAT_IF_MOUNT_FAILED to format it", FS_LITTLEFS_PARTITION_LABEL, res);
+			format = false;
+#endif
+		}
+		if (format) {
+			res = lfs_format(&LLFS_ESP32_lfs, &LLFS_ESP32_lfs_config);
+			if (res == LFS_ERR_OK) {
+				res = lfs_mount(&LLFS_ESP32_lfs, &LLFS_ESP32_lfs_config);
+			}
+		}
+	}
+	ESP_ERROR_CHECK((res == LFS_ERR_OK) ? ESP_OK : ESP_FAIL);
+}
+
+void LLFS_ESP32_get_flash_statistics(int64_t* statistics, bool reset) {
+	taskENTER_CRITICAL(&LLFS_ESP32_statistics_lock);
+	(void)memcpy(statistics, LLFS_ESP32_statistics, sizeof(LLFS_ESP32_statistics));
+	if (reset) {
+		(void)memset(LLFS_ESP32_statistics, 0, sizeof(LLFS_ESP32_statistics));
+	}
+	taskEXIT_CRITICAL(&LLFS_ESP32_statistics_lock);
+}
+
+#endif // FS_USE_LITTLEFS
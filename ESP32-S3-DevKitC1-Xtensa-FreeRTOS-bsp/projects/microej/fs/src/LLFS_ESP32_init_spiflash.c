@@ -5,8 +5,15 @@
  * Use of this source code is governed by a BSD-style license that can be found with this software.
  */
 
+#include <stdbool.h>
+#include <string.h>
 #include "fs_configuration.h"
+#include "LLFS_EXTENSION_impl.h"
 
+#ifndef FS_USE_LITTLEFS
+
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
 #include "esp_vfs_fat.h"
 #include "esp_partition.h"
 #include "wear_levelling.h"
@@ -16,13 +23,290 @@
 // Mount path for the partition
 const char *base_path = "/spiflash";
 
+// Maximum number of files open at the same time
+#define LLFS_ESP32_MAX_FILES (30)
+
+/**
+ * @brief A sector of the wear-leveling partition kept in RAM.
+ */
+typedef struct {
+	uint8_t* data; /*!< Content of the sector, NULL if the entry could not be allocated. */
+	uint32_t sector; /*!< Number of the sector. */
+	uint32_t last_use; /*!< Value of the cache clock the last time the sector was accessed. */
+	bool valid; /*!< true if the entry holds a sector. */
+	bool dirty; /*!< true if the sector has been modified since it was written to the flash. */
+} LLFS_ESP32_cache_entry_t;
+
+static wl_handle_t LLFS_ESP32_wl_handle = WL_INVALID_HANDLE;
+static size_t LLFS_ESP32_sector_size;
+
+#if FS_SECTOR_CACHE_COUNT > 0
+static LLFS_ESP32_cache_entry_t LLFS_ESP32_cache[FS_SECTOR_CACHE_COUNT];
+static uint32_t LLFS_ESP32_cache_clock;
+#endif
+
+// Flash statistics, indexed by LLFS_FLASH_STAT_*
+static int64_t LLFS_ESP32_statistics[LLFS_FLASH_STAT_COUNT];
+static portMUX_TYPE LLFS_ESP32_statistics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void LLFS_ESP32_count(int32_t statistic, uint32_t count) {
+	taskENTER_CRITICAL(&LLFS_ESP32_statistics_lock);
+	LLFS_ESP32_statistics[statistic] += count;
+	taskEXIT_CRITICAL(&LLFS_ESP32_statistics_lock);
+}
+
+/**
+ * @brief Erases and writes consecutive sectors to the wear-leveling layer.
+ */
+static DRESULT LLFS_ESP32_write_sectors(const uint8_t* buff, uint32_t sector, uint32_t count) {
+	size_t address = sector * LLFS_ESP32_sector_size;
+	size_t size = count * LLFS_ESP32_sector_size;
+
+	LLFS_ESP32_count(LLFS_FLASH_STAT_PHYSICAL_ERASES, count);
+	if (wl_erase_range(LLFS_ESP32_wl_handle, address, size) != ESP_OK) {
+		return RES_ERROR;
+	}
+	LLFS_ESP32_count(LLFS_FLASH_STAT_PHYSICAL_WRITES, count);
+	if (wl_write(LLFS_ESP32_wl_handle, address, buff, size) != ESP_OK) {
+		return RES_ERROR;
+	}
+	return RES_OK;
+}
+
+#if FS_SECTOR_CACHE_COUNT > 0
+/**
+ * @brief Returns the cache entry of a sector, NULL if the sector is not cached.
+ */
+static LLFS_ESP32_cache_entry_t* LLFS_ESP32_cache_find(uint32_t sector) {
+	for (int32_t i = 0; i < FS_SECTOR_CACHE_COUNT; i++) {
+		LLFS_ESP32_cache_entry_t* entry = &LLFS_ESP32_cache[i];
+		if (entry->valid && (entry->sector == sector)) {
+			entry->last_use = ++LLFS_ESP32_cache_clock;
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Writes a dirty cache entry back to the flash.
+ */
+static DRESULT LLFS_ESP32_cache_write_back(LLFS_ESP32_cache_entry_t* entry) {
+	DRESULT result = RES_OK;
+	if (entry->valid && entry->dirty) {
+		result = LLFS_ESP32_write_sectors(entry->data, entry->sector, 1);
+		if (result == RES_OK) {
+			entry->dirty = false;
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Returns a free cache entry for a sector, evicting the least recently used one.
+ * Returns NULL if no entry is available or if the evicted sector could not be written back.
+ */
+static LLFS_ESP32_cache_entry_t* LLFS_ESP32_cache_allocate(uint32_t sector) {
+	LLFS_ESP32_cache_entry_t* victim = NULL;
+	for (int32_t i = 0; i < FS_SECTOR_CACHE_COUNT; i++) {
+		LLFS_ESP32_cache_entry_t* entry = &LLFS_ESP32_cache[i];
+		if (entry->data != NULL) {
+			if (!entry->valid) {
+				victim = entry;
+				break;
+			}
+			if ((victim == NULL) || (entry->last_use < victim->last_use)) {
+				victim = entry;
+			}
+		}
+	}
+
+	if ((victim != NULL) && (LLFS_ESP32_cache_write_back(victim) != RES_OK)) {
+		victim = NULL;
+	}
+	if (victim != NULL) {
+		victim->valid = false;
+		victim->sector = sector;
+		victim->last_use = ++LLFS_ESP32_cache_clock;
+	}
+	return victim;
+}
+#endif // FS_SECTOR_CACHE_COUNT > 0
+
+/**
+ * @brief Writes all the dirty sectors of the cache to the flash.
+ */
+static DRESULT LLFS_ESP32_cache_flush(void) {
+	DRESULT result = RES_OK;
+#if FS_SECTOR_CACHE_COUNT > 0
+	for (int32_t i = 0; i < FS_SECTOR_CACHE_COUNT; i++) {
+		if (LLFS_ESP32_cache_write_back(&LLFS_ESP32_cache[i]) != RES_OK) {
+			result = RES_ERROR;
+		}
+	}
+#endif
+	LLFS_ESP32_count(LLFS_FLASH_STAT_FLUSHES, 1);
+	return result;
+}
+
+static DSTATUS LLFS_ESP32_disk_initialize(BYTE pdrv) {
+	(void)pdrv;
+	return 0;
+}
+
+static DSTATUS LLFS_ESP32_disk_status(BYTE pdrv) {
+	(void)pdrv;
+	return 0;
+}
+
+static DRESULT LLFS_ESP32_disk_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
+	(void)pdrv;
+	LLFS_ESP32_count(LLFS_FLASH_STAT_LOGICAL_READS, count);
+
+	for (UINT i = 0; i < count; i++) {
+		uint8_t* sector_buff = buff + (i * LLFS_ESP32_sector_size);
+#if FS_SECTOR_CACHE_COUNT > 0
+		LLFS_ESP32_cache_entry_t* entry = LLFS_ESP32_cache_find(sector + i);
+		if (entry != NULL) {
+			LLFS_ESP32_count(LLFS_FLASH_STAT_CACHE_HITS, 1);
+			(void)memcpy(sector_buff, entry->data, LLFS_ESP32_sector_size);
+			continue;
+		}
+		if (count == 1) {
+			// Single sector reads are FAT and directory accesses: keep them in the cache
+			entry = LLFS_ESP32_cache_allocate(sector);
+			if (entry != NULL) {
+				if (wl_read(LLFS_ESP32_wl_handle, sector * LLFS_ESP32_sector_size, entry->data, LLFS_ESP32_sector_size) != ESP_OK) {
+					return RES_ERROR;
+				}
+				entry->valid = true;
+				entry->dirty = false;
+				(void)memcpy(sector_buff, entry->data, LLFS_ESP32_sector_size);
+				continue;
+			}
+		}
+#endif
+		if (wl_read(LLFS_ESP32_wl_handle, (sector + i) * LLFS_ESP32_sector_size, sector_buff, LLFS_ESP32_sector_size) != ESP_OK) {
+			return RES_ERROR;
+		}
+	}
+	return RES_OK;
+}
+
+static DRESULT LLFS_ESP32_disk_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count) {
+	(void)pdrv;
+	LLFS_ESP32_count(LLFS_FLASH_STAT_LOGICAL_WRITES, count);
+
+#if FS_SECTOR_CACHE_COUNT > 0
+	// Consecutive sectors that are not cached are written directly, as a single range
+	UINT run_start = 0;
+	UINT run_count = 0;
+	for (UINT i = 0; i < count; i++) {
+		const uint8_t* sector_buff = buff + (i * LLFS_ESP32_sector_size);
+		LLFS_ESP32_cache_entry_t* entry = LLFS_ESP32_cache_find(sector + i);
+		if (entry != NULL) {
+			// Coalesced with the previous writes of the sector
+			LLFS_ESP32_count(LLFS_FLASH_STAT_CACHE_HITS, 1);
+		}
+		else if (count == 1) {
+			entry = LLFS_ESP32_cache_allocate(sector);
+		}
+
+		if (entry == NULL) {
+			if (run_count == 0) {
+				run_start = i;
+			}
+			run_count++;
+			continue;
+		}
+		if (run_count > 0) {
+			if (LLFS_ESP32_write_sectors(buff + (run_start * LLFS_ESP32_sector_size), sector + run_start, run_count) != RES_OK) {
+				return RES_ERROR;
+			}
+			run_count = 0;
+		}
+		(void)memcpy(entry->data, sector_buff, LLFS_ESP32_sector_size);
+		entry->valid = true;
+		entry->dirty = true;
+	}
+	if (run_count > 0) {
+		return LLFS_ESP32_write_sectors(buff + (run_start * LLFS_ESP32_sector_size), sector + run_start, run_count);
+	}
+	return RES_OK;
+#else
+	return LLFS_ESP32_write_sectors(buff, sector, count);
+#endif
+}
+
+static DRESULT LLFS_ESP32_disk_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
+	(void)pdrv;
+	switch (cmd) {
+	case CTRL_SYNC:
+		// Called by FatFs when a file is synced or closed
+		return LLFS_ESP32_cache_flush();
+	case GET_SECTOR_COUNT:
+		*((DWORD*)buff) = wl_size(LLFS_ESP32_wl_handle) / LLFS_ESP32_sector_size;
+		return RES_OK;
+	case GET_SECTOR_SIZE:
+		*((WORD*)buff) = LLFS_ESP32_sector_size;
+		return RES_OK;
+	default:
+		return RES_ERROR;
+	}
+}
+
+static const ff_diskio_impl_t LLFS_ESP32_diskio = {
+	.init = &LLFS_ESP32_disk_initialize,
+	.status = &LLFS_ESP32_disk_status,
+	.read = &LLFS_ESP32_disk_read,
+	.write = &LLFS_ESP32_disk_write,
+	.ioctl = &LLFS_ESP32_disk_ioctl
+};
+
 void LLFS_ESP32_init_spiflash(void) {
-	wl_handle_t wl_handle;
+	BYTE pdrv;
+	FATFS* fs;
 
-	esp_vfs_fat_mount_config_t mount_config;
-	mount_config.format_if_mount_failed = true;
-	mount_config.max_files = 30;
-	mount_config.allocation_unit_size = 0;
+	// Same as esp_vfs_fat_spiflash_mount_rw_wl(), with the sector cache between FatFs and the wear-leveling layer
+	const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_FAT, NULL);
+	ESP_ERROR_CHECK((partition != NULL) ? ESP_OK : ESP_ERR_NOT_FOUND);
+	ESP_ERROR_CHECK(wl_mount(partition, &LLFS_ESP32_wl_handle));
+	LLFS_ESP32_sector_size = wl_sector_size(LLFS_ESP32_wl_handle);
 
-	ESP_ERROR_CHECK(esp_vfs_fat_spiflash_mount_rw_wl(base_path, NULL, &mount_config, &wl_handle));
+#if FS_SECTOR_CACHE_COUNT > 0
+	for (int32_t i = 0; i < FS_SECTOR_CACHE_COUNT; i++) {
+		// The cache works with fewer entries if the memory is not available
+		LLFS_ESP32_cache[i].data = (uint8_t*)heap_caps_malloc(LLFS_ESP32_sector_size, FS_SECTOR_CACHE_CAPS);
+	}
+#endif
+
+	ESP_ERROR_CHECK(ff_diskio_get_drive(&pdrv));
+	ff_diskio_register(pdrv, &LLFS_ESP32_diskio);
+	char drive[3] = {(char)('0' + pdrv), ':', '\0'};
+	ESP_ERROR_CHECK(esp_vfs_fat_register(base_path, drive, LLFS_ESP32_MAX_FILES, &fs));
+
+	FRESULT fresult = f_mount(fs, drive, 1);
+	if ((fresult == FR_NO_FILESYSTEM) || (fresult == FR_INT_ERR)) {
+		// Format the partition
+		void* work_buffer = ff_memalloc(FF_MAX_SS);
+		ESP_ERROR_CHECK((work_buffer != NULL) ? ESP_OK : ESP_ERR_NO_MEM);
+		const MKFS_PARM options = {(BYTE)(FM_ANY | FM_SFD), 0, 0, 0, LLFS_ESP32_sector_size};
+		fresult = f_mkfs(drive, &options, work_buffer, FF_MAX_SS);
+		ff_memfree(work_buffer);
+		if (fresult == FR_OK) {
+			fresult = f_mount(fs, drive, 0);
+		}
+	}
+	ESP_ERROR_CHECK((fresult == FR_OK) ? ESP_OK : ESP_FAIL);
 }
+
+void LLFS_ESP32_get_flash_statistics(int64_t* statistics, bool reset) {
+	taskENTER_CRITICAL(&LLFS_ESP32_statistics_lock);
+	(void)memcpy(statistics, LLFS_ESP32_statistics, sizeof(LLFS_ESP32_statistics));
+	if (reset) {
+		(void)memset(LLFS_ESP32_statistics, 0, sizeof(LLFS_ESP32_statistics));
+	}
+	taskEXIT_CRITICAL(&LLFS_ESP32_statistics_lock);
+}
+
+#endif // FS_USE_LITTLEFS
@@ -0,0 +1,77 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Resource image storage in the FS_RESOURCE_PARTITION_LABEL partition, mapped with esp_partition_mmap.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ */
+
+#include <stdint.h>
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "spi_flash_mmap.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Returns the resource image partition, NULL if the partition table has none.
+ */
+static const esp_partition_t* LLFS_ESP32_resource_partition(void) {
+	static const esp_partition_t* partition = NULL;
+	if (partition == NULL) {
+		partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FS_RESOURCE_PARTITION_LABEL);
+	}
+	return partition;
+}
+
+uint32_t LLFS_resource_storage_size(void) {
+	const esp_partition_t* partition = LLFS_ESP32_resource_partition();
+	return (partition == NULL) ? 0U : (uint32_t)partition->size;
+}
+
+int32_t LLFS_resource_storage_map(uint32_t size, const uint8_t** data, void** handle) {
+	const esp_partition_t* partition = LLFS_ESP32_resource_partition();
+	const void* ptr;
+	spi_flash_mmap_handle_t mmap_handle;
+
+	// The MMU maps whole pages: only the pages holding the requested range use the data address space
+	if ((partition == NULL) || (esp_partition_mmap(partition, 0, size, SPI_FLASH_MMAP_DATA, &ptr, &mmap_handle) != ESP_OK)) {
+		return LLFS_NOK;
+	}
+	*data = (const uint8_t*)ptr;
+	*handle = (void*)(uintptr_t)mmap_handle;
+	return LLFS_OK;
+}
+
+void LLFS_resource_storage_unmap(void* handle) {
+	spi_flash_munmap((spi_flash_mmap_handle_t)(uintptr_t)handle);
+}
+
+int32_t LLFS_resource_storage_write(const uint8_t* image, uint32_t size) {
+	const esp_partition_t* partition = LLFS_ESP32_resource_partition();
+	if ((partition == NULL) || (size > partition->size)) {
+		return LLFS_NOK;
+	}
+
+	uint32_t erase_size = ((size + partition->erase_size - 1U) / partition->erase_size) * partition->erase_size;
+	esp_err_t err = esp_partition_erase_range(partition, 0, erase_size);
+	if (err == ESP_OK) {
+		err = esp_partition_write(partition, 0, image, size);
+	}
+	LLFS_DEBUG_TRACE("[%s:%u] write %lu bytes of resource image (err %d)\n", __func__, __LINE__, size, err);
+	return (err == ESP_OK) ? LLFS_OK : LLFS_NOK;
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -1,661 +1,1336 @@
-/*
- * C
- *
- * Copyright 2015-2023 MicroEJ Corp. All rights reserved.
- * Use of this source code is governed by a BSD-style license that can be found with this software.
- */
-
-/**
- * @file
- * @brief LLFS_File implementation with async worker.
- * @author MicroEJ Developer Team
- * @version 2.1.1
- * @date 26 April 2023
- */
-
-/* Includes ------------------------------------------------------------------*/
-
-#include <stdbool.h>
-#include <stddef.h>
-#include "sni.h"
-#include "LLFS_impl.h"
-#include "LLFS_File_impl.h"
-#include "fs_configuration.h"
-#include "fs_helper.h"
-
-#ifdef __cplusplus
-	extern "C" {
-#endif
-
-/**
- * Sanity check between the expected version of the configuration and the actual version of
- * the configuration.
- * If an error is raised here, it means that a new version of the CCO has been installed and
- * the configuration fs_configuration.h must be updated based on the one provided
- * by the new CCO version.
- */
-#if FS_CONFIGURATION_VERSION != 1
-
-	#error "Version of the configuration file fs_configuration.h is not compatible with this implementation."
-
-#endif
-
-static int32_t LLFS_async_exec_write_read_job(int32_t file_id, uint8_t* data, int32_t offset, int32_t length, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
-static int32_t LLFS_async_exec_write_read_byte_job(int32_t file_id, int32_t data, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
-static int32_t LLFS_File_IMPL_open_on_done(uint8_t* path, uint8_t mode);
-static int32_t LLFS_File_IMPL_write_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length);
-static void LLFS_File_IMPL_write_byte_on_done(int32_t file_id, int32_t data);
-static int32_t LLFS_File_IMPL_read_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length);
-static int32_t LLFS_File_IMPL_read_byte_on_done(int32_t file_id);
-static void LLFS_File_IMPL_close_on_done(int32_t file_id);
-static void LLFS_File_IMPL_seek_on_done(int32_t file_id, int64_t n);
-static int64_t LLFS_File_IMPL_get_file_pointer_on_done(int32_t file_id);
-static void LLFS_File_IMPL_set_length_on_done(int32_t file_id, int64_t newLength);
-static int64_t LLFS_File_IMPL_get_length_with_fd_on_done(int32_t file_id);
-static int32_t LLFS_File_IMPL_available_on_done(int32_t file_id);
-static void LLFS_File_IMPL_flush_on_done(int32_t file_id);
-
-int32_t LLFS_File_IMPL_open(uint8_t* path, uint8_t mode){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_open);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return LLFS_NOK;
-	}
-
-	FS_open_t* params = (FS_open_t*)job->params;
-	if(LLFS_set_path_param(path, (uint8_t*)&params->path) != LLFS_OK){
-		SNI_throwNativeIOException(LLFS_NOK, "Path name too long");
-	}
-	else{
-		params->mode = mode;
-
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_open_action, (SNI_callback)LLFS_File_IMPL_open_on_done);
-		if(status == MICROEJ_ASYNC_WORKER_OK){
-			// Wait for the action to be done
-			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
-		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-	}
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-int32_t LLFS_File_IMPL_write(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
-	return LLFS_async_exec_write_read_job(file_id, data, offset, length, true, (SNI_callback)LLFS_File_IMPL_write, LLFS_File_IMPL_write_action, (SNI_callback)LLFS_File_IMPL_write_on_done);
-}
-
-void LLFS_File_IMPL_write_byte(int32_t file_id, int32_t data){
-	(void)LLFS_async_exec_write_read_byte_job(file_id, data, true, (SNI_callback)LLFS_File_IMPL_write_byte, LLFS_File_IMPL_write_action, (SNI_callback)LLFS_File_IMPL_write_byte_on_done);
-}
-
-int32_t LLFS_File_IMPL_read(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
-	return LLFS_async_exec_write_read_job(file_id, data, offset, length, false, (SNI_callback)LLFS_File_IMPL_read, LLFS_File_IMPL_read_action, (SNI_callback)LLFS_File_IMPL_read_on_done);
-}
-
-int32_t LLFS_File_IMPL_read_byte(int32_t file_id){
-	return LLFS_async_exec_write_read_byte_job(file_id, 0, false, (SNI_callback)LLFS_File_IMPL_read_byte, LLFS_File_IMPL_read_action, (SNI_callback)LLFS_File_IMPL_read_byte_on_done);
-}
-
-void LLFS_File_IMPL_close(int32_t file_id) {
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_close);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return;
-	}
-
-	FS_close_t* params = (FS_close_t*)job->params;
-	params->file_id = file_id;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_close_action, (SNI_callback)LLFS_File_IMPL_close_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-void LLFS_File_IMPL_seek(int32_t file_id, int64_t n){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_seek);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return;
-	}
-
-	FS_seek_t* params = (FS_seek_t*)job->params;
-	params->file_id = file_id;
-	params->n = n;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_seek_action, (SNI_callback)LLFS_File_IMPL_seek_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return;
-}
-
-int64_t LLFS_File_IMPL_get_file_pointer(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_get_file_pointer);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return SNI_IGNORED_RETURNED_VALUE;;
-	}
-
-	FS_getfp_t* params = (FS_getfp_t*)job->params;
-	params->file_id = file_id;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_get_file_pointer_action, (SNI_callback)LLFS_File_IMPL_get_file_pointer_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return SNI_IGNORED_RETURNED_VALUE;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-void LLFS_File_IMPL_set_length(int32_t file_id, int64_t newLength){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_set_length);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return;
-	}
-
-	FS_set_length_t* params = (FS_set_length_t*)job->params;
-	params->file_id = file_id;
-	params->length = newLength;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_set_length_action, (SNI_callback)LLFS_File_IMPL_set_length_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return;
-}
-
-int64_t LLFS_File_IMPL_get_length_with_fd(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_get_length_with_fd);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return SNI_IGNORED_RETURNED_VALUE;
-	}
-
-	FS_get_length_with_fd_t* params = (FS_get_length_with_fd_t*)job->params;
-	params->file_id = file_id;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_get_length_with_fd_action, (SNI_callback)LLFS_File_IMPL_get_length_with_fd_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return SNI_IGNORED_RETURNED_VALUE;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-int32_t LLFS_File_IMPL_available(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_available);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return LLFS_NOK;
-	}
-
-	FS_available_t* params = (FS_available_t*)job->params;
-	params->file_id = file_id;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_available_action, (SNI_callback)LLFS_File_IMPL_available_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return SNI_IGNORED_RETURNED_VALUE;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-
-void LLFS_File_IMPL_flush(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_File_IMPL_flush);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return;
-	}
-
-	FS_flush_t* params = (FS_flush_t*)job->params;
-	params->file_id = file_id;
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_File_IMPL_flush_action, (SNI_callback)LLFS_File_IMPL_flush_on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return;
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-/**
- * @brief Prepare and send an execution job to async_worker, called either from
- * <code>LLFS_File_IMPL_write</code> or <code>LLFS_File_IMPL_read</code>.
- *
- * @param[in] file_id file identifier.
- * @param[in] data buffer used for reading or writing operations.
- * @param[in] offset the offset inside the buffer where the data has to be manipulated.
- * @param[in] length buffer length.
- * @param[in] exec_write true if the data buffer content need to be sent to the async_worker job, else false.
- * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
- * @param[in] action the function to execute asynchronously.
- * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
- *
- * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
- */
-static int32_t LLFS_async_exec_write_read_job(int32_t file_id, uint8_t* data, int32_t offset, int32_t length, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done){
-
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, retry_function);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return LLFS_NOK;
-	}
-
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	bool do_copy = exec_write;
-	int32_t result = SNI_retrieveArrayElements((int8_t *)data, offset, length, (int8_t*)&params->buffer, sizeof(params->buffer), (int8_t**)&params->data, (uint32_t *)&params->length, do_copy);
-
-	if(result != SNI_OK){
-		SNI_throwNativeIOException(result, "SNI_retrieveArrayElements: Internal error");
-	}
-	else {
-		params->file_id = file_id;
-
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, action, on_done);
-		if(status == MICROEJ_ASYNC_WORKER_OK){
-			// Wait for the action to be done
-			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
-		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-	}
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-/**
- * @brief Prepare and send an execution job to async_worker, called either from
- * <code>LLFS_File_IMPL_write_byte</code> or <code>LLFS_File_IMPL_read_byte</code>.
- *
- * @param[in] file_id file identifier.
- * @param[in/out] data byte to be read/written.
- * @param[in] exec_write true if the data buffer content need to be sent to the async_worker job, else false.
- * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
- * @param[in] action the function to execute asynchronously.
- * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
- *
- * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
- */
-static int32_t LLFS_async_exec_write_read_byte_job(int32_t file_id, int32_t data, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, retry_function);
-	if(job == NULL){
-		// No job available, either:
-		// - wait for a job to be available and this function to be executed again,
-		// - or an exception is pending
-		return LLFS_NOK;
-	}
-
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	params->file_id = file_id;
-	params->data = (uint8_t*)&params->buffer;
-	params->length = sizeof(uint8_t);
-	if(exec_write == true){
-		params->buffer[0] = (uint8_t)data;
-	}
-
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, action, on_done);
-	if(status == MICROEJ_ASYNC_WORKER_OK){
-		// Wait for the action to be done
-		return SNI_IGNORED_RETURNED_VALUE;//returned value not used
-	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-
-	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return LLFS_NOK;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_open</code> is done.
- *
- * @param[in] path absolute path of file to open.
- * @param[in] mode opening mode.
- *
- * @return <code>LLFS_File_IMPL_open_action</code> function return code.
- */
-static int32_t LLFS_File_IMPL_open_on_done(uint8_t* path, uint8_t mode){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_open_t* params = (FS_open_t*)job->params;
-
-	(void)path;
-	(void)mode;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write</code> is done.
- *
- * @param[in] file_id file identifier.
- * @param[in] data buffer used for writing operations.
- * @param[in] offset the offset inside the buffer where the data has to be manipulated.
- * @param[in] length buffer length.
- *
- * @return <code>LLFS_File_IMPL_write_action</code> function return code.
- */
-static int32_t LLFS_File_IMPL_write_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	(void)file_id;
-	(void)data;
-	(void)offset;
-	(void)length;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read</code> is done.
- *
- * @param[in] file_id file identifier.
- * @param[out] data buffer used for reading operations.
- * @param[in] offset the offset inside the buffer where the data has to be manipulated.
- * @param[in] length buffer length.
- *
- * @return <code>LLFS_File_IMPL_read_action</code> function return code.
- */
-static int32_t LLFS_File_IMPL_read_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	(void)file_id;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	else if(result != LLFS_EOF){
-		int32_t release_result = SNI_flushArrayElements((int8_t*)data, offset, length, (int8_t*)params->data, result);
-		if(release_result != SNI_OK){
-			SNI_throwNativeIOException(release_result, "SNI_flushArrayElements: Internal error");
-		}
-	}else{
-		// Successful: result hold the number of read bytes.
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write_byte</code> is done.
- *
- * @param[in] file_id file identifier.
- * @param[in] data byte to be written.
- *
- * @return <code>LLFS_File_IMPL_write_action</code> function return code.
- */
-static void LLFS_File_IMPL_write_byte_on_done(int32_t file_id, int32_t data){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	(void)file_id;
-	(void)data;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read_byte</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_File_IMPL_read_action</code> function return code.
- */
-static int32_t LLFS_File_IMPL_read_byte_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_write_read_t* params = (FS_write_read_t*)job->params;
-
-	(void)file_id;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	else if(result == 1) {
-		// 1 byte read: return the read byte
-		result = (uint8_t)params->data[0];
-	}
-	else if(result != LLFS_EOF) {
-		// Invalid value returned by the read_byte action
-		SNI_throwNativeIOException(result, "Internal error");
-	}
-	else{
-		// Successful: result hold the number of read bytes.
-	}
-	// else: result==LLFS_EOF: just return LLFS_EOF
-	
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_close</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_File_IMPL_close_action</code> function return code.
- */
-static void LLFS_File_IMPL_close_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_close_t* params = (FS_close_t*)job->params;
-
-	(void)file_id;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_seek</code> is done.
- *
- * @param[in] file_id file identifier.
- * @param[in] n the new position of the file pointer.
- *
- * @return <code>LLFS_File_IMPL_seek_action</code> function return code.
- */
-static void LLFS_File_IMPL_seek_on_done(int32_t file_id, int64_t n){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_seek_t* params = (FS_seek_t*)job->params;
-
-	(void)file_id;
-	(void)n;
-
-	if(params->result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_get_file_pointer</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_File_IMPL_get_file_pointer_on_done</code> function return code.
- */
-static int64_t LLFS_File_IMPL_get_file_pointer_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_getfp_t* params = (FS_getfp_t*)job->params;
-
-	(void)file_id;
-
-	int64_t result = params->result;
-	if(params->result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-		return LLFS_NOK;
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_set_length</code> is done.
- *
- * @param[in] file_id file identifier.
- * @param[in] newLength the new length of the file.
- *
- * @return <code>LLFS_File_IMPL_set_length_action</code> function return code.
- */
-static void LLFS_File_IMPL_set_length_on_done(int32_t file_id, int64_t newLength){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_set_length_t* params = (FS_set_length_t*)job->params;
-
-	(void)file_id;
-	(void)newLength;
-
-	if(params->result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_get_length_with_fd</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_IMPL_get_length_with_fd_action</code> function return code.
- */
-static int64_t LLFS_File_IMPL_get_length_with_fd_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_get_length_with_fd_t* params = (FS_get_length_with_fd_t*)job->params;
-
-	(void)file_id;
-
-	int64_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_available</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_File_IMPL_available_action</code> function return code.
- */
-static int32_t LLFS_File_IMPL_available_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_available_t* params = (FS_available_t*)job->params;
-
-	(void)file_id;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_flush</code> is done.
- *
- * @param[in] file_id file identifier.
- *
- * @return <code>LLFS_File_IMPL_flush_action</code> function return code.
- */
-static void LLFS_File_IMPL_flush_on_done(int32_t file_id){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_flush_t* params = (FS_flush_t*)job->params;
-
-	(void)file_id;
-
-	int32_t result = params->result;
-	if(result == LLFS_NOK){
-		// Exception
-		SNI_throwNativeIOException(params->error_code, params->error_message);
-	}
-
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-}
-
-
-#ifdef __cplusplus
-	}
-#endif
+/*
+ * C
+ *
+ * Copyright 2015-2023 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief LLFS_File implementation with async worker.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ * @date 26 April 2023
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sni.h"
+#include "LLFS_impl.h"
+#include "LLFS_File_impl.h"
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "LLFS_EXTENSION_impl.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * Sanity check between the expected version of the configuration and the actual version of
+ * the configuration.
+ * If an error is raised here, it means that a new version of the CCO has been installed and
+ * the configuration fs_configuration.h must be updated based on the one provided
+ * by the new CCO version.
+ */
+#if FS_CONFIGURATION_VERSION != 2
+
+	#error "Version of the configuration file fs_configuration.h is not compatible with this implementation."
+
+#endif
+
+static int32_t LLFS_async_exec_write_read_job(int32_t file_id, uint8_t* data, int32_t offset, int32_t length, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
+static int32_t LLFS_async_exec_write_read_byte_job(int32_t file_id, int32_t data, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
+static int32_t LLFS_File_IMPL_open_on_done(uint8_t* path, uint8_t mode);
+static int32_t LLFS_File_IMPL_write_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length);
+static void LLFS_File_IMPL_write_byte_on_done(int32_t file_id, int32_t data);
+static int32_t LLFS_File_IMPL_read_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length);
+static int32_t LLFS_File_IMPL_read_byte_on_done(int32_t file_id);
+static void LLFS_File_IMPL_close_on_done(int32_t file_id);
+static void LLFS_File_IMPL_seek_on_done(int32_t file_id, int64_t n);
+static int64_t LLFS_File_IMPL_get_file_pointer_on_done(int32_t file_id);
+static void LLFS_File_IMPL_set_length_on_done(int32_t file_id, int64_t newLength);
+static int64_t LLFS_File_IMPL_get_length_with_fd_on_done(int32_t file_id);
+static int32_t LLFS_File_IMPL_available_on_done(int32_t file_id);
+static void LLFS_File_IMPL_flush_on_done(int32_t file_id);
+static int32_t LLFS_async_exec_extents_job(int32_t file_id, int64_t* positions, int32_t* lengths, int32_t count, uint8_t* data, int32_t offset, bool exec_write, SNI_callback retry_function, SNI_callback on_done);
+static int32_t LLFS_File_IMPL_read_at_on_done(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length);
+static int32_t LLFS_File_IMPL_write_at_on_done(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length);
+static int32_t LLFS_File_IMPL_read_extents_on_done(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset);
+static int32_t LLFS_File_IMPL_write_extents_on_done(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset);
+static int32_t LLFS_extents_result(uint8_t* data, int32_t offset, bool read);
+
+#if FS_FILE_BUFFER_COUNT > 0
+static LLFS_File_buffer_t LLFS_File_buffers[FS_FILE_BUFFER_COUNT];
+#endif
+
+/**
+ * @brief Returns the buffer attached to a file.
+ *
+ * @param[in] file_id file identifier, 0 to get a free buffer.
+ *
+ * @return the buffer, or NULL if the file is not buffered.
+ */
+static LLFS_File_buffer_t* LLFS_File_buffer_get(int32_t file_id){
+	LLFS_File_buffer_t* buffer = NULL;
+#if FS_FILE_BUFFER_COUNT > 0
+	for(int32_t i = 0; i < FS_FILE_BUFFER_COUNT; i++){
+		if(LLFS_File_buffers[i].file_id == file_id){
+			buffer = &LLFS_File_buffers[i];
+			break;
+		}
+	}
+#else
+	(void)file_id;
+#endif
+	return buffer;
+}
+
+/**
+ * @brief Attaches a free buffer to a newly opened file, if the opening mode allows it.
+ * Files opened in a synchronous mode are never buffered.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] mode opening mode.
+ */
+static void LLFS_File_buffer_attach(int32_t file_id, uint8_t mode){
+	if((mode != (uint8_t)LLFS_FILE_MODE_READ_WRITE_SYNC) && (mode != (uint8_t)LLFS_FILE_MODE_READ_WRITE_DATA_SYNC)){
+		LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(0);
+		if(buffer != NULL){
+			LLFS_File_buffer_initialize(buffer, file_id);
+		} // else no free buffer: the file is not buffered
+	}
+}
+
+/**
+ * @brief Starts an async_worker job on a file buffer.
+ *
+ * The job uses <code>native</code> as its <code>SNI_callback</code>: the native is executed again when the
+ * job is done and completes it with <code>LLFS_File_buffer_complete</code>.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] kind the kind of job to start.
+ * @param[in] native the native that started the job.
+ */
+static void LLFS_File_buffer_start_job(LLFS_File_buffer_t* buffer, LLFS_File_buffer_job_kind_t kind, SNI_callback native){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(buffer->file_id), native);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and the native to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	MICROEJ_ASYNC_WORKER_action_t action = LLFS_File_buffer_set_job_params(buffer, kind, (FS_worker_param_t*)job->params);
+
+	buffer->job = job;
+	buffer->job_kind = kind;
+	buffer->thread_id = SNI_getCurrentJavaThreadID();
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, native);
+	if(status != MICROEJ_ASYNC_WORKER_OK){
+		// An error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+		buffer->job = NULL;
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	}
+}
+
+/**
+ * @brief Completes the job started on a file buffer, if any, and updates the buffer with its result.
+ * Must be called first by every native that uses the buffer.
+ *
+ * If the job has been started by another thread, the current thread is suspended and <code>native</code>
+ * is executed again after <code>FS_CONCURRENT_ACCESS_RETRY_DELAY</code> milliseconds.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] throw_error true to throw a NativeIOException if the job failed, false to store the error
+ * in the buffer so that it is reported later.
+ * @param[in] native the calling native, executed again when the job of another thread may be done.
+ *
+ * @return <code>LLFS_OK</code> on success, <code>LLFS_EOF</code> if a refill reached the end of the file,
+ * else <code>LLFS_NOK</code> (the job failed or the current thread has been suspended).
+ */
+static int32_t LLFS_File_buffer_complete(LLFS_File_buffer_t* buffer, bool throw_error, SNI_callback native){
+	int32_t result = LLFS_OK;
+	MICROEJ_ASYNC_WORKER_job_t* job = buffer->job;
+
+	if(job == NULL){
+		// No pending job
+	}
+	else if(buffer->thread_id != SNI_getCurrentJavaThreadID()){
+		// The job has been started by another thread that is still waiting for it: the owner
+		// completes it when it is resumed, retry after it
+		(void)SNI_suspendCurrentJavaThreadWithCallback(FS_CONCURRENT_ACCESS_RETRY_DELAY, native, NULL);
+		result = LLFS_NOK;
+	}
+	else {
+		int32_t error_code;
+		char* error_message;
+		result = LLFS_File_buffer_job_done(buffer, buffer->job_kind, (FS_worker_param_t*)job->params, &error_code, &error_message);
+		buffer->job = NULL;
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+		if(result == LLFS_NOK){
+			if(throw_error == true){
+				SNI_throwNativeIOException(error_code, error_message);
+			}
+			else {
+				buffer->error_code = error_code;
+				buffer->error_message = error_message;
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Moves the file pointer of a buffered file to the logical position, writing the write-behind
+ * data or dropping the read-ahead data. Called by the natives that access the file directly.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] native the calling native, executed again when a started job is done.
+ * @param[in] keep_read_ahead true to keep the read-ahead data and leave the file pointer after it, the
+ * caller takes <code>LLFS_File_buffer_unread</code> bytes into account.
+ *
+ * @return true if the native can access the file, false if a job has been started or an exception is pending.
+ */
+static bool LLFS_File_buffer_sync(int32_t file_id, SNI_callback native, bool keep_read_ahead){
+	bool synchronized = true;
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		if(LLFS_File_buffer_complete(buffer, true, native) == LLFS_NOK){
+			synchronized = false;
+		}
+		else if(buffer->state == LLFS_FILE_BUFFER_WRITE){
+			LLFS_File_buffer_start_job(buffer, LLFS_FILE_BUFFER_JOB_FLUSH, native);
+			synchronized = false;
+		}
+		else if((keep_read_ahead == false) && (LLFS_File_buffer_unread(buffer) > 0)){
+			LLFS_File_buffer_start_job(buffer, LLFS_FILE_BUFFER_JOB_REWIND, native);
+			synchronized = false;
+		}
+		else {
+			// Nothing to write and file pointer up to date
+		}
+	}
+	return synchronized;
+}
+
+/**
+ * @brief Reads data through a file buffer. Small reads are served from the read-ahead data,
+ * reads of at least <code>FS_FILE_BUFFER_SIZE</code> bytes are done directly in the file.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[out] data the Java array where the data is copied.
+ * @param[in] offset the offset inside the array.
+ * @param[in] length the maximum number of bytes to read.
+ *
+ * @return the number of bytes read, <code>LLFS_EOF</code> on EOF, <code>SNI_IGNORED_RETURNED_VALUE</code>
+ * if a job has been started, else a negative error code.
+ */
+static int32_t LLFS_File_buffer_read(LLFS_File_buffer_t* buffer, uint8_t* data, int32_t offset, int32_t length){
+	int32_t result = LLFS_File_buffer_complete(buffer, true, (SNI_callback)LLFS_File_IMPL_read);
+	if(result == LLFS_OK){
+		int32_t read = 0;
+		LLFS_File_buffer_job_kind_t kind = LLFS_File_buffer_read_data(buffer, &data[offset], length, &read);
+		if(kind == LLFS_FILE_BUFFER_JOB_NONE){
+			result = read;
+		}
+		else if(kind == LLFS_FILE_BUFFER_JOB_DIRECT){
+			result = LLFS_async_exec_write_read_job(buffer->file_id, data, offset, length, false, (SNI_callback)LLFS_File_IMPL_read, LLFS_File_IMPL_read_action, (SNI_callback)LLFS_File_IMPL_read_on_done);
+		}
+		else {
+			LLFS_File_buffer_start_job(buffer, kind, (SNI_callback)LLFS_File_IMPL_read);
+			result = SNI_IGNORED_RETURNED_VALUE;
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Writes data through a file buffer. Small writes are appended to the write-behind data,
+ * writes of at least <code>FS_FILE_BUFFER_SIZE</code> bytes are done directly in the file.
+ *
+ * @param[in] buffer the file buffer.
+ * @param[in] data the data to write.
+ * @param[in] offset the offset inside <code>data</code>.
+ * @param[in] length the number of bytes to write.
+ * @param[in] native the calling native, executed again when a started job is done.
+ *
+ * @return the number of bytes written, <code>SNI_IGNORED_RETURNED_VALUE</code> if a job has been started,
+ * else a negative error code.
+ */
+static int32_t LLFS_File_buffer_write(LLFS_File_buffer_t* buffer, uint8_t* data, int32_t offset, int32_t length, SNI_callback native){
+	int32_t result = LLFS_File_buffer_complete(buffer, true, native);
+	if(result == LLFS_OK){
+		LLFS_File_buffer_job_kind_t kind = LLFS_File_buffer_write_data(buffer, &data[offset], length);
+		if(kind == LLFS_FILE_BUFFER_JOB_NONE){
+			result = length;
+		}
+		else if(kind == LLFS_FILE_BUFFER_JOB_DIRECT){
+			result = LLFS_async_exec_write_read_job(buffer->file_id, data, offset, length, true, (SNI_callback)LLFS_File_IMPL_write, LLFS_File_IMPL_write_action, (SNI_callback)LLFS_File_IMPL_write_on_done);
+		}
+		else {
+			LLFS_File_buffer_start_job(buffer, kind, native);
+			result = SNI_IGNORED_RETURNED_VALUE;
+		}
+	}
+	return result;
+}
+
+int32_t LLFS_File_IMPL_open(uint8_t* path, uint8_t mode){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_File_IMPL_open);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_open_t* params = (FS_open_t*)job->params;
+	if(LLFS_set_path_param(path, (uint8_t*)&params->path) != LLFS_OK){
+		SNI_throwNativeIOException(LLFS_NOK, "Path name too long");
+	}
+	else{
+		params->mode = mode;
+
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_open_action, (SNI_callback)LLFS_File_IMPL_open_on_done);
+		if(status == MICROEJ_ASYNC_WORKER_OK){
+			// Wait for the action to be done
+			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+	}
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+int32_t LLFS_File_IMPL_write(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		return LLFS_File_buffer_write(buffer, data, offset, length, (SNI_callback)LLFS_File_IMPL_write);
+	}
+	return LLFS_async_exec_write_read_job(file_id, data, offset, length, true, (SNI_callback)LLFS_File_IMPL_write, LLFS_File_IMPL_write_action, (SNI_callback)LLFS_File_IMPL_write_on_done);
+}
+
+void LLFS_File_IMPL_write_byte(int32_t file_id, int32_t data){
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		uint8_t byte = (uint8_t)data;
+		(void)LLFS_File_buffer_write(buffer, &byte, 0, 1, (SNI_callback)LLFS_File_IMPL_write_byte);
+		return;
+	}
+	(void)LLFS_async_exec_write_read_byte_job(file_id, data, true, (SNI_callback)LLFS_File_IMPL_write_byte, LLFS_File_IMPL_write_action, (SNI_callback)LLFS_File_IMPL_write_byte_on_done);
+}
+
+int32_t LLFS_File_IMPL_read(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		return LLFS_File_buffer_read(buffer, data, offset, length);
+	}
+	return LLFS_async_exec_write_read_job(file_id, data, offset, length, false, (SNI_callback)LLFS_File_IMPL_read, LLFS_File_IMPL_read_action, (SNI_callback)LLFS_File_IMPL_read_on_done);
+}
+
+int32_t LLFS_File_IMPL_read_byte(int32_t file_id){
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer == NULL){
+		return LLFS_async_exec_write_read_byte_job(file_id, 0, false, (SNI_callback)LLFS_File_IMPL_read_byte, LLFS_File_IMPL_read_action, (SNI_callback)LLFS_File_IMPL_read_byte_on_done);
+	}
+
+	int32_t result = LLFS_File_buffer_complete(buffer, true, (SNI_callback)LLFS_File_IMPL_read_byte);
+	if(result == LLFS_OK){
+		uint8_t byte;
+		int32_t read = 0;
+		// One byte is never read directly in the file
+		LLFS_File_buffer_job_kind_t kind = LLFS_File_buffer_read_data(buffer, &byte, 1, &read);
+		if(kind == LLFS_FILE_BUFFER_JOB_NONE){
+			result = (int32_t)byte;
+		}
+		else {
+			LLFS_File_buffer_start_job(buffer, kind, (SNI_callback)LLFS_File_IMPL_read_byte);
+			result = SNI_IGNORED_RETURNED_VALUE;
+		}
+	}
+	return result;
+}
+
+void LLFS_File_IMPL_close(int32_t file_id) {
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		// A flush error is reported once the file is closed
+		(void)LLFS_File_buffer_complete(buffer, false, (SNI_callback)LLFS_File_IMPL_close);
+		if(buffer->job != NULL){
+			// Job started by another thread: suspended until it may be done
+			return;
+		}
+		if(buffer->state == LLFS_FILE_BUFFER_WRITE){
+			LLFS_File_buffer_start_job(buffer, LLFS_FILE_BUFFER_JOB_FLUSH, (SNI_callback)LLFS_File_IMPL_close);
+			return;
+		}
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_close);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	FS_close_t* params = (FS_close_t*)job->params;
+	params->file_id = file_id;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_close_action, (SNI_callback)LLFS_File_IMPL_close_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+}
+
+void LLFS_File_IMPL_seek(int32_t file_id, int64_t n){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_seek, true) == false){
+		// A buffer job has been started or an exception is pending
+		return;
+	}
+
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		// The file pointer is set to an absolute position: the read-ahead data is dropped
+		buffer->state = LLFS_FILE_BUFFER_EMPTY;
+		buffer->position = 0;
+		buffer->count = 0;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_seek);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	FS_seek_t* params = (FS_seek_t*)job->params;
+	params->file_id = file_id;
+	params->n = n;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_seek_action, (SNI_callback)LLFS_File_IMPL_seek_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return;
+}
+
+int64_t LLFS_File_IMPL_get_file_pointer(int32_t file_id){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_get_file_pointer, true) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_get_file_pointer);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;;
+	}
+
+	FS_getfp_t* params = (FS_getfp_t*)job->params;
+	params->file_id = file_id;
+
+	// Short query: do not wait behind pending reads and writes
+	MICROEJ_ASYNC_WORKER_set_job_lane(job, MICROEJ_ASYNC_WORKER_LANE_HIGH);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_get_file_pointer_action, (SNI_callback)LLFS_File_IMPL_get_file_pointer_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+void LLFS_File_IMPL_set_length(int32_t file_id, int64_t newLength){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_set_length, false) == false){
+		// A buffer job has been started or an exception is pending
+		return;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_set_length);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	FS_set_length_t* params = (FS_set_length_t*)job->params;
+	params->file_id = file_id;
+	params->length = newLength;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_set_length_action, (SNI_callback)LLFS_File_IMPL_set_length_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return;
+}
+
+int64_t LLFS_File_IMPL_get_length_with_fd(int32_t file_id){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_get_length_with_fd, true) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_get_length_with_fd);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	FS_get_length_with_fd_t* params = (FS_get_length_with_fd_t*)job->params;
+	params->file_id = file_id;
+
+	// Short query: do not wait behind pending reads and writes
+	MICROEJ_ASYNC_WORKER_set_job_lane(job, MICROEJ_ASYNC_WORKER_LANE_HIGH);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_get_length_with_fd_action, (SNI_callback)LLFS_File_IMPL_get_length_with_fd_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+int32_t LLFS_File_IMPL_available(int32_t file_id){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_available, true) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_available);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_available_t* params = (FS_available_t*)job->params;
+	params->file_id = file_id;
+
+	// Short query: do not wait behind pending reads and writes
+	MICROEJ_ASYNC_WORKER_set_job_lane(job, MICROEJ_ASYNC_WORKER_LANE_HIGH);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_available_action, (SNI_callback)LLFS_File_IMPL_available_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+
+void LLFS_File_IMPL_flush(int32_t file_id){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_flush, true) == false){
+		// A buffer job has been started or an exception is pending
+		return;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), (SNI_callback)LLFS_File_IMPL_flush);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	FS_flush_t* params = (FS_flush_t*)job->params;
+	params->file_id = file_id;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_flush_action, (SNI_callback)LLFS_File_IMPL_flush_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+}
+
+int32_t LLFS_File_IMPL_read_at(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length){
+	// The read-ahead data stays valid: the file pointer is not moved
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_read_at, true) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+	return LLFS_async_exec_extents_job(file_id, &position, &length, 1, data, offset, false, (SNI_callback)LLFS_File_IMPL_read_at, (SNI_callback)LLFS_File_IMPL_read_at_on_done);
+}
+
+int32_t LLFS_File_IMPL_write_at(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length){
+	// The written data may overlap the read-ahead data: drop it
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_write_at, false) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+	return LLFS_async_exec_extents_job(file_id, &position, &length, 1, data, offset, true, (SNI_callback)LLFS_File_IMPL_write_at, (SNI_callback)LLFS_File_IMPL_write_at_on_done);
+}
+
+int32_t LLFS_File_IMPL_read_extents(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_read_extents, true) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+	int32_t count = SNI_getArrayLength(positions);
+	if(count != SNI_getArrayLength(lengths)){
+		SNI_throwNativeIOException(LLFS_NOK, "Positions and lengths arrays of different lengths");
+		return LLFS_NOK;
+	}
+	return LLFS_async_exec_extents_job(file_id, positions, lengths, count, data, offset, false, (SNI_callback)LLFS_File_IMPL_read_extents, (SNI_callback)LLFS_File_IMPL_read_extents_on_done);
+}
+
+int32_t LLFS_File_IMPL_write_extents(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset){
+	if(LLFS_File_buffer_sync(file_id, (SNI_callback)LLFS_File_IMPL_write_extents, false) == false){
+		// A buffer job has been started or an exception is pending
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+	int32_t count = SNI_getArrayLength(positions);
+	if(count != SNI_getArrayLength(lengths)){
+		SNI_throwNativeIOException(LLFS_NOK, "Positions and lengths arrays of different lengths");
+		return LLFS_NOK;
+	}
+	return LLFS_async_exec_extents_job(file_id, positions, lengths, count, data, offset, true, (SNI_callback)LLFS_File_IMPL_write_extents, (SNI_callback)LLFS_File_IMPL_write_extents_on_done);
+}
+
+/**
+ * @brief Prepare and send an execution job to async_worker, called either from
+ * <code>LLFS_File_IMPL_write</code> or <code>LLFS_File_IMPL_read</code>.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] data buffer used for reading or writing operations.
+ * @param[in] offset the offset inside the buffer where the data has to be manipulated.
+ * @param[in] length buffer length.
+ * @param[in] exec_write true if the data buffer content need to be sent to the async_worker job, else false.
+ * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
+ * @param[in] action the function to execute asynchronously.
+ * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
+ *
+ * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
+ */
+static int32_t LLFS_async_exec_write_read_job(int32_t file_id, uint8_t* data, int32_t offset, int32_t length, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done){
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), retry_function);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	// Immortal arrays are used in place, others are copied to a bounce buffer
+	uint32_t bounce_buffer_length = sizeof(params->buffer);
+	int8_t* bounce_buffer = (int8_t*)&params->buffer;
+	if(SNI_isImmortalArray(data) == false){
+		bounce_buffer = (int8_t*)LLFS_bounce_buffer_select((uint8_t*)&params->buffer, &bounce_buffer_length, length);
+	}
+
+	bool do_copy = exec_write;
+	params->data = NULL;
+	int32_t result = SNI_retrieveArrayElements((int8_t *)data, offset, length, bounce_buffer, bounce_buffer_length, (int8_t**)&params->data, (uint32_t *)&params->length, do_copy);
+
+	if(result != SNI_OK){
+		SNI_throwNativeIOException(result, "SNI_retrieveArrayElements: Internal error");
+	}
+	else {
+		params->file_id = file_id;
+
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, on_done);
+		if(status == MICROEJ_ASYNC_WORKER_OK){
+			// Wait for the action to be done
+			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+	}
+
+	// Error
+	LLFS_large_io_buffer_release((uint8_t*)bounce_buffer);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+/**
+ * @brief Prepare and send an execution job to async_worker, called either from
+ * <code>LLFS_File_IMPL_write_byte</code> or <code>LLFS_File_IMPL_read_byte</code>.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in/out] data byte to be read/written.
+ * @param[in] exec_write true if the data buffer content need to be sent to the async_worker job, else false.
+ * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
+ * @param[in] action the function to execute asynchronously.
+ * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
+ *
+ * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
+ */
+static int32_t LLFS_async_exec_write_read_byte_job(int32_t file_id, int32_t data, bool exec_write, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), retry_function);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	params->file_id = file_id;
+	params->data = (uint8_t*)&params->buffer;
+	params->length = sizeof(uint8_t);
+	if(exec_write == true){
+		params->buffer[0] = (uint8_t)data;
+	}
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+/**
+ * @brief Prepare and send a positional execution job to async_worker, called from
+ * <code>LLFS_File_IMPL_read_at</code>, <code>LLFS_File_IMPL_write_at</code>,
+ * <code>LLFS_File_IMPL_read_extents</code> or <code>LLFS_File_IMPL_write_extents</code>.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] positions position in the file of each extent.
+ * @param[in] lengths length of each extent.
+ * @param[in] count number of extents.
+ * @param[in] data buffer used for reading or writing operations.
+ * @param[in] offset the offset inside the buffer where the data of the first extent is.
+ * @param[in] exec_write true if the data buffer content need to be sent to the async_worker job, else false.
+ * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
+ * @param[in] on_done the <code>SNI_callback</code> called when the job is done.
+ *
+ * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
+ */
+static int32_t LLFS_async_exec_extents_job(int32_t file_id, int64_t* positions, int32_t* lengths, int32_t count, uint8_t* data, int32_t offset, bool exec_write, SNI_callback retry_function, SNI_callback on_done){
+	if((count < 1) || (count > FS_FILE_EXTENT_COUNT)){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid number of extents");
+		return LLFS_NOK;
+	}
+
+	int64_t total_length = 0;
+	for(int32_t i = 0; i < count; i++){
+		if((positions[i] < 0) || (lengths[i] < 0)){
+			SNI_throwNativeIOException(LLFS_NOK, "Invalid extent");
+			return LLFS_NOK;
+		}
+		total_length += lengths[i];
+	}
+	if(total_length > ((int64_t)SNI_getArrayLength(data) - offset)){
+		SNI_throwNativeIOException(LLFS_NOK, "Extents larger than the data array");
+		return LLFS_NOK;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), retry_function);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_extents_t* params = (FS_extents_t*)job->params;
+
+	// Immortal arrays are used in place, others are copied to a bounce buffer: with the job IO buffer, the last
+	// extents are truncated
+	uint32_t bounce_buffer_length = sizeof(params->buffer);
+	int8_t* bounce_buffer = (int8_t*)&params->buffer;
+	if(SNI_isImmortalArray(data) == false){
+		bounce_buffer = (int8_t*)LLFS_bounce_buffer_select((uint8_t*)&params->buffer, &bounce_buffer_length, total_length);
+	}
+
+	params->data = NULL;
+	int32_t result = SNI_retrieveArrayElements((int8_t *)data, offset, (int32_t)total_length, bounce_buffer, bounce_buffer_length, (int8_t**)&params->data, (uint32_t *)&params->length, exec_write);
+
+	if(result != SNI_OK){
+		SNI_throwNativeIOException(result, "SNI_retrieveArrayElements: Internal error");
+	}
+	else {
+		params->file_id = file_id;
+		params->count = count;
+		for(int32_t i = 0; i < count; i++){
+			params->positions[i] = positions[i];
+			params->lengths[i] = lengths[i];
+		}
+
+		MICROEJ_ASYNC_WORKER_action_t action = exec_write ? LLFS_File_IMPL_write_extents_action : LLFS_File_IMPL_read_extents_action;
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, on_done);
+		if(status == MICROEJ_ASYNC_WORKER_OK){
+			// Wait for the action to be done
+			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+	}
+
+	// Error
+	LLFS_large_io_buffer_release((uint8_t*)bounce_buffer);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+int32_t LLFS_File_read_range(int32_t file_id, int64_t position, int64_t length, FS_read_range_consumer_t consumer, void* context, SNI_callback native, SNI_callback on_done){
+	if((position < 0) || (length < 0)){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid range");
+		return LLFS_NOK;
+	}
+
+	// The read-ahead data stays valid: the file pointer is not moved
+	if(LLFS_File_buffer_sync(file_id, native, true) == false){
+		// A buffer job has been started or an exception is pending
+		return LLFS_NOK;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(file_id), native);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and the native to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_read_range_t* params = (FS_read_range_t*)job->params;
+	params->file_id = file_id;
+	params->position = position;
+	params->length = length;
+	params->consumer = consumer;
+	params->context = context;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_read_range_action, on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return LLFS_OK;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_open</code> is done.
+ *
+ * @param[in] path absolute path of file to open.
+ * @param[in] mode opening mode.
+ *
+ * @return <code>LLFS_File_IMPL_open_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_open_on_done(uint8_t* path, uint8_t mode){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_open_t* params = (FS_open_t*)job->params;
+
+	(void)path;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else {
+		LLFS_File_buffer_attach(result, mode);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	if(mode != (uint8_t)LLFS_FILE_MODE_READ){
+		// The file may have been created or truncated
+		LLFS_stat_cache_invalidate();
+	}
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] data buffer used for writing operations.
+ * @param[in] offset the offset inside the buffer where the data has to be manipulated.
+ * @param[in] length buffer length.
+ *
+ * @return <code>LLFS_File_IMPL_write_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_write_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	(void)file_id;
+	(void)data;
+	(void)offset;
+	(void)length;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	LLFS_large_io_buffer_release(params->data);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	// Files opened in a synchronous mode are updated on the volume by each write
+	LLFS_stat_cache_invalidate();
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[out] data buffer used for reading operations.
+ * @param[in] offset the offset inside the buffer where the data has to be manipulated.
+ * @param[in] length buffer length.
+ *
+ * @return <code>LLFS_File_IMPL_read_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_read_on_done(int32_t file_id, uint8_t* data, int32_t offset, int32_t length){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	(void)file_id;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else if(result != LLFS_EOF){
+		int32_t release_result = SNI_flushArrayElements((int8_t*)data, offset, length, (int8_t*)params->data, result);
+		if(release_result != SNI_OK){
+			SNI_throwNativeIOException(release_result, "SNI_flushArrayElements: Internal error");
+		}
+	}else{
+		// Successful: result hold the number of read bytes.
+	}
+	LLFS_large_io_buffer_release(params->data);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write_byte</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] data byte to be written.
+ *
+ * @return <code>LLFS_File_IMPL_write_action</code> function return code.
+ */
+static void LLFS_File_IMPL_write_byte_on_done(int32_t file_id, int32_t data){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	(void)file_id;
+	(void)data;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read_byte</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_File_IMPL_read_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_read_byte_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_write_read_t* params = (FS_write_read_t*)job->params;
+
+	(void)file_id;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else if(result == 1) {
+		// 1 byte read: return the read byte
+		result = (uint8_t)params->data[0];
+	}
+	else if(result != LLFS_EOF) {
+		// Invalid value returned by the read_byte action
+		SNI_throwNativeIOException(result, "Internal error");
+	}
+	else{
+		// Successful: result hold the number of read bytes.
+	}
+	// else: result==LLFS_EOF: just return LLFS_EOF
+	
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_close</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_File_IMPL_close_action</code> function return code.
+ */
+static void LLFS_File_IMPL_close_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_close_t* params = (FS_close_t*)job->params;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		if((result != LLFS_NOK) && (buffer->error_message != NULL)){
+			// Report the error of the last flush of the buffer
+			SNI_throwNativeIOException(buffer->error_code, buffer->error_message);
+		}
+		buffer->file_id = 0;
+	}
+
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	// The length and the date of the file are updated on the volume when it is closed
+	LLFS_stat_cache_invalidate();
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_seek</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] n the new position of the file pointer.
+ *
+ * @return <code>LLFS_File_IMPL_seek_action</code> function return code.
+ */
+static void LLFS_File_IMPL_seek_on_done(int32_t file_id, int64_t n){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_seek_t* params = (FS_seek_t*)job->params;
+
+	(void)file_id;
+	(void)n;
+
+	if(params->result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_get_file_pointer</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_File_IMPL_get_file_pointer_on_done</code> function return code.
+ */
+static int64_t LLFS_File_IMPL_get_file_pointer_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_getfp_t* params = (FS_getfp_t*)job->params;
+
+	int64_t result = params->result;
+	if(params->result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+		return LLFS_NOK;
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+	if(buffer != NULL){
+		// The file pointer is after the read-ahead data
+		result -= LLFS_File_buffer_unread(buffer);
+	}
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_set_length</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] newLength the new length of the file.
+ *
+ * @return <code>LLFS_File_IMPL_set_length_action</code> function return code.
+ */
+static void LLFS_File_IMPL_set_length_on_done(int32_t file_id, int64_t newLength){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_set_length_t* params = (FS_set_length_t*)job->params;
+
+	(void)file_id;
+	(void)newLength;
+
+	if(params->result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_get_length_with_fd</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_IMPL_get_length_with_fd_action</code> function return code.
+ */
+static int64_t LLFS_File_IMPL_get_length_with_fd_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_get_length_with_fd_t* params = (FS_get_length_with_fd_t*)job->params;
+
+	(void)file_id;
+
+	int64_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_available</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_File_IMPL_available_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_available_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_available_t* params = (FS_available_t*)job->params;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else {
+		LLFS_File_buffer_t* buffer = LLFS_File_buffer_get(file_id);
+		if(buffer != NULL){
+			// The read-ahead data is available too
+			result += LLFS_File_buffer_unread(buffer);
+		}
+	}
+
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_flush</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ *
+ * @return <code>LLFS_File_IMPL_flush_action</code> function return code.
+ */
+static void LLFS_File_IMPL_flush_on_done(int32_t file_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_flush_t* params = (FS_flush_t*)job->params;
+
+	(void)file_id;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	// The length and the date of the file are updated on the volume when it is flushed
+	LLFS_stat_cache_invalidate();
+}
+
+/**
+ * @brief Unified handling for the <code>SNI_callback</code> of positional operations, called via
+ * <code>LLFS_File_IMPL_read_at_on_done</code>, <code>LLFS_File_IMPL_write_at_on_done</code>,
+ * <code>LLFS_File_IMPL_read_extents_on_done</code> and <code>LLFS_File_IMPL_write_extents_on_done</code>.
+ *
+ * @param[out] data buffer used for reading or writing operations.
+ * @param[in] offset the offset inside the buffer where the data of the first extent is.
+ * @param[in] read true if the read data must be copied back to <code>data</code>.
+ *
+ * @return <code>LLFS_File_IMPL_read_extents_action</code> or <code>LLFS_File_IMPL_write_extents_action</code> function return code.
+ */
+static int32_t LLFS_extents_result(uint8_t* data, int32_t offset, bool read){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_extents_t* params = (FS_extents_t*)job->params;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else if(read == true){
+		if(result != LLFS_EOF){
+			int32_t release_result = SNI_flushArrayElements((int8_t*)data, offset, params->length, (int8_t*)params->data, result);
+			if(release_result != SNI_OK){
+				SNI_throwNativeIOException(release_result, "SNI_flushArrayElements: Internal error");
+			}
+		}
+	}
+	else {
+		LLFS_stat_cache_invalidate();
+	}
+	LLFS_large_io_buffer_release(params->data);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read_at</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] position the position in the file.
+ * @param[out] data buffer used for reading operations.
+ * @param[in] offset the offset inside the buffer where the data has to be manipulated.
+ * @param[in] length buffer length.
+ *
+ * @return <code>LLFS_File_IMPL_read_extents_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_read_at_on_done(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length){
+	(void)file_id;
+	(void)position;
+	(void)length;
+
+	return LLFS_extents_result(data, offset, true);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write_at</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] position the position in the file.
+ * @param[in] data buffer used for writing operations.
+ * @param[in] offset the offset inside the buffer where the data has to be manipulated.
+ * @param[in] length buffer length.
+ *
+ * @return <code>LLFS_File_IMPL_write_extents_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_write_at_on_done(int32_t file_id, int64_t position, uint8_t* data, int32_t offset, int32_t length){
+	(void)file_id;
+	(void)position;
+	(void)length;
+
+	return LLFS_extents_result(data, offset, false);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_read_extents</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] positions position in the file of each extent.
+ * @param[in] lengths length of each extent.
+ * @param[out] data buffer used for reading operations.
+ * @param[in] offset the offset inside the buffer where the data of the first extent is.
+ *
+ * @return <code>LLFS_File_IMPL_read_extents_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_read_extents_on_done(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset){
+	(void)file_id;
+	(void)positions;
+	(void)lengths;
+
+	return LLFS_extents_result(data, offset, true);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_File_IMPL_write_extents</code> is done.
+ *
+ * @param[in] file_id file identifier.
+ * @param[in] positions position in the file of each extent.
+ * @param[in] lengths length of each extent.
+ * @param[in] data buffer used for writing operations.
+ * @param[in] offset the offset inside the buffer where the data of the first extent is.
+ *
+ * @return <code>LLFS_File_IMPL_write_extents_action</code> function return code.
+ */
+static int32_t LLFS_File_IMPL_write_extents_on_done(int32_t file_id, int64_t* positions, int32_t* lengths, uint8_t* data, int32_t offset){
+	(void)file_id;
+	(void)positions;
+	(void)lengths;
+
+	return LLFS_extents_result(data, offset, false);
+}
+
+
+#ifdef __cplusplus
+	}
+#endif
@@ -0,0 +1,478 @@
+/*
+ * C
+ *
+ * Copyright 2023 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Append log implementation with async worker.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ * @date 26 April 2023
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sni.h"
+#include "LLFS_impl.h"
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "LLFS_EXTENSION_impl.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * Sanity check between the expected version of the configuration and the actual version of
+ * the configuration.
+ * If an error is raised here, it means that a new version of the CCO has been installed and
+ * the configuration fs_configuration.h must be updated based on the one provided
+ * by the new CCO version.
+ */
+#if FS_CONFIGURATION_VERSION != 2
+
+	#error "Version of the configuration file fs_configuration.h is not compatible with this implementation."
+
+#endif
+
+#if (FS_LOG_BUFFER_SIZE + 16) > FS_IO_BUFFER_SIZE
+	#error "FS_LOG_BUFFER_SIZE must be at most FS_IO_BUFFER_SIZE - 16."
+#endif
+
+/**
+ * @brief Value of <code>log_id</code> of a log slot reserved by a pending open operation.
+ */
+#define LLFS_LOG_RESERVED (-1)
+
+/**
+ * @brief State of an open append log.
+ *
+ * Logs are only accessed from the VM task. While a write job is pending on a log, the worker
+ * owns <code>pending</code> and the Java thread that started the job is suspended.
+ */
+typedef struct {
+	int32_t log_id; /*!< ID of the log file, 0 if the slot is free. */
+	int64_t capacity; /*!< Size of the log file. */
+	int64_t end; /*!< Position after the last record written to the file. */
+	uint32_t epoch; /*!< Epoch of the log. */
+	uint32_t sequence; /*!< Sequence number of the next record. */
+	bool dirty; /*!< true if records have been written but not committed. */
+	int32_t pending_count; /*!< Number of bytes of records appended but not written. */
+	MICROEJ_ASYNC_WORKER_job_t* job; /*!< Pending write job, NULL if none. */
+	int32_t thread_id; /*!< Java thread waiting for the pending job. */
+	uint8_t pending[FS_LOG_BUFFER_SIZE + sizeof(FS_log_record_header_t)]; /*!< Appended records, followed by room for an end marker. */
+} LLFS_log_t;
+
+#if FS_LOG_COUNT > 0
+static LLFS_log_t LLFS_logs[FS_LOG_COUNT];
+#endif
+
+static int32_t LLFS_LOG_IMPL_open_on_done(uint8_t* path, int64_t capacity);
+static int32_t LLFS_LOG_IMPL_read_on_done(int32_t log_id, int64_t* position, uint8_t* data, int32_t offset, int32_t length);
+static void LLFS_LOG_IMPL_close_on_done(int32_t log_id);
+
+/**
+ * @brief Returns the state of an open log.
+ *
+ * @param[in] log_id log identifier, 0 to get a free slot.
+ *
+ * @return the log, or NULL if not found.
+ */
+static LLFS_log_t* LLFS_log_get(int32_t log_id){
+	LLFS_log_t* log = NULL;
+#if FS_LOG_COUNT > 0
+	for(int32_t i = 0; i < FS_LOG_COUNT; i++){
+		if(LLFS_logs[i].log_id == log_id){
+			log = &LLFS_logs[i];
+			break;
+		}
+	}
+#else
+	(void)log_id;
+#endif
+	return log;
+}
+
+/**
+ * @brief Returns the state of an open log, throwing a NativeIOException if the log is not open.
+ *
+ * @param[in] log_id log identifier.
+ *
+ * @return the log, or NULL if an exception is pending.
+ */
+static LLFS_log_t* LLFS_log_get_open(int32_t log_id){
+	LLFS_log_t* log = NULL;
+	if((log_id != 0) && (log_id != LLFS_LOG_RESERVED)){
+		log = LLFS_log_get(log_id);
+	}
+	if(log == NULL){
+		SNI_throwNativeIOException(LLFS_NOK, "Append log not open");
+	}
+	return log;
+}
+
+/**
+ * @brief Starts a job writing the appended records of a log.
+ *
+ * The job uses <code>native</code> as its <code>SNI_callback</code>: the native is executed again when the
+ * job is done and completes it with <code>LLFS_log_complete</code>.
+ *
+ * @param[in] log the log.
+ * @param[in] sync true to commit the log file after the write.
+ * @param[in] native the native that started the job.
+ */
+static void LLFS_log_start_write(LLFS_log_t* log, bool sync, SNI_callback native){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(log->log_id), native);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and the native to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	int32_t length = log->pending_count;
+	if((length > 0) && ((log->end + length + (int64_t)sizeof(FS_log_record_header_t)) <= log->capacity)){
+		// Write an end marker after the records: data left after it by an interrupted write is never read
+		length = LLFS_log_append_end_marker((uint8_t*)&log->pending, length);
+	}
+
+	FS_log_write_t* params = (FS_log_write_t*)job->params;
+	params->log_id = log->log_id;
+	params->data = (uint8_t*)&log->pending;
+	params->length = length;
+	params->position = log->end;
+	params->sync = sync;
+
+	log->job = job;
+	log->thread_id = SNI_getCurrentJavaThreadID();
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_LOG_IMPL_write_action, native);
+	if(status != MICROEJ_ASYNC_WORKER_OK){
+		// An error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+		log->job = NULL;
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	}
+}
+
+/**
+ * @brief Completes the write job started on a log, if any. Must be called first by every native that uses the log.
+ * If the job has been started by another thread, the current thread is suspended and <code>native</code>
+ * is executed again after <code>FS_CONCURRENT_ACCESS_RETRY_DELAY</code> milliseconds.
+ *
+ * @param[in] log the log.
+ * @param[in] native the calling native, executed again when the job of another thread may be done.
+ *
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code> and either a NativeIOException is pending
+ * or the current thread has been suspended.
+ */
+static int32_t LLFS_log_complete(LLFS_log_t* log, SNI_callback native){
+	int32_t result = LLFS_OK;
+	MICROEJ_ASYNC_WORKER_job_t* job = log->job;
+
+	if(job == NULL){
+		// No pending job
+	}
+	else if(log->thread_id != SNI_getCurrentJavaThreadID()){
+		// The job has been started by another thread that is still waiting for it: the owner
+		// completes it when it is resumed, retry after it
+		(void)SNI_suspendCurrentJavaThreadWithCallback(FS_CONCURRENT_ACCESS_RETRY_DELAY, native, NULL);
+		result = LLFS_NOK;
+	}
+	else {
+		FS_log_write_t* params = (FS_log_write_t*)job->params;
+		if(params->result == LLFS_NOK){
+			// The records stay pending, the write can be retried
+			SNI_throwNativeIOException(params->error_code, params->error_message);
+			result = LLFS_NOK;
+		}
+		else {
+			log->end += log->pending_count;
+			log->pending_count = 0;
+			log->dirty = !params->sync;
+		}
+		log->job = NULL;
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+		LLFS_stat_cache_invalidate();
+	}
+
+	return result;
+}
+
+int32_t LLFS_LOG_IMPL_open(uint8_t* path, int64_t capacity){
+	LLFS_log_t* log = LLFS_log_get(0);
+	if(log == NULL){
+		SNI_throwNativeIOException(LLFS_NOK, "Too many open append logs");
+		return LLFS_NOK;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_LOG_IMPL_open);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_log_open_t* params = (FS_log_open_t*)job->params;
+	if(LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK){
+		params->capacity = capacity;
+		params->slot = 0;
+#if FS_LOG_COUNT > 0
+		params->slot = (int32_t)(log - LLFS_logs);
+#endif
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_LOG_IMPL_open_action, (SNI_callback)LLFS_LOG_IMPL_open_on_done);
+		if(status == MICROEJ_ASYNC_WORKER_OK){
+			// Reserve the slot until the action is done
+			log->log_id = LLFS_LOG_RESERVED;
+			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+	}
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+int32_t LLFS_LOG_IMPL_append(int32_t log_id, uint8_t* data, int32_t offset, int32_t length){
+	LLFS_log_t* log = LLFS_log_get_open(log_id);
+	if((log == NULL) || (LLFS_log_complete(log, (SNI_callback)LLFS_LOG_IMPL_append) != LLFS_OK)){
+		return LLFS_NOK;
+	}
+
+	int32_t record_length = (int32_t)sizeof(FS_log_record_header_t) + length;
+	if((length < 0) || (offset < 0) || (length > (SNI_getArrayLength(data) - offset))){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid record bounds");
+		return LLFS_NOK;
+	}
+	if(record_length > FS_LOG_BUFFER_SIZE){
+		SNI_throwNativeIOException(LLFS_NOK, "Record too large");
+		return LLFS_NOK;
+	}
+	if((log->end + log->pending_count + record_length) > log->capacity){
+		SNI_throwNativeIOException(LLFS_NOK, "Append log full");
+		return LLFS_NOK;
+	}
+	if((log->pending_count + record_length) > FS_LOG_BUFFER_SIZE){
+		// Group commit buffer full: write the records, the record is appended when this native is executed again
+		LLFS_log_start_write(log, false, (SNI_callback)LLFS_LOG_IMPL_append);
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	uint32_t sequence = log->sequence;
+	log->pending_count += LLFS_log_encode_record(&log->pending[log->pending_count], log->epoch, sequence, &data[offset], length);
+	log->sequence++;
+
+	return (int32_t)sequence;
+}
+
+void LLFS_LOG_IMPL_commit(int32_t log_id){
+	LLFS_log_t* log = LLFS_log_get_open(log_id);
+	if((log == NULL) || (LLFS_log_complete(log, (SNI_callback)LLFS_LOG_IMPL_commit) != LLFS_OK)){
+		return;
+	}
+
+	if((log->pending_count > 0) || log->dirty){
+		// All the records appended since the last commit are written and committed at once
+		LLFS_log_start_write(log, true, (SNI_callback)LLFS_LOG_IMPL_commit);
+	} // else nothing to commit
+}
+
+int32_t LLFS_LOG_IMPL_read(int32_t log_id, int64_t* position, uint8_t* data, int32_t offset, int32_t length){
+	LLFS_log_t* log = LLFS_log_get_open(log_id);
+	if((log == NULL) || (LLFS_log_complete(log, (SNI_callback)LLFS_LOG_IMPL_read) != LLFS_OK)){
+		return LLFS_NOK;
+	}
+	if(SNI_getArrayLength(position) < 1){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid position array");
+		return LLFS_NOK;
+	}
+	if((length < 0) || (offset < 0) || (length > (SNI_getArrayLength(data) - offset))){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid buffer bounds");
+		return LLFS_NOK;
+	}
+
+	int64_t record_position = position[0];
+	if(record_position < (int64_t)sizeof(FS_log_file_header_t)){
+		record_position = (int64_t)sizeof(FS_log_file_header_t);
+	}
+	if(record_position >= (log->end + log->pending_count)){
+		return LLFS_EOF;
+	}
+	if(record_position >= log->end){
+		// The record has not been written yet
+		LLFS_log_start_write(log, false, (SNI_callback)LLFS_LOG_IMPL_read);
+		return SNI_IGNORED_RETURNED_VALUE;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(log_id), (SNI_callback)LLFS_LOG_IMPL_read);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return LLFS_NOK;
+	}
+
+	FS_log_read_t* params = (FS_log_read_t*)job->params;
+	params->log_id = log_id;
+	params->position = record_position;
+	params->epoch = log->epoch;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_LOG_IMPL_read_action, (SNI_callback)LLFS_LOG_IMPL_read_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_NOK;
+}
+
+void LLFS_LOG_IMPL_close(int32_t log_id){
+	LLFS_log_t* log = LLFS_log_get_open(log_id);
+	if((log == NULL) || (LLFS_log_complete(log, (SNI_callback)LLFS_LOG_IMPL_close) != LLFS_OK)){
+		return;
+	}
+
+	if((log->pending_count > 0) || log->dirty){
+		LLFS_log_start_write(log, true, (SNI_callback)LLFS_LOG_IMPL_close);
+		return;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(log_id), (SNI_callback)LLFS_LOG_IMPL_close);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending
+		return;
+	}
+
+	FS_close_t* params = (FS_close_t*)job->params;
+	params->file_id = log_id;
+
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_File_IMPL_close_action, (SNI_callback)LLFS_LOG_IMPL_close_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return;
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_LOG_IMPL_open</code> is done.
+ *
+ * @param[in] path absolute path of the log file.
+ * @param[in] capacity size to preallocate.
+ *
+ * @return <code>LLFS_LOG_IMPL_open_action</code> function return code.
+ */
+static int32_t LLFS_LOG_IMPL_open_on_done(uint8_t* path, int64_t capacity){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_log_open_t* params = (FS_log_open_t*)job->params;
+
+	(void)path;
+	(void)capacity;
+
+	int32_t result = params->result;
+#if FS_LOG_COUNT > 0
+	LLFS_log_t* log = &LLFS_logs[params->slot];
+	if(result == LLFS_NOK){
+		// Exception
+		log->log_id = 0;
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else {
+		log->log_id = result;
+		log->capacity = params->capacity;
+		log->end = params->end;
+		log->epoch = params->epoch;
+		log->sequence = params->sequence;
+		log->dirty = false;
+		log->pending_count = 0;
+		log->job = NULL;
+	}
+#endif
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_LOG_IMPL_read</code> is done.
+ *
+ * @param[in] log_id log identifier.
+ * @param[in,out] position position of the record, set to the position of the next record.
+ * @param[out] data the array receiving the payload.
+ * @param[in] offset the offset in the array.
+ * @param[in] length the maximum length of the payload.
+ *
+ * @return <code>LLFS_LOG_IMPL_read_action</code> function return code.
+ */
+static int32_t LLFS_LOG_IMPL_read_on_done(int32_t log_id, int64_t* position, uint8_t* data, int32_t offset, int32_t length){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_log_read_t* params = (FS_log_read_t*)job->params;
+
+	(void)log_id;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else if(result > length){
+		SNI_throwNativeIOException(LLFS_NOK, "Buffer too small for the record");
+		result = LLFS_NOK;
+	}
+	else {
+		(void)memcpy(&data[offset], params->buffer, (size_t)result);
+		position[0] = params->position + (int64_t)sizeof(FS_log_record_header_t) + result;
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_LOG_IMPL_close</code> is done.
+ *
+ * @param[in] log_id log identifier.
+ */
+static void LLFS_LOG_IMPL_close_on_done(int32_t log_id){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return;
+	}
+	FS_close_t* params = (FS_close_t*)job->params;
+
+	if(params->result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+
+	// The log file is closed even on error
+	LLFS_log_t* log = LLFS_log_get(log_id);
+	if(log != NULL){
+		log->log_id = 0;
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -0,0 +1,104 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Resource image storage in a file, mapped with mmap. Replaces LLFS_ESP32_resource_image.c in host builds of
+ * the FS helpers and of their tests: it is not part of the ESP-IDF build.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "fs_configuration.h"
+#include "fs_helper.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Path of the file holding the resource image, can be defined on the command line. The file stands for the
+ * resource image partition: it must be created with the size of the partition, the image is at its beginning.
+ */
+#ifndef FS_RESOURCE_IMAGE_FILE
+#define FS_RESOURCE_IMAGE_FILE "resources.bin"
+#endif
+
+/**
+ * @brief A mapping of the resource image file.
+ */
+typedef struct {
+	void* address; /*!< Start of the mapping. */
+	size_t size; /*!< Size of the mapping. */
+} LLFS_POSIX_mapping_t;
+
+/** @brief The mappings, a resource image is mapped at most three times at once (header, entries and data). */
+static LLFS_POSIX_mapping_t LLFS_POSIX_mappings[3];
+
+uint32_t LLFS_resource_storage_size(void) {
+	struct stat st;
+	return (stat(FS_RESOURCE_IMAGE_FILE, &st) == 0) ? (uint32_t)st.st_size : 0U;
+}
+
+int32_t LLFS_resource_storage_map(uint32_t size, const uint8_t** data, void** handle) {
+	LLFS_POSIX_mapping_t* mapping = NULL;
+	for (size_t i = 0; i < (sizeof(LLFS_POSIX_mappings) / sizeof(LLFS_POSIX_mappings[0])); i++) {
+		if (LLFS_POSIX_mappings[i].address == NULL) {
+			mapping = &LLFS_POSIX_mappings[i];
+			break;
+		}
+	}
+	int fd = open(FS_RESOURCE_IMAGE_FILE, O_RDONLY);
+	if ((mapping == NULL) || (fd < 0)) {
+		if (fd >= 0) {
+			(void)close(fd);
+		}
+		return LLFS_NOK;
+	}
+
+	void* address = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping stays valid after the file is closed
+	(void)close(fd);
+	if (address == MAP_FAILED) {
+		return LLFS_NOK;
+	}
+	mapping->address = address;
+	mapping->size = size;
+	*data = (const uint8_t*)address;
+	*handle = mapping;
+	return LLFS_OK;
+}
+
+void LLFS_resource_storage_unmap(void* handle) {
+	LLFS_POSIX_mapping_t* mapping = (LLFS_POSIX_mapping_t*)handle;
+	(void)munmap(mapping->address, mapping->size);
+	mapping->address = NULL;
+}
+
+int32_t LLFS_resource_storage_write(const uint8_t* image, uint32_t size) {
+	// Write in place, like the partition, so that the size of the storage does not change
+	FILE* file = fopen(FS_RESOURCE_IMAGE_FILE, "r+b");
+	if ((file == NULL) || (size > LLFS_resource_storage_size())) {
+		if (file != NULL) {
+			(void)fclose(file);
+		}
+		return LLFS_NOK;
+	}
+	bool written = (fwrite(image, 1, size, file) == size);
+	return ((fclose(file) == 0) && written) ? LLFS_OK : LLFS_NOK;
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -0,0 +1,109 @@
+/*
+ * C
+ *
+ * Copyright 2023 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Memory-mapped resource image implementation.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ * @date 26 April 2023
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sni.h"
+#include "LLFS_impl.h"
+#include "fs_configuration.h"
+#include "LLFS_EXTENSION_impl.h"
+#include "fs_helper.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * Sanity check between the expected version of the configuration and the actual version of
+ * the configuration.
+ * If an error is raised here, it means that a new version of the CCO has been installed and
+ * the configuration fs_configuration.h must be updated based on the one provided
+ * by the new CCO version.
+ */
+#if FS_CONFIGURATION_VERSION != 2
+
+	#error "Version of the configuration file fs_configuration.h is not compatible with this implementation."
+
+#endif
+
+/**
+ * @brief Mapped resource image. The image is mapped once, on first use, and is never unmapped
+ * so the addresses given to the Java side stay valid. Only accessed from the VM task.
+ */
+static LLFS_resource_image_t LLFS_RESOURCE_image;
+
+/**
+ * @brief Maps the resource image on first use.
+ *
+ * @return <code>LLFS_OK</code> on success, else <code>LLFS_NOK</code> and a NativeIOException is pending.
+ */
+static int32_t LLFS_RESOURCE_map(void){
+	const char* error_message;
+	if(LLFS_RESOURCE_image.data != NULL){
+		return LLFS_OK;
+	}
+	if(LLFS_resource_image_map(&LLFS_RESOURCE_image, &error_message) != LLFS_OK){
+		SNI_throwNativeIOException(LLFS_NOK, error_message);
+		return LLFS_NOK;
+	}
+	return LLFS_OK;
+}
+
+int32_t LLFS_RESOURCE_IMPL_open(uint8_t* name, int64_t* info){
+	LLFS_DEBUG_TRACE("[%s:%u] open resource %s\n", __func__, __LINE__, name);
+
+	if(SNI_getArrayLength(info) < LLFS_RESOURCE_INFO_SIZE){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid info array");
+		return LLFS_NOK;
+	}
+	if(LLFS_RESOURCE_map() != LLFS_OK){
+		return LLFS_NOK;
+	}
+
+	int32_t resource_id = LLFS_resource_image_find(&LLFS_RESOURCE_image, (const char*)name);
+	const LLFS_resource_image_entry_t* entry = LLFS_resource_image_get_entry(&LLFS_RESOURCE_image, resource_id);
+	if(entry != NULL){
+		info[LLFS_RESOURCE_INFO_ADDRESS] = (int64_t)(intptr_t)(LLFS_RESOURCE_image.data + entry->offset);
+		info[LLFS_RESOURCE_INFO_LENGTH] = (int64_t)entry->length;
+	}
+	return resource_id;
+}
+
+int32_t LLFS_RESOURCE_IMPL_read(int32_t resource_id, int32_t position, uint8_t* data, int32_t offset, int32_t length){
+	const LLFS_resource_image_entry_t* entry = LLFS_resource_image_get_entry(&LLFS_RESOURCE_image, resource_id);
+	if(entry == NULL){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid resource ID");
+		return LLFS_NOK;
+	}
+	if((position < 0) || (offset < 0) || (length < 0) || (length > (SNI_getArrayLength(data) - offset))){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid read bounds");
+		return LLFS_NOK;
+	}
+	if((uint32_t)position >= entry->length){
+		return LLFS_EOF;
+	}
+
+	uint32_t available = entry->length - (uint32_t)position;
+	int32_t count = ((uint32_t)length < available) ? length : (int32_t)available;
+	(void)memcpy(data + offset, LLFS_RESOURCE_image.data + entry->offset + (uint32_t)position, (size_t)count);
+	return count;
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -17,11 +17,13 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include "sni.h"
 #include "LLFS_impl.h"
 #include "fs_configuration.h"
 #include "fs_helper.h"
+#include "LLFS_EXTENSION_impl.h"
 
 #ifdef __cplusplus
 	extern "C" {
@@ -34,38 +36,143 @@
  * the configuration fs_configuration.h must be updated based on the one provided
  * by the new CCO version.
  */
-#if FS_CONFIGURATION_VERSION != 1
+#if FS_CONFIGURATION_VERSION != 2
 
 	#error "Version of the configuration file fs_configuration.h is not compatible with this implementation."
 
 #endif
 
+#if (FS_WORKER_COUNT < 1) || (FS_WORKER_COUNT > 4)
+	#error "FS_WORKER_COUNT must be between 1 and 4."
+#endif
+
+#if (FS_STAT_BATCH_SIZE < 1) || (FS_STAT_BATCH_SIZE > FS_WORKER_JOB_COUNT)
+	#error "FS_STAT_BATCH_SIZE must be between 1 and FS_WORKER_JOB_COUNT."
+#endif
+
+#if (FS_JOB_TIMEOUT < 0) || (FS_JOB_TIMEOUT > MICROEJ_ASYNC_WORKER_MAX_TIMEOUT)
+	#error "FS_JOB_TIMEOUT must be between 0 and MICROEJ_ASYNC_WORKER_MAX_TIMEOUT."
+#endif
+
 #ifndef FS_CUSTOM_WORKER
 /* Async worker task declaration ---------------------------------------------*/
 MICROEJ_ASYNC_WORKER_worker_declare(fs_worker, FS_WORKER_JOB_COUNT, FS_worker_param_t, FS_WAITING_LIST_SIZE);
 OSAL_task_stack_declare(fs_worker_stack, FS_WORKER_STACK_SIZE);
+#if FS_WORKER_COUNT > 1
+MICROEJ_ASYNC_WORKER_worker_declare(fs_worker_1, FS_WORKER_JOB_COUNT, FS_worker_param_t, FS_WAITING_LIST_SIZE);
+OSAL_task_stack_declare(fs_worker_1_stack, FS_WORKER_STACK_SIZE);
+#endif
+#if FS_WORKER_COUNT > 2
+MICROEJ_ASYNC_WORKER_worker_declare(fs_worker_2, FS_WORKER_JOB_COUNT, FS_worker_param_t, FS_WAITING_LIST_SIZE);
+OSAL_task_stack_declare(fs_worker_2_stack, FS_WORKER_STACK_SIZE);
+#endif
+#if FS_WORKER_COUNT > 3
+MICROEJ_ASYNC_WORKER_worker_declare(fs_worker_3, FS_WORKER_JOB_COUNT, FS_worker_param_t, FS_WAITING_LIST_SIZE);
+OSAL_task_stack_declare(fs_worker_3_stack, FS_WORKER_STACK_SIZE);
+#endif
+#endif
+
+#if FS_WORKER_COUNT > 1
+/**
+ * @brief The FS workers, <code>fs_worker</code> first.
+ */
+static MICROEJ_ASYNC_WORKER_handle_t* const fs_workers[FS_WORKER_COUNT] = {
+	&fs_worker,
+#if FS_WORKER_COUNT > 1
+	&fs_worker_1,
+#endif
+#if FS_WORKER_COUNT > 2
+	&fs_worker_2,
+#endif
+#if FS_WORKER_COUNT > 3
+	&fs_worker_3,
+#endif
+};
+
+/**
+ * @brief Index of the worker to try first for the next path operation.
+ */
+static int32_t fs_worker_next_path_index = 0;
 #endif
 
 static MICROEJ_ASYNC_WORKER_job_t* LLFS_allocate_path_job(uint8_t* path, SNI_callback retry_function);
 static int32_t LLFS_async_exec_path_job(uint8_t* path, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
 static int32_t LLFS_async_exec_directory_job(int32_t directory_ID, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done);
-static int32_t LLFS_IMPL_get_last_modified_on_done(uint8_t* path, LLFS_date_t* date);
 static int32_t LLFS_IMPL_path_function_on_done(uint8_t* path);
-static int64_t LLFS_IMPL_path64_function_on_done(uint8_t* path);
 static int32_t LLFS_IMPL_create_on_done(uint8_t* path);
 static int32_t LLFS_IMPL_read_directory_on_done(int32_t directory_ID, uint8_t* path);
+static int32_t LLFS_IMPL_read_directory_entries_on_done(int32_t directory_ID, uint8_t* pattern, uint8_t* entries);
 static int32_t LLFS_IMPL_close_directory_on_done(int32_t directory_ID);
 static int32_t LLFS_IMPL_rename_to_on_done(uint8_t* path, uint8_t* new_path);
 static int64_t LLFS_IMPL_get_space_size_on_done(uint8_t* path, int32_t space_type);
 static int32_t LLFS_IMPL_set_last_modified_on_done(uint8_t* path, LLFS_date_t* date);
-static int32_t LLFS_IMPL_is_accessible_on_done(uint8_t* path, int32_t access);
 static int32_t LLFS_IMPL_set_permission_on_done(uint8_t* path, int32_t access, int32_t enable, int32_t owner);
+static int32_t LLFS_IMPL_get_last_modified_on_done(uint8_t* path, LLFS_date_t* date);
+static int32_t LLFS_IMPL_get_last_modified_from_info(const FS_stat_info_t* info, LLFS_date_t* date);
+static int64_t LLFS_IMPL_get_length_on_done(uint8_t* path);
+static int64_t LLFS_IMPL_get_length_from_info(const FS_stat_info_t* info);
+static int32_t LLFS_IMPL_exist_on_done(uint8_t* path);
+static int32_t LLFS_IMPL_is_hidden_on_done(uint8_t* path);
+static int32_t LLFS_IMPL_is_hidden_from_info(const FS_stat_info_t* info);
+static int32_t LLFS_IMPL_is_directory_on_done(uint8_t* path);
+static int32_t LLFS_IMPL_is_directory_from_info(const FS_stat_info_t* info);
+static int32_t LLFS_IMPL_is_file_on_done(uint8_t* path);
+static int32_t LLFS_IMPL_is_file_from_info(const FS_stat_info_t* info);
+static int32_t LLFS_IMPL_is_accessible_on_done(uint8_t* path, int32_t access);
+static int32_t LLFS_IMPL_is_accessible_from_info(const FS_stat_info_t* info, int32_t access);
+static int32_t LLFS_IMPL_stat_on_done(uint8_t* path, int64_t* attributes);
+static int32_t LLFS_IMPL_stat_from_info(const FS_stat_info_t* info, int64_t* attributes);
+static int32_t LLFS_IMPL_stat_batch_on_done(uint8_t* paths, int32_t count, int64_t* attributes);
 static int32_t LLFS_async_exec_path_result(void);
+static int32_t LLFS_stat_get(uint8_t* path, FS_stat_info_t* info, SNI_callback native, SNI_callback on_done);
+static int32_t LLFS_stat_get_done(FS_stat_info_t* info);
+#if FS_STAT_CACHE_SIZE > 0
+static bool LLFS_stat_cache_lookup(uint8_t* path, FS_stat_info_t* info);
+static bool LLFS_stat_cache_find(const uint8_t* path, FS_stat_info_t* info);
+static void LLFS_stat_cache_insert(FS_stat_t* params);
+#endif
+
+#if FS_STAT_CACHE_SIZE > 0
+/**
+ * @brief Entry of the stat cache.
+ */
+typedef struct {
+	bool valid; /*!< true if the entry is in use. */
+	uint32_t last_use; /*!< Value of <code>LLFS_stat_cache_use_counter</code> when the entry was last used. */
+	FS_stat_info_t info; /*!< Attributes of the path. */
+	uint8_t path[FS_PATH_LENGTH]; /*!< Null terminated path. */
+} LLFS_stat_cache_entry_t;
+
+/**
+ * @brief The stat cache. Only accessed from the VM task.
+ */
+static LLFS_stat_cache_entry_t LLFS_stat_cache[FS_STAT_CACHE_SIZE];
+
+/**
+ * @brief Counter used to find the least recently used entry of the stat cache.
+ */
+static uint32_t LLFS_stat_cache_use_counter = 0;
+#endif
+
+/**
+ * @brief Incremented each time the stat cache is invalidated. A stat job started before an invalidation
+ * does not fill the cache.
+ */
+static uint32_t LLFS_stat_cache_generation = 0;
 
-void LLFS_IMPL_initialize(void){
 #ifndef FS_CUSTOM_WORKER
-	// cppcheck-suppress misra-c2012-11.8 // String casts conform to MICROEJ_ASYNC_WORKER_initialize function definitions.
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_initialize(&fs_worker, (uint8_t*)"MicroEJ FS", fs_worker_stack, FS_WORKER_PRIORITY);
+/**
+ * @brief Initializes and starts an FS worker.
+ *
+ * @param[in] async_worker the worker to initialize.
+ * @param[in] name worker task name.
+ * @param[in] stack worker task stack.
+ *
+ * @return <code>true</code> on success, else <code>false</code> and a NativeException is pending.
+ */
+static bool LLFS_initialize_worker(MICROEJ_ASYNC_WORKER_handle_t* async_worker, const char* name, OSAL_task_stack_t stack){
+	// cppcheck-suppress misra-c2012-11.8 // String casts conform to MICROEJ_ASYNC_WORKER_initialize_tasks function definitions.
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_initialize_tasks(async_worker, (uint8_t*)name, &stack, 1, FS_WORKER_PRIORITY, FS_WORKER_CORE);
 	if(status == MICROEJ_ASYNC_WORKER_INVALID_ARGS){
 		SNI_throwNativeException(status, "Invalid argument for FS async worker");
 	}else if (status == MICROEJ_ASYNC_WORKER_ERROR){
@@ -73,19 +180,96 @@ void LLFS_IMPL_initialize(void){
 	}else{
 		// Default case: MICROEJ_ASYNC_WORKER_OK
 	}
+	return status == MICROEJ_ASYNC_WORKER_OK;
+}
+#endif
+
+void LLFS_IMPL_initialize(void){
+	if(LLFS_helper_initialize() != LLFS_OK){
+		SNI_throwNativeException(LLFS_NOK, "Error while initializing FS helper");
+		return;
+	}
+
+#ifndef FS_CUSTOM_WORKER
+	bool initialized = LLFS_initialize_worker(&fs_worker, "MicroEJ FS", fs_worker_stack);
+#if FS_WORKER_COUNT > 1
+	initialized = initialized && LLFS_initialize_worker(&fs_worker_1, "MicroEJ FS 1", fs_worker_1_stack);
+#endif
+#if FS_WORKER_COUNT > 2
+	initialized = initialized && LLFS_initialize_worker(&fs_worker_2, "MicroEJ FS 2", fs_worker_2_stack);
+#endif
+#if FS_WORKER_COUNT > 3
+	initialized = initialized && LLFS_initialize_worker(&fs_worker_3, "MicroEJ FS 3", fs_worker_3_stack);
+#endif
+	(void)initialized;
 #endif
 
 	llfs_init();
 }
 
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_for_file(int32_t file_id){
+#if FS_WORKER_COUNT > 1
+	// File IDs are addresses: mix their bits before selecting the worker
+	uint32_t hash = (uint32_t)file_id * 2654435761u;
+	return fs_workers[(hash >> 16) % FS_WORKER_COUNT];
+#else
+	(void)file_id;
+	return &fs_worker;
+#endif
+}
+
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_for_path(void){
+#if FS_WORKER_COUNT > 1
+	// Select the worker with the fewest queued jobs
+	MICROEJ_ASYNC_WORKER_statistics_t statistics;
+	int32_t index = fs_worker_next_path_index;
+	int32_t best_index = index;
+	uint32_t best_queue_depth = UINT32_MAX;
+	for(int32_t i = 0; i < FS_WORKER_COUNT; i++){
+		MICROEJ_ASYNC_WORKER_get_statistics(fs_workers[index], &statistics, false);
+		if(statistics.queue_depth < best_queue_depth){
+			best_queue_depth = statistics.queue_depth;
+			best_index = index;
+		}
+		index = (index + 1) % FS_WORKER_COUNT;
+	}
+	// Round robin between equally loaded workers
+	fs_worker_next_path_index = (best_index + 1) % FS_WORKER_COUNT;
+	return fs_workers[best_index];
+#else
+	return &fs_worker;
+#endif
+}
+
+MICROEJ_ASYNC_WORKER_handle_t* LLFS_worker_of_job(MICROEJ_ASYNC_WORKER_job_t* job){
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = &fs_worker;
+#if FS_WORKER_COUNT > 1
+	uint8_t* job_params = (uint8_t*)job->params;
+	for(int32_t i = 0; i < FS_WORKER_COUNT; i++){
+		uint8_t* params = (uint8_t*)fs_workers[i]->params;
+		if((job_params >= params) && (job_params < (params + (fs_workers[i]->job_count * fs_workers[i]->params_sizeof)))){
+			async_worker = fs_workers[i];
+			break;
+		}
+	}
+#else
+	(void)job;
+#endif
+	return async_worker;
+}
+
 int32_t LLFS_IMPL_get_max_path_length(void){
 	return FS_PATH_LENGTH;
 }
 
 int32_t LLFS_IMPL_get_last_modified(uint8_t* path, LLFS_date_t* date){
-	(void)date;
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_get_last_modified, (SNI_callback)LLFS_IMPL_get_last_modified_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
 
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_get_last_modified, LLFS_IMPL_get_last_modified_action, (SNI_callback)LLFS_IMPL_get_last_modified_on_done);
+	return LLFS_IMPL_get_last_modified_from_info(&info, date);
 }
 
 int32_t LLFS_IMPL_set_read_only(uint8_t* path){
@@ -93,7 +277,7 @@ int32_t LLFS_IMPL_set_read_only(uint8_t* path){
 }
 
 int32_t LLFS_IMPL_create(uint8_t* path){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_create);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_IMPL_create);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -106,7 +290,7 @@ int32_t LLFS_IMPL_create(uint8_t* path){
 		SNI_throwNativeIOException(LLFS_NOK, "Path name too long");
 	}
 	else{
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_create_action, (SNI_callback)LLFS_IMPL_create_on_done);
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_create_action, (SNI_callback)LLFS_IMPL_create_on_done);
 		if(status == MICROEJ_ASYNC_WORKER_OK){
 			// Wait for the action to be done
 			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
@@ -114,7 +298,7 @@ int32_t LLFS_IMPL_create(uint8_t* path){
 	}
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
@@ -133,7 +317,7 @@ int32_t LLFS_IMPL_close_directory(int32_t directory_ID){
 }
 
 int32_t LLFS_IMPL_rename_to(uint8_t* path, uint8_t* new_path){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_rename_to);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_IMPL_rename_to);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -143,7 +327,7 @@ int32_t LLFS_IMPL_rename_to(uint8_t* path, uint8_t* new_path){
 
 	FS_rename_to_t* params = (FS_rename_to_t*)job->params;
 	if((LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK) && (LLFS_set_path_param(new_path, (uint8_t*)&params->new_path) == LLFS_OK)){
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_rename_to_action, (SNI_callback)LLFS_IMPL_rename_to_on_done);
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_rename_to_action, (SNI_callback)LLFS_IMPL_rename_to_on_done);
 		if(status == MICROEJ_ASYNC_WORKER_OK){
 			// Wait for the action to be done
 			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
@@ -151,20 +335,32 @@ int32_t LLFS_IMPL_rename_to(uint8_t* path, uint8_t* new_path){
 	}
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
 int64_t LLFS_IMPL_get_length(uint8_t* path){
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_get_length, LLFS_IMPL_get_length_action, (SNI_callback)LLFS_IMPL_path64_function_on_done);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_get_length, (SNI_callback)LLFS_IMPL_get_length_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_get_length_from_info(&info);
 }
 
 int32_t LLFS_IMPL_exist(uint8_t* path){
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_exist, LLFS_IMPL_exist_action, (SNI_callback)LLFS_IMPL_path_function_on_done);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_exist, (SNI_callback)LLFS_IMPL_exist_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return info.result;
 }
 
 int64_t LLFS_IMPL_get_space_size(uint8_t* path, int32_t space_type){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_get_space_size);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_IMPL_get_space_size);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -175,8 +371,9 @@ int64_t LLFS_IMPL_get_space_size(uint8_t* path, int32_t space_type){
 	FS_get_space_size* params = (FS_get_space_size*)job->params;
 	if(LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK){
 		params->space_type = space_type;
+		(void)MICROEJ_ASYNC_WORKER_set_job_timeout(job, FS_JOB_TIMEOUT);
 
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_get_space_size_action, (SNI_callback)LLFS_IMPL_get_space_size_on_done);
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_get_space_size_action, (SNI_callback)LLFS_IMPL_get_space_size_on_done);
 		if(status == MICROEJ_ASYNC_WORKER_OK){
 			// Wait for the action to be done
 			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
@@ -184,7 +381,7 @@ int64_t LLFS_IMPL_get_space_size(uint8_t* path, int32_t space_type){
 	}
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
@@ -193,19 +390,37 @@ int32_t LLFS_IMPL_make_directory(uint8_t* path){
 }
 
 int32_t LLFS_IMPL_is_hidden(uint8_t* path){
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_is_hidden, LLFS_IMPL_is_hidden_action, (SNI_callback)LLFS_IMPL_path_function_on_done);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_is_hidden, (SNI_callback)LLFS_IMPL_is_hidden_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_is_hidden_from_info(&info);
 }
 
 int32_t LLFS_IMPL_is_directory(uint8_t* path){
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_is_directory, LLFS_IMPL_is_directory_action, (SNI_callback)LLFS_IMPL_path_function_on_done);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_is_directory, (SNI_callback)LLFS_IMPL_is_directory_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_is_directory_from_info(&info);
 }
 
 int32_t LLFS_IMPL_is_file(uint8_t* path){
-	return LLFS_async_exec_path_job(path, (SNI_callback)LLFS_IMPL_is_file, LLFS_IMPL_is_file_action, (SNI_callback)LLFS_IMPL_path_function_on_done);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_is_file, (SNI_callback)LLFS_IMPL_is_file_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_is_file_from_info(&info);
 }
 
 int32_t LLFS_IMPL_set_last_modified(uint8_t* path, LLFS_date_t* date){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_set_last_modified);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_IMPL_set_last_modified);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -217,7 +432,7 @@ int32_t LLFS_IMPL_set_last_modified(uint8_t* path, LLFS_date_t* date){
 	if(LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK){
 		params->date = *date;
 
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_set_last_modified_action, (SNI_callback)LLFS_IMPL_set_last_modified_on_done);
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_set_last_modified_action, (SNI_callback)LLFS_IMPL_set_last_modified_on_done);
 		if(status == MICROEJ_ASYNC_WORKER_OK){
 			// Wait for the action to be done
 			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
@@ -225,7 +440,7 @@ int32_t LLFS_IMPL_set_last_modified(uint8_t* path, LLFS_date_t* date){
 	}
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
@@ -234,7 +449,17 @@ int32_t LLFS_IMPL_delete(uint8_t* path){
 }
 
 int32_t LLFS_IMPL_is_accessible(uint8_t* path, int32_t access){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_is_accessible);
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_is_accessible, (SNI_callback)LLFS_IMPL_is_accessible_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_is_accessible_from_info(&info, access);
+}
+
+int32_t LLFS_IMPL_set_permission(uint8_t* path, int32_t access, int32_t enable, int32_t owner){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), (SNI_callback)LLFS_IMPL_set_permission);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -242,11 +467,13 @@ int32_t LLFS_IMPL_is_accessible(uint8_t* path, int32_t access){
 		return LLFS_NOK;
 	}
 
-	FS_is_accessible_t* params = (FS_is_accessible_t*)job->params;
+	FS_set_permission_t* params = (FS_set_permission_t*)job->params;
 	if(LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK){
 		params->access = access;
+		params->enable = enable;
+		params->owner = owner;
 
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_is_accessible_action, (SNI_callback)LLFS_IMPL_is_accessible_on_done);
+		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_set_permission_action, (SNI_callback)LLFS_IMPL_set_permission_on_done);
 		if(status == MICROEJ_ASYNC_WORKER_OK){
 			// Wait for the action to be done
 			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
@@ -254,12 +481,129 @@ int32_t LLFS_IMPL_is_accessible(uint8_t* path, int32_t access){
 	}
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
-int32_t LLFS_IMPL_set_permission(uint8_t* path, int32_t access, int32_t enable, int32_t owner){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, (SNI_callback)LLFS_IMPL_set_permission);
+int32_t LLFS_IMPL_stat(uint8_t* path, int64_t* attributes){
+	if(SNI_getArrayLength(attributes) < LLFS_STAT_ATTRIBUTES_LENGTH){
+		SNI_throwNativeIOException(LLFS_NOK, "Attributes array too small");
+		return LLFS_NOK;
+	}
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get(path, &info, (SNI_callback)LLFS_IMPL_stat, (SNI_callback)LLFS_IMPL_stat_on_done) != LLFS_OK){
+		// Wait for the stat job to be done, or an exception is pending
+		return LLFS_NOK;
+	}
+
+	return LLFS_IMPL_stat_from_info(&info, attributes);
+}
+
+int32_t LLFS_IMPL_stat_batch(uint8_t* paths, int32_t count, int64_t* attributes){
+	int32_t paths_length = SNI_getArrayLength(paths);
+	int32_t batch_size = (count < FS_STAT_BATCH_SIZE) ? count : FS_STAT_BATCH_SIZE;
+	int32_t offsets[FS_STAT_BATCH_SIZE];
+	if(count < 1){
+		SNI_throwNativeIOException(LLFS_NOK, "Invalid path count");
+		return LLFS_NOK;
+	}
+	if(SNI_getArrayLength(attributes) < (batch_size * LLFS_STAT_ATTRIBUTES_LENGTH)){
+		SNI_throwNativeIOException(LLFS_NOK, "Attributes array too small");
+		return LLFS_NOK;
+	}
+
+	// Check all the paths before allocating any job
+	int32_t offset = 0;
+	for(int32_t i = 0; i < batch_size; i++){
+		uint8_t* end = (uint8_t*)memchr(&paths[offset], 0, (size_t)(paths_length - offset));
+		if(end == NULL){
+			SNI_throwNativeIOException(LLFS_NOK, "Path not null terminated");
+			return LLFS_NOK;
+		}
+		int32_t path_length = (int32_t)(end - &paths[offset]) + 1;
+		if(path_length > FS_PATH_LENGTH){
+			SNI_throwNativeException(LLFS_NOK, "Path length is too long");
+			return LLFS_NOK;
+		}
+		offsets[i] = offset;
+		offset += path_length;
+	}
+
+	// Read the cached paths now and allocate a job for each other one, all on the same worker
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = LLFS_worker_for_path();
+	MICROEJ_ASYNC_WORKER_job_t* jobs[FS_STAT_BATCH_SIZE];
+	int32_t job_count = 0;
+	for(int32_t i = 0; i < batch_size; i++){
+		uint8_t* path = &paths[offsets[i]];
+#if FS_STAT_CACHE_SIZE > 0
+		FS_stat_info_t info;
+		if(LLFS_stat_cache_find(path, &info)){
+			(void)LLFS_IMPL_stat_from_info(&info, &attributes[i * LLFS_STAT_ATTRIBUTES_LENGTH]);
+			continue;
+		}
+#endif
+		MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(async_worker, (SNI_callback)LLFS_IMPL_stat_batch);
+		if(job == NULL){
+			// No job available: release the ones already allocated and either:
+			// - wait for a job to be available and this function to be executed again,
+			// - or an exception is pending.
+			for(int32_t j = 0; j < job_count; j++){
+				MICROEJ_ASYNC_WORKER_free_job(async_worker, jobs[j]);
+			}
+			return LLFS_NOK;
+		}
+
+		FS_stat_t* params = (FS_stat_t*)job->params;
+		// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+		strncpy((char*)params->path, (char*)path, FS_PATH_LENGTH);
+		params->generation = LLFS_stat_cache_generation;
+		params->index = i;
+		jobs[job_count] = job;
+		job_count++;
+	}
+
+	if(job_count == 0){
+		// All the paths were in the stat cache
+		return batch_size;
+	}
+
+	// Metadata query: do not wait behind pending reads and writes, and do not wait forever for a stuck volume.
+	// The lane and the timeout of a batch are the ones of its first job.
+	MICROEJ_ASYNC_WORKER_set_job_lane(jobs[0], MICROEJ_ASYNC_WORKER_LANE_HIGH);
+	(void)MICROEJ_ASYNC_WORKER_set_job_timeout(jobs[0], FS_JOB_TIMEOUT);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec_batch(async_worker, jobs, job_count, LLFS_IMPL_stat_action, (SNI_callback)LLFS_IMPL_stat_batch_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the batch to be done
+		return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec_batch has thrown a SNI exception
+
+	// Error
+	MICROEJ_ASYNC_WORKER_free_batch(async_worker, jobs[0]);
+	return LLFS_NOK;
+}
+
+void LLFS_IMPL_get_flash_statistics(int64_t* statistics, jboolean reset){
+	if(SNI_getArrayLength(statistics) < LLFS_FLASH_STAT_COUNT){
+		SNI_throwNativeIOException(LLFS_NOK, "Statistics array too small");
+		return;
+	}
+	llfs_get_flash_statistics(statistics, reset == (jboolean)JTRUE);
+}
+
+int32_t LLFS_IMPL_read_directory_entries(int32_t directory_ID, uint8_t* pattern, uint8_t* entries){
+	int32_t entries_length = SNI_getArrayLength(entries);
+	int32_t pattern_length = SNI_getArrayLength(pattern);
+	if(entries_length < LLFS_DIRECTORY_ENTRY_MAX_LENGTH){
+		SNI_throwNativeIOException(LLFS_NOK, "Entries array too small");
+		return LLFS_NOK;
+	}
+	if(pattern_length > FS_DIRECTORY_PATTERN_LENGTH){
+		SNI_throwNativeIOException(LLFS_NOK, "Pattern too long");
+		return LLFS_NOK;
+	}
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(directory_ID), (SNI_callback)LLFS_IMPL_read_directory_entries);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -267,24 +611,34 @@ int32_t LLFS_IMPL_set_permission(uint8_t* path, int32_t access, int32_t enable,
 		return LLFS_NOK;
 	}
 
-	FS_set_permission_t* params = (FS_set_permission_t*)job->params;
-	if(LLFS_set_path_param(path, (uint8_t*)&params->path) == LLFS_OK){
-		params->access = access;
-		params->enable = enable;
-		params->owner = owner;
+	FS_read_directory_entries_t* params = (FS_read_directory_entries_t*)job->params;
+	params->directory_ID = directory_ID;
+	params->length = (entries_length < FS_IO_BUFFER_SIZE) ? entries_length : FS_IO_BUFFER_SIZE;
+	params->pattern[0] = 0;
+	// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+	memcpy(params->pattern, pattern, pattern_length);
+	params->pattern[FS_DIRECTORY_PATTERN_LENGTH - 1] = 0;
 
-		MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, LLFS_IMPL_set_permission_action, (SNI_callback)LLFS_IMPL_set_permission_on_done);
-		if(status == MICROEJ_ASYNC_WORKER_OK){
-			// Wait for the action to be done
-			return SNI_IGNORED_RETURNED_VALUE;//returned value not used
-		} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-	}
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_read_directory_entries_action, (SNI_callback)LLFS_IMPL_read_directory_entries_on_done);
+	if(status == MICROEJ_ASYNC_WORKER_OK){
+		// Wait for the action to be done
+		return SNI_IGNORED_RETURNED_VALUE;//returned value not used
+	} // else an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
 
 	// Error
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return LLFS_NOK;
 }
 
+void LLFS_stat_cache_invalidate(void){
+#if FS_STAT_CACHE_SIZE > 0
+	for(int32_t i = 0; i < FS_STAT_CACHE_SIZE; i++){
+		LLFS_stat_cache[i].valid = false;
+	}
+#endif
+	LLFS_stat_cache_generation++;
+}
+
 int32_t LLFS_set_path_param(uint8_t* path, uint8_t* path_param){
 	int32_t path_length = SNI_getArrayLength(path);
 	if(path_length > FS_PATH_LENGTH){
@@ -306,7 +660,7 @@ int32_t LLFS_set_path_param(uint8_t* path, uint8_t* path_param){
  * @return an allocated job object or NULL if the allocation fails.
  */
 static MICROEJ_ASYNC_WORKER_job_t* LLFS_allocate_path_job(uint8_t* path, SNI_callback retry_function){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, retry_function);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_path(), retry_function);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -317,7 +671,7 @@ static MICROEJ_ASYNC_WORKER_job_t* LLFS_allocate_path_job(uint8_t* path, SNI_cal
 	FS_path_operation_t* params = (FS_path_operation_t*)job->params;
 	if(LLFS_set_path_param(path, (uint8_t*)&params->path) != LLFS_OK){
 		// Path name too long
-		MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 		return NULL;
 	}
 
@@ -326,11 +680,8 @@ static MICROEJ_ASYNC_WORKER_job_t* LLFS_allocate_path_job(uint8_t* path, SNI_cal
 
 /**
  * @brief Prepare and send an execution job to async_worker, called either from
- * <code>LLFS_IMPL_get_last_modified</code>, <code>LLFS_IMPL_set_read_only</code>,
- * <code>LLFS_IMPL_open_directory</code>, <code>LLFS_IMPL_get_length</code>,
- * <code>LLFS_IMPL_exist</code>, <code>LLFS_IMPL_make_directory</code>,
- * <code>LLFS_IMPL_is_hidden</code>, <code>LLFS_IMPL_is_directory</code>,
- * <code>LLFS_IMPL_is_file</code> or <code>LLFS_IMPL_delete</code>.
+ * <code>LLFS_IMPL_set_read_only</code>, <code>LLFS_IMPL_open_directory</code>,
+ * <code>LLFS_IMPL_make_directory</code> or <code>LLFS_IMPL_delete</code>.
  *
  * @param[in] path absolute path of file.
  * @param[in] retry_function if the current Java thread has been suspended, this function is called when it is resumed.
@@ -348,10 +699,10 @@ static int32_t LLFS_async_exec_path_job(uint8_t* path, SNI_callback retry_functi
 		return LLFS_NOK;
 	}
 
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, action, on_done);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, on_done);
 	if(status != MICROEJ_ASYNC_WORKER_OK){
 		// an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-		MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 		return LLFS_NOK;
 	}
 	else {
@@ -372,7 +723,7 @@ static int32_t LLFS_async_exec_path_job(uint8_t* path, SNI_callback retry_functi
  * @return <code>SNI_IGNORED_RETURNED_VALUE</code> on success, else a negative error code.
  */
 static int32_t LLFS_async_exec_directory_job(int32_t directory_ID, SNI_callback retry_function, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&fs_worker, retry_function);
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(LLFS_worker_for_file(directory_ID), retry_function);
 	if(job == NULL){
 		// No job available, either:
 		// - wait for a job to be available and this function to be executed again,
@@ -383,11 +734,11 @@ static int32_t LLFS_async_exec_directory_job(int32_t directory_ID, SNI_callback
 	FS_directory_operation_t* params = (FS_directory_operation_t*)job->params;
 	params->directory_ID = directory_ID;
 
-	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(&fs_worker, job, action, on_done);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, action, on_done);
 
 	if(status != MICROEJ_ASYNC_WORKER_OK){
 		// an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
-		MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 		return LLFS_NOK;
 	}
 	else {
@@ -396,42 +747,15 @@ static int32_t LLFS_async_exec_directory_job(int32_t directory_ID, SNI_callback
 	}
 }
 
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_get_last_modified</code> is done.
- *
- * @param[in] path absolute path of file.
- * @param[out] date the structure where the date is stored.
- *
- * @return <code>LLFS_IMPL_get_last_modified_action</code> function return code.
- */
-static int32_t LLFS_IMPL_get_last_modified_on_done(uint8_t* path, LLFS_date_t* date){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_last_modified_t* params = (FS_last_modified_t*)job->params;
-
-	(void)path;
-
-	int32_t result = params->result;
-	if(result == LLFS_OK){
-		*date = params->date;
-	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-
-	return result;
-}
-
 /**
  * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_set_read_only</code>,
- * <code>LLFS_IMPL_open_directory</code>, <code>LLFS_IMPL_exist</code>,
- * <code>LLFS_IMPL_make_directory</code>, <code>LLFS_IMPL_is_hidden</code>,
- * <code>LLFS_IMPL_is_directory</code>, <code>LLFS_IMPL_is_file</code> or
+ * <code>LLFS_IMPL_open_directory</code>, <code>LLFS_IMPL_make_directory</code> or
  * <code>LLFS_IMPL_delete</code> is done.
  *
  * @param[in] path absolute path of file.
  *
  * @return <code>LLFS_IMPL_set_read_only_action</code>,
- * <code>LLFS_IMPL_open_directory_action</code>, <code>LLFS_IMPL_exist_action</code>,
- * <code>LLFS_IMPL_make_directory_action</code>, <code>LLFS_IMPL_is_hidden_action</code>,
- * <code>LLFS_IMPL_is_directory_action</code>, <code>LLFS_IMPL_is_file_action</code> or
+ * <code>LLFS_IMPL_open_directory_action</code>, <code>LLFS_IMPL_make_directory_action</code> or
  * <code>LLFS_IMPL_delete_action</code> function return code.
  */
 static int32_t LLFS_IMPL_path_function_on_done(uint8_t* path){
@@ -440,24 +764,6 @@ static int32_t LLFS_IMPL_path_function_on_done(uint8_t* path){
 	return LLFS_async_exec_path_result();
 }
 
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_get_length</code> is done.
- *
- * @param[in] path absolute path of file.
- *
- * @return <code>LLFS_IMPL_get_length_action</code> function return code.
- */
-static int64_t LLFS_IMPL_path64_function_on_done(uint8_t* path){
-	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
-	FS_path64_operation_t* params = (FS_path64_operation_t*)job->params;
-
-	(void)path;
-
-	int64_t result = params->result;
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
-	return result;
-}
-
 /**
  * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_create</code> is done.
  *
@@ -467,6 +773,9 @@ static int64_t LLFS_IMPL_path64_function_on_done(uint8_t* path){
  */
 static int32_t LLFS_IMPL_create_on_done(uint8_t* path){
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
 	FS_create_t* params = (FS_create_t*)job->params;
 
 	(void)path;
@@ -476,7 +785,8 @@ static int32_t LLFS_IMPL_create_on_done(uint8_t* path){
 		// Exception
 		SNI_throwNativeIOException(params->error_code, params->error_message);
 	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
 
 	return result;
 }
@@ -491,6 +801,9 @@ static int32_t LLFS_IMPL_create_on_done(uint8_t* path){
  */
 static int32_t LLFS_IMPL_read_directory_on_done(int32_t directory_ID, uint8_t* path){
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
 	FS_read_directory_t* params = (FS_read_directory_t*)job->params;
 
 	(void)directory_ID;
@@ -510,7 +823,40 @@ static int32_t LLFS_IMPL_read_directory_on_done(int32_t directory_ID, uint8_t* p
 			result = LLFS_NOK;
 		}
 	}
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_read_directory_entries</code> is done.
+ *
+ * @param[in] directory_ID the directory ID.
+ * @param[in] pattern the glob pattern.
+ * @param[out] entries the array receiving the packed entries.
+ *
+ * @return <code>LLFS_IMPL_read_directory_entries_action</code> function return code.
+ */
+static int32_t LLFS_IMPL_read_directory_entries_on_done(int32_t directory_ID, uint8_t* pattern, uint8_t* entries){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_read_directory_entries_t* params = (FS_read_directory_entries_t*)job->params;
+
+	(void)directory_ID;
+	(void)pattern;
+
+	int32_t result = params->result;
+	if(result == LLFS_NOK){
+		// Exception
+		SNI_throwNativeIOException(params->error_code, params->error_message);
+	}
+	else {
+		// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+		memcpy(entries, params->buffer, params->length);
+	}
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 
 	return result;
 }
@@ -524,12 +870,15 @@ static int32_t LLFS_IMPL_read_directory_on_done(int32_t directory_ID, uint8_t* p
  */
 static int32_t LLFS_IMPL_close_directory_on_done(int32_t directory_ID){
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
 	FS_close_directory_t* params = (FS_close_directory_t*)job->params;
 
 	(void)directory_ID;
 
 	int32_t result = params->result;
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return result;
 }
 
@@ -558,13 +907,16 @@ static int32_t LLFS_IMPL_rename_to_on_done(uint8_t* path, uint8_t* new_path){
  */
 static int64_t LLFS_IMPL_get_space_size_on_done(uint8_t* path, int32_t space_type){
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
 	FS_get_space_size* params = (FS_get_space_size*)job->params;
 
 	(void)path;
 	(void)space_type;
 
 	int64_t result = params->result;
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
 	return result;
 }
 
@@ -583,21 +935,6 @@ static int32_t LLFS_IMPL_set_last_modified_on_done(uint8_t* path, LLFS_date_t* d
 	return LLFS_async_exec_path_result();
 }
 
-/**
- * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_is_accessible</code> is done.
- *
- * @param[in] path absolute path of file to modified.
- * @param[in] access access type to be checked.
- *
- * @return <code>LLFS_IMPL_is_accessible_action</code> function return code.
- */
-static int32_t LLFS_IMPL_is_accessible_on_done(uint8_t* path, int32_t access){
-	(void)path;
-	(void)access;
-
-	return LLFS_async_exec_path_result();
-}
-
 /**
  * @brief The <code>SNI_callback</code> called when the async_worker job requested by <code>LLFS_IMPL_set_permission</code> is done.
  *
@@ -617,23 +954,465 @@ static int32_t LLFS_IMPL_set_permission_on_done(uint8_t* path, int32_t access, i
 	return LLFS_async_exec_path_result();
 }
 
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_get_last_modified</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ * @param[out] date the last modified date.
+ *
+ * @return @see <code>LLFS_IMPL_get_last_modified</code>.
+ */
+static int32_t LLFS_IMPL_get_last_modified_on_done(uint8_t* path, LLFS_date_t* date){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_get_last_modified_from_info(&info, date);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_get_last_modified</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ * @param[out] date the last modified date.
+ *
+ * @return @see <code>LLFS_IMPL_get_last_modified</code>.
+ */
+static int32_t LLFS_IMPL_get_last_modified_from_info(const FS_stat_info_t* info, LLFS_date_t* date){
+	if(info->result == LLFS_OK){
+		*date = info->last_modified;
+	}
+	return info->result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_get_length</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ *
+ * @return @see <code>LLFS_IMPL_get_length</code>.
+ */
+static int64_t LLFS_IMPL_get_length_on_done(uint8_t* path){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_get_length_from_info(&info);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_get_length</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ *
+ * @return @see <code>LLFS_IMPL_get_length</code>.
+ */
+static int64_t LLFS_IMPL_get_length_from_info(const FS_stat_info_t* info){
+	int64_t result;
+	if(info->result == LLFS_OK){
+		result = info->length;
+	}else if(info->no_file){
+		result = 0;
+	}else{
+		result = LLFS_NOK;
+	}
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_exist</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ *
+ * @return @see <code>LLFS_IMPL_exist</code>.
+ */
+static int32_t LLFS_IMPL_exist_on_done(uint8_t* path){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return info.result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_is_hidden</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ *
+ * @return @see <code>LLFS_IMPL_is_hidden</code>.
+ */
+static int32_t LLFS_IMPL_is_hidden_on_done(uint8_t* path){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_is_hidden_from_info(&info);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_is_hidden</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ *
+ * @return @see <code>LLFS_IMPL_is_hidden</code>.
+ */
+static int32_t LLFS_IMPL_is_hidden_from_info(const FS_stat_info_t* info){
+	return ((info->result == LLFS_OK) && info->hidden) ? LLFS_OK : LLFS_NOK;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_is_directory</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ *
+ * @return @see <code>LLFS_IMPL_is_directory</code>.
+ */
+static int32_t LLFS_IMPL_is_directory_on_done(uint8_t* path){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_is_directory_from_info(&info);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_is_directory</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ *
+ * @return @see <code>LLFS_IMPL_is_directory</code>.
+ */
+static int32_t LLFS_IMPL_is_directory_from_info(const FS_stat_info_t* info){
+	return ((info->result == LLFS_OK) && info->directory) ? LLFS_OK : LLFS_NOK;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_is_file</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ *
+ * @return @see <code>LLFS_IMPL_is_file</code>.
+ */
+static int32_t LLFS_IMPL_is_file_on_done(uint8_t* path){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_is_file_from_info(&info);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_is_file</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ *
+ * @return @see <code>LLFS_IMPL_is_file</code>.
+ */
+static int32_t LLFS_IMPL_is_file_from_info(const FS_stat_info_t* info){
+	return ((info->result == LLFS_OK) && !info->directory) ? LLFS_OK : LLFS_NOK;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_is_accessible</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ * @param[in] access access type to check.
+ *
+ * @return @see <code>LLFS_IMPL_is_accessible</code>.
+ */
+static int32_t LLFS_IMPL_is_accessible_on_done(uint8_t* path, int32_t access){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_is_accessible_from_info(&info, access);
+}
+
+/**
+ * @brief Returns the result of <code>LLFS_IMPL_is_accessible</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ * @param[in] access access type to check.
+ *
+ * @return @see <code>LLFS_IMPL_is_accessible</code>.
+ */
+static int32_t LLFS_IMPL_is_accessible_from_info(const FS_stat_info_t* info, int32_t access){
+	int32_t result = info->result;
+	if(result == LLFS_OK){
+		switch (access) {
+		case LLFS_ACCESS_WRITE:
+			result = info->read_only ? LLFS_NOK : LLFS_OK;
+			break;
+		/* FatFs doesn't support other permissions so return always ok */
+		case LLFS_ACCESS_READ:
+		case LLFS_ACCESS_EXECUTE:
+			result = LLFS_OK;
+			break;
+		default:
+			result = LLFS_NOK;
+			break;
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat job requested by <code>LLFS_IMPL_stat</code> is done.
+ *
+ * @param[in] path absolute path of file.
+ * @param[out] attributes the array receiving the attributes.
+ *
+ * @return @see <code>LLFS_IMPL_stat</code>.
+ */
+static int32_t LLFS_IMPL_stat_on_done(uint8_t* path, int64_t* attributes){
+	(void)path;
+
+	FS_stat_info_t info;
+	if(LLFS_stat_get_done(&info) != LLFS_OK){
+		return LLFS_NOK;
+	}
+	return LLFS_IMPL_stat_from_info(&info, attributes);
+}
+
+/**
+ * @brief The <code>SNI_callback</code> called when the stat batch requested by <code>LLFS_IMPL_stat_batch</code> is done.
+ *
+ * @param[in] paths the null terminated absolute paths.
+ * @param[in] count the number of paths.
+ * @param[out] attributes the array receiving the attributes.
+ *
+ * @return @see <code>LLFS_IMPL_stat_batch</code>.
+ */
+static int32_t LLFS_IMPL_stat_batch_on_done(uint8_t* paths, int32_t count, int64_t* attributes){
+	(void)paths;
+
+	MICROEJ_ASYNC_WORKER_job_t* first_job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(first_job == NULL){
+		return LLFS_NOK;
+	}
+
+	// The paths found in the stat cache have been filled by LLFS_IMPL_stat_batch
+	for(MICROEJ_ASYNC_WORKER_job_t* job = first_job; job != NULL; job = MICROEJ_ASYNC_WORKER_get_next_batch_job(job)){
+		FS_stat_t* params = (FS_stat_t*)job->params;
+		(void)LLFS_IMPL_stat_from_info(&params->info, &attributes[params->index * LLFS_STAT_ATTRIBUTES_LENGTH]);
+#if FS_STAT_CACHE_SIZE > 0
+		LLFS_stat_cache_insert(params);
+#endif
+	}
+	MICROEJ_ASYNC_WORKER_free_batch(LLFS_worker_of_job(first_job), first_job);
+	return (count < FS_STAT_BATCH_SIZE) ? count : FS_STAT_BATCH_SIZE;
+}
+
+/**
+ * @brief Fills the attributes array of <code>LLFS_IMPL_stat</code> from the attributes of the path.
+ *
+ * @param[in] info the attributes of the path.
+ * @param[out] attributes the array receiving the attributes.
+ *
+ * @return @see <code>LLFS_IMPL_stat</code>.
+ */
+static int32_t LLFS_IMPL_stat_from_info(const FS_stat_info_t* info, int64_t* attributes){
+	if(info->result == LLFS_OK){
+		int64_t flags = LLFS_STAT_FLAG_EXISTS;
+		if(info->directory){
+			flags |= LLFS_STAT_FLAG_DIRECTORY;
+		}
+		if(info->hidden){
+			flags |= LLFS_STAT_FLAG_HIDDEN;
+		}
+		if(info->read_only){
+			flags |= LLFS_STAT_FLAG_READ_ONLY;
+		}
+		attributes[LLFS_STAT_FLAGS] = flags;
+		attributes[LLFS_STAT_LENGTH] = info->length;
+		attributes[LLFS_STAT_YEAR] = info->last_modified.year;
+		attributes[LLFS_STAT_MONTH] = info->last_modified.month;
+		attributes[LLFS_STAT_DAY] = info->last_modified.day;
+		attributes[LLFS_STAT_HOUR] = info->last_modified.hour;
+		attributes[LLFS_STAT_MINUTE] = info->last_modified.minute;
+		attributes[LLFS_STAT_SECOND] = info->last_modified.second;
+	}else{
+		attributes[LLFS_STAT_FLAGS] = 0;
+	}
+	return info->result;
+}
+
 /**
  * @brief Unified handling for <code>SNI_callback</code>, called via
  * <code>LLFS_IMPL_path_function_on_done</code>, <code>LLFS_IMPL_rename_to_on_done</code>,
- * <code>LLFS_IMPL_set_last_modified_on_done</code>, <code>LLFS_IMPL_is_accessible_on_done</code> and
- * <code>LLFS_IMPL_set_permission_on_done</code> functions.
+ * <code>LLFS_IMPL_set_last_modified_on_done</code> and <code>LLFS_IMPL_set_permission_on_done</code> functions.
+ * All these operations but <code>LLFS_IMPL_open_directory</code> modify the file system, so the stat cache is invalidated.
  *
  * @return @see function callers return code.
  */
 static int32_t LLFS_async_exec_path_result(void){
 	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
 	FS_path_operation_t* params = (FS_path_operation_t*)job->params;
 
 	int32_t result = params->result;
-	MICROEJ_ASYNC_WORKER_free_job(&fs_worker, job);
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	LLFS_stat_cache_invalidate();
 	return result;
 }
 
+#if FS_STAT_CACHE_SIZE > 0
+/**
+ * @brief Looks for the attributes of a path in the stat cache.
+ *
+ * @param[in] path absolute path of file.
+ * @param[out] info the attributes of the path, if found.
+ *
+ * @return <code>true</code> if the path is in the cache, else <code>false</code>.
+ */
+static bool LLFS_stat_cache_lookup(uint8_t* path, FS_stat_info_t* info){
+	if(SNI_getArrayLength(path) > FS_PATH_LENGTH){
+		// Can not be in the cache, let the path job report the error
+		return false;
+	}
+	return LLFS_stat_cache_find(path, info);
+}
+
+/**
+ * @brief Looks for the attributes of a path in the stat cache.
+ *
+ * @param[in] path null terminated absolute path, not longer than <code>FS_PATH_LENGTH</code>.
+ * @param[out] info the attributes of the path, if found.
+ *
+ * @return <code>true</code> if the path is in the cache, else <code>false</code>.
+ */
+static bool LLFS_stat_cache_find(const uint8_t* path, FS_stat_info_t* info){
+	for(int32_t i = 0; i < FS_STAT_CACHE_SIZE; i++){
+		LLFS_stat_cache_entry_t* entry = &LLFS_stat_cache[i];
+		if(entry->valid && (strncmp((char*)entry->path, (const char*)path, FS_PATH_LENGTH) == 0)){
+			LLFS_stat_cache_use_counter++;
+			entry->last_use = LLFS_stat_cache_use_counter;
+			*info = entry->info;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Stores the result of a stat job in the stat cache, replacing the least recently used entry.
+ *
+ * The result is dropped if the cache has been invalidated since the job was started, or if the attributes
+ * could not be read for another reason than a missing file.
+ *
+ * @param[in] params the parameters of the stat job.
+ */
+static void LLFS_stat_cache_insert(FS_stat_t* params){
+	if((params->generation != LLFS_stat_cache_generation) || ((params->info.result != LLFS_OK) && !params->info.no_file)){
+		return;
+	}
+
+	LLFS_stat_cache_entry_t* victim = &LLFS_stat_cache[0];
+	for(int32_t i = 0; i < FS_STAT_CACHE_SIZE; i++){
+		LLFS_stat_cache_entry_t* entry = &LLFS_stat_cache[i];
+		if(!entry->valid){
+			victim = entry;
+			break;
+		}
+		if((LLFS_stat_cache_use_counter - entry->last_use) > (LLFS_stat_cache_use_counter - victim->last_use)){
+			victim = entry;
+		}
+	}
+
+	LLFS_stat_cache_use_counter++;
+	victim->valid = true;
+	victim->last_use = LLFS_stat_cache_use_counter;
+	victim->info = params->info;
+	// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+	memcpy(victim->path, params->path, FS_PATH_LENGTH);
+}
+#endif
+
+/**
+ * @brief Gets the attributes of a path from the stat cache, or starts a stat job.
+ *
+ * Called by the natives reading path attributes. On a cache miss, a stat job is started: when it is done,
+ * <code>on_done</code> is called and gets the attributes read by the job with <code>LLFS_stat_get_done</code>.
+ *
+ * @param[in] path absolute path of file.
+ * @param[out] info the attributes of the path, if found in the cache.
+ * @param[in] native the calling native, called again when a job is available.
+ * @param[in] on_done the <code>SNI_callback</code> of the native called when the stat job is done.
+ *
+ * @return <code>LLFS_OK</code> if <code>info</code> is filled, else <code>LLFS_NOK</code> if the job is
+ * in progress or an exception is pending.
+ */
+static int32_t LLFS_stat_get(uint8_t* path, FS_stat_info_t* info, SNI_callback native, SNI_callback on_done){
+#if FS_STAT_CACHE_SIZE > 0
+	if(LLFS_stat_cache_lookup(path, info)){
+		return LLFS_OK;
+	}
+#else
+	(void)info;
+#endif
+
+	MICROEJ_ASYNC_WORKER_job_t* job = LLFS_allocate_path_job(path, native);
+	if(job == NULL){
+		// No job available, either:
+		// - wait for a job to be available and this function to be executed again,
+		// - or an exception is pending.
+		return LLFS_NOK;
+	}
+
+	FS_stat_t* params = (FS_stat_t*)job->params;
+	params->generation = LLFS_stat_cache_generation;
+
+	// Metadata query: do not wait behind pending reads and writes, and do not wait forever for a stuck volume
+	MICROEJ_ASYNC_WORKER_set_job_lane(job, MICROEJ_ASYNC_WORKER_LANE_HIGH);
+	(void)MICROEJ_ASYNC_WORKER_set_job_timeout(job, FS_JOB_TIMEOUT);
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_async_exec(LLFS_worker_of_job(job), job, LLFS_IMPL_stat_action, on_done);
+	if(status != MICROEJ_ASYNC_WORKER_OK){
+		// an error occurred and MICROEJ_ASYNC_WORKER_async_exec has thrown a SNI exception
+		MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	} // else wait for the action to be done
+
+	return LLFS_NOK;
+}
+
+/**
+ * @brief Gets the attributes read by the stat job started by <code>LLFS_stat_get</code>, and stores them in the
+ * stat cache. Called from the <code>SNI_callback</code> of the natives reading path attributes.
+ *
+ * @param[out] info the attributes of the path.
+ *
+ * @return <code>LLFS_OK</code> if <code>info</code> is filled, else <code>LLFS_NOK</code> if an exception is pending.
+ */
+static int32_t LLFS_stat_get_done(FS_stat_info_t* info){
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+	if(job == NULL){
+		return LLFS_NOK;
+	}
+	FS_stat_t* params = (FS_stat_t*)job->params;
+
+	*info = params->info;
+#if FS_STAT_CACHE_SIZE > 0
+	LLFS_stat_cache_insert(params);
+#endif
+	MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+	return LLFS_OK;
+}
+
 #ifdef __cplusplus
 	}
 #endif
@@ -0,0 +1,233 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ *
+ */
+
+/**
+ * @file
+ * @brief Read-ahead/write-behind logic of the LLFS file buffers, bounce buffers of the transfers and encoding of the
+ * append log records, independent of SNI.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "LLFS_impl.h"
+#include "esp_heap_caps.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+void LLFS_File_buffer_initialize(LLFS_File_buffer_t* buffer, int32_t file_id){
+	buffer->file_id = file_id;
+	buffer->state = LLFS_FILE_BUFFER_EMPTY;
+	buffer->position = 0;
+	buffer->count = 0;
+	buffer->job = NULL;
+	buffer->error_message = NULL;
+}
+
+int32_t LLFS_File_buffer_unread(const LLFS_File_buffer_t* buffer){
+	int32_t unread = 0;
+	if(buffer->state == LLFS_FILE_BUFFER_READ){
+		unread = buffer->count - buffer->position;
+	}
+	return unread;
+}
+
+LLFS_File_buffer_job_kind_t LLFS_File_buffer_read_data(LLFS_File_buffer_t* buffer, uint8_t* data, int32_t length, int32_t* read){
+	LLFS_File_buffer_job_kind_t kind;
+	int32_t unread = LLFS_File_buffer_unread(buffer);
+	if(unread > 0){
+		if(unread > length){
+			unread = length;
+		}
+		(void)memcpy(data, &buffer->data[buffer->position], (size_t)unread);
+		buffer->position += unread;
+		*read = unread;
+		kind = LLFS_FILE_BUFFER_JOB_NONE;
+	}
+	else if(buffer->state == LLFS_FILE_BUFFER_WRITE){
+		// Reading at the logical position: write the write-behind data first
+		kind = LLFS_FILE_BUFFER_JOB_FLUSH;
+	}
+	else if(length >= FS_FILE_BUFFER_SIZE){
+		kind = LLFS_FILE_BUFFER_JOB_DIRECT;
+	}
+	else {
+		kind = LLFS_FILE_BUFFER_JOB_REFILL;
+	}
+	return kind;
+}
+
+LLFS_File_buffer_job_kind_t LLFS_File_buffer_write_data(LLFS_File_buffer_t* buffer, const uint8_t* data, int32_t length){
+	LLFS_File_buffer_job_kind_t kind;
+	if(LLFS_File_buffer_unread(buffer) > 0){
+		// Writing at the logical position: drop the read-ahead data first
+		kind = LLFS_FILE_BUFFER_JOB_REWIND;
+	}
+	else if((buffer->state == LLFS_FILE_BUFFER_WRITE) && ((buffer->count + length) > FS_FILE_BUFFER_SIZE)){
+		kind = LLFS_FILE_BUFFER_JOB_FLUSH;
+	}
+	else if(length >= FS_FILE_BUFFER_SIZE){
+		kind = LLFS_FILE_BUFFER_JOB_DIRECT;
+	}
+	else {
+		if(buffer->state != LLFS_FILE_BUFFER_WRITE){
+			buffer->state = LLFS_FILE_BUFFER_WRITE;
+			buffer->position = 0;
+			buffer->count = 0;
+		}
+		(void)memcpy(&buffer->data[buffer->count], data, (size_t)length);
+		buffer->count += length;
+		kind = LLFS_FILE_BUFFER_JOB_NONE;
+	}
+	return kind;
+}
+
+MICROEJ_ASYNC_WORKER_action_t LLFS_File_buffer_set_job_params(LLFS_File_buffer_t* buffer, LLFS_File_buffer_job_kind_t kind, FS_worker_param_t* params){
+	MICROEJ_ASYNC_WORKER_action_t action;
+	if(kind == LLFS_FILE_BUFFER_JOB_REWIND){
+		params->seek.file_id = buffer->file_id;
+		params->seek.n = LLFS_File_buffer_unread(buffer);
+		action = LLFS_File_IMPL_rewind_action;
+	}
+	else {
+		params->write.file_id = buffer->file_id;
+		params->write.data = (uint8_t*)&buffer->data;
+		if(kind == LLFS_FILE_BUFFER_JOB_FLUSH){
+			params->write.length = buffer->count;
+			action = LLFS_File_IMPL_write_action;
+		}
+		else {
+			params->write.length = FS_FILE_BUFFER_SIZE;
+			action = LLFS_File_IMPL_read_action;
+		}
+	}
+	return action;
+}
+
+int32_t LLFS_File_buffer_job_done(LLFS_File_buffer_t* buffer, LLFS_File_buffer_job_kind_t kind, const FS_worker_param_t* params, int32_t* error_code, char** error_message){
+	int32_t result = LLFS_OK;
+	int32_t job_result;
+	if(kind == LLFS_FILE_BUFFER_JOB_REWIND){
+		job_result = params->seek.result;
+		*error_code = params->seek.error_code;
+		*error_message = params->seek.error_message;
+	}
+	else {
+		job_result = params->write.result;
+		*error_code = params->write.error_code;
+		*error_message = params->write.error_message;
+	}
+
+	int32_t flushed_count = buffer->count;
+	buffer->state = LLFS_FILE_BUFFER_EMPTY;
+	buffer->position = 0;
+	buffer->count = 0;
+
+	if(job_result == LLFS_NOK){
+		result = LLFS_NOK;
+	}
+	else if(kind == LLFS_FILE_BUFFER_JOB_FLUSH){
+		if(job_result != flushed_count){
+			// Partial write, the volume is full
+			*error_code = LLFS_NOK;
+			*error_message = "Buffered data partially written";
+			result = LLFS_NOK;
+		}
+	}
+	else if(kind == LLFS_FILE_BUFFER_JOB_REFILL){
+		if(job_result == LLFS_EOF){
+			result = LLFS_EOF;
+		}
+		else {
+			buffer->state = LLFS_FILE_BUFFER_READ;
+			buffer->count = job_result;
+		}
+	}
+	else {
+		// Rewind done
+	}
+	return result;
+}
+
+#if FS_LARGE_IO_BUFFER_SIZE > 0
+/**
+ * @brief Bounce buffer for large transfers, allocated on first use.
+ */
+static uint8_t* LLFS_large_io_buffer = NULL;
+
+/**
+ * @brief true while the bounce buffer for large transfers is used by a job.
+ */
+static bool LLFS_large_io_buffer_used = false;
+#endif
+
+uint8_t* LLFS_large_io_buffer_take(void){
+	uint8_t* buffer = NULL;
+#if FS_LARGE_IO_BUFFER_SIZE > 0
+	if(LLFS_large_io_buffer == NULL){
+		LLFS_large_io_buffer = (uint8_t*)heap_caps_malloc(FS_LARGE_IO_BUFFER_SIZE, FS_LARGE_IO_BUFFER_CAPS);
+		if(LLFS_large_io_buffer == NULL){
+			LLFS_DEBUG_TRACE("[%s:%u] large IO buffer allocation failed\n", __func__, __LINE__);
+		}
+	}
+	if((LLFS_large_io_buffer != NULL) && (LLFS_large_io_buffer_used == false)){
+		LLFS_large_io_buffer_used = true;
+		buffer = LLFS_large_io_buffer;
+	}
+#endif
+	return buffer;
+}
+
+void LLFS_large_io_buffer_release(uint8_t* data){
+#if FS_LARGE_IO_BUFFER_SIZE > 0
+	if((data != NULL) && (data == LLFS_large_io_buffer)){
+		LLFS_large_io_buffer_used = false;
+	}
+#else
+	(void)data;
+#endif
+}
+
+uint8_t* LLFS_bounce_buffer_select(uint8_t* job_buffer, uint32_t* buffer_length, int64_t length){
+	uint8_t* bounce_buffer = job_buffer;
+	if(length > (int64_t)*buffer_length){
+		uint8_t* large_io_buffer = LLFS_large_io_buffer_take();
+		if(large_io_buffer != NULL){
+			bounce_buffer = large_io_buffer;
+			*buffer_length = FS_LARGE_IO_BUFFER_SIZE;
+		} // else use the job IO buffer
+	}
+	return bounce_buffer;
+}
+
+int32_t LLFS_log_encode_record(uint8_t* record, uint32_t epoch, uint32_t sequence, const uint8_t* payload, int32_t length){
+	FS_log_record_header_t header;
+	header.magic = FS_LOG_RECORD_MAGIC;
+	header.length = (uint32_t)length;
+	header.sequence = sequence;
+	header.crc = LLFS_log_record_crc(epoch, &header, payload);
+
+	(void)memcpy(record, &header, sizeof(header));
+	(void)memcpy(&record[sizeof(header)], payload, (size_t)length);
+	return (int32_t)sizeof(header) + length;
+}
+
+int32_t LLFS_log_append_end_marker(uint8_t* records, int32_t length){
+	(void)memset(&records[length], 0, sizeof(FS_log_record_header_t));
+	return length + (int32_t)sizeof(FS_log_record_header_t);
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -0,0 +1,221 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ *
+ */
+
+/**
+ * @file
+ * @brief Code shared by the FatFs and LittleFS helpers: pool locking, directory entries and append log framing.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "microej_pool.h"
+#include "esp_random.h"
+#include "esp_rom_crc.h"
+#include "osal.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/** @brief mutex protecting the file and directory pools of the helper, used by several FS workers */
+static OSAL_mutex_handle_t gst_pool_mutex;
+
+int32_t LLFS_helper_initialize(void) {
+	// cppcheck-suppress misra-c2012-11.8 // String casts conform to OSAL_mutex_create function definitions.
+	OSAL_status_t res = OSAL_mutex_create((uint8_t*)"FS pool", &gst_pool_mutex);
+
+	LLFS_DEBUG_TRACE("[%s:%u] pool mutex creation (err %d)\n", __func__, __LINE__, res);
+	return (res == OSAL_OK) ? LLFS_OK : LLFS_NOK;
+}
+
+void LLFS_pool_lock(void) {
+	(void)OSAL_mutex_take(&gst_pool_mutex, OSAL_INFINITE_TIME);
+}
+
+void LLFS_pool_unlock(void) {
+	(void)OSAL_mutex_give(&gst_pool_mutex);
+}
+
+POOL_status_t LLFS_pool_reserve(POOL_ctx_t* pool_ctx, void** item) {
+	LLFS_pool_lock();
+	POOL_status_t res = POOL_reserve_f(pool_ctx, item);
+	LLFS_pool_unlock();
+	return res;
+}
+
+POOL_status_t LLFS_pool_free(POOL_ctx_t* pool_ctx, void* item) {
+	LLFS_pool_lock();
+	POOL_status_t res = POOL_free_f(pool_ctx, item);
+	LLFS_pool_unlock();
+	return res;
+}
+
+bool LLFS_glob_match(const char* pattern, const char* name) {
+	const char* star = NULL;
+	const char* star_name = NULL;
+
+	while (*name != '\0') {
+		if ((*pattern == '?') || ((*pattern != '*') && (tolower((unsigned char)*pattern) == tolower((unsigned char)*name)))) {
+			pattern++;
+			name++;
+		} else if (*pattern == '*') {
+			// Try first to match an empty sequence, backtrack here on mismatch
+			star = pattern;
+			pattern++;
+			star_name = name;
+		} else if (star != NULL) {
+			pattern = star + 1;
+			star_name++;
+			name = star_name;
+		} else {
+			return false;
+		}
+	}
+	while (*pattern == '*') {
+		pattern++;
+	}
+	return *pattern == '\0';
+}
+
+void LLFS_put_uint16(uint8_t* buffer, uint32_t value) {
+	buffer[0] = (uint8_t) value;
+	buffer[1] = (uint8_t) (value >> 8);
+}
+
+void LLFS_put_int64(uint8_t* buffer, int64_t value) {
+	for (int32_t i = 0; i < 8; i++) {
+		buffer[i] = (uint8_t) ((uint64_t) value >> (8 * i));
+	}
+}
+
+uint32_t LLFS_log_record_crc(uint32_t epoch, const FS_log_record_header_t* header, const uint8_t* payload) {
+	uint32_t crc = esp_rom_crc32_le(epoch, (const uint8_t*)&header->length, sizeof(header->length));
+	crc = esp_rom_crc32_le(crc, (const uint8_t*)&header->sequence, sizeof(header->sequence));
+	return esp_rom_crc32_le(crc, payload, header->length);
+}
+
+/**
+ * @brief Reads exactly <code>length</code> bytes at a position of a log file.
+ *
+ * @param[out] complete set to false on a short read.
+ *
+ * @return 0 on success, including a short read, else the error code of the file system.
+ */
+static int32_t LLFS_log_read_fully(void* file, const LLFS_log_file_ops_t* ops, int64_t position, void* data, uint32_t length, bool* complete) {
+	uint32_t count = 0;
+	int32_t res = ops->read_at(file, position, data, length, &count);
+	*complete = (res == 0) && (count == length);
+	return res;
+}
+
+int32_t LLFS_log_create(void* file, const LLFS_log_file_ops_t* ops, FS_log_open_t* param) {
+	int32_t res;
+	FS_log_file_header_t header = {
+		.magic = FS_LOG_FILE_MAGIC,
+		.version = FS_LOG_FILE_VERSION,
+		.epoch = esp_random(),
+		.reserved = 0
+	};
+	// Invalidate the first record, the preallocated space may contain any data
+	FS_log_record_header_t end_marker = {0};
+
+	if (param->capacity < (int64_t)(sizeof(FS_log_file_header_t) + sizeof(FS_log_record_header_t))) {
+		param->capacity = (int64_t)(sizeof(FS_log_file_header_t) + sizeof(FS_log_record_header_t));
+	}
+
+	res = ops->preallocate(file, param->capacity);
+	if (res == 0) {
+		res = ops->write_at(file, 0, &header, sizeof(header));
+	}
+	if (res == 0) {
+		res = ops->write_at(file, (int64_t)sizeof(header), &end_marker, sizeof(end_marker));
+	}
+	if (res == 0) {
+		res = ops->sync(file);
+	}
+
+	param->capacity = ops->size(file);
+	param->end = (int64_t)sizeof(FS_log_file_header_t);
+	param->sequence = 0;
+	param->epoch = header.epoch;
+	return res;
+}
+
+int32_t LLFS_log_recover(void* file, const LLFS_log_file_ops_t* ops, FS_log_open_t* param) {
+	FS_log_file_header_t file_header;
+	FS_log_record_header_t header;
+	int64_t capacity = ops->size(file);
+	int64_t position = (int64_t)sizeof(FS_log_file_header_t);
+	uint32_t sequence = 0;
+	bool valid = true;
+
+	int32_t res = LLFS_log_read_fully(file, ops, 0, &file_header, sizeof(file_header), &valid);
+	if ((res == 0) && (!valid || (file_header.magic != FS_LOG_FILE_MAGIC) || (file_header.version != FS_LOG_FILE_VERSION))) {
+		res = ops->not_a_log;
+	}
+
+	while ((res == 0) && valid && ((position + (int64_t)sizeof(header)) <= capacity)) {
+		res = LLFS_log_read_fully(file, ops, position, &header, sizeof(header), &valid);
+		if (res != 0) {
+			break;
+		}
+		valid = valid && (header.magic == FS_LOG_RECORD_MAGIC) && (header.sequence == sequence)
+				&& (header.length <= (FS_LOG_BUFFER_SIZE - sizeof(header))) && ((position + (int64_t)(sizeof(header) + header.length)) <= capacity);
+		if (valid) {
+			res = LLFS_log_read_fully(file, ops, position + (int64_t)sizeof(header), param->buffer, header.length, &valid);
+			valid = valid && (LLFS_log_record_crc(file_header.epoch, &header, param->buffer) == header.crc);
+		}
+		if (valid) {
+			position += (int64_t)(sizeof(header) + header.length);
+			sequence++;
+		} // else torn or stale record: the log ends here
+	}
+
+	param->capacity = capacity;
+	param->end = position;
+	param->sequence = sequence;
+	param->epoch = file_header.epoch;
+	return res;
+}
+
+int32_t LLFS_log_read_record(void* file, const LLFS_log_file_ops_t* ops, FS_log_read_t* param) {
+	FS_log_record_header_t header;
+	bool valid = false;
+
+	int32_t res = LLFS_log_read_fully(file, ops, param->position, &header, sizeof(header), &valid);
+	if (res != 0) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "append log read failed";
+		return res;
+	}
+
+	valid = valid && (header.magic == FS_LOG_RECORD_MAGIC) && (header.length <= (FS_LOG_BUFFER_SIZE - sizeof(header)));
+	if (valid) {
+		res = LLFS_log_read_fully(file, ops, param->position + (int64_t)sizeof(header), param->buffer, header.length, &valid);
+		valid = valid && (LLFS_log_record_crc(param->epoch, &header, param->buffer) == header.crc);
+	}
+	if (!valid) {
+		param->result = LLFS_NOK;
+		param->error_code = LLFS_NOK;
+		param->error_message = "corrupted append log record";
+	} else {
+		param->result = (int32_t)header.length;
+	}
+	return res;
+}
+
+#ifdef __cplusplus
+	}
+#endif
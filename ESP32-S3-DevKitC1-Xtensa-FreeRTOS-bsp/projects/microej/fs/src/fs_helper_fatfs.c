@@ -13,13 +13,19 @@
  * @version 2.1.0
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "fs_configuration.h"
+
+#ifndef FS_USE_LITTLEFS
+
 #include "ff.h"
 #include "fs_helper.h"
 #include "microej_async_worker.h"
 #include "microej_pool.h"
 #include "LLFS_File_impl.h"
+#include "LLFS_EXTENSION_impl.h"
 #include "diskio.h"
 
 #ifdef __cplusplus
@@ -40,7 +46,8 @@ static POOL_ctx_t gst_pool_file_ctx =
 	gpst_pool_file,
 	gpst_pool_file_item_status,
 	sizeof(FIL),
-	sizeof(gpst_pool_file)/sizeof(FIL)
+	sizeof(gpst_pool_file)/sizeof(FIL),
+	{0}
 };
 
 /** @brief private pool directory */
@@ -51,33 +58,218 @@ static POOL_ctx_t gst_pool_dir_ctx =
 	gpst_pool_dir,
 	gpst_pool_dir_item_status,
 	sizeof(FF_DIR),
-	sizeof(gpst_pool_dir)/sizeof(FF_DIR)
+	sizeof(gpst_pool_dir)/sizeof(FF_DIR),
+	{0}
 };
 
-void LLFS_IMPL_get_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+#if FF_LFN_BUF > LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH
+	#error "FatFs names may not fit in LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH."
+#endif
+
+#if (FS_WORKER_COUNT > 1) && (FF_FS_REENTRANT == 0)
+	#error "FatFs must be configured with FF_FS_REENTRANT when FS_WORKER_COUNT is greater than 1."
+#endif
 
-	FS_last_modified_t* param = (FS_last_modified_t*) job->params;
+/** @brief index of a file in the private file pool */
+#define LLFS_FILE_INDEX(fp) ((int32_t)((fp) - gpst_pool_file))
+
+// cppcheck-suppress misra-c2012-20.9 // Defined by FatFS.
+#if FF_USE_FASTSEEK
+/** @brief fast seek link maps of the files of the pool opened for reading */
+static DWORD gpst_pool_file_link_map[FS_MAX_NUMBER_OF_FILE_IN_POOL][FS_FASTSEEK_TABLE_SIZE];
+#endif
+
+#if FS_OPEN_CACHE_SIZE > 0
+/** @brief paths of the files of the pool opened for reading */
+static char gpst_pool_file_path[FS_MAX_NUMBER_OF_FILE_IN_POOL][FS_PATH_LENGTH];
+
+/** @brief generations of the open cache when the files of the pool have been opened for reading */
+static uint32_t gpst_pool_file_generation[FS_MAX_NUMBER_OF_FILE_IN_POOL];
+
+/** @brief files closed by LLFS and kept open for a next open of the same path, protected by LLFS_pool_lock */
+static FIL* gst_open_cache[FS_OPEN_CACHE_SIZE];
+
+/**
+ * @brief generation of the open cache, incremented when a modification of the file system starts and when it ends,
+ * protected by LLFS_pool_lock. A file opened before the end of a modification is never kept.
+ */
+static uint32_t gst_open_cache_generation;
+
+/** @brief number of modifications of the file system in progress, protected by LLFS_pool_lock */
+static int32_t gst_open_cache_modifications;
+
+/**
+ * @brief Gets the generation of the open cache, to be recorded before a file is opened for reading.
+ */
+static uint32_t LLFS_open_cache_get_generation(void) {
+	LLFS_pool_lock();
+	uint32_t generation = gst_open_cache_generation;
+	LLFS_pool_unlock();
+	return generation;
+}
+
+/**
+ * @brief Closes the given files taken out of the open cache.
+ *
+ * @return true if at least one file has been closed.
+ */
+static bool LLFS_open_cache_close(FIL* const* files, int32_t count) {
+	bool closed = false;
+	for (int32_t i = 0; i < count; i++) {
+		if (files[i] != NULL) {
+			(void)f_close(files[i]);
+			LLFS_pool_free(&gst_pool_file_ctx, (void*)files[i]);
+			closed = true;
+		}
+	}
+	return closed;
+}
+
+/**
+ * @brief Takes the kept file opened on the given path out of the open cache. Kept files of an older generation
+ * are dropped.
+ *
+ * @return the file rewound at its beginning, NULL if no file is kept for this path.
+ */
+static FIL* LLFS_open_cache_take(const uint8_t* path) {
+	FIL* stale_files[FS_OPEN_CACHE_SIZE] = {NULL};
+	FIL* fp = NULL;
+	LLFS_pool_lock();
+	for (int32_t i = 0; i < FS_OPEN_CACHE_SIZE; i++) {
+		FIL* kept = gst_open_cache[i];
+		if ((kept != NULL) && (gpst_pool_file_generation[LLFS_FILE_INDEX(kept)] != gst_open_cache_generation)) {
+			stale_files[i] = kept;
+			gst_open_cache[i] = NULL;
+		} else if ((fp == NULL) && (kept != NULL) && (strcmp(gpst_pool_file_path[LLFS_FILE_INDEX(kept)], (const char*)path) == 0)) {
+			fp = kept;
+			gst_open_cache[i] = NULL;
+		} else {
+			// Kept file of another path
+		}
+	}
+	LLFS_pool_unlock();
+
+	(void)LLFS_open_cache_close(stale_files, FS_OPEN_CACHE_SIZE);
+	if ((fp != NULL) && (f_lseek(fp, 0) != FR_OK)) {
+		// The volume has been remounted or the file is in error: drop it
+		(void)LLFS_open_cache_close(&fp, 1);
+		fp = NULL;
+	}
+	return fp;
+}
+
+/**
+ * @brief Keeps a file opened for reading in the open cache instead of closing it. The oldest kept file is
+ * closed if the cache is full.
+ * The file is not kept while a modification of the file system is in progress, or if it has been opened before the
+ * end of a modification: it could hold a FatFs lock the modification needs or refer to a renamed or deleted file.
+ *
+ * @return true if the file is kept, false if it must be closed by the caller.
+ */
+static bool LLFS_open_cache_put(FIL* fp) {
+	if (((fp->flag & FA_WRITE) != 0U) || (fp->err != 0U) || (gpst_pool_file_path[LLFS_FILE_INDEX(fp)][0] == '\0')) {
+		return false;
+	}
+
+	LLFS_pool_lock();
+	if ((gst_open_cache_modifications > 0) || (gpst_pool_file_generation[LLFS_FILE_INDEX(fp)] != gst_open_cache_generation)) {
+		LLFS_pool_unlock();
+		return false;
+	}
+	FIL* evicted = gst_open_cache[0];
+	for (int32_t i = 1; i < FS_OPEN_CACHE_SIZE; i++) {
+		gst_open_cache[i - 1] = gst_open_cache[i];
+	}
+	gst_open_cache[FS_OPEN_CACHE_SIZE - 1] = fp;
+	LLFS_pool_unlock();
+
+	(void)LLFS_open_cache_close(&evicted, 1);
+	return true;
+}
+
+/**
+ * @brief Closes all the files kept in the open cache, to release the file slots and FatFs locks they use.
+ *
+ * @return true if at least one file has been closed.
+ */
+static bool LLFS_open_cache_flush(void) {
+	FIL* files[FS_OPEN_CACHE_SIZE];
+
+	LLFS_pool_lock();
+	(void)memcpy(files, gst_open_cache, sizeof(files));
+	(void)memset(gst_open_cache, 0, sizeof(gst_open_cache));
+	LLFS_pool_unlock();
+
+	return LLFS_open_cache_close(files, FS_OPEN_CACHE_SIZE);
+}
+
+/**
+ * @brief Starts a modification of the file system: closes all the kept files and refuses new ones until
+ * LLFS_open_cache_end_modification() is called, so a kept file never holds a FatFs lock that would make the
+ * modification fail. Another FS worker may close a file at any time.
+ */
+static void LLFS_open_cache_begin_modification(void) {
+	FIL* files[FS_OPEN_CACHE_SIZE];
+
+	LLFS_pool_lock();
+	gst_open_cache_modifications++;
+	gst_open_cache_generation++;
+	(void)memcpy(files, gst_open_cache, sizeof(files));
+	(void)memset(gst_open_cache, 0, sizeof(gst_open_cache));
+	LLFS_pool_unlock();
+
+	(void)LLFS_open_cache_close(files, FS_OPEN_CACHE_SIZE);
+}
+
+/**
+ * @brief Ends a modification of the file system. The files opened before are never kept, so a kept file never
+ * outlives a change of its path.
+ */
+static void LLFS_open_cache_end_modification(void) {
+	LLFS_pool_lock();
+	gst_open_cache_modifications--;
+	gst_open_cache_generation++;
+	LLFS_pool_unlock();
+}
+#else
+#define LLFS_open_cache_flush() (false)
+#define LLFS_open_cache_begin_modification() ((void)0)
+#define LLFS_open_cache_end_modification() ((void)0)
+#endif // FS_OPEN_CACHE_SIZE > 0
+
+void LLFS_IMPL_stat_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_stat_t* param = (FS_stat_t*) job->params;
 	FILINFO fno = {0};
 	FRESULT res = FR_OK;
 
 	uint8_t* path = (uint8_t*)&param->path;
-	LLFS_date_t* out_date = &param->date;
+	FS_stat_info_t* info = &param->info;
+	LLFS_date_t* out_date = &info->last_modified;
+
+	(void)memset(info, 0, sizeof(FS_stat_info_t));
 
 	res = f_stat((TCHAR*)path, &fno);
 	if (FR_OK != res) {
-		param->result = LLFS_NOK;
+		info->result = LLFS_NOK;
+		info->no_file = (res == FR_NO_FILE);
 	} else {
+		info->length = (int64_t) fno.fsize;
+		info->directory = ((fno.fattrib & AM_DIR) != 0x0);
+		info->hidden = ((fno.fattrib & AM_HID) != 0x0);
+		info->read_only = ((fno.fattrib & AM_RDO) != 0x0);
 		out_date->second = (int32_t) ((fno.ftime & 31) * 2);
 		out_date->minute = (int32_t) ((fno.ftime >> 5) & 63);
 		out_date->hour = (int32_t) (fno.ftime >> 11);
 		out_date->day = (int32_t) (fno.fdate & 31);
 		out_date->month = (int32_t) ((fno.fdate >> 5) & 15);
 		out_date->year = (int32_t) ((fno.fdate >> 9) + 1980);
-		param->result = LLFS_OK;
+		info->result = LLFS_OK;
 	}
+	param->result = info->result;
 
-	LLFS_DEBUG_TRACE("[%s:%u] timestamp get : %ld/%02ld/%02ld, %02ld:%02ld:%02ld\n (err %d)\n", __func__, __LINE__,
-			out_date->year, out_date->month, out_date->day, out_date->hour, out_date->minute, out_date->second, res);
+	LLFS_DEBUG_TRACE("[%s:%u] stat %s : length %lld, attributes 0x%x (err %d)\n", __func__, __LINE__,
+			path, info->length, fno.fattrib, res);
 }
 
 void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job) {
@@ -88,6 +280,7 @@ void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	uint8_t* path = (uint8_t*)&param->path;
 
+	LLFS_open_cache_begin_modification();
 	res = f_stat((TCHAR*)path, &fno);
 	if ((res != FR_OK) || (fno.fattrib & AM_DIR)) {
 		/* If an error occurs or the file is directory returns error */
@@ -100,6 +293,7 @@ void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 			param->result = LLFS_OK;
 		}
 	}
+	LLFS_open_cache_end_modification();
 
 	LLFS_DEBUG_TRACE("[%s:%u] readonly set on %s (err %d)\n", __func__, __LINE__, path, res);
 }
@@ -112,7 +306,9 @@ void LLFS_IMPL_create_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	uint8_t* path = (uint8_t*)&param->path;
 
+	LLFS_open_cache_begin_modification();
 	res = f_open(&fp, (TCHAR*)path, FA_CREATE_NEW);
+	LLFS_open_cache_end_modification();
 	if (res == FR_OK) {
 		res = f_close(&fp);
 		if (res == FR_OK) {
@@ -144,15 +340,19 @@ void LLFS_IMPL_open_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	uint8_t* path = (uint8_t*)&param->path;
 
-	pool_res = POOL_reserve_f(&gst_pool_dir_ctx, (void**)&pdir);
+	pool_res = LLFS_pool_reserve(&gst_pool_dir_ctx, (void**)&pdir);
 	if (pool_res != POOL_NO_ERROR) {
 		param->result = LLFS_NOK;
 	} else {
 		res = f_opendir(pdir, (TCHAR*)path);
+		if ((res == FR_TOO_MANY_OPEN_FILES) && LLFS_open_cache_flush()) {
+			// The kept files were using all the FatFs locks
+			res = f_opendir(pdir, (TCHAR*)path);
+		}
 		if (res == FR_OK) {
 			param->result = (int32_t)pdir;
 		} else {
-			POOL_free_f(&gst_pool_dir_ctx, (void*)pdir);
+			LLFS_pool_free(&gst_pool_dir_ctx, (void*)pdir);
 			param->result = LLFS_NOK;
 		}
 	}
@@ -180,79 +380,113 @@ void LLFS_IMPL_read_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	LLFS_DEBUG_TRACE("[%s:%u] read dir %ld return %s (err %d)\n", __func__, __LINE__, directory_ID, path, res);
 }
 
-void LLFS_IMPL_close_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+void LLFS_IMPL_read_directory_entries_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
-	FS_close_directory_t* param = (FS_close_directory_t*) job->params;
+	FS_read_directory_entries_t* param = (FS_read_directory_entries_t*) job->params;
+	FILINFO fno = {0};
 	FRESULT res = FR_OK;
 
 	int32_t directory_ID = param->directory_ID;
+	const char* pattern = (const char*)param->pattern;
+	int32_t capacity = param->length;
+	int32_t used = 0;
+	int32_t count = 0;
+	bool end = false;
+
+	// Read an entry only if the largest one fits: a read entry can not be put back in the directory
+	while (!end && ((capacity - used) >= LLFS_DIRECTORY_ENTRY_MAX_LENGTH)) {
+		res = f_readdir((FF_DIR*)directory_ID, &fno);
+		if ((res != FR_OK) || (fno.fname[0] == 0)) {
+			end = true;
+		} else if ((pattern[0] == '\0') || LLFS_glob_match(pattern, (char*)fno.fname)) {
+			uint8_t* entry = &param->buffer[used];
+			uint32_t name_length = strlen((char*)fno.fname);
+			uint8_t flags = LLFS_STAT_FLAG_EXISTS;
+
+			if ((fno.fattrib & AM_DIR) != 0x0) {
+				flags |= LLFS_STAT_FLAG_DIRECTORY;
+			}
+			if ((fno.fattrib & AM_HID) != 0x0) {
+				flags |= LLFS_STAT_FLAG_HIDDEN;
+			}
+			if ((fno.fattrib & AM_RDO) != 0x0) {
+				flags |= LLFS_STAT_FLAG_READ_ONLY;
+			}
 
-	res = f_closedir((FF_DIR*)directory_ID);
-	if (res != FR_OK) {
+			LLFS_put_int64(&entry[LLFS_DIRECTORY_ENTRY_LENGTH_OFFSET], (int64_t) fno.fsize);
+			LLFS_put_uint16(&entry[LLFS_DIRECTORY_ENTRY_YEAR_OFFSET], (uint32_t) ((fno.fdate >> 9) + 1980));
+			entry[LLFS_DIRECTORY_ENTRY_MONTH_OFFSET] = (uint8_t) ((fno.fdate >> 5) & 15);
+			entry[LLFS_DIRECTORY_ENTRY_DAY_OFFSET] = (uint8_t) (fno.fdate & 31);
+			entry[LLFS_DIRECTORY_ENTRY_HOUR_OFFSET] = (uint8_t) (fno.ftime >> 11);
+			entry[LLFS_DIRECTORY_ENTRY_MINUTE_OFFSET] = (uint8_t) ((fno.ftime >> 5) & 63);
+			entry[LLFS_DIRECTORY_ENTRY_SECOND_OFFSET] = (uint8_t) ((fno.ftime & 31) * 2);
+			entry[LLFS_DIRECTORY_ENTRY_FLAGS_OFFSET] = flags;
+			LLFS_put_uint16(&entry[LLFS_DIRECTORY_ENTRY_NAME_LENGTH_OFFSET], name_length);
+			// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+			memcpy(&entry[LLFS_DIRECTORY_ENTRY_NAME_OFFSET], fno.fname, name_length);
+
+			used += LLFS_DIRECTORY_ENTRY_NAME_OFFSET + (int32_t) name_length;
+			count++;
+		} else {
+			// Entry filtered out
+		}
+	}
+
+	if ((res != FR_OK) && (count == 0)) {
+		// Entries read before the error are returned, the error is reported by the next call
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "error while reading directory";
+	} else if (!end && (count == 0)) {
 		param->result = LLFS_NOK;
+		param->error_code = LLFS_NOK;
+		param->error_message = "buffer too small";
 	} else {
-		param->result = LLFS_OK;
+		param->result = count;
 	}
+	param->length = used;
 
-	// cppcheck-suppress misra-c2012-11.6 // directory_ID type is received from SNI.
-	POOL_free_f(&gst_pool_dir_ctx, (void*)directory_ID);
-
-	LLFS_DEBUG_TRACE("[%s:%u] close dir %ld (err %d)\n", __func__, __LINE__, directory_ID, res);
+	LLFS_DEBUG_TRACE("[%s:%u] read dir %ld entries %ld (%ld bytes) (err %d)\n", __func__, __LINE__, directory_ID, count, used, res);
 }
 
-void LLFS_IMPL_rename_to_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+void LLFS_IMPL_close_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
-	FS_rename_to_t* param = (FS_rename_to_t*) job->params;
+	FS_close_directory_t* param = (FS_close_directory_t*) job->params;
 	FRESULT res = FR_OK;
 
-	uint8_t* path = (uint8_t*)&param->path;
-	uint8_t* new_path = (uint8_t*)&param->new_path;
+	int32_t directory_ID = param->directory_ID;
 
-	res = f_rename((TCHAR*)path, (TCHAR*)new_path);
+	res = f_closedir((FF_DIR*)directory_ID);
 	if (res != FR_OK) {
 		param->result = LLFS_NOK;
 	} else {
 		param->result = LLFS_OK;
 	}
 
-	LLFS_DEBUG_TRACE("[%s:%u] rename : old name %s, new name %s (err %d)\n", __func__, __LINE__, path, new_path, res);
-}
-
-void LLFS_IMPL_get_length_action(MICROEJ_ASYNC_WORKER_job_t* job) {
-
-	FS_path64_operation_t* param = (FS_path64_operation_t*) job->params;
-	FILINFO fno = {0};
-	FRESULT res = FR_OK;
-
-	uint8_t* path = (uint8_t*)&param->path;
-
-	res = f_stat((TCHAR*)path, &fno);
-	if (res == FR_OK) {
-		param->result = fno.fsize;
-	} else if (res == FR_NO_FILE) {
-		param->result = 0;
-	} else {
-		param->result = LLFS_NOK;
-	}
+	// cppcheck-suppress misra-c2012-11.6 // directory_ID type is received from SNI.
+	LLFS_pool_free(&gst_pool_dir_ctx, (void*)directory_ID);
 
-	LLFS_DEBUG_TRACE("[%s:%u] length of %s : %lld bytes (err %d)\n", __func__, __LINE__, path, param->result, res);
+	LLFS_DEBUG_TRACE("[%s:%u] close dir %ld (err %d)\n", __func__, __LINE__, directory_ID, res);
 }
 
-void LLFS_IMPL_exist_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+void LLFS_IMPL_rename_to_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
-	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
+	FS_rename_to_t* param = (FS_rename_to_t*) job->params;
 	FRESULT res = FR_OK;
 
 	uint8_t* path = (uint8_t*)&param->path;
+	uint8_t* new_path = (uint8_t*)&param->new_path;
 
-	res = f_stat((TCHAR*)path, NULL);
+	LLFS_open_cache_begin_modification();
+	res = f_rename((TCHAR*)path, (TCHAR*)new_path);
+	LLFS_open_cache_end_modification();
 	if (res != FR_OK) {
 		param->result = LLFS_NOK;
 	} else {
 		param->result = LLFS_OK;
 	}
 
-	LLFS_DEBUG_TRACE("[%s:%u] exist file %s (err %d)\n", __func__, __LINE__, path, res);
+	LLFS_DEBUG_TRACE("[%s:%u] rename : old name %s, new name %s (err %d)\n", __func__, __LINE__, path, new_path, res);
 }
 
 void LLFS_IMPL_get_space_size_action(MICROEJ_ASYNC_WORKER_job_t* job) {
@@ -317,72 +551,6 @@ void LLFS_IMPL_make_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	LLFS_DEBUG_TRACE("[%s:%u] create dir %s (err %d)\n", __func__, __LINE__, path, res);
 }
 
-void LLFS_IMPL_is_hidden_action(MICROEJ_ASYNC_WORKER_job_t* job) {
-
-	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
-	FILINFO fno = {0};
-	FRESULT res = FR_OK;
-
-	uint8_t* path = (uint8_t*)&param->path;
-
-	res = f_stat((TCHAR*)path, &fno);
-	if (FR_OK != res) {
-		param->result = LLFS_NOK;
-	} else {
-		if ((fno.fattrib & AM_HID) != 0x0) {
-			param->result = LLFS_OK;
-		} else {
-			param->result = LLFS_NOK;
-		}
-	}
-
-	LLFS_DEBUG_TRACE("[%s:%u] %s is hidden ? (err %d)\n", __func__, __LINE__, path, res);
-}
-
-void LLFS_IMPL_is_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
-
-	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
-	FILINFO fno = {0};
-	FRESULT res = FR_OK;
-
-	uint8_t* path = (uint8_t*)&param->path;
-
-	res = f_stat((TCHAR*)path, &fno);
-	if (FR_OK != res) {
-		param->result = LLFS_NOK;
-	} else {
-		if ((fno.fattrib & AM_DIR) != 0x0) {
-			param->result = LLFS_OK;
-		} else {
-			param->result = LLFS_NOK;
-		}
-	}
-
-	LLFS_DEBUG_TRACE("[%s:%u] %s is directory ? (err %d)\n", __func__, __LINE__, path, res);
-}
-
-void LLFS_IMPL_is_file_action(MICROEJ_ASYNC_WORKER_job_t* job) {
-
-	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
-	FILINFO fno = {0};
-	FRESULT res = FR_OK;
-
-	uint8_t* path = (uint8_t*)&param->path;
-
-	res = f_stat((TCHAR*)path, &fno);
-	if (FR_OK != res) {
-		param->result = LLFS_NOK;
-	} else {
-		if ((fno.fattrib & AM_DIR) != 0x0) {
-			param->result = LLFS_NOK;
-		} else {
-			param->result = LLFS_OK;
-		}
-	}
-
-	LLFS_DEBUG_TRACE("[%s:%u] %s is file ? (err %d)\n", __func__, __LINE__, path, res);
-}
-
 void LLFS_IMPL_set_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	FS_last_modified_t* param = (FS_last_modified_t*) job->params;
@@ -413,7 +581,9 @@ void LLFS_IMPL_delete_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	uint8_t* path = (uint8_t*)&param->path;
 
+	LLFS_open_cache_begin_modification();
 	res = f_unlink((TCHAR*)path);
+	LLFS_open_cache_end_modification();
 	if (FR_OK != res) {
 		param->result = LLFS_NOK;
 	} else {
@@ -423,43 +593,6 @@ void LLFS_IMPL_delete_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	LLFS_DEBUG_TRACE("[%s:%u] delete %s (err %d)\n", __func__, __LINE__, path, res);
 }
 
-void LLFS_IMPL_is_accessible_action(MICROEJ_ASYNC_WORKER_job_t* job) {
-
-	FS_is_accessible_t* param = (FS_is_accessible_t*) job->params;
-	FILINFO fno = {0};
-	FRESULT res = FR_OK;
-
-	uint8_t* path = (uint8_t*)&param->path;
-	int32_t checked_access = param->access;
-
-	res = f_stat((TCHAR*)path, &fno);
-	if (res != FR_OK) {
-		param->result = LLFS_NOK;
-	} else {
-		switch (checked_access) {
-		case LLFS_ACCESS_WRITE:
-			if ((fno.fattrib & AM_RDO) != 0x0) {
-				param->result = LLFS_NOK;
-			} else {
-				param->result = LLFS_OK;
-			}
-			break;
-		/* FatFs doesn't support other permissions so return always ok */
-		case LLFS_ACCESS_READ:
-			param->result = LLFS_OK;
-			break;
-		case LLFS_ACCESS_EXECUTE:
-			param->result = LLFS_OK;
-			break;
-		default:
-			param->result = LLFS_NOK;
-			break;
-		}
-	}
-
-	LLFS_DEBUG_TRACE("[%s:%u] %s is accessible ? access %ld (err %d)\n", __func__, __LINE__, path, checked_access, res);
-}
-
 void LLFS_IMPL_set_permission_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	FS_set_permission_t* param = (FS_set_permission_t*) job->params;
@@ -471,6 +604,7 @@ void LLFS_IMPL_set_permission_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	int32_t access = param->access;
 	int32_t enable = param->enable;
 
+	LLFS_open_cache_begin_modification();
 	res = f_stat((TCHAR*)path, &fno);
 	if ((res != FR_OK) || (fno.fattrib & AM_DIR)) {
 		/* If an error occurs or the file is directory returns error */
@@ -499,6 +633,7 @@ void LLFS_IMPL_set_permission_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 			break;
 		}
 	}
+	LLFS_open_cache_end_modification();
 
 	LLFS_DEBUG_TRACE("[%s:%u] set permission %ld for %s as %ld (err %d)\n", __func__, __LINE__, access, path, enable, res);
 }
@@ -536,23 +671,77 @@ void LLFS_File_IMPL_open_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 		return;
 	}
 
-	pool_res = POOL_reserve_f(&gst_pool_file_ctx, (void**)&fp);
+#if FS_OPEN_CACHE_SIZE > 0
+	// Generation of the open cache before the path is resolved, the file is kept on close only if no modification
+	// has been done in between
+	uint32_t generation = 0;
+	if (mode == LLFS_FILE_MODE_READ) {
+		// Reuse a file kept open on this path: the path is not resolved again
+		fp = LLFS_open_cache_take(path);
+		if (fp != NULL) {
+			param->result = (int32_t)fp;
+			LLFS_DEBUG_TRACE("[%s:%u] open file %s in %c mode from cache, fd %ld\n", __func__, __LINE__, path, mode, param->result);
+			return;
+		}
+		generation = LLFS_open_cache_get_generation();
+	}
+#endif
+	if (mode != LLFS_FILE_MODE_READ) {
+		LLFS_open_cache_begin_modification();
+	}
+
+	pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	if ((pool_res != POOL_NO_ERROR) && LLFS_open_cache_flush()) {
+		// The kept files were using all the file slots
+		pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	}
 	if (pool_res != POOL_NO_ERROR) {
 		param->result = LLFS_NOK;
 		param->error_code = pool_res;
 		param->error_message = "POOL_reserve_f failed";
 	} else {
 		res = f_open(fp, (TCHAR*)path, b_internal_mode);
+		if ((res == FR_TOO_MANY_OPEN_FILES) && LLFS_open_cache_flush()) {
+			// The kept files were using all the FatFs locks
+			res = f_open(fp, (TCHAR*)path, b_internal_mode);
+		}
 		if (res != FR_OK) {
-			POOL_free_f(&gst_pool_file_ctx, (void*)fp);
+			LLFS_pool_free(&gst_pool_file_ctx, (void*)fp);
 			param->result = LLFS_NOK;
 			param->error_code = res;
 			param->error_message = "f_open failed";
 		} else {
 			/* An f_lseek() following f_open() is no longer needed if FA_OPEN_APPEND mode, since FatFs R0.12a */
 			param->result = (int32_t)fp;
+// cppcheck-suppress misra-c2012-20.9 // Defined by FatFS.
+#if FF_USE_FASTSEEK
+			if (mode == LLFS_FILE_MODE_READ) {
+				// Map the clusters of the file so seeks do not follow the FAT chain. The file can not be extended
+				// in fast seek mode, so this is only done for files opened for reading.
+				DWORD* link_map = gpst_pool_file_link_map[LLFS_FILE_INDEX(fp)];
+				link_map[0] = FS_FASTSEEK_TABLE_SIZE;
+				fp->cltbl = link_map;
+				if (f_lseek(fp, CREATE_LINKMAP) != FR_OK) {
+					// Too many fragments
+					fp->cltbl = NULL;
+				}
+			}
+#endif
+#if FS_OPEN_CACHE_SIZE > 0
+			char* fp_path = gpst_pool_file_path[LLFS_FILE_INDEX(fp)];
+			if (mode == LLFS_FILE_MODE_READ) {
+				(void)strncpy(fp_path, (const char*)path, FS_PATH_LENGTH - 1);
+				fp_path[FS_PATH_LENGTH - 1] = '\0';
+				gpst_pool_file_generation[LLFS_FILE_INDEX(fp)] = generation;
+			} else {
+				fp_path[0] = '\0';
+			}
+#endif
 		}
 	}
+	if (mode != LLFS_FILE_MODE_READ) {
+		LLFS_open_cache_end_modification();
+	}
 
 	LLFS_DEBUG_TRACE("[%s:%u] open file %s in %c mode, fd %ld (err %d)\n", __func__, __LINE__, path, mode, param->result, res);
 }
@@ -605,6 +794,120 @@ void LLFS_File_IMPL_read_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	LLFS_DEBUG_TRACE("[%s:%u] read %ld bytes from file %ld (err %d)\n", __func__, __LINE__, param->result, (int32_t)fd, res);
 }
 
+/**
+ * @brief Reads or writes the extents of a positional operation, then restores the file pointer.
+ *
+ * @param[in] param the parameters of the operation.
+ * @param[in] write true to write the extents, false to read them.
+ */
+static void LLFS_File_transfer_extents(FS_extents_t* param, bool write) {
+	FRESULT res = FR_OK;
+	FIL* fd = (FIL*)param->file_id;
+	FSIZE_t file_pointer = f_tell(fd);
+	int32_t transferred = 0;
+	bool end = false;
+
+	for (int32_t i = 0; (i < param->count) && (end == false); i++) {
+		UINT length = (UINT)param->lengths[i];
+		UINT count = 0;
+
+		if (length > (UINT)(param->length - transferred)) {
+			// Job buffer full
+			length = (UINT)(param->length - transferred);
+			end = true;
+		}
+
+		res = f_lseek(fd, (FSIZE_t)param->positions[i]);
+		if (res == FR_OK) {
+			if (write) {
+				res = f_write(fd, (void*)&param->data[transferred], length, &count);
+			} else {
+				res = f_read(fd, (void*)&param->data[transferred], length, &count);
+			}
+		}
+		transferred += (int32_t)count;
+
+		if ((res != FR_OK) || (count < length)) {
+			// Error, end of file or volume full
+			end = true;
+		}
+	}
+
+	FRESULT seek_res = f_lseek(fd, file_pointer);
+	if (res == FR_OK) {
+		res = seek_res;
+	}
+
+	if (res != FR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = write ? "positional f_write failed" : "positional f_read failed";
+	} else if ((write == false) && (transferred == 0) && (param->count > 0) && (param->lengths[0] > 0)) {
+		param->result = LLFS_EOF;
+	} else {
+		param->result = transferred;
+	}
+}
+
+void LLFS_File_IMPL_read_extents_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_extents_t* param = (FS_extents_t*) job->params;
+
+	LLFS_File_transfer_extents(param, false);
+
+	LLFS_DEBUG_TRACE("[%s:%u] read %ld extents from file %ld: %ld bytes\n", __func__, __LINE__, param->count, param->file_id, param->result);
+}
+
+void LLFS_File_IMPL_write_extents_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_extents_t* param = (FS_extents_t*) job->params;
+
+	LLFS_File_transfer_extents(param, true);
+
+	LLFS_DEBUG_TRACE("[%s:%u] write %ld extents to file %ld: %ld bytes\n", __func__, __LINE__, param->count, param->file_id, param->result);
+}
+
+void LLFS_File_IMPL_read_range_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_read_range_t* param = (FS_read_range_t*) job->params;
+	FIL* fd = (FIL*)param->file_id;
+	FSIZE_t file_pointer = f_tell(fd);
+	int64_t remaining = param->length;
+	UINT count = 0;
+
+	param->consumer_result = 0;
+	FRESULT res = f_lseek(fd, (FSIZE_t)param->position);
+	while ((res == FR_OK) && (remaining > 0) && (param->consumer_result == 0)) {
+		UINT length = (remaining < (int64_t)FS_IO_BUFFER_SIZE) ? (UINT)remaining : (UINT)FS_IO_BUFFER_SIZE;
+		res = f_read(fd, (void*)param->buffer, length, &count);
+		if ((res == FR_OK) && (count > (UINT)0)) {
+			param->consumer_result = param->consumer(param->context, param->buffer, (int32_t)count);
+			remaining -= (int64_t)count;
+		}
+		if (count < length) {
+			// End of file
+			break;
+		}
+	}
+
+	FRESULT seek_res = f_lseek(fd, file_pointer);
+	if (res == FR_OK) {
+		res = seek_res;
+	}
+
+	if ((res != FR_OK) || (param->consumer_result != 0)) {
+		param->result = LLFS_NOK;
+		param->error_code = (res != FR_OK) ? (int32_t)res : param->consumer_result;
+		param->error_message = (res != FR_OK) ? "range f_read failed" : "range consumer failed";
+	} else if (remaining > 0) {
+		param->result = LLFS_EOF;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] read range of file %ld: %ld bytes left (status %ld err %d)\n", __func__, __LINE__, param->file_id, (int32_t)remaining, param->result, res);
+}
+
 void LLFS_File_IMPL_close_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	FS_close_t* param = (FS_close_t*) job->params;
@@ -612,6 +915,15 @@ void LLFS_File_IMPL_close_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 
 	FIL* fd = (FIL*)param->file_id;
 
+#if FS_OPEN_CACHE_SIZE > 0
+	if (LLFS_open_cache_put(fd)) {
+		// Nothing to write back for a file opened for reading
+		param->result = LLFS_OK;
+		LLFS_DEBUG_TRACE("[%s:%u] close file %ld kept in cache\n", __func__, __LINE__, (int32_t)fd);
+		return;
+	}
+#endif
+
 	res = f_close(fd);
 	if (res != FR_OK) {
 		param->result = LLFS_NOK;
@@ -621,7 +933,7 @@ void LLFS_File_IMPL_close_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 		param->result = LLFS_OK;
 	}
 
-	POOL_free_f(&gst_pool_file_ctx, (void*)fd);
+	LLFS_pool_free(&gst_pool_file_ctx, (void*)fd);
 
 	LLFS_DEBUG_TRACE("[%s:%u] close file %ld (status %ld err %d)\n", __func__, __LINE__, (int32_t)fd, param->result, res);
 }
@@ -770,6 +1082,172 @@ void LLFS_File_IMPL_flush_action(MICROEJ_ASYNC_WORKER_job_t* job) {
 	LLFS_DEBUG_TRACE("[%s:%u] flush file %ld (status %ld err %d)\n", __func__, __LINE__, (int32_t)fd, param->result, res);
 }
 
+void LLFS_File_IMPL_rewind_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_seek_t* param = (FS_seek_t*) job->params;
+	FRESULT res = FR_INVALID_PARAMETER;
+
+	FIL* fd = (FIL*)param->file_id;
+	FSIZE_t pos = f_tell(fd);
+
+	if ((param->n >= 0) && ((QWORD)param->n <= (QWORD)pos)) {
+		res = f_lseek(fd, pos - (FSIZE_t)param->n);
+	}
+	if (res != FR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "f_lseek failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] rewind %ld bytes on %ld (status %ld err %d)\n", __func__, __LINE__, (int32_t)param->n, (int32_t)fd, param->result, res);
+}
+
+/**
+ * @brief Reads an append log file at a position.
+ */
+static int32_t LLFS_log_read_at(void* file, int64_t position, void* data, uint32_t length, uint32_t* count) {
+	FIL* fp = (FIL*)file;
+	UINT read = 0;
+	FRESULT res = f_lseek(fp, (FSIZE_t)position);
+	if (res == FR_OK) {
+		res = f_read(fp, data, (UINT)length, &read);
+	}
+	*count = (uint32_t)read;
+	return (int32_t)res;
+}
+
+/**
+ * @brief Writes an append log file at a position, a short write on a full volume is <code>FR_DENIED</code>.
+ */
+static int32_t LLFS_log_write_at(void* file, int64_t position, const void* data, uint32_t length) {
+	FIL* fp = (FIL*)file;
+	UINT count = 0;
+	FRESULT res = f_lseek(fp, (FSIZE_t)position);
+	if (res == FR_OK) {
+		res = f_write(fp, data, (UINT)length, &count);
+	}
+	if ((res == FR_OK) && (count != (UINT)length)) {
+		res = FR_DENIED;
+	}
+	return (int32_t)res;
+}
+
+/**
+ * @brief Allocates the clusters of an empty append log file.
+ */
+static int32_t LLFS_log_preallocate(void* file, int64_t capacity) {
+#if FF_USE_EXPAND == 1
+	// Contiguous allocation: the clusters are allocated once and the FAT is never updated again
+	return (int32_t)f_expand((FIL*)file, (FSIZE_t)capacity, 1);
+#else
+	// Seeking after the end of a file opened for writing allocates the clusters
+	return (int32_t)f_lseek((FIL*)file, (FSIZE_t)capacity);
+#endif
+}
+
+static int32_t LLFS_log_sync(void* file) {
+	return (int32_t)f_sync((FIL*)file);
+}
+
+static int64_t LLFS_log_size(void* file) {
+	return (int64_t)f_size((FIL*)file);
+}
+
+/** @brief FatFs operations on the append log files */
+static const LLFS_log_file_ops_t gst_log_file_ops = {
+	.read_at = LLFS_log_read_at,
+	.write_at = LLFS_log_write_at,
+	.preallocate = LLFS_log_preallocate,
+	.sync = LLFS_log_sync,
+	.size = LLFS_log_size,
+	.not_a_log = (int32_t)FR_INT_ERR
+};
+
+void LLFS_LOG_IMPL_open_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_open_t* param = (FS_log_open_t*) job->params;
+	FIL * fp;
+	FRESULT res = FR_OK;
+	POOL_status_t pool_res;
+
+	uint8_t* path = (uint8_t*)&param->path;
+
+	LLFS_open_cache_begin_modification();
+
+	pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	if (pool_res != POOL_NO_ERROR) {
+		param->result = LLFS_NOK;
+		param->error_code = pool_res;
+		param->error_message = "POOL_reserve_f failed";
+	} else {
+#if FS_OPEN_CACHE_SIZE > 0
+		gpst_pool_file_path[LLFS_FILE_INDEX(fp)][0] = '\0';
+#endif
+		res = f_open(fp, (TCHAR*)path, FA_READ | FA_WRITE | FA_OPEN_ALWAYS);
+		if (res == FR_OK) {
+			if (f_size(fp) == 0) {
+				res = (FRESULT)LLFS_log_create(fp, &gst_log_file_ops, param);
+			} else {
+				res = (FRESULT)LLFS_log_recover(fp, &gst_log_file_ops, param);
+			}
+			if (res != FR_OK) {
+				(void)f_close(fp);
+			}
+		}
+		if (res != FR_OK) {
+			LLFS_pool_free(&gst_pool_file_ctx, (void*)fp);
+			param->result = LLFS_NOK;
+			param->error_code = res;
+			param->error_message = (res == FR_INT_ERR) ? "not an append log" : "append log open failed";
+		} else {
+			param->result = (int32_t)fp;
+		}
+	}
+	LLFS_open_cache_end_modification();
+
+	LLFS_DEBUG_TRACE("[%s:%u] open log %s fd %ld, end %lld, %lu records (err %d)\n", __func__, __LINE__, path, param->result, param->end, param->sequence, res);
+}
+
+void LLFS_LOG_IMPL_write_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_write_t* param = (FS_log_write_t*) job->params;
+	FRESULT res = FR_OK;
+
+	FIL* fd = (FIL*)param->log_id;
+
+	if (param->length > 0) {
+		res = (FRESULT)LLFS_log_write_at(fd, param->position, param->data, (uint32_t)param->length);
+	}
+	if ((res == FR_OK) && param->sync) {
+		res = f_sync(fd);
+	}
+
+	if (res != FR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "append log write failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] write log %ld: %ld bytes at %lld, sync %d (err %d)\n", __func__, __LINE__, param->log_id, param->length, param->position, param->sync, res);
+}
+
+void LLFS_LOG_IMPL_read_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_read_t* param = (FS_log_read_t*) job->params;
+
+	FIL* fd = (FIL*)param->log_id;
+
+	int32_t res = LLFS_log_read_record(fd, &gst_log_file_ops, param);
+
+	LLFS_DEBUG_TRACE("[%s:%u] read log %ld at %lld: %ld (err %ld)\n", __func__, __LINE__, param->log_id, param->position, param->result, res);
+}
+
 #ifdef __cplusplus
 }
 #endif
+
+#endif // FS_USE_LITTLEFS
@@ -0,0 +1,1113 @@
+/*
+ * C
+ *
+ * Copyright 2020-2023 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ *
+ */
+
+/**
+ * @file
+ * @brief LittleFS helper for LLFS.
+ * @author MicroEJ Developer Team
+ * @version 2.1.0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "fs_configuration.h"
+
+#ifdef FS_USE_LITTLEFS
+
+#include "lfs.h"
+#include "fs_helper.h"
+#include "microej_async_worker.h"
+#include "microej_pool.h"
+#include "LLFS_File_impl.h"
+#include "LLFS_EXTENSION_impl.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/** @brief LittleFS instance mounted by LLFS_ESP32_init_littlefs(). */
+extern lfs_t LLFS_ESP32_lfs;
+
+/** @brief LittleFS has no file attributes: the last modification date is stored in this user attribute. */
+#define LLFS_LITTLEFS_ATTR_MTIME (0x74)
+
+/** @brief LittleFS has no file attributes: the read only flag is stored in this user attribute. */
+#define LLFS_LITTLEFS_ATTR_READ_ONLY (0x72)
+
+/** @brief An open file. */
+typedef struct {
+	lfs_file_t file; /*!< LittleFS file, must be the first field. */
+	struct lfs_file_config config; /*!< Configuration attaching the last modification date to the file. */
+	struct lfs_attr attr; /*!< Last modification date attribute, written when the file is synced. */
+	uint32_t mtime; /*!< Last modification date in seconds since the Epoch. */
+} LLFS_littlefs_file_t;
+
+/** @brief An open directory. */
+typedef struct {
+	lfs_dir_t dir; /*!< LittleFS directory, must be the first field. */
+	char path[FS_PATH_LENGTH]; /*!< Path of the directory, to read the attributes of its entries. */
+} LLFS_littlefs_dir_t;
+
+/** @ brief private pool file */
+static LLFS_littlefs_file_t gpst_pool_file[FS_LITTLEFS_MAX_OPEN_FILES];
+static POOL_item_status_t gpst_pool_file_item_status[FS_LITTLEFS_MAX_OPEN_FILES];
+static POOL_ctx_t gst_pool_file_ctx =
+{
+	gpst_pool_file,
+	gpst_pool_file_item_status,
+	sizeof(LLFS_littlefs_file_t),
+	sizeof(gpst_pool_file)/sizeof(LLFS_littlefs_file_t),
+	{0}
+};
+
+/** @brief private pool directory */
+static LLFS_littlefs_dir_t gpst_pool_dir[FS_LITTLEFS_MAX_OPEN_FILES];
+static POOL_item_status_t gpst_pool_dir_item_status[FS_LITTLEFS_MAX_OPEN_FILES];
+static POOL_ctx_t gst_pool_dir_ctx =
+{
+	gpst_pool_dir,
+	gpst_pool_dir_item_status,
+	sizeof(LLFS_littlefs_dir_t),
+	sizeof(gpst_pool_dir)/sizeof(LLFS_littlefs_dir_t),
+	{0}
+};
+
+#if LFS_NAME_MAX > LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH
+	#error "LittleFS names may not fit in LLFS_DIRECTORY_ENTRY_MAX_NAME_LENGTH."
+#endif
+
+#if (FS_WORKER_COUNT > 1) && !defined(LFS_THREADSAFE)
+	#error "LittleFS must be configured with LFS_THREADSAFE when FS_WORKER_COUNT is greater than 1."
+#endif
+
+/**
+ * @brief Converts a date in seconds since the Epoch to a LLFS date, in local time.
+ */
+static void LLFS_littlefs_to_date(uint32_t mtime, LLFS_date_t* date) {
+	time_t t = (time_t)mtime;
+	struct tm tm;
+
+	(void)localtime_r(&t, &tm);
+	date->year = (int32_t) (tm.tm_year + 1900);
+	date->month = (int32_t) (tm.tm_mon + 1);
+	date->day = (int32_t) tm.tm_mday;
+	date->hour = (int32_t) tm.tm_hour;
+	date->minute = (int32_t) tm.tm_min;
+	date->second = (int32_t) tm.tm_sec;
+}
+
+/**
+ * @brief Returns the last modification date of a path, 0 if it has never been set.
+ */
+static uint32_t LLFS_littlefs_get_mtime(const char* path) {
+	uint32_t mtime = 0;
+	lfs_ssize_t size = lfs_getattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_MTIME, &mtime, sizeof(mtime));
+	return (size == (lfs_ssize_t)sizeof(mtime)) ? mtime : 0U;
+}
+
+/**
+ * @brief Returns true if a path has been set read only.
+ */
+static bool LLFS_littlefs_is_read_only(const char* path) {
+	uint8_t read_only = 0;
+	lfs_ssize_t size = lfs_getattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_READ_ONLY, &read_only, sizeof(read_only));
+	return (size == (lfs_ssize_t)sizeof(read_only)) && (read_only != 0U);
+}
+
+/**
+ * @brief Returns true if a name is hidden: as on POSIX file systems, names starting with a dot are hidden.
+ */
+static bool LLFS_littlefs_is_hidden(const char* name) {
+	const char* last_separator = strrchr(name, '/');
+	const char* base_name = (last_separator != NULL) ? (last_separator + 1) : name;
+	return base_name[0] == '.';
+}
+
+/**
+ * @brief Marks an open file as modified now. The date is written with the file when it is synced or closed.
+ */
+static void LLFS_littlefs_touch(LLFS_littlefs_file_t* fd) {
+	fd->mtime = (uint32_t)time(NULL);
+}
+
+void LLFS_IMPL_stat_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_stat_t* param = (FS_stat_t*) job->params;
+	struct lfs_info fno = {0};
+	int res = LFS_ERR_OK;
+
+	const char* path = (const char*)&param->path;
+	FS_stat_info_t* info = &param->info;
+
+	(void)memset(info, 0, sizeof(FS_stat_info_t));
+
+	res = lfs_stat(&LLFS_ESP32_lfs, path, &fno);
+	if (res != LFS_ERR_OK) {
+		info->result = LLFS_NOK;
+		info->no_file = (res == LFS_ERR_NOENT);
+	} else {
+		info->length = (fno.type == LFS_TYPE_REG) ? (int64_t) fno.size : 0;
+		info->directory = (fno.type == LFS_TYPE_DIR);
+		info->hidden = LLFS_littlefs_is_hidden(path);
+		info->read_only = LLFS_littlefs_is_read_only(path);
+		LLFS_littlefs_to_date(LLFS_littlefs_get_mtime(path), &info->last_modified);
+		info->result = LLFS_OK;
+	}
+	param->result = info->result;
+
+	LLFS_DEBUG_TRACE("[%s:%u] stat %s : length %lld, type %d (err %d)\n", __func__, __LINE__,
+			path, info->length, fno.type, res);
+}
+
+void LLFS_IMPL_set_read_only_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
+	struct lfs_info fno = {0};
+	int res = LFS_ERR_OK;
+	uint8_t read_only = 1;
+
+	const char* path = (const char*)&param->path;
+
+	res = lfs_stat(&LLFS_ESP32_lfs, path, &fno);
+	if ((res != LFS_ERR_OK) || (fno.type == LFS_TYPE_DIR)) {
+		/* If an error occurs or the file is directory returns error */
+		param->result = LLFS_NOK;
+	} else {
+		res = lfs_setattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_READ_ONLY, &read_only, sizeof(read_only));
+		if (res != LFS_ERR_OK) {
+			param->result = LLFS_NOK;
+		} else {
+			param->result = LLFS_OK;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] readonly set on %s (err %d)\n", __func__, __LINE__, path, res);
+}
+
+void LLFS_IMPL_create_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_create_t* param = (FS_create_t*) job->params;
+	LLFS_littlefs_file_t* fp;
+	int res = LFS_ERR_OK;
+	POOL_status_t pool_res;
+
+	const char* path = (const char*)&param->path;
+
+	pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	if (pool_res != POOL_NO_ERROR) {
+		param->result = LLFS_NOT_CREATED;
+		param->error_code = pool_res;
+		param->error_message = "POOL_reserve_f failed";
+		return;
+	}
+
+	res = lfs_file_open(&LLFS_ESP32_lfs, &fp->file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_EXCL);
+	if (res == LFS_ERR_OK) {
+		res = lfs_file_close(&LLFS_ESP32_lfs, &fp->file);
+		if (res == LFS_ERR_OK) {
+			uint32_t mtime = (uint32_t)time(NULL);
+			(void)lfs_setattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_MTIME, &mtime, sizeof(mtime));
+			param->result = LLFS_OK;
+		} else {
+			param->result = LLFS_NOK;
+			param->error_code = res;
+			param->error_message = "lfs_file_close failed";
+		}
+	} else if (res == LFS_ERR_EXIST) {
+		param->result = LLFS_NOT_CREATED;
+		param->error_code = res;
+		param->error_message = "file exists";
+	} else {
+		param->result = LLFS_NOT_CREATED;
+		param->error_code = res;
+		param->error_message = "lfs_file_open failed";
+	}
+	LLFS_pool_free(&gst_pool_file_ctx, (void*)fp);
+
+	LLFS_DEBUG_TRACE("[%s:%u] create file %s (err %d)\n", __func__, __LINE__, path, res);
+}
+
+void LLFS_IMPL_open_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
+	LLFS_littlefs_dir_t* pdir;
+	int res = LFS_ERR_OK;
+	POOL_status_t pool_res;
+
+	const char* path = (const char*)&param->path;
+
+	pool_res = LLFS_pool_reserve(&gst_pool_dir_ctx, (void**)&pdir);
+	if (pool_res != POOL_NO_ERROR) {
+		param->result = LLFS_NOK;
+	} else {
+		res = lfs_dir_open(&LLFS_ESP32_lfs, &pdir->dir, path);
+		if (res == LFS_ERR_OK) {
+			// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+			strncpy(pdir->path, path, sizeof(pdir->path) - 1U);
+			pdir->path[sizeof(pdir->path) - 1U] = '\0';
+			param->result = (int32_t)pdir;
+		} else {
+			LLFS_pool_free(&gst_pool_dir_ctx, (void*)pdir);
+			param->result = LLFS_NOK;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] open dir %s fd %ld (err %d)\n", __func__, __LINE__, path, param->result, res);
+}
+
+/**
+ * @brief Reads the next entry of a directory, skipping the "." and ".." entries.
+ *
+ * @return a positive value if an entry has been read, 0 at the end of the directory, else a negative error code.
+ */
+static int LLFS_littlefs_dir_read(LLFS_littlefs_dir_t* pdir, struct lfs_info* fno) {
+	int res;
+	do {
+		res = lfs_dir_read(&LLFS_ESP32_lfs, &pdir->dir, fno);
+	} while ((res > 0) && ((strcmp(fno->name, ".") == 0) || (strcmp(fno->name, "..") == 0)));
+	return res;
+}
+
+void LLFS_IMPL_read_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_read_directory_t* param = (FS_read_directory_t*) job->params;
+	struct lfs_info fno = {0};
+	int res = LFS_ERR_OK;
+
+	int32_t directory_ID = param->directory_ID;
+	uint8_t* path = (uint8_t*)&param->path;
+	res = LLFS_littlefs_dir_read((LLFS_littlefs_dir_t*)directory_ID, &fno);
+	if (res <= 0) {
+		param->result = LLFS_NOK;
+	} else {
+		// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+		strcpy((char*)path, fno.name);
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] read dir %ld return %s (err %d)\n", __func__, __LINE__, directory_ID, path, res);
+}
+
+void LLFS_IMPL_read_directory_entries_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_read_directory_entries_t* param = (FS_read_directory_entries_t*) job->params;
+	struct lfs_info fno = {0};
+	int res = LFS_ERR_OK;
+	char entry_path[FS_PATH_LENGTH + LFS_NAME_MAX + 1];
+
+	int32_t directory_ID = param->directory_ID;
+	LLFS_littlefs_dir_t* pdir = (LLFS_littlefs_dir_t*)directory_ID;
+	const char* pattern = (const char*)param->pattern;
+	int32_t capacity = param->length;
+	int32_t used = 0;
+	int32_t count = 0;
+	bool end = false;
+
+	// Read an entry only if the largest one fits: a read entry can not be put back in the directory
+	while (!end && ((capacity - used) >= LLFS_DIRECTORY_ENTRY_MAX_LENGTH)) {
+		res = LLFS_littlefs_dir_read(pdir, &fno);
+		if (res <= 0) {
+			end = true;
+		} else if ((pattern[0] == '\0') || LLFS_glob_match(pattern, fno.name)) {
+			uint8_t* entry = &param->buffer[used];
+			uint32_t name_length = strlen(fno.name);
+			uint8_t flags = LLFS_STAT_FLAG_EXISTS;
+			LLFS_date_t date;
+
+			(void)snprintf(entry_path, sizeof(entry_path), "%s/%s", pdir->path, fno.name);
+			if (fno.type == LFS_TYPE_DIR) {
+				flags |= LLFS_STAT_FLAG_DIRECTORY;
+			}
+			if (LLFS_littlefs_is_hidden(fno.name)) {
+				flags |= LLFS_STAT_FLAG_HIDDEN;
+			}
+			if (LLFS_littlefs_is_read_only(entry_path)) {
+				flags |= LLFS_STAT_FLAG_READ_ONLY;
+			}
+			LLFS_littlefs_to_date(LLFS_littlefs_get_mtime(entry_path), &date);
+
+			LLFS_put_int64(&entry[LLFS_DIRECTORY_ENTRY_LENGTH_OFFSET], (fno.type == LFS_TYPE_REG) ? (int64_t) fno.size : 0);
+			LLFS_put_uint16(&entry[LLFS_DIRECTORY_ENTRY_YEAR_OFFSET], (uint32_t) date.year);
+			entry[LLFS_DIRECTORY_ENTRY_MONTH_OFFSET] = (uint8_t) date.month;
+			entry[LLFS_DIRECTORY_ENTRY_DAY_OFFSET] = (uint8_t) date.day;
+			entry[LLFS_DIRECTORY_ENTRY_HOUR_OFFSET] = (uint8_t) date.hour;
+			entry[LLFS_DIRECTORY_ENTRY_MINUTE_OFFSET] = (uint8_t) date.minute;
+			entry[LLFS_DIRECTORY_ENTRY_SECOND_OFFSET] = (uint8_t) date.second;
+			entry[LLFS_DIRECTORY_ENTRY_FLAGS_OFFSET] = flags;
+			LLFS_put_uint16(&entry[LLFS_DIRECTORY_ENTRY_NAME_LENGTH_OFFSET], name_length);
+			// cppcheck-suppress misra-c2012-17.7 // Return value does not require checking.
+			memcpy(&entry[LLFS_DIRECTORY_ENTRY_NAME_OFFSET], fno.name, name_length);
+
+			used += LLFS_DIRECTORY_ENTRY_NAME_OFFSET + (int32_t) name_length;
+			count++;
+		} else {
+			// Entry filtered out
+		}
+	}
+
+	if ((res < 0) && (count == 0)) {
+		// Entries read before the error are returned, the error is reported by the next call
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "error while reading directory";
+	} else if (!end && (count == 0)) {
+		param->result = LLFS_NOK;
+		param->error_code = LLFS_NOK;
+		param->error_message = "buffer too small";
+	} else {
+		param->result = count;
+	}
+	param->length = used;
+
+	LLFS_DEBUG_TRACE("[%s:%u] read dir %ld entries %ld (%ld bytes) (err %d)\n", __func__, __LINE__, directory_ID, count, used, res);
+}
+
+void LLFS_IMPL_close_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_close_directory_t* param = (FS_close_directory_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	int32_t directory_ID = param->directory_ID;
+
+	res = lfs_dir_close(&LLFS_ESP32_lfs, &((LLFS_littlefs_dir_t*)directory_ID)->dir);
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	// cppcheck-suppress misra-c2012-11.6 // directory_ID type is received from SNI.
+	LLFS_pool_free(&gst_pool_dir_ctx, (void*)directory_ID);
+
+	LLFS_DEBUG_TRACE("[%s:%u] close dir %ld (err %d)\n", __func__, __LINE__, directory_ID, res);
+}
+
+void LLFS_IMPL_rename_to_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_rename_to_t* param = (FS_rename_to_t*) job->params;
+	struct lfs_info fno = {0};
+	int res = LFS_ERR_OK;
+
+	const char* path = (const char*)&param->path;
+	const char* new_path = (const char*)&param->new_path;
+
+	// lfs_rename() replaces an existing destination, FatFs and the Java specification do not
+	if (lfs_stat(&LLFS_ESP32_lfs, new_path, &fno) == LFS_ERR_OK) {
+		res = LFS_ERR_EXIST;
+	} else {
+		res = lfs_rename(&LLFS_ESP32_lfs, path, new_path);
+	}
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] rename : old name %s, new name %s (err %d)\n", __func__, __LINE__, path, new_path, res);
+}
+
+void LLFS_IMPL_get_space_size_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_get_space_size* param = (FS_get_space_size*) job->params;
+	const struct lfs_config* cfg = LLFS_ESP32_lfs.cfg;
+
+	uint8_t* path = (uint8_t*)&param->path;
+	int32_t space_type = param->space_type;
+
+	lfs_ssize_t used_blocks = lfs_fs_size(&LLFS_ESP32_lfs);
+	if (used_blocks < 0) {
+		param->result = LLFS_NOK;
+	} else {
+		switch (space_type) {
+		case LLFS_FREE_SPACE:
+		case LLFS_USABLE_SPACE:
+			param->result = ((int64_t)cfg->block_count - used_blocks) * cfg->block_size;
+			break;
+		case LLFS_TOTAL_SPACE:
+			param->result = (int64_t)cfg->block_count * cfg->block_size;
+			break;
+		default:
+			param->result = LLFS_NOK;
+			break;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] get space type %ld on %s : %lld bytes (used blocks %ld)\n", __func__, __LINE__, space_type, path, param->result, used_blocks);
+	(void)path;
+}
+
+void LLFS_IMPL_make_directory_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	const char* path = (const char*)&param->path;
+
+	res = lfs_mkdir(&LLFS_ESP32_lfs, path);
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+	} else {
+		uint32_t mtime = (uint32_t)time(NULL);
+		(void)lfs_setattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_MTIME, &mtime, sizeof(mtime));
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] create dir %s (err %d)\n", __func__, __LINE__, path, res);
+}
+
+void LLFS_IMPL_set_last_modified_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_last_modified_t* param = (FS_last_modified_t*) job->params;
+	int res = LFS_ERR_OK;
+	struct tm tm = {0};
+
+	const char* path = (const char*)&param->path;
+	LLFS_date_t* new_date = &param->date;
+
+	tm.tm_year = new_date->year - 1900;
+	tm.tm_mon = new_date->month - 1;
+	tm.tm_mday = new_date->day;
+	tm.tm_hour = new_date->hour;
+	tm.tm_min = new_date->minute;
+	tm.tm_sec = new_date->second;
+	tm.tm_isdst = -1;
+	uint32_t mtime = (uint32_t)mktime(&tm);
+
+	res = lfs_setattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_MTIME, &mtime, sizeof(mtime));
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] timestamp set : %ld/%02ld/%02ld, %02ld:%02ld:%02ld\n (err %d)\n", __func__, __LINE__,
+			new_date->year, new_date->month, new_date->day, new_date->hour, new_date->minute, new_date->second, res);
+}
+
+void LLFS_IMPL_delete_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_path_operation_t* param = (FS_path_operation_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	const char* path = (const char*)&param->path;
+
+	if (LLFS_littlefs_is_read_only(path)) {
+		/* Read only files can not be deleted, as with FatFs */
+		res = LFS_ERR_INVAL;
+	} else {
+		res = lfs_remove(&LLFS_ESP32_lfs, path);
+	}
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] delete %s (err %d)\n", __func__, __LINE__, path, res);
+}
+
+void LLFS_IMPL_set_permission_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_set_permission_t* param = (FS_set_permission_t*) job->params;
+	struct lfs_info fno = {0};
+	uint8_t read_only;
+	int res = LFS_ERR_OK;
+
+	const char* path = (const char*)&param->path;
+	int32_t access = param->access;
+	int32_t enable = param->enable;
+
+	res = lfs_stat(&LLFS_ESP32_lfs, path, &fno);
+	if ((res != LFS_ERR_OK) || (fno.type == LFS_TYPE_DIR)) {
+		/* If an error occurs or the file is directory returns error */
+		param->result = LLFS_NOK;
+	} else {
+		read_only = enable ? 0U : 1U;
+		switch (access) {
+		case LLFS_ACCESS_WRITE:
+			/* LittleFS doesn't identify the owner */
+			res = lfs_setattr(&LLFS_ESP32_lfs, path, LLFS_LITTLEFS_ATTR_READ_ONLY, &read_only, sizeof(read_only));
+			if (res == LFS_ERR_OK) {
+				param->result = LLFS_OK;
+			} else {
+				param->result = LLFS_NOK;
+			}
+			break;
+		/* LittleFS doesn't support other permissions so return always ok */
+		case LLFS_ACCESS_READ:
+			param->result = LLFS_OK;
+			break;
+		case LLFS_ACCESS_EXECUTE:
+			param->result = LLFS_OK;
+			break;
+		default:
+			param->result = LLFS_NOK;
+			break;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] set permission %ld for %s as %ld (err %d)\n", __func__, __LINE__, access, path, enable, res);
+}
+
+/**
+ * @brief Opens a file of the pool with its last modification date attribute.
+ *
+ * @return the result of <code>lfs_file_opencfg</code>.
+ */
+static int LLFS_littlefs_file_open(LLFS_littlefs_file_t* fp, const char* path, int flags) {
+	(void)memset(&fp->config, 0, sizeof(fp->config));
+	fp->mtime = 0;
+	fp->attr.type = LLFS_LITTLEFS_ATTR_MTIME;
+	fp->attr.buffer = &fp->mtime;
+	fp->attr.size = sizeof(fp->mtime);
+	fp->config.attrs = &fp->attr;
+	fp->config.attr_count = 1;
+	if (((flags & LFS_O_WRONLY) == LFS_O_WRONLY) && LLFS_littlefs_is_read_only(path)) {
+		/* Read only files can not be opened for writing, as with FatFs */
+		return LFS_ERR_INVAL;
+	}
+	int res = lfs_file_opencfg(&LLFS_ESP32_lfs, &fp->file, path, flags, &fp->config);
+	if ((res == LFS_ERR_OK) && (((flags & LFS_O_TRUNC) == LFS_O_TRUNC) || (((flags & LFS_O_CREAT) == LFS_O_CREAT) && (fp->mtime == 0U)))) {
+		// Truncated or created file
+		LLFS_littlefs_touch(fp);
+	}
+	return res;
+}
+
+void LLFS_File_IMPL_open_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_open_t* param = (FS_open_t*) job->params;
+	LLFS_littlefs_file_t* fp;
+	int res = LFS_ERR_OK;
+	POOL_status_t pool_res;
+	int flags;
+
+	const char* path = (const char*)&param->path;
+	uint8_t mode = param->mode;
+
+	/* Map input mode to LittleFS mode */
+	switch(mode) {
+	case LLFS_FILE_MODE_APPEND:
+		flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND;
+		break;
+	case LLFS_FILE_MODE_READ:
+		flags = LFS_O_RDONLY;
+		break;
+	case LLFS_FILE_MODE_WRITE:
+		flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
+		break;
+	case LLFS_FILE_MODE_READ_WRITE:
+	case LLFS_FILE_MODE_READ_WRITE_DATA_SYNC:
+	case LLFS_FILE_MODE_READ_WRITE_SYNC:
+		flags = LFS_O_RDWR | LFS_O_CREAT;
+		break;
+	default:
+		param->error_code = mode;
+		param->error_message = "Invalid opening mode";
+		return;
+	}
+
+	pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	if (pool_res != POOL_NO_ERROR) {
+		param->result = LLFS_NOK;
+		param->error_code = pool_res;
+		param->error_message = "POOL_reserve_f failed";
+	} else {
+		res = LLFS_littlefs_file_open(fp, path, flags);
+		if (res != LFS_ERR_OK) {
+			LLFS_pool_free(&gst_pool_file_ctx, (void*)fp);
+			param->result = LLFS_NOK;
+			param->error_code = res;
+			param->error_message = "lfs_file_open failed";
+		} else {
+			param->result = (int32_t)fp;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] open file %s in %c mode, fd %ld (err %d)\n", __func__, __LINE__, path, mode, param->result, res);
+}
+
+void LLFS_File_IMPL_write_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_write_read_t* param = (FS_write_read_t*) job->params;
+	lfs_ssize_t res;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	uint8_t* data = param->data;
+	int32_t length = param->length;
+
+	LLFS_littlefs_touch(fd);
+	res = lfs_file_write(&LLFS_ESP32_lfs, &fd->file, (void*)data, (lfs_size_t)length);
+	if (res < 0) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "lfs_file_write failed";
+	} else {
+		param->result = (int32_t)res;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] written %ld bytes to file %ld (err %ld)\n", __func__, __LINE__, param->result, (int32_t)fd, res);
+}
+
+void LLFS_File_IMPL_read_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_write_read_t* param = (FS_write_read_t*) job->params;
+	lfs_ssize_t res;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	uint8_t* data = param->data;
+	int32_t length = param->length;
+
+	res = lfs_file_read(&LLFS_ESP32_lfs, &fd->file, (void*)data, (lfs_size_t)length);
+	if (res < 0) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "lfs_file_read failed";
+	} else {
+		if (res == 0) {
+			param->result = LLFS_EOF;
+		} else {
+			param->result = (int32_t)res;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] read %ld bytes from file %ld (err %ld)\n", __func__, __LINE__, param->result, (int32_t)fd, res);
+}
+
+/**
+ * @brief Reads or writes the extents of a positional operation, then restores the file pointer.
+ *
+ * @param[in] param the parameters of the operation.
+ * @param[in] write true to write the extents, false to read them.
+ */
+static void LLFS_File_transfer_extents(FS_extents_t* param, bool write) {
+	lfs_ssize_t res = LFS_ERR_OK;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	lfs_soff_t file_pointer = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+	int32_t transferred = 0;
+	bool end = false;
+
+	if (write) {
+		LLFS_littlefs_touch(fd);
+	}
+
+	for (int32_t i = 0; (i < param->count) && (end == false); i++) {
+		lfs_size_t length = (lfs_size_t)param->lengths[i];
+		lfs_ssize_t count = 0;
+
+		if (length > (lfs_size_t)(param->length - transferred)) {
+			// Job buffer full
+			length = (lfs_size_t)(param->length - transferred);
+			end = true;
+		}
+
+		res = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, (lfs_soff_t)param->positions[i], LFS_SEEK_SET);
+		if (res >= 0) {
+			if (write) {
+				res = lfs_file_write(&LLFS_ESP32_lfs, &fd->file, (void*)&param->data[transferred], length);
+			} else {
+				res = lfs_file_read(&LLFS_ESP32_lfs, &fd->file, (void*)&param->data[transferred], length);
+			}
+			count = (res > 0) ? res : 0;
+		}
+		transferred += (int32_t)count;
+
+		if ((res < 0) || ((lfs_size_t)count < length)) {
+			// Error, end of file or volume full
+			end = true;
+		}
+	}
+
+	lfs_soff_t seek_res = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, file_pointer, LFS_SEEK_SET);
+	if ((res >= 0) && (seek_res < 0)) {
+		res = seek_res;
+	}
+
+	if (res < 0) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = write ? "positional lfs_file_write failed" : "positional lfs_file_read failed";
+	} else if ((write == false) && (transferred == 0) && (param->count > 0) && (param->lengths[0] > 0)) {
+		param->result = LLFS_EOF;
+	} else {
+		param->result = transferred;
+	}
+}
+
+void LLFS_File_IMPL_read_extents_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_extents_t* param = (FS_extents_t*) job->params;
+
+	LLFS_File_transfer_extents(param, false);
+
+	LLFS_DEBUG_TRACE("[%s:%u] read %ld extents from file %ld: %ld bytes\n", __func__, __LINE__, param->count, param->file_id, param->result);
+}
+
+void LLFS_File_IMPL_write_extents_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_extents_t* param = (FS_extents_t*) job->params;
+
+	LLFS_File_transfer_extents(param, true);
+
+	LLFS_DEBUG_TRACE("[%s:%u] write %ld extents to file %ld: %ld bytes\n", __func__, __LINE__, param->count, param->file_id, param->result);
+}
+
+void LLFS_File_IMPL_read_range_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_read_range_t* param = (FS_read_range_t*) job->params;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	lfs_soff_t file_pointer = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+	int64_t remaining = param->length;
+
+	param->consumer_result = 0;
+	lfs_ssize_t res = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, (lfs_soff_t)param->position, LFS_SEEK_SET);
+	while ((res >= 0) && (remaining > 0) && (param->consumer_result == 0)) {
+		lfs_size_t length = (remaining < (int64_t)FS_IO_BUFFER_SIZE) ? (lfs_size_t)remaining : (lfs_size_t)FS_IO_BUFFER_SIZE;
+		res = lfs_file_read(&LLFS_ESP32_lfs, &fd->file, (void*)param->buffer, length);
+		if (res > 0) {
+			param->consumer_result = param->consumer(param->context, param->buffer, (int32_t)res);
+			remaining -= (int64_t)res;
+		}
+		if ((res >= 0) && ((lfs_size_t)res < length)) {
+			// End of file
+			break;
+		}
+	}
+
+	lfs_soff_t seek_res = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, file_pointer, LFS_SEEK_SET);
+	if ((res >= 0) && (seek_res < 0)) {
+		res = seek_res;
+	}
+
+	if ((res < 0) || (param->consumer_result != 0)) {
+		param->result = LLFS_NOK;
+		param->error_code = (res < 0) ? (int32_t)res : param->consumer_result;
+		param->error_message = (res < 0) ? "range lfs_file_read failed" : "range consumer failed";
+	} else if (remaining > 0) {
+		param->result = LLFS_EOF;
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] read range of file %ld: %ld bytes left (status %ld err %ld)\n", __func__, __LINE__, param->file_id, (int32_t)remaining, param->result, res);
+}
+
+void LLFS_File_IMPL_close_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_close_t* param = (FS_close_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+
+	res = lfs_file_close(&LLFS_ESP32_lfs, &fd->file);
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "lfs_file_close failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_pool_free(&gst_pool_file_ctx, (void*)fd);
+
+	LLFS_DEBUG_TRACE("[%s:%u] close file %ld (status %ld err %d)\n", __func__, __LINE__, (int32_t)fd, param->result, res);
+}
+
+void LLFS_File_IMPL_seek_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_seek_t* param = (FS_seek_t*) job->params;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	lfs_soff_t pos = 0;
+
+	if ((param->n < 0) || (param->n > (int64_t)LFS_FILE_MAX)) {
+		param->result = LLFS_NOK;
+		param->error_code = LFS_ERR_INVAL;
+		param->error_message = "lfs_file_seek failed";
+	} else {
+		pos = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, (lfs_soff_t)param->n, LFS_SEEK_SET);
+		if (pos < 0) {
+			param->result = LLFS_NOK;
+			param->error_code = pos;
+			param->error_message = "lfs_file_seek failed";
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] seek to %ld on %ld (status %ld)\n", __func__, __LINE__, pos, (int32_t)fd, param->result);
+}
+
+void LLFS_File_IMPL_get_file_pointer_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+	FS_getfp_t* param = (FS_getfp_t*) job->params;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	param->result = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+
+	if (param->result < 0) {
+		// Error occurred
+		param->error_code = param->result;
+		param->result = LLFS_NOK;
+		param->error_message = "lfs_file_tell failed";
+	}
+
+#ifdef LLFS_DEBUG
+	printf("[%s:%u] get file pointer file %ld (status %lld)\n",__func__, __LINE__, (int32_t) fd, param->result);
+#endif
+}
+
+void LLFS_File_IMPL_set_length_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_set_length_t* param = (FS_set_length_t*) job->params;
+	int res = LFS_ERR_OK;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	lfs_soff_t oldPos = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+
+	if ((param->length < 0) || (param->length > (int64_t)LFS_FILE_MAX)) {
+		res = LFS_ERR_INVAL;
+	} else {
+		LLFS_littlefs_touch(fd);
+		// lfs_file_truncate() both shrinks and extends the file, and keeps the file pointer
+		res = lfs_file_truncate(&LLFS_ESP32_lfs, &fd->file, (lfs_off_t)param->length);
+		if ((res == LFS_ERR_OK) && (oldPos > (lfs_soff_t)param->length)) {
+			// The file pointer is moved to the new end of the file
+			lfs_soff_t pos = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, (lfs_soff_t)param->length, LFS_SEEK_SET);
+			res = (pos < 0) ? (int)pos : LFS_ERR_OK;
+		}
+	}
+
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "set length failed";
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] set length to %lld on %ld (status %ld)\n", __func__, __LINE__, param->length, (int32_t)fd, param->result);
+}
+
+
+void LLFS_File_IMPL_get_length_with_fd_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+	FS_get_length_with_fd_t* param = (FS_get_length_with_fd_t*) job->params;
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	param->result = lfs_file_size(&LLFS_ESP32_lfs, &fd->file);
+	if (param->result < 0) {
+		param->error_code = (int32_t)param->result;
+		param->result = LLFS_NOK;
+		param->error_message = "lfs_file_size failed";
+	}
+	LLFS_DEBUG_TRACE("[%s:%u] get length with fd on %ld length=%lld \n", __func__, __LINE__, (int32_t)fd, param->result);
+}
+
+void LLFS_File_IMPL_available_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_available_t* param = (FS_available_t*) job->params;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+
+	lfs_soff_t currentPtr = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+	lfs_soff_t size = lfs_file_size(&LLFS_ESP32_lfs, &fd->file);
+
+	if ((currentPtr < 0) || (size < 0) || (currentPtr > size)) {
+		param->result = 0;
+	} else {
+		param->result = size - currentPtr;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] available %ld bytes on %ld\n", __func__, __LINE__, param->result, (int32_t)fd);
+}
+
+void LLFS_File_IMPL_flush_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_flush_t* param = (FS_flush_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+
+	res = lfs_file_sync(&LLFS_ESP32_lfs, &fd->file);
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "lfs_file_sync failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] flush file %ld (status %ld err %d)\n", __func__, __LINE__, (int32_t)fd, param->result, res);
+}
+
+void LLFS_File_IMPL_rewind_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_seek_t* param = (FS_seek_t*) job->params;
+	lfs_soff_t res = LFS_ERR_INVAL;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->file_id;
+	lfs_soff_t pos = lfs_file_tell(&LLFS_ESP32_lfs, &fd->file);
+
+	if ((param->n >= 0) && (pos >= 0) && (param->n <= (int64_t)pos)) {
+		res = lfs_file_seek(&LLFS_ESP32_lfs, &fd->file, pos - (lfs_soff_t)param->n, LFS_SEEK_SET);
+	}
+	if (res < 0) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "lfs_file_seek failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] rewind %ld bytes on %ld (status %ld err %ld)\n", __func__, __LINE__, (int32_t)param->n, (int32_t)fd, param->result, res);
+}
+
+/**
+ * @brief Writes exactly <code>length</code> bytes at a position of a file.
+ *
+ * @return <code>LFS_ERR_OK</code> on success, <code>LFS_ERR_NOSPC</code> on a short write, else a negative error code.
+ */
+static int32_t LLFS_log_write_at(void* file, int64_t position, const void* data, uint32_t length) {
+	LLFS_littlefs_file_t* fp = (LLFS_littlefs_file_t*)file;
+	lfs_soff_t pos = lfs_file_seek(&LLFS_ESP32_lfs, &fp->file, (lfs_soff_t)position, LFS_SEEK_SET);
+	if (pos < 0) {
+		return (int32_t)pos;
+	}
+	lfs_ssize_t count = lfs_file_write(&LLFS_ESP32_lfs, &fp->file, data, (lfs_size_t)length);
+	if (count < 0) {
+		return (int32_t)count;
+	}
+	return ((uint32_t)count == length) ? LFS_ERR_OK : LFS_ERR_NOSPC;
+}
+
+/**
+ * @brief Reads at a position of a file.
+ *
+ * @return <code>LFS_ERR_OK</code> on success, including a short read at the end of the file, else a negative error
+ * code.
+ */
+static int32_t LLFS_log_read_at(void* file, int64_t position, void* data, uint32_t length, uint32_t* count) {
+	LLFS_littlefs_file_t* fp = (LLFS_littlefs_file_t*)file;
+	*count = 0;
+	lfs_soff_t pos = lfs_file_seek(&LLFS_ESP32_lfs, &fp->file, (lfs_soff_t)position, LFS_SEEK_SET);
+	if (pos < 0) {
+		return (int32_t)pos;
+	}
+	lfs_ssize_t read = lfs_file_read(&LLFS_ESP32_lfs, &fp->file, data, (lfs_size_t)length);
+	if (read < 0) {
+		return (int32_t)read;
+	}
+	*count = (uint32_t)read;
+	return LFS_ERR_OK;
+}
+
+/**
+ * @brief Sets the size of an empty append log file.
+ *
+ * LittleFS is copy-on-write, so sizing the file once does not avoid metadata updates as it does with FatFs,
+ * but it keeps the same file format and capacity semantics on both file systems.
+ */
+static int32_t LLFS_log_preallocate(void* file, int64_t capacity) {
+	LLFS_littlefs_file_t* fp = (LLFS_littlefs_file_t*)file;
+	LLFS_littlefs_touch(fp);
+	return (int32_t)lfs_file_truncate(&LLFS_ESP32_lfs, &fp->file, (lfs_off_t)capacity);
+}
+
+static int32_t LLFS_log_sync(void* file) {
+	return (int32_t)lfs_file_sync(&LLFS_ESP32_lfs, &((LLFS_littlefs_file_t*)file)->file);
+}
+
+static int64_t LLFS_log_size(void* file) {
+	return (int64_t)lfs_file_size(&LLFS_ESP32_lfs, &((LLFS_littlefs_file_t*)file)->file);
+}
+
+/** @brief LittleFS operations on the append log files */
+static const LLFS_log_file_ops_t gst_log_file_ops = {
+	.read_at = LLFS_log_read_at,
+	.write_at = LLFS_log_write_at,
+	.preallocate = LLFS_log_preallocate,
+	.sync = LLFS_log_sync,
+	.size = LLFS_log_size,
+	.not_a_log = LFS_ERR_CORRUPT
+};
+
+void LLFS_LOG_IMPL_open_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_open_t* param = (FS_log_open_t*) job->params;
+	LLFS_littlefs_file_t* fp;
+	int res = LFS_ERR_OK;
+	POOL_status_t pool_res;
+
+	const char* path = (const char*)&param->path;
+
+	pool_res = LLFS_pool_reserve(&gst_pool_file_ctx, (void**)&fp);
+	if (pool_res != POOL_NO_ERROR) {
+		param->result = LLFS_NOK;
+		param->error_code = pool_res;
+		param->error_message = "POOL_reserve_f failed";
+	} else {
+		res = LLFS_littlefs_file_open(fp, path, LFS_O_RDWR | LFS_O_CREAT);
+		if (res == LFS_ERR_OK) {
+			if (lfs_file_size(&LLFS_ESP32_lfs, &fp->file) == 0) {
+				res = (int)LLFS_log_create(fp, &gst_log_file_ops, param);
+			} else {
+				res = (int)LLFS_log_recover(fp, &gst_log_file_ops, param);
+			}
+			if (res != LFS_ERR_OK) {
+				(void)lfs_file_close(&LLFS_ESP32_lfs, &fp->file);
+			}
+		}
+		if (res != LFS_ERR_OK) {
+			LLFS_pool_free(&gst_pool_file_ctx, (void*)fp);
+			param->result = LLFS_NOK;
+			param->error_code = res;
+			param->error_message = (res == LFS_ERR_CORRUPT) ? "not an append log" : "append log open failed";
+		} else {
+			param->result = (int32_t)fp;
+		}
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] open log %s fd %ld, end %lld, %lu records (err %d)\n", __func__, __LINE__, path, param->result, param->end, param->sequence, res);
+}
+
+void LLFS_LOG_IMPL_write_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_write_t* param = (FS_log_write_t*) job->params;
+	int res = LFS_ERR_OK;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->log_id;
+
+	if (param->length > 0) {
+		LLFS_littlefs_touch(fd);
+		res = (int)LLFS_log_write_at(fd, param->position, param->data, (uint32_t)param->length);
+	}
+	if ((res == LFS_ERR_OK) && param->sync) {
+		res = lfs_file_sync(&LLFS_ESP32_lfs, &fd->file);
+	}
+
+	if (res != LFS_ERR_OK) {
+		param->result = LLFS_NOK;
+		param->error_code = res;
+		param->error_message = "append log write failed";
+	} else {
+		param->result = LLFS_OK;
+	}
+
+	LLFS_DEBUG_TRACE("[%s:%u] write log %ld: %ld bytes at %lld, sync %d (err %d)\n", __func__, __LINE__, param->log_id, param->length, param->position, param->sync, res);
+}
+
+void LLFS_LOG_IMPL_read_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+
+	FS_log_read_t* param = (FS_log_read_t*) job->params;
+
+	LLFS_littlefs_file_t* fd = (LLFS_littlefs_file_t*)param->log_id;
+
+	int32_t res = LLFS_log_read_record(fd, &gst_log_file_ops, param);
+
+	LLFS_DEBUG_TRACE("[%s:%u] read log %ld at %lld: %ld (err %ld)\n", __func__, __LINE__, param->log_id, param->position, param->result, res);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FS_USE_LITTLEFS
@@ -0,0 +1,133 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ *
+ */
+
+/**
+ * @file
+ * @brief Mapping and lookups of the resource image, independent of SNI and of the resource image storage.
+ * @author MicroEJ Developer Team
+ * @version 2.1.1
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "fs_configuration.h"
+#include "fs_helper.h"
+#include "LLFS_EXTENSION_impl.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Validates the header of a resource image.
+ *
+ * @return the size of the header and of the entries, 0 if the header is not valid.
+ */
+static uint32_t LLFS_resource_image_check_header(const LLFS_resource_image_header_t* header, uint32_t capacity) {
+	uint32_t max_count = (capacity - sizeof(LLFS_resource_image_header_t)) / sizeof(LLFS_resource_image_entry_t);
+	if ((header->magic != LLFS_RESOURCE_IMAGE_MAGIC) || (header->version != LLFS_RESOURCE_IMAGE_VERSION) || (header->count > max_count)) {
+		return 0;
+	}
+	return sizeof(LLFS_resource_image_header_t) + (header->count * sizeof(LLFS_resource_image_entry_t));
+}
+
+/**
+ * @brief Validates the entries of a resource image.
+ *
+ * @return the size used by the image: its header, its entries and the data of its resources, 0 if an entry is
+ * not valid.
+ */
+static uint32_t LLFS_resource_image_check_entries(const LLFS_resource_image_entry_t* entries, uint32_t count, uint32_t table_size, uint32_t capacity) {
+	uint32_t used_size = table_size;
+	for (uint32_t i = 0; i < count; i++) {
+		if ((memchr(entries[i].name, 0, LLFS_RESOURCE_NAME_LENGTH) == NULL) || (entries[i].offset < table_size)
+				|| (entries[i].offset > capacity) || (entries[i].length > (capacity - entries[i].offset))
+				|| (entries[i].length > (uint32_t)INT32_MAX)) {
+			return 0;
+		}
+		if ((entries[i].offset + entries[i].length) > used_size) {
+			used_size = entries[i].offset + entries[i].length;
+		}
+	}
+	return used_size;
+}
+
+int32_t LLFS_resource_image_map(LLFS_resource_image_t* image, const char** error_message) {
+	const uint8_t* data;
+	void* handle;
+	uint32_t count = 0;
+	uint32_t table_size = 0;
+	uint32_t used_size = 0;
+
+	image->data = NULL;
+	uint32_t capacity = LLFS_resource_storage_size();
+	if (capacity < sizeof(LLFS_resource_image_header_t)) {
+		*error_message = "Resource partition not found";
+		return LLFS_NOK;
+	}
+
+	// Map the header alone first: the image may be much smaller than its partition
+	if (LLFS_resource_storage_map(sizeof(LLFS_resource_image_header_t), &data, &handle) != LLFS_OK) {
+		*error_message = "Cannot map the resource partition";
+		return LLFS_NOK;
+	}
+	table_size = LLFS_resource_image_check_header((const LLFS_resource_image_header_t*)data, capacity);
+	if (table_size != 0U) {
+		count = ((const LLFS_resource_image_header_t*)data)->count;
+	}
+	LLFS_resource_storage_unmap(handle);
+
+	if ((table_size != 0U) && (LLFS_resource_storage_map(table_size, &data, &handle) == LLFS_OK)) {
+		used_size = LLFS_resource_image_check_entries((const LLFS_resource_image_entry_t*)&data[sizeof(LLFS_resource_image_header_t)], count, table_size, capacity);
+		LLFS_resource_storage_unmap(handle);
+	}
+	if (used_size == 0U) {
+		*error_message = "Invalid resource image";
+		return LLFS_NOK;
+	}
+
+	if (LLFS_resource_storage_map(used_size, &data, &handle) != LLFS_OK) {
+		*error_message = "Cannot map the resource partition";
+		return LLFS_NOK;
+	}
+	image->data = data;
+	image->size = used_size;
+	image->count = count;
+	image->handle = handle;
+	LLFS_DEBUG_TRACE("[%s:%u] mapped %lu bytes of %lu for %lu resources at %p\n", __func__, __LINE__, used_size, capacity, count, data);
+	return LLFS_OK;
+}
+
+void LLFS_resource_image_unmap(LLFS_resource_image_t* image) {
+	if (image->data != NULL) {
+		LLFS_resource_storage_unmap(image->handle);
+		image->data = NULL;
+	}
+}
+
+int32_t LLFS_resource_image_find(const LLFS_resource_image_t* image, const char* name) {
+	const LLFS_resource_image_entry_t* entries = (const LLFS_resource_image_entry_t*)&image->data[sizeof(LLFS_resource_image_header_t)];
+	for (uint32_t i = 0; i < image->count; i++) {
+		if (strcmp(entries[i].name, name) == 0) {
+			return (int32_t)i;
+		}
+	}
+	return LLFS_NOK;
+}
+
+const LLFS_resource_image_entry_t* LLFS_resource_image_get_entry(const LLFS_resource_image_t* image, int32_t resource_id) {
+	if ((image->data == NULL) || (resource_id < 0) || ((uint32_t)resource_id >= image->count)) {
+		return NULL;
+	}
+	return &((const LLFS_resource_image_entry_t*)&image->data[sizeof(LLFS_resource_image_header_t)])[resource_id];
+}
+
+#ifdef __cplusplus
+	}
+#endif
@@ -0,0 +1,61 @@
+# Python
+#
+# Copyright 2024 MicroEJ Corp. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be found with this software.
+
+# This script generates a resource image for the "resources" partition (see FS_RESOURCE_PARTITION_LABEL in fs_configuration.h).
+# The image layout is described in LLFS_EXTENSION_impl.h: a header, one entry per resource, then the data of the resources.
+# A resource is named after its input file, or after the name given before '=' in the argument.
+# Usage: `python make_resource_image.py output-filename [--size partition-size] [[name=]input-filename]*`
+# Example: `python make_resource_image.py resources.bin --size 0x8000 fonts/sans.ejf images/logo=images/logo.png`
+
+import os
+import struct
+import sys
+
+IMAGE_MAGIC = 0x49524A4D
+IMAGE_VERSION = 1
+NAME_LENGTH = 56
+HEADER_FORMAT = "<IIII"
+ENTRY_FORMAT = "<%dsII" % NAME_LENGTH
+# Alignment of the data of each resource, for word accesses to the mapped data
+DATA_ALIGNMENT = 4
+
+output_filename = sys.argv[1]
+partition_size = None
+resources = []
+
+i = 2
+while i < len(sys.argv):
+	if sys.argv[i] == "--size":
+		partition_size = int(sys.argv[i + 1], 0)
+		i += 2
+		continue
+	name, separator, input_filename = sys.argv[i].partition("=")
+	if not separator:
+		input_filename = name
+		name = os.path.basename(name)
+	if len(name.encode("utf-8")) >= NAME_LENGTH:
+		exit("Resource name too long: " + name)
+	if any(name == resource[0] for resource in resources):
+		exit("Duplicate resource name: " + name)
+	input_file = open(input_filename, "rb")
+	resources.append((name, input_file.read()))
+	input_file.close()
+	i += 1
+
+image = bytearray(struct.pack(HEADER_FORMAT, IMAGE_MAGIC, IMAGE_VERSION, len(resources), 0))
+data_offset = len(image) + len(resources) * struct.calcsize(ENTRY_FORMAT)
+data = bytearray()
+for name, content in resources:
+	data += bytearray(-(data_offset + len(data)) % DATA_ALIGNMENT)
+	image += struct.pack(ENTRY_FORMAT, name.encode("utf-8"), data_offset + len(data), len(content))
+	data += content
+image += data
+
+if partition_size is not None and len(image) > partition_size:
+	exit("Resource image too large: %d bytes for a partition of %d bytes" % (len(image), partition_size))
+
+output_file = open(output_filename, "wb")
+output_file.write(image)
+output_file.close()
@@ -0,0 +1,61 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ Security low level API: key agreement.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_KEY_AGREEMENT_IMPL_H
+#define LLSEC_KEY_AGREEMENT_IMPL_H
+
+#include <sni.h>
+#include <LLSEC_ERRORS.h>
+#include <stdint.h>
+
+#define LLSEC_KEY_AGREEMENT_IMPL_get_algorithm          Java_com_microej_support_security_keyagreement_NativeKeyAgreementSpi_nativeGetAlgorithm
+#define LLSEC_KEY_AGREEMENT_IMPL_generate_secret        Java_com_microej_support_security_keyagreement_NativeKeyAgreementSpi_nativeGenerateSecret
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Gets for the given algorithm name the algorithm structure pointer if it's supported.
+ *
+ * @param[in] algorithm_name            Null terminated string that describes the algorithm ("X25519", "XDH" or "ECDH").
+ *
+ * @return The algorithm ID (pointer) on success or -1 on error.
+ */
+int32_t LLSEC_KEY_AGREEMENT_IMPL_get_algorithm(uint8_t* algorithm_name);
+
+/**
+ * @brief Computes the shared secret between a local private key and a peer public key.
+ *
+ * X25519 secrets are the 32-byte little-endian u-coordinate (RFC 7748). ECDH secrets are the big-endian
+ * x-coordinate, padded to the size of the curve field.
+ *
+ * @param[in] algorithm_id              The algorithm ID.
+ * @param[in] private_key_id            The local private key native ID.
+ * @param[in] public_key_id             The peer public key native ID.
+ * @param[out] secret                   The output buffer.
+ * @param[in] secret_length             The output buffer length.
+ *
+ * @return The number of bytes written into <code>secret</code>.
+ *
+ * @throws NativeException on error.
+ */
+int32_t LLSEC_KEY_AGREEMENT_IMPL_generate_secret(int32_t algorithm_id, int32_t private_key_id, int32_t public_key_id, uint8_t* secret, int32_t secret_length);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_KEY_AGREEMENT_IMPL_H */
@@ -0,0 +1,72 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ Security low level API: secret key derivation extensions.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_SECRET_KEY_FACTORY_EXTENSION_IMPL_H
+#define LLSEC_SECRET_KEY_FACTORY_EXTENSION_IMPL_H
+
+#include <sni.h>
+#include <LLSEC_ERRORS.h>
+#include <stdint.h>
+
+#define LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract      Java_com_microej_support_security_secretkeyfactory_NativeHKDF_nativeExtract
+#define LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_expand       Java_com_microej_support_security_secretkeyfactory_NativeHKDF_nativeExpand
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief HKDF-Extract (RFC 5869): computes a pseudorandom key from an input keying material.
+ *
+ * @param[in] digest_name                   Null terminated string that describes the HMAC digest ("SHA-1", "SHA-256",
+ *                                          "SHA-384" or "SHA-512").
+ * @param[in] salt                          The salt, may be empty.
+ * @param[in] salt_length                   The salt length.
+ * @param[in] ikm                           The input keying material.
+ * @param[in] ikm_length                    The input keying material length.
+ * @param[out] prk                          The buffer receiving the pseudorandom key.
+ * @param[in] prk_length                    The prk buffer length, at least the digest length.
+ *
+ * @return The length of the pseudorandom key (the digest length).
+ *
+ * @throws NativeException on error.
+ *
+ * @warning <code>salt</code>, <code>ikm</code> and <code>prk</code> must not be used outside of the VM task or saved.
+ */
+int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract(uint8_t* digest_name, uint8_t* salt, int32_t salt_length, uint8_t* ikm, int32_t ikm_length, uint8_t* prk, int32_t prk_length);
+
+/**
+ * @brief HKDF-Expand (RFC 5869): derives an output keying material from a pseudorandom key.
+ *
+ * @param[in] digest_name                   Null terminated string that describes the HMAC digest (see
+ *                                          LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract()).
+ * @param[in] prk                           The pseudorandom key.
+ * @param[in] prk_length                    The pseudorandom key length, at least the digest length.
+ * @param[in] info                          The context and application specific information, may be empty.
+ * @param[in] info_length                   The info length.
+ * @param[out] okm                          The buffer receiving the output keying material.
+ * @param[in] okm_length                    The number of bytes to derive, at most 255 times the digest length.
+ *
+ * @throws NativeException on error.
+ *
+ * @warning <code>prk</code>, <code>info</code> and <code>okm</code> must not be used outside of the VM task or saved.
+ */
+void LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_expand(uint8_t* digest_name, uint8_t* prk, int32_t prk_length, uint8_t* info, int32_t info_length, uint8_t* okm, int32_t okm_length);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_SECRET_KEY_FACTORY_EXTENSION_IMPL_H */
@@ -0,0 +1,45 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Secret key derivation, independent of SNI.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_SECRET_KEY_FACTORY_HELPER_H
+#define LLSEC_SECRET_KEY_FACTORY_HELPER_H
+
+#include <stdint.h>
+
+#include "microej_async_worker.h"
+#include "mbedtls/md.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Derives a key with PKCS#5 PBKDF2.
+ *
+ * @return LLSEC_MBEDTLS_SUCCESS on success, an mbedTLS error code otherwise.
+ */
+int LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(mbedtls_md_type_t md_type, const uint8_t* password, int32_t password_length, const uint8_t* salt, int32_t salt_length, int32_t iterations, uint8_t* key, int32_t key_length);
+
+/**
+ * @brief Security worker action: derives the key described by the <code>pbkdf2</code> parameters of the job
+ * (see LLSEC_worker.h) and stores the mbedTLS return code in their <code>result</code> field.
+ */
+void LLSEC_SECRET_KEY_FACTORY_PBKDF2_action(MICROEJ_ASYNC_WORKER_job_t* job);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_SECRET_KEY_FACTORY_HELPER_H */
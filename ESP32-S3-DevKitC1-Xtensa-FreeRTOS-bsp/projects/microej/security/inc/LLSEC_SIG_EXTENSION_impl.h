@@ -0,0 +1,160 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ Security low level API: signature extensions.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_SIG_EXTENSION_IMPL_H
+#define LLSEC_SIG_EXTENSION_IMPL_H
+
+#include <sni.h>
+#include <LLSEC_ERRORS.h>
+#include <stdint.h>
+
+#define LLSEC_SIG_IMPL_stream_init                      Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamInit
+#define LLSEC_SIG_IMPL_stream_update                    Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamUpdate
+#define LLSEC_SIG_IMPL_stream_update_from_partition     Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamUpdateFromPartition
+#define LLSEC_SIG_IMPL_stream_update_from_file          Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamUpdateFromFile
+#define LLSEC_SIG_IMPL_stream_verify                    Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamVerify
+#define LLSEC_SIG_IMPL_stream_sign                      Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamSign
+#define LLSEC_SIG_IMPL_stream_close                     Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamClose
+#define LLSEC_SIG_IMPL_stream_get_close_id              Java_com_microej_support_security_signature_NativeSignatureExtension_nativeStreamGetCloseId
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Initializes a streaming signature resource.
+ *
+ * The message is hashed incrementally with the digest of the signature algorithm as it is fed with
+ * LLSEC_SIG_IMPL_stream_update(), LLSEC_SIG_IMPL_stream_update_from_partition() or
+ * LLSEC_SIG_IMPL_stream_update_from_file(), so that it never has to be held in memory nor hashed by a separate Java
+ * pass.
+ *
+ * @param[in] algorithm_id                  The algorithm ID (see LLSEC_SIG_IMPL_get_algorithm_description()).
+ *
+ * @return The native ID of the resource.
+ *
+ * @throws NativeException on error.
+ */
+int32_t LLSEC_SIG_IMPL_stream_init(int32_t algorithm_id);
+
+/**
+ * @brief Adds data to the message.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ * @param[in] buffer                        The buffer containing the data to add.
+ * @param[in] buffer_offset                 The buffer offset.
+ * @param[in] buffer_length                 The number of bytes to add.
+ *
+ * @throws NativeException on error.
+ *
+ * @warning <code>buffer</code> must not be used outside of the VM task or saved.
+ */
+void LLSEC_SIG_IMPL_stream_update(int32_t native_id, uint8_t* buffer, int32_t buffer_offset, int32_t buffer_length);
+
+/**
+ * @brief Adds a range of a flash partition to the message, without copying it through the Java heap.
+ *
+ * The range is memory-mapped and hashed in place, LLSEC_SIG_STREAM_MAP_SIZE bytes at a time. Ranges longer than
+ * LLSEC_SIG_STREAM_MAP_SIZE are hashed by the security worker: the calling Java thread is suspended until the whole
+ * range is hashed and the other Java threads keep running.
+ *
+ * If an exception is thrown, the message is undefined and the resource must be closed.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ * @param[in] partition_label               The null terminated label of the data or application partition, as
+ *                                          defined in the partition table (e.g. "ota_1").
+ * @param[in] offset                        The offset of the range in the partition.
+ * @param[in] length                        The number of bytes to add.
+ *
+ * @throws NativeException on error, or if no partition has the given label.
+ *
+ * @warning <code>partition_label</code> must not be used outside of the VM task or saved.
+ */
+void LLSEC_SIG_IMPL_stream_update_from_partition(int32_t native_id, uint8_t* partition_label, int32_t offset, int32_t length);
+
+/**
+ * @brief Adds a range of an open file to the message, without copying it through the Java heap.
+ *
+ * The range is read and hashed by the FS worker of the file, in order with the other operations on the file. The
+ * calling Java thread is suspended until the whole range is hashed. The file pointer is not moved.
+ *
+ * If an exception is thrown, the message is undefined and the resource must be closed.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ * @param[in] file_id                       The file ID, as returned by LLFS_File_IMPL_open().
+ * @param[in] position                      The position of the range in the file.
+ * @param[in] length                        The number of bytes to add.
+ *
+ * @throws NativeException on error, or if the file ends before the end of the range.
+ */
+void LLSEC_SIG_IMPL_stream_update_from_file(int32_t native_id, int32_t file_id, int64_t position, int64_t length);
+
+/**
+ * @brief Verifies the signature of the message added so far.
+ *
+ * The resource is reset and can be used for a new message afterwards.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ * @param[in] signature                     The buffer containing the signature.
+ * @param[in] signature_length              The signature length.
+ * @param[in] public_key_id                 The public key native ID.
+ *
+ * @return JTRUE if the signature is valid, JFALSE otherwise.
+ *
+ * @throws NativeException on error.
+ *
+ * @warning <code>signature</code> must not be used outside of the VM task or saved.
+ */
+uint8_t LLSEC_SIG_IMPL_stream_verify(int32_t native_id, uint8_t* signature, int32_t signature_length, int32_t public_key_id);
+
+/**
+ * @brief Signs the message added so far.
+ *
+ * The resource is reset and can be used for a new message afterwards.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ * @param[out] signature                    The buffer receiving the signature.
+ * @param[in] signature_length              The signature buffer length.
+ * @param[in] private_key_id                The private key native ID.
+ *
+ * @return The length of the signature.
+ *
+ * @throws NativeException on error.
+ *
+ * @warning <code>signature</code> must not be used outside of the VM task or saved.
+ */
+int32_t LLSEC_SIG_IMPL_stream_sign(int32_t native_id, uint8_t* signature, int32_t signature_length, int32_t private_key_id);
+
+/**
+ * @brief Closes the resource related to the native ID.
+ *
+ * @param[in] native_id                     The resource's native ID.
+ *
+ * @throws NativeException on error.
+ */
+void LLSEC_SIG_IMPL_stream_close(int32_t native_id);
+
+/**
+ * @brief Gets the id of the native close function.
+ *
+ * @return the id of the static native close function.
+ */
+int32_t LLSEC_SIG_IMPL_stream_get_close_id(void);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_SIG_EXTENSION_IMPL_H */
@@ -0,0 +1,72 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief X509 certificate path validation, independent of SNI.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_X509_CERT_PATH_HELPER_H
+#define LLSEC_X509_CERT_PATH_HELPER_H
+
+#include <LLSEC_ERRORS.h>
+#include <stdint.h>
+
+#include "mbedtls/x509_crt.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Checks that the current time is within the validity period of the given certificate.
+ *
+ * @return {@link J_SEC_NO_ERROR} on success, {@link J_X509_CERT_EXPIRED_ERROR} if the certificate expired,
+ * {@link J_X509_CERT_NOT_YET_VALID_ERROR} if it is not yet valid.
+ */
+int32_t LLSEC_X509_CERT_check_validity_period(const mbedtls_x509_crt* x509);
+
+/**
+ * @brief Validates a certificate chain against a set of trust anchors.
+ *
+ * See LLSEC_X509_CERT_PATH_IMPL_validate() for the checks done on each link. Verified links are remembered in the
+ * link cache so that their signature is not checked again.
+ *
+ * @return {@link J_SEC_NO_ERROR} on success, {@link LLSEC_ERROR} if a count is invalid, an error code otherwise
+ * (see LLSEC_X509_CERT_PATH_IMPL_validate()).
+ */
+int32_t LLSEC_X509_CERT_PATH_validate(int8_t* certs, int32_t* cert_lengths, int32_t cert_count,
+                                      int8_t* trusted_certs, int32_t* trusted_cert_lengths, int32_t trusted_cert_count);
+
+/**
+ * @brief Tells whether the link between the two given encoded certificates is in the link cache.
+ *
+ * The lookup does not refresh the entry.
+ *
+ * @return 1 if <code>issuer</code> is known to have issued <code>subject</code>, 0 otherwise.
+ */
+uint8_t LLSEC_X509_CERT_PATH_is_link_verified(const uint8_t* issuer, int32_t issuer_length,
+                                              const uint8_t* subject, int32_t subject_length);
+
+/**
+ * @brief Returns the number of links whose signature check was skipped because they were in the link cache.
+ */
+uint32_t LLSEC_X509_CERT_PATH_get_cache_hit_count(void);
+
+/**
+ * @brief Forgets all the verified links.
+ */
+void LLSEC_X509_CERT_PATH_clear_cache(void);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_X509_CERT_PATH_HELPER_H */
@@ -0,0 +1,63 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ Security low level API: X509 certificate path validation.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_X509_CERT_PATH_IMPL_H
+#define LLSEC_X509_CERT_PATH_IMPL_H
+
+#include <sni.h>
+#include <LLSEC_ERRORS.h>
+#include <stdint.h>
+
+#define LLSEC_X509_CERT_PATH_IMPL_validate              Java_com_microej_support_security_natives_X509CertPathNatives_validate
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @brief Validates a certificate chain against a set of trusted certificates.
+ *
+ * The chain is ordered from the end-entity certificate (index 0) to the certificate closest to the trust anchor.
+ * Each link is checked for name chaining, basic constraints (CA flag and path length), keyCertSign key usage,
+ * validity period and signature. The chain is trusted if its last certificate is one of the trusted certificates or
+ * is signed by one of them.
+ *
+ * Successful signature checks are remembered per (issuer, subject) pair, so validating a chain that shares
+ * intermediates with a previously validated chain does not perform the RSA/ECDSA operations again.
+ *
+ * @param[in] certs                         The encoded (DER or PEM) certificates of the chain, concatenated.
+ * @param[in] cert_lengths                  The length of each certificate in <code>certs</code>.
+ * @param[in] cert_count                    The number of certificates in the chain.
+ * @param[in] trusted_certs                 The encoded (DER or PEM) trusted certificates, concatenated.
+ * @param[in] trusted_cert_lengths          The length of each certificate in <code>trusted_certs</code>.
+ * @param[in] trusted_cert_count            The number of trusted certificates.
+ *
+ * @return {@link J_SEC_NO_ERROR} if the chain is valid; otherwise one of {@link J_CERT_PARSE_ERROR},
+ * {@link J_MAX_CHAIN_ERROR}, {@link J_NAME_CHAINING_ERROR}, {@link J_NOT_CA_CERT}, {@link J_X509_CERT_EXPIRED_ERROR},
+ * {@link J_X509_CERT_NOT_YET_VALID_ERROR}, {@link J_VERIFY_CERT_ERROR} or {@link J_NO_TRUSTED_CERT}.
+ *
+ * @warning <code>certs</code>, <code>cert_lengths</code>, <code>trusted_certs</code> and <code>trusted_cert_lengths</code>
+ * must not be used outside of the VM task or saved.
+ *
+ * @throws NativeException on error.
+ */
+int32_t LLSEC_X509_CERT_PATH_IMPL_validate(int8_t* certs, int32_t* cert_lengths, int32_t cert_count,
+                                           int8_t* trusted_certs, int32_t* trusted_cert_lengths, int32_t trusted_cert_count);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_X509_CERT_PATH_IMPL_H */
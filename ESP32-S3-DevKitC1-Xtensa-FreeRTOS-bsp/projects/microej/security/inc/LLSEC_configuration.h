@@ -34,6 +34,63 @@
 #define LLSEC_PRIVATE_KEY_LOCAL_BUFFER_SIZE       (3072)
 #define LLSEC_PUBLIC_KEY_LOCAL_BUFFER_SIZE        (3072)
 
+/*
+ * Number of parsed X509 certificates kept in the LLSEC_X509_CERT cache.
+ * Each entry holds a full mbedtls_x509_crt (around 1-2 KB for a typical RSA/EC certificate).
+ * Must be greater than or equal to 1.
+ */
+#ifndef LLSEC_X509_CERT_CACHE_SIZE
+#define LLSEC_X509_CERT_CACHE_SIZE                (4)
+#endif
+
+/*
+ * Maximum number of certificates in a chain given to LLSEC_X509_CERT_PATH_IMPL_validate().
+ */
+#ifndef LLSEC_X509_CERT_PATH_MAX_LENGTH
+#define LLSEC_X509_CERT_PATH_MAX_LENGTH           (4)
+#endif
+
+/*
+ * Number of verified (issuer, subject) certificate links remembered by LLSEC_X509_CERT_PATH_IMPL_validate().
+ * Each entry uses 36 bytes.
+ */
+#ifndef LLSEC_X509_CERT_PATH_CACHE_SIZE
+#define LLSEC_X509_CERT_PATH_CACHE_SIZE           (8)
+#endif
+
+/*
+ * Size of the flash window mapped at once by LLSEC_SIG_IMPL_stream_update_from_partition().
+ * Larger ranges are hashed window by window to bound the number of MMU pages in use, by the security worker task
+ * instead of the VM task.
+ */
+#ifndef LLSEC_SIG_STREAM_MAP_SIZE
+#define LLSEC_SIG_STREAM_MAP_SIZE                 (64 * 1024)
+#endif
+
+/*
+ * PBKDF2 derivations with at least this number of iterations are run by the security worker task instead of the VM
+ * task. The calling Java thread is suspended until the derivation is done, the other Java threads keep running.
+ */
+#ifndef LLSEC_SECRET_KEY_FACTORY_ASYNC_ITERATIONS
+#define LLSEC_SECRET_KEY_FACTORY_ASYNC_ITERATIONS (1000)
+#endif
+
+/*
+ * Security worker task (see LLSEC_worker.h), started on first use.
+ */
+#ifndef LLSEC_WORKER_JOB_COUNT
+#define LLSEC_WORKER_JOB_COUNT                    (2)
+#endif
+#ifndef LLSEC_WORKER_WAITING_LIST_SIZE
+#define LLSEC_WORKER_WAITING_LIST_SIZE            (4)
+#endif
+#ifndef LLSEC_WORKER_STACK_SIZE
+#define LLSEC_WORKER_STACK_SIZE                   (1024 * 4)
+#endif
+#ifndef LLSEC_WORKER_PRIORITY
+#define LLSEC_WORKER_PRIORITY                     (5)
+#endif
+
 /*
  * Debug traces activation
  */
@@ -54,6 +111,9 @@
 #ifndef LLSEC_DIGEST_DEBUG
 #define LLSEC_DIGEST_DEBUG                        LLSEC_DEBUG_TRACE_DISABLE
 #endif
+#ifndef LLSEC_KEY_AGREEMENT_DEBUG
+#define LLSEC_KEY_AGREEMENT_DEBUG                 LLSEC_DEBUG_TRACE_DISABLE
+#endif
 #ifndef LLSEC_KEY_FACTORY_DEBUG
 #define LLSEC_KEY_FACTORY_DEBUG                   LLSEC_DEBUG_TRACE_DISABLE
 #endif
@@ -100,6 +160,12 @@
 #define LLSEC_DIGEST_DEBUG_TRACE(...)             ((void)(0))
 #endif
 
+#if (LLSEC_KEY_AGREEMENT_DEBUG == LLSEC_DEBUG_TRACE_ENABLE || LLSEC_ALL_DEBUG == LLSEC_DEBUG_TRACE_ENABLE)
+#define LLSEC_KEY_AGREEMENT_DEBUG_TRACE(...)      LLSEC_DEBUG_TRACE(__VA_ARGS__)
+#else
+#define LLSEC_KEY_AGREEMENT_DEBUG_TRACE(...)      ((void)(0))
+#endif
+
 #if (LLSEC_KEY_FACTORY_DEBUG == LLSEC_DEBUG_TRACE_ENABLE || LLSEC_ALL_DEBUG == LLSEC_DEBUG_TRACE_ENABLE)
 #define LLSEC_KEY_FACTORY_DEBUG_TRACE(...)        LLSEC_DEBUG_TRACE(__VA_ARGS__)
 #else
@@ -0,0 +1,81 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Ed25519 signatures (RFC 8032), for the mbedTLS versions that do not implement EdDSA.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_ED25519_H
+#define LLSEC_ED25519_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* Ed25519 sizes (RFC 8032, RFC 8410) */
+#define LLSEC_ED25519_KEY_SIZE           (32)
+#define LLSEC_ED25519_SIGNATURE_SIZE     (64)
+#define LLSEC_ED25519_PREHASH_SIZE       (64) /* SHA-512 */
+#define LLSEC_ED25519_PKCS8_KEY_SIZE     (48)
+#define LLSEC_ED25519_X509_KEY_SIZE      (44)
+
+/*
+ * Ed25519 key, referenced by LLSEC_priv_key and LLSEC_pub_key when their type is TYPE_ED25519.
+ * The private part is the 32-byte seed of RFC 8032 section 5.1.5, it is all zeros for a public key.
+ */
+typedef struct {
+    uint8_t has_private_key;
+    uint8_t private_key[LLSEC_ED25519_KEY_SIZE];
+    uint8_t public_key[LLSEC_ED25519_KEY_SIZE];
+} LLSEC_ed25519_key;
+
+/**
+ * @brief Computes the public key of the given private key (RFC 8032 section 5.1.5).
+ *
+ * @return 0 on success, a negative value if the memory can't be allocated.
+ */
+int llsec_ed25519_public_key(uint8_t* public_key, const uint8_t* private_key);
+
+/**
+ * @brief Erases and frees a key allocated with mbedtls_calloc().
+ */
+void llsec_ed25519_key_free(LLSEC_ed25519_key* key);
+
+/**
+ * @brief Signs a message (RFC 8032 section 5.1.6).
+ *
+ * @param[in] prehashed                     0 for Ed25519, 1 for Ed25519ph: <code>message</code> is then the SHA-512
+ *                                          digest of the message.
+ *
+ * @return 0 on success, a negative value if the memory can't be allocated.
+ */
+int llsec_ed25519_sign(uint8_t* signature, const uint8_t* message, size_t message_length,
+                       const LLSEC_ed25519_key* key, uint8_t prehashed);
+
+/**
+ * @brief Verifies the signature of a message (RFC 8032 section 5.1.7).
+ *
+ * @param[in] prehashed                     0 for Ed25519, 1 for Ed25519ph: <code>message</code> is then the SHA-512
+ *                                          digest of the message.
+ *
+ * @return 0 if the signature is valid, a negative value otherwise.
+ */
+int llsec_ed25519_verify(const uint8_t* signature, const uint8_t* message, size_t message_length,
+                         const uint8_t* public_key, uint8_t prehashed);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_ED25519_H */
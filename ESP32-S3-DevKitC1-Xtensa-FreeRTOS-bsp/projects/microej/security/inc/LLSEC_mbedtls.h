@@ -17,22 +17,49 @@
 #define LLSEC_MBEDTLS_H
 
 #include <stdint.h>
+#include <LLSEC_ed25519.h>
+#include "mbedtls/version.h"
 #include "mbedtls/pk.h"
+#include "mbedtls/ctr_drbg.h"
+
+/* Access to the mbedTLS structure fields that are private since mbedTLS 3 */
+#if (MBEDTLS_VERSION_MAJOR == 2)
+#define LLSEC_MBEDTLS_PRIVATE(f) f
+#elif (MBEDTLS_VERSION_MAJOR == 3)
+#define LLSEC_MBEDTLS_PRIVATE(f) MBEDTLS_PRIVATE(f)
+#else
+#error "Unsupported mbedTLS major version"
+#endif
 
 typedef enum {
-    TYPE_RSA = 6,     //EVP_PKEY_RSA,
-    TYPE_ECDSA = 408, //EVP_PKEY_EC,
+    TYPE_RSA = 6,        //EVP_PKEY_RSA,
+    TYPE_ECDSA = 408,    //EVP_PKEY_EC,
+    TYPE_X25519 = 1034,  //EVP_PKEY_X25519, key is a mbedtls_ecp_keypair on MBEDTLS_ECP_DP_CURVE25519
+    TYPE_ED25519 = 1087, //EVP_PKEY_ED25519, key is a LLSEC_ed25519_key (see LLSEC_ed25519.h)
 } LLSEC_pub_key_type;
 
-/*key must be mbedtls_rsa_context or mbedtls_ecdsa_context TYPE*/
+/* X25519 key sizes (RFC 7748, RFC 8410) */
+#define LLSEC_X25519_KEY_SIZE            (32)
+#define LLSEC_X25519_PKCS8_KEY_SIZE      (48)
+#define LLSEC_X25519_X509_KEY_SIZE       (44)
+
+/*
+ * key must be mbedtls_rsa_context or mbedtls_ecdsa_context TYPE.
+ * references counts the natives that keep the key besides its own SNI resource (e.g. a RSA cipher): the key is only
+ * freed when its resource is closed and references is back to 0, see llsec_priv_key_release().
+ */
 typedef struct {
     LLSEC_pub_key_type type;
     char *key; /*mbedtls_rsa_context or mbedtls_ecdsa_context*/
+    uint32_t references;
+    uint8_t closed;
 } LLSEC_priv_key;
 
 typedef struct {
     LLSEC_pub_key_type type;
     char *key; /*mbedtls_rsa_context or mbedtls_ecdsa_context*/
+    uint32_t references;
+    uint8_t closed;
 } LLSEC_pub_key;
 
 typedef struct {
@@ -42,4 +69,27 @@ typedef struct {
 
 extern char *llsec_gen_random_str_internal(int length);
 
+/*
+ * Key lifetime, see LLSEC_KEY_FACTORY_impl.c. Must be called from the VM task.
+ * llsec_*_key_close() is the close function of the SNI resource of the key, llsec_*_key_retain() and
+ * llsec_*_key_release() bracket the use of the key by another native resource.
+ */
+extern void llsec_priv_key_close(void* native_id);
+extern void llsec_priv_key_retain(LLSEC_priv_key* key);
+extern void llsec_priv_key_release(LLSEC_priv_key* key);
+extern void llsec_pub_key_close(void* native_id);
+extern void llsec_pub_key_retain(LLSEC_pub_key* key);
+extern void llsec_pub_key_release(LLSEC_pub_key* key);
+
+/* Random generator shared by the security natives for blinding and padding, see LLSEC_RANDOM_impl.c */
+extern mbedtls_ctr_drbg_context* llsec_get_ctr_drbg(void);
+
+/* X25519 PKCS#8 and X.509 (SubjectPublicKeyInfo) encodings, see LLSEC_KEY_FACTORY_impl.c */
+extern int llsec_x25519_write_private_key_der(mbedtls_ecp_keypair* key, uint8_t* output, int32_t output_length);
+extern int llsec_x25519_write_public_key_der(mbedtls_ecp_keypair* key, uint8_t* output, int32_t output_length);
+
+/* Ed25519 PKCS#8 and X.509 (SubjectPublicKeyInfo) encodings, see LLSEC_KEY_FACTORY_impl.c */
+extern int llsec_ed25519_write_private_key_der(const LLSEC_ed25519_key* key, uint8_t* output, int32_t output_length);
+extern int llsec_ed25519_write_public_key_der(const LLSEC_ed25519_key* key, uint8_t* output, int32_t output_length);
+
 #endif /* LLSEC_MBEDTLS_H */
@@ -0,0 +1,80 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Security worker: runs the long cryptographic operations out of the VM task.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#ifndef LLSEC_WORKER_H
+#define LLSEC_WORKER_H
+
+#include <stdint.h>
+
+#include "LLSEC_mbedtls.h"
+#include "microej_async_worker.h"
+#include "mbedtls/md.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+ * IMPORTANT NOTICE
+ *
+ * The parameters of each job run by the security worker are declared here.
+ * If you add a new job type, do not forget to add its parameters to the LLSEC_worker_param_t union.
+ */
+
+/* PBKDF2 derivation: password and salt are copied out of the Java heap */
+typedef struct {
+    LLSEC_secret_key* secret_key;
+    mbedtls_md_type_t md_type;
+    uint8_t*          password;
+    int32_t           password_length;
+    uint8_t*          salt;
+    int32_t           salt_length;
+    int32_t           iterations;
+    int               result;
+} LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t;
+
+/* Hash of a flash partition range by a streaming signature */
+typedef struct {
+    mbedtls_md_context_t*  md_ctx;
+    const esp_partition_t* partition;
+    int32_t                offset;
+    int32_t                length;
+    int                    result;       /* ESP_OK/LLSEC_MBEDTLS_SUCCESS or the error code */
+    const char*            error_message;
+} LLSEC_SIG_partition_param_t;
+
+typedef union {
+    LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t pbkdf2;
+    LLSEC_SIG_partition_param_t             sig_partition;
+} LLSEC_worker_param_t;
+
+/* Declared with MICROEJ_ASYNC_WORKER_worker_declare() in LLSEC_worker.c */
+extern MICROEJ_ASYNC_WORKER_handle_t llsec_worker;
+
+/**
+ * @brief Starts the security worker on first use.
+ *
+ * Must be called from the VM task.
+ *
+ * @return LLSEC_SUCCESS if the worker is running, LLSEC_ERROR otherwise.
+ */
+int32_t llsec_worker_start(void);
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif /* LLSEC_WORKER_H */
@@ -27,6 +27,7 @@
 #define MD5_DIGEST_LENGTH     (16)
 #define SHA1_DIGEST_LENGTH    (20)
 #define SHA256_DIGEST_LENGTH  (32)
+#define SHA384_DIGEST_LENGTH  (48)
 #define SHA512_DIGEST_LENGTH  (64)
 
 typedef int (*LLSEC_DIGEST_init)(void** native_id);
@@ -51,11 +52,12 @@ static int mbedtls_digest_digest(void* native_id, uint8_t* out, int32_t* out_len
 static int LLSEC_DIGEST_MD5_init(void** native_id);
 static int LLSEC_DIGEST_SHA1_init(void** native_id);
 static int LLSEC_DIGEST_SHA256_init(void** native_id);
+static int LLSEC_DIGEST_SHA384_init(void** native_id);
 static int LLSEC_DIGEST_SHA512_init(void** native_id);
 static void mbedtls_digest_close(void* native_id);
 
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
-static LLSEC_DIGEST_algorithm available_digest_algorithms[4] = {
+static LLSEC_DIGEST_algorithm available_digest_algorithms[5] = {
     {
         .name   = "MD5",
         .init   = LLSEC_DIGEST_MD5_init,
@@ -86,6 +88,16 @@ static LLSEC_DIGEST_algorithm available_digest_algorithms[4] = {
             .digest_length = SHA256_DIGEST_LENGTH
         }
     },
+    {
+        .name   = "SHA-384",
+        .init   = LLSEC_DIGEST_SHA384_init,
+        .update = mbedtls_digest_update,
+        .digest = mbedtls_digest_digest,
+        .close  = mbedtls_digest_close,
+        {
+            .digest_length = SHA384_DIGEST_LENGTH
+        }
+    },
     {
         .name   = "SHA-512",
         .init   = LLSEC_DIGEST_SHA512_init,
@@ -243,6 +255,43 @@ static int LLSEC_DIGEST_SHA256_init(void** native_id) {
     return return_code;
 }
 
+/*
+ * Specific sha-384 function
+ */
+static int LLSEC_DIGEST_SHA384_init(void** native_id) {
+    int return_code = LLSEC_SUCCESS;
+    LLSEC_DIGEST_DEBUG_TRACE("%s \n", __func__);
+
+    mbedtls_md_context_t* md_ctx = mbedtls_calloc(1, sizeof(mbedtls_md_context_t));
+    if (NULL == md_ctx) {
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code){
+        mbedtls_md_init(md_ctx);
+        int mbedtls_rc = mbedtls_md_setup(md_ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA384), 0);
+        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code){
+        int mbedtls_rc = mbedtls_md_starts(md_ctx);
+        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS != return_code) {
+        mbedtls_md_free(md_ctx);
+        mbedtls_free(md_ctx);
+    } else {
+        *native_id = md_ctx;
+    }
+
+    return return_code;
+}
+
 /*
  * Specific sha-512 function
  */
@@ -0,0 +1,149 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief MicroEJ Security low level API implementation for MbedTLS Library.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#include <LLSEC_mbedtls.h>
+
+#include <LLSEC_ERRORS.h>
+#include <LLSEC_KEY_AGREEMENT_impl.h>
+#include <LLSEC_configuration.h>
+#include <sni.h>
+#include <string.h>
+
+#include "mbedtls/version.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/bignum.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/ecdh.h"
+
+typedef struct {
+    char* name;
+    LLSEC_pub_key_type key_type; // Expected type of both keys
+} LLSEC_KEY_AGREEMENT_algorithm;
+
+// cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
+static LLSEC_KEY_AGREEMENT_algorithm supportedAlgorithms[3] = {
+    {
+        .name     = "X25519",
+        .key_type = TYPE_X25519
+    },
+    {
+        .name     = "XDH",
+        .key_type = TYPE_X25519
+    },
+    {
+        .name     = "ECDH",
+        .key_type = TYPE_ECDSA
+    }
+};
+
+int32_t LLSEC_KEY_AGREEMENT_IMPL_get_algorithm(uint8_t* algorithm_name) {
+    int32_t return_code = LLSEC_ERROR;
+    LLSEC_KEY_AGREEMENT_DEBUG_TRACE("%s \n", __func__);
+
+    int32_t nb_algorithms = sizeof(supportedAlgorithms) / sizeof(LLSEC_KEY_AGREEMENT_algorithm);
+    LLSEC_KEY_AGREEMENT_algorithm* algorithm = &supportedAlgorithms[0];
+
+    while (--nb_algorithms >= 0) {
+        if (strcmp((char*)algorithm_name, algorithm->name) == 0) {
+            break;
+        }
+        algorithm++;
+    }
+
+    if (0 <= nb_algorithms) {
+        return_code = (int32_t)algorithm;
+    }
+    return return_code;
+}
+
+int32_t LLSEC_KEY_AGREEMENT_IMPL_generate_secret(int32_t algorithm_id, int32_t private_key_id, int32_t public_key_id, uint8_t* secret, int32_t secret_length) {
+    LLSEC_KEY_AGREEMENT_DEBUG_TRACE("%s \n", __func__);
+
+    int32_t return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
+    LLSEC_KEY_AGREEMENT_algorithm* algorithm = (LLSEC_KEY_AGREEMENT_algorithm*)algorithm_id;
+    LLSEC_priv_key* private_key = (LLSEC_priv_key*)private_key_id;
+    LLSEC_pub_key* public_key = (LLSEC_pub_key*)public_key_id;
+    mbedtls_ecp_keypair* local = NULL;
+    mbedtls_ecp_keypair* peer = NULL;
+    mbedtls_ctr_drbg_context* ctr_drbg = NULL;
+    mbedtls_mpi z;
+    size_t z_length = 0;
+
+    mbedtls_mpi_init(&z);
+
+    if ((algorithm->key_type != private_key->type) || (algorithm->key_type != public_key->type)) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Invalid key type");
+        return_code = LLSEC_ERROR;
+    } else {
+        local = (mbedtls_ecp_keypair*)private_key->key;
+        peer = (mbedtls_ecp_keypair*)public_key->key;
+        if (local->LLSEC_MBEDTLS_PRIVATE(grp).id != peer->LLSEC_MBEDTLS_PRIVATE(grp).id) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Keys are not on the same curve");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        z_length = (local->LLSEC_MBEDTLS_PRIVATE(grp).pbits + 7U) / 8U;
+        if ((size_t)secret_length < z_length) {
+            (void)SNI_throwNativeException(J_BUFFER_ERROR, "Secret buffer is too small");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        /* Used for blinding (Weierstrass curves) and randomized projective coordinates (Montgomery curves) */
+        ctr_drbg = llsec_get_ctr_drbg();
+        if (NULL == ctr_drbg) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Random generator initialization failed");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        mbedtls_rc = mbedtls_ecdh_compute_shared(&local->LLSEC_MBEDTLS_PRIVATE(grp), &z, &peer->LLSEC_MBEDTLS_PRIVATE(Q),
+                                                 &local->LLSEC_MBEDTLS_PRIVATE(d), mbedtls_ctr_drbg_random, ctr_drbg);
+        LLSEC_KEY_AGREEMENT_DEBUG_TRACE("%s mbedtls_ecdh_compute_shared: %d\n", __func__, mbedtls_rc);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "Shared secret computation failed");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        if (TYPE_X25519 == algorithm->key_type) {
+            /* RFC 7748: reject the all-zero output produced by small order peer points */
+            if (0 == mbedtls_mpi_cmp_int(&z, 0)) {
+                mbedtls_rc = MBEDTLS_ERR_ECP_INVALID_KEY;
+            } else {
+                mbedtls_rc = mbedtls_mpi_write_binary_le(&z, secret, z_length);
+            }
+        } else {
+            mbedtls_rc = mbedtls_mpi_write_binary(&z, secret, z_length);
+        }
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "Shared secret encoding failed");
+            return_code = LLSEC_ERROR;
+        } else {
+            return_code = (int32_t)z_length;
+        }
+    }
+
+    mbedtls_mpi_free(&z);
+
+    LLSEC_KEY_AGREEMENT_DEBUG_TRACE("%s: return_code = %d\n", __func__, (int)return_code);
+    return return_code;
+}
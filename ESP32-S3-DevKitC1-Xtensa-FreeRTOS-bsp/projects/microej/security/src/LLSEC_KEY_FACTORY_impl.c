@@ -25,6 +25,7 @@
 #include "mbedtls/pk.h"
 #include "mbedtls/version.h"
 #include "mbedtls/ctr_drbg.h"
+#include "mbedtls/ecp.h"
 #include "mbedtls/entropy.h"
 
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
@@ -33,6 +34,33 @@ static const char* pkcs8_format = "PKCS#8";
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
 static const char* x509_format = "X.509";
 
+/*
+ * X25519 keys have a fixed size encoding (RFC 8410): the DER header is constant and followed by the raw key.
+ * AlgorithmIdentifier is id-X25519 (1.3.101.110) without parameters.
+ */
+// cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
+static const uint8_t x25519_pkcs8_header[LLSEC_X25519_PKCS8_KEY_SIZE - LLSEC_X25519_KEY_SIZE] = {
+    0x30, 0x2e, 0x02, 0x01, 0x00, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x6e, 0x04, 0x22, 0x04, 0x20
+};
+
+// cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
+static const uint8_t x25519_x509_header[LLSEC_X25519_X509_KEY_SIZE - LLSEC_X25519_KEY_SIZE] = {
+    0x30, 0x2a, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x6e, 0x03, 0x21, 0x00
+};
+
+/*
+ * Ed25519 keys are encoded the same way, with the id-Ed25519 (1.3.101.112) AlgorithmIdentifier.
+ */
+// cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
+static const uint8_t ed25519_pkcs8_header[LLSEC_ED25519_PKCS8_KEY_SIZE - LLSEC_ED25519_KEY_SIZE] = {
+    0x30, 0x2e, 0x02, 0x01, 0x00, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x70, 0x04, 0x22, 0x04, 0x20
+};
+
+// cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
+static const uint8_t ed25519_x509_header[LLSEC_ED25519_X509_KEY_SIZE - LLSEC_ED25519_KEY_SIZE] = {
+    0x30, 0x2a, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x70, 0x03, 0x21, 0x00
+};
+
 typedef int32_t (*LLSEC_KEY_FACTORY_get_private_key_data)(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length);
 typedef int32_t (*LLSEC_KEY_FACTORY_get_public_key_data)(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length);
 typedef void (*LLSEC_KEY_FACTORY_key_close)(void* native_id);
@@ -49,24 +77,54 @@ static int32_t LLSEC_KEY_FACTORY_RSA_mbedtls_get_private_key_data(LLSEC_priv_key
 static int32_t LLSEC_KEY_FACTORY_RSA_mbedtls_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length);
 static int32_t LLSEC_KEY_FACTORY_EC_mbedtls_get_private_key_data(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length);
 static int32_t LLSEC_KEY_FACTORY_EC_mbedtls_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length);
-static void LLSEC_KEY_FACTORY_mbedtls_private_key_close(void* native_id);
-static void LLSEC_KEY_FACTORY_mbedtls_public_key_close(void* native_id);
+static int32_t LLSEC_KEY_FACTORY_X25519_mbedtls_get_private_key_data(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length);
+static int32_t LLSEC_KEY_FACTORY_X25519_mbedtls_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length);
+static int32_t LLSEC_KEY_FACTORY_Ed25519_get_private_key_data(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length);
+static int32_t LLSEC_KEY_FACTORY_Ed25519_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length);
 
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
-static LLSEC_KEY_FACTORY_algorithm available_key_algorithms[2] = {
+static LLSEC_KEY_FACTORY_algorithm available_key_algorithms[6] = {
     {
         .name = "RSA",
         .get_private_key_data = LLSEC_KEY_FACTORY_RSA_mbedtls_get_private_key_data,
         .get_public_key_data  = LLSEC_KEY_FACTORY_RSA_mbedtls_get_public_key_data,
-        .private_key_close    = LLSEC_KEY_FACTORY_mbedtls_private_key_close,
-        .public_key_close     = LLSEC_KEY_FACTORY_mbedtls_public_key_close
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
     },
     {
         .name = "EC",
         .get_private_key_data = LLSEC_KEY_FACTORY_EC_mbedtls_get_private_key_data,
         .get_public_key_data  = LLSEC_KEY_FACTORY_EC_mbedtls_get_public_key_data,
-        .private_key_close    = LLSEC_KEY_FACTORY_mbedtls_private_key_close,
-        .public_key_close     = LLSEC_KEY_FACTORY_mbedtls_public_key_close
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
+    },
+    {
+        .name = "X25519",
+        .get_private_key_data = LLSEC_KEY_FACTORY_X25519_mbedtls_get_private_key_data,
+        .get_public_key_data  = LLSEC_KEY_FACTORY_X25519_mbedtls_get_public_key_data,
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
+    },
+    {
+        .name = "XDH",
+        .get_private_key_data = LLSEC_KEY_FACTORY_X25519_mbedtls_get_private_key_data,
+        .get_public_key_data  = LLSEC_KEY_FACTORY_X25519_mbedtls_get_public_key_data,
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
+    },
+    {
+        .name = "Ed25519",
+        .get_private_key_data = LLSEC_KEY_FACTORY_Ed25519_get_private_key_data,
+        .get_public_key_data  = LLSEC_KEY_FACTORY_Ed25519_get_public_key_data,
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
+    },
+    {
+        .name = "EdDSA",
+        .get_private_key_data = LLSEC_KEY_FACTORY_Ed25519_get_private_key_data,
+        .get_public_key_data  = LLSEC_KEY_FACTORY_Ed25519_get_public_key_data,
+        .private_key_close    = llsec_priv_key_close,
+        .public_key_close     = llsec_pub_key_close
     }
 };
 
@@ -121,7 +179,7 @@ static int32_t LLSEC_KEY_FACTORY_RSA_mbedtls_get_private_key_data(LLSEC_priv_key
     
     if(LLSEC_SUCCESS == return_code) {
         void* native_id = (void*)priv_key;
-        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)LLSEC_KEY_FACTORY_mbedtls_private_key_close, NULL)) {
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_priv_key_close, NULL)) {
             (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
             mbedtls_rsa_free((mbedtls_rsa_context*)priv_key->key);
             return_code = LLSEC_ERROR;
@@ -168,7 +226,7 @@ static int32_t LLSEC_KEY_FACTORY_RSA_mbedtls_get_public_key_data(LLSEC_pub_key*
 
     if(LLSEC_SUCCESS == return_code) {
         void* native_id = (void*)pub_key;
-        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)LLSEC_KEY_FACTORY_mbedtls_public_key_close, NULL)) {
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_pub_key_close, NULL)) {
             (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
             mbedtls_rsa_free((mbedtls_rsa_context*)pub_key->key);
             return_code = LLSEC_ERROR;
@@ -233,7 +291,7 @@ static int32_t LLSEC_KEY_FACTORY_EC_mbedtls_get_private_key_data(LLSEC_priv_key*
 
     if(LLSEC_SUCCESS == return_code) {
         void* native_id = (void*)priv_key;
-        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)LLSEC_KEY_FACTORY_mbedtls_private_key_close, NULL)) {
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_priv_key_close, NULL)) {
             (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
             mbedtls_ecdsa_free((mbedtls_ecdsa_context*)priv_key->key);
             return_code = LLSEC_ERROR;
@@ -280,7 +338,7 @@ static int32_t LLSEC_KEY_FACTORY_EC_mbedtls_get_public_key_data(LLSEC_pub_key* p
 
     if(LLSEC_SUCCESS == return_code) {
         void* native_id = (void*)pub_key;
-        if (SNI_registerResource(native_id, (SNI_closeFunction)LLSEC_KEY_FACTORY_mbedtls_public_key_close, NULL) != SNI_OK) {
+        if (SNI_registerResource(native_id, (SNI_closeFunction)llsec_pub_key_close, NULL) != SNI_OK) {
             (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
             mbedtls_ecdsa_free((mbedtls_ecdsa_context*)pub_key->key);
             return_code = LLSEC_ERROR;
@@ -295,28 +353,348 @@ static int32_t LLSEC_KEY_FACTORY_EC_mbedtls_get_public_key_data(LLSEC_pub_key* p
 
 }
 
-static void LLSEC_KEY_FACTORY_mbedtls_private_key_close(void* native_id) {
-    LLSEC_priv_key* key = (LLSEC_priv_key*)native_id;
+static int32_t LLSEC_KEY_FACTORY_X25519_mbedtls_get_private_key_data(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length) {
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (key = %p) \n", __func__, priv_key);
+
+    int return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
+    mbedtls_ecp_keypair* ctx = NULL;
+    /* Used for the randomized projective coordinates of the public point computation */
+    mbedtls_ctr_drbg_context* ctr_drbg = llsec_get_ctr_drbg();
+
+    priv_key->type = TYPE_X25519;
+
+    if (NULL == ctr_drbg) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Random generator initialization failed");
+        return_code = LLSEC_ERROR;
+    }
+
+    if ((LLSEC_SUCCESS == return_code) && ((LLSEC_X25519_PKCS8_KEY_SIZE != encoded_key_length) ||
+        (0 != memcmp(encoded_key, x25519_pkcs8_header, sizeof(x25519_pkcs8_header))))) {
+        LLSEC_KEY_FACTORY_DEBUG_TRACE("%s invalid X25519 PKCS#8 encoding\n", __func__);
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        ctx = (mbedtls_ecp_keypair*)mbedtls_calloc(1, sizeof(mbedtls_ecp_keypair));
+        if (NULL == ctx) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't allocate mbedtls_ecp_keypair structure");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        mbedtls_ecp_keypair_init(ctx);
+        mbedtls_rc = mbedtls_ecp_read_key(MBEDTLS_ECP_DP_CURVE25519, ctx, &encoded_key[sizeof(x25519_pkcs8_header)], LLSEC_X25519_KEY_SIZE);
+        if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+            /* Public point, needed for the encoding of the public key */
+            mbedtls_rc = mbedtls_ecp_mul(&ctx->LLSEC_MBEDTLS_PRIVATE(grp), &ctx->LLSEC_MBEDTLS_PRIVATE(Q), &ctx->LLSEC_MBEDTLS_PRIVATE(d),
+                                         &ctx->LLSEC_MBEDTLS_PRIVATE(grp).G, mbedtls_ctr_drbg_random, ctr_drbg);
+        }
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_ecp_read_key failed (rc = %d)\n", __func__, mbedtls_rc);
+            mbedtls_ecp_keypair_free(ctx);
+            mbedtls_free(ctx);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        priv_key->key = (char*)ctx;
+        void* native_id = (void*)priv_key;
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_priv_key_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            mbedtls_ecp_keypair_free(ctx);
+            mbedtls_free(ctx);
+            return_code = LLSEC_ERROR;
+        } else {
+            // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+            return_code = (int32_t)native_id;
+        }
+    }
+
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (rc = %d)\n", __func__, return_code);
+    return return_code;
+}
+
+static int32_t LLSEC_KEY_FACTORY_X25519_mbedtls_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length) {
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (key = %p) \n", __func__, pub_key);
+
+    int return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
+    mbedtls_ecp_keypair* ctx = NULL;
+
+    pub_key->type = TYPE_X25519;
+
+    if ((LLSEC_X25519_X509_KEY_SIZE != encoded_key_length) ||
+        (0 != memcmp(encoded_key, x25519_x509_header, sizeof(x25519_x509_header)))) {
+        LLSEC_KEY_FACTORY_DEBUG_TRACE("%s invalid X25519 X.509 encoding\n", __func__);
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        ctx = (mbedtls_ecp_keypair*)mbedtls_calloc(1, sizeof(mbedtls_ecp_keypair));
+        if (NULL == ctx) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't allocate mbedtls_ecp_keypair structure");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        mbedtls_ecp_keypair_init(ctx);
+        mbedtls_rc = mbedtls_ecp_group_load(&ctx->LLSEC_MBEDTLS_PRIVATE(grp), MBEDTLS_ECP_DP_CURVE25519);
+        if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+            mbedtls_rc = mbedtls_ecp_point_read_binary(&ctx->LLSEC_MBEDTLS_PRIVATE(grp), &ctx->LLSEC_MBEDTLS_PRIVATE(Q),
+                                                       &encoded_key[sizeof(x25519_x509_header)], LLSEC_X25519_KEY_SIZE);
+        }
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_ecp_point_read_binary failed (rc = %d)\n", __func__, mbedtls_rc);
+            mbedtls_ecp_keypair_free(ctx);
+            mbedtls_free(ctx);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        pub_key->key = (char*)ctx;
+        void* native_id = (void*)pub_key;
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_pub_key_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            mbedtls_ecp_keypair_free(ctx);
+            mbedtls_free(ctx);
+            return_code = LLSEC_ERROR;
+        } else {
+            // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+            return_code = (int32_t)native_id;
+        }
+    }
+
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (rc = %d)\n", __func__, return_code);
+    return return_code;
+}
+
+static int32_t LLSEC_KEY_FACTORY_Ed25519_get_private_key_data(LLSEC_priv_key* priv_key, uint8_t* encoded_key, int32_t encoded_key_length) {
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (key = %p) \n", __func__, priv_key);
+
+    int return_code = LLSEC_SUCCESS;
+    LLSEC_ed25519_key* key = NULL;
+
+    priv_key->type = TYPE_ED25519;
+
+    if ((LLSEC_ED25519_PKCS8_KEY_SIZE != encoded_key_length) ||
+        (0 != memcmp(encoded_key, ed25519_pkcs8_header, sizeof(ed25519_pkcs8_header)))) {
+        LLSEC_KEY_FACTORY_DEBUG_TRACE("%s invalid Ed25519 PKCS#8 encoding\n", __func__);
+        return_code = LLSEC_ERROR;
+    }
 
-    if (TYPE_RSA == key->type) {
-        mbedtls_rsa_free((mbedtls_rsa_context*)key->key);
+    if (LLSEC_SUCCESS == return_code) {
+        key = (LLSEC_ed25519_key*)mbedtls_calloc(1, sizeof(LLSEC_ed25519_key));
+        if (NULL == key) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't allocate LLSEC_ed25519_key structure");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        key->has_private_key = 1;
+        (void)memcpy(key->private_key, &encoded_key[sizeof(ed25519_pkcs8_header)], LLSEC_ED25519_KEY_SIZE);
+        /* Public key, needed for the signatures and the encoding of the public key */
+        if (0 != llsec_ed25519_public_key(key->public_key, key->private_key)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Ed25519 public key computation failed");
+            llsec_ed25519_key_free(key);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        priv_key->key = (char*)key;
+        void* native_id = (void*)priv_key;
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_priv_key_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            llsec_ed25519_key_free(key);
+            return_code = LLSEC_ERROR;
+        } else {
+            // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+            return_code = (int32_t)native_id;
+        }
+    }
+
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (rc = %d)\n", __func__, return_code);
+    return return_code;
+}
+
+static int32_t LLSEC_KEY_FACTORY_Ed25519_get_public_key_data(LLSEC_pub_key* pub_key, uint8_t* encoded_key, int32_t encoded_key_length) {
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (key = %p) \n", __func__, pub_key);
+
+    int return_code = LLSEC_SUCCESS;
+    LLSEC_ed25519_key* key = NULL;
+
+    pub_key->type = TYPE_ED25519;
+
+    if ((LLSEC_ED25519_X509_KEY_SIZE != encoded_key_length) ||
+        (0 != memcmp(encoded_key, ed25519_x509_header, sizeof(ed25519_x509_header)))) {
+        LLSEC_KEY_FACTORY_DEBUG_TRACE("%s invalid Ed25519 X.509 encoding\n", __func__);
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        key = (LLSEC_ed25519_key*)mbedtls_calloc(1, sizeof(LLSEC_ed25519_key));
+        if (NULL == key) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't allocate LLSEC_ed25519_key structure");
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        /* The point is decoded (and rejected if invalid) by the signature verification */
+        (void)memcpy(key->public_key, &encoded_key[sizeof(ed25519_x509_header)], LLSEC_ED25519_KEY_SIZE);
+        pub_key->key = (char*)key;
+        void* native_id = (void*)pub_key;
+        if (SNI_OK != SNI_registerResource(native_id, (SNI_closeFunction)llsec_pub_key_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            llsec_ed25519_key_free(key);
+            return_code = LLSEC_ERROR;
+        } else {
+            // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+            return_code = (int32_t)native_id;
+        }
+    }
+
+    LLSEC_KEY_FACTORY_DEBUG_TRACE("%s (rc = %d)\n", __func__, return_code);
+    return return_code;
+}
+
+/**
+ * @brief Writes a X25519 private key to its PKCS#8 DER structure (RFC 8410).
+ *
+ * @return the number of bytes written, or a negative mbedTLS error code.
+ */
+int llsec_x25519_write_private_key_der(mbedtls_ecp_keypair* key, uint8_t* output, int32_t output_length) {
+    int return_code = LLSEC_X25519_PKCS8_KEY_SIZE;
+    if (LLSEC_X25519_PKCS8_KEY_SIZE > output_length) {
+        return_code = MBEDTLS_ERR_ECP_BUFFER_TOO_SMALL;
+    } else {
+        (void)memcpy(output, x25519_pkcs8_header, sizeof(x25519_pkcs8_header));
+        /* X25519 scalars are encoded in little-endian order */
+        int mbedtls_rc = mbedtls_mpi_write_binary_le(&key->LLSEC_MBEDTLS_PRIVATE(d), &output[sizeof(x25519_pkcs8_header)], LLSEC_X25519_KEY_SIZE);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            return_code = mbedtls_rc;
+        }
+    }
+    return return_code;
+}
+
+/**
+ * @brief Writes a X25519 public key to its X.509 SubjectPublicKeyInfo DER structure (RFC 8410).
+ *
+ * @return the number of bytes written, or a negative mbedTLS error code.
+ */
+int llsec_x25519_write_public_key_der(mbedtls_ecp_keypair* key, uint8_t* output, int32_t output_length) {
+    int return_code = LLSEC_X25519_X509_KEY_SIZE;
+    if (LLSEC_X25519_X509_KEY_SIZE > output_length) {
+        return_code = MBEDTLS_ERR_ECP_BUFFER_TOO_SMALL;
+    } else {
+        size_t olen = 0;
+        (void)memcpy(output, x25519_x509_header, sizeof(x25519_x509_header));
+        int mbedtls_rc = mbedtls_ecp_point_write_binary(&key->LLSEC_MBEDTLS_PRIVATE(grp), &key->LLSEC_MBEDTLS_PRIVATE(Q), MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                                        &olen, &output[sizeof(x25519_x509_header)], LLSEC_X25519_KEY_SIZE);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            return_code = mbedtls_rc;
+        }
+    }
+    return return_code;
+}
+
+/**
+ * @brief Writes an Ed25519 private key to its PKCS#8 DER structure (RFC 8410).
+ *
+ * @return the number of bytes written, or a negative mbedTLS error code.
+ */
+int llsec_ed25519_write_private_key_der(const LLSEC_ed25519_key* key, uint8_t* output, int32_t output_length) {
+    int return_code = LLSEC_ED25519_PKCS8_KEY_SIZE;
+    if ((LLSEC_ED25519_PKCS8_KEY_SIZE > output_length) || (0 == key->has_private_key)) {
+        return_code = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
     } else {
-        mbedtls_ecdsa_free((mbedtls_ecdsa_context*)key->key);
+        (void)memcpy(output, ed25519_pkcs8_header, sizeof(ed25519_pkcs8_header));
+        (void)memcpy(&output[sizeof(ed25519_pkcs8_header)], key->private_key, LLSEC_ED25519_KEY_SIZE);
     }
-    if(NULL != key){
+    return return_code;
+}
+
+/**
+ * @brief Writes an Ed25519 public key to its X.509 SubjectPublicKeyInfo DER structure (RFC 8410).
+ *
+ * @return the number of bytes written, or a negative mbedTLS error code.
+ */
+int llsec_ed25519_write_public_key_der(const LLSEC_ed25519_key* key, uint8_t* output, int32_t output_length) {
+    int return_code = LLSEC_ED25519_X509_KEY_SIZE;
+    if (LLSEC_ED25519_X509_KEY_SIZE > output_length) {
+        return_code = MBEDTLS_ERR_ECP_BUFFER_TOO_SMALL;
+    } else {
+        (void)memcpy(output, ed25519_x509_header, sizeof(ed25519_x509_header));
+        (void)memcpy(&output[sizeof(ed25519_x509_header)], key->public_key, LLSEC_ED25519_KEY_SIZE);
+    }
+    return return_code;
+}
+
+static void llsec_key_free(LLSEC_pub_key_type type, char* key) {
+    if (TYPE_RSA == type) {
+        mbedtls_rsa_free((mbedtls_rsa_context*)key);
+    } else if (TYPE_ED25519 == type) {
+        llsec_ed25519_key_free((LLSEC_ed25519_key*)key);
+    } else {
+        mbedtls_ecdsa_free((mbedtls_ecdsa_context*)key);
+    }
+}
+
+/*
+ * The SNI resource of a key may be closed while a cipher still uses the key context: the key is then only marked as
+ * closed and the last llsec_*_key_release() frees it.
+ */
+void llsec_priv_key_close(void* native_id) {
+    LLSEC_priv_key* key = (LLSEC_priv_key*)native_id;
+
+    if (NULL != key) {
+        key->closed = 1;
+        if (0U == key->references) {
+            llsec_key_free(key->type, key->key);
+            mbedtls_free(key);
+        }
+    }
+}
+
+void llsec_priv_key_retain(LLSEC_priv_key* key) {
+    key->references++;
+}
+
+void llsec_priv_key_release(LLSEC_priv_key* key) {
+    key->references--;
+    if ((0U == key->references) && ((uint8_t)0 != key->closed)) {
+        llsec_key_free(key->type, key->key);
         mbedtls_free(key);
     }
 }
 
-static void LLSEC_KEY_FACTORY_mbedtls_public_key_close(void* native_id) {
+void llsec_pub_key_close(void* native_id) {
     LLSEC_pub_key* key = (LLSEC_pub_key*)native_id;
 
-    if (TYPE_RSA == key->type) {
-        mbedtls_rsa_free((mbedtls_rsa_context*)key->key);
-    } else {
-        mbedtls_ecdsa_free((mbedtls_ecdsa_context*)key->key);
+    if (NULL != key) {
+        key->closed = 1;
+        if (0U == key->references) {
+            llsec_key_free(key->type, key->key);
+            mbedtls_free(key);
+        }
     }
-    if(NULL != key){
+}
+
+void llsec_pub_key_retain(LLSEC_pub_key* key) {
+    key->references++;
+}
+
+void llsec_pub_key_release(LLSEC_pub_key* key) {
+    key->references--;
+    if ((0U == key->references) && ((uint8_t)0 != key->closed)) {
+        llsec_key_free(key->type, key->key);
         mbedtls_free(key);
     }
 }
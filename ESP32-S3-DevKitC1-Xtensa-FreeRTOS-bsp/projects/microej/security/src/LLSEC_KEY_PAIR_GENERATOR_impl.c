@@ -38,6 +38,12 @@ static int32_t LLSEC_KEY_PAIR_GENERATOR_RSA_mbedtls_generateKeyPair(int32_t rsa_
 //EC
 static int32_t LLSEC_KEY_PAIR_GENERATOR_EC_mbedtls_generateKeyPair(uint8_t* ec_curve_stdname);
 
+//X25519
+static int32_t LLSEC_KEY_PAIR_GENERATOR_X25519_mbedtls_generateKeyPair(void);
+
+//Ed25519
+static int32_t LLSEC_KEY_PAIR_GENERATOR_Ed25519_generateKeyPair(void);
+
 //common
 static void LLSEC_KEY_PAIR_GENERATOR_mbedtls_close(void* native_id);
 
@@ -47,7 +53,7 @@ typedef struct {
 } LLSEC_KEY_PAIR_GENERATOR_algorithm;
 
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
-static LLSEC_KEY_PAIR_GENERATOR_algorithm supportedAlgorithms[2] = {
+static LLSEC_KEY_PAIR_GENERATOR_algorithm supportedAlgorithms[6] = {
     {
         .name  = "RSA",
         .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
@@ -55,6 +61,22 @@ static LLSEC_KEY_PAIR_GENERATOR_algorithm supportedAlgorithms[2] = {
     {
         .name  = "EC",
         .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
+    },
+    {
+        .name  = "X25519",
+        .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
+    },
+    {
+        .name  = "XDH",
+        .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
+    },
+    {
+        .name  = "Ed25519",
+        .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
+    },
+    {
+        .name  = "EdDSA",
+        .close = LLSEC_KEY_PAIR_GENERATOR_mbedtls_close
     }
 
 };
@@ -211,17 +233,147 @@ static int32_t LLSEC_KEY_PAIR_GENERATOR_EC_mbedtls_generateKeyPair(uint8_t* ec_c
     return return_code;
 }
 
-static void LLSEC_KEY_PAIR_GENERATOR_mbedtls_close(void* native_id) {
-    LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s \n", __func__);
+static int32_t LLSEC_KEY_PAIR_GENERATOR_X25519_mbedtls_generateKeyPair(void) {
+    LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s\n", __func__);
+
+    int return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
+    mbedtls_ecp_keypair* ctx = mbedtls_calloc(1, sizeof(mbedtls_ecp_keypair));
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+    const char* pers = llsec_gen_random_str_internal(8);
+    LLSEC_priv_key* key = NULL;
+    void* native_id = NULL;
+
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&ctr_drbg);
+
+    if ((NULL == ctx) || (NULL == pers)) {
+        LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s allocation error\n", __func__);
+        return_code = LLSEC_ERROR;
+    } else {
+        mbedtls_ecp_keypair_init(ctx);
+        mbedtls_rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const uint8_t*)pers, strlen(pers));
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed (rc = %d)\n", __func__, mbedtls_rc);
+            mbedtls_ecp_keypair_free(ctx);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        /* Generate X25519 key pair (RFC 7748) */
+        mbedtls_rc = mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_CURVE25519, ctx, mbedtls_ctr_drbg_random, &ctr_drbg);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s mbedtls_ecp_gen_key (rc = %d)\n", __func__, mbedtls_rc);
+            mbedtls_ecp_keypair_free(ctx);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        key = (LLSEC_priv_key*)mbedtls_calloc(1, sizeof(LLSEC_priv_key));
+        if (NULL == key) {
+            LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s mbedtls_calloc error\n", __func__);
+            mbedtls_ecp_keypair_free(ctx);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        key->key = (char*)ctx;
+        key->type = TYPE_X25519;
+
+        // Register the key to be managed by SNI as a native resource.
+        // the close callback when be called when the key is collected by the GC
+        // The key is freed in the close callback
+        native_id = (void*)key;
+        if (SNI_OK != SNI_registerResource(native_id, LLSEC_KEY_PAIR_GENERATOR_mbedtls_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            mbedtls_ecp_keypair_free(ctx);
+            mbedtls_free(key);
+            return_code = LLSEC_ERROR;
+        }
+    }
 
-    LLSEC_priv_key* key = (LLSEC_priv_key*)native_id;
+    mbedtls_ctr_drbg_free(&ctr_drbg);
+    mbedtls_entropy_free(&entropy);
+    // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
+    mbedtls_free((void*)pers);
 
-    if (TYPE_RSA == key->type) {
-        mbedtls_rsa_free((mbedtls_rsa_context*)key->key);
+    if (LLSEC_SUCCESS == return_code) {
+        // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+        return_code = (uint32_t)native_id;
     } else {
-        mbedtls_ecdsa_free((mbedtls_ecdsa_context*)key->key);
+        mbedtls_free(ctx);
+    }
+
+    return return_code;
+}
+
+static int32_t LLSEC_KEY_PAIR_GENERATOR_Ed25519_generateKeyPair(void) {
+    LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s\n", __func__);
+
+    int return_code = LLSEC_SUCCESS;
+    LLSEC_ed25519_key* ctx = (LLSEC_ed25519_key*)mbedtls_calloc(1, sizeof(LLSEC_ed25519_key));
+    mbedtls_ctr_drbg_context* ctr_drbg = llsec_get_ctr_drbg();
+    LLSEC_priv_key* key = NULL;
+    void* native_id = NULL;
+
+    if ((NULL == ctx) || (NULL == ctr_drbg)) {
+        LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s allocation error\n", __func__);
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        /* Generate Ed25519 key pair (RFC 8032 section 5.1.5): the private key is a random seed */
+        ctx->has_private_key = 1;
+        int mbedtls_rc = mbedtls_ctr_drbg_random(ctr_drbg, ctx->private_key, LLSEC_ED25519_KEY_SIZE);
+        if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+            mbedtls_rc = llsec_ed25519_public_key(ctx->public_key, ctx->private_key);
+        }
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s key generation (rc = %d)\n", __func__, mbedtls_rc);
+            return_code = LLSEC_ERROR;
+        }
     }
-    mbedtls_free(key);
+
+    if (LLSEC_SUCCESS == return_code) {
+        key = (LLSEC_priv_key*)mbedtls_calloc(1, sizeof(LLSEC_priv_key));
+        if (NULL == key) {
+            LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s mbedtls_calloc error\n", __func__);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        key->key = (char*)ctx;
+        key->type = TYPE_ED25519;
+
+        // Register the key to be managed by SNI as a native resource.
+        // The key is freed in the close callback
+        native_id = (void*)key;
+        if (SNI_OK != SNI_registerResource(native_id, LLSEC_KEY_PAIR_GENERATOR_mbedtls_close, NULL)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            mbedtls_free(key);
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+        return_code = (uint32_t)native_id;
+    } else {
+        llsec_ed25519_key_free(ctx);
+    }
+
+    return return_code;
+}
+
+static void LLSEC_KEY_PAIR_GENERATOR_mbedtls_close(void* native_id) {
+    LLSEC_KEY_PAIR_GENERATOR_DEBUG_TRACE("%s \n", __func__);
+
+    llsec_priv_key_close(native_id);
 }
 
 int32_t LLSEC_KEY_PAIR_GENERATOR_IMPL_get_algorithm(uint8_t* algorithm_name) {
@@ -253,6 +405,10 @@ int32_t LLSEC_KEY_PAIR_GENERATOR_IMPL_generateKeyPair(int32_t algorithm_id, int3
         return_code = LLSEC_KEY_PAIR_GENERATOR_RSA_mbedtls_generateKeyPair(rsa_key_size, rsa_public_exponent);
     } else if (0 == strcmp(algorithm->name, "EC")) {
         return_code = LLSEC_KEY_PAIR_GENERATOR_EC_mbedtls_generateKeyPair(ec_curve_stdname);
+    } else if ((0 == strcmp(algorithm->name, "X25519")) || (0 == strcmp(algorithm->name, "XDH"))) {
+        return_code = LLSEC_KEY_PAIR_GENERATOR_X25519_mbedtls_generateKeyPair();
+    } else if ((0 == strcmp(algorithm->name, "Ed25519")) || (0 == strcmp(algorithm->name, "EdDSA"))) {
+        return_code = LLSEC_KEY_PAIR_GENERATOR_Ed25519_generateKeyPair();
     } else{
         // Algorithm not found error.
         // this should never happen because the algorithm_id is a valid algorithm at this level.
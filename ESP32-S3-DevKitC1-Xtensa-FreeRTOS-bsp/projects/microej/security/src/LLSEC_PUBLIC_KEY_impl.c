@@ -66,39 +66,47 @@ int32_t LLSEC_PUBLIC_KEY_IMPL_get_encoded_max_size(int32_t native_id) {
     int return_code = LLSEC_ERROR;
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
-    mbedtls_pk_context pk;
-    mbedtls_pk_type_t pk_type;
-
-    if (TYPE_RSA == key->type) {
-        pk_type = MBEDTLS_PK_RSA;
+    if (TYPE_X25519 == key->type) {
+        /* Fixed size SubjectPublicKeyInfo encoding, see llsec_x25519_write_public_key_der() */
+        return_code = LLSEC_X25519_X509_KEY_SIZE;
+    } else if (TYPE_ED25519 == key->type) {
+        /* Fixed size SubjectPublicKeyInfo encoding, see llsec_ed25519_write_public_key_der() */
+        return_code = LLSEC_ED25519_X509_KEY_SIZE;
     } else {
-        pk_type = MBEDTLS_PK_ECKEY;
-    }
+        mbedtls_pk_context pk;
+        mbedtls_pk_type_t pk_type;
 
-    mbedtls_pk_init(&pk);
+        if (TYPE_RSA == key->type) {
+            pk_type = MBEDTLS_PK_RSA;
+        } else {
+            pk_type = MBEDTLS_PK_ECKEY;
+        }
 
-    mbedtls_pk_info_t info;
-    (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
-    info.ctx_alloc_func = pub_ctx_alloc_func;
-    info.ctx_free_func = pub_ctx_free_func;
+        mbedtls_pk_init(&pk);
 
-    pub_pk_ctx = (void*)key->key;
+        mbedtls_pk_info_t info;
+        (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
+        info.ctx_alloc_func = pub_ctx_alloc_func;
+        info.ctx_free_func = pub_ctx_free_func;
 
-    mbedtls_rc = mbedtls_pk_setup(&pk, &info);
-    if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-        (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
-    } else {
-        char buf_local[LLSEC_PUBLIC_KEY_LOCAL_BUFFER_SIZE];
-        /*
-         * Write a public key to a SubjectPublicKeyInfo DER structure.
-         * mbedtls_pk_write_pubkey_der() API will write data at the end of the buffer, not at the beginning, so instead of getting the encoded max size (mbedTLS v3.x has macros, mbedTLS v2.x doesn't), get the encoded fixed size.
-         * LLSEC_PUBLIC_KEY_IMPL_get_encode() will then work straightforward with a fixed size and not a max size.
-         */
-        int length = mbedtls_pk_write_pubkey_der(&pk, (unsigned char*)(&buf_local), sizeof(buf_local));
-        if (0 > length) {
-            (void)SNI_throwNativeException(-length, "Encoded key max size get failed");
+        pub_pk_ctx = (void*)key->key;
+
+        mbedtls_rc = mbedtls_pk_setup(&pk, &info);
+        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
         } else {
-            return_code = length;
+            char buf_local[LLSEC_PUBLIC_KEY_LOCAL_BUFFER_SIZE];
+            /*
+             * Write a public key to a SubjectPublicKeyInfo DER structure.
+             * mbedtls_pk_write_pubkey_der() API will write data at the end of the buffer, not at the beginning, so instead of getting the encoded max size (mbedTLS v3.x has macros, mbedTLS v2.x doesn't), get the encoded fixed size.
+             * LLSEC_PUBLIC_KEY_IMPL_get_encode() will then work straightforward with a fixed size and not a max size.
+             */
+            int length = mbedtls_pk_write_pubkey_der(&pk, (unsigned char*)(&buf_local), sizeof(buf_local));
+            if (0 > length) {
+                (void)SNI_throwNativeException(-length, "Encoded key max size get failed");
+            } else {
+                return_code = length;
+            }
         }
     }
 
@@ -122,34 +130,50 @@ int32_t LLSEC_PUBLIC_KEY_IMPL_get_encode(int32_t native_id, uint8_t* output, int
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
     LLSEC_pub_key* key = (LLSEC_pub_key*)native_id;
-    mbedtls_pk_context pk;
-    mbedtls_pk_type_t pk_type;
-
-    if (TYPE_RSA == key->type) {
-        pk_type = MBEDTLS_PK_RSA;
+    if (TYPE_X25519 == key->type) {
+        int length = llsec_x25519_write_public_key_der((mbedtls_ecp_keypair*)key->key, output, outputLength);
+        if (0 > length) {
+            (void)SNI_throwNativeException(-length, "Public key encoding failed");
+        } else {
+            return_code = length;
+        }
+    } else if (TYPE_ED25519 == key->type) {
+        int length = llsec_ed25519_write_public_key_der((LLSEC_ed25519_key*)key->key, output, outputLength);
+        if (0 > length) {
+            (void)SNI_throwNativeException(-length, "Public key encoding failed");
+        } else {
+            return_code = length;
+        }
     } else {
-        pk_type = MBEDTLS_PK_ECKEY;
-    }
+        mbedtls_pk_context pk;
+        mbedtls_pk_type_t pk_type;
 
-    mbedtls_pk_init(&pk);
+        if (TYPE_RSA == key->type) {
+            pk_type = MBEDTLS_PK_RSA;
+        } else {
+            pk_type = MBEDTLS_PK_ECKEY;
+        }
 
-    mbedtls_pk_info_t info;
-    (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
-    info.ctx_alloc_func = pub_ctx_alloc_func;
-    info.ctx_free_func = pub_ctx_free_func;
+        mbedtls_pk_init(&pk);
 
-    pub_pk_ctx = (void*)key->key;
+        mbedtls_pk_info_t info;
+        (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
+        info.ctx_alloc_func = pub_ctx_alloc_func;
+        info.ctx_free_func = pub_ctx_free_func;
 
-    mbedtls_rc = mbedtls_pk_setup(&pk, &info);
-    if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-        (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
-    } else {
-        /* Write a public key to a SubjectPublicKeyInfo DER structure */
-        int length = mbedtls_pk_write_pubkey_der(&pk, output, outputLength);
-        if (0 > length) {
-            (void)SNI_throwNativeException(-length, "Public key encoding failed");
+        pub_pk_ctx = (void*)key->key;
+
+        mbedtls_rc = mbedtls_pk_setup(&pk, &info);
+        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
         } else {
-            return_code = length;
+            /* Write a public key to a SubjectPublicKeyInfo DER structure */
+            int length = mbedtls_pk_write_pubkey_der(&pk, output, outputLength);
+            if (0 > length) {
+                (void)SNI_throwNativeException(-length, "Public key encoding failed");
+            } else {
+                return_code = length;
+            }
         }
     }
 
@@ -172,29 +196,35 @@ int32_t LLSEC_PUBLIC_KEY_IMPL_get_output_size(int32_t native_id) {
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
     LLSEC_pub_key* key = (LLSEC_pub_key*)native_id;
-    mbedtls_pk_context pk;
-    mbedtls_pk_type_t pk_type;
-
-    if (TYPE_RSA == key->type) {
-        pk_type = MBEDTLS_PK_RSA;
+    if (TYPE_X25519 == key->type) {
+        return_code = LLSEC_X25519_KEY_SIZE;
+    } else if (TYPE_ED25519 == key->type) {
+        return_code = LLSEC_ED25519_SIGNATURE_SIZE;
     } else {
-        pk_type = MBEDTLS_PK_ECKEY;
-    }
+        mbedtls_pk_context pk;
+        mbedtls_pk_type_t pk_type;
+
+        if (TYPE_RSA == key->type) {
+            pk_type = MBEDTLS_PK_RSA;
+        } else {
+            pk_type = MBEDTLS_PK_ECKEY;
+        }
 
-    mbedtls_pk_init(&pk);
+        mbedtls_pk_init(&pk);
 
-    mbedtls_pk_info_t info;
-    (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
-    info.ctx_alloc_func = pub_ctx_alloc_func;
-    info.ctx_free_func = pub_ctx_free_func;
+        mbedtls_pk_info_t info;
+        (void)memcpy(&info, mbedtls_pk_info_from_type(pk_type), sizeof(mbedtls_pk_info_t));
+        info.ctx_alloc_func = pub_ctx_alloc_func;
+        info.ctx_free_func = pub_ctx_free_func;
 
-    pub_pk_ctx = (void*)key->key;
+        pub_pk_ctx = (void*)key->key;
 
-    mbedtls_rc = mbedtls_pk_setup(&pk, &info);
-    if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-        (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
-    } else {
-        return_code = mbedtls_pk_get_bitlen(&pk) / 8;
+        mbedtls_rc = mbedtls_pk_setup(&pk, &info);
+        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "Public key context setup failed");
+        } else {
+            return_code = mbedtls_pk_get_bitlen(&pk) / 8;
+        }
     }
 
     return return_code;
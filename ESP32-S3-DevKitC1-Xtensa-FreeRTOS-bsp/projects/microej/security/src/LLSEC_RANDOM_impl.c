@@ -236,3 +236,45 @@ char* llsec_gen_random_str_internal(int length) {
 
     return return_code;
 }
+
+/**
+ * @brief Returns the random generator shared by the security natives for blinding and padding.
+ *
+ * The generator is seeded once, on first use, and then kept for the lifetime of the application: seeding a new
+ * generator for every operation costs more than the operation itself for EC keys. It is distinct from the
+ * generator of LLSEC_RANDOM_IMPL_next_bytes() so that LLSEC_RANDOM_IMPL_set_seed() does not affect it.
+ * Only accessed from SNI natives, i.e. from the MicroEJ VM task: no locking required.
+ *
+ * @return the random generator, or NULL if it can't be seeded.
+ */
+mbedtls_ctr_drbg_context* llsec_get_ctr_drbg(void) {
+    static mbedtls_entropy_context internal_entropy;
+    static mbedtls_ctr_drbg_context internal_ctr_drbg;
+    static int internal_initialized = 0;
+    mbedtls_ctr_drbg_context* return_code = NULL;
+
+    if (0 == internal_initialized) {
+        const char* pers = llsec_gen_random_str_internal(8);
+        if(NULL == pers) {
+            LLSEC_RANDOM_DEBUG_TRACE("%s llsec_gen_random_str_internal: allocation error\n", __func__);
+        } else {
+            mbedtls_entropy_init(&internal_entropy);
+            mbedtls_ctr_drbg_init(&internal_ctr_drbg);
+            int mbedtls_rc = mbedtls_ctr_drbg_seed(&internal_ctr_drbg, mbedtls_entropy_func, &internal_entropy, (const unsigned char*)pers, strlen(pers));
+            LLSEC_RANDOM_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed: %d\n", __func__, mbedtls_rc);
+            if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+                mbedtls_ctr_drbg_free(&internal_ctr_drbg);
+                mbedtls_entropy_free(&internal_entropy);
+            } else {
+                internal_initialized = 1;
+            }
+            // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
+            mbedtls_free((void*)pers);
+        }
+    }
+
+    if (0 != internal_initialized) {
+        return_code = &internal_ctr_drbg;
+    }
+    return return_code;
+}
@@ -25,7 +25,6 @@
 
 #include "mbedtls/version.h"
 #include "mbedtls/ctr_drbg.h"
-#include "mbedtls/entropy.h"
 #include "mbedtls/rsa.h"
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
@@ -47,16 +46,25 @@ typedef struct {
     LLSEC_RSA_CIPHER_transformation_desc description;
 } LLSEC_RSA_CIPHER_transformation;
 
+/*
+ * The cipher works on the RSA context of the key: copying it would drop the blinding values the key context already
+ * computed. The key is retained until the cipher is closed, see llsec_priv_key_retain(), and the padding of the cipher
+ * is set before each operation since signatures and other ciphers may change the padding of the same key context.
+ */
 typedef struct {
     LLSEC_RSA_CIPHER_transformation* transformation;
-    mbedtls_rsa_context mbedtls_ctx;
-    mbedtls_ctr_drbg_context ctr_drbg;
+    uint8_t is_decrypting;
+    void* key; // LLSEC_priv_key when decrypting, LLSEC_pub_key otherwise
+    mbedtls_rsa_context* mbedtls_ctx;
+    int padding;
+    mbedtls_md_type_t hash_id;
 } LLSEC_RSA_CIPHER_ctx;
 
 static int32_t llsec_rsa_cipher_init(int32_t transformation_id, void** native_id, uint8_t is_decrypting, int32_t key_id, int32_t padding_type, int32_t oaep_hash_algorithm);
 static int32_t llsec_rsa_cipher_decrypt(void* native_id, uint8_t* buffer, int32_t buffer_length, uint8_t* output);
 static int32_t llsec_rsa_cipher_encrypt(void* native_id, uint8_t* buffer, int32_t buffer_length, uint8_t* output);
 static void llsec_rsa_cipher_close(void* native_id);
+static int llsec_rsa_cipher_set_padding(LLSEC_RSA_CIPHER_ctx* cipher_ctx);
 
 // cppcheck-suppress misra-c2012-5.9 // Define here for code readability even if it called once in this file.
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
@@ -98,51 +106,41 @@ static LLSEC_RSA_CIPHER_transformation available_transformations[3] = {
 
 static int32_t llsec_rsa_cipher_init(int32_t transformation_id, void** native_id, uint8_t is_decrypting, int32_t key_id, int32_t padding_type, int32_t oaep_hash_algorithm) {
     int return_code = LLSEC_SUCCESS;
-    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
-    mbedtls_rsa_context* key_ctx = NULL;
     LLSEC_RSA_CIPHER_ctx* cipher_ctx;
     LLSEC_RSA_CIPHER_DEBUG_TRACE("%s\n", __func__);
 
     cipher_ctx = LLSEC_calloc(1, (int32_t)sizeof(LLSEC_RSA_CIPHER_ctx));
-    cipher_ctx->transformation = (LLSEC_RSA_CIPHER_transformation*) transformation_id;
-
-    if ((uint8_t)0 != is_decrypting) {
-        LLSEC_priv_key* key = (LLSEC_priv_key*)key_id;
-        key_ctx = (mbedtls_rsa_context*)key->key;
-    } else {
-        LLSEC_pub_key* key = (LLSEC_pub_key*)key_id;
-        key_ctx = (mbedtls_rsa_context*)key->key;
-    }
-
-    mbedtls_rc = mbedtls_rsa_copy(&cipher_ctx->mbedtls_ctx, key_ctx);
-    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
-        int32_t padding = (padding_type == PAD_PKCS1_TYPE) ? MBEDTLS_RSA_PKCS_V15 : MBEDTLS_RSA_PKCS_V21;
-        int32_t hash_id = (oaep_hash_algorithm == OAEP_HASH_SHA_1_ALGORITHM) ? MBEDTLS_MD_SHA1 : MBEDTLS_MD_SHA256;
-        mbedtls_rsa_set_padding(&cipher_ctx->mbedtls_ctx, padding, hash_id);
-    } else {
-        mbedtls_rsa_free(&cipher_ctx->mbedtls_ctx);
-        (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_rsa_copy failed");
+    if (NULL == cipher_ctx) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "LLSEC_calloc failed");
         return_code = LLSEC_ERROR;
     }
 
     if (LLSEC_SUCCESS == return_code) {
-        mbedtls_entropy_context entropy;
-        const char* pers = llsec_gen_random_str_internal(8);
-
-        mbedtls_entropy_init(&entropy);
-        mbedtls_ctr_drbg_init(&cipher_ctx->ctr_drbg);
-
-        mbedtls_rc = mbedtls_ctr_drbg_seed(&cipher_ctx->ctr_drbg, mbedtls_entropy_func, &entropy, (const uint8_t*)pers, strlen(pers));
-        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            mbedtls_ctr_drbg_free(&cipher_ctx->ctr_drbg);
-            mbedtls_entropy_free(&entropy);
-            // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature 
-            mbedtls_free((void*)pers);
-            (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_ctr_drbg_seed failed");
+        if (NULL == llsec_get_ctr_drbg()) {
+            LLSEC_free(cipher_ctx);
+            (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_ctr_drbg_seed failed");
             return_code = LLSEC_ERROR;
         }
     }
 
+    if (LLSEC_SUCCESS == return_code) {
+        cipher_ctx->transformation = (LLSEC_RSA_CIPHER_transformation*) transformation_id;
+        cipher_ctx->is_decrypting = is_decrypting;
+        cipher_ctx->padding = (padding_type == PAD_PKCS1_TYPE) ? MBEDTLS_RSA_PKCS_V15 : MBEDTLS_RSA_PKCS_V21;
+        cipher_ctx->hash_id = (oaep_hash_algorithm == OAEP_HASH_SHA_1_ALGORITHM) ? MBEDTLS_MD_SHA1 : MBEDTLS_MD_SHA256;
+        if ((uint8_t)0 != is_decrypting) {
+            LLSEC_priv_key* key = (LLSEC_priv_key*)key_id;
+            llsec_priv_key_retain(key);
+            cipher_ctx->key = key;
+            cipher_ctx->mbedtls_ctx = (mbedtls_rsa_context*)key->key;
+        } else {
+            LLSEC_pub_key* key = (LLSEC_pub_key*)key_id;
+            llsec_pub_key_retain(key);
+            cipher_ctx->key = key;
+            cipher_ctx->mbedtls_ctx = (mbedtls_rsa_context*)key->key;
+        }
+    }
+
     if (LLSEC_SUCCESS == return_code) {
         *native_id = cipher_ctx;
     }
@@ -157,13 +155,16 @@ static int32_t llsec_rsa_cipher_decrypt(void* native_id, uint8_t* buffer, int32_
 
     size_t out_len = 0;
     int32_t return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = llsec_rsa_cipher_set_padding(cipher_ctx);
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
 #if (MBEDTLS_VERSION_MAJOR == 2)
-    int mbedtls_rc = mbedtls_rsa_pkcs1_decrypt(&cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, &cipher_ctx->ctr_drbg, MBEDTLS_RSA_PRIVATE, &out_len, buffer, output, mbedtls_rsa_get_len(&cipher_ctx->mbedtls_ctx));
+        mbedtls_rc = mbedtls_rsa_pkcs1_decrypt(cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, llsec_get_ctr_drbg(), MBEDTLS_RSA_PRIVATE, &out_len, buffer, output, mbedtls_rsa_get_len(cipher_ctx->mbedtls_ctx));
 #elif (MBEDTLS_VERSION_MAJOR == 3)
-    int mbedtls_rc = mbedtls_rsa_pkcs1_decrypt(&cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, &cipher_ctx->ctr_drbg, &out_len, buffer, output, mbedtls_rsa_get_len(&cipher_ctx->mbedtls_ctx));
+        mbedtls_rc = mbedtls_rsa_pkcs1_decrypt(cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, llsec_get_ctr_drbg(), &out_len, buffer, output, mbedtls_rsa_get_len(cipher_ctx->mbedtls_ctx));
 #else
     #error "Unsupported mbedTLS major version"
 #endif
+    }
     if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
         return_code = out_len;
     } else {
@@ -179,15 +180,18 @@ static int32_t llsec_rsa_cipher_encrypt(void* native_id, uint8_t* buffer, int32_
     LLSEC_RSA_CIPHER_DEBUG_TRACE("%s\n", __func__);
 
     int32_t return_code = LLSEC_SUCCESS;
+    int mbedtls_rc = llsec_rsa_cipher_set_padding(cipher_ctx);
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
 #if (MBEDTLS_VERSION_MAJOR == 2)
-    int mbedtls_rc = mbedtls_rsa_pkcs1_encrypt(&cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, &cipher_ctx->ctr_drbg, MBEDTLS_RSA_PUBLIC, buffer_length, buffer, output);
+        mbedtls_rc = mbedtls_rsa_pkcs1_encrypt(cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, llsec_get_ctr_drbg(), MBEDTLS_RSA_PUBLIC, buffer_length, buffer, output);
 #elif (MBEDTLS_VERSION_MAJOR == 3)
-    int mbedtls_rc = mbedtls_rsa_pkcs1_encrypt(&cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, &cipher_ctx->ctr_drbg, buffer_length, buffer, output);
+        mbedtls_rc = mbedtls_rsa_pkcs1_encrypt(cipher_ctx->mbedtls_ctx, mbedtls_ctr_drbg_random, llsec_get_ctr_drbg(), buffer_length, buffer, output);
 #else
     #error "Unsupported mbedTLS major version"
 #endif
+    }
     if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
-        return_code = mbedtls_rsa_get_len(&cipher_ctx->mbedtls_ctx);
+        return_code = mbedtls_rsa_get_len(cipher_ctx->mbedtls_ctx);
     } else {
         (void)SNI_throwNativeException(mbedtls_rc, "llsec_rsa_cipher_encrypt failed");
         return_code = LLSEC_ERROR;
@@ -199,10 +203,23 @@ static int32_t llsec_rsa_cipher_encrypt(void* native_id, uint8_t* buffer, int32_
 static void llsec_rsa_cipher_close(void* native_id) {
     LLSEC_RSA_CIPHER_DEBUG_TRACE("%s native_id:%p\n", __func__, native_id);
     LLSEC_RSA_CIPHER_ctx* cipher_ctx = (LLSEC_RSA_CIPHER_ctx*)native_id;
-    mbedtls_rsa_free(&cipher_ctx->mbedtls_ctx);
+    if ((uint8_t)0 != cipher_ctx->is_decrypting) {
+        llsec_priv_key_release((LLSEC_priv_key*)cipher_ctx->key);
+    } else {
+        llsec_pub_key_release((LLSEC_pub_key*)cipher_ctx->key);
+    }
     LLSEC_free(native_id);
 }
 
+static int llsec_rsa_cipher_set_padding(LLSEC_RSA_CIPHER_ctx* cipher_ctx) {
+#if (MBEDTLS_VERSION_MAJOR == 2)
+    mbedtls_rsa_set_padding(cipher_ctx->mbedtls_ctx, cipher_ctx->padding, (int)cipher_ctx->hash_id);
+    return LLSEC_MBEDTLS_SUCCESS;
+#else
+    return mbedtls_rsa_set_padding(cipher_ctx->mbedtls_ctx, cipher_ctx->padding, cipher_ctx->hash_id);
+#endif
+}
+
 /**
  * @brief Gets for the given transformation the RSA cipher description.
  * <p>
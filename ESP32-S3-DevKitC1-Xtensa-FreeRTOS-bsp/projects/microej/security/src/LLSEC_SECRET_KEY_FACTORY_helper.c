@@ -0,0 +1,76 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Secret key derivation for MbedTLS Library, independent of SNI.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#include <LLSEC_SECRET_KEY_FACTORY_helper.h>
+#include <LLSEC_configuration.h>
+#include <LLSEC_worker.h>
+
+#include "mbedtls/pkcs5.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(mbedtls_md_type_t md_type, const uint8_t* password, int32_t password_length, const uint8_t* salt, int32_t salt_length, int32_t iterations, uint8_t* key, int32_t key_length) {
+    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
+    mbedtls_md_context_t md_ctx;
+
+    /* Initialize HMAC context */
+    mbedtls_md_init(&md_ctx);
+    const mbedtls_md_info_t *md_info = mbedtls_md_info_from_type(md_type);
+    if (NULL == md_info) {
+        mbedtls_rc = MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    }
+
+    /* Setup HMAC context */
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_md_setup(&md_ctx, md_info, 1);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_md_setup() failed (rc = %d)\n", __func__, mbedtls_rc);
+        }
+    }
+
+    /* PKCS#5 PBKDF2 using HMAC */
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_pkcs5_pbkdf2_hmac(&md_ctx,
+                                               (const unsigned char *)password,
+                                               (size_t)password_length,
+                                               (const unsigned char *)salt,
+                                               (size_t)salt_length,
+                                               (unsigned int)iterations,
+                                               (uint32_t)key_length,
+                                               (unsigned char *)key);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_pkcs5_pbkdf2_hmac() failed (rc = %d)\n", __func__, mbedtls_rc);
+        }
+    }
+
+    /* Release HMAC context */
+    mbedtls_md_free(&md_ctx);
+
+    return mbedtls_rc;
+}
+
+void LLSEC_SECRET_KEY_FACTORY_PBKDF2_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+    LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t* params = &((LLSEC_worker_param_t*)job->params)->pbkdf2;
+
+    params->result = LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(params->md_type, params->password, params->password_length,
+                                                                     params->salt, params->salt_length, params->iterations,
+                                                                     params->secret_key->key, params->secret_key->key_length);
+}
+
+#ifdef __cplusplus
+}
+#endif
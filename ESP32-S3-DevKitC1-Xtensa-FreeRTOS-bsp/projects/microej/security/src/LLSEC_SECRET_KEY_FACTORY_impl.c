@@ -14,11 +14,15 @@
  */
 
 #include <LLSEC_SECRET_KEY_FACTORY_impl.h>
+#include <LLSEC_SECRET_KEY_FACTORY_EXTENSION_impl.h>
 #include <LLSEC_configuration.h>
 #include <LLSEC_mbedtls.h>
+#include <LLSEC_SECRET_KEY_FACTORY_helper.h>
+#include <LLSEC_worker.h>
 #include <string.h>
 #include "mbedtls/platform.h"
-#include "mbedtls/pkcs5.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/hkdf.h"
 
 typedef int32_t (*LLSEC_SECRET_KEY_FACTORY_get_key_data)(LLSEC_secret_key* secret_key, mbedtls_md_type_t md_type, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations, int32_t key_length);
 typedef void    (*LLSEC_SECRET_KEY_FACTORY_key_close)(void* native_id);
@@ -35,6 +39,13 @@ typedef struct {
 
 } LLSEC_SECRET_KEY_FACTORY_IMPL_algorithm;
 
+typedef struct {
+    const char*       name;
+    mbedtls_md_type_t md_type;
+} LLSEC_SECRET_KEY_FACTORY_hkdf_digest;
+
+static int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data_on_done(int32_t algorithm_id, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations, int32_t key_length);
+
 // cppcheck-suppress misra-c2012-8.9 // Define here for code readability even if it called once in this file.
 static LLSEC_SECRET_KEY_FACTORY_IMPL_algorithm available_algorithms[5] = {
     {
@@ -69,6 +80,13 @@ static LLSEC_SECRET_KEY_FACTORY_IMPL_algorithm available_algorithms[5] = {
     }
 };
 
+static LLSEC_SECRET_KEY_FACTORY_hkdf_digest available_hkdf_digests[4] = {
+    { .name = "SHA-1",   .md_type = MBEDTLS_MD_SHA1   },
+    { .name = "SHA-256", .md_type = MBEDTLS_MD_SHA256 },
+    { .name = "SHA-384", .md_type = MBEDTLS_MD_SHA384 },
+    { .name = "SHA-512", .md_type = MBEDTLS_MD_SHA512 }
+};
+
 void LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(LLSEC_secret_key* secret_key) {
     if(NULL != secret_key->key) {
         mbedtls_free(secret_key->key);
@@ -78,75 +96,121 @@ void LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(LLSEC_secret_key* secret_k
     }
 }
 
-int32_t LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_get_key_data(LLSEC_secret_key* secret_key, mbedtls_md_type_t md_type, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations, int32_t key_length) {
-    LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s \n", __func__);
-
+/**
+ * @brief Registers a derived secret key as SNI native resource.
+ *
+ * @return the native ID of the key on success, LLSEC_ERROR otherwise (the key is released).
+ */
+static int32_t LLSEC_SECRET_KEY_FACTORY_mbedtls_register_secret_key(LLSEC_secret_key* secret_key) {
     int32_t return_code = LLSEC_SUCCESS;
-    mbedtls_md_context_t md_ctx;
-    const mbedtls_md_info_t *md_info = NULL;
 
-    /* Allocate resources */
-    secret_key->key = mbedtls_calloc(1, key_length);
-    if (NULL == secret_key->key) {
-        (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_calloc() failed");
+    /* Register SNI close callback */
+    if (SNI_OK != SNI_registerResource((void* )secret_key, (SNI_closeFunction)LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_key_close, NULL)) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
         return_code = LLSEC_ERROR;
     }
 
-    /* Initialize HMAC context */
+    /* Return key struct addr (native_id) */
     if (LLSEC_SUCCESS == return_code) {
-        mbedtls_md_init(&md_ctx);
-        md_info = mbedtls_md_info_from_type(md_type);
-        if (NULL == md_info) {
-            (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_md_info_from_type() failed");
-            return_code = LLSEC_ERROR;
-        }
+        return_code = (int32_t)secret_key;
+        LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_pkcs5_pbkdf2_hmac() success. (native_id = %d)\n", __func__, (int)return_code);
+    } else {
+        LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
     }
 
-    /* Setup HMAC context */
-    if (LLSEC_SUCCESS == return_code) {
-        int mbedtls_rc = mbedtls_md_setup(&md_ctx, md_info, 1);
-        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_md_setup() failed (rc = %d)\n", __func__, mbedtls_rc);
-            (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_md_setup() failed");
-            return_code = LLSEC_ERROR;
-        }
+    return return_code;
+}
+
+static void LLSEC_SECRET_KEY_FACTORY_PBKDF2_free_params(LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t* params) {
+    if (NULL != params->password) {
+        mbedtls_platform_zeroize(params->password, (size_t)params->password_length);
+        mbedtls_free(params->password);
+        params->password = NULL;
+    }
+    if (NULL != params->salt) {
+        mbedtls_free(params->salt);
+        params->salt = NULL;
     }
+}
 
-    /* PKCS#5 PBKDF2 using HMAC */
-    if (LLSEC_SUCCESS == return_code) {
-        secret_key->key_length = key_length;
-        int mbedtls_rc = mbedtls_pkcs5_pbkdf2_hmac((mbedtls_md_context_t *)&md_ctx,
-                                                   (const unsigned char *)password,
-                                                   (size_t)password_length,
-                                                   (const unsigned char *)salt,
-                                                   (size_t)salt_length,
-                                                   (unsigned int)iterations,
-                                                   (uint32_t)secret_key->key_length,
-                                                   (unsigned char *)secret_key->key);
-        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_pkcs5_pbkdf2_hmac() failed (rc = %d)\n", __func__, mbedtls_rc);
-            (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_pkcs5_pbkdf2_hmac() failed");
+/**
+ * @brief Runs the derivation in the security worker and suspends the calling Java thread.
+ *
+ * The secret key is released on error. If no job is available, the Java thread is suspended and
+ * LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data() is called again when a job is released.
+ *
+ * @return LLSEC_SUCCESS if the job has been started, LLSEC_ERROR otherwise (an exception may be pending).
+ */
+static int32_t LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_async_get_key_data(LLSEC_secret_key* secret_key, mbedtls_md_type_t md_type, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations) {
+    int32_t return_code = LLSEC_SUCCESS;
+
+    MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&llsec_worker, (SNI_callback)LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data);
+    if (NULL == job) {
+        /* Thread suspended until a job is available, or exception thrown */
+        return_code = LLSEC_ERROR;
+    } else {
+        LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t* params = &((LLSEC_worker_param_t*)job->params)->pbkdf2;
+        params->secret_key = secret_key;
+        params->md_type = md_type;
+        params->password_length = password_length;
+        params->salt_length = salt_length;
+        params->iterations = iterations;
+        /* Java arrays may be moved by the GC while the thread is suspended: copy them */
+        params->password = mbedtls_calloc(1, (size_t)password_length + 1);
+        params->salt = mbedtls_calloc(1, (size_t)salt_length + 1);
+        if ((NULL == params->password) || (NULL == params->salt)) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_calloc() failed");
             return_code = LLSEC_ERROR;
+        } else {
+            (void)memcpy(params->password, password, (size_t)password_length);
+            (void)memcpy(params->salt, salt, (size_t)salt_length);
+            if (MICROEJ_ASYNC_WORKER_OK != MICROEJ_ASYNC_WORKER_async_exec(&llsec_worker, job, LLSEC_SECRET_KEY_FACTORY_PBKDF2_action, (SNI_callback)LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data_on_done)) {
+                /* MICROEJ_ASYNC_WORKER_async_exec() has thrown an exception */
+                return_code = LLSEC_ERROR;
+            }
+        }
+        if (LLSEC_SUCCESS != return_code) {
+            LLSEC_SECRET_KEY_FACTORY_PBKDF2_free_params(params);
+            (void)MICROEJ_ASYNC_WORKER_free_job(&llsec_worker, job);
         }
     }
 
-    /* Release HMAC context */
-    mbedtls_md_free(&md_ctx);
+    if (LLSEC_SUCCESS != return_code) {
+        LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
+    }
+    return return_code;
+}
 
-    /* Register SNI close callback */
-    if (LLSEC_SUCCESS == return_code) {
-        if (SNI_OK != SNI_registerResource((void* )secret_key, (SNI_closeFunction)LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_key_close, NULL)) {
-            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
-            return_code = LLSEC_ERROR;
-        }
+int32_t LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_get_key_data(LLSEC_secret_key* secret_key, mbedtls_md_type_t md_type, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations, int32_t key_length) {
+    LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s \n", __func__);
+
+    int32_t return_code = LLSEC_SUCCESS;
+
+    /* Allocate resources */
+    secret_key->key = mbedtls_calloc(1, key_length);
+    if (NULL == secret_key->key) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "mbedtls_calloc() failed");
+        LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
+        return_code = LLSEC_ERROR;
+    } else {
+        secret_key->key_length = key_length;
     }
 
-    /* Return key struct addr (native_id) */
     if (LLSEC_SUCCESS == return_code) {
-        return_code = (int32_t)secret_key;
-        LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_pkcs5_pbkdf2_hmac() success. (native_id = %d)\n", __func__, (int)return_code);
-    } else {
-        LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
+        if ((LLSEC_SECRET_KEY_FACTORY_ASYNC_ITERATIONS <= iterations) && (LLSEC_SUCCESS == llsec_worker_start())) {
+            /* Long derivation: the result is returned by LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data_on_done() */
+            (void)LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_async_get_key_data(secret_key, md_type, password, password_length, salt, salt_length, iterations);
+            return_code = LLSEC_ERROR;
+        } else {
+            int mbedtls_rc = LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(md_type, password, password_length, salt, salt_length, iterations, secret_key->key, key_length);
+            if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+                (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_pkcs5_pbkdf2_hmac() failed");
+                LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
+                return_code = LLSEC_ERROR;
+            } else {
+                return_code = LLSEC_SECRET_KEY_FACTORY_mbedtls_register_secret_key(secret_key);
+            }
+        }
     }
 
     return return_code;
@@ -226,6 +290,39 @@ int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data(int32_t algorithm_id, uint8_t
     return return_code;
 }
 
+static int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_get_key_data_on_done(int32_t algorithm_id, uint8_t* password, int32_t password_length, uint8_t* salt, int32_t salt_length, int32_t iterations, int32_t key_length) {
+    LLSEC_UNUSED_PARAM(algorithm_id);
+    LLSEC_UNUSED_PARAM(password);
+    LLSEC_UNUSED_PARAM(password_length);
+    LLSEC_UNUSED_PARAM(salt);
+    LLSEC_UNUSED_PARAM(salt_length);
+    LLSEC_UNUSED_PARAM(iterations);
+    LLSEC_UNUSED_PARAM(key_length);
+    LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s \n", __func__);
+
+    int32_t return_code;
+    MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+    if (job == NULL) {
+        return LLSEC_ERROR;
+    }
+    LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t* params = &((LLSEC_worker_param_t*)job->params)->pbkdf2;
+    LLSEC_secret_key* secret_key = params->secret_key;
+    int mbedtls_rc = params->result;
+
+    LLSEC_SECRET_KEY_FACTORY_PBKDF2_free_params(params);
+    (void)MICROEJ_ASYNC_WORKER_free_job(&llsec_worker, job);
+
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_pkcs5_pbkdf2_hmac() failed");
+        LLSEC_SECRET_KEY_FACTORY_mbedtls_free_secret_key(secret_key);
+        return_code = LLSEC_ERROR;
+    } else {
+        return_code = LLSEC_SECRET_KEY_FACTORY_mbedtls_register_secret_key(secret_key);
+    }
+
+    return return_code;
+}
+
 /**
  * Gets the id of the native close function.
  *
@@ -241,3 +338,59 @@ int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_get_close_id(int32_t algorithm_id) {
     // cppcheck-suppress misra-c2012-11.1 // Abstract data type for SNI usage
     return (int32_t)algorithm->key_close;
 }
+
+static const mbedtls_md_info_t* LLSEC_SECRET_KEY_FACTORY_get_hkdf_md_info(uint8_t* digest_name) {
+    const mbedtls_md_info_t* md_info = NULL;
+    int32_t nb_digests = sizeof(available_hkdf_digests) / sizeof(LLSEC_SECRET_KEY_FACTORY_hkdf_digest);
+    LLSEC_SECRET_KEY_FACTORY_hkdf_digest* digest = &available_hkdf_digests[0];
+
+    while (--nb_digests >= 0) {
+        if (strcmp((char*)digest_name, digest->name) == 0) {
+            md_info = mbedtls_md_info_from_type(digest->md_type);
+            break;
+        }
+        digest++;
+    }
+    return md_info;
+}
+
+int32_t LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract(uint8_t* digest_name, uint8_t* salt, int32_t salt_length, uint8_t* ikm, int32_t ikm_length, uint8_t* prk, int32_t prk_length) {
+    LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s \n", __func__);
+    int32_t return_code = LLSEC_SUCCESS;
+
+    const mbedtls_md_info_t* md_info = LLSEC_SECRET_KEY_FACTORY_get_hkdf_md_info(digest_name);
+    if (NULL == md_info) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Unsupported HKDF digest");
+        return_code = LLSEC_ERROR;
+    } else if (prk_length < (int32_t)mbedtls_md_get_size(md_info)) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Output buffer too small");
+        return_code = LLSEC_ERROR;
+    } else {
+        int mbedtls_rc = mbedtls_hkdf_extract(md_info, salt, (size_t)salt_length, ikm, (size_t)ikm_length, prk);
+        LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_hkdf_extract() rc = %d\n", __func__, mbedtls_rc);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_hkdf_extract() failed");
+            return_code = LLSEC_ERROR;
+        } else {
+            return_code = (int32_t)mbedtls_md_get_size(md_info);
+        }
+    }
+
+    return return_code;
+}
+
+void LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_expand(uint8_t* digest_name, uint8_t* prk, int32_t prk_length, uint8_t* info, int32_t info_length, uint8_t* okm, int32_t okm_length) {
+    LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s \n", __func__);
+
+    const mbedtls_md_info_t* md_info = LLSEC_SECRET_KEY_FACTORY_get_hkdf_md_info(digest_name);
+    if (NULL == md_info) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Unsupported HKDF digest");
+    } else {
+        /* mbedTLS checks prk_length and okm_length (at most 255 blocks) */
+        int mbedtls_rc = mbedtls_hkdf_expand(md_info, prk, (size_t)prk_length, info, (size_t)info_length, okm, (size_t)okm_length);
+        LLSEC_SECRET_KEY_FACTORY_DEBUG_TRACE("%s mbedtls_hkdf_expand() rc = %d\n", __func__, mbedtls_rc);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            (void)SNI_throwNativeException(mbedtls_rc, "mbedtls_hkdf_expand() failed");
+        }
+    }
+}
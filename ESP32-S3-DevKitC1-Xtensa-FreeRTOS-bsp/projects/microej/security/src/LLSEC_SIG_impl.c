@@ -15,6 +15,7 @@
 
 #include <LLSEC_ERRORS.h>
 #include <LLSEC_SIG_impl.h>
+#include <LLSEC_SIG_EXTENSION_impl.h>
 #include <LLSEC_configuration.h>
 #include <sni.h>
 #include <stdint.h>
@@ -31,6 +32,10 @@
 #include "mbedtls/error.h"
 #include "mbedtls/md.h"
 #include "mbedtls/pk.h"
+#include "mbedtls/rsa.h"
+#include "esp_partition.h"
+#include "fs_helper.h"
+#include "LLSEC_worker.h"
 
 typedef struct LLSEC_SIG_algorithm LLSEC_SIG_algorithm;
 typedef int (*LLSEC_SIG_verify)(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length);
@@ -41,22 +46,66 @@ struct LLSEC_SIG_algorithm {
     char* digest_name;
     char* digest_native_name;
     char* oid;
+    mbedtls_md_type_t md_type;
+    int rsa_padding; // MBEDTLS_RSA_PKCS_V15 or MBEDTLS_RSA_PKCS_V21 (PSS), unused for ECDSA and EdDSA
     LLSEC_SIG_verify verify;
     LLSEC_SIG_sign sign;
 };
 
+typedef struct {
+    LLSEC_SIG_algorithm* algorithm;
+    int32_t digest_length;
+    mbedtls_md_context_t md_ctx;
+} LLSEC_SIG_stream;
+
 static int LLSEC_SIG_mbedtls_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length);
 static int LLSEC_SIG_mbedtls_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length);
 
 static int LLSEC_SIG_mbedtls_ec_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length);
 static int LLSEC_SIG_mbedtls_ec_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length);
 
-static LLSEC_SIG_algorithm available_sig_algorithms[2] = {
+static int LLSEC_SIG_ed25519_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length);
+static int LLSEC_SIG_ed25519_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length);
+
+static LLSEC_SIG_algorithm available_sig_algorithms[8] = {
     {
         .name = "SHA256withRSA",
         .digest_name = "SHA-256",
         .digest_native_name = "SHA256",
         .oid = "1.2.840.113549.1.1.11",
+        .md_type = MBEDTLS_MD_SHA256,
+        .rsa_padding = MBEDTLS_RSA_PKCS_V15,
+        .verify = LLSEC_SIG_mbedtls_verify,
+        .sign = LLSEC_SIG_mbedtls_sign
+    },
+    {
+        .name = "SHA384withRSA",
+        .digest_name = "SHA-384",
+        .digest_native_name = "SHA384",
+        .oid = "1.2.840.113549.1.1.12",
+        .md_type = MBEDTLS_MD_SHA384,
+        .rsa_padding = MBEDTLS_RSA_PKCS_V15,
+        .verify = LLSEC_SIG_mbedtls_verify,
+        .sign = LLSEC_SIG_mbedtls_sign
+    },
+    {
+        .name = "SHA512withRSA",
+        .digest_name = "SHA-512",
+        .digest_native_name = "SHA512",
+        .oid = "1.2.840.113549.1.1.13",
+        .md_type = MBEDTLS_MD_SHA512,
+        .rsa_padding = MBEDTLS_RSA_PKCS_V15,
+        .verify = LLSEC_SIG_mbedtls_verify,
+        .sign = LLSEC_SIG_mbedtls_sign
+    },
+    {
+        /* RSASSA-PSS, MGF1 with SHA-256, salt length of 32 bytes */
+        .name = "SHA256withRSA/PSS",
+        .digest_name = "SHA-256",
+        .digest_native_name = "SHA256",
+        .oid = "1.2.840.113549.1.1.10",
+        .md_type = MBEDTLS_MD_SHA256,
+        .rsa_padding = MBEDTLS_RSA_PKCS_V21,
         .verify = LLSEC_SIG_mbedtls_verify,
         .sign = LLSEC_SIG_mbedtls_sign
     },
@@ -65,87 +114,101 @@ static LLSEC_SIG_algorithm available_sig_algorithms[2] = {
         .digest_name = "SHA-256",
         .digest_native_name = "SHA256",
         .oid = "1.2.840.10045.4.3.2",
+        .md_type = MBEDTLS_MD_SHA256,
+        .rsa_padding = 0,
         .verify = LLSEC_SIG_mbedtls_ec_verify,
         .sign = LLSEC_SIG_mbedtls_ec_sign
+    },
+    {
+        .name = "SHA384withECDSA",
+        .digest_name = "SHA-384",
+        .digest_native_name = "SHA384",
+        .oid = "1.2.840.10045.4.3.3",
+        .md_type = MBEDTLS_MD_SHA384,
+        .rsa_padding = 0,
+        .verify = LLSEC_SIG_mbedtls_ec_verify,
+        .sign = LLSEC_SIG_mbedtls_ec_sign
+    },
+    {
+        .name = "SHA512withECDSA",
+        .digest_name = "SHA-512",
+        .digest_native_name = "SHA512",
+        .oid = "1.2.840.10045.4.3.4",
+        .md_type = MBEDTLS_MD_SHA512,
+        .rsa_padding = 0,
+        .verify = LLSEC_SIG_mbedtls_ec_verify,
+        .sign = LLSEC_SIG_mbedtls_ec_sign
+    },
+    {
+        /*
+         * The signature natives receive the digest of the message, not the message: only the prehash variant of
+         * EdDSA (RFC 8032 section 5.1, SHA-512 prehash) can be provided. id-Ed25519 (RFC 8410) identifies the key.
+         */
+        .name = "Ed25519ph",
+        .digest_name = "SHA-512",
+        .digest_native_name = "SHA512",
+        .oid = "1.3.101.112",
+        .md_type = MBEDTLS_MD_SHA512,
+        .rsa_padding = 0,
+        .verify = LLSEC_SIG_ed25519_verify,
+        .sign = LLSEC_SIG_ed25519_sign
     }
 };
 
+/**
+ * @brief Selects the padding of the given algorithm in an RSA key context.
+ *
+ * RSA key contexts are shared by all the signatures using the key (so that the blinding values and the Montgomery
+ * constants computed by mbedTLS are kept across operations): the padding must be set before each operation.
+ *
+ * @return <code>LLSEC_MBEDTLS_SUCCESS</code> on success, else the mbedTLS error code.
+ */
+static int LLSEC_SIG_mbedtls_rsa_set_padding(LLSEC_SIG_algorithm* algorithm, mbedtls_rsa_context* ctx) {
+    return mbedtls_rsa_set_padding(ctx, algorithm->rsa_padding, algorithm->md_type);
+}
+
 static int LLSEC_SIG_mbedtls_ec_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length) {
     LLSEC_UNUSED_PARAM(algorithm);
 
     LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
 
-    mbedtls_entropy_context entropy;
-    mbedtls_ctr_drbg_context ctr_drbg;
-
     int return_code = LLSEC_SUCCESS;
-    int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
-
-    mbedtls_entropy_init(&entropy);
-    mbedtls_ctr_drbg_init(&ctr_drbg);
 
-    const char* pers = llsec_gen_random_str_internal(8);
-    if(NULL == pers) {
-        LLSEC_SIG_DEBUG_TRACE("%s llsec_gen_random_str_internal: allocation error\n", __func__);
+    /* ECDSA verification only uses public data: no random generator needed */
+    mbedtls_ecdsa_context* ctx = (mbedtls_ecdsa_context*)pub_key->key;
+    int mbedtls_rc = mbedtls_ecdsa_read_signature(ctx, digest, (size_t)digest_length, signature, signature_length);
+    LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ecdsa_read_signature: %d\n", __func__, mbedtls_rc);
+    if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
         return_code = LLSEC_ERROR;
     }
-    if (LLSEC_SUCCESS == return_code) {
-        mbedtls_rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)pers, strlen(pers));
-        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed: %d\n", __func__, mbedtls_rc);
-        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            return_code = LLSEC_ERROR;
-        }
-    }
-    if (LLSEC_SUCCESS == return_code) {
-        mbedtls_ecdsa_context* ctx = (mbedtls_ecdsa_context*)pub_key->key;
-        mbedtls_rc = mbedtls_ecdsa_read_signature(ctx, digest, (size_t)digest_length, signature, signature_length);
-        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ecdsa_read_signature: %d\n", __func__, mbedtls_rc);
-        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            return_code = LLSEC_ERROR;
-        }
-    }
-
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-    mbedtls_entropy_free(&entropy);
-    // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
-    mbedtls_free((void*)pers);
 
     LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
     return return_code;
 }
 
 static int LLSEC_SIG_mbedtls_ec_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length) {
-    LLSEC_UNUSED_PARAM(algorithm);
-
     LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
 
-    mbedtls_entropy_context entropy;
-    mbedtls_ctr_drbg_context ctr_drbg;
-
     int return_code = LLSEC_SUCCESS;
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
-    mbedtls_entropy_init(&entropy);
-    mbedtls_ctr_drbg_init(&ctr_drbg);
-
-    const char* pers = llsec_gen_random_str_internal(8);
-    if(NULL == pers) {
-        LLSEC_SIG_DEBUG_TRACE("%s llsec_gen_random_str_internal: allocation error\n", __func__);
+    mbedtls_ctr_drbg_context* ctr_drbg = llsec_get_ctr_drbg();
+    if (NULL == ctr_drbg) {
         return_code = LLSEC_ERROR;
     }
-    if (LLSEC_SUCCESS == return_code) {
-        mbedtls_rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)pers, strlen(pers));
-        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed: %d\n", __func__, mbedtls_rc);
-        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            return_code = LLSEC_ERROR;
-        }
-    }
     if (LLSEC_SUCCESS == return_code) {
         mbedtls_ecdsa_context* ctx = (mbedtls_ecdsa_context*)priv_key->key;
+        /*
+         * With MBEDTLS_ECDSA_DETERMINISTIC, the nonce is derived from the key and the digest (RFC 6979) and the
+         * random generator is only used for blinding. The multiplication of the curve generator uses the static
+         * comb tables of CONFIG_MBEDTLS_ECP_FIXED_POINT_OPTIM (sdkconfig), shared by all the keys of a curve.
+         * No table is kept per key: mbedTLS only precomputes the generator, the multiplication of the public point
+         * done by the verification always builds a temporary table.
+         */
 #if (MBEDTLS_VERSION_MAJOR == 2)
-        mbedtls_rc = mbedtls_ecdsa_write_signature(ctx, MBEDTLS_MD_SHA256, digest, (size_t)digest_length, signature, (size_t*)signature_length, mbedtls_ctr_drbg_random, &ctr_drbg);
+        mbedtls_rc = mbedtls_ecdsa_write_signature(ctx, algorithm->md_type, digest, (size_t)digest_length, signature, (size_t*)signature_length, mbedtls_ctr_drbg_random, ctr_drbg);
 #elif (MBEDTLS_VERSION_MAJOR == 3)
-        mbedtls_rc = mbedtls_ecdsa_write_signature(ctx, MBEDTLS_MD_SHA256, digest, (size_t)digest_length, signature, (size_t)*signature_length, (size_t*)signature_length, mbedtls_ctr_drbg_random, &ctr_drbg);
+        mbedtls_rc = mbedtls_ecdsa_write_signature(ctx, algorithm->md_type, digest, (size_t)digest_length, signature, (size_t)*signature_length, (size_t*)signature_length, mbedtls_ctr_drbg_random, ctr_drbg);
 #else
         #error "Unsupported mbedTLS major version"
 #endif
@@ -155,17 +218,57 @@ static int LLSEC_SIG_mbedtls_ec_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* si
         }
     }
 
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-    mbedtls_entropy_free(&entropy);
-    // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
-    mbedtls_free((void*)pers);
+    LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
+    return return_code;
+}
+
+static int LLSEC_SIG_ed25519_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length) {
+    LLSEC_UNUSED_PARAM(algorithm);
+
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    int return_code = LLSEC_SUCCESS;
+
+    if ((TYPE_ED25519 != pub_key->type) || (LLSEC_ED25519_SIGNATURE_SIZE != signature_length) || (LLSEC_ED25519_PREHASH_SIZE != digest_length)) {
+        return_code = LLSEC_ERROR;
+    } else {
+        LLSEC_ed25519_key* key = (LLSEC_ed25519_key*)pub_key->key;
+        int rc = llsec_ed25519_verify(signature, digest, (size_t)digest_length, key->public_key, 1);
+        LLSEC_SIG_DEBUG_TRACE("%s llsec_ed25519_verify: %d\n", __func__, rc);
+        if (0 != rc) {
+            return_code = LLSEC_ERROR;
+        }
+    }
+
+    LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
+    return return_code;
+}
+
+static int LLSEC_SIG_ed25519_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length) {
+    LLSEC_UNUSED_PARAM(algorithm);
+
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    int return_code = LLSEC_SUCCESS;
+
+    /* EdDSA signatures are deterministic: no random generator needed */
+    if ((TYPE_ED25519 != priv_key->type) || (LLSEC_ED25519_SIGNATURE_SIZE > *signature_length) || (LLSEC_ED25519_PREHASH_SIZE != digest_length)) {
+        return_code = LLSEC_ERROR;
+    } else {
+        int rc = llsec_ed25519_sign(signature, digest, (size_t)digest_length, (LLSEC_ed25519_key*)priv_key->key, 1);
+        LLSEC_SIG_DEBUG_TRACE("%s llsec_ed25519_sign: %d\n", __func__, rc);
+        if (0 != rc) {
+            return_code = LLSEC_ERROR;
+        } else {
+            *signature_length = LLSEC_ED25519_SIGNATURE_SIZE;
+        }
+    }
 
     LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
     return return_code;
 }
 
 static int LLSEC_SIG_mbedtls_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t signature_length, LLSEC_pub_key* pub_key, uint8_t* digest, int32_t digest_length) {
-    LLSEC_UNUSED_PARAM(algorithm);
     LLSEC_UNUSED_PARAM(signature_length);
 
     LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
@@ -174,31 +277,26 @@ static int LLSEC_SIG_mbedtls_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* sig
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
 #if (MBEDTLS_VERSION_MAJOR == 2)
-    mbedtls_entropy_context entropy;
-    mbedtls_ctr_drbg_context ctr_drbg;
-
-    mbedtls_entropy_init(&entropy);
-    mbedtls_ctr_drbg_init(&ctr_drbg);
-
-    const char* pers = llsec_gen_random_str_internal(8);
-    if(NULL == pers) {
-        LLSEC_SIG_DEBUG_TRACE("%s llsec_gen_random_str_internal: allocation error\n", __func__);
+    mbedtls_ctr_drbg_context* ctr_drbg = llsec_get_ctr_drbg();
+    if (NULL == ctr_drbg) {
         return_code = LLSEC_ERROR;
     }
+#endif
+
     if (LLSEC_SUCCESS == return_code) {
-        mbedtls_rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)pers, strlen(pers));
-        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed: %d\n", __func__, mbedtls_rc);
-        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            return_code = LLSEC_ERROR;
-        }
+        /* PKCS#1 v1.5 or PSS (any salt length) depending on the padding */
+        mbedtls_rc = LLSEC_SIG_mbedtls_rsa_set_padding(algorithm, (mbedtls_rsa_context*)pub_key->key);
+    }
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        return_code = LLSEC_ERROR;
     }
-#endif
 
     if (LLSEC_SUCCESS == return_code) {
+        mbedtls_rsa_context* ctx = (mbedtls_rsa_context*)pub_key->key;
 #if (MBEDTLS_VERSION_MAJOR == 2)
-        mbedtls_rc = mbedtls_rsa_pkcs1_verify((mbedtls_rsa_context*)pub_key->key, mbedtls_ctr_drbg_random, &ctr_drbg, MBEDTLS_RSA_PUBLIC, MBEDTLS_MD_SHA256, digest_length, digest, signature);
+        mbedtls_rc = mbedtls_rsa_pkcs1_verify(ctx, mbedtls_ctr_drbg_random, ctr_drbg, MBEDTLS_RSA_PUBLIC, algorithm->md_type, digest_length, digest, signature);
 #elif (MBEDTLS_VERSION_MAJOR == 3)
-        mbedtls_rc = mbedtls_rsa_pkcs1_verify((mbedtls_rsa_context*)pub_key->key, MBEDTLS_MD_SHA256, digest_length, digest, signature);
+        mbedtls_rc = mbedtls_rsa_pkcs1_verify(ctx, algorithm->md_type, digest_length, digest, signature);
 #else
         #error "Unsupported mbedTLS major version"
 #endif
@@ -208,48 +306,38 @@ static int LLSEC_SIG_mbedtls_verify(LLSEC_SIG_algorithm* algorithm, uint8_t* sig
         }
     }
 
-#if (MBEDTLS_VERSION_MAJOR == 2)
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-    mbedtls_entropy_free(&entropy);
-    // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
-    mbedtls_free((void*)pers);
-#endif
-
     LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
     return return_code;
 }
 
 static int LLSEC_SIG_mbedtls_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signature, int32_t* signature_length, LLSEC_priv_key* priv_key, uint8_t* digest, int32_t digest_length) {
-    LLSEC_UNUSED_PARAM(algorithm);
-
     LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
 
-    mbedtls_entropy_context entropy;
-    mbedtls_ctr_drbg_context ctr_drbg;
-
     int return_code = LLSEC_SUCCESS;
     int mbedtls_rc = LLSEC_MBEDTLS_SUCCESS;
 
-    mbedtls_entropy_init(&entropy);
-    mbedtls_ctr_drbg_init(&ctr_drbg);
-
-    const char* pers = llsec_gen_random_str_internal(8);
-    if(NULL == pers) {
-        LLSEC_SIG_DEBUG_TRACE("%s llsec_gen_random_str_internal: allocation error\n", __func__);
+    mbedtls_ctr_drbg_context* ctr_drbg = llsec_get_ctr_drbg();
+    if (NULL == ctr_drbg) {
         return_code = LLSEC_ERROR;
     }
     if (LLSEC_SUCCESS == return_code) {
-        mbedtls_rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)pers, strlen(pers));
-        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_ctr_drbg_seed: %d\n", __func__, mbedtls_rc);
-        if(LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
-            return_code = LLSEC_ERROR;
-        }
+        mbedtls_rc = LLSEC_SIG_mbedtls_rsa_set_padding(algorithm, (mbedtls_rsa_context*)priv_key->key);
     }
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        return_code = LLSEC_ERROR;
+    }
+
     if (LLSEC_SUCCESS == return_code) {
+        mbedtls_rsa_context* ctx = (mbedtls_rsa_context*)priv_key->key;
 #if (MBEDTLS_VERSION_MAJOR == 2)
-        mbedtls_rc = mbedtls_rsa_pkcs1_sign((mbedtls_rsa_context*)priv_key->key, mbedtls_ctr_drbg_random, &ctr_drbg, MBEDTLS_RSA_PRIVATE, MBEDTLS_MD_SHA256, digest_length, digest, signature);
+        mbedtls_rc = mbedtls_rsa_pkcs1_sign(ctx, mbedtls_ctr_drbg_random, ctr_drbg, MBEDTLS_RSA_PRIVATE, algorithm->md_type, digest_length, digest, signature);
 #elif (MBEDTLS_VERSION_MAJOR == 3)
-        mbedtls_rc = mbedtls_rsa_pkcs1_sign((mbedtls_rsa_context*)priv_key->key, mbedtls_ctr_drbg_random, &ctr_drbg, MBEDTLS_MD_SHA256, digest_length, digest, signature);
+        if (MBEDTLS_RSA_PKCS_V21 == algorithm->rsa_padding) {
+            /* Salt as long as the digest, as expected by the default PSS parameters of Java verifiers */
+            mbedtls_rc = mbedtls_rsa_rsassa_pss_sign_ext(ctx, mbedtls_ctr_drbg_random, ctr_drbg, algorithm->md_type, digest_length, digest, digest_length, signature);
+        } else {
+            mbedtls_rc = mbedtls_rsa_pkcs1_sign(ctx, mbedtls_ctr_drbg_random, ctr_drbg, algorithm->md_type, digest_length, digest, signature);
+        }
 #else
         #error "Unsupported mbedTLS major version"
 #endif
@@ -262,11 +350,6 @@ static int LLSEC_SIG_mbedtls_sign(LLSEC_SIG_algorithm* algorithm, uint8_t* signa
         *signature_length = mbedtls_rsa_get_len((mbedtls_rsa_context*)priv_key->key);
     }
 
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-    mbedtls_entropy_free(&entropy);
-    // cppcheck-suppress misra-c2012-11.8 // Cast for matching free function signature
-    mbedtls_free((void*)pers);
-
     LLSEC_SIG_DEBUG_TRACE("%s: return_code = %d\n", __func__, return_code);
     return return_code;
 }
@@ -400,3 +483,313 @@ int32_t LLSEC_SIG_IMPL_sign(int32_t algorithm_id, uint8_t* signature, int32_t si
 
     return return_code;
 }
+
+static void LLSEC_SIG_stream_close(void* native_id) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+
+    /* Memory deallocation */
+    mbedtls_md_free(&stream->md_ctx);
+    mbedtls_free(stream);
+}
+
+/**
+ * @brief Finishes the digest of a streaming signature and restarts it for the next message.
+ *
+ * @param[in] stream                        The streaming signature.
+ * @param[out] digest                       The digest, at least MBEDTLS_MD_MAX_SIZE bytes.
+ * @param[out] digest_length                The digest length.
+ *
+ * @return LLSEC_SUCCESS on success, LLSEC_ERROR otherwise.
+ */
+static int LLSEC_SIG_stream_finish(LLSEC_SIG_stream* stream, uint8_t* digest, int32_t* digest_length) {
+    int return_code = LLSEC_SUCCESS;
+
+    int mbedtls_rc = mbedtls_md_finish(&stream->md_ctx, digest);
+    LLSEC_SIG_DEBUG_TRACE("%s mbedtls_md_finish: %d\n", __func__, mbedtls_rc);
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        return_code = LLSEC_ERROR;
+    } else {
+        *digest_length = stream->digest_length;
+    }
+
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_md_starts(&stream->md_ctx)) {
+        return_code = LLSEC_ERROR;
+    }
+    return return_code;
+}
+
+int32_t LLSEC_SIG_IMPL_stream_init(int32_t algorithm_id) {
+    int32_t return_code = LLSEC_SUCCESS;
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    LLSEC_SIG_algorithm* algorithm = (LLSEC_SIG_algorithm*)algorithm_id;
+    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_string(algorithm->digest_native_name);
+
+    LLSEC_SIG_stream* stream = mbedtls_calloc(1, sizeof(LLSEC_SIG_stream));
+    if ((NULL == stream) || (NULL == md_info)) {
+        return_code = LLSEC_ERROR;
+    }
+
+    if (LLSEC_SUCCESS == return_code) {
+        stream->algorithm = algorithm;
+        stream->digest_length = (int32_t)mbedtls_md_get_size(md_info);
+        mbedtls_md_init(&stream->md_ctx);
+        int mbedtls_rc = mbedtls_md_setup(&stream->md_ctx, md_info, 0);
+        if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+            mbedtls_rc = mbedtls_md_starts(&stream->md_ctx);
+        }
+        LLSEC_SIG_DEBUG_TRACE("%s mbedtls_md_setup/starts: %d\n", __func__, mbedtls_rc);
+        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+            LLSEC_SIG_stream_close(stream);
+            return_code = LLSEC_ERROR;
+        }
+    } else {
+        mbedtls_free(stream);
+    }
+
+    if (LLSEC_SUCCESS != return_code) {
+        (void)SNI_throwNativeException(return_code, "LLSEC_SIG_IMPL_stream_init failed");
+    } else {
+        /* register SNI native resource */
+        if (SNI_registerResource(stream, LLSEC_SIG_stream_close, NULL) != SNI_OK) {
+            (void)SNI_throwNativeException(LLSEC_ERROR, "Can't register SNI native resource");
+            LLSEC_SIG_stream_close(stream);
+            return_code = LLSEC_ERROR;
+        } else {
+            // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+            return_code = (int32_t)stream;
+        }
+    }
+    return return_code;
+}
+
+void LLSEC_SIG_IMPL_stream_update(int32_t native_id, uint8_t* buffer, int32_t buffer_offset, int32_t buffer_length) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+    int mbedtls_rc = mbedtls_md_update(&stream->md_ctx, &buffer[buffer_offset], (size_t)buffer_length);
+
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        (void)SNI_throwNativeException(mbedtls_rc, "LLSEC_SIG_IMPL_stream_update failed");
+    }
+}
+
+/**
+ * @brief Finds a partition by its label.
+ *
+ * @return the partition, NULL if no data or application partition has this label.
+ */
+static const esp_partition_t* LLSEC_SIG_find_partition(const char* label) {
+    const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (NULL == partition) {
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, label);
+    }
+    return partition;
+}
+
+/**
+ * @brief Hashes a partition range window by window, straight from the flash cache: no copy to RAM.
+ *
+ * Does not use SNI: may be called from the security worker task.
+ */
+static void LLSEC_SIG_hash_partition(LLSEC_SIG_partition_param_t* params) {
+    int32_t offset = params->offset;
+    int32_t length = params->length;
+
+    params->result = LLSEC_MBEDTLS_SUCCESS;
+    params->error_message = NULL;
+    while ((LLSEC_MBEDTLS_SUCCESS == params->result) && (0 < length)) {
+        size_t window = (length < LLSEC_SIG_STREAM_MAP_SIZE) ? (size_t)length : (size_t)LLSEC_SIG_STREAM_MAP_SIZE;
+        const void* data = NULL;
+        spi_flash_mmap_handle_t handle;
+
+        esp_err_t err = esp_partition_mmap(params->partition, (size_t)offset, window, SPI_FLASH_MMAP_DATA, &data, &handle);
+        LLSEC_SIG_DEBUG_TRACE("%s esp_partition_mmap(%d, %d): %d\n", __func__, (int)offset, (int)window, (int)err);
+        if (ESP_OK != err) {
+            params->result = (int)err;
+            params->error_message = "LLSEC_SIG_IMPL_stream_update_from_partition: esp_partition_mmap failed";
+        } else {
+            params->result = mbedtls_md_update(params->md_ctx, (const unsigned char*)data, window);
+            spi_flash_munmap(handle);
+            if (LLSEC_MBEDTLS_SUCCESS != params->result) {
+                params->error_message = "LLSEC_SIG_IMPL_stream_update_from_partition failed";
+            }
+        }
+        offset += (int32_t)window;
+        length -= (int32_t)window;
+    }
+}
+
+static void LLSEC_SIG_hash_partition_action(MICROEJ_ASYNC_WORKER_job_t* job) {
+    LLSEC_SIG_hash_partition(&((LLSEC_worker_param_t*)job->params)->sig_partition);
+}
+
+static void LLSEC_SIG_IMPL_stream_update_from_partition_on_done(int32_t native_id, uint8_t* partition_label, int32_t offset, int32_t length) {
+    LLSEC_UNUSED_PARAM(native_id);
+    LLSEC_UNUSED_PARAM(partition_label);
+    LLSEC_UNUSED_PARAM(offset);
+    LLSEC_UNUSED_PARAM(length);
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+    if (NULL == job) {
+        return;
+    }
+    LLSEC_SIG_partition_param_t* params = &((LLSEC_worker_param_t*)job->params)->sig_partition;
+    int result = params->result;
+    const char* error_message = params->error_message;
+    (void)MICROEJ_ASYNC_WORKER_free_job(&llsec_worker, job);
+
+    if (LLSEC_MBEDTLS_SUCCESS != result) {
+        (void)SNI_throwNativeException(result, error_message);
+    }
+}
+
+void LLSEC_SIG_IMPL_stream_update_from_partition(int32_t native_id, uint8_t* partition_label, int32_t offset, int32_t length) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+    const esp_partition_t* partition = LLSEC_SIG_find_partition((const char*)partition_label);
+
+    if (NULL == partition) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Partition not found");
+    } else if ((0 > offset) || (0 > length) || (((uint32_t)offset + (uint32_t)length) > partition->size)) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Invalid partition range");
+    } else if ((LLSEC_SIG_STREAM_MAP_SIZE >= length) || (LLSEC_SUCCESS != llsec_worker_start())) {
+        /* Short range: not worth suspending the Java thread */
+        LLSEC_SIG_partition_param_t params = {
+            .md_ctx = &stream->md_ctx, .partition = partition, .offset = offset, .length = length
+        };
+        LLSEC_SIG_hash_partition(&params);
+        if (LLSEC_MBEDTLS_SUCCESS != params.result) {
+            (void)SNI_throwNativeException(params.result, params.error_message);
+        }
+    } else {
+        /* Long range: hashed by the security worker, the other Java threads keep running */
+        MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&llsec_worker, (SNI_callback)LLSEC_SIG_IMPL_stream_update_from_partition);
+        if (NULL != job) {
+            LLSEC_SIG_partition_param_t* params = &((LLSEC_worker_param_t*)job->params)->sig_partition;
+            params->md_ctx = &stream->md_ctx;
+            params->partition = partition;
+            params->offset = offset;
+            params->length = length;
+            if (MICROEJ_ASYNC_WORKER_OK != MICROEJ_ASYNC_WORKER_async_exec(&llsec_worker, job, LLSEC_SIG_hash_partition_action, (SNI_callback)LLSEC_SIG_IMPL_stream_update_from_partition_on_done)) {
+                /* MICROEJ_ASYNC_WORKER_async_exec() has thrown an exception */
+                (void)MICROEJ_ASYNC_WORKER_free_job(&llsec_worker, job);
+            }
+        } // else thread suspended until a job is available, or exception thrown
+    }
+}
+
+/**
+ * @brief Adds the data read from a file to the digest of a streaming signature.
+ *
+ * Called from the FS worker task by LLFS_File_IMPL_read_range_action().
+ */
+static int32_t LLSEC_SIG_stream_consume(void* context, const uint8_t* data, int32_t length) {
+    return (int32_t)mbedtls_md_update((mbedtls_md_context_t*)context, (const unsigned char*)data, (size_t)length);
+}
+
+static void LLSEC_SIG_IMPL_stream_update_from_file_on_done(int32_t native_id, int32_t file_id, int64_t position, int64_t length) {
+    LLSEC_UNUSED_PARAM(native_id);
+    LLSEC_UNUSED_PARAM(file_id);
+    LLSEC_UNUSED_PARAM(position);
+    LLSEC_UNUSED_PARAM(length);
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+    if (NULL == job) {
+        return;
+    }
+    FS_read_range_t* params = (FS_read_range_t*)job->params;
+    int32_t result = params->result;
+    int32_t error_code = params->error_code;
+    const char* error_message = params->error_message;
+    (void)MICROEJ_ASYNC_WORKER_free_job(LLFS_worker_of_job(job), job);
+
+    if (LLFS_EOF == result) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "LLSEC_SIG_IMPL_stream_update_from_file: range after the end of the file");
+    } else if (LLFS_OK != result) {
+        (void)SNI_throwNativeException(error_code, error_message);
+    } else {
+        // Whole range hashed
+    }
+}
+
+void LLSEC_SIG_IMPL_stream_update_from_file(int32_t native_id, int32_t file_id, int64_t position, int64_t length) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+
+    /* Hashed by the FS worker of the file, in order with the other operations on the file */
+    (void)LLFS_File_read_range(file_id, position, length, LLSEC_SIG_stream_consume, &stream->md_ctx,
+                               (SNI_callback)LLSEC_SIG_IMPL_stream_update_from_file, (SNI_callback)LLSEC_SIG_IMPL_stream_update_from_file_on_done);
+}
+
+uint8_t LLSEC_SIG_IMPL_stream_verify(int32_t native_id, uint8_t* signature, int32_t signature_length, int32_t public_key_id) {
+    uint8_t return_code = JTRUE;
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+    uint8_t digest[MBEDTLS_MD_MAX_SIZE];
+    int32_t digest_length = 0;
+
+    int rc = LLSEC_SIG_stream_finish(stream, digest, &digest_length);
+    if (LLSEC_SUCCESS == rc) {
+        rc = stream->algorithm->verify(stream->algorithm, signature, signature_length, (LLSEC_pub_key*)public_key_id, digest, digest_length);
+    }
+
+    if (LLSEC_SUCCESS != rc) {
+        (void)SNI_throwNativeException(rc, "LLSEC_SIG_IMPL_stream_verify failed");
+        return_code = JFALSE;
+    }
+
+    return return_code;
+}
+
+int32_t LLSEC_SIG_IMPL_stream_sign(int32_t native_id, uint8_t* signature, int32_t signature_length, int32_t private_key_id) {
+    int32_t return_code = JFALSE;
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream* stream = (LLSEC_SIG_stream*)native_id;
+    uint8_t digest[MBEDTLS_MD_MAX_SIZE];
+    int32_t digest_length = 0;
+
+    int rc = LLSEC_SIG_stream_finish(stream, digest, &digest_length);
+    if (LLSEC_SUCCESS == rc) {
+        rc = stream->algorithm->sign(stream->algorithm, signature, &signature_length, (LLSEC_priv_key*)private_key_id, digest, digest_length);
+    }
+
+    if (LLSEC_SUCCESS != rc) {
+        (void)SNI_throwNativeException(rc, "LLSEC_SIG_IMPL_stream_sign failed");
+    } else {
+        return_code = signature_length;
+    }
+
+    return return_code;
+}
+
+void LLSEC_SIG_IMPL_stream_close(int32_t native_id) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    LLSEC_SIG_stream_close((void*)native_id);
+
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    if (SNI_OK != SNI_unregisterResource((void*)native_id, (SNI_closeFunction)LLSEC_SIG_stream_close)) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Can't unregister SNI native resource");
+    }
+}
+
+int32_t LLSEC_SIG_IMPL_stream_get_close_id(void) {
+    LLSEC_SIG_DEBUG_TRACE("%s \n", __func__);
+    // cppcheck-suppress misra-c2012-11.1 // Abstract data type for SNI usage
+    return (int32_t)LLSEC_SIG_stream_close;
+}
@@ -0,0 +1,366 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief X509 certificate path validation for MbedTLS Library, independent of SNI.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#include <LLSEC_X509_CERT_PATH_helper.h>
+#include <LLSEC_configuration.h>
+#include <string.h>
+
+#include "LLSEC_mbedtls.h"
+#include "mbedtls/md.h"
+#include "mbedtls/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LLSEC_X509_CERT_PATH_DIGEST_SIZE (32) /* SHA-256 */
+
+#if LLSEC_X509_CERT_PATH_CACHE_SIZE < 1
+#error "LLSEC_X509_CERT_PATH_CACHE_SIZE must be greater than or equal to 1"
+#endif
+
+/*
+ * Verified certificate link entry.
+ * The digest is the SHA-256 of the encoded issuer certificate followed by the encoded subject certificate:
+ * the signature check result only depends on these bytes.
+ */
+typedef struct {
+    uint8_t used;
+    uint32_t last_use;
+    uint8_t digest[LLSEC_X509_CERT_PATH_DIGEST_SIZE];
+} LLSEC_X509_CERT_PATH_cache_entry;
+
+/*
+ * LRU cache of verified certificate links.
+ * Only accessed from SNI natives, i.e. from the MicroEJ VM task: no locking required.
+ */
+static LLSEC_X509_CERT_PATH_cache_entry llsec_x509_cert_path_cache[LLSEC_X509_CERT_PATH_CACHE_SIZE];
+static uint32_t llsec_x509_cert_path_cache_clock = 0;
+static uint32_t llsec_x509_cert_path_cache_hits = 0;
+
+static int parse_into_chain(mbedtls_x509_crt* chain, int8_t* cert_data, int32_t len);
+static int32_t parse_certificates(mbedtls_x509_crt* chain, mbedtls_x509_crt** certs, int8_t* data, int32_t* lengths, int32_t count);
+static uint8_t is_self_issued(const mbedtls_x509_crt* crt);
+static int compute_link_digest(const uint8_t* issuer, size_t issuer_length, const uint8_t* subject, size_t subject_length, uint8_t* digest);
+static LLSEC_X509_CERT_PATH_cache_entry* find_verified_link(const uint8_t* digest);
+static int32_t check_certificate_link(const mbedtls_x509_crt* subject, mbedtls_x509_crt* issuer, uint8_t issuer_is_trusted, int32_t intermediate_count);
+
+int32_t LLSEC_X509_CERT_check_validity_period(const mbedtls_x509_crt* x509) {
+    int32_t return_code;
+    int mbedtls_is_past = mbedtls_x509_time_is_past(&x509->valid_to);
+    int mbedtls_is_future = mbedtls_x509_time_is_future(&x509->valid_from);
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_is_past) {
+        LLSEC_X509_DEBUG_TRACE("LLSEC_X509 time is past");
+        return_code = J_X509_CERT_EXPIRED_ERROR;
+    } else if (LLSEC_MBEDTLS_SUCCESS != mbedtls_is_future) {
+        LLSEC_X509_DEBUG_TRACE("LLSEC_X509 time is future");
+        return_code = J_X509_CERT_NOT_YET_VALID_ERROR;
+    } else {
+        return_code = J_SEC_NO_ERROR;
+    }
+    return return_code;
+}
+
+/**
+ * @brief Parses a DER or PEM certificate and appends it to the given chain.
+ *
+ * @return LLSEC_MBEDTLS_SUCCESS on success, a mbedTLS error code otherwise.
+ */
+static int parse_into_chain(mbedtls_x509_crt* chain, int8_t* cert_data, int32_t len) {
+    int mbedtls_rc = mbedtls_x509_crt_parse_der(chain, (const uint8_t*)cert_data, len);
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        /* PEM parsing requires a NUL-terminated buffer */
+        int8_t* tmp_cert_data = (int8_t*)mbedtls_calloc(1, len + 1);
+        if (NULL == tmp_cert_data) {
+            mbedtls_rc = MBEDTLS_ERR_X509_ALLOC_FAILED;
+        } else {
+            (void)memcpy(tmp_cert_data, cert_data, len);
+            tmp_cert_data[len] = '\0';
+            mbedtls_rc = mbedtls_x509_crt_parse(chain, (const uint8_t*)tmp_cert_data, len + 1);
+            mbedtls_free(tmp_cert_data);
+        }
+    }
+    return mbedtls_rc;
+}
+
+/**
+ * @brief Parses <code>count</code> concatenated certificates into <code>chain</code>.
+ *
+ * @param[out] certs the parsed certificates, in the given order. May be NULL.
+ *
+ * @return {@link J_SEC_NO_ERROR} on success, {@link J_CERT_PARSE_ERROR} or {@link J_MEMORY_ERROR} on error.
+ */
+static int32_t parse_certificates(mbedtls_x509_crt* chain, mbedtls_x509_crt** certs, int8_t* data, int32_t* lengths, int32_t count) {
+    int32_t return_code = J_SEC_NO_ERROR;
+    int32_t offset = 0;
+    int32_t i;
+
+    for (i = 0; (i < count) && (J_SEC_NO_ERROR == return_code); i++) {
+        if (lengths[i] <= 0) {
+            return_code = J_CERT_PARSE_ERROR;
+        } else {
+            int mbedtls_rc = parse_into_chain(chain, &data[offset], lengths[i]);
+            if (MBEDTLS_ERR_X509_ALLOC_FAILED == mbedtls_rc) {
+                return_code = J_MEMORY_ERROR;
+            } else if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+                LLSEC_X509_DEBUG_TRACE("%s. certificate %d parse fail, return_code: %d\n", __func__, (int)i, mbedtls_rc);
+                return_code = J_CERT_PARSE_ERROR;
+            } else {
+                offset += lengths[i];
+            }
+        }
+    }
+
+    if (J_SEC_NO_ERROR == return_code) {
+        /* A PEM entry may hold several certificates: check that each entry gave exactly one */
+        int32_t parsed = 0;
+        mbedtls_x509_crt* crt;
+        for (crt = chain; (NULL != crt) && (NULL != crt->raw.p); crt = crt->next) {
+            if ((NULL != certs) && (parsed < count)) {
+                certs[parsed] = crt;
+            }
+            parsed++;
+        }
+        if (parsed != count) {
+            return_code = J_CERT_PARSE_ERROR;
+        }
+    }
+
+    return return_code;
+}
+
+/**
+ * @brief Checks whether a certificate is self-issued (same subject and issuer names, RFC 5280 section 3.3.1).
+ */
+static uint8_t is_self_issued(const mbedtls_x509_crt* crt) {
+    return ((crt->issuer_raw.len == crt->subject_raw.len) &&
+            (0 == memcmp(crt->issuer_raw.p, crt->subject_raw.p, crt->issuer_raw.len))) ? (uint8_t)1 : (uint8_t)0;
+}
+
+/**
+ * @brief Computes the link cache key: the SHA-256 of the encoded issuer followed by the encoded subject.
+ *
+ * @return LLSEC_MBEDTLS_SUCCESS on success, a mbedTLS error code otherwise.
+ */
+static int compute_link_digest(const uint8_t* issuer, size_t issuer_length, const uint8_t* subject, size_t subject_length, uint8_t* digest) {
+    mbedtls_md_context_t md_ctx;
+    mbedtls_md_init(&md_ctx);
+    int mbedtls_rc = mbedtls_md_setup(&md_ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0);
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_md_starts(&md_ctx);
+    }
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_md_update(&md_ctx, issuer, issuer_length);
+    }
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_md_update(&md_ctx, subject, subject_length);
+    }
+    if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+        mbedtls_rc = mbedtls_md_finish(&md_ctx, digest);
+    }
+    mbedtls_md_free(&md_ctx);
+    return mbedtls_rc;
+}
+
+/**
+ * @brief Returns the link cache entry holding the given digest, or NULL if there is none.
+ */
+static LLSEC_X509_CERT_PATH_cache_entry* find_verified_link(const uint8_t* digest) {
+    LLSEC_X509_CERT_PATH_cache_entry* entry = NULL;
+    int i;
+
+    for (i = 0; i < LLSEC_X509_CERT_PATH_CACHE_SIZE; i++) {
+        LLSEC_X509_CERT_PATH_cache_entry* current = &llsec_x509_cert_path_cache[i];
+        if (((uint8_t)0 != current->used) && (0 == memcmp(current->digest, digest, LLSEC_X509_CERT_PATH_DIGEST_SIZE))) {
+            entry = current;
+            break;
+        }
+    }
+    return entry;
+}
+
+/**
+ * @brief Checks that <code>issuer</code> issued <code>subject</code>.
+ *
+ * The issuer must be allowed to sign certificates: CA basic constraint (unless it is trusted), keyCertSign key usage
+ * when the key usage extension is present, and path length constraint (RFC 5280 section 4.2.1.9). The signature check
+ * is skipped if this link has already been verified.
+ *
+ * @param[in] intermediate_count            The number of non self-issued intermediate certificates between the
+ *                                          issuer and the end-entity certificate.
+ *
+ * @return {@link J_SEC_NO_ERROR} on success, {@link J_NAME_CHAINING_ERROR}, {@link J_NOT_CA_CERT},
+ * {@link J_MAX_CHAIN_ERROR}, {@link J_VERIFY_CERT_ERROR} or {@link J_MEMORY_ERROR} on error.
+ */
+static int32_t check_certificate_link(const mbedtls_x509_crt* subject, mbedtls_x509_crt* issuer, uint8_t issuer_is_trusted, int32_t intermediate_count) {
+    int32_t return_code = J_SEC_NO_ERROR;
+    LLSEC_X509_CERT_PATH_cache_entry* entry = NULL;
+    uint8_t digest[LLSEC_X509_CERT_PATH_DIGEST_SIZE];
+    int i;
+
+    if ((subject->issuer_raw.len != issuer->subject_raw.len) ||
+        (0 != memcmp(subject->issuer_raw.p, issuer->subject_raw.p, subject->issuer_raw.len))) {
+        return_code = J_NAME_CHAINING_ERROR;
+    } else if (((uint8_t)0 == issuer_is_trusted) && (0 == issuer->LLSEC_MBEDTLS_PRIVATE(ca_istrue))) {
+        return_code = J_NOT_CA_CERT;
+#if defined(MBEDTLS_X509_CHECK_KEY_USAGE)
+    } else if (0 != mbedtls_x509_crt_check_key_usage(issuer, MBEDTLS_X509_KU_KEY_CERT_SIGN)) {
+        return_code = J_NOT_CA_CERT;
+#endif
+    } else if ((0 < issuer->LLSEC_MBEDTLS_PRIVATE(max_pathlen)) && (issuer->LLSEC_MBEDTLS_PRIVATE(max_pathlen) <= intermediate_count)) {
+        /* mbedTLS stores the pathLenConstraint plus one, 0 meaning no constraint */
+        return_code = J_MAX_CHAIN_ERROR;
+    } else if (LLSEC_MBEDTLS_SUCCESS != compute_link_digest(issuer->raw.p, issuer->raw.len, subject->raw.p, subject->raw.len, digest)) {
+        return_code = J_MEMORY_ERROR;
+    } else {
+        llsec_x509_cert_path_cache_clock++;
+        entry = find_verified_link(digest);
+        if (NULL != entry) {
+            LLSEC_X509_DEBUG_TRACE("%s. link already verified\n", __func__);
+            llsec_x509_cert_path_cache_hits++;
+            entry->last_use = llsec_x509_cert_path_cache_clock;
+        } else {
+            unsigned char hash[MBEDTLS_MD_MAX_SIZE];
+            mbedtls_md_type_t sig_md = subject->LLSEC_MBEDTLS_PRIVATE(sig_md);
+            const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(sig_md);
+            int mbedtls_rc = -1;
+
+            if ((NULL != md_info) && mbedtls_pk_can_do(&issuer->pk, subject->LLSEC_MBEDTLS_PRIVATE(sig_pk))) {
+                mbedtls_rc = mbedtls_md(md_info, subject->tbs.p, subject->tbs.len, hash);
+            }
+            if (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) {
+                mbedtls_rc = mbedtls_pk_verify_ext(subject->LLSEC_MBEDTLS_PRIVATE(sig_pk), subject->LLSEC_MBEDTLS_PRIVATE(sig_opts),
+                                                   &issuer->pk, sig_md, hash, mbedtls_md_get_size(md_info),
+                                                   subject->LLSEC_MBEDTLS_PRIVATE(sig).p, subject->LLSEC_MBEDTLS_PRIVATE(sig).len);
+            }
+
+            if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+                LLSEC_X509_DEBUG_TRACE("%s. signature check fail, return_code: %d\n", __func__, mbedtls_rc);
+                return_code = J_VERIFY_CERT_ERROR;
+            } else {
+                /* Store in a free entry or evict the least recently used one */
+                entry = &llsec_x509_cert_path_cache[0];
+                for (i = 0; i < LLSEC_X509_CERT_PATH_CACHE_SIZE; i++) {
+                    LLSEC_X509_CERT_PATH_cache_entry* current = &llsec_x509_cert_path_cache[i];
+                    if ((uint8_t)0 == current->used) {
+                        entry = current;
+                        break;
+                    }
+                    // Wrap-safe age comparison
+                    if ((llsec_x509_cert_path_cache_clock - current->last_use) > (llsec_x509_cert_path_cache_clock - entry->last_use)) {
+                        entry = current;
+                    }
+                }
+                entry->used = (uint8_t)1;
+                entry->last_use = llsec_x509_cert_path_cache_clock;
+                (void)memcpy(entry->digest, digest, sizeof(digest));
+            }
+        }
+    }
+
+    return return_code;
+}
+
+int32_t LLSEC_X509_CERT_PATH_validate(int8_t* certs, int32_t* cert_lengths, int32_t cert_count,
+                                      int8_t* trusted_certs, int32_t* trusted_cert_lengths, int32_t trusted_cert_count) {
+    int32_t return_code = J_SEC_NO_ERROR;
+    mbedtls_x509_crt chain;
+    mbedtls_x509_crt trusted;
+    mbedtls_x509_crt* path[LLSEC_X509_CERT_PATH_MAX_LENGTH];
+    int32_t intermediate_count = 0;
+    int32_t i;
+
+    mbedtls_x509_crt_init(&chain);
+    mbedtls_x509_crt_init(&trusted);
+
+    if ((cert_count <= 0) || (trusted_cert_count < 0)) {
+        return_code = LLSEC_ERROR;
+    } else if (cert_count > LLSEC_X509_CERT_PATH_MAX_LENGTH) {
+        return_code = J_MAX_CHAIN_ERROR;
+    } else {
+        return_code = parse_certificates(&chain, path, certs, cert_lengths, cert_count);
+    }
+
+    if (J_SEC_NO_ERROR == return_code) {
+        return_code = parse_certificates(&trusted, NULL, trusted_certs, trusted_cert_lengths, trusted_cert_count);
+    }
+
+    /* Validity period of every certificate of the chain */
+    for (i = 0; (i < cert_count) && (J_SEC_NO_ERROR == return_code); i++) {
+        return_code = LLSEC_X509_CERT_check_validity_period(path[i]);
+    }
+
+    /* Links inside the chain */
+    for (i = 0; (i < (cert_count - 1)) && (J_SEC_NO_ERROR == return_code); i++) {
+        if ((0 < i) && ((uint8_t)0 == is_self_issued(path[i]))) {
+            intermediate_count++;
+        }
+        return_code = check_certificate_link(path[i], path[i + 1], (uint8_t)0, intermediate_count);
+    }
+    if ((1 < cert_count) && ((uint8_t)0 == is_self_issued(path[cert_count - 1]))) {
+        /* The last certificate is an intermediate below the trust anchor */
+        intermediate_count++;
+    }
+
+    /* Link to a trust anchor */
+    if (J_SEC_NO_ERROR == return_code) {
+        const mbedtls_x509_crt* last = path[cert_count - 1];
+        int32_t anchor_code = J_NO_TRUSTED_CERT;
+        mbedtls_x509_crt* anchor;
+
+        for (anchor = &trusted; (NULL != anchor) && (NULL != anchor->raw.p) && (J_SEC_NO_ERROR != anchor_code); anchor = anchor->next) {
+            if ((last->raw.len == anchor->raw.len) && (0 == memcmp(last->raw.p, anchor->raw.p, last->raw.len))) {
+                /* The last certificate is itself trusted */
+                anchor_code = J_SEC_NO_ERROR;
+            } else if ((last->issuer_raw.len == anchor->subject_raw.len) &&
+                       (0 == memcmp(last->issuer_raw.p, anchor->subject_raw.p, last->issuer_raw.len))) {
+                /* Candidate issuer: keep looking for another one with the same name if it does not verify */
+                anchor_code = check_certificate_link(last, anchor, (uint8_t)1, intermediate_count);
+            } else {
+                /* Not related */
+            }
+        }
+        return_code = anchor_code;
+    }
+
+    mbedtls_x509_crt_free(&chain);
+    mbedtls_x509_crt_free(&trusted);
+
+    return return_code;
+}
+
+uint8_t LLSEC_X509_CERT_PATH_is_link_verified(const uint8_t* issuer, int32_t issuer_length,
+                                              const uint8_t* subject, int32_t subject_length) {
+    uint8_t verified = (uint8_t)0;
+    uint8_t digest[LLSEC_X509_CERT_PATH_DIGEST_SIZE];
+
+    if ((LLSEC_MBEDTLS_SUCCESS == compute_link_digest(issuer, (size_t)issuer_length, subject, (size_t)subject_length, digest)) &&
+        (NULL != find_verified_link(digest))) {
+        verified = (uint8_t)1;
+    }
+    return verified;
+}
+
+uint32_t LLSEC_X509_CERT_PATH_get_cache_hit_count(void) {
+    return llsec_x509_cert_path_cache_hits;
+}
+
+void LLSEC_X509_CERT_PATH_clear_cache(void) {
+    (void)memset(llsec_x509_cert_path_cache, 0, sizeof(llsec_x509_cert_path_cache));
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -14,12 +14,16 @@
  */
 
 #include <LLSEC_X509_CERT_impl.h>
+#include <LLSEC_X509_CERT_PATH_impl.h>
+#include <LLSEC_X509_CERT_PATH_helper.h>
 #include <LLSEC_configuration.h>
 #include <sni.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "LLSEC_mbedtls.h"
+#include "mbedtls/version.h"
+#include "mbedtls/md.h"
 #include "mbedtls/platform.h"
 #include "mbedtls/ssl.h"
 
@@ -29,7 +33,33 @@ extern "C" {
 
 #define LLSEC_X509_UNKNOWN_FORMAT ((int)(-1))
 
+#define LLSEC_X509_CERT_CACHE_DIGEST_SIZE (32) /* SHA-256 */
+
+#if LLSEC_X509_CERT_CACHE_SIZE < 1
+#error "LLSEC_X509_CERT_CACHE_SIZE must be greater than or equal to 1"
+#endif
+
+/*
+ * Parsed certificate cache entry.
+ * Entries are identified by the SHA-256 digest and the length of the encoded certificate.
+ */
+typedef struct {
+    mbedtls_x509_crt* crt;
+    int32_t cert_length;
+    int32_t cert_format;
+    uint32_t last_use;
+    uint8_t digest[LLSEC_X509_CERT_CACHE_DIGEST_SIZE];
+} LLSEC_X509_CERT_cache_entry;
+
+/*
+ * LRU cache of parsed certificates.
+ * Only accessed from SNI natives, i.e. from the MicroEJ VM task: no locking required.
+ */
+static LLSEC_X509_CERT_cache_entry llsec_x509_cert_cache[LLSEC_X509_CERT_CACHE_SIZE];
+static uint32_t llsec_x509_cert_cache_clock = 0;
+
 static mbedtls_x509_crt* get_x509_certificate(int8_t* cert_data, int32_t len, int32_t* cert_format);
+static mbedtls_x509_crt* get_cached_x509_certificate(int8_t* cert_data, int32_t len, int32_t* cert_format);
 static int32_t LLSEC_X509_CERT_mbedtls_close_key(int32_t native_id);
 
 static mbedtls_x509_crt* get_x509_certificate(int8_t* cert_data, int32_t len, int32_t* cert_format) {
@@ -62,8 +92,9 @@ static mbedtls_x509_crt* get_x509_certificate(int8_t* cert_data, int32_t len, in
         }
     }
 
-    if (NULL != new_cert) {
+    if ((NULL != new_cert) && (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc)) {
         /* Parse the X509 PEM certificate */
+        mbedtls_x509_crt_free(new_cert);
         mbedtls_x509_crt_init(new_cert);
 
         /* To avoid tmp_cert_data is not a string, which causes mbedtls_x509_crt_parse error */
@@ -94,18 +125,94 @@ static mbedtls_x509_crt* get_x509_certificate(int8_t* cert_data, int32_t len, in
     return new_cert;
 }
 
-static int32_t LLSEC_X509_CERT_mbedtls_close_key(int32_t native_id) {
-    LLSEC_X509_DEBUG_TRACE("%s \n", __func__);
-    int return_code = LLSEC_SUCCESS;
-    LLSEC_pub_key* key = (LLSEC_pub_key*)native_id;
+/**
+ * @brief Returns the parsed form of the given certificate, parsing it only if it is not already in the cache.
+ *
+ * The returned certificate is owned by the cache: it must not be freed by the caller and must not be
+ * referenced after the native returns, since it may be evicted by a subsequent call.
+ *
+ * @param[in] cert_data    the encoded (DER or PEM) certificate.
+ * @param[in] len          the certificate length.
+ * @param[out] cert_format the certificate format (CERT_DER_FORMAT, CERT_PEM_FORMAT) or an error code. May be NULL.
+ *
+ * @return the parsed certificate, or NULL if it can't be allocated or parsed.
+ */
+static mbedtls_x509_crt* get_cached_x509_certificate(int8_t* cert_data, int32_t len, int32_t* cert_format) {
+    mbedtls_x509_crt* cert = NULL;
+    LLSEC_X509_CERT_cache_entry* entry = NULL;
+    uint8_t digest[LLSEC_X509_CERT_CACHE_DIGEST_SIZE] = {0};
+    int32_t format = LLSEC_X509_UNKNOWN_FORMAT;
+    int i;
 
-    if (TYPE_RSA == key->type) {
-        mbedtls_rsa_free((mbedtls_rsa_context*)key->key);
+    llsec_x509_cert_cache_clock++;
+    int mbedtls_rc = mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const unsigned char*)cert_data, (size_t)len, digest);
+    if (LLSEC_MBEDTLS_SUCCESS != mbedtls_rc) {
+        LLSEC_X509_DEBUG_TRACE("%s. mbedtls_md fail, return_code: %d\n", __func__, mbedtls_rc);
     } else {
-        mbedtls_ecdsa_free((mbedtls_ecdsa_context*)key->key);
+        for (i = 0; i < LLSEC_X509_CERT_CACHE_SIZE; i++) {
+            LLSEC_X509_CERT_cache_entry* current = &llsec_x509_cert_cache[i];
+            if ((NULL != current->crt) && (len == current->cert_length) &&
+                (0 == memcmp(current->digest, digest, sizeof(digest)))) {
+                LLSEC_X509_DEBUG_TRACE("%s. cache hit (entry %d)\n", __func__, i);
+                current->last_use = llsec_x509_cert_cache_clock;
+                cert = current->crt;
+                format = current->cert_format;
+                break;
+            }
+        }
+    }
+
+    if (NULL == cert) {
+        cert = get_x509_certificate(cert_data, len, &format);
+        if ((NULL != cert) && (CERT_DER_FORMAT != format) && (CERT_PEM_FORMAT != format)) {
+            mbedtls_x509_crt_free(cert);
+            mbedtls_free(cert);
+            cert = NULL;
+        }
+
+        if (NULL != cert) {
+            /* Store in a free entry or evict the least recently used one */
+            entry = &llsec_x509_cert_cache[0];
+            for (i = 0; i < LLSEC_X509_CERT_CACHE_SIZE; i++) {
+                LLSEC_X509_CERT_cache_entry* current = &llsec_x509_cert_cache[i];
+                if (NULL == current->crt) {
+                    entry = current;
+                    break;
+                }
+                // Wrap-safe age comparison
+                if ((llsec_x509_cert_cache_clock - current->last_use) > (llsec_x509_cert_cache_clock - entry->last_use)) {
+                    entry = current;
+                }
+            }
+
+            if (NULL != entry->crt) {
+                LLSEC_X509_DEBUG_TRACE("%s. evict entry %d\n", __func__, (int)(entry - &llsec_x509_cert_cache[0]));
+                mbedtls_x509_crt_free(entry->crt);
+                mbedtls_free(entry->crt);
+            }
+            entry->crt = cert;
+            /* If the digest could not be computed, the entry only keeps the certificate alive and never matches */
+            entry->cert_length = (LLSEC_MBEDTLS_SUCCESS == mbedtls_rc) ? len : -1;
+            entry->cert_format = format;
+            entry->last_use = llsec_x509_cert_cache_clock;
+            (void)memcpy(entry->digest, digest, sizeof(digest));
+        }
+    }
+
+    if (NULL != cert_format) {
+        *cert_format = format;
     }
 
-    mbedtls_free(key);
+    return cert;
+}
+
+static int32_t LLSEC_X509_CERT_mbedtls_close_key(int32_t native_id) {
+    LLSEC_X509_DEBUG_TRACE("%s \n", __func__);
+    int return_code = LLSEC_SUCCESS;
+
+    /* The key may still be used by a RSA cipher: it is freed by its last user */
+    // cppcheck-suppress misra-c2012-11.6 // Abstract data type for SNI usage
+    llsec_pub_key_close((void*)native_id);
     return return_code;
 }
 
@@ -114,13 +221,9 @@ int32_t LLSEC_X509_CERT_IMPL_parse(int8_t* cert, int32_t off, int32_t len) {
 
     int32_t format = LLSEC_X509_UNKNOWN_FORMAT;
     int8_t* cert_data = &cert[off];
-    mbedtls_x509_crt* tmp_cert = get_x509_certificate(cert_data, len, &format);
 
-    /* Free the X509 certificate */
-    if (NULL != tmp_cert) {
-        mbedtls_x509_crt_free(tmp_cert);
-        mbedtls_free(tmp_cert);
-    }
+    /* Keep the parsed certificate in the cache: it is usually inspected right after being parsed */
+    (void)get_cached_x509_certificate(cert_data, len, &format);
 
     return format;
 }
@@ -142,7 +245,7 @@ int32_t LLSEC_X509_CERT_IMPL_get_x500_principal_data(int8_t* cert_data, int32_t
     int32_t return_code = LLSEC_SUCCESS;
     LLSEC_X509_DEBUG_TRACE("%s(cert=%p, Cert_len=%d,prin_len=%d,get_issuer=%d)\n", __func__, cert_data, (int)cert_data_length, (int)principal_data_length, (int)get_issuer);
 
-    mbedtls_x509_crt* x509 = get_x509_certificate(cert_data, cert_data_length, NULL);
+    mbedtls_x509_crt* x509 = get_cached_x509_certificate(cert_data, cert_data_length, NULL);
     if (NULL == x509) {
         (void)SNI_throwNativeException(LLSEC_ERROR, "Bad x509 certificate");
         return_code = LLSEC_ERROR;
@@ -162,11 +265,6 @@ int32_t LLSEC_X509_CERT_IMPL_get_x500_principal_data(int8_t* cert_data, int32_t
             return_code = LLSEC_ERROR;
         } else {
             (void)memcpy(principal_data, &buf[0], len);
-
-            /* Free the X509 certificate */
-            mbedtls_x509_crt_free(x509);
-            mbedtls_free(x509);
-
             return_code = len;
         }
     }
@@ -200,6 +298,7 @@ int32_t LLSEC_X509_CERT_IMPL_get_key(int8_t* cert_data, int32_t cert_data_length
     }
 
     if(LLSEC_SUCCESS == return_code) {
+        /* Not taken from the cache: the returned key points into the certificate and outlives this call */
         x509 = get_x509_certificate(cert_data, cert_data_length, NULL);
         if (NULL == x509) {
             (void)SNI_throwNativeException(LLSEC_ERROR, "Bad x509 certificate");
@@ -258,7 +357,7 @@ int32_t LLSEC_X509_CERT_IMPL_verify(int8_t* cert_data, int32_t cert_data_length,
     LLSEC_X509_DEBUG_TRACE("%s \n", __func__);
     int return_code = LLSEC_SUCCESS;
 
-    mbedtls_x509_crt* x509 = get_x509_certificate(cert_data, cert_data_length, NULL);
+    mbedtls_x509_crt* x509 = get_cached_x509_certificate(cert_data, cert_data_length, NULL);
     if (NULL == x509) {
         (void)SNI_throwNativeException(LLSEC_ERROR, "Bad x509 certificate");
         return_code = LLSEC_ERROR;
@@ -274,11 +373,6 @@ int32_t LLSEC_X509_CERT_IMPL_verify(int8_t* cert_data, int32_t cert_data_length,
         }
     }
 
-    if(NULL != x509) {
-        mbedtls_x509_crt_free(x509);
-        mbedtls_free(x509);
-    }
-
     return return_code;
 }
 
@@ -297,29 +391,14 @@ int32_t LLSEC_X509_CERT_IMPL_check_validity(int8_t* cert_data, int32_t cert_data
     LLSEC_X509_DEBUG_TRACE("%s \n", __func__);
     int return_code = LLSEC_SUCCESS;
 
-    mbedtls_x509_crt* x509 = get_x509_certificate(cert_data, cert_data_length, NULL);
+    mbedtls_x509_crt* x509 = get_cached_x509_certificate(cert_data, cert_data_length, NULL);
     if (NULL == x509) {
         (void)SNI_throwNativeException(LLSEC_ERROR, "Bad x509 certificate");
         return_code = LLSEC_ERROR;
     }
 
     if (LLSEC_SUCCESS == return_code) {
-        int mbedtls_is_past = mbedtls_x509_time_is_past(&x509->valid_to);
-        int mbedtls_is_future = mbedtls_x509_time_is_future(&x509->valid_from);
-        if (LLSEC_MBEDTLS_SUCCESS != mbedtls_is_past) {
-            LLSEC_X509_DEBUG_TRACE("LLSEC_X509 time is past");
-            return_code = J_X509_CERT_EXPIRED_ERROR;
-        } else if (LLSEC_MBEDTLS_SUCCESS != mbedtls_is_future) {
-            LLSEC_X509_DEBUG_TRACE("LLSEC_X509 time is future");
-            return_code = J_X509_CERT_NOT_YET_VALID_ERROR;
-        } else {
-            return_code = J_SEC_NO_ERROR;
-        }
-    }
-
-    if(NULL != x509) {
-        mbedtls_x509_crt_free(x509);
-        mbedtls_free(x509);
+        return_code = LLSEC_X509_CERT_check_validity_period(x509);
     }
 
     return return_code;
@@ -336,3 +415,21 @@ int32_t LLSEC_X509_CERT_IMPL_get_close_key(void) {
     LLSEC_X509_DEBUG_TRACE("%s \n", __func__);
     return (int32_t)LLSEC_X509_CERT_mbedtls_close_key;
 }
+
+int32_t LLSEC_X509_CERT_PATH_IMPL_validate(int8_t* certs, int32_t* cert_lengths, int32_t cert_count,
+                                           int8_t* trusted_certs, int32_t* trusted_cert_lengths, int32_t trusted_cert_count) {
+    LLSEC_X509_DEBUG_TRACE("%s(cert_count=%d, trusted_cert_count=%d)\n", __func__, (int)cert_count, (int)trusted_cert_count);
+
+    int32_t return_code = LLSEC_X509_CERT_PATH_validate(certs, cert_lengths, cert_count,
+                                                        trusted_certs, trusted_cert_lengths, trusted_cert_count);
+    if (LLSEC_ERROR == return_code) {
+        (void)SNI_throwNativeException(LLSEC_ERROR, "Invalid certificate count");
+    } else if (J_MEMORY_ERROR == return_code) {
+        (void)SNI_throwNativeException(J_MEMORY_ERROR, "Can't allocate certificate");
+    } else {
+        /* Validation result returned to the caller */
+    }
+
+    LLSEC_X509_DEBUG_TRACE("%s: return_code = %d\n", __func__, (int)return_code);
+    return return_code;
+}
@@ -0,0 +1,582 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Ed25519 signatures (RFC 8032), for the mbedTLS versions that do not implement EdDSA.
+ *
+ * The field and group arithmetic is derived from the public domain TweetNaCl library
+ * (https://tweetnacl.cr.yp.to): small and constant-time, at the expense of speed. SHA-512 is provided by mbedTLS.
+ * The points and the scalar reduction buffer are allocated on the heap so that signatures can be computed from the
+ * VM task.
+ *
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#include <LLSEC_ed25519.h>
+#include <string.h>
+
+#include "mbedtls/version.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/sha512.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MBEDTLS_VERSION_MAJOR == 2)
+#define llsec_ed25519_sha512_starts(ctx)            mbedtls_sha512_starts_ret((ctx), 0)
+#define llsec_ed25519_sha512_update(ctx, in, len)   mbedtls_sha512_update_ret((ctx), (in), (len))
+#define llsec_ed25519_sha512_finish(ctx, out)       mbedtls_sha512_finish_ret((ctx), (out))
+#elif (MBEDTLS_VERSION_MAJOR == 3)
+#define llsec_ed25519_sha512_starts(ctx)            mbedtls_sha512_starts((ctx), 0)
+#define llsec_ed25519_sha512_update(ctx, in, len)   mbedtls_sha512_update((ctx), (in), (len))
+#define llsec_ed25519_sha512_finish(ctx, out)       mbedtls_sha512_finish((ctx), (out))
+#else
+#error "Unsupported mbedTLS major version"
+#endif
+
+#define LLSEC_ED25519_ERROR (-1)
+
+/* Element of GF(2^255 - 19): 16 limbs of 16 bits, with room for the carries */
+typedef int64_t gf[16];
+
+/*
+ * Working memory of a key computation, a signature or a verification.
+ */
+typedef struct {
+    gf p[4];
+    gf q[4];
+    gf s[4];
+    int64_t x[64];
+    uint8_t d[64];
+    uint8_t r[64];
+    uint8_t h[64];
+    uint8_t t[32];
+    mbedtls_sha512_context sha;
+} llsec_ed25519_work;
+
+static const gf gf0 = {0};
+static const gf gf1 = {1};
+/* Curve constant d = -121665/121666 */
+static const gf D = {
+    0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+    0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203
+};
+/* 2 * d */
+static const gf D2 = {
+    0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+    0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406
+};
+/* Base point coordinates */
+static const gf X = {
+    0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+    0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169
+};
+static const gf Y = {
+    0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+    0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666
+};
+/* sqrt(-1) */
+static const gf I = {
+    0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+    0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83
+};
+/* Order of the base point, little-endian */
+static const int64_t L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+};
+
+/* Domain separation prefix of Ed25519ph (RFC 8032 section 5.1): dom2(1, empty context) */
+static const uint8_t dom2_ph[34] = {
+    'S', 'i', 'g', 'E', 'd', '2', '5', '5', '1', '9', ' ', 'n', 'o', ' ',
+    'E', 'd', '2', '5', '5', '1', '9', ' ', 'c', 'o', 'l', 'l', 'i', 's', 'i', 'o', 'n', 's',
+    1, 0
+};
+
+static void set25519(gf r, const gf a) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        r[i] = a[i];
+    }
+}
+
+static void car25519(gf o) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        o[i] += ((int64_t)1 << 16);
+        int64_t c = o[i] >> 16;
+        if (i < 15) {
+            o[i + 1] += c - 1;
+        } else {
+            o[0] += 38 * (c - 1);
+        }
+        o[i] -= c * ((int64_t)1 << 16);
+    }
+}
+
+/* Swaps p and q if b is 1, in constant time */
+static void sel25519(gf p, gf q, int b) {
+    int64_t c = ~((int64_t)b - 1);
+    int i;
+    for (i = 0; i < 16; i++) {
+        int64_t t = c & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+    }
+}
+
+static void pack25519(uint8_t* o, const gf n) {
+    int i;
+    int j;
+    gf m;
+    gf t;
+    set25519(t, n);
+    car25519(t);
+    car25519(t);
+    car25519(t);
+    for (j = 0; j < 2; j++) {
+        m[0] = t[0] - 0xffed;
+        for (i = 1; i < 15; i++) {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        int b = (int)((m[15] >> 16) & 1);
+        m[14] &= 0xffff;
+        sel25519(t, m, 1 - b);
+    }
+    for (i = 0; i < 16; i++) {
+        o[2 * i] = (uint8_t)(t[i] & 0xff);
+        o[(2 * i) + 1] = (uint8_t)((t[i] >> 8) & 0xff);
+    }
+}
+
+static int neq25519(const gf a, const gf b) {
+    uint8_t c[32];
+    uint8_t d[32];
+    uint8_t diff = 0;
+    int i;
+    pack25519(c, a);
+    pack25519(d, b);
+    for (i = 0; i < 32; i++) {
+        diff |= c[i] ^ d[i];
+    }
+    return (0 != diff) ? 1 : 0;
+}
+
+static uint8_t par25519(const gf a) {
+    uint8_t d[32];
+    pack25519(d, a);
+    return d[0] & 1;
+}
+
+static void unpack25519(gf o, const uint8_t* n) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        o[i] = (int64_t)n[2 * i] + ((int64_t)n[(2 * i) + 1] << 8);
+    }
+    o[15] &= 0x7fff;
+}
+
+static void A(gf o, const gf a, const gf b) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        o[i] = a[i] + b[i];
+    }
+}
+
+static void Z(gf o, const gf a, const gf b) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        o[i] = a[i] - b[i];
+    }
+}
+
+static void M(gf o, const gf a, const gf b) {
+    int64_t t[31];
+    int i;
+    int j;
+    for (i = 0; i < 31; i++) {
+        t[i] = 0;
+    }
+    for (i = 0; i < 16; i++) {
+        for (j = 0; j < 16; j++) {
+            t[i + j] += a[i] * b[j];
+        }
+    }
+    for (i = 0; i < 15; i++) {
+        t[i] += 38 * t[i + 16];
+    }
+    for (i = 0; i < 16; i++) {
+        o[i] = t[i];
+    }
+    car25519(o);
+    car25519(o);
+}
+
+static void S(gf o, const gf a) {
+    M(o, a, a);
+}
+
+static void inv25519(gf o, const gf i) {
+    gf c;
+    int a;
+    set25519(c, i);
+    for (a = 253; a >= 0; a--) {
+        S(c, c);
+        if ((a != 2) && (a != 4)) {
+            M(c, c, i);
+        }
+    }
+    set25519(o, c);
+}
+
+static void pow2523(gf o, const gf i) {
+    gf c;
+    int a;
+    set25519(c, i);
+    for (a = 250; a >= 0; a--) {
+        S(c, c);
+        if (a != 1) {
+            M(c, c, i);
+        }
+    }
+    set25519(o, c);
+}
+
+/* p = p + q, extended coordinates */
+static void add(gf p[4], gf q[4]) {
+    gf a;
+    gf b;
+    gf c;
+    gf d;
+    gf t;
+    gf e;
+    gf f;
+    gf g;
+    gf h;
+
+    Z(a, p[1], p[0]);
+    Z(t, q[1], q[0]);
+    M(a, a, t);
+    A(b, p[0], p[1]);
+    A(t, q[0], q[1]);
+    M(b, b, t);
+    M(c, p[3], q[3]);
+    M(c, c, D2);
+    M(d, p[2], q[2]);
+    A(d, d, d);
+    Z(e, b, a);
+    Z(f, d, c);
+    A(g, d, c);
+    A(h, b, a);
+
+    M(p[0], e, f);
+    M(p[1], h, g);
+    M(p[2], g, f);
+    M(p[3], e, h);
+}
+
+static void cswap(gf p[4], gf q[4], uint8_t b) {
+    int i;
+    for (i = 0; i < 4; i++) {
+        sel25519(p[i], q[i], b);
+    }
+}
+
+static void pack(uint8_t* r, gf p[4]) {
+    gf tx;
+    gf ty;
+    gf zi;
+    inv25519(zi, p[2]);
+    M(tx, p[0], zi);
+    M(ty, p[1], zi);
+    pack25519(r, ty);
+    r[31] ^= (uint8_t)(par25519(tx) << 7);
+}
+
+/* p = s * q, q is destroyed */
+static void scalarmult(gf p[4], gf q[4], const uint8_t* s) {
+    int i;
+    set25519(p[0], gf0);
+    set25519(p[1], gf1);
+    set25519(p[2], gf1);
+    set25519(p[3], gf0);
+    for (i = 255; i >= 0; i--) {
+        uint8_t b = (s[i / 8] >> (i & 7)) & 1;
+        cswap(p, q, b);
+        add(q, p);
+        add(p, p);
+        cswap(p, q, b);
+    }
+}
+
+/* p = s * B, q is used as working memory */
+static void scalarbase(gf p[4], gf q[4], const uint8_t* s) {
+    set25519(q[0], X);
+    set25519(q[1], Y);
+    set25519(q[2], gf1);
+    M(q[3], X, Y);
+    scalarmult(p, q, s);
+}
+
+/* r = x mod L, x is destroyed */
+static void modL(uint8_t* r, int64_t x[64]) {
+    int64_t carry;
+    int i;
+    int j;
+    for (i = 63; i >= 32; i--) {
+        carry = 0;
+        for (j = i - 32; j < (i - 12); j++) {
+            x[j] += carry - (16 * x[i] * L[j - (i - 32)]);
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+    carry = 0;
+    for (j = 0; j < 32; j++) {
+        x[j] += carry - ((x[31] >> 4) * L[j]);
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (j = 0; j < 32; j++) {
+        x[j] -= carry * L[j];
+    }
+    for (i = 0; i < 32; i++) {
+        x[i + 1] += x[i] >> 8;
+        r[i] = (uint8_t)(x[i] & 255);
+    }
+}
+
+/* r = r mod L, r is 64 bytes long */
+static void reduce(uint8_t* r, int64_t x[64]) {
+    int i;
+    for (i = 0; i < 64; i++) {
+        x[i] = (int64_t)r[i];
+    }
+    for (i = 0; i < 64; i++) {
+        r[i] = 0;
+    }
+    modL(r, x);
+}
+
+/* Decodes the point p and negates it, returns 0 on success */
+static int unpackneg(gf r[4], const uint8_t* p) {
+    gf t;
+    gf chk;
+    gf num;
+    gf den;
+    gf den2;
+    gf den4;
+    gf den6;
+
+    set25519(r[2], gf1);
+    unpack25519(r[1], p);
+    S(num, r[1]);
+    M(den, num, D);
+    Z(num, num, r[2]);
+    A(den, r[2], den);
+
+    S(den2, den);
+    S(den4, den2);
+    M(den6, den4, den2);
+    M(t, den6, num);
+    M(t, t, den);
+
+    pow2523(t, t);
+    M(t, t, num);
+    M(t, t, den);
+    M(t, t, den);
+    M(r[0], t, den);
+
+    S(chk, r[0]);
+    M(chk, chk, den);
+    if (0 != neq25519(chk, num)) {
+        M(r[0], r[0], I);
+    }
+
+    S(chk, r[0]);
+    M(chk, chk, den);
+    if (0 != neq25519(chk, num)) {
+        return LLSEC_ED25519_ERROR;
+    }
+
+    if (par25519(r[0]) == (p[31] >> 7)) {
+        Z(r[0], gf0, r[0]);
+    }
+
+    M(r[3], r[0], r[1]);
+    return 0;
+}
+
+/* Checks that the 32-byte little-endian scalar s is lower than L */
+static int is_canonical_scalar(const uint8_t* s) {
+    int i;
+    int result = 0;
+    for (i = 31; i >= 0; i--) {
+        if ((int64_t)s[i] != L[i]) {
+            result = ((int64_t)s[i] < L[i]) ? 1 : 0;
+            break;
+        }
+    }
+    return result;
+}
+
+/* out = SHA-512([dom2] || a || b || c) */
+static int hash(llsec_ed25519_work* work, uint8_t* out, uint8_t prehashed,
+                const uint8_t* a, size_t a_length, const uint8_t* b, size_t b_length, const uint8_t* c, size_t c_length) {
+    int rc = llsec_ed25519_sha512_starts(&work->sha);
+    if ((0 == rc) && ((uint8_t)0 != prehashed)) {
+        rc = llsec_ed25519_sha512_update(&work->sha, dom2_ph, sizeof(dom2_ph));
+    }
+    if ((0 == rc) && (0 != a_length)) {
+        rc = llsec_ed25519_sha512_update(&work->sha, a, a_length);
+    }
+    if ((0 == rc) && (0 != b_length)) {
+        rc = llsec_ed25519_sha512_update(&work->sha, b, b_length);
+    }
+    if ((0 == rc) && (0 != c_length)) {
+        rc = llsec_ed25519_sha512_update(&work->sha, c, c_length);
+    }
+    if (0 == rc) {
+        rc = llsec_ed25519_sha512_finish(&work->sha, out);
+    }
+    return rc;
+}
+
+static llsec_ed25519_work* work_allocate(void) {
+    llsec_ed25519_work* work = (llsec_ed25519_work*)mbedtls_calloc(1, sizeof(llsec_ed25519_work));
+    if (NULL != work) {
+        mbedtls_sha512_init(&work->sha);
+    }
+    return work;
+}
+
+static void work_free(llsec_ed25519_work* work) {
+    mbedtls_sha512_free(&work->sha);
+    /* The work memory holds the secret scalar and nonce */
+    mbedtls_platform_zeroize(work, sizeof(llsec_ed25519_work));
+    mbedtls_free(work);
+}
+
+/* work->d = expanded private key: clamped secret scalar followed by the nonce prefix */
+static int expand_private_key(llsec_ed25519_work* work, const uint8_t* private_key) {
+    int rc = hash(work, work->d, 0, private_key, LLSEC_ED25519_KEY_SIZE, NULL, 0, NULL, 0);
+    work->d[0] &= 248;
+    work->d[31] &= 127;
+    work->d[31] |= 64;
+    return rc;
+}
+
+int llsec_ed25519_public_key(uint8_t* public_key, const uint8_t* private_key) {
+    int rc = LLSEC_ED25519_ERROR;
+    llsec_ed25519_work* work = work_allocate();
+    if (NULL != work) {
+        rc = expand_private_key(work, private_key);
+        if (0 == rc) {
+            scalarbase(work->p, work->q, work->d);
+            pack(public_key, work->p);
+        }
+        work_free(work);
+    }
+    return rc;
+}
+
+void llsec_ed25519_key_free(LLSEC_ed25519_key* key) {
+    if (NULL != key) {
+        mbedtls_platform_zeroize(key, sizeof(LLSEC_ed25519_key));
+        mbedtls_free(key);
+    }
+}
+
+int llsec_ed25519_sign(uint8_t* signature, const uint8_t* message, size_t message_length,
+                       const LLSEC_ed25519_key* key, uint8_t prehashed) {
+    int rc = LLSEC_ED25519_ERROR;
+    int i;
+    int j;
+    llsec_ed25519_work* work = work_allocate();
+
+    if ((NULL != work) && ((uint8_t)0 != key->has_private_key)) {
+        rc = expand_private_key(work, key->private_key);
+
+        /* r = SHA-512(dom2 || prefix || M) mod L, R = r * B */
+        if (0 == rc) {
+            rc = hash(work, work->r, prehashed, &work->d[32], 32, message, message_length, NULL, 0);
+        }
+        if (0 == rc) {
+            reduce(work->r, work->x);
+            scalarbase(work->p, work->q, work->r);
+            pack(signature, work->p);
+
+            /* h = SHA-512(dom2 || R || A || M) mod L */
+            rc = hash(work, work->h, prehashed, signature, 32, key->public_key, LLSEC_ED25519_KEY_SIZE, message, message_length);
+        }
+        if (0 == rc) {
+            reduce(work->h, work->x);
+
+            /* S = (r + h * s) mod L */
+            for (i = 0; i < 64; i++) {
+                work->x[i] = 0;
+            }
+            for (i = 0; i < 32; i++) {
+                work->x[i] = (int64_t)work->r[i];
+            }
+            for (i = 0; i < 32; i++) {
+                for (j = 0; j < 32; j++) {
+                    work->x[i + j] += (int64_t)work->h[i] * (int64_t)work->d[j];
+                }
+            }
+            modL(&signature[32], work->x);
+        }
+    }
+
+    if (NULL != work) {
+        work_free(work);
+    }
+    return rc;
+}
+
+int llsec_ed25519_verify(const uint8_t* signature, const uint8_t* message, size_t message_length,
+                         const uint8_t* public_key, uint8_t prehashed) {
+    int rc = LLSEC_ED25519_ERROR;
+    llsec_ed25519_work* work = work_allocate();
+
+    if ((NULL != work) && (0 != is_canonical_scalar(&signature[32])) && (0 == unpackneg(work->q, public_key))) {
+        /* Check that S * B - h * A == R */
+        rc = hash(work, work->h, prehashed, signature, 32, public_key, LLSEC_ED25519_KEY_SIZE, message, message_length);
+        if (0 == rc) {
+            reduce(work->h, work->x);
+            scalarmult(work->p, work->q, work->h);
+            scalarbase(work->s, work->q, &signature[32]);
+            add(work->p, work->s);
+            pack(work->t, work->p);
+
+            uint8_t diff = 0;
+            int i;
+            for (i = 0; i < 32; i++) {
+                diff |= work->t[i] ^ signature[i];
+            }
+            rc = (0 == diff) ? 0 : LLSEC_ED25519_ERROR;
+        }
+    }
+
+    if (NULL != work) {
+        work_free(work);
+    }
+    return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/**
+ * @file
+ * @brief Security worker: runs the long cryptographic operations out of the VM task.
+ * @author MicroEJ Developer Team
+ * @version 1.5.0
+ * @date 19 February 2024
+ */
+
+#include <LLSEC_configuration.h>
+#include <LLSEC_worker.h>
+
+MICROEJ_ASYNC_WORKER_worker_declare(llsec_worker, LLSEC_WORKER_JOB_COUNT, LLSEC_worker_param_t, LLSEC_WORKER_WAITING_LIST_SIZE);
+OSAL_task_stack_declare(llsec_worker_stack, LLSEC_WORKER_STACK_SIZE);
+
+int32_t llsec_worker_start(void) {
+    static int32_t worker_status = LLSEC_ERROR;
+    static int32_t worker_started = 0;
+
+    if (0 == worker_started) {
+        worker_started = 1;
+        // cppcheck-suppress misra-c2012-11.8 // String casts conform to MICROEJ_ASYNC_WORKER_initialize function definitions.
+        MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_initialize(&llsec_worker, (uint8_t*)"MicroEJ SEC", llsec_worker_stack, LLSEC_WORKER_PRIORITY);
+        if (MICROEJ_ASYNC_WORKER_OK == status) {
+            worker_status = LLSEC_SUCCESS;
+        }
+    }
+    return worker_status;
+}
@@ -8,8 +8,20 @@
 #ifndef MICROEJ_ALLOCATOR_H
 #define MICROEJ_ALLOCATOR_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include "microej_allocator_configuration.h"
+#include "microej_pool.h"
+
+/** @brief Number of size classes of the slab allocator: 16, 32, 64, 128 and 256 bytes. */
+#define MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT (5)
+
+/** @brief Statistics of a size class, see microej_allocator_get_slab_statistics(). */
+typedef struct {
+	size_t size;                          /**< size of the blocks of the class */
+	POOL_statistics_t pool;               /**< usage of the slab */
+	unsigned int heap_allocation_count;   /**< number of blocks of this class allocated from the heap because the slab was full */
+} microej_allocator_slab_statistics_t;
 
 /**
  * @brief Allocate a memory area and return the pointer to the allocated memory.
@@ -32,4 +44,12 @@ void* microej_calloc(size_t n, size_t size);
 */
 void microej_free(void *ptr);
 
+/**
+ * @brief Gets the statistics of a size class of the slab allocator.
+ * @param[in] class_index Index of the class, from 0 to MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT - 1.
+ * @param[out] statistics Statistics of the class.
+ * @return true on success, false if the index is not valid or the slabs are disabled.
+ */
+bool microej_allocator_get_slab_statistics(int class_index, microej_allocator_slab_statistics_t* statistics);
+
 #endif // MICROEJ_ALLOCATOR_H
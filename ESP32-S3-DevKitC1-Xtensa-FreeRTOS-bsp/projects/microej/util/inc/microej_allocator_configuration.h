@@ -11,4 +11,18 @@
 // uncomment this define if the MicroEJ allocator has to allocate in Espressif SPI RAM first
 #define CONFIG_MICROEJ_ALLOCATION_FROM_SPIRAM_FIRST
 
+// comment this define to allocate the small blocks from the heap instead of the size class slabs.
+// Blocks of up to 256 bytes (mbedTLS MPIs, X.509 nodes, ...) are allocated from fixed size slabs in internal RAM:
+// no multi_heap lock and no PSRAM fragmentation. A block is allocated from the heap when its slab is full.
+// Trade-off: every mbedTLS allocation of up to 256 bytes moves from SPIRAM to internal RAM. With the counts below, the
+// slabs reserve about 9.2 KB of static internal RAM plus about 0.7 KB for their status arrays, even when TLS is not used.
+#define MICROEJ_ALLOCATOR_SLABS
+
+// number of blocks of each size class slab, must be greater than 0. Slabs are static arrays in internal RAM.
+#define MICROEJ_ALLOCATOR_SLAB_16_COUNT (64)
+#define MICROEJ_ALLOCATOR_SLAB_32_COUNT (64)
+#define MICROEJ_ALLOCATOR_SLAB_64_COUNT (32)
+#define MICROEJ_ALLOCATOR_SLAB_128_COUNT (16)
+#define MICROEJ_ALLOCATOR_SLAB_256_COUNT (8)
+
 #endif // MICROEJ_ALLOCATOR_CONFIGURATION_H
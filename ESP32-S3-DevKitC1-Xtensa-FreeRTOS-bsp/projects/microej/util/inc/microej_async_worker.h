@@ -20,6 +20,25 @@
  * 		the <code>MICROEJ_ASYNC_WORKER_initialize()</code> function.
  * 		Jobs are allocated using <code>MICROEJ_ASYNC_WORKER_allocate_job()</code> and scheduled with <code>MICROEJ_ASYNC_WORKER_async_exec()</code>.
  * 		<p>
+ * 		A worker may be executed by several tasks, optionally pinned to a core, using <code>MICROEJ_ASYNC_WORKER_initialize_tasks()</code>.
+ * 		In this case, jobs are executed in parallel and may complete in a different order than they have been scheduled.
+ * 		Jobs are scheduled in the <code>MICROEJ_ASYNC_WORKER_LANE_NORMAL</code> lane by default. Short jobs can be moved to the
+ * 		<code>MICROEJ_ASYNC_WORKER_LANE_HIGH</code> lane with <code>MICROEJ_ASYNC_WORKER_set_job_lane()</code> so they are executed
+ * 		before the jobs already waiting in the normal lane.
+ * 		<p>
+ * 		Several jobs can be submitted as a batch with <code>MICROEJ_ASYNC_WORKER_async_exec_batch()</code>: they are queued once,
+ * 		executed one after the other by the same worker task and the Java thread is resumed once, when the last one is done.
+ * 		<p>
+ * 		A job can be given a timeout with <code>MICROEJ_ASYNC_WORKER_set_job_timeout()</code> and can be cancelled with
+ * 		<code>MICROEJ_ASYNC_WORKER_cancel_job()</code>, or from Java with <code>NativeAsyncWorker.nativeCancel()</code>. In both
+ * 		cases, the waiting Java thread resumes with an exception while the worker task may still be running the action: the
+ * 		job is released by the worker when the action ends and its result is discarded. Every <code>on_done_callback</code>
+ * 		must check the job returned by <code>MICROEJ_ASYNC_WORKER_get_job_done()</code> against <code>NULL</code>.
+ * 		<p>
+ * 		Each worker measures the time its jobs wait in the queues and the time their actions run. These statistics are read
+ * 		in C with <code>MICROEJ_ASYNC_WORKER_get_statistics()</code> and <code>MICROEJ_ASYNC_WORKER_get_action_statistics()</code>,
+ * 		and in Java with the <code>com.microej.support.util.NativeAsyncWorker</code> natives.
+ * 		<p>
  * 		Typical usage consists in declaring:
  * 		- for each SNI function, a structure that contains the parameters of the function,
  * 		- an union of all the previously declared structures,
@@ -110,10 +129,11 @@
  *
  *
  * @author MicroEJ Developer Team
- * @version 0.4.0
+ * @version 0.9.0
  * @date 17 June 2022
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "sni.h"
 #include "osal.h"
@@ -130,9 +150,104 @@ typedef enum {
 } MICROEJ_ASYNC_WORKER_status_t;
 
 
+/** @brief Maximum number of tasks that can execute a worker. */
+#define MICROEJ_ASYNC_WORKER_MAX_TASK_COUNT (4)
+
+/**
+ * @brief Maximum number of workers that can be queried with the <code>NativeAsyncWorker</code> natives.
+ * Workers initialized when this number is reached work normally but cannot be queried from Java.
+ */
+#define MICROEJ_ASYNC_WORKER_MAX_WORKER_COUNT (8)
+
+/**
+ * @brief Number of buckets of the wait time and service time histograms.
+ * Bucket <code>i</code> counts the durations lower than <code>MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_LIMIT(i)</code>
+ * and greater or equal to the limit of bucket <code>i-1</code>. The last bucket counts all the longer durations.
+ */
+#define MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT (8)
+
+/** @brief Upper limit in microseconds of a histogram bucket: 64us, 256us, 1ms, 4ms, 16ms, 65ms, 262ms. */
+#define MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_LIMIT(_bucket) (64u << (2u * (uint32_t)(_bucket)))
+
+/**
+ * @brief Number of different actions timed by each worker (see <code>MICROEJ_ASYNC_WORKER_get_action_statistics()</code>).
+ * The actions executed when all the entries are used are only counted in the global statistics.
+ */
+#define MICROEJ_ASYNC_WORKER_ACTION_STATISTICS_COUNT (16)
+
+/**
+ * @brief Set this define to record an LLTRACE event each time a job is queued and around each action.
+ * Events are recorded in the <code>AsyncWorker</code> group, see <code>MICROEJ_ASYNC_WORKER_TRACE_*</code>.
+ */
+//#define MICROEJ_ASYNC_WORKER_TRACE
+
+/** @brief Trace event: a job has been queued. Values: worker id, lane. */
+#define MICROEJ_ASYNC_WORKER_TRACE_JOB_QUEUED (0)
+/** @brief Trace event: an action is executed. Values: worker id, wait time in microseconds. Ends with the service time. */
+#define MICROEJ_ASYNC_WORKER_TRACE_JOB_EXECUTE (1)
+/** @brief Trace event: a thread cannot wait for a job, the waiting list is full. Value: worker id. */
+#define MICROEJ_ASYNC_WORKER_TRACE_WAITING_LIST_OVERFLOW (2)
+/** @brief Maximum timeout of a job in milliseconds, see <code>MICROEJ_ASYNC_WORKER_set_job_timeout()</code>. */
+#define MICROEJ_ASYNC_WORKER_MAX_TIMEOUT (30*60*1000)
+
+/**
+ * @brief Time in milliseconds given to a worker task to resume a Java thread whose job completed at its deadline.
+ * The Java thread waits for this resume so it does not wake up a later suspension of the same thread.
+ */
+#define MICROEJ_ASYNC_WORKER_TIMEOUT_GRACE_TIME (10)
+
+/** @brief Number of trace events. */
+#define MICROEJ_ASYNC_WORKER_TRACE_EVENT_COUNT (3)
+
+/** @brief Indexes of the array filled by <code>MICROEJ_ASYNC_WORKER_IMPL_get_statistics()</code>. */
+#define MICROEJ_ASYNC_WORKER_STAT_WAKEUP_COUNT (0)
+#define MICROEJ_ASYNC_WORKER_STAT_EXECUTED_JOB_COUNT (1)
+#define MICROEJ_ASYNC_WORKER_STAT_BATCH_COUNT (2)
+#define MICROEJ_ASYNC_WORKER_STAT_RESUME_COUNT (3)
+#define MICROEJ_ASYNC_WORKER_STAT_QUEUE_DEPTH (4)
+#define MICROEJ_ASYNC_WORKER_STAT_MAX_QUEUE_DEPTH (5)
+#define MICROEJ_ASYNC_WORKER_STAT_WAITING_LIST_OVERFLOW_COUNT (6)
+#define MICROEJ_ASYNC_WORKER_STAT_MAX_WAIT_TIME (7)
+#define MICROEJ_ASYNC_WORKER_STAT_MAX_SERVICE_TIME (8)
+#define MICROEJ_ASYNC_WORKER_STAT_WAIT_HISTOGRAM (9)
+#define MICROEJ_ASYNC_WORKER_STAT_SERVICE_HISTOGRAM (MICROEJ_ASYNC_WORKER_STAT_WAIT_HISTOGRAM + MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT)
+#define MICROEJ_ASYNC_WORKER_STAT_TIMEOUT_COUNT (MICROEJ_ASYNC_WORKER_STAT_SERVICE_HISTOGRAM + MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT)
+#define MICROEJ_ASYNC_WORKER_STAT_CANCEL_COUNT (MICROEJ_ASYNC_WORKER_STAT_TIMEOUT_COUNT + 1)
+#define MICROEJ_ASYNC_WORKER_STAT_COUNT (MICROEJ_ASYNC_WORKER_STAT_CANCEL_COUNT + 1)
+
+/** @brief Indexes of the array filled by <code>MICROEJ_ASYNC_WORKER_IMPL_get_action_statistics()</code>. */
+#define MICROEJ_ASYNC_WORKER_ACTION_STAT_ADDRESS (0)
+#define MICROEJ_ASYNC_WORKER_ACTION_STAT_COUNT (1)
+#define MICROEJ_ASYNC_WORKER_ACTION_STAT_TOTAL_TIME (2)
+#define MICROEJ_ASYNC_WORKER_ACTION_STAT_MAX_TIME (3)
+#define MICROEJ_ASYNC_WORKER_ACTION_STAT_SIZE (4)
+
+/** @brief Java natives to query the workers. */
+#define MICROEJ_ASYNC_WORKER_IMPL_get_worker_count          Java_com_microej_support_util_NativeAsyncWorker_nativeGetWorkerCount
+#define MICROEJ_ASYNC_WORKER_IMPL_get_name                  Java_com_microej_support_util_NativeAsyncWorker_nativeGetName
+#define MICROEJ_ASYNC_WORKER_IMPL_get_statistics            Java_com_microej_support_util_NativeAsyncWorker_nativeGetStatistics
+#define MICROEJ_ASYNC_WORKER_IMPL_get_action_statistics     Java_com_microej_support_util_NativeAsyncWorker_nativeGetActionStatistics
+#define MICROEJ_ASYNC_WORKER_IMPL_get_current_thread_id     Java_com_microej_support_util_NativeAsyncWorker_nativeGetCurrentThreadId
+#define MICROEJ_ASYNC_WORKER_IMPL_cancel                    Java_com_microej_support_util_NativeAsyncWorker_nativeCancel
+
+/**
+ * @brief Scheduling lanes of a worker.
+ *
+ * When a worker task is available, it executes the oldest job of the highest priority lane that is not empty.
+ * Jobs of the same lane are started in FIFO order.
+ */
+typedef enum {
+	MICROEJ_ASYNC_WORKER_LANE_HIGH, // Short jobs that must not wait behind long ones.
+	MICROEJ_ASYNC_WORKER_LANE_NORMAL, // Default lane.
+	MICROEJ_ASYNC_WORKER_LANE_COUNT
+} MICROEJ_ASYNC_WORKER_lane_t;
+
 /** @brief See <code>struct MICROEJ_ASYNC_WORKER_job</code>. */
 typedef struct MICROEJ_ASYNC_WORKER_job MICROEJ_ASYNC_WORKER_job_t;
 
+/** @brief See <code>struct MICROEJ_ASYNC_WORKER_handle</code>. */
+typedef struct MICROEJ_ASYNC_WORKER_handle MICROEJ_ASYNC_WORKER_handle_t;
+
 /** @brief Pointer to a function to call asynchronously. */
 typedef void (*MICROEJ_ASYNC_WORKER_action_t)(MICROEJ_ASYNC_WORKER_job_t* job);
 
@@ -155,9 +270,57 @@ struct MICROEJ_ASYNC_WORKER_job{
 		MICROEJ_ASYNC_WORKER_action_t action; // Pointer to the action to execute asynchronously.
 		int32_t thread_id; // Id of the Java thread that is waiting for this job to complete ; SNI_ERROR if no thread is waiting.
 		MICROEJ_ASYNC_WORKER_job_t* next_free_job; // Next in the free jobs linked list.
+		MICROEJ_ASYNC_WORKER_lane_t lane; // Lane in which the job is scheduled.
+		MICROEJ_ASYNC_WORKER_job_t* next_batch_job; // Next job of the same batch, NULL if last or not in a batch.
+		uint32_t queue_time; // Time at which the job has been queued, in microseconds.
+		volatile uint32_t state; // Execution state and release flags, see MICROEJ_ASYNC_WORKER_JOB_STATE_* in the implementation.
+		int64_t timeout; // Timeout in milliseconds, 0 for no timeout.
+		SNI_callback on_done_callback; // Callback of the waiting Java thread.
+		MICROEJ_ASYNC_WORKER_handle_t* worker; // Worker that owns the job.
+		bool draining_resume; // true when the Java thread waits for the resume of a job that completed at its deadline.
 	} _intern;
 };
 
+/**
+ * @brief Statistics of a worker, see <code>MICROEJ_ASYNC_WORKER_get_statistics()</code>.
+ *
+ * <code>wakeup_count / executed_job_count</code> is the number of times a worker task is woken up per job and
+ * <code>resume_count / executed_job_count</code> the number of Java thread resumes per job.
+ */
+typedef struct {
+	uint32_t wakeup_count; // Number of times a worker task has blocked waiting for a job and has been woken up.
+	uint32_t executed_job_count; // Number of jobs executed.
+	uint32_t batch_count; // Number of queue entries executed: a single job or a whole batch.
+	uint32_t resume_count; // Number of Java threads resumed when their job or batch was done.
+	uint32_t queue_depth; // Number of queue entries currently queued. Not reset.
+	uint32_t max_queue_depth; // Maximum number of queue entries queued at the same time.
+	uint32_t waiting_list_overflow_count; // Number of allocations that failed because the waiting list was full.
+	uint32_t max_wait_time; // Maximum time spent by a queue entry in the queues, in microseconds.
+	uint32_t max_service_time; // Maximum execution time of an action, in microseconds.
+	uint32_t wait_histogram[MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT]; // Histogram of the time spent by the queue entries in the queues.
+	uint32_t service_histogram[MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT]; // Histogram of the execution time of the actions.
+	uint32_t timeout_count; // Number of jobs whose timeout has expired.
+	uint32_t cancel_count; // Number of jobs cancelled with MICROEJ_ASYNC_WORKER_cancel_job().
+} MICROEJ_ASYNC_WORKER_statistics_t;
+
+/**
+ * @brief Execution time statistics of an action, see <code>MICROEJ_ASYNC_WORKER_get_action_statistics()</code>.
+ */
+typedef struct {
+	MICROEJ_ASYNC_WORKER_action_t action; // The action.
+	uint32_t count; // Number of executions.
+	uint32_t total_time; // Total execution time in microseconds.
+	uint32_t max_time; // Maximum execution time in microseconds.
+} MICROEJ_ASYNC_WORKER_action_statistics_t;
+
+/** @brief Internal counters of an action, see <code>MICROEJ_ASYNC_WORKER_action_statistics_t</code>. */
+typedef struct {
+	volatile uint32_t action; // Address of the action, 0 if the entry is not used yet. Never reset.
+	volatile uint32_t count;
+	volatile uint32_t total_time;
+	volatile uint32_t max_time;
+} MICROEJ_ASYNC_WORKER_action_counters_t;
+
 /**
  * @brief An async worker.
  *
@@ -166,19 +329,37 @@ struct MICROEJ_ASYNC_WORKER_job{
  * <p>
  * All the fields of this structure are internal data and must not be modified.
  */
-typedef struct {
+struct MICROEJ_ASYNC_WORKER_handle{
 	int32_t job_count; // Maximum number of jobs.
-	MICROEJ_ASYNC_WORKER_job_t* free_jobs; // Linked list of free jobs
+	MICROEJ_ASYNC_WORKER_job_t* jobs; // Array of all the jobs. Length of this array is job_count.
+	MICROEJ_ASYNC_WORKER_job_t* volatile free_jobs; // Lock-free stack of free jobs, pushed by any task and popped by the VM task only
 	void* params; // Pointer to params array. Length of this array is job_count.
 	int32_t params_sizeof; // Size of the params union
 	int32_t waiting_threads_length; // Length of the waiting_threads array
 	int32_t* waiting_threads; // Array of waiting threads (circular list)
-	uint16_t waiting_thread_offset; // Offset of the first waiting thread. If equals to free_waiting_thread_offset: no waiting thread
-	uint16_t free_waiting_thread_offset; // Offset of the first free slot in waiting_threads array
-	OSAL_queue_handle_t jobs_queue; // Linked list of jobs
-	OSAL_task_handle_t task; // The task that executes this worker.
-	OSAL_mutex_handle_t mutex; // Mutex used for critical sections.
-} MICROEJ_ASYNC_WORKER_handle_t;
+	volatile uint32_t waiting_thread_offset; // Offset of the first waiting thread in the low 16 bits, ABA tag in the high 16 bits. If the offset equals to free_waiting_thread_offset: no waiting thread
+	volatile uint32_t free_waiting_thread_offset; // Offset of the first free slot in waiting_threads array, written by the VM task only
+	OSAL_queue_handle_t jobs_queues[MICROEJ_ASYNC_WORKER_LANE_COUNT]; // Queues of jobs, one per lane
+	OSAL_counter_semaphore_handle_t jobs_semaphore; // Number of jobs in all the queues
+	int32_t task_count; // Number of tasks that execute this worker.
+	OSAL_task_handle_t tasks[MICROEJ_ASYNC_WORKER_MAX_TASK_COUNT]; // The tasks that execute this worker.
+	volatile uint32_t wakeup_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t executed_job_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t batch_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t resume_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t queue_depth; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t max_queue_depth; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t waiting_list_overflow_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t max_wait_time; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t max_service_time; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t wait_histogram[MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT]; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t service_histogram[MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT]; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t timeout_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	volatile uint32_t cancel_count; // See MICROEJ_ASYNC_WORKER_statistics_t
+	MICROEJ_ASYNC_WORKER_action_counters_t action_counters[MICROEJ_ASYNC_WORKER_ACTION_STATISTICS_COUNT]; // Execution time of each action.
+	const uint8_t* name; // Name given to MICROEJ_ASYNC_WORKER_initialize_tasks().
+	int32_t id; // Index of the worker in the list of the queryable workers, -1 if it cannot be queried.
+};
 
 /**
  * @brief Declares a worker named <code>_name</code>.
@@ -188,7 +369,7 @@ typedef struct {
  * @param _name name of the worker variable.
  * @param _job_count maximum number of jobs that can be allocated for this worker. Must be greater than 0.
  * @param _param_type type of the union of all the parameters structures
- * @param  _waiting_list_size Maximum Java thread that can be suspended on <code>MICROEJ_ASYNC_WORKER_allocate_job()</code> when no job is available. Must be greater than 0.
+ * @param  _waiting_list_size Maximum Java thread that can be suspended on <code>MICROEJ_ASYNC_WORKER_allocate_job()</code> when no job is available. Must be greater than 0 and lower than 65535.
  */
 #define MICROEJ_ASYNC_WORKER_worker_declare(_name, _job_count, _param_type, _waiting_list_size)\
 	_param_type _name ## _params[_job_count];\
@@ -196,13 +377,15 @@ typedef struct {
 	int32_t _name ## _waiting_threads[_waiting_list_size+1];\
 	MICROEJ_ASYNC_WORKER_handle_t _name = {\
 		.job_count = _job_count,\
+		.jobs = _name ## _jobs,\
 		.free_jobs = _name ## _jobs,\
 		.params = _name ## _params,\
 		.params_sizeof = sizeof(_param_type),\
 		.waiting_threads_length = _waiting_list_size+1,\
 		.waiting_threads = _name ## _waiting_threads,\
 		.waiting_thread_offset = 0,\
-		.free_waiting_thread_offset = 0\
+		.free_waiting_thread_offset = 0,\
+		.id = -1\
 	}
 
 
@@ -220,6 +403,25 @@ typedef struct {
  */
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_initialize(MICROEJ_ASYNC_WORKER_handle_t* async_worker, uint8_t* name, OSAL_task_stack_t stack, int32_t priority);
 
+/**
+ * @brief Initializes and starts a worker executed by several tasks.
+ *
+ * Jobs of the worker are executed in parallel by the tasks, so the actions of the worker must be reentrant.
+ * A Java thread waiting for a job is still resumed only when its job is done.
+ *
+ * @param[in] async_worker the worker to initialize. Declared with <code>MICROEJ_ASYNC_WORKER_worker_declare()</code> macro.
+ * @param[in] name worker name, shared by all its tasks.
+ * @param[in] stacks worker task stacks declared using <code>OSAL_task_stack_declare()</code> macro, one per task.
+ * @param[in] task_count number of tasks, from 1 to <code>MICROEJ_ASYNC_WORKER_MAX_TASK_COUNT</code>.
+ * @param[in] priority worker tasks priority.
+ * @param[in] core index of the core that runs the worker tasks, <code>OSAL_NO_AFFINITY</code> to run them on any core.
+ *
+ * @return MICROEJ_ASYNC_WORKER_INVALID_ARGS if given worker has not been correctly declared or if task_count is not valid.
+ * Returns MICROEJ_ASYNC_WORKER_ERROR if worker task or queue creation fails.
+ * Returns MICROEJ_ASYNC_WORKER_OK on success.
+ */
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_initialize_tasks(MICROEJ_ASYNC_WORKER_handle_t* async_worker, uint8_t* name, OSAL_task_stack_t* stacks, int32_t task_count, int32_t priority, int32_t core);
+
 /**
  * @brief Allocates a new job for the given worker.
  *
@@ -265,6 +467,53 @@ MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_allocate_job(MICROEJ_ASYNC_WORK
  */
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_free_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job);
 
+/**
+ * @brief Sets the lane in which the given job will be scheduled.
+ *
+ * Jobs are scheduled in the <code>MICROEJ_ASYNC_WORKER_LANE_NORMAL</code> lane unless this function is called between
+ * <code>MICROEJ_ASYNC_WORKER_allocate_job()</code> and <code>MICROEJ_ASYNC_WORKER_async_exec()</code>.
+ *
+ * @param[in] job the job. Must have been allocated with <code>MICROEJ_ASYNC_WORKER_allocate_job()</code>.
+ * @param[in] lane the lane of the job.
+ */
+void MICROEJ_ASYNC_WORKER_set_job_lane(MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_lane_t lane);
+
+/**
+ * @brief Sets the maximum time the Java thread waits for the given job.
+ *
+ * Jobs have no timeout unless this function is called between <code>MICROEJ_ASYNC_WORKER_allocate_job()</code> and
+ * <code>MICROEJ_ASYNC_WORKER_async_exec()</code>. When the timeout expires before the end of the job, the Java thread
+ * resumes, <code>MICROEJ_ASYNC_WORKER_get_job_done()</code> throws an SNI exception and returns <code>NULL</code>,
+ * and the job is released by the worker when its action ends. The action must not access Java objects.
+ *
+ * @param[in] job the job. Must have been allocated with <code>MICROEJ_ASYNC_WORKER_allocate_job()</code>.
+ * @param[in] timeout timeout in milliseconds, 0 for no timeout.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_OK</code> on success, <code>MICROEJ_ASYNC_WORKER_INVALID_ARGS</code> if the
+ * timeout is negative or greater than <code>MICROEJ_ASYNC_WORKER_MAX_TIMEOUT</code>.
+ */
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_set_job_timeout(MICROEJ_ASYNC_WORKER_job_t* job, int64_t timeout);
+
+/**
+ * @brief Cancels a job that has been executed with <code>MICROEJ_ASYNC_WORKER_async_exec()</code>,
+ * <code>MICROEJ_ASYNC_WORKER_async_exec_batch()</code> or <code>MICROEJ_ASYNC_WORKER_async_exec_no_wait()</code> and
+ * that is not done yet.
+ *
+ * The action of the job is not executed if it has not started yet, otherwise its result is discarded. The Java thread
+ * waiting for the job resumes, <code>MICROEJ_ASYNC_WORKER_get_job_done()</code> throws an SNI exception and returns
+ * <code>NULL</code>. The job is released by the worker: it must not be freed by the caller. A batch is cancelled with
+ * its first job.
+ * <p>
+ * This function must be called within the virtual machine task.
+ *
+ * @param[in] async_worker the worker that executes the job.
+ * @param[in] job the job to cancel.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_OK</code> if the job has been cancelled, <code>MICROEJ_ASYNC_WORKER_ERROR</code>
+ * if it is already done, timed out or cancelled.
+ */
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_cancel_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job);
+
 /**
  * @brief Executes the given job asynchronously.
  *
@@ -292,6 +541,58 @@ MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_free_job(MICROEJ_ASYNC_WORKER
  */
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done_callback);
 
+/**
+ * @brief Executes the given jobs asynchronously as a single batch.
+ *
+ * This function does not block and returns immediately but it suspends the execution of the current Java thread
+ * until all the jobs are finished. The jobs are queued once, in the lane of the first job, and are executed in order
+ * by the same worker task.
+ * <p>
+ * When the last job is finished, the SNI callback <code>on_done_callback</code> is called once before going back to
+ * Java. In this callback, <code>MICROEJ_ASYNC_WORKER_get_job_done()</code> returns the first job of the batch and
+ * the other ones are retrieved with <code>MICROEJ_ASYNC_WORKER_get_next_batch_job()</code>. The jobs must be released
+ * with <code>MICROEJ_ASYNC_WORKER_free_batch()</code>.
+ * <p>
+ * If an error happens, an SNI exception is thrown using <code>SNI_throwNativeIOException()</code> and the error
+ * status <code>MICROEJ_ASYNC_WORKER_ERROR</code> is returned. In this case, the SNI callback
+ * <code>on_done_callback</code> is not called and the jobs must be released explicitly by calling
+ * <code>MICROEJ_ASYNC_WORKER_free_batch()</code> with the first job.
+ * <p>
+ * This function must be called within the virtual machine task.
+ *
+ * @param[in] async_worker the worker used to execute the given jobs. Must be the same than the one used to allocate the jobs.
+ * @param[in] jobs the jobs to execute, in execution order. Must have been allocated with <code>MICROEJ_ASYNC_WORKER_allocate_job()</code>.
+ * @param[in] count the number of jobs, greater than 0.
+ * @param[in] action the function to execute asynchronously for each job.
+ * @param[in] on_done_callback the <code>SNI_callback</code> called when all the jobs are done.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_OK</code> on success, otherwise returns the error status
+ * <code>MICROEJ_ASYNC_WORKER_ERROR</code> or <code>MICROEJ_ASYNC_WORKER_INVALID_ARGS</code> if count is not valid.
+ */
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_batch(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t** jobs, int32_t count, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done_callback);
+
+/**
+ * @brief Returns the job following the given one in its batch.
+ *
+ * @param[in] job a job executed with <code>MICROEJ_ASYNC_WORKER_async_exec_batch()</code>.
+ *
+ * @return the next job of the batch, <code>NULL</code> if the given job is the last one.
+ */
+MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_get_next_batch_job(MICROEJ_ASYNC_WORKER_job_t* job);
+
+/**
+ * @brief Frees all the jobs of a batch.
+ *
+ * This function must be called within the virtual machine task.
+ *
+ * @param[in] async_worker the worker used to allocate the jobs.
+ * @param[in] job the first job of the batch.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_OK</code> on success, otherwise returns the error status
+ * <code>MICROEJ_ASYNC_WORKER_ERROR</code>.
+ */
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_free_batch(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job);
+
 /**
  * @brief Executes the given job asynchronously.
  *
@@ -319,11 +620,108 @@ MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_no_wait(MICROEJ_AS
  *
  * This function must be called after the execution of a job in the function passed as <code>on_done_callback</code>
  * argument to <code>MICROEJ_ASYNC_WORKER_async_exec()</code>.
+ * <p>
+ * This function returns <code>NULL</code> when the job is not done: either it has been cancelled or its timeout has
+ * expired and an SNI exception is pending, or the Java thread has been resumed early and it has been suspended again
+ * until the end of the job. In both cases the callback must return immediately without accessing or freeing the job.
  *
- * @return the job that has been executed asynchronously or <code>NULL</code> if not called from an <code>on_done_callback</code>.
+ * @return the job that has been executed asynchronously or <code>NULL</code> if not called from an <code>on_done_callback</code>
+ * or if the job is not done.
  */
 MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_get_job_done(void);
 
+/**
+ * @brief Gets the statistics of a worker.
+ *
+ * The statistics are counted since the initialization of the worker or since the last reset.
+ *
+ * @param[in] async_worker the worker.
+ * @param[out] statistics the statistics of the worker.
+ * @param[in] reset true to reset the statistics.
+ */
+void MICROEJ_ASYNC_WORKER_get_statistics(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_statistics_t* statistics, bool reset);
+
+/**
+ * @brief Gets the execution time statistics of an action of a worker.
+ *
+ * The actions are listed in the order of their first execution.
+ *
+ * @param[in] async_worker the worker.
+ * @param[in] index index of the action, from 0 to <code>MICROEJ_ASYNC_WORKER_ACTION_STATISTICS_COUNT - 1</code>.
+ * @param[out] statistics the statistics of the action.
+ * @param[in] reset true to reset the statistics of the action.
+ *
+ * @return true on success, false if no action has this index.
+ */
+bool MICROEJ_ASYNC_WORKER_get_action_statistics(MICROEJ_ASYNC_WORKER_handle_t* async_worker, int32_t index, MICROEJ_ASYNC_WORKER_action_statistics_t* statistics, bool reset);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeGetWorkerCount()</code>.
+ *
+ * @return the number of workers that can be queried.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_worker_count(void);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeGetName(int workerId, byte[] name)</code>.
+ * Copies the name of a worker in a null-terminated string, truncated to the length of the array.
+ *
+ * @param[in] worker_id the worker, from 0 to <code>nativeGetWorkerCount() - 1</code>.
+ * @param[out] name the array receiving the name.
+ *
+ * @return the length of the copied name, without the null byte, or -1 if the worker id is not valid.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_name(int32_t worker_id, uint8_t* name);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeGetStatistics(int workerId, long[] statistics, boolean reset)</code>.
+ *
+ * @param[in] worker_id the worker, from 0 to <code>nativeGetWorkerCount() - 1</code>.
+ * @param[out] statistics array of at least <code>MICROEJ_ASYNC_WORKER_STAT_COUNT</code> elements receiving the
+ * statistics, indexed by <code>MICROEJ_ASYNC_WORKER_STAT_*</code>.
+ * @param[in] reset true to reset the statistics.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_STAT_COUNT</code>, or -1 if the worker id or the array is not valid.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_statistics(int32_t worker_id, int64_t* statistics, jboolean reset);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeGetActionStatistics(int workerId, int index, long[] statistics, boolean reset)</code>.
+ * The address of the action can be resolved to a function name with the map file of the firmware.
+ *
+ * @param[in] worker_id the worker, from 0 to <code>nativeGetWorkerCount() - 1</code>.
+ * @param[in] index index of the action.
+ * @param[out] statistics array of at least <code>MICROEJ_ASYNC_WORKER_ACTION_STAT_SIZE</code> elements receiving the
+ * statistics, indexed by <code>MICROEJ_ASYNC_WORKER_ACTION_STAT_*</code>.
+ * @param[in] reset true to reset the statistics of the action.
+ *
+ * @return <code>MICROEJ_ASYNC_WORKER_ACTION_STAT_SIZE</code>, 0 if no action has this index, or -1 if the worker id
+ * or the array is not valid.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_action_statistics(int32_t worker_id, int32_t index, int64_t* statistics, jboolean reset);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeGetCurrentThreadId()</code>.
+ * A thread gets its id before starting a blocking operation so another thread can cancel it with
+ * <code>nativeCancel()</code>.
+ *
+ * @return the id of the current Java thread.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_current_thread_id(void);
+
+/**
+ * @brief Java native <code>int NativeAsyncWorker.nativeCancel(int workerId, int threadId)</code>.
+ * Cancels the job of a worker that a Java thread is waiting for, see <code>MICROEJ_ASYNC_WORKER_cancel_job()</code>.
+ * The blocking native of the thread throws an exception.
+ *
+ * @param[in] worker_id the worker, from 0 to <code>nativeGetWorkerCount() - 1</code>.
+ * @param[in] thread_id the id of the thread returned by <code>nativeGetCurrentThreadId()</code>.
+ *
+ * @return the number of cancelled jobs, 0 if the thread is not waiting for a job of the worker, or -1 if the worker id
+ * is not valid.
+ */
+int32_t MICROEJ_ASYNC_WORKER_IMPL_cancel(int32_t worker_id, int32_t thread_id);
+
 #ifdef __cplusplus
 	}
 #endif
@@ -9,12 +9,20 @@
  * @file
  * @brief MicroEJ memory pool implementation
  * @author MicroEJ Developer Team
- * @version 0.1.0
+ * @version 0.2.0
  */
 
 /*
  * The module provide function to simply manage a
  * Fixed memory pool size.
+ *
+ * Free items are chained in a free list stored in the items themselves, so
+ * reserving and freeing an item do not scan the pool. The free list is built
+ * on the first reservation. Items smaller than a pointer can not be chained:
+ * such pools are scanned as before.
+ *
+ * The module is not thread safe: pools shared by several tasks must be
+ * protected by the caller.
  */
 
 #ifndef MICROEJ_POOL_H
@@ -34,14 +42,32 @@ typedef enum
 	POOL_USED
 }POOL_item_status_t;
 
+/** @brief pool state managed by the module, must be zero initialized */
+typedef struct {
+	void * pv_free_list;                  /**< first free element, linked through the free elements */
+	bool b_free_list_built;               /**< true once the free list has been built */
+	unsigned int ui_num_item_used;        /**< number of reserved elements */
+	unsigned int ui_high_water_mark;      /**< maximum number of reserved elements */
+	unsigned int ui_num_reserve_failed;   /**< number of reservations failed because the pool was full */
+}POOL_internal_t;
+
 /** @brief define pool type */
 typedef struct {
 	void * pv_first_item;                 /**< pointer on first element in pool */
 	POOL_item_status_t * puc_item_status; /**< pointer on array status item */
 	unsigned int ui_size_of_item;         /**< size of one element */
 	unsigned int uc_num_item_in_pool;    /**< number of element in pool */
+	POOL_internal_t st_internal;          /**< state managed by the module, initialized with {0} */
 }POOL_ctx_t;
 
+/** @brief pool usage statistics */
+typedef struct {
+	unsigned int ui_num_item_in_pool;     /**< number of element in pool */
+	unsigned int ui_num_item_used;        /**< number of reserved elements */
+	unsigned int ui_high_water_mark;      /**< maximum number of reserved elements since the creation of the pool */
+	unsigned int ui_num_reserve_failed;   /**< number of reservations failed because the pool was full */
+}POOL_statistics_t;
+
 /** @brief list of module constant */
 typedef enum
 {
@@ -64,7 +90,8 @@ typedef bool (*microej_pool_compare_functor_t)(void *item, void *characteristic)
 		name ## _pool_array,	\
 		name ## _pool_item_status,	\
 		sizeof(pool_type),	\
-		sizeof(name ## _pool_array) / sizeof(pool_type)	\
+		sizeof(name ## _pool_array) / sizeof(pool_type),	\
+		{0}	\
 	}
 
 /**
@@ -80,6 +107,7 @@ POOL_status_t POOL_reserve_f(POOL_ctx_t * _st_pool_ctx,
 
 /**
  * @brief Get an item in according to a comparison function and a characteristic.
+ * Only reserved items are compared, the search stops after the last reserved item.
  *
  * @param[in] 		_st_pool_ctx        	pool context
  * @param[in,out]  	_ppv_item_retrieved  	pointer on item to be retrieved
@@ -102,6 +130,17 @@ POOL_status_t POOL_get_f(POOL_ctx_t * _st_pool_ctx, void ** _ppv_item_retrieved,
 POOL_status_t POOL_free_f(POOL_ctx_t * _st_pool_ctx,
 		                  void * const _pv_item_to_free);
 
+/**
+ * @brief function to get the usage statistics of the pool
+ *
+ * @param[in]  _st_pool_ctx      pool context
+ * @param[out] _pst_statistics   pointer on statistics to fill
+ *
+ * @return @see POOL_status_t
+ */
+POOL_status_t POOL_get_statistics_f(POOL_ctx_t * _st_pool_ctx,
+		                            POOL_statistics_t * _pst_statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,8 +32,19 @@
  *         @param[in] _name name of the variable that defines the queue.
  *         @param[in] _size number of items that can be stored in the queue. _size must be compile time constant value.
  *         OSAL_queue_declare(_name, _size);
- *
- * Both macros must be compile-time constants for static initialization.
+ * - OSAL_compare_and_set:
+ *         @brief Atomically sets a 32-bit word to a new value if it is equal to an expected value.
+ *         @param[in] _ptr pointer on the volatile uint32_t word.
+ *         @param[in] _expected expected value of the word.
+ *         @param[in] _value new value of the word.
+ *         @return true if the word has been set, false if it was not equal to _expected.
+ *         OSAL_compare_and_set(_ptr, _expected, _value);
+ * - OSAL_get_time_us:
+ *         @brief Gets a monotonic time in microseconds, used to measure durations. The value may wrap.
+ *         @return the current time in microseconds, as an uint32_t.
+ *         OSAL_get_time_us();
+ *
+ * The stack and queue declaration macros must be compile-time constants for static initialization.
  *
  * This file must declare the following type:
  * - OSAL_task_stack_t: OS task stack
@@ -41,7 +52,7 @@
  */
 #include "osal_portmacro.h"
 
-#if !defined(OSAL_task_stack_declare) || !defined(OSAL_queue_declare)
+#if !defined(OSAL_task_stack_declare) || !defined(OSAL_queue_declare) || !defined(OSAL_compare_and_set) || !defined(OSAL_get_time_us)
 	#error "osal_portmacro.h doesn't comply with specification."
 #endif
 
@@ -52,6 +63,9 @@
 /** @brief define an infinite time */
 #define OSAL_INFINITE_TIME    0xFFFFFFFF
 
+/** @brief core value given to OSAL_task_create_on_core() to let the OS run the task on any core */
+#define OSAL_NO_AFFINITY    (-1)
+
 /** @brief return code list */
 typedef enum {
 	OSAL_OK,
@@ -99,6 +113,25 @@ typedef void* OSAL_mutex_handle_t;
 OSAL_status_t OSAL_task_create(OSAL_task_entry_point_t entry_point, uint8_t* name, OSAL_task_stack_t stack, int32_t priority,
 		void* parameters, OSAL_task_handle_t* handle);
 
+/**
+ * @brief Create an OS task pinned to a core and start it.
+ *
+ * On single core targets, or if the OS does not support task affinity, the core is ignored and the task is
+ * created as with OSAL_task_create().
+ *
+ * @param[in] entry_point function called at task startup
+ * @param[in] name the task name
+ * @param[in] stack task stack declared using OSAL_task_stack_declare() macro
+ * @param[in] priority task priority
+ * @param[in] core index of the core that runs the task, OSAL_NO_AFFINITY to run it on any core
+ * @param[in] parameters task entry parameters. NULL if no entry parameters
+ * @param[in,out] handle pointer on a task handle
+ *
+ * @return operation status (@see OSAL_status_t)
+ */
+OSAL_status_t OSAL_task_create_on_core(OSAL_task_entry_point_t entry_point, uint8_t* name, OSAL_task_stack_t stack, int32_t priority,
+		int32_t core, void* parameters, OSAL_task_handle_t* handle);
+
 /**
  * @brief Delete an OS task and start it.
  *
@@ -21,6 +21,8 @@
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
 
 /** @brief Custom OS type definitions */
 #define OSAL_CUSTOM_TYPEDEF
@@ -65,4 +67,24 @@ typedef int32_t OSAL_queue_t;
  */
 #define OSAL_queue_declare(_name, _size) OSAL_queue_t _name = _size
 
+/*
+ * @brief Atomically sets a 32-bit word to a new value if it is equal to an expected value.
+ * Uses the S32C1I compare and set instruction, safe between cores.
+ *
+ * @param[in] _ptr pointer on the volatile uint32_t word.
+ * @param[in] _expected expected value of the word.
+ * @param[in] _value new value of the word.
+ *
+ * @return true if the word has been set, false if it was not equal to _expected.
+ */
+#define OSAL_compare_and_set(_ptr, _expected, _value) esp_cpu_compare_and_set((_ptr), (_expected), (_value))
+
+/*
+ * @brief Gets a monotonic time in microseconds, used to measure durations.
+ * The 64-bit ESP timer is truncated: the value wraps every 71 minutes.
+ *
+ * @return the current time in microseconds.
+ */
+#define OSAL_get_time_us() ((uint32_t)esp_timer_get_time())
+
 #endif // OSAL_PORTMACRO_H
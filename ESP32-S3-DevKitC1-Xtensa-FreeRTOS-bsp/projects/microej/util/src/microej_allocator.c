@@ -6,13 +6,107 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
+#include "freertos/FreeRTOS.h"
 #include "esp_heap_caps.h"
 
 #include "microej_allocator_configuration.h"
 #include "microej_allocator.h"
 
 #include "esp_log.h"
+
+#ifdef MICROEJ_ALLOCATOR_SLABS
+/*
+ * Size class slabs. Each class is a microej_pool of blocks aligned on 8 bytes. The pools are static arrays so they are
+ * placed in internal RAM. A pointer is freed in a slab when its address is in the slab array.
+ */
+#define MICROEJ_ALLOCATOR_SLAB_declare(_size, _count) \
+	typedef struct { uint64_t data[(_size) / sizeof(uint64_t)]; } microej_allocator_block_ ## _size ## _t; \
+	POOL_declare(microej_allocator_slab_ ## _size, microej_allocator_block_ ## _size ## _t, _count)
+
+MICROEJ_ALLOCATOR_SLAB_declare(16, MICROEJ_ALLOCATOR_SLAB_16_COUNT);
+MICROEJ_ALLOCATOR_SLAB_declare(32, MICROEJ_ALLOCATOR_SLAB_32_COUNT);
+MICROEJ_ALLOCATOR_SLAB_declare(64, MICROEJ_ALLOCATOR_SLAB_64_COUNT);
+MICROEJ_ALLOCATOR_SLAB_declare(128, MICROEJ_ALLOCATOR_SLAB_128_COUNT);
+MICROEJ_ALLOCATOR_SLAB_declare(256, MICROEJ_ALLOCATOR_SLAB_256_COUNT);
+
+// Slabs by increasing block size.
+static POOL_ctx_t* const microej_allocator_slabs[MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT] = {
+	&microej_allocator_slab_16,
+	&microej_allocator_slab_32,
+	&microej_allocator_slab_64,
+	&microej_allocator_slab_128,
+	&microej_allocator_slab_256,
+};
+
+// Number of blocks of each class allocated from the heap because the slab was full.
+static unsigned int microej_allocator_heap_allocation_count[MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT];
+
+// Protects the slabs, used by all the tasks. Critical sections only last a free list update.
+static portMUX_TYPE microej_allocator_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+ * Returns the index of the smallest class that fits the given size, MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT if none.
+ */
+static int microej_allocator_slab_class(size_t size) {
+	int class_index = 0;
+	while ((class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT) && (size > microej_allocator_slabs[class_index]->ui_size_of_item)) {
+		class_index++;
+	}
+	return class_index;
+}
+
+/*
+ * Allocates a block from the slab of the given size, NULL if the size is too large or the slab is full.
+ */
+static void* microej_allocator_slab_malloc(size_t size) {
+	if (size == 0) {
+		return NULL;
+	}
+	int class_index = microej_allocator_slab_class(size);
+	if (class_index == MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT) {
+		return NULL;
+	}
+
+	void* block = NULL;
+	taskENTER_CRITICAL(&microej_allocator_lock);
+	if (POOL_reserve_f(microej_allocator_slabs[class_index], &block) != POOL_NO_ERROR) {
+		block = NULL;
+		microej_allocator_heap_allocation_count[class_index]++;
+	}
+	taskEXIT_CRITICAL(&microej_allocator_lock);
+	return block;
+}
+
+/*
+ * Frees a block if it belongs to a slab.
+ * @return true if the block has been freed, false if it has not been allocated from a slab.
+ */
+static bool microej_allocator_slab_free(void* ptr) {
+	for (int class_index = 0; class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT; class_index++) {
+		POOL_ctx_t* slab = microej_allocator_slabs[class_index];
+		uint8_t* first = (uint8_t*)slab->pv_first_item;
+		if (((uint8_t*)ptr >= first) && ((uint8_t*)ptr < (first + (slab->uc_num_item_in_pool * slab->ui_size_of_item)))) {
+			taskENTER_CRITICAL(&microej_allocator_lock);
+			(void)POOL_free_f(slab, ptr);
+			taskEXIT_CRITICAL(&microej_allocator_lock);
+			return true;
+		}
+	}
+	return false;
+}
+#endif // MICROEJ_ALLOCATOR_SLABS
+
+static void* microej_heap_malloc(size_t size)
+{
+#ifdef CONFIG_MICROEJ_ALLOCATION_FROM_SPIRAM_FIRST
+    return heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL);
+#else
+    return malloc(size);
+#endif
+}
+
 void* microej_calloc4tls(size_t nmemb, size_t size) {
 	//ESP_LOGI(__func__, "allocate %d, %d\n", nmemb, size);
 	return microej_calloc(nmemb, size);
@@ -25,15 +119,26 @@ void microej_free4tls(void *ptr) {
 
 void* microej_malloc(size_t size)
 {
-#ifdef CONFIG_MICROEJ_ALLOCATION_FROM_SPIRAM_FIRST
-    return heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL);
-#else
-    return malloc(size);
+#ifdef MICROEJ_ALLOCATOR_SLABS
+	void* block = microej_allocator_slab_malloc(size);
+	if (block != NULL) {
+		return block;
+	}
 #endif
+	return microej_heap_malloc(size);
 }
 
 void* microej_calloc(size_t nmemb, size_t size)
 {
+#ifdef MICROEJ_ALLOCATOR_SLABS
+	// Small blocks only: nmemb * size cannot overflow.
+	if ((nmemb <= 256) && (size <= 256)) {
+		void* block = microej_allocator_slab_malloc(nmemb * size);
+		if (block != NULL) {
+			return memset(block, 0, nmemb * size);
+		}
+	}
+#endif
 #ifdef CONFIG_MICROEJ_ALLOCATION_FROM_SPIRAM_FIRST
     return heap_caps_calloc_prefer(nmemb, size, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL);
 #else
@@ -43,6 +148,11 @@ void* microej_calloc(size_t nmemb, size_t size)
 
 void microej_free(void *ptr)
 {
+#ifdef MICROEJ_ALLOCATOR_SLABS
+	if (microej_allocator_slab_free(ptr)) {
+		return;
+	}
+#endif
 #ifdef CONFIG_MICROEJ_ALLOCATION_FROM_SPIRAM_FIRST
 	return heap_caps_free(ptr);
 #else
@@ -50,3 +160,22 @@ void microej_free(void *ptr)
 #endif
 }
 
+bool microej_allocator_get_slab_statistics(int class_index, microej_allocator_slab_statistics_t* statistics)
+{
+#ifdef MICROEJ_ALLOCATOR_SLABS
+	if ((class_index < 0) || (class_index >= MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT)) {
+		return false;
+	}
+	POOL_ctx_t* slab = microej_allocator_slabs[class_index];
+	statistics->size = slab->ui_size_of_item;
+	taskENTER_CRITICAL(&microej_allocator_lock);
+	(void)POOL_get_statistics_f(slab, &statistics->pool);
+	statistics->heap_allocation_count = microej_allocator_heap_allocation_count[class_index];
+	taskEXIT_CRITICAL(&microej_allocator_lock);
+	return true;
+#else
+	(void)class_index;
+	(void)statistics;
+	return false;
+#endif
+}
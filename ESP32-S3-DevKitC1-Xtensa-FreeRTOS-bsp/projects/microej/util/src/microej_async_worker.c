@@ -9,7 +9,7 @@
  * @file
  * @brief Asynchronous Worker implementation
  * @author MicroEJ Developer Team
- * @version 0.4.0
+ * @version 0.9.0
  * @date 17 June 2022
  */
 
@@ -17,23 +17,88 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#ifdef MICROEJ_ASYNC_WORKER_TRACE
+#include "trace.h"
+#endif
 
 
 #ifdef __cplusplus
 	extern "C" {
 #endif
 
+#ifdef MICROEJ_ASYNC_WORKER_TRACE
+// ID of the LLTRACE group of the workers, -1 if not declared.
+static int32_t MICROEJ_ASYNC_WORKER_trace_group = -1;
+#define MICROEJ_ASYNC_WORKER_trace_u32(_event, _value) if(MICROEJ_ASYNC_WORKER_trace_group >= 0){ TRACE_record_event_u32(MICROEJ_ASYNC_WORKER_trace_group, (_event), (_value)); }
+#define MICROEJ_ASYNC_WORKER_trace_u32x2(_event, _value1, _value2) if(MICROEJ_ASYNC_WORKER_trace_group >= 0){ TRACE_record_event_u32x2(MICROEJ_ASYNC_WORKER_trace_group, (_event), (_value1), (_value2)); }
+#define MICROEJ_ASYNC_WORKER_trace_end_u32(_event, _value) if(MICROEJ_ASYNC_WORKER_trace_group >= 0){ TRACE_record_event_end_u32(MICROEJ_ASYNC_WORKER_trace_group, (_event), (_value)); }
+#else
+#define MICROEJ_ASYNC_WORKER_trace_u32(_event, _value) ((void) 0)
+#define MICROEJ_ASYNC_WORKER_trace_u32x2(_event, _value1, _value2) ((void) 0)
+#define MICROEJ_ASYNC_WORKER_trace_end_u32(_event, _value) ((void) 0)
+#endif
+
+/*
+ * Job state: the execution state in the low bits and flags. The job is shared by the Java thread that waits for it
+ * (the owner) and by the worker task. When a job is cancelled or times out, each side sets its release flag when it
+ * no longer uses the job and the side that sets the last flag frees it.
+ */
+#define MICROEJ_ASYNC_WORKER_JOB_STATE_QUEUED (0x0u)
+#define MICROEJ_ASYNC_WORKER_JOB_STATE_RUNNING (0x1u)
+#define MICROEJ_ASYNC_WORKER_JOB_STATE_DONE (0x2u)
+#define MICROEJ_ASYNC_WORKER_JOB_STATE_MASK (0x3u)
+#define MICROEJ_ASYNC_WORKER_JOB_CANCELLED (0x4u) // Cancelled or timed out, set by the VM task only.
+#define MICROEJ_ASYNC_WORKER_JOB_TIMED_OUT (0x8u) // Set with MICROEJ_ASYNC_WORKER_JOB_CANCELLED when the timeout has expired.
+#define MICROEJ_ASYNC_WORKER_JOB_OWNER_RELEASED (0x10u)
+#define MICROEJ_ASYNC_WORKER_JOB_WORKER_RELEASED (0x20u)
+#define MICROEJ_ASYNC_WORKER_JOB_RELEASED (MICROEJ_ASYNC_WORKER_JOB_OWNER_RELEASED | MICROEJ_ASYNC_WORKER_JOB_WORKER_RELEASED)
+
+// Workers that can be queried with the NativeAsyncWorker natives, in initialization order. Only accessed by the VM task.
+static MICROEJ_ASYNC_WORKER_handle_t* MICROEJ_ASYNC_WORKER_workers[MICROEJ_ASYNC_WORKER_MAX_WORKER_COUNT];
+static int32_t MICROEJ_ASYNC_WORKER_worker_count = 0;
+
 // Entry point of the async worker task.
 static void MICROEJ_ASYNC_WORKER_loop(void* args);
 
+// Resumes the first thread of the waiting list, if any. May be called by any task.
+static void MICROEJ_ASYNC_WORKER_resume_waiting_thread(MICROEJ_ASYNC_WORKER_handle_t* async_worker);
+
+// Atomically adds a value to a statistics counter and returns the new value. Counters are updated by all the worker tasks.
+static uint32_t MICROEJ_ASYNC_WORKER_add(volatile uint32_t* counter, uint32_t value);
+
+// Atomically sets a statistics counter to the given value if it is greater.
+static void MICROEJ_ASYNC_WORKER_max(volatile uint32_t* counter, uint32_t value);
+
+// Counts a duration in a histogram.
+static void MICROEJ_ASYNC_WORKER_histogram_add(volatile uint32_t* histogram, uint32_t time);
+
+// Counts the execution time of an action.
+static void MICROEJ_ASYNC_WORKER_action_add(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_action_t action, uint32_t time);
+
+// Sets a release flag of a cancelled job and frees the job if both sides have released it. May be called by any task.
+static void MICROEJ_ASYNC_WORKER_release_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, uint32_t flag);
+
+// Returns the worker with the given id, NULL if not valid.
+static MICROEJ_ASYNC_WORKER_handle_t* MICROEJ_ASYNC_WORKER_get_worker(int32_t worker_id);
+
+// Atomically reads and resets a statistics counter.
+static uint32_t MICROEJ_ASYNC_WORKER_read(volatile uint32_t* counter, bool reset);
+
 // Generic method for MICROEJ_ASYNC_WORKER_async_exec and MICROEJ_ASYNC_WORKER_async_exec_no_wait
 static MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_intern(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done_callback, bool wait);
 
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_initialize(MICROEJ_ASYNC_WORKER_handle_t* async_worker, uint8_t* name, OSAL_task_stack_t stack, int32_t priority){
+	return MICROEJ_ASYNC_WORKER_initialize_tasks(async_worker, name, &stack, 1, priority, OSAL_NO_AFFINITY);
+}
+
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_initialize_tasks(MICROEJ_ASYNC_WORKER_handle_t* async_worker, uint8_t* name, OSAL_task_stack_t* stacks, int32_t task_count, int32_t priority, int32_t core){
 	// Check configuration
 	int32_t job_count = async_worker->job_count;
 	if(job_count <= 0
 	|| async_worker->waiting_threads_length <= 1 // compare with 1 because '+1' is added when declaring the array
+	|| async_worker->waiting_threads_length > 0xFFFF // offsets are stored on 16 bits
+	|| task_count < 1
+	|| task_count > MICROEJ_ASYNC_WORKER_MAX_TASK_COUNT
 	){
 		return MICROEJ_ASYNC_WORKER_INVALID_ARGS;
 	}
@@ -45,66 +110,102 @@ MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_initialize(MICROEJ_ASYNC_WORK
 	for(int i=0 ; i<job_count-1 ; i++){
 		jobs[i]._intern.next_free_job = &jobs[i+1];
 		jobs[i].params = params;
+		jobs[i]._intern.worker = async_worker;
 		params = ( void *) ( (int32_t)params + params_sizeof );
 	}
 	jobs[job_count-1]._intern.next_free_job = NULL;
 	jobs[job_count-1].params = params;
+	jobs[job_count-1]._intern.worker = async_worker;
 
-	// Create queue
-	OSAL_status_t res = OSAL_queue_create(name, &async_worker->jobs_queue, async_worker->job_count);
+	// Create one queue per lane, each one can hold all the jobs
+	OSAL_status_t res = OSAL_OK;
+	for(int i=0 ; (i<MICROEJ_ASYNC_WORKER_LANE_COUNT) && (res == OSAL_OK) ; i++){
+		res = OSAL_queue_create(name, &async_worker->jobs_queues[i], async_worker->job_count);
+	}
 	if(res != OSAL_OK){
 		return MICROEJ_ASYNC_WORKER_ERROR;
 	}
 
-	// Create mutex
-	res = OSAL_mutex_create(name, &async_worker->mutex);
+	// Create the semaphore counting the queued jobs
+	res = OSAL_counter_semaphore_create(name, 0, (uint32_t)job_count, &async_worker->jobs_semaphore);
 	if(res != OSAL_OK){
 		return MICROEJ_ASYNC_WORKER_ERROR;
 	}
 
-	// Create task
-	res = OSAL_task_create(MICROEJ_ASYNC_WORKER_loop, name, stack, priority, async_worker, &async_worker->task);
-	if(res != OSAL_OK){
-		return MICROEJ_ASYNC_WORKER_ERROR;
+	// Create tasks
+	async_worker->task_count = task_count;
+	for(int i=0 ; i<task_count ; i++){
+		res = OSAL_task_create_on_core(MICROEJ_ASYNC_WORKER_loop, name, stacks[i], priority, core, async_worker, &async_worker->tasks[i]);
+		if(res != OSAL_OK){
+			return MICROEJ_ASYNC_WORKER_ERROR;
+		}
 	}
 
+	// Register the worker so it can be queried from Java
+	async_worker->name = name;
+	async_worker->id = -1;
+	if(MICROEJ_ASYNC_WORKER_worker_count < MICROEJ_ASYNC_WORKER_MAX_WORKER_COUNT){
+		async_worker->id = MICROEJ_ASYNC_WORKER_worker_count;
+		MICROEJ_ASYNC_WORKER_workers[MICROEJ_ASYNC_WORKER_worker_count] = async_worker;
+		MICROEJ_ASYNC_WORKER_worker_count++;
+	}
+#ifdef MICROEJ_ASYNC_WORKER_TRACE
+	if(MICROEJ_ASYNC_WORKER_trace_group < 0){
+		MICROEJ_ASYNC_WORKER_trace_group = TRACE_declare_event_group("AsyncWorker", MICROEJ_ASYNC_WORKER_TRACE_EVENT_COUNT);
+	}
+#endif
+
 	return MICROEJ_ASYNC_WORKER_OK;
 }
 
 
 MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_allocate_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, SNI_callback sni_retry_callback){
 
-	MICROEJ_ASYNC_WORKER_job_t* job = NULL;
+	MICROEJ_ASYNC_WORKER_job_t* job;
 
-	OSAL_mutex_take(&async_worker->mutex, OSAL_INFINITE_TIME);
-	{
+	// Pop a job from the free list. Jobs are popped by the VM task only: a job cannot be popped and pushed
+	// back while the compare and set below is pending, so the free list is not subject to the ABA problem.
+	do {
 		job = async_worker->free_jobs;
-		if(job != NULL){
-			// Free job found: remove it from the free list
-			async_worker->free_jobs = job->_intern.next_free_job;
-			job->_intern.next_free_job = NULL;
-		}
+	} while((job != NULL)
+			&& !OSAL_compare_and_set((volatile uint32_t*)&async_worker->free_jobs, (uint32_t)job, (uint32_t)job->_intern.next_free_job));
+
+	if(job != NULL){
+		job->_intern.next_free_job = NULL;
+		job->_intern.lane = MICROEJ_ASYNC_WORKER_LANE_NORMAL;
+		job->_intern.next_batch_job = NULL;
+		job->_intern.timeout = 0;
+		job->_intern.state = MICROEJ_ASYNC_WORKER_JOB_STATE_DONE; // Not executed yet: cannot be cancelled.
 	}
-	OSAL_mutex_give(&async_worker->mutex);
-
-	if(job == NULL){
+	else {
 		// No free job available: wait for a free job.
 		// Store the current thread id in the waiting list.
 		// First check if there is a free element in the waiting list.
-		int32_t free_waiting_thread_offset = async_worker->free_waiting_thread_offset;
-		int32_t new_free_waiting_thread_offset = free_waiting_thread_offset + 1;
-		if(new_free_waiting_thread_offset >= async_worker->waiting_threads_length){
+		uint32_t free_waiting_thread_offset = async_worker->free_waiting_thread_offset;
+		uint32_t new_free_waiting_thread_offset = free_waiting_thread_offset + 1;
+		if(new_free_waiting_thread_offset >= (uint32_t)async_worker->waiting_threads_length){
 			new_free_waiting_thread_offset = 0;
 		}
 
-		if(new_free_waiting_thread_offset == async_worker->waiting_thread_offset){
+		if(new_free_waiting_thread_offset == (async_worker->waiting_thread_offset & 0xFFFFu)){
 			// The waiting list is full.
+			MICROEJ_ASYNC_WORKER_add(&async_worker->waiting_list_overflow_count, 1);
+			MICROEJ_ASYNC_WORKER_trace_u32(MICROEJ_ASYNC_WORKER_TRACE_WAITING_LIST_OVERFLOW, (uint32_t)async_worker->id);
 			SNI_throwNativeIOException(-1, "MICROEJ_ASYNC_WORKER: thread cannot be suspended, waiting list is full.");
 		}
 		else {
-			async_worker->free_waiting_thread_offset = (uint16_t)new_free_waiting_thread_offset;
 			int32_t thread_id = SNI_getCurrentJavaThreadID();
 			async_worker->waiting_threads[free_waiting_thread_offset] = thread_id;
+			// Publish the slot. Only the VM task writes this offset so the compare and set always succeeds,
+			// it orders the write of the slot before the publication.
+			(void)OSAL_compare_and_set(&async_worker->free_waiting_thread_offset, free_waiting_thread_offset, new_free_waiting_thread_offset);
+
+			// A job may have been freed by a worker task between the pop above and the publication: in this
+			// case nobody will resume a waiting thread, do it now. If the resumed thread is the current one,
+			// its pending resume flag is set and it is not suspended below.
+			if(async_worker->free_jobs != NULL){
+				MICROEJ_ASYNC_WORKER_resume_waiting_thread(async_worker);
+			}
 			SNI_suspendCurrentJavaThreadWithCallback(0, (SNI_callback) sni_retry_callback, NULL);
 		}
 	}
@@ -114,32 +215,111 @@ MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_allocate_job(MICROEJ_ASYNC_WORK
 
 
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_free_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job) {
-	OSAL_mutex_take(&async_worker->mutex, OSAL_INFINITE_TIME);
-	{
-		job->_intern.next_free_job = async_worker->free_jobs;
-		async_worker->free_jobs = job;
-
-		int32_t waiting_thread_offset = async_worker->waiting_thread_offset;
-		if(waiting_thread_offset != async_worker->free_waiting_thread_offset){
-			// A thread was waiting for a free job: notify it
-			int32_t thread_id = async_worker->waiting_threads[waiting_thread_offset];
-			int32_t new_waiting_thread_offset = waiting_thread_offset + 1;
-			if(new_waiting_thread_offset >= async_worker->waiting_threads_length){
-				new_waiting_thread_offset = 0;
-			}
-			async_worker->waiting_thread_offset = new_waiting_thread_offset;
+	// Push the job on the free list
+	MICROEJ_ASYNC_WORKER_job_t* free_jobs;
+	do {
+		free_jobs = async_worker->free_jobs;
+		job->_intern.next_free_job = free_jobs;
+	} while(!OSAL_compare_and_set((volatile uint32_t*)&async_worker->free_jobs, (uint32_t)free_jobs, (uint32_t)job));
+
+	// A thread may be waiting for a free job: notify it
+	MICROEJ_ASYNC_WORKER_resume_waiting_thread(async_worker);
+
+	return MICROEJ_ASYNC_WORKER_OK;
+}
+
+static void MICROEJ_ASYNC_WORKER_resume_waiting_thread(MICROEJ_ASYNC_WORKER_handle_t* async_worker){
+	// Several tasks may free jobs at the same time: the first waiting thread is removed with a compare and set.
+	// The offset is tagged with a counter so a task preempted between the read of the slot and the compare
+	// and set cannot remove a thread added after the list has wrapped around.
+	while(1){
+		uint32_t waiting_thread_offset = async_worker->waiting_thread_offset;
+		uint32_t offset = waiting_thread_offset & 0xFFFFu;
+		if(offset == async_worker->free_waiting_thread_offset){
+			// No waiting thread
+			break;
+		}
+
+		int32_t thread_id = async_worker->waiting_threads[offset];
+		uint32_t new_offset = offset + 1;
+		if(new_offset >= (uint32_t)async_worker->waiting_threads_length){
+			new_offset = 0;
+		}
+		uint32_t new_waiting_thread_offset = ((waiting_thread_offset + 0x10000u) & 0xFFFF0000u) | new_offset;
+		if(OSAL_compare_and_set(&async_worker->waiting_thread_offset, waiting_thread_offset, new_waiting_thread_offset)){
 			SNI_resumeJavaThread(thread_id);
+			break;
 		}
+		// Another task removed the first waiting thread: retry
 	}
-	OSAL_mutex_give(&async_worker->mutex);
+}
+
+void MICROEJ_ASYNC_WORKER_set_job_lane(MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_lane_t lane){
+	job->_intern.lane = lane;
+}
 
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_set_job_timeout(MICROEJ_ASYNC_WORKER_job_t* job, int64_t timeout){
+	if((timeout < 0) || (timeout > MICROEJ_ASYNC_WORKER_MAX_TIMEOUT)){
+		return MICROEJ_ASYNC_WORKER_INVALID_ARGS;
+	}
+	job->_intern.timeout = timeout;
 	return MICROEJ_ASYNC_WORKER_OK;
 }
 
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_cancel_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job){
+	int32_t thread_id = job->_intern.thread_id;
+	// A job executed without waiting thread has no owner to release it.
+	uint32_t flags = MICROEJ_ASYNC_WORKER_JOB_CANCELLED | ((thread_id == SNI_ERROR) ? MICROEJ_ASYNC_WORKER_JOB_OWNER_RELEASED : 0u);
+
+	uint32_t state = job->_intern.state;
+	while(((state & MICROEJ_ASYNC_WORKER_JOB_CANCELLED) == 0u) && ((state & MICROEJ_ASYNC_WORKER_JOB_STATE_MASK) != MICROEJ_ASYNC_WORKER_JOB_STATE_DONE)){
+		if(OSAL_compare_and_set(&job->_intern.state, state, state | flags)){
+			// The worker does not resume the thread of a cancelled job: its callback is called once, now.
+			(void)MICROEJ_ASYNC_WORKER_add(&async_worker->cancel_count, 1);
+			if(thread_id != SNI_ERROR){
+				SNI_resumeJavaThread(thread_id);
+			}
+			return MICROEJ_ASYNC_WORKER_OK;
+		}
+		state = job->_intern.state;
+	}
+	return MICROEJ_ASYNC_WORKER_ERROR;
+}
+
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done_callback){
 	return MICROEJ_ASYNC_WORKER_async_exec_intern(async_worker, job, action, on_done_callback, true);
 }
 
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_batch(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t** jobs, int32_t count, MICROEJ_ASYNC_WORKER_action_t action, SNI_callback on_done_callback){
+	if(count <= 0){
+		SNI_throwNativeIOException(-1, "MICROEJ_ASYNC_WORKER: Invalid batch size.");
+		return MICROEJ_ASYNC_WORKER_INVALID_ARGS;
+	}
+
+	// Chain the jobs, only the first one is queued
+	for(int i=0 ; i<count ; i++){
+		jobs[i]->_intern.action = action;
+		jobs[i]->_intern.next_batch_job = (i < (count-1)) ? jobs[i+1] : NULL;
+	}
+	return MICROEJ_ASYNC_WORKER_async_exec_intern(async_worker, jobs[0], action, on_done_callback, true);
+}
+
+MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_get_next_batch_job(MICROEJ_ASYNC_WORKER_job_t* job){
+	return job->_intern.next_batch_job;
+}
+
+MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_free_batch(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job){
+	MICROEJ_ASYNC_WORKER_status_t status = MICROEJ_ASYNC_WORKER_OK;
+	while(job != NULL){
+		MICROEJ_ASYNC_WORKER_job_t* next_job = job->_intern.next_batch_job;
+		if(MICROEJ_ASYNC_WORKER_free_job(async_worker, job) != MICROEJ_ASYNC_WORKER_OK){
+			status = MICROEJ_ASYNC_WORKER_ERROR;
+		}
+		job = next_job;
+	}
+	return status;
+}
+
 MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_no_wait(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, MICROEJ_ASYNC_WORKER_action_t action){
 	return MICROEJ_ASYNC_WORKER_async_exec_intern(async_worker, job, action, NULL, false);
 }
@@ -149,19 +329,34 @@ MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_intern(MICROEJ_ASY
 
 	if(wait == true){
 		job->_intern.thread_id = SNI_getCurrentJavaThreadID();
+		// A resume that arrived after the end of a previous job of this thread (e.g. once its timeout has expired)
+		// must not wake the thread before the end of this one.
+		(void)SNI_clearCurrentJavaThreadPendingResumeFlag();
 	}
 	else {
 		job->_intern.thread_id = SNI_ERROR;
 	}
+	job->_intern.on_done_callback = on_done_callback;
+	job->_intern.draining_resume = false;
+	job->_intern.state = MICROEJ_ASYNC_WORKER_JOB_STATE_QUEUED;
 
-	OSAL_status_t res = OSAL_queue_post(&async_worker->jobs_queue, job);
+	// Count the job before posting it: a worker task may dequeue it before the post returns.
+	uint32_t queue_depth = MICROEJ_ASYNC_WORKER_add(&async_worker->queue_depth, 1);
+	MICROEJ_ASYNC_WORKER_max(&async_worker->max_queue_depth, queue_depth);
+	job->_intern.queue_time = OSAL_get_time_us();
+	MICROEJ_ASYNC_WORKER_trace_u32x2(MICROEJ_ASYNC_WORKER_TRACE_JOB_QUEUED, (uint32_t)async_worker->id, (uint32_t)job->_intern.lane);
+
+	OSAL_status_t res = OSAL_queue_post(&async_worker->jobs_queues[job->_intern.lane], job);
 	if(res == OSAL_OK){
+		// Wake up a worker task. Cannot fail: there are never more queued jobs than jobs.
+		(void)OSAL_counter_semaphore_give(&async_worker->jobs_semaphore);
 		if(wait == true){
-			SNI_suspendCurrentJavaThreadWithCallback(0, (SNI_callback)on_done_callback, job);
+			SNI_suspendCurrentJavaThreadWithCallback(job->_intern.timeout, (SNI_callback)on_done_callback, job);
 		}
 		return MICROEJ_ASYNC_WORKER_OK;
 	}
 	else {
+		(void)MICROEJ_ASYNC_WORKER_add(&async_worker->queue_depth, (uint32_t)-1);
 		SNI_throwNativeIOException(-1, "MICROEJ_ASYNC_WORKER: Internal error.");
 		return MICROEJ_ASYNC_WORKER_ERROR;
 	}
@@ -171,24 +366,302 @@ MICROEJ_ASYNC_WORKER_status_t MICROEJ_ASYNC_WORKER_async_exec_intern(MICROEJ_ASY
 MICROEJ_ASYNC_WORKER_job_t* MICROEJ_ASYNC_WORKER_get_job_done(void){
 	MICROEJ_ASYNC_WORKER_job_t* job = NULL;
 	SNI_getCallbackArgs((void**)&job, NULL);
-	return job;
+	if(job == NULL){
+		return NULL;
+	}
+
+	uint32_t state = job->_intern.state;
+	if((state & MICROEJ_ASYNC_WORKER_JOB_CANCELLED) != 0u){
+		// Cancelled with MICROEJ_ASYNC_WORKER_cancel_job(), the job is freed here if the worker has already released it.
+		SNI_throwNativeIOException(-1, "MICROEJ_ASYNC_WORKER: job cancelled.");
+		MICROEJ_ASYNC_WORKER_release_job(job->_intern.worker, job, MICROEJ_ASYNC_WORKER_JOB_OWNER_RELEASED);
+		return NULL;
+	}
+
+	// The thread may also have been resumed by its timeout. Keep a margin: the clock of the VM and the one used
+	// here are not the same.
+	int64_t timeout = job->_intern.timeout;
+	int64_t elapsed = (int64_t)((OSAL_get_time_us() - job->_intern.queue_time) / 1000u);
+	bool deadline_reached = (timeout != 0) && ((elapsed + MICROEJ_ASYNC_WORKER_TIMEOUT_GRACE_TIME) >= timeout);
+
+	while(deadline_reached && ((state & MICROEJ_ASYNC_WORKER_JOB_STATE_MASK) != MICROEJ_ASYNC_WORKER_JOB_STATE_DONE)){
+		// Only the worker modifies the state concurrently, to start or end the job.
+		if(OSAL_compare_and_set(&job->_intern.state, state, state | MICROEJ_ASYNC_WORKER_JOB_CANCELLED | MICROEJ_ASYNC_WORKER_JOB_TIMED_OUT | MICROEJ_ASYNC_WORKER_JOB_OWNER_RELEASED)){
+			(void)MICROEJ_ASYNC_WORKER_add(&job->_intern.worker->timeout_count, 1);
+			SNI_throwNativeIOException(-1, "MICROEJ_ASYNC_WORKER: job timeout.");
+			return NULL;
+		}
+		state = job->_intern.state;
+	}
+
+	if((state & MICROEJ_ASYNC_WORKER_JOB_STATE_MASK) == MICROEJ_ASYNC_WORKER_JOB_STATE_DONE){
+		if(deadline_reached && !job->_intern.draining_resume){
+			// Done at its deadline: the thread may have been resumed by its timeout and the worker may not have resumed
+			// it yet. Wait for this resume, or for the grace time if it was the one that resumed the thread.
+			job->_intern.draining_resume = true;
+			SNI_suspendCurrentJavaThreadWithCallback(MICROEJ_ASYNC_WORKER_TIMEOUT_GRACE_TIME, job->_intern.on_done_callback, job);
+			return NULL;
+		}
+		return job;
+	}
+
+	// Resumed before the end of the job: wait again until the job is done or its timeout expires.
+	SNI_suspendCurrentJavaThreadWithCallback((timeout == 0) ? 0 : (timeout - elapsed), job->_intern.on_done_callback, job);
+	return NULL;
+}
+
+void MICROEJ_ASYNC_WORKER_get_statistics(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_statistics_t* statistics, bool reset){
+	statistics->wakeup_count = MICROEJ_ASYNC_WORKER_read(&async_worker->wakeup_count, reset);
+	statistics->executed_job_count = MICROEJ_ASYNC_WORKER_read(&async_worker->executed_job_count, reset);
+	statistics->batch_count = MICROEJ_ASYNC_WORKER_read(&async_worker->batch_count, reset);
+	statistics->resume_count = MICROEJ_ASYNC_WORKER_read(&async_worker->resume_count, reset);
+	statistics->queue_depth = MICROEJ_ASYNC_WORKER_read(&async_worker->queue_depth, false);
+	statistics->max_queue_depth = MICROEJ_ASYNC_WORKER_read(&async_worker->max_queue_depth, reset);
+	statistics->waiting_list_overflow_count = MICROEJ_ASYNC_WORKER_read(&async_worker->waiting_list_overflow_count, reset);
+	statistics->max_wait_time = MICROEJ_ASYNC_WORKER_read(&async_worker->max_wait_time, reset);
+	statistics->max_service_time = MICROEJ_ASYNC_WORKER_read(&async_worker->max_service_time, reset);
+	for(int i=0 ; i<MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT ; i++){
+		statistics->wait_histogram[i] = MICROEJ_ASYNC_WORKER_read(&async_worker->wait_histogram[i], reset);
+		statistics->service_histogram[i] = MICROEJ_ASYNC_WORKER_read(&async_worker->service_histogram[i], reset);
+	}
+	statistics->timeout_count = MICROEJ_ASYNC_WORKER_read(&async_worker->timeout_count, reset);
+	statistics->cancel_count = MICROEJ_ASYNC_WORKER_read(&async_worker->cancel_count, reset);
+}
+
+bool MICROEJ_ASYNC_WORKER_get_action_statistics(MICROEJ_ASYNC_WORKER_handle_t* async_worker, int32_t index, MICROEJ_ASYNC_WORKER_action_statistics_t* statistics, bool reset){
+	if((index < 0) || (index >= MICROEJ_ASYNC_WORKER_ACTION_STATISTICS_COUNT) || (async_worker->action_counters[index].action == 0u)){
+		return false;
+	}
+	MICROEJ_ASYNC_WORKER_action_counters_t* counters = &async_worker->action_counters[index];
+	statistics->action = (MICROEJ_ASYNC_WORKER_action_t)counters->action;
+	statistics->count = MICROEJ_ASYNC_WORKER_read(&counters->count, reset);
+	statistics->total_time = MICROEJ_ASYNC_WORKER_read(&counters->total_time, reset);
+	statistics->max_time = MICROEJ_ASYNC_WORKER_read(&counters->max_time, reset);
+	return true;
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_worker_count(void){
+	return MICROEJ_ASYNC_WORKER_worker_count;
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_name(int32_t worker_id, uint8_t* name){
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = MICROEJ_ASYNC_WORKER_get_worker(worker_id);
+	int32_t name_length = SNI_getArrayLength(name);
+	if((async_worker == NULL) || (name_length <= 0)){
+		return -1;
+	}
+	int32_t length = 0;
+	while((length < (name_length - 1)) && (async_worker->name[length] != (uint8_t)'\0')){
+		name[length] = async_worker->name[length];
+		length++;
+	}
+	name[length] = (uint8_t)'\0';
+	return length;
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_statistics(int32_t worker_id, int64_t* statistics, jboolean reset){
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = MICROEJ_ASYNC_WORKER_get_worker(worker_id);
+	if((async_worker == NULL) || (SNI_getArrayLength(statistics) < MICROEJ_ASYNC_WORKER_STAT_COUNT)){
+		return -1;
+	}
+
+	MICROEJ_ASYNC_WORKER_statistics_t worker_statistics;
+	MICROEJ_ASYNC_WORKER_get_statistics(async_worker, &worker_statistics, reset == (jboolean)JTRUE);
+	statistics[MICROEJ_ASYNC_WORKER_STAT_WAKEUP_COUNT] = (int64_t)worker_statistics.wakeup_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_EXECUTED_JOB_COUNT] = (int64_t)worker_statistics.executed_job_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_BATCH_COUNT] = (int64_t)worker_statistics.batch_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_RESUME_COUNT] = (int64_t)worker_statistics.resume_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_QUEUE_DEPTH] = (int64_t)worker_statistics.queue_depth;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_MAX_QUEUE_DEPTH] = (int64_t)worker_statistics.max_queue_depth;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_WAITING_LIST_OVERFLOW_COUNT] = (int64_t)worker_statistics.waiting_list_overflow_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_MAX_WAIT_TIME] = (int64_t)worker_statistics.max_wait_time;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_MAX_SERVICE_TIME] = (int64_t)worker_statistics.max_service_time;
+	for(int i=0 ; i<MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT ; i++){
+		statistics[MICROEJ_ASYNC_WORKER_STAT_WAIT_HISTOGRAM + i] = (int64_t)worker_statistics.wait_histogram[i];
+		statistics[MICROEJ_ASYNC_WORKER_STAT_SERVICE_HISTOGRAM + i] = (int64_t)worker_statistics.service_histogram[i];
+	}
+	statistics[MICROEJ_ASYNC_WORKER_STAT_TIMEOUT_COUNT] = (int64_t)worker_statistics.timeout_count;
+	statistics[MICROEJ_ASYNC_WORKER_STAT_CANCEL_COUNT] = (int64_t)worker_statistics.cancel_count;
+	return MICROEJ_ASYNC_WORKER_STAT_COUNT;
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_action_statistics(int32_t worker_id, int32_t index, int64_t* statistics, jboolean reset){
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = MICROEJ_ASYNC_WORKER_get_worker(worker_id);
+	if((async_worker == NULL) || (SNI_getArrayLength(statistics) < MICROEJ_ASYNC_WORKER_ACTION_STAT_SIZE)){
+		return -1;
+	}
+
+	MICROEJ_ASYNC_WORKER_action_statistics_t action_statistics;
+	if(!MICROEJ_ASYNC_WORKER_get_action_statistics(async_worker, index, &action_statistics, reset == (jboolean)JTRUE)){
+		return 0;
+	}
+	statistics[MICROEJ_ASYNC_WORKER_ACTION_STAT_ADDRESS] = (int64_t)(uint32_t)action_statistics.action;
+	statistics[MICROEJ_ASYNC_WORKER_ACTION_STAT_COUNT] = (int64_t)action_statistics.count;
+	statistics[MICROEJ_ASYNC_WORKER_ACTION_STAT_TOTAL_TIME] = (int64_t)action_statistics.total_time;
+	statistics[MICROEJ_ASYNC_WORKER_ACTION_STAT_MAX_TIME] = (int64_t)action_statistics.max_time;
+	return MICROEJ_ASYNC_WORKER_ACTION_STAT_SIZE;
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_get_current_thread_id(void){
+	return SNI_getCurrentJavaThreadID();
+}
+
+int32_t MICROEJ_ASYNC_WORKER_IMPL_cancel(int32_t worker_id, int32_t thread_id){
+	MICROEJ_ASYNC_WORKER_handle_t* async_worker = MICROEJ_ASYNC_WORKER_get_worker(worker_id);
+	if(async_worker == NULL){
+		return -1;
+	}
+
+	// Jobs are queued by the VM task only, which also runs this native: the thread id of a queued or running job is stable.
+	int32_t count = 0;
+	for(int i=0 ; i<async_worker->job_count ; i++){
+		MICROEJ_ASYNC_WORKER_job_t* job = &async_worker->jobs[i];
+		uint32_t state = job->_intern.state & MICROEJ_ASYNC_WORKER_JOB_STATE_MASK;
+		if((state != MICROEJ_ASYNC_WORKER_JOB_STATE_DONE) && (job->_intern.thread_id == thread_id) && (thread_id != SNI_ERROR)
+				&& (MICROEJ_ASYNC_WORKER_cancel_job(async_worker, job) == MICROEJ_ASYNC_WORKER_OK)){
+			count++;
+		}
+	}
+	return count;
+}
+
+static void MICROEJ_ASYNC_WORKER_release_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job, uint32_t flag){
+	uint32_t state;
+	do {
+		state = job->_intern.state;
+	} while(!OSAL_compare_and_set(&job->_intern.state, state, state | flag));
+
+	if(((state | flag) & MICROEJ_ASYNC_WORKER_JOB_RELEASED) == MICROEJ_ASYNC_WORKER_JOB_RELEASED){
+		(void)MICROEJ_ASYNC_WORKER_free_batch(async_worker, job);
+	}
+}
+
+static MICROEJ_ASYNC_WORKER_handle_t* MICROEJ_ASYNC_WORKER_get_worker(int32_t worker_id){
+	if((worker_id < 0) || (worker_id >= MICROEJ_ASYNC_WORKER_worker_count)){
+		return NULL;
+	}
+	return MICROEJ_ASYNC_WORKER_workers[worker_id];
+}
+
+static uint32_t MICROEJ_ASYNC_WORKER_add(volatile uint32_t* counter, uint32_t value){
+	uint32_t count;
+	do {
+		count = *counter;
+	} while(!OSAL_compare_and_set(counter, count, count + value));
+	return count + value;
+}
+
+static void MICROEJ_ASYNC_WORKER_max(volatile uint32_t* counter, uint32_t value){
+	uint32_t max;
+	do {
+		max = *counter;
+	} while((value > max) && !OSAL_compare_and_set(counter, max, value));
+}
+
+static void MICROEJ_ASYNC_WORKER_histogram_add(volatile uint32_t* histogram, uint32_t time){
+	int bucket = 0;
+	while((bucket < (MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_COUNT - 1)) && (time >= MICROEJ_ASYNC_WORKER_HISTOGRAM_BUCKET_LIMIT(bucket))){
+		bucket++;
+	}
+	(void)MICROEJ_ASYNC_WORKER_add(&histogram[bucket], 1);
+}
+
+static void MICROEJ_ASYNC_WORKER_action_add(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_action_t action, uint32_t time){
+	// Find the entry of the action or claim the first free one. Entries are never released so a claimed entry
+	// always belongs to the same action.
+	uint32_t address = (uint32_t)action;
+	for(int i=0 ; i<MICROEJ_ASYNC_WORKER_ACTION_STATISTICS_COUNT ; i++){
+		MICROEJ_ASYNC_WORKER_action_counters_t* counters = &async_worker->action_counters[i];
+		if((counters->action == address) || ((counters->action == 0u) && (OSAL_compare_and_set(&counters->action, 0u, address) || (counters->action == address)))){
+			(void)MICROEJ_ASYNC_WORKER_add(&counters->count, 1);
+			(void)MICROEJ_ASYNC_WORKER_add(&counters->total_time, time);
+			MICROEJ_ASYNC_WORKER_max(&counters->max_time, time);
+			return;
+		}
+	}
+}
+
+static uint32_t MICROEJ_ASYNC_WORKER_read(volatile uint32_t* counter, bool reset){
+	uint32_t count;
+	do {
+		count = *counter;
+	} while(reset && !OSAL_compare_and_set(counter, count, 0));
+	return count;
+}
+
+// Executes a queued job, or all the jobs of a queued batch, and notifies the waiting Java thread.
+static void MICROEJ_ASYNC_WORKER_execute(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_job_t* job){
+	// Read before the end of the job: once done, the job may be freed by the VM task at any time.
+	int32_t thread_id = job->_intern.thread_id;
+
+	if(!OSAL_compare_and_set(&job->_intern.state, MICROEJ_ASYNC_WORKER_JOB_STATE_QUEUED, MICROEJ_ASYNC_WORKER_JOB_STATE_RUNNING)){
+		// Cancelled or timed out before it started: do not execute it.
+		MICROEJ_ASYNC_WORKER_release_job(async_worker, job, MICROEJ_ASYNC_WORKER_JOB_WORKER_RELEASED);
+		return;
+	}
+
+	uint32_t start_time = OSAL_get_time_us();
+	uint32_t wait_time = start_time - job->_intern.queue_time;
+	MICROEJ_ASYNC_WORKER_histogram_add(async_worker->wait_histogram, wait_time);
+	MICROEJ_ASYNC_WORKER_max(&async_worker->max_wait_time, wait_time);
+
+	uint32_t job_count = 0;
+	for(MICROEJ_ASYNC_WORKER_job_t* batch_job = job ; batch_job != NULL ; batch_job = batch_job->_intern.next_batch_job){
+		MICROEJ_ASYNC_WORKER_trace_u32x2(MICROEJ_ASYNC_WORKER_TRACE_JOB_EXECUTE, (uint32_t)async_worker->id, wait_time);
+		batch_job->_intern.action(batch_job);
+		uint32_t end_time = OSAL_get_time_us();
+		uint32_t service_time = end_time - start_time;
+		MICROEJ_ASYNC_WORKER_trace_end_u32(MICROEJ_ASYNC_WORKER_TRACE_JOB_EXECUTE, service_time);
+
+		MICROEJ_ASYNC_WORKER_histogram_add(async_worker->service_histogram, service_time);
+		MICROEJ_ASYNC_WORKER_max(&async_worker->max_service_time, service_time);
+		MICROEJ_ASYNC_WORKER_action_add(async_worker, batch_job->_intern.action, service_time);
+		start_time = end_time;
+		job_count++;
+	}
+	(void)MICROEJ_ASYNC_WORKER_add(&async_worker->executed_job_count, job_count);
+	(void)MICROEJ_ASYNC_WORKER_add(&async_worker->batch_count, 1);
+
+	if(!OSAL_compare_and_set(&job->_intern.state, MICROEJ_ASYNC_WORKER_JOB_STATE_RUNNING, MICROEJ_ASYNC_WORKER_JOB_STATE_DONE)){
+		// Cancelled or timed out while running: the result is discarded and the thread has already been resumed.
+		MICROEJ_ASYNC_WORKER_release_job(async_worker, job, MICROEJ_ASYNC_WORKER_JOB_WORKER_RELEASED);
+	}
+	else if(thread_id != SNI_ERROR){
+		(void)MICROEJ_ASYNC_WORKER_add(&async_worker->resume_count, 1);
+		SNI_resumeJavaThread(thread_id);
+	}
+	else {
+		MICROEJ_ASYNC_WORKER_free_job(async_worker, job);
+	}
 }
 
 static void MICROEJ_ASYNC_WORKER_loop(void* args){
 	MICROEJ_ASYNC_WORKER_handle_t* async_worker = (MICROEJ_ASYNC_WORKER_handle_t*) args;
 
 	while(1){
-		MICROEJ_ASYNC_WORKER_job_t* job;
-		OSAL_status_t res = OSAL_queue_fetch(&async_worker->jobs_queue, (void**)&job, OSAL_INFINITE_TIME);
+		// Take a queued job without blocking first: the task only blocks, and counts a wakeup, when no job is queued.
+		OSAL_status_t res = OSAL_counter_semaphore_take(&async_worker->jobs_semaphore, 0);
+		if(res != OSAL_OK){
+			res = OSAL_counter_semaphore_take(&async_worker->jobs_semaphore, OSAL_INFINITE_TIME);
+			if(res == OSAL_OK){
+				(void)MICROEJ_ASYNC_WORKER_add(&async_worker->wakeup_count, 1);
+			}
+		}
 
 		if(res == OSAL_OK){
-			// New job to execute
-			job->_intern.action(job);
-			if(job->_intern.thread_id != SNI_ERROR){
-				SNI_resumeJavaThread(job->_intern.thread_id);
+			// A job has been queued: take the first one of the highest priority lane.
+			// Each job is counted once in the semaphore so a queued job is always found.
+			MICROEJ_ASYNC_WORKER_job_t* job = NULL;
+			for(int i=0 ; (i<MICROEJ_ASYNC_WORKER_LANE_COUNT) && (job == NULL) ; i++){
+				if(OSAL_queue_fetch(&async_worker->jobs_queues[i], (void**)&job, 0) != OSAL_OK){
+					job = NULL;
+				}
 			}
-			else {
-				MICROEJ_ASYNC_WORKER_free_job(async_worker, job);
+
+			if(job != NULL){
+				// New job to execute
+				(void)MICROEJ_ASYNC_WORKER_add(&async_worker->queue_depth, (uint32_t)-1);
+				MICROEJ_ASYNC_WORKER_execute(async_worker, job);
 			}
 		}
 	}
@@ -9,17 +9,65 @@
  * @file
  * @brief MicroEJ memory pool implementation
  * @author MicroEJ Developer Team
- * @version 0.1.0
+ * @version 0.2.0
  */
 
 #include "microej_pool.h"
 #include <stdio.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/** @brief get the address of the item at the given index */
+#define POOL_ITEM_AT(_st_pool_ctx, ui_index) \
+	((void*)((unsigned char*)((_st_pool_ctx)->pv_first_item) + ((ui_index) * (_st_pool_ctx)->ui_size_of_item)))
+
+/** @brief true if the free list can be stored in the items of the pool */
+#define POOL_HAS_FREE_LIST(_st_pool_ctx) ((_st_pool_ctx)->ui_size_of_item >= sizeof(void*))
+
+/* Items are not necessarily aligned on pointers: the links are copied */
+static void * POOL_get_next_free(void * _pv_item)
+{
+	void * pv_next;
+	(void)memcpy(&pv_next, _pv_item, sizeof(void*));
+	return (pv_next);
+}
+
+static void POOL_set_next_free(void * _pv_item, void * _pv_next)
+{
+	(void)memcpy(_pv_item, &_pv_next, sizeof(void*));
+}
+
+/* Chain the free items, the first item of the pool is at the head of the list */
+static void POOL_build_free_list(POOL_ctx_t * _st_pool_ctx)
+{
+	unsigned int ui_i;
+
+	_st_pool_ctx->st_internal.pv_free_list = NULL;
+	_st_pool_ctx->st_internal.ui_num_item_used = 0;
+	for (ui_i = _st_pool_ctx->uc_num_item_in_pool; ui_i > 0U; ui_i--)
+	{
+		if (POOL_USED != _st_pool_ctx->puc_item_status[ui_i - 1U])
+		{
+			void * pv_item = POOL_ITEM_AT(_st_pool_ctx, ui_i - 1U);
+			POOL_set_next_free(pv_item, _st_pool_ctx->st_internal.pv_free_list);
+			_st_pool_ctx->st_internal.pv_free_list = pv_item;
+		}
+		else
+		{
+			_st_pool_ctx->st_internal.ui_num_item_used++;
+		}
+	}
+	if (_st_pool_ctx->st_internal.ui_high_water_mark < _st_pool_ctx->st_internal.ui_num_item_used)
+	{
+		_st_pool_ctx->st_internal.ui_high_water_mark = _st_pool_ctx->st_internal.ui_num_item_used;
+	}
+	_st_pool_ctx->st_internal.b_free_list_built = true;
+}
+
 POOL_status_t POOL_reserve_f(POOL_ctx_t * _st_pool_ctx,
 		                     void ** _ppv_item_reserved)
 {
@@ -32,24 +80,51 @@ POOL_status_t POOL_reserve_f(POOL_ctx_t * _st_pool_ctx,
 		 (NULL != _st_pool_ctx) &&
 		 (NULL != _st_pool_ctx->pv_first_item))
 	{
-		/* looking for a free place in pool */
-		for (uc_i = 0;(uc_i < _st_pool_ctx->uc_num_item_in_pool) && (!uc_found);uc_i++)
+		if (POOL_HAS_FREE_LIST(_st_pool_ctx))
 		{
-			if (POOL_USED != _st_pool_ctx->puc_item_status[uc_i])
+			if (!_st_pool_ctx->st_internal.b_free_list_built)
 			{
-				uc_found = 1;
+				POOL_build_free_list(_st_pool_ctx);
+			}
+
+			/* take the head of the free list */
+			if (NULL != _st_pool_ctx->st_internal.pv_free_list)
+			{
+				void * pv_item = _st_pool_ctx->st_internal.pv_free_list;
+				uc_i = (unsigned int)(((unsigned char*)pv_item - (unsigned char*)_st_pool_ctx->pv_first_item) / _st_pool_ctx->ui_size_of_item);
+				_st_pool_ctx->st_internal.pv_free_list = POOL_get_next_free(pv_item);
 				_st_pool_ctx->puc_item_status[uc_i] = POOL_USED;
-				*_ppv_item_reserved = (void*)((unsigned char*)(_st_pool_ctx->pv_first_item) + (uc_i * _st_pool_ctx->ui_size_of_item));
+				*_ppv_item_reserved = pv_item;
+				uc_found = 1;
+			}
+		}
+		else
+		{
+			/* looking for a free place in pool */
+			for (uc_i = 0;(uc_i < _st_pool_ctx->uc_num_item_in_pool) && (!uc_found);uc_i++)
+			{
+				if (POOL_USED != _st_pool_ctx->puc_item_status[uc_i])
+				{
+					uc_found = 1;
+					_st_pool_ctx->puc_item_status[uc_i] = POOL_USED;
+					*_ppv_item_reserved = POOL_ITEM_AT(_st_pool_ctx, uc_i);
+				}
 			}
 		}
 
 		/* test if poll is full */
 		if (!uc_found)
 		{
+			_st_pool_ctx->st_internal.ui_num_reserve_failed++;
 			e_return = POOL_NO_SPACE_AVAILABLE;
 		}
 		else
 		{
+			_st_pool_ctx->st_internal.ui_num_item_used++;
+			if (_st_pool_ctx->st_internal.ui_high_water_mark < _st_pool_ctx->st_internal.ui_num_item_used)
+			{
+				_st_pool_ctx->st_internal.ui_high_water_mark = _st_pool_ctx->st_internal.ui_num_item_used;
+			}
 			e_return = POOL_NO_ERROR;
 		}
 	}
@@ -67,6 +142,7 @@ POOL_status_t POOL_get_f(POOL_ctx_t * _st_pool_ctx, void ** _ppv_item_retrieved,
 {
 	POOL_status_t e_return;
 	unsigned int uc_i;
+	unsigned int ui_num_item_visited = 0;
 	unsigned char uc_found = 0;
 	void * _pv_item = NULL;
 
@@ -75,14 +151,23 @@ POOL_status_t POOL_get_f(POOL_ctx_t * _st_pool_ctx, void ** _ppv_item_retrieved,
 		 (_st_pool_ctx != NULL) &&
 		 (NULL != _st_pool_ctx->pv_first_item))
 	{
-		/* looking for the item that matches with the given compare function */
-		for (uc_i = 0;(uc_i < _st_pool_ctx->uc_num_item_in_pool) && (!uc_found);uc_i++)
+		if (POOL_HAS_FREE_LIST(_st_pool_ctx) && !_st_pool_ctx->st_internal.b_free_list_built)
 		{
-			_pv_item = (void*)((unsigned char*)(_st_pool_ctx->pv_first_item) + (uc_i * _st_pool_ctx->ui_size_of_item));
-			if (POOL_USED == _st_pool_ctx->puc_item_status[uc_i] && compare_to(_pv_item, characteristic))
+			POOL_build_free_list(_st_pool_ctx);
+		}
+
+		/* looking for the item that matches with the given compare function, up to the last reserved item */
+		for (uc_i = 0;(uc_i < _st_pool_ctx->uc_num_item_in_pool) && (ui_num_item_visited < _st_pool_ctx->st_internal.ui_num_item_used) && (!uc_found);uc_i++)
+		{
+			if (POOL_USED == _st_pool_ctx->puc_item_status[uc_i])
 			{
-				*_ppv_item_retrieved = _pv_item;
-				uc_found = 1;
+				ui_num_item_visited++;
+				_pv_item = POOL_ITEM_AT(_st_pool_ctx, uc_i);
+				if (compare_to(_pv_item, characteristic))
+				{
+					*_ppv_item_retrieved = _pv_item;
+					uc_found = 1;
+				}
 			}
 		}
 
@@ -116,13 +201,25 @@ POOL_status_t POOL_free_f(POOL_ctx_t * _st_pool_ctx,
 		(NULL != _st_pool_ctx) &&
 		(NULL != _st_pool_ctx->pv_first_item))
 	{
-		/* looking for item index to free place in pool */
-		for (uc_i = 0;(uc_i < _st_pool_ctx->uc_num_item_in_pool) && (!uc_found);uc_i++)
+		/* compute the item index from its address */
+		unsigned char* puc_first = (unsigned char*)_st_pool_ctx->pv_first_item;
+		unsigned char* puc_item = (unsigned char*)_pv_item_to_free;
+		if ((puc_item >= puc_first) &&
+			(puc_item < (puc_first + (_st_pool_ctx->uc_num_item_in_pool * _st_pool_ctx->ui_size_of_item))) &&
+			((((unsigned int)(puc_item - puc_first)) % _st_pool_ctx->ui_size_of_item) == 0U))
 		{
-			if ((void*)((unsigned char*)(_st_pool_ctx->pv_first_item) + (uc_i * _st_pool_ctx->ui_size_of_item)) == _pv_item_to_free)
+			uc_i = ((unsigned int)(puc_item - puc_first)) / _st_pool_ctx->ui_size_of_item;
+			/* an item freed twice is not found */
+			if (POOL_USED == _st_pool_ctx->puc_item_status[uc_i])
 			{
 				uc_found = 1;
 				_st_pool_ctx->puc_item_status[uc_i] = POOL_FREE;
+				_st_pool_ctx->st_internal.ui_num_item_used--;
+				if (POOL_HAS_FREE_LIST(_st_pool_ctx) && _st_pool_ctx->st_internal.b_free_list_built)
+				{
+					POOL_set_next_free(_pv_item_to_free, _st_pool_ctx->st_internal.pv_free_list);
+					_st_pool_ctx->st_internal.pv_free_list = _pv_item_to_free;
+				}
 			}
 		}
 
@@ -144,6 +241,29 @@ POOL_status_t POOL_free_f(POOL_ctx_t * _st_pool_ctx,
 	return (e_return);
 }
 
+POOL_status_t POOL_get_statistics_f(POOL_ctx_t * _st_pool_ctx,
+		                            POOL_statistics_t * _pst_statistics)
+{
+	POOL_status_t e_return;
+
+	/* test entry function */
+	if ((NULL != _st_pool_ctx) &&
+		(NULL != _pst_statistics))
+	{
+		_pst_statistics->ui_num_item_in_pool = _st_pool_ctx->uc_num_item_in_pool;
+		_pst_statistics->ui_num_item_used = _st_pool_ctx->st_internal.ui_num_item_used;
+		_pst_statistics->ui_high_water_mark = _st_pool_ctx->st_internal.ui_high_water_mark;
+		_pst_statistics->ui_num_reserve_failed = _st_pool_ctx->st_internal.ui_num_reserve_failed;
+		e_return = POOL_NO_ERROR;
+	}
+	else
+	{
+		e_return = POOL_ERROR_IN_ENTRY_PARAMETERS;
+	}
+
+	return (e_return);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,6 +58,47 @@ OSAL_status_t OSAL_task_create(OSAL_task_entry_point_t entry_point, uint8_t* nam
     return OSAL_OK;
 }
 
+/**
+ * @brief Create an OS task pinned to a core and start it.
+ *
+ * @param[in] entry_point function called at task startup
+ * @param[in] name the task name
+ * @param[in] stack task stack declared using OSAL_task_stack_declare() macro
+ * @param[in] priority task priority
+ * @param[in] core index of the core that runs the task, OSAL_NO_AFFINITY to run it on any core
+ * @param[in] parameters task entry parameters. NULL if no entry parameters
+ * @param[in,out] handle pointer on a task handle
+ *
+ * @return operation status (@see OSAL_status_t)
+ */
+OSAL_status_t OSAL_task_create_on_core(OSAL_task_entry_point_t entry_point, uint8_t* name, OSAL_task_stack_t stack, int32_t priority, int32_t core, void* parameters, OSAL_task_handle_t* handle)
+{
+#ifdef tskNO_AFFINITY
+    uint16_t stack_size = (uint16_t)stack;
+
+    if (handle == NULL)
+    {
+        return OSAL_WRONG_ARGS;
+    }
+
+    if (xTaskCreatePinnedToCore(entry_point, (char const *)name,
+        (stack_size / (sizeof(portSTACK_TYPE))),
+        parameters,
+        (unsigned portBASE_TYPE)priority,
+        handle,
+        (core == OSAL_NO_AFFINITY) ? tskNO_AFFINITY : (BaseType_t)core) != pdPASS)
+    {
+        return OSAL_ERROR;
+    }
+
+    return OSAL_OK;
+#else
+    /* Task affinity is not supported by this FreeRTOS port */
+    (void)core;
+    return OSAL_task_create(entry_point, name, stack, priority, parameters, handle);
+#endif
+}
+
 /**
  * @brief Delete an OS task and start it.
  *
@@ -0,0 +1,31 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_ALLOCATOR_H
+#define __T_CORE_ALLOCATOR_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the size class slabs of microej_allocator: blocks are taken from the smallest class that fits, a full
+ * slab falls back to the heap, and tasks pinned to each core allocate and free blocks concurrently without sharing one.
+ * A benchmark prints the time of a malloc/free pair from a slab and from the heap.
+ */
+TestRef T_CORE_ALLOCATOR_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_ASYNC_WORKER_H
+#define __T_CORE_ASYNC_WORKER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Stresses the lock-free free-job list of microej_async_worker: jobs are allocated by the test task and freed
+ * concurrently by worker tasks running on both cores. The test fails if a job is given twice, if a job is lost, or if
+ * the worker has to suspend or resume a Java thread. The average allocate/exec/free round trip time is printed.
+ * Short jobs are then executed while bulk jobs keep the worker busy: their median and tail latencies are printed in the
+ * normal and high lanes, with one worker task and with two. Finally, the test task acts as a Java thread executing
+ * batches of jobs: each batch must run its jobs in order and resume the thread exactly once. It then waits for a job
+ * that does not return until its timeout expires, or until another thread cancels it with the NativeAsyncWorker native:
+ * the thread must resume with an exception and the job slot must be reused once the action returns.
+ */
+TestRef T_CORE_ASYNC_WORKER_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
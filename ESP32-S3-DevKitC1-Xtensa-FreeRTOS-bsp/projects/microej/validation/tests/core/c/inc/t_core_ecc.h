@@ -0,0 +1,32 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_ECC_H
+#define __T_CORE_ECC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the Ed25519 and Ed25519ph signatures against the RFC 8032 test vectors and rejects tampered
+ * signatures. The time of a signature and of a verification is printed for Ed25519ph and ECDSA P-256, as well as the
+ * ECDSA P-256 signature throughput with the same key and the time of a key generation and of a key agreement for
+ * X25519 and ECDH P-256.
+ */
+TestRef T_CORE_ECC_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_FS_H
+#define __T_CORE_FS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the file system helper actions on the SPI flash, executed by the test task instead of an FS
+ * worker. Append logs are reopened after torn and corrupted writes: the recovery must stop after the last complete
+ * record. Files opened for reading are reopened, modified and opened all at once while the FatFs helper keeps some of
+ * them open. Directories are listed entry by entry and in bulk, with a glob filter. The append throughput, the reopen
+ * time, the byte-wise read and sequential transfer throughputs and the directory listing time are printed. Small
+ * reads run on test FS workers while a bulk copy is running: their median and tail latencies are printed with the
+ * copy on the same worker and on another worker. A file is closed on a test FS worker while another one renames or
+ * deletes it: a retried modification must succeed and the old path must not be reopened from a kept file. The times of small appends, random reads and directory operations
+ * are printed with the name of the file system, to compare builds with and without FS_USE_LITTLEFS. A generated
+ * resource image is written to the resource image partition and mapped.
+ */
+TestRef T_CORE_FS_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
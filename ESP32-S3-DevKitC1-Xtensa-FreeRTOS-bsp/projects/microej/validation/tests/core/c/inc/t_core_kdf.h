@@ -0,0 +1,32 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_KDF_H
+#define __T_CORE_KDF_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the key derivation functions used by the secret key factory natives against known answers:
+ * HKDF-Extract and HKDF-Expand with the RFC 5869 test vectors, PBKDF2 HMAC-SHA1 with the RFC 6070 test vectors, in
+ * the calling task and in the security worker. The test fails if a derived key differs from the expected one.
+ * The number of PBKDF2 iterations per second is printed for SHA-1, SHA-256 and SHA-512.
+ */
+TestRef T_CORE_KDF_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
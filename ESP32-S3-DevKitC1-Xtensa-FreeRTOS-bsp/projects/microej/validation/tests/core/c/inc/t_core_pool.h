@@ -0,0 +1,31 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_POOL_H
+#define __T_CORE_POOL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the microej_pool free list: a full pool refuses reservations, an item freed twice or an address
+ * outside of the pool is rejected without corrupting the free list, and pools of items smaller than a pointer still work.
+ * A micro-benchmark prints the time of a reserve/free pair on a pool with most of its items in use.
+ */
+TestRef T_CORE_POOL_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
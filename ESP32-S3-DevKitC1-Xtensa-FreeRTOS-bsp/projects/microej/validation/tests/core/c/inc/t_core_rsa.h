@@ -0,0 +1,31 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_RSA_H
+#define __T_CORE_RSA_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks that a RSA cipher and a signature can share the key context by setting their padding before each
+ * operation. The OAEP decryption and PKCS#1 v1.5 signature throughput is printed with the same key, with the key
+ * context copied for each operation and with the key imported for each operation.
+ */
+TestRef T_CORE_RSA_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+
+/* Prevent recursive inclusion */
+
+#ifndef __T_CORE_X509_H
+#define __T_CORE_X509_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+
+/* Public function declarations */
+/**
+ * @brief Checks the X509 certificate path validation on a generated ECDSA P-256 chain: a good chain, a broken
+ * signature, a pathLenConstraint violation and a CA without keyCertSign. Verified links must be remembered by the link
+ * cache, failed ones must not. The validation time with and without the link cache is printed.
+ */
+TestRef T_CORE_X509_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,320 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+
+#include "microej_allocator.h"
+
+/* Private constant declarations */
+
+#define T_CORE_ALLOCATOR_TASK_COUNT			(2)
+#define T_CORE_ALLOCATOR_TASK_STACK_SIZE	(4096)
+#define T_CORE_ALLOCATOR_TASK_LOOPS			(50000)
+#define T_CORE_ALLOCATOR_TASK_TIMEOUT_MS	(30000)
+/* blocks kept allocated by each task: more than the 256 bytes slab holds for both tasks */
+#define T_CORE_ALLOCATOR_TASK_BLOCKS		(8)
+#define T_CORE_ALLOCATOR_MAX_BLOCK_SIZE		(256)
+#define T_CORE_ALLOCATOR_BENCH_LOOPS		(100000)
+#define T_CORE_ALLOCATOR_BENCH_SIZE			(64)
+
+/* Private structure declarations */
+
+typedef struct {
+	uint8_t* block;
+	size_t size;
+	uint8_t pattern;
+} T_CORE_ALLOCATOR_block_t;
+
+typedef struct {
+	int index;
+	SemaphoreHandle_t start;
+	SemaphoreHandle_t done;
+	uint32_t seed;
+	int allocation_failures;
+	int corruptions;
+	T_CORE_ALLOCATOR_block_t blocks[T_CORE_ALLOCATOR_TASK_BLOCKS];
+} T_CORE_ALLOCATOR_task_t;
+
+/* Private variable definitions */
+
+static T_CORE_ALLOCATOR_task_t T_CORE_ALLOCATOR_tasks[T_CORE_ALLOCATOR_TASK_COUNT];
+
+/* Private function definitions */
+
+/**
+ * @brief Returns the number of blocks in use in the given class, -1 if the slabs are disabled.
+ */
+static int T_CORE_ALLOCATOR_used(int class_index)
+{
+	microej_allocator_slab_statistics_t statistics;
+	if (!microej_allocator_get_slab_statistics(class_index, &statistics)) {
+		return -1;
+	}
+	return (int)statistics.pool.ui_num_item_used;
+}
+
+/**
+ * @brief Frees the given block, returns the index of the class that held it, -1 if it has been allocated from the heap.
+ */
+static int T_CORE_ALLOCATOR_free_from_class(void* block)
+{
+	int used[MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT];
+	int class_index;
+
+	for (class_index = 0; class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT; class_index++) {
+		used[class_index] = T_CORE_ALLOCATOR_used(class_index);
+	}
+	microej_free(block);
+	for (class_index = 0; class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT; class_index++) {
+		if (T_CORE_ALLOCATOR_used(class_index) != used[class_index]) {
+			break;
+		}
+	}
+	return (class_index == MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT) ? -1 : class_index;
+}
+
+static bool T_CORE_ALLOCATOR_check(const T_CORE_ALLOCATOR_block_t* block)
+{
+	for (size_t i = 0; i < block->size; i++) {
+		if (block->block[i] != block->pattern) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Replaces the blocks of the task one after the other with blocks of random sizes. Each block is filled with a
+ * pattern specific to the task and checked before being freed: a block given to both tasks is detected.
+ */
+static void T_CORE_ALLOCATOR_task(void* parameters)
+{
+	T_CORE_ALLOCATOR_task_t* task = (T_CORE_ALLOCATOR_task_t*)parameters;
+
+	/* all the tasks start together to run concurrently */
+	(void)xSemaphoreTake(task->start, portMAX_DELAY);
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_LOOPS; i++) {
+		T_CORE_ALLOCATOR_block_t* block = &task->blocks[i % T_CORE_ALLOCATOR_TASK_BLOCKS];
+		if (block->block != NULL) {
+			if (!T_CORE_ALLOCATOR_check(block)) {
+				task->corruptions++;
+			}
+			microej_free(block->block);
+		}
+
+		task->seed = (task->seed * 1103515245U) + 12345U;
+		block->size = 1U + ((task->seed >> 16) % T_CORE_ALLOCATOR_MAX_BLOCK_SIZE);
+		block->pattern = (uint8_t)((task->index << 7) | (i & 0x7F));
+		if ((i & 1) == 0) {
+			block->block = (uint8_t*)microej_malloc(block->size);
+		} else {
+			block->block = (uint8_t*)microej_calloc(1, block->size);
+			if ((block->block != NULL) && (block->block[block->size - 1U] != 0U)) {
+				task->corruptions++;
+			}
+		}
+		if (block->block == NULL) {
+			task->allocation_failures++;
+		} else {
+			(void)memset(block->block, block->pattern, block->size);
+		}
+	}
+
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_BLOCKS; i++) {
+		T_CORE_ALLOCATOR_block_t* block = &task->blocks[i];
+		if (block->block != NULL) {
+			if (!T_CORE_ALLOCATOR_check(block)) {
+				task->corruptions++;
+			}
+			microej_free(block->block);
+			block->block = NULL;
+		}
+	}
+
+	(void)xSemaphoreGive(task->done);
+	vTaskDelete(NULL);
+}
+
+static void T_CORE_ALLOCATOR_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+}
+
+static void T_CORE_ALLOCATOR_tearDown(void)
+{
+}
+
+static void T_CORE_ALLOCATOR_classes(void)
+{
+	static const size_t sizes[] = { 1, 16, 17, 32, 33, 64, 65, 128, 129, 256 };
+	static const int classes[] = { 0, 0, 1, 1, 2, 2, 3, 3, 4, 4 };
+	microej_allocator_slab_statistics_t statistics;
+
+	TEST_ASSERT_MESSAGE(microej_allocator_get_slab_statistics(0, &statistics), "slabs are disabled");
+	TEST_ASSERT_EQUAL_INT(16, (int)statistics.size);
+	TEST_ASSERT_MESSAGE(!microej_allocator_get_slab_statistics(-1, &statistics), "invalid class index accepted");
+	TEST_ASSERT_MESSAGE(!microej_allocator_get_slab_statistics(MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT, &statistics),
+			"invalid class index accepted");
+
+	for (size_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+		void* block = microej_malloc(sizes[i]);
+		TEST_ASSERT_NOT_NULL(block);
+		TEST_ASSERT_EQUAL_INT(0, (int)((uintptr_t)block % sizeof(uint64_t)));
+		TEST_ASSERT_EQUAL_INT(classes[i], T_CORE_ALLOCATOR_free_from_class(block));
+	}
+
+	/* large blocks are allocated from the heap */
+	void* block = microej_malloc(T_CORE_ALLOCATOR_MAX_BLOCK_SIZE + 1);
+	TEST_ASSERT_NOT_NULL(block);
+	TEST_ASSERT_EQUAL_INT(-1, T_CORE_ALLOCATOR_free_from_class(block));
+
+	/* calloc clears a reused block */
+	uint8_t* bytes = (uint8_t*)microej_malloc(48);
+	TEST_ASSERT_NOT_NULL(bytes);
+	(void)memset(bytes, 0xA5, 48);
+	microej_free(bytes);
+	bytes = (uint8_t*)microej_calloc(6, 8);
+	TEST_ASSERT_NOT_NULL(bytes);
+	for (int i = 0; i < 48; i++) {
+		TEST_ASSERT_EQUAL_INT(0, bytes[i]);
+	}
+	microej_free(bytes);
+}
+
+static void T_CORE_ALLOCATOR_full_slab(void)
+{
+	void* blocks[MICROEJ_ALLOCATOR_SLAB_256_COUNT + 1];
+	microej_allocator_slab_statistics_t before;
+	microej_allocator_slab_statistics_t after;
+	int class_index = MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT - 1;
+
+	TEST_ASSERT_MESSAGE(microej_allocator_get_slab_statistics(class_index, &before), "slabs are disabled");
+	TEST_ASSERT_EQUAL_INT(256, (int)before.size);
+	int available = (int)(before.pool.ui_num_item_in_pool - before.pool.ui_num_item_used);
+
+	/* one more block than the slab can hold */
+	for (int i = 0; i <= available; i++) {
+		blocks[i] = microej_malloc(200);
+		TEST_ASSERT_NOT_NULL(blocks[i]);
+	}
+	TEST_ASSERT_MESSAGE(microej_allocator_get_slab_statistics(class_index, &after), "slabs are disabled");
+	TEST_ASSERT_EQUAL_INT((int)before.pool.ui_num_item_in_pool, (int)after.pool.ui_num_item_used);
+	TEST_ASSERT_EQUAL_INT((int)before.heap_allocation_count + 1, (int)after.heap_allocation_count);
+	TEST_ASSERT_EQUAL_INT((int)before.pool.ui_num_reserve_failed + 1, (int)after.pool.ui_num_reserve_failed);
+
+	for (int i = 0; i <= available; i++) {
+		microej_free(blocks[i]);
+	}
+	TEST_ASSERT_EQUAL_INT((int)before.pool.ui_num_item_used, T_CORE_ALLOCATOR_used(class_index));
+}
+
+static void T_CORE_ALLOCATOR_both_cores(void)
+{
+	int used[MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT];
+	SemaphoreHandle_t start = xSemaphoreCreateCounting(T_CORE_ALLOCATOR_TASK_COUNT, 0);
+	SemaphoreHandle_t done = xSemaphoreCreateCounting(T_CORE_ALLOCATOR_TASK_COUNT, 0);
+	TEST_ASSERT_NOT_NULL(start);
+	TEST_ASSERT_NOT_NULL(done);
+
+	for (int class_index = 0; class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT; class_index++) {
+		used[class_index] = T_CORE_ALLOCATOR_used(class_index);
+	}
+
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_COUNT; i++) {
+		T_CORE_ALLOCATOR_task_t* task = &T_CORE_ALLOCATOR_tasks[i];
+		(void)memset(task, 0, sizeof(T_CORE_ALLOCATOR_task_t));
+		task->index = i;
+		task->start = start;
+		task->done = done;
+		task->seed = (uint32_t)(i + 1);
+		TEST_ASSERT_MESSAGE(pdPASS == xTaskCreatePinnedToCore(T_CORE_ALLOCATOR_task, "alloc_test",
+				T_CORE_ALLOCATOR_TASK_STACK_SIZE, task, uxTaskPriorityGet(NULL), NULL, i % portNUM_PROCESSORS),
+				"task creation failed");
+	}
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_COUNT; i++) {
+		(void)xSemaphoreGive(start);
+	}
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_COUNT; i++) {
+		TEST_ASSERT_MESSAGE(pdTRUE == xSemaphoreTake(done, pdMS_TO_TICKS(T_CORE_ALLOCATOR_TASK_TIMEOUT_MS)),
+				"allocation task timeout");
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+	vSemaphoreDelete(start);
+	vSemaphoreDelete(done);
+
+	for (int i = 0; i < T_CORE_ALLOCATOR_TASK_COUNT; i++) {
+		TEST_ASSERT_EQUAL_INT(0, T_CORE_ALLOCATOR_tasks[i].allocation_failures);
+		TEST_ASSERT_EQUAL_INT(0, T_CORE_ALLOCATOR_tasks[i].corruptions);
+	}
+	for (int class_index = 0; class_index < MICROEJ_ALLOCATOR_SLAB_CLASS_COUNT; class_index++) {
+		TEST_ASSERT_EQUAL_INT(used[class_index], T_CORE_ALLOCATOR_used(class_index));
+	}
+
+	UTIL_print_string("Allocator malloc/free pair, ");
+	UTIL_print_integer(T_CORE_ALLOCATOR_TASK_COUNT);
+	UTIL_print_string(" tasks on ");
+	UTIL_print_integer(portNUM_PROCESSORS);
+	UTIL_print_string(" cores: ");
+	UTIL_print_float(((double)elapsed_time * 1000.0) / (T_CORE_ALLOCATOR_TASK_COUNT * T_CORE_ALLOCATOR_TASK_LOOPS));
+	UTIL_print_string(" ns\n");
+}
+
+static void T_CORE_ALLOCATOR_benchmark(void)
+{
+	void* block = NULL;
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int i = 0; i < T_CORE_ALLOCATOR_BENCH_LOOPS; i++) {
+		block = microej_malloc(T_CORE_ALLOCATOR_BENCH_SIZE);
+		microej_free(block);
+	}
+	int64_t slab_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_NOT_NULL(block);
+
+	/* same allocation policy as microej_malloc() without slabs */
+	start_time = UTIL_TIME_BASE_getTime();
+	for (int i = 0; i < T_CORE_ALLOCATOR_BENCH_LOOPS; i++) {
+		block = heap_caps_malloc_prefer(T_CORE_ALLOCATOR_BENCH_SIZE, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM,
+				MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL);
+		heap_caps_free(block);
+	}
+	int64_t heap_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_NOT_NULL(block);
+
+	UTIL_print_string("Allocator malloc/free pair (");
+	UTIL_print_integer(T_CORE_ALLOCATOR_BENCH_SIZE);
+	UTIL_print_string(" bytes): slab ");
+	UTIL_print_float(((double)slab_time * 1000.0) / T_CORE_ALLOCATOR_BENCH_LOOPS);
+	UTIL_print_string(" ns, heap ");
+	UTIL_print_float(((double)heap_time * 1000.0) / T_CORE_ALLOCATOR_BENCH_LOOPS);
+	UTIL_print_string(" ns\n");
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_ALLOCATOR_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Size classes", T_CORE_ALLOCATOR_classes),
+		new_TestFixture("Full slab falls back to the heap", T_CORE_ALLOCATOR_full_slab),
+		new_TestFixture("Malloc/free on both cores", T_CORE_ALLOCATOR_both_cores),
+		new_TestFixture("Slab and heap benchmark", T_CORE_ALLOCATOR_benchmark),
+	};
+	UTIL_print_string("\nAllocator tests:\n");
+	EMB_UNIT_TESTCALLER(allocatorTest, "ALLOCATOR_tests", T_CORE_ALLOCATOR_setUp, T_CORE_ALLOCATOR_tearDown, fixtures);
+
+	return (TestRef)&allocatorTest;
+}
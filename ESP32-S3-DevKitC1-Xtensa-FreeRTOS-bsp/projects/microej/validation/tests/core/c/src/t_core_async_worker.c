@@ -0,0 +1,590 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sni.h"
+#include "microej_async_worker.h"
+
+/* Private constant declarations */
+
+#define T_CORE_ASYNC_WORKER_JOB_COUNT		(8)
+#define T_CORE_ASYNC_WORKER_TASK_COUNT		(2)
+#define T_CORE_ASYNC_WORKER_STACK_SIZE		(2048)
+#define T_CORE_ASYNC_WORKER_LOOPS			(20000)
+#define T_CORE_ASYNC_WORKER_TIMEOUT_US		(10000000)
+#define T_CORE_ASYNC_WORKER_BULK_DEPTH		(4)
+#define T_CORE_ASYNC_WORKER_BULK_TICKS		(2)
+#define T_CORE_ASYNC_WORKER_SHORT_COUNT		(200)
+#define T_CORE_ASYNC_WORKER_JAVA_THREAD_ID	(1)
+#define T_CORE_ASYNC_WORKER_JOB_TIMEOUT_MS	(20)
+
+/* Private structure declarations */
+
+typedef struct {
+	volatile bool in_use;
+	volatile int32_t sequence; // Execution order of the job in its batch.
+} T_CORE_ASYNC_WORKER_param_t;
+
+/* Private variable definitions */
+
+MICROEJ_ASYNC_WORKER_worker_declare(T_CORE_ASYNC_WORKER_worker, T_CORE_ASYNC_WORKER_JOB_COUNT, T_CORE_ASYNC_WORKER_param_t, 1);
+static OSAL_task_stack_t T_CORE_ASYNC_WORKER_stacks[T_CORE_ASYNC_WORKER_TASK_COUNT] = {
+	T_CORE_ASYNC_WORKER_STACK_SIZE,
+	T_CORE_ASYNC_WORKER_STACK_SIZE,
+};
+static bool T_CORE_ASYNC_WORKER_initialized = false;
+
+// Worker with a single task, as the workers created with MICROEJ_ASYNC_WORKER_initialize().
+MICROEJ_ASYNC_WORKER_worker_declare(T_CORE_ASYNC_WORKER_single_worker, T_CORE_ASYNC_WORKER_JOB_COUNT, T_CORE_ASYNC_WORKER_param_t, 1);
+static OSAL_task_stack_t T_CORE_ASYNC_WORKER_single_stacks[1] = {
+	T_CORE_ASYNC_WORKER_STACK_SIZE,
+};
+static bool T_CORE_ASYNC_WORKER_single_initialized = false;
+
+// Number of jobs found in an unexpected state.
+static volatile uint32_t T_CORE_ASYNC_WORKER_corruptions = 0;
+// Number of calls to the SNI functions below.
+static volatile uint32_t T_CORE_ASYNC_WORKER_sni_calls = 0;
+// Number of bulk jobs done, incremented by the worker tasks.
+static volatile uint32_t T_CORE_ASYNC_WORKER_bulk_done_count = 0;
+// Set when the last short job is done.
+static volatile bool T_CORE_ASYNC_WORKER_short_done = false;
+// Latencies of the short jobs in microseconds.
+static int64_t T_CORE_ASYNC_WORKER_latencies[T_CORE_ASYNC_WORKER_SHORT_COUNT];
+// Id of the Java thread simulated by the test task, SNI_ERROR when the test task does not act as a Java thread.
+static int32_t T_CORE_ASYNC_WORKER_java_thread_id = SNI_ERROR;
+// Suspend argument of the simulated Java thread, returned by SNI_getCallbackArgs().
+static void* T_CORE_ASYNC_WORKER_callback_arg = NULL;
+// Number of suspends of the simulated Java thread.
+static volatile uint32_t T_CORE_ASYNC_WORKER_suspend_count = 0;
+// Number of resumes of the simulated Java thread, incremented by the worker tasks.
+static volatile uint32_t T_CORE_ASYNC_WORKER_resume_count = 0;
+// Next execution order in the running batch, incremented by the worker task that runs it.
+static volatile int32_t T_CORE_ASYNC_WORKER_batch_sequence = 0;
+// Number of exceptions thrown to the simulated Java thread.
+static volatile uint32_t T_CORE_ASYNC_WORKER_exception_count = 0;
+// Blocks the stuck jobs while set, as a file system or a driver that does not return.
+static volatile bool T_CORE_ASYNC_WORKER_stuck = false;
+// Set when a stuck job has started.
+static volatile bool T_CORE_ASYNC_WORKER_stuck_started = false;
+
+/*
+ * The validation build does not link the VM. The worker only calls these SNI functions for a job that a Java thread
+ * waits for, or when no job is free. Unless the test task simulates a Java thread waiting for its jobs, each call is
+ * counted as a failure.
+ */
+int32_t SNI_throwNativeIOException(int32_t errorCode, const char* message)
+{
+	(void)errorCode;
+	(void)message;
+	if (T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+		return SNI_ERROR;
+	}
+	T_CORE_ASYNC_WORKER_exception_count++;
+	return SNI_OK;
+}
+
+int32_t SNI_getCurrentJavaThreadID(void)
+{
+	if (T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+	}
+	return T_CORE_ASYNC_WORKER_java_thread_id;
+}
+
+int32_t SNI_suspendCurrentJavaThreadWithCallback(int64_t timeout, SNI_callback sniCallback, void* callbackSuspendArg)
+{
+	(void)timeout;
+	(void)sniCallback;
+	if (T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+		return SNI_ERROR;
+	}
+	T_CORE_ASYNC_WORKER_callback_arg = callbackSuspendArg;
+	T_CORE_ASYNC_WORKER_suspend_count++;
+	return SNI_OK;
+}
+
+int32_t SNI_getCallbackArgs(void** callbackSuspendArgPtr, void** callbackResumeArgPtr)
+{
+	(void)callbackResumeArgPtr;
+	if (T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+		return SNI_ERROR;
+	}
+	*callbackSuspendArgPtr = T_CORE_ASYNC_WORKER_callback_arg;
+	return SNI_OK;
+}
+
+int32_t SNI_resumeJavaThread(int32_t javaThreadID)
+{
+	if ((T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) || (javaThreadID != T_CORE_ASYNC_WORKER_java_thread_id)) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+		return SNI_ERROR;
+	}
+	T_CORE_ASYNC_WORKER_resume_count++;
+	return SNI_OK;
+}
+
+bool SNI_clearCurrentJavaThreadPendingResumeFlag(void)
+{
+	if (T_CORE_ASYNC_WORKER_java_thread_id == SNI_ERROR) {
+		T_CORE_ASYNC_WORKER_sni_calls++;
+	}
+	return false;
+}
+
+/* Private function definitions */
+
+/**
+ * @brief Action executed by the worker tasks: releases the job, which is then pushed back on the free list.
+ */
+static void T_CORE_ASYNC_WORKER_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	T_CORE_ASYNC_WORKER_param_t* params = (T_CORE_ASYNC_WORKER_param_t*)job->params;
+	if (!params->in_use) {
+		T_CORE_ASYNC_WORKER_corruptions++;
+	}
+	params->in_use = false;
+}
+
+/**
+ * @brief Returns the number of jobs in the free list.
+ */
+static int T_CORE_ASYNC_WORKER_free_job_count(void)
+{
+	int count = 0;
+	for (MICROEJ_ASYNC_WORKER_job_t* job = T_CORE_ASYNC_WORKER_worker.free_jobs; (job != NULL) && (count <= T_CORE_ASYNC_WORKER_JOB_COUNT);
+			job = job->_intern.next_free_job) {
+		count++;
+	}
+	return count;
+}
+
+static uint32_t T_CORE_ASYNC_WORKER_executed_job_count(void)
+{
+	MICROEJ_ASYNC_WORKER_statistics_t statistics;
+	MICROEJ_ASYNC_WORKER_get_statistics(&T_CORE_ASYNC_WORKER_worker, &statistics, false);
+	return statistics.executed_job_count;
+}
+
+/**
+ * @brief Starts the worker of the tests on first use, with T_CORE_ASYNC_WORKER_TASK_COUNT tasks running with a higher
+ * priority than the test task on any core.
+ *
+ * @return true if the worker is running.
+ */
+static bool T_CORE_ASYNC_WORKER_start(void)
+{
+	if (!T_CORE_ASYNC_WORKER_initialized) {
+		T_CORE_ASYNC_WORKER_initialized = (MICROEJ_ASYNC_WORKER_initialize_tasks(&T_CORE_ASYNC_WORKER_worker, (uint8_t*)"test_worker",
+				T_CORE_ASYNC_WORKER_stacks, T_CORE_ASYNC_WORKER_TASK_COUNT, (int32_t)uxTaskPriorityGet(NULL) + 1, OSAL_NO_AFFINITY)
+				== MICROEJ_ASYNC_WORKER_OK);
+	}
+	return T_CORE_ASYNC_WORKER_initialized;
+}
+
+/**
+ * @brief Action of the bulk jobs: blocks the worker task as a long file or network transfer does.
+ */
+static void T_CORE_ASYNC_WORKER_bulk_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	(void)job;
+	vTaskDelay(T_CORE_ASYNC_WORKER_BULK_TICKS);
+	uint32_t count;
+	do {
+		count = T_CORE_ASYNC_WORKER_bulk_done_count;
+	} while (!OSAL_compare_and_set(&T_CORE_ASYNC_WORKER_bulk_done_count, count, count + 1U));
+}
+
+/**
+ * @brief Action of the short jobs, as a stat or a close.
+ */
+static void T_CORE_ASYNC_WORKER_short_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	(void)job;
+	T_CORE_ASYNC_WORKER_short_done = true;
+}
+
+/**
+ * @brief Posts bulk jobs while less than T_CORE_ASYNC_WORKER_BULK_DEPTH of them are queued or running and a job is
+ * free.
+ *
+ * @return the number of bulk jobs posted since the beginning of the load.
+ */
+static uint32_t T_CORE_ASYNC_WORKER_post_bulk_jobs(MICROEJ_ASYNC_WORKER_handle_t* async_worker, uint32_t posted_count)
+{
+	while (((posted_count - T_CORE_ASYNC_WORKER_bulk_done_count) < T_CORE_ASYNC_WORKER_BULK_DEPTH) && (async_worker->free_jobs != NULL)) {
+		MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(async_worker, NULL);
+		if ((job == NULL) || (MICROEJ_ASYNC_WORKER_async_exec_no_wait(async_worker, job, T_CORE_ASYNC_WORKER_bulk_action) != MICROEJ_ASYNC_WORKER_OK)) {
+			break;
+		}
+		posted_count++;
+	}
+	return posted_count;
+}
+
+/**
+ * @brief Action of the batch jobs: records the execution order and checks that the Java thread is not resumed before
+ * the end of the batch.
+ */
+static void T_CORE_ASYNC_WORKER_batch_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	T_CORE_ASYNC_WORKER_param_t* params = (T_CORE_ASYNC_WORKER_param_t*)job->params;
+	if (!params->in_use || (T_CORE_ASYNC_WORKER_resume_count != 0U)) {
+		T_CORE_ASYNC_WORKER_corruptions++;
+	}
+	params->sequence = T_CORE_ASYNC_WORKER_batch_sequence;
+	T_CORE_ASYNC_WORKER_batch_sequence++;
+	params->in_use = false;
+}
+
+/**
+ * @brief Action of the stuck jobs: blocks the worker task until T_CORE_ASYNC_WORKER_stuck is cleared.
+ */
+static void T_CORE_ASYNC_WORKER_stuck_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	(void)job;
+	T_CORE_ASYNC_WORKER_stuck_started = true;
+	while (T_CORE_ASYNC_WORKER_stuck) {
+		vTaskDelay(1);
+	}
+}
+
+/**
+ * @brief Simulates a Java thread that waits for a stuck job, then unblocks the job once the thread has resumed with an
+ * error. Checks that the job is released by the worker and that the next allocation reuses its slot.
+ *
+ * @param[in] timeout_ms the timeout of the job, 0 to cancel the job with the NativeAsyncWorker native instead.
+ */
+static void T_CORE_ASYNC_WORKER_abandon_stuck_job(int64_t timeout_ms)
+{
+	int expected_timeout_count = (timeout_ms != 0) ? 1 : 0;
+	int expected_cancel_count = 1 - expected_timeout_count;
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_start(), "worker start failed");
+	while (T_CORE_ASYNC_WORKER_free_job_count() != T_CORE_ASYNC_WORKER_JOB_COUNT) {
+		vTaskDelay(1);
+	}
+	MICROEJ_ASYNC_WORKER_statistics_t statistics;
+	MICROEJ_ASYNC_WORKER_get_statistics(&T_CORE_ASYNC_WORKER_worker, &statistics, true);
+	T_CORE_ASYNC_WORKER_sni_calls = 0;
+	T_CORE_ASYNC_WORKER_exception_count = 0;
+	T_CORE_ASYNC_WORKER_suspend_count = 0;
+	T_CORE_ASYNC_WORKER_resume_count = 0;
+	T_CORE_ASYNC_WORKER_java_thread_id = T_CORE_ASYNC_WORKER_JAVA_THREAD_ID;
+	T_CORE_ASYNC_WORKER_stuck = true;
+	T_CORE_ASYNC_WORKER_stuck_started = false;
+
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&T_CORE_ASYNC_WORKER_worker, NULL);
+	TEST_ASSERT_NOT_NULL(job);
+	TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_set_job_timeout(job, timeout_ms));
+	TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_async_exec(&T_CORE_ASYNC_WORKER_worker, job,
+			T_CORE_ASYNC_WORKER_stuck_action, NULL));
+	TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_suspend_count);
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (!T_CORE_ASYNC_WORKER_stuck_started) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+			TEST_FAIL("job not started");
+		}
+	}
+
+	if (timeout_ms != 0) {
+		// As the VM once the suspend timeout has expired: the thread resumes and runs the on_done_callback
+		vTaskDelay(pdMS_TO_TICKS(timeout_ms) + 1);
+	} else {
+		TEST_ASSERT_EQUAL_INT(1, MICROEJ_ASYNC_WORKER_IMPL_cancel(T_CORE_ASYNC_WORKER_worker.id, MICROEJ_ASYNC_WORKER_IMPL_get_current_thread_id()));
+		TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_resume_count);
+		TEST_ASSERT_EQUAL_INT(0, MICROEJ_ASYNC_WORKER_IMPL_cancel(T_CORE_ASYNC_WORKER_worker.id, T_CORE_ASYNC_WORKER_JAVA_THREAD_ID));
+	}
+	TEST_ASSERT_NULL(MICROEJ_ASYNC_WORKER_get_job_done());
+	TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_exception_count);
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_JOB_COUNT - 1, T_CORE_ASYNC_WORKER_free_job_count());
+
+	// The action returns: the worker releases the job without resuming the thread again
+	T_CORE_ASYNC_WORKER_stuck = false;
+	start_time = UTIL_TIME_BASE_getTime();
+	while (T_CORE_ASYNC_WORKER_free_job_count() != T_CORE_ASYNC_WORKER_JOB_COUNT) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+			TEST_FAIL("job not released");
+		}
+	}
+	TEST_ASSERT_EQUAL_INT(expected_cancel_count, (int)T_CORE_ASYNC_WORKER_resume_count);
+
+	// The slot is reused by the next job, which completes normally
+	MICROEJ_ASYNC_WORKER_job_t* next_job = MICROEJ_ASYNC_WORKER_allocate_job(&T_CORE_ASYNC_WORKER_worker, NULL);
+	TEST_ASSERT(next_job == job);
+	T_CORE_ASYNC_WORKER_resume_count = 0;
+	TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_async_exec(&T_CORE_ASYNC_WORKER_worker, next_job,
+			T_CORE_ASYNC_WORKER_short_action, NULL));
+	start_time = UTIL_TIME_BASE_getTime();
+	while (T_CORE_ASYNC_WORKER_resume_count == 0U) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+			TEST_FAIL("next job not done");
+		}
+	}
+	TEST_ASSERT(MICROEJ_ASYNC_WORKER_get_job_done() == next_job);
+	TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_free_job(&T_CORE_ASYNC_WORKER_worker, next_job));
+	T_CORE_ASYNC_WORKER_java_thread_id = SNI_ERROR;
+
+	MICROEJ_ASYNC_WORKER_get_statistics(&T_CORE_ASYNC_WORKER_worker, &statistics, false);
+	TEST_ASSERT_EQUAL_INT(expected_timeout_count, (int)statistics.timeout_count);
+	TEST_ASSERT_EQUAL_INT(expected_cancel_count, (int)statistics.cancel_count);
+	TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_exception_count);
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_JOB_COUNT, T_CORE_ASYNC_WORKER_free_job_count());
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_sni_calls);
+}
+
+static int T_CORE_ASYNC_WORKER_compare_latencies(const void* latency1, const void* latency2)
+{
+	int64_t difference = *(const int64_t*)latency1 - *(const int64_t*)latency2;
+	return (difference > 0) - (difference < 0);
+}
+
+/**
+ * @brief Executes T_CORE_ASYNC_WORKER_SHORT_COUNT short jobs in the given lane, one after the other as a single Java
+ * thread, while bulk jobs keep the worker busy. Prints the latency of the short jobs from their post to their end.
+ *
+ * @return true if all the jobs have been executed.
+ */
+static bool T_CORE_ASYNC_WORKER_mixed_load(MICROEJ_ASYNC_WORKER_handle_t* async_worker, MICROEJ_ASYNC_WORKER_lane_t lane, const char* label)
+{
+	uint32_t posted_count = 0;
+	bool valid = true;
+	T_CORE_ASYNC_WORKER_bulk_done_count = 0;
+
+	for (int i = 0; valid && (i < T_CORE_ASYNC_WORKER_SHORT_COUNT); i++) {
+		posted_count = T_CORE_ASYNC_WORKER_post_bulk_jobs(async_worker, posted_count);
+		MICROEJ_ASYNC_WORKER_job_t* job = (async_worker->free_jobs != NULL) ? MICROEJ_ASYNC_WORKER_allocate_job(async_worker, NULL) : NULL;
+		if (job == NULL) {
+			valid = false;
+			break;
+		}
+		MICROEJ_ASYNC_WORKER_set_job_lane(job, lane);
+		T_CORE_ASYNC_WORKER_short_done = false;
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		valid = (MICROEJ_ASYNC_WORKER_async_exec_no_wait(async_worker, job, T_CORE_ASYNC_WORKER_short_action) == MICROEJ_ASYNC_WORKER_OK);
+		while (valid && !T_CORE_ASYNC_WORKER_short_done) {
+			posted_count = T_CORE_ASYNC_WORKER_post_bulk_jobs(async_worker, posted_count);
+			valid = ((UTIL_TIME_BASE_getTime() - start_time) <= T_CORE_ASYNC_WORKER_TIMEOUT_US);
+		}
+		T_CORE_ASYNC_WORKER_latencies[i] = UTIL_TIME_BASE_getTime() - start_time;
+	}
+
+	// Wait for the last bulk jobs
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (T_CORE_ASYNC_WORKER_bulk_done_count != posted_count) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+			valid = false;
+			break;
+		}
+	}
+
+	if (valid) {
+		qsort(T_CORE_ASYNC_WORKER_latencies, T_CORE_ASYNC_WORKER_SHORT_COUNT, sizeof(int64_t), T_CORE_ASYNC_WORKER_compare_latencies);
+		UTIL_print_string("Short jobs, ");
+		UTIL_print_string(label);
+		UTIL_print_string(": median ");
+		UTIL_print_integer((int32_t)T_CORE_ASYNC_WORKER_latencies[T_CORE_ASYNC_WORKER_SHORT_COUNT / 2]);
+		UTIL_print_string(" us, 99th percentile ");
+		UTIL_print_integer((int32_t)T_CORE_ASYNC_WORKER_latencies[(T_CORE_ASYNC_WORKER_SHORT_COUNT * 99) / 100]);
+		UTIL_print_string(" us, max ");
+		UTIL_print_integer((int32_t)T_CORE_ASYNC_WORKER_latencies[T_CORE_ASYNC_WORKER_SHORT_COUNT - 1]);
+		UTIL_print_string(" us, ");
+		UTIL_print_integer((int32_t)posted_count);
+		UTIL_print_string(" bulk jobs\n");
+	}
+	return valid;
+}
+
+static void T_CORE_ASYNC_WORKER_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+	T_CORE_ASYNC_WORKER_java_thread_id = SNI_ERROR;
+}
+
+static void T_CORE_ASYNC_WORKER_tearDown(void)
+{
+}
+
+/*
+ * The test task is the only one that allocates jobs, as the VM task. The worker tasks run on both cores with a higher
+ * priority and free the jobs concurrently: the pushes on the free list race with each other and with the pops.
+ */
+static void T_CORE_ASYNC_WORKER_free_list_stress(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_start(), "worker start failed");
+	T_CORE_ASYNC_WORKER_corruptions = 0;
+	T_CORE_ASYNC_WORKER_sni_calls = 0;
+	uint32_t executed_job_count = T_CORE_ASYNC_WORKER_executed_job_count();
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int i = 0; i < T_CORE_ASYNC_WORKER_LOOPS; i++) {
+		// Only allocate a free job: the worker would suspend the current Java thread otherwise.
+		while (T_CORE_ASYNC_WORKER_worker.free_jobs == NULL) {
+			if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+				TEST_FAIL("no free job");
+			}
+		}
+		MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&T_CORE_ASYNC_WORKER_worker, NULL);
+		TEST_ASSERT_NOT_NULL(job);
+
+		T_CORE_ASYNC_WORKER_param_t* params = (T_CORE_ASYNC_WORKER_param_t*)job->params;
+		if (params->in_use) {
+			T_CORE_ASYNC_WORKER_corruptions++;
+		}
+		params->in_use = true;
+		TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_async_exec_no_wait(&T_CORE_ASYNC_WORKER_worker,
+				job, T_CORE_ASYNC_WORKER_action));
+	}
+
+	// Wait for the last jobs
+	while (T_CORE_ASYNC_WORKER_free_job_count() != T_CORE_ASYNC_WORKER_JOB_COUNT) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+			TEST_FAIL("jobs lost");
+		}
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_LOOPS, (int)(T_CORE_ASYNC_WORKER_executed_job_count() - executed_job_count));
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_corruptions);
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_sni_calls);
+
+	UTIL_print_string("Async worker allocate/exec/free round trip (");
+	UTIL_print_integer(T_CORE_ASYNC_WORKER_TASK_COUNT);
+	UTIL_print_string(" tasks): ");
+	UTIL_print_float((double)elapsed_time / T_CORE_ASYNC_WORKER_LOOPS);
+	UTIL_print_string(" us\n");
+}
+
+/*
+ * Short jobs are executed while bulk jobs keep the worker tasks blocked, as metadata operations during file or network
+ * transfers: in the normal lane behind the queued bulk jobs, then in the high lane, with one worker task and with
+ * T_CORE_ASYNC_WORKER_TASK_COUNT tasks.
+ */
+static void T_CORE_ASYNC_WORKER_mixed_load_benchmark(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_start(), "worker start failed");
+	if (!T_CORE_ASYNC_WORKER_single_initialized) {
+		TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_initialize_tasks(&T_CORE_ASYNC_WORKER_single_worker,
+				(uint8_t*)"test_single_worker", T_CORE_ASYNC_WORKER_single_stacks, 1, (int32_t)uxTaskPriorityGet(NULL) + 1,
+				OSAL_NO_AFFINITY));
+		T_CORE_ASYNC_WORKER_single_initialized = true;
+	}
+	T_CORE_ASYNC_WORKER_sni_calls = 0;
+
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_mixed_load(&T_CORE_ASYNC_WORKER_single_worker, MICROEJ_ASYNC_WORKER_LANE_NORMAL,
+			"1 task, normal lane"), "mixed load failed");
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_mixed_load(&T_CORE_ASYNC_WORKER_single_worker, MICROEJ_ASYNC_WORKER_LANE_HIGH,
+			"1 task, high lane"), "mixed load failed");
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_mixed_load(&T_CORE_ASYNC_WORKER_worker, MICROEJ_ASYNC_WORKER_LANE_NORMAL,
+			"2 tasks, normal lane"), "mixed load failed");
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_mixed_load(&T_CORE_ASYNC_WORKER_worker, MICROEJ_ASYNC_WORKER_LANE_HIGH,
+			"2 tasks, high lane"), "mixed load failed");
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_sni_calls);
+}
+
+/*
+ * The test task acts as a Java thread that executes batches of 1 to T_CORE_ASYNC_WORKER_JOB_COUNT jobs: each batch
+ * suspends the thread once and resumes it once, after its last job, and its jobs are executed in order.
+ */
+static void T_CORE_ASYNC_WORKER_batch_resume(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_ASYNC_WORKER_start(), "worker start failed");
+	MICROEJ_ASYNC_WORKER_statistics_t statistics;
+	MICROEJ_ASYNC_WORKER_get_statistics(&T_CORE_ASYNC_WORKER_worker, &statistics, true);
+	T_CORE_ASYNC_WORKER_corruptions = 0;
+	T_CORE_ASYNC_WORKER_sni_calls = 0;
+	T_CORE_ASYNC_WORKER_java_thread_id = T_CORE_ASYNC_WORKER_JAVA_THREAD_ID;
+
+	MICROEJ_ASYNC_WORKER_job_t* jobs[T_CORE_ASYNC_WORKER_JOB_COUNT];
+	for (int count = 1; count <= T_CORE_ASYNC_WORKER_JOB_COUNT; count++) {
+		for (int i = 0; i < count; i++) {
+			jobs[i] = MICROEJ_ASYNC_WORKER_allocate_job(&T_CORE_ASYNC_WORKER_worker, NULL);
+			TEST_ASSERT_NOT_NULL(jobs[i]);
+			T_CORE_ASYNC_WORKER_param_t* params = (T_CORE_ASYNC_WORKER_param_t*)jobs[i]->params;
+			params->in_use = true;
+			params->sequence = -1;
+		}
+		T_CORE_ASYNC_WORKER_batch_sequence = 0;
+		T_CORE_ASYNC_WORKER_suspend_count = 0;
+		T_CORE_ASYNC_WORKER_resume_count = 0;
+
+		TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_async_exec_batch(&T_CORE_ASYNC_WORKER_worker,
+				jobs, count, T_CORE_ASYNC_WORKER_batch_action, NULL));
+		TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_suspend_count);
+
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		while (T_CORE_ASYNC_WORKER_resume_count == 0U) {
+			if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_ASYNC_WORKER_TIMEOUT_US) {
+				TEST_FAIL("batch not done");
+			}
+		}
+
+		// As the on_done_callback of the batch
+		MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_get_job_done();
+		for (int i = 0; i < count; i++) {
+			TEST_ASSERT(job == jobs[i]);
+			TEST_ASSERT_EQUAL_INT(i, (int)((T_CORE_ASYNC_WORKER_param_t*)job->params)->sequence);
+			job = MICROEJ_ASYNC_WORKER_get_next_batch_job(job);
+		}
+		TEST_ASSERT_NULL(job);
+		TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_free_batch(&T_CORE_ASYNC_WORKER_worker, jobs[0]));
+		TEST_ASSERT_EQUAL_INT(1, (int)T_CORE_ASYNC_WORKER_resume_count);
+	}
+	T_CORE_ASYNC_WORKER_java_thread_id = SNI_ERROR;
+
+	MICROEJ_ASYNC_WORKER_get_statistics(&T_CORE_ASYNC_WORKER_worker, &statistics, false);
+	TEST_ASSERT_EQUAL_INT((T_CORE_ASYNC_WORKER_JOB_COUNT * (T_CORE_ASYNC_WORKER_JOB_COUNT + 1)) / 2, (int)statistics.executed_job_count);
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_JOB_COUNT, (int)statistics.batch_count);
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_JOB_COUNT, (int)statistics.resume_count);
+	TEST_ASSERT_EQUAL_INT(T_CORE_ASYNC_WORKER_JOB_COUNT, T_CORE_ASYNC_WORKER_free_job_count());
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_corruptions);
+	TEST_ASSERT_EQUAL_INT(0, (int)T_CORE_ASYNC_WORKER_sni_calls);
+}
+
+/*
+ * A Java thread waits for a job that does not return: its timeout expires, the thread resumes with an exception and
+ * the job slot is reused once the action returns.
+ */
+static void T_CORE_ASYNC_WORKER_timeout(void)
+{
+	T_CORE_ASYNC_WORKER_abandon_stuck_job(T_CORE_ASYNC_WORKER_JOB_TIMEOUT_MS);
+}
+
+/*
+ * Another Java thread cancels the job that does not return with NativeAsyncWorker.nativeCancel(): the waiting thread
+ * resumes with an exception and the job slot is reused once the action returns.
+ */
+static void T_CORE_ASYNC_WORKER_cancel(void)
+{
+	T_CORE_ASYNC_WORKER_abandon_stuck_job(0);
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_ASYNC_WORKER_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Lock-free free job list stress", T_CORE_ASYNC_WORKER_free_list_stress),
+		new_TestFixture("Short job latency under a bulk load", T_CORE_ASYNC_WORKER_mixed_load_benchmark),
+		new_TestFixture("One resume per batch", T_CORE_ASYNC_WORKER_batch_resume),
+		new_TestFixture("Expired job timeout", T_CORE_ASYNC_WORKER_timeout),
+		new_TestFixture("Cancelled job", T_CORE_ASYNC_WORKER_cancel),
+	};
+	UTIL_print_string("\nAsync worker tests:\n");
+	EMB_UNIT_TESTCALLER(asyncWorkerTest, "ASYNC_WORKER_tests", T_CORE_ASYNC_WORKER_setUp, T_CORE_ASYNC_WORKER_tearDown, fixtures);
+
+	return (TestRef)&asyncWorkerTest;
+}
@@ -0,0 +1,488 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "LLSEC_ed25519.h"
+
+#include "mbedtls/version.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/md.h"
+
+/* Private constant declarations */
+
+#define T_CORE_ECC_MAX_MESSAGE_SIZE	(128)
+
+/* Number of operations timed by the benchmarks */
+#define T_CORE_ECC_BENCHMARK_ITERATIONS	(4)
+
+/* Number of signatures timed by the throughput benchmark */
+#define T_CORE_ECC_THROUGHPUT_SIGNATURES	(8)
+
+/* Private structure declarations */
+
+typedef struct {
+	const char* private_key;
+	const char* public_key;
+	const char* message;
+	const char* signature;
+	uint8_t prehashed;
+} T_CORE_ECC_ed25519_vector_t;
+
+/* Private variable definitions */
+
+/* RFC 8032, section 7.1: tests 1, 2 and 3 (Ed25519), section 7.3: test abc (Ed25519ph) */
+static const T_CORE_ECC_ed25519_vector_t T_CORE_ECC_ed25519_vectors[] = {
+	{
+		"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+		"d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+		"",
+		"e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b",
+		0
+	},
+	{
+		"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+		"3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+		"72",
+		"92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00",
+		0
+	},
+	{
+		"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+		"fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+		"af82",
+		"6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a",
+		0
+	},
+	{
+		"833fe62409237b9d62ec77587520911e9a759cec1d19755b7da901b96dca3d42",
+		"ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+		"616263",
+		"98a70222f0b8121aa9d30f813d683f809e462b469c7ff87639499bb94e6dae4131f85042463c2a355a2003d062adf5aaa10b8c61e636062aaad11c2a26083406",
+		1
+	},
+};
+
+/* Order of the Ed25519 base point, little-endian */
+static const uint8_t T_CORE_ECC_ed25519_order[LLSEC_ED25519_KEY_SIZE] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+static const char T_CORE_ECC_benchmark_message[] = "Signature benchmark message";
+
+static mbedtls_entropy_context T_CORE_ECC_entropy;
+static mbedtls_ctr_drbg_context T_CORE_ECC_ctr_drbg;
+static int T_CORE_ECC_ctr_drbg_rc;
+
+/* Private function declarations */
+
+static void T_CORE_ECC_setUp(void);
+static void T_CORE_ECC_tearDown(void);
+static size_t T_CORE_ECC_from_hex(const char* hex, uint8_t* output);
+static int T_CORE_ECC_sha512(const uint8_t* message, size_t message_length, uint8_t* digest);
+static int T_CORE_ECC_load_vector(const T_CORE_ECC_ed25519_vector_t* vector, LLSEC_ed25519_key* key, uint8_t* message,
+                                  size_t* message_length, uint8_t* signature);
+static void T_CORE_ECC_print_time(const char* name, int64_t total_time);
+static void T_CORE_ECC_ed25519_rfc8032(void);
+static void T_CORE_ECC_ed25519_tampered(void);
+static void T_CORE_ECC_signature_benchmark(void);
+static int T_CORE_ECC_ecdsa_sign(mbedtls_ecdsa_context* ecdsa, const uint8_t* digest, uint8_t* signature, mbedtls_ctr_drbg_context* ctr_drbg);
+static void T_CORE_ECC_print_throughput(const char* name, int64_t total_time);
+static void T_CORE_ECC_ecdsa_sign_throughput(void);
+static void T_CORE_ECC_key_agreement_benchmark(void);
+
+/* Private function definitions */
+
+static void T_CORE_ECC_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+	mbedtls_entropy_init(&T_CORE_ECC_entropy);
+	mbedtls_ctr_drbg_init(&T_CORE_ECC_ctr_drbg);
+	T_CORE_ECC_ctr_drbg_rc = mbedtls_ctr_drbg_seed(&T_CORE_ECC_ctr_drbg, mbedtls_entropy_func, &T_CORE_ECC_entropy,
+			(const unsigned char*)"t_core_ecc", 10);
+}
+
+static void T_CORE_ECC_tearDown(void)
+{
+	mbedtls_ctr_drbg_free(&T_CORE_ECC_ctr_drbg);
+	mbedtls_entropy_free(&T_CORE_ECC_entropy);
+}
+
+/**
+ * @brief Decodes a hexadecimal string, returns the number of bytes.
+ */
+static size_t T_CORE_ECC_from_hex(const char* hex, uint8_t* output)
+{
+	size_t length = strlen(hex) / 2;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t byte = 0;
+		for (int j = 0; j < 2; j++) {
+			char c = hex[(2 * i) + j];
+			byte <<= 4;
+			if ((c >= '0') && (c <= '9')) {
+				byte |= (uint8_t)(c - '0');
+			} else {
+				byte |= (uint8_t)(c - 'a' + 10);
+			}
+		}
+		output[i] = byte;
+	}
+	return length;
+}
+
+/**
+ * @brief Computes the digest given to Ed25519ph, as done by the Java signature before calling LLSEC_SIG_IMPL_sign().
+ */
+static int T_CORE_ECC_sha512(const uint8_t* message, size_t message_length, uint8_t* digest)
+{
+	return mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA512), message, message_length, digest);
+}
+
+/**
+ * @brief Decodes a test vector, the message is replaced by its digest for Ed25519ph.
+ *
+ * @return 0 on success.
+ */
+static int T_CORE_ECC_load_vector(const T_CORE_ECC_ed25519_vector_t* vector, LLSEC_ed25519_key* key, uint8_t* message,
+                                  size_t* message_length, uint8_t* signature)
+{
+	int rc = 0;
+	uint8_t raw_message[T_CORE_ECC_MAX_MESSAGE_SIZE];
+
+	key->has_private_key = 1;
+	(void)T_CORE_ECC_from_hex(vector->private_key, key->private_key);
+	(void)T_CORE_ECC_from_hex(vector->public_key, key->public_key);
+	(void)T_CORE_ECC_from_hex(vector->signature, signature);
+	*message_length = T_CORE_ECC_from_hex(vector->message, raw_message);
+	if ((uint8_t)0 != vector->prehashed) {
+		rc = T_CORE_ECC_sha512(raw_message, *message_length, message);
+		*message_length = LLSEC_ED25519_PREHASH_SIZE;
+	} else {
+		(void)memcpy(message, raw_message, *message_length);
+	}
+	return rc;
+}
+
+static void T_CORE_ECC_print_time(const char* name, int64_t total_time)
+{
+	UTIL_print_string(name);
+	UTIL_print_integer((int)(total_time / T_CORE_ECC_BENCHMARK_ITERATIONS));
+	UTIL_print_string(" us\n");
+}
+
+static void T_CORE_ECC_ed25519_rfc8032(void)
+{
+	for (size_t i = 0; i < (sizeof(T_CORE_ECC_ed25519_vectors) / sizeof(T_CORE_ECC_ed25519_vectors[0])); i++) {
+		const T_CORE_ECC_ed25519_vector_t* vector = &T_CORE_ECC_ed25519_vectors[i];
+		LLSEC_ed25519_key key;
+		uint8_t message[T_CORE_ECC_MAX_MESSAGE_SIZE];
+		size_t message_length;
+		uint8_t expected[LLSEC_ED25519_SIGNATURE_SIZE];
+		uint8_t output[LLSEC_ED25519_SIGNATURE_SIZE];
+
+		TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_load_vector(vector, &key, message, &message_length, expected));
+
+		TEST_ASSERT_EQUAL_INT(0, llsec_ed25519_public_key(output, key.private_key));
+		TEST_ASSERT_MESSAGE(0 == memcmp(key.public_key, output, LLSEC_ED25519_KEY_SIZE), "wrong public key");
+
+		TEST_ASSERT_EQUAL_INT(0, llsec_ed25519_sign(output, message, message_length, &key, vector->prehashed));
+		TEST_ASSERT_MESSAGE(0 == memcmp(expected, output, LLSEC_ED25519_SIGNATURE_SIZE), "wrong signature");
+
+		TEST_ASSERT_MESSAGE(0 == llsec_ed25519_verify(expected, message, message_length, key.public_key, vector->prehashed),
+				"valid signature rejected");
+		/* Ed25519 and Ed25519ph signatures are not interchangeable (dom2 prefix) */
+		TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(expected, message, message_length, key.public_key, (uint8_t)(1 - vector->prehashed)),
+				"signature accepted by the other variant");
+	}
+}
+
+static void T_CORE_ECC_ed25519_tampered(void)
+{
+	/* Ed25519ph vector */
+	const T_CORE_ECC_ed25519_vector_t* vector = &T_CORE_ECC_ed25519_vectors[3];
+	LLSEC_ed25519_key key;
+	uint8_t message[T_CORE_ECC_MAX_MESSAGE_SIZE];
+	size_t message_length;
+	uint8_t signature[LLSEC_ED25519_SIGNATURE_SIZE];
+	uint8_t tampered[LLSEC_ED25519_SIGNATURE_SIZE];
+	uint8_t other_public_key[LLSEC_ED25519_KEY_SIZE];
+
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_load_vector(vector, &key, message, &message_length, signature));
+
+	/* R modified */
+	(void)memcpy(tampered, signature, sizeof(tampered));
+	tampered[0] ^= (uint8_t)0x01;
+	TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(tampered, message, message_length, key.public_key, 1), "modified R accepted");
+
+	/* S modified */
+	(void)memcpy(tampered, signature, sizeof(tampered));
+	tampered[LLSEC_ED25519_KEY_SIZE] ^= (uint8_t)0x01;
+	TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(tampered, message, message_length, key.public_key, 1), "modified S accepted");
+
+	/* S + L: same point equation, but a malleable encoding that must be rejected (RFC 8032 section 5.1.7) */
+	(void)memcpy(tampered, signature, sizeof(tampered));
+	uint16_t carry = 0;
+	for (int i = 0; i < LLSEC_ED25519_KEY_SIZE; i++) {
+		carry += (uint16_t)tampered[LLSEC_ED25519_KEY_SIZE + i] + (uint16_t)T_CORE_ECC_ed25519_order[i];
+		tampered[LLSEC_ED25519_KEY_SIZE + i] = (uint8_t)carry;
+		carry >>= 8;
+	}
+	TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(tampered, message, message_length, key.public_key, 1), "non canonical S accepted");
+
+	/* Digest modified */
+	message[0] ^= (uint8_t)0x01;
+	TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(signature, message, message_length, key.public_key, 1), "modified digest accepted");
+	message[0] ^= (uint8_t)0x01;
+
+	/* Other public key */
+	(void)T_CORE_ECC_from_hex(T_CORE_ECC_ed25519_vectors[0].public_key, other_public_key);
+	TEST_ASSERT_MESSAGE(0 != llsec_ed25519_verify(signature, message, message_length, other_public_key, 1), "signature accepted with another key");
+
+	TEST_ASSERT_MESSAGE(0 == llsec_ed25519_verify(signature, message, message_length, key.public_key, 1), "valid signature rejected");
+}
+
+/*
+ * Ed25519ph (LLSEC_ed25519.c) versus ECDSA P-256 (mbedTLS, as used by SHA256withECDSA), signature and verification of
+ * the digest of the same message.
+ */
+static void T_CORE_ECC_signature_benchmark(void)
+{
+	LLSEC_ed25519_key ed25519_key;
+	uint8_t digest[MBEDTLS_MD_MAX_SIZE];
+	uint8_t signature[MBEDTLS_ECDSA_MAX_LEN];
+	size_t signature_length = 0;
+	mbedtls_ecdsa_context ecdsa;
+	int64_t ed25519_sign_time = 0;
+	int64_t ed25519_verify_time = 0;
+	int64_t ecdsa_sign_time = 0;
+	int64_t ecdsa_verify_time = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_ctr_drbg_rc);
+	ed25519_key.has_private_key = 1;
+	TEST_ASSERT_EQUAL_INT(0, mbedtls_ctr_drbg_random(&T_CORE_ECC_ctr_drbg, ed25519_key.private_key, LLSEC_ED25519_KEY_SIZE));
+	TEST_ASSERT_EQUAL_INT(0, llsec_ed25519_public_key(ed25519_key.public_key, ed25519_key.private_key));
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_sha512((const uint8_t*)T_CORE_ECC_benchmark_message, sizeof(T_CORE_ECC_benchmark_message), digest));
+
+	for (int i = 0; i < T_CORE_ECC_BENCHMARK_ITERATIONS; i++) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		int rc = llsec_ed25519_sign(signature, digest, LLSEC_ED25519_PREHASH_SIZE, &ed25519_key, 1);
+		ed25519_sign_time += UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(0, rc);
+
+		start_time = UTIL_TIME_BASE_getTime();
+		rc = llsec_ed25519_verify(signature, digest, LLSEC_ED25519_PREHASH_SIZE, ed25519_key.public_key, 1);
+		ed25519_verify_time += UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(0, rc);
+	}
+
+	mbedtls_ecdsa_init(&ecdsa);
+	int rc = mbedtls_ecdsa_genkey(&ecdsa, MBEDTLS_ECP_DP_SECP256R1, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+	if (0 == rc) {
+		rc = mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const uint8_t*)T_CORE_ECC_benchmark_message,
+				sizeof(T_CORE_ECC_benchmark_message), digest);
+	}
+	for (int i = 0; (0 == rc) && (i < T_CORE_ECC_BENCHMARK_ITERATIONS); i++) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+#if (MBEDTLS_VERSION_MAJOR == 2)
+		rc = mbedtls_ecdsa_write_signature(&ecdsa, MBEDTLS_MD_SHA256, digest, 32, signature, &signature_length,
+				mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+#elif (MBEDTLS_VERSION_MAJOR == 3)
+		rc = mbedtls_ecdsa_write_signature(&ecdsa, MBEDTLS_MD_SHA256, digest, 32, signature, sizeof(signature), &signature_length,
+				mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+#else
+		#error "Unsupported mbedTLS major version"
+#endif
+		ecdsa_sign_time += UTIL_TIME_BASE_getTime() - start_time;
+
+		if (0 == rc) {
+			start_time = UTIL_TIME_BASE_getTime();
+			rc = mbedtls_ecdsa_read_signature(&ecdsa, digest, 32, signature, signature_length);
+			ecdsa_verify_time += UTIL_TIME_BASE_getTime() - start_time;
+		}
+	}
+	mbedtls_ecdsa_free(&ecdsa);
+	TEST_ASSERT_EQUAL_INT(0, rc);
+
+	T_CORE_ECC_print_time("Ed25519ph sign: ", ed25519_sign_time);
+	T_CORE_ECC_print_time("Ed25519ph verify: ", ed25519_verify_time);
+	T_CORE_ECC_print_time("ECDSA P-256 sign: ", ecdsa_sign_time);
+	T_CORE_ECC_print_time("ECDSA P-256 verify: ", ecdsa_verify_time);
+}
+
+/**
+ * @brief Signs a SHA-256 digest, as done by LLSEC_SIG_mbedtls_ec_sign().
+ */
+static int T_CORE_ECC_ecdsa_sign(mbedtls_ecdsa_context* ecdsa, const uint8_t* digest, uint8_t* signature, mbedtls_ctr_drbg_context* ctr_drbg)
+{
+	size_t signature_length = 0;
+#if (MBEDTLS_VERSION_MAJOR == 2)
+	return mbedtls_ecdsa_write_signature(ecdsa, MBEDTLS_MD_SHA256, digest, 32, signature, &signature_length,
+			mbedtls_ctr_drbg_random, ctr_drbg);
+#elif (MBEDTLS_VERSION_MAJOR == 3)
+	return mbedtls_ecdsa_write_signature(ecdsa, MBEDTLS_MD_SHA256, digest, 32, signature, MBEDTLS_ECDSA_MAX_LEN, &signature_length,
+			mbedtls_ctr_drbg_random, ctr_drbg);
+#else
+	#error "Unsupported mbedTLS major version"
+#endif
+}
+
+static void T_CORE_ECC_print_throughput(const char* name, int64_t total_time)
+{
+	/* Below the time base resolution */
+	if (0 >= total_time) {
+		total_time = 1;
+	}
+	UTIL_print_string(name);
+	UTIL_print_integer((int)(((int64_t)T_CORE_ECC_THROUGHPUT_SIGNATURES * 1000000 * 10) / total_time));
+	UTIL_print_string(" signatures/10s\n");
+}
+
+/*
+ * Repeated ECDSA P-256 signatures with the same key. The signature native keeps one random generator for all the
+ * signatures (llsec_get_ctr_drbg()): this is compared with seeding a new entropy source and random generator for each
+ * signature, as it was done before. The generator multiplication uses the static tables of
+ * CONFIG_MBEDTLS_ECP_FIXED_POINT_OPTIM in both cases.
+ */
+static void T_CORE_ECC_ecdsa_sign_throughput(void)
+{
+	uint8_t digest[MBEDTLS_MD_MAX_SIZE];
+	uint8_t signature[MBEDTLS_ECDSA_MAX_LEN];
+	mbedtls_ecdsa_context ecdsa;
+	int64_t shared_time = 0;
+	int64_t seeded_time = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_ctr_drbg_rc);
+
+	mbedtls_ecdsa_init(&ecdsa);
+	int rc = mbedtls_ecdsa_genkey(&ecdsa, MBEDTLS_ECP_DP_SECP256R1, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+	if (0 == rc) {
+		rc = mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const uint8_t*)T_CORE_ECC_benchmark_message,
+				sizeof(T_CORE_ECC_benchmark_message), digest);
+	}
+
+	if (0 == rc) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		for (int i = 0; (0 == rc) && (i < T_CORE_ECC_THROUGHPUT_SIGNATURES); i++) {
+			rc = T_CORE_ECC_ecdsa_sign(&ecdsa, digest, signature, &T_CORE_ECC_ctr_drbg);
+		}
+		shared_time = UTIL_TIME_BASE_getTime() - start_time;
+	}
+
+	if (0 == rc) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		for (int i = 0; (0 == rc) && (i < T_CORE_ECC_THROUGHPUT_SIGNATURES); i++) {
+			mbedtls_entropy_context entropy;
+			mbedtls_ctr_drbg_context ctr_drbg;
+
+			mbedtls_entropy_init(&entropy);
+			mbedtls_ctr_drbg_init(&ctr_drbg);
+			rc = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)"t_core_ecc", 10);
+			if (0 == rc) {
+				rc = T_CORE_ECC_ecdsa_sign(&ecdsa, digest, signature, &ctr_drbg);
+			}
+			mbedtls_ctr_drbg_free(&ctr_drbg);
+			mbedtls_entropy_free(&entropy);
+		}
+		seeded_time = UTIL_TIME_BASE_getTime() - start_time;
+	}
+	mbedtls_ecdsa_free(&ecdsa);
+	TEST_ASSERT_EQUAL_INT(0, rc);
+
+	T_CORE_ECC_print_throughput("ECDSA P-256, shared random generator: ", shared_time);
+	T_CORE_ECC_print_throughput("ECDSA P-256, random generator seeded per signature: ", seeded_time);
+}
+
+/*
+ * X25519 versus ECDH P-256 (mbedTLS, as used by LLSEC_KEY_AGREEMENT_impl.c): key pair generation and shared secret
+ * computation between two parties.
+ */
+static void T_CORE_ECC_key_agreement_benchmark(void)
+{
+	const mbedtls_ecp_group_id curves[] = { MBEDTLS_ECP_DP_CURVE25519, MBEDTLS_ECP_DP_SECP256R1 };
+	const char* names[] = { "X25519", "ECDH P-256" };
+
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_ECC_ctr_drbg_rc);
+
+	for (size_t c = 0; c < (sizeof(curves) / sizeof(curves[0])); c++) {
+		mbedtls_ecp_group grp;
+		mbedtls_mpi d_a;
+		mbedtls_mpi d_b;
+		mbedtls_mpi z_a;
+		mbedtls_mpi z_b;
+		mbedtls_ecp_point q_a;
+		mbedtls_ecp_point q_b;
+		int64_t keygen_time = 0;
+		int64_t shared_time = 0;
+
+		mbedtls_ecp_group_init(&grp);
+		mbedtls_mpi_init(&d_a);
+		mbedtls_mpi_init(&d_b);
+		mbedtls_mpi_init(&z_a);
+		mbedtls_mpi_init(&z_b);
+		mbedtls_ecp_point_init(&q_a);
+		mbedtls_ecp_point_init(&q_b);
+
+		int rc = mbedtls_ecp_group_load(&grp, curves[c]);
+		for (int i = 0; (0 == rc) && (i < T_CORE_ECC_BENCHMARK_ITERATIONS); i++) {
+			int64_t start_time = UTIL_TIME_BASE_getTime();
+			rc = mbedtls_ecdh_gen_public(&grp, &d_a, &q_a, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+			keygen_time += UTIL_TIME_BASE_getTime() - start_time;
+			if (0 == rc) {
+				rc = mbedtls_ecdh_gen_public(&grp, &d_b, &q_b, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+			}
+
+			if (0 == rc) {
+				start_time = UTIL_TIME_BASE_getTime();
+				rc = mbedtls_ecdh_compute_shared(&grp, &z_a, &q_b, &d_a, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+				shared_time += UTIL_TIME_BASE_getTime() - start_time;
+			}
+			if (0 == rc) {
+				rc = mbedtls_ecdh_compute_shared(&grp, &z_b, &q_a, &d_b, mbedtls_ctr_drbg_random, &T_CORE_ECC_ctr_drbg);
+			}
+			if ((0 == rc) && (0 != mbedtls_mpi_cmp_mpi(&z_a, &z_b))) {
+				rc = -1;
+			}
+		}
+
+		mbedtls_ecp_point_free(&q_b);
+		mbedtls_ecp_point_free(&q_a);
+		mbedtls_mpi_free(&z_b);
+		mbedtls_mpi_free(&z_a);
+		mbedtls_mpi_free(&d_b);
+		mbedtls_mpi_free(&d_a);
+		mbedtls_ecp_group_free(&grp);
+		TEST_ASSERT_MESSAGE(0 == rc, "key agreement failed");
+
+		UTIL_print_string(names[c]);
+		T_CORE_ECC_print_time(" key generation: ", keygen_time);
+		UTIL_print_string(names[c]);
+		T_CORE_ECC_print_time(" shared secret: ", shared_time);
+	}
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_ECC_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Ed25519 and Ed25519ph known answers (RFC 8032)", T_CORE_ECC_ed25519_rfc8032),
+		new_TestFixture("Ed25519ph tampered signatures", T_CORE_ECC_ed25519_tampered),
+		new_TestFixture("Ed25519ph versus ECDSA P-256 signature benchmark", T_CORE_ECC_signature_benchmark),
+		new_TestFixture("ECDSA P-256 signature throughput with the same key", T_CORE_ECC_ecdsa_sign_throughput),
+		new_TestFixture("X25519 versus ECDH P-256 key agreement benchmark", T_CORE_ECC_key_agreement_benchmark),
+	};
+	UTIL_print_string("\nElliptic curve tests:\n");
+	EMB_UNIT_TESTCALLER(eccTest, "ECC_tests", T_CORE_ECC_setUp, T_CORE_ECC_tearDown, fixtures);
+
+	return (TestRef)&eccTest;
+}
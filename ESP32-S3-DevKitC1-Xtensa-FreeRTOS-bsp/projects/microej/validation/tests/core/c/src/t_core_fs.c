@@ -0,0 +1,1548 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "fs_helper.h"
+#include "LLFS_File_impl.h"
+#include "LLFS_EXTENSION_impl.h"
+#ifndef FS_USE_LITTLEFS
+#include "ff.h"
+#endif
+
+/* Private constant declarations */
+
+#define T_CORE_FS_LOG_PATH				"/t_core_fs.log"
+#define T_CORE_FS_FILE_PATH				"/t_core_fs.txt"
+#define T_CORE_FS_LOG_CAPACITY			(64 * 1024)
+#define T_CORE_FS_RECORD_LENGTH			(100)
+#define T_CORE_FS_BENCH_RECORD_LENGTH	(64)
+#define T_CORE_FS_BENCH_RECORD_COUNT	(500)
+#define T_CORE_FS_BENCH_GROUP_SIZE		(10)
+#define T_CORE_FS_REOPEN_COUNT			(100)
+#define T_CORE_FS_BYTE_FILE_SIZE		(16 * 1024)
+#define T_CORE_FS_TRANSFER_SIZE_MIN		(4 * 1024)
+#define T_CORE_FS_TRANSFER_SIZE_MAX		(1024 * 1024)
+#define T_CORE_FS_DIRECTORY_PATH		"/t_core_fs_dir"
+#define T_CORE_FS_COPY_SOURCE_PATH		"/t_core_fs_src.bin"
+#define T_CORE_FS_COPY_PATH				"/t_core_fs_dst.bin"
+#define T_CORE_FS_COPY_SIZE				(128 * 1024)
+#define T_CORE_FS_COPY_DEPTH			(2)
+#define T_CORE_FS_STRESS_JOB_COUNT		(T_CORE_FS_COPY_DEPTH + 1)
+#define T_CORE_FS_STRESS_READ_COUNT		(200)
+#define T_CORE_FS_STRESS_READ_LENGTH	(64)
+#define T_CORE_FS_STRESS_TIMEOUT_US		(10000000)
+#define T_CORE_FS_COMPARE_COUNT			(200)
+#define T_CORE_FS_COMPARE_LENGTH		(64)
+#define T_CORE_FS_COMPARE_FILE_SIZE		(64 * 1024)
+#define T_CORE_FS_COMPARE_FILE_COUNT	(50)
+#define T_CORE_FS_RACE_COUNT			(50)
+#define T_CORE_FS_RACE_CONTENT			"content before the modification"
+#define T_CORE_FS_RENAMED_PATH			"/t_core_fs_renamed.txt"
+#define T_CORE_FS_RESOURCE_COUNT		(3)
+#define T_CORE_FS_RESOURCE_IMAGE_SIZE	(2048)
+#ifdef FS_USE_LITTLEFS
+#define T_CORE_FS_NAME					"LittleFS"
+#else
+#define T_CORE_FS_NAME					"FatFs"
+#endif
+
+/* Private structure declarations */
+
+/**
+ * @brief State of an open append log, as kept by LLFS_LOG_impl.c.
+ */
+typedef struct {
+	int32_t id;
+	int64_t end;
+	uint32_t sequence;
+	uint32_t epoch;
+} T_CORE_FS_log_t;
+
+/* Private variable definitions */
+
+static bool T_CORE_FS_mounted = false;
+// Parameters of the executed action.
+static FS_worker_param_t T_CORE_FS_params;
+// Records written by T_CORE_FS_log_append(), followed by room for an end marker.
+static uint8_t T_CORE_FS_records[FS_LOG_BUFFER_SIZE + sizeof(FS_log_record_header_t)];
+// Payload of the records written by T_CORE_FS_log_append().
+static uint8_t T_CORE_FS_payload[FS_LOG_BUFFER_SIZE];
+// Data of the pattern files.
+static uint8_t T_CORE_FS_file_buffer[FS_FILE_BUFFER_SIZE];
+// File buffer of the byte-wise reads, driven as by LLFS_File_impl.c.
+static LLFS_File_buffer_t T_CORE_FS_buffer;
+
+// FS workers of the stress test, the first one runs the bulk copy.
+MICROEJ_ASYNC_WORKER_worker_declare(T_CORE_FS_copy_worker, T_CORE_FS_STRESS_JOB_COUNT, FS_worker_param_t, 1);
+MICROEJ_ASYNC_WORKER_worker_declare(T_CORE_FS_read_worker, T_CORE_FS_STRESS_JOB_COUNT, FS_worker_param_t, 1);
+static OSAL_task_stack_t T_CORE_FS_worker_stacks[1] = {
+	FS_WORKER_STACK_SIZE,
+};
+static bool T_CORE_FS_workers_initialized = false;
+// Files of the bulk copy, used by T_CORE_FS_copy_chunk_action() only.
+static int32_t T_CORE_FS_copy_source;
+static int32_t T_CORE_FS_copy_destination;
+// Number of chunks copied, and of chunks not copied entirely.
+static volatile int32_t T_CORE_FS_copied_chunk_count = 0;
+static volatile int32_t T_CORE_FS_copy_errors = 0;
+// Outcome of the last small read, set by T_CORE_FS_small_read_action().
+static volatile bool T_CORE_FS_small_read_done = false;
+static volatile bool T_CORE_FS_small_read_valid = false;
+// Latencies of the small reads in microseconds.
+static int64_t T_CORE_FS_small_read_latencies[T_CORE_FS_STRESS_READ_COUNT];
+// Outcome of the close and of the modification run in parallel, set by T_CORE_FS_race_*_action().
+static volatile bool T_CORE_FS_race_close_done = false;
+static volatile bool T_CORE_FS_race_modification_done = false;
+static volatile int32_t T_CORE_FS_race_close_result;
+static volatile int32_t T_CORE_FS_race_modification_result;
+
+static const char* T_CORE_FS_resource_names[T_CORE_FS_RESOURCE_COUNT] = { "fonts/sans.ejf", "images/logo.png", "empty" };
+static const uint32_t T_CORE_FS_resource_lengths[T_CORE_FS_RESOURCE_COUNT] = { 1000, 37, 0 };
+
+static uint8_t T_CORE_FS_resource_image_data[T_CORE_FS_RESOURCE_IMAGE_SIZE];
+
+/* Private function definitions */
+
+/**
+ * @brief Executes an action with T_CORE_FS_params, as an FS worker would.
+ */
+static void T_CORE_FS_execute(MICROEJ_ASYNC_WORKER_action_t action)
+{
+	MICROEJ_ASYNC_WORKER_job_t job;
+	(void)memset(&job, 0, sizeof(job));
+	job.params = &T_CORE_FS_params;
+	action(&job);
+}
+
+/**
+ * @brief Executes an action on a path (delete, make directory, open directory, ...), returns its result.
+ */
+static int32_t T_CORE_FS_path_operation(MICROEJ_ASYNC_WORKER_action_t action, const char* path)
+{
+	(void)strncpy((char*)T_CORE_FS_params.path_operation.path, path, FS_PATH_LENGTH);
+	T_CORE_FS_execute(action);
+	return T_CORE_FS_params.path_operation.result;
+}
+
+static int32_t T_CORE_FS_delete(const char* path)
+{
+	return T_CORE_FS_path_operation(LLFS_IMPL_delete_action, path);
+}
+
+/**
+ * @brief Opens a file, returns the ID of the file or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_open(const char* path, uint8_t mode)
+{
+	FS_open_t* params = &T_CORE_FS_params.open;
+	(void)strncpy((char*)params->path, path, FS_PATH_LENGTH);
+	params->mode = mode;
+	T_CORE_FS_execute(LLFS_File_IMPL_open_action);
+	return params->result;
+}
+
+static int32_t T_CORE_FS_close(int32_t file_id)
+{
+	T_CORE_FS_params.close.file_id = file_id;
+	T_CORE_FS_execute(LLFS_File_IMPL_close_action);
+	return T_CORE_FS_params.close.result;
+}
+
+/**
+ * @brief Reads or writes data at the file pointer, returns the number of bytes transferred, LLFS_EOF or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_transfer(int32_t file_id, uint8_t* data, int32_t length, bool write)
+{
+	FS_write_read_t* params = &T_CORE_FS_params.write;
+	params->file_id = file_id;
+	params->data = data;
+	params->length = length;
+	T_CORE_FS_execute(write ? LLFS_File_IMPL_write_action : LLFS_File_IMPL_read_action);
+	return params->result;
+}
+
+/**
+ * @brief Creates a file or replaces its content with the given string.
+ *
+ * @return true if the file has been written and closed.
+ */
+static bool T_CORE_FS_write_file(const char* path, const char* content)
+{
+	int32_t length = (int32_t)strlen(content);
+	int32_t file_id = T_CORE_FS_open(path, LLFS_FILE_MODE_WRITE);
+	if (file_id == LLFS_NOK) {
+		return false;
+	}
+	bool written = (T_CORE_FS_transfer(file_id, (uint8_t*)content, length, true) == length);
+	return (T_CORE_FS_close(file_id) == LLFS_OK) && written;
+}
+
+/**
+ * @brief Opens a file for reading and reads it: its content must be the given string. The file is closed if it is
+ * not.
+ *
+ * @return the ID of the file, or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_open_and_check(const char* path, const char* content)
+{
+	char buffer[FS_PATH_LENGTH];
+	int32_t length = (int32_t)strlen(content);
+	int32_t file_id = T_CORE_FS_open(path, LLFS_FILE_MODE_READ);
+	if ((file_id != LLFS_NOK) && ((T_CORE_FS_transfer(file_id, (uint8_t*)buffer, (int32_t)sizeof(buffer), false) != length)
+			|| (memcmp(content, buffer, (size_t)length) != 0))) {
+		(void)T_CORE_FS_close(file_id);
+		file_id = LLFS_NOK;
+	}
+	return file_id;
+}
+
+/**
+ * @brief Opens, reads and closes a file: its content must be the given string.
+ */
+static bool T_CORE_FS_check_file(const char* path, const char* content)
+{
+	int32_t file_id = T_CORE_FS_open_and_check(path, content);
+	return (file_id != LLFS_NOK) && (T_CORE_FS_close(file_id) == LLFS_OK);
+}
+
+
+/**
+ * @brief Opens or creates an append log, returns the ID of the log or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_log_open(T_CORE_FS_log_t* log)
+{
+	FS_log_open_t* params = &T_CORE_FS_params.log_open;
+	(void)strncpy((char*)params->path, T_CORE_FS_LOG_PATH, FS_PATH_LENGTH);
+	params->capacity = T_CORE_FS_LOG_CAPACITY;
+	T_CORE_FS_execute(LLFS_LOG_IMPL_open_action);
+	log->id = params->result;
+	log->end = params->end;
+	log->sequence = params->sequence;
+	log->epoch = params->epoch;
+	return params->result;
+}
+
+/**
+ * @brief Writes records at the end of a log in one write, as LLFS_LOG_IMPL_commit() does: the records are encoded
+ * with the helpers of LLFS_LOG_impl.c and followed by an end marker. Only the first written_length bytes are written to simulate a power cut, all of them if negative.
+ * The end of the log is only moved when all the records are written.
+ *
+ * @return the result of the write action.
+ */
+static int32_t T_CORE_FS_log_append(T_CORE_FS_log_t* log, int32_t record_count, int32_t payload_length, int32_t written_length,
+		bool sync)
+{
+	int32_t length = 0;
+	uint32_t sequence = log->sequence;
+
+	for (int32_t i = 0; i < record_count; i++) {
+		(void)memset(T_CORE_FS_payload, (int)(sequence & 0xFFU), (size_t)payload_length);
+		length += LLFS_log_encode_record(&T_CORE_FS_records[length], log->epoch, sequence, T_CORE_FS_payload, payload_length);
+		sequence++;
+	}
+	int32_t marked_length = LLFS_log_append_end_marker(T_CORE_FS_records, length);
+
+	FS_log_write_t* params = &T_CORE_FS_params.log_write;
+	params->log_id = log->id;
+	params->data = T_CORE_FS_records;
+	params->length = (written_length < 0) ? marked_length : written_length;
+	params->position = log->end;
+	params->sync = sync;
+	T_CORE_FS_execute(LLFS_LOG_IMPL_write_action);
+	if ((params->result == LLFS_OK) && (written_length < 0)) {
+		log->end += length;
+		log->sequence = sequence;
+	}
+	return params->result;
+}
+
+/**
+ * @brief Reads the record at the given position, returns its payload length or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_log_read(const T_CORE_FS_log_t* log, int64_t position)
+{
+	FS_log_read_t* params = &T_CORE_FS_params.log_read;
+	params->log_id = log->id;
+	params->position = position;
+	params->epoch = log->epoch;
+	T_CORE_FS_execute(LLFS_LOG_IMPL_read_action);
+	return params->result;
+}
+
+/**
+ * @brief Returns the byte at the given position of the files written by T_CORE_FS_write_pattern().
+ */
+static uint8_t T_CORE_FS_pattern(int32_t position)
+{
+	return (uint8_t)((position * 7) + (position >> 8));
+}
+
+/**
+ * @brief Fills a buffer with the pattern of the files, from the given position of the file.
+ */
+static void T_CORE_FS_fill_pattern(uint8_t* buffer, int32_t position, int32_t length)
+{
+	for (int32_t i = 0; i < length; i++) {
+		buffer[i] = T_CORE_FS_pattern(position + i);
+	}
+}
+
+/**
+ * @brief Creates a file of the given size filled with T_CORE_FS_pattern().
+ *
+ * @return true if the file has been written and closed.
+ */
+static bool T_CORE_FS_write_pattern(const char* path, int32_t size)
+{
+	int32_t file_id = T_CORE_FS_open(path, LLFS_FILE_MODE_WRITE);
+	if (file_id == LLFS_NOK) {
+		return false;
+	}
+	bool written = true;
+	for (int32_t position = 0; written && (position < size); position += FS_FILE_BUFFER_SIZE) {
+		int32_t length = ((size - position) < FS_FILE_BUFFER_SIZE) ? (size - position) : FS_FILE_BUFFER_SIZE;
+		T_CORE_FS_fill_pattern(T_CORE_FS_file_buffer, position, length);
+		written = (T_CORE_FS_transfer(file_id, T_CORE_FS_file_buffer, length, true) == length);
+	}
+	return (T_CORE_FS_close(file_id) == LLFS_OK) && written;
+}
+
+/**
+ * @brief Closes and reopens a log, checks that the recovered end of the log is the expected one. The log is closed
+ * if it is not.
+ *
+ * @return true if the log has been recovered up to the expected record.
+ */
+static bool T_CORE_FS_log_reopen(T_CORE_FS_log_t* log, int64_t expected_end, uint32_t expected_sequence)
+{
+	if ((T_CORE_FS_close(log->id) != LLFS_OK) || (T_CORE_FS_log_open(log) == LLFS_NOK)) {
+		return false;
+	}
+	if ((log->sequence != expected_sequence) || (log->end != expected_end)) {
+		(void)T_CORE_FS_close(log->id);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Creates an empty append log and appends the given number of records to it. The log is closed on error.
+ *
+ * @return true if the log has been created.
+ */
+static bool T_CORE_FS_log_create(T_CORE_FS_log_t* log, int32_t record_count)
+{
+	(void)T_CORE_FS_delete(T_CORE_FS_LOG_PATH);
+	if (T_CORE_FS_log_open(log) == LLFS_NOK) {
+		return false;
+	}
+	if ((log->sequence != 0U) || (log->end != (int64_t)sizeof(FS_log_file_header_t))
+			|| ((record_count > 0) && (T_CORE_FS_log_append(log, record_count, T_CORE_FS_RECORD_LENGTH, -1, true) != LLFS_OK))) {
+		(void)T_CORE_FS_close(log->id);
+		return false;
+	}
+	return true;
+}
+
+static void T_CORE_FS_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+	if (!T_CORE_FS_mounted) {
+		llfs_init();
+		(void)LLFS_helper_initialize();
+		T_CORE_FS_mounted = true;
+	}
+}
+
+static void T_CORE_FS_tearDown(void)
+{
+}
+
+static void T_CORE_FS_log_recovery(void)
+{
+	T_CORE_FS_log_t log;
+	int64_t record_size = (int64_t)sizeof(FS_log_record_header_t) + T_CORE_FS_RECORD_LENGTH;
+
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_create(&log, 5), "append log creation failed");
+	int64_t end = log.end;
+	TEST_ASSERT_MESSAGE(end == ((int64_t)sizeof(FS_log_file_header_t) + (5 * record_size)), "wrong end of log");
+
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, end, 5), "wrong recovered end of log");
+	int64_t position = (int64_t)sizeof(FS_log_file_header_t) + (2 * record_size);
+	TEST_ASSERT_EQUAL_INT(T_CORE_FS_RECORD_LENGTH, T_CORE_FS_log_read(&log, position));
+	TEST_ASSERT_EQUAL_INT(2, T_CORE_FS_params.log_read.buffer[0]);
+	TEST_ASSERT_EQUAL_INT(2, T_CORE_FS_params.log_read.buffer[T_CORE_FS_RECORD_LENGTH - 1]);
+
+	// Records appended after the recovery follow the recovered ones
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_log_append(&log, 2, T_CORE_FS_RECORD_LENGTH, -1, true));
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, end + (2 * record_size), 7), "wrong recovered end of log");
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(log.id));
+}
+
+static void T_CORE_FS_log_torn_tails(void)
+{
+	// Power cut in the header, after the header, in the payload, in the end marker of a group commit
+	const int32_t record_size = (int32_t)sizeof(FS_log_record_header_t) + T_CORE_FS_RECORD_LENGTH;
+	const int32_t torn_lengths[] = {
+		(int32_t)sizeof(FS_log_record_header_t) / 2,
+		(int32_t)sizeof(FS_log_record_header_t),
+		(int32_t)sizeof(FS_log_record_header_t) + (T_CORE_FS_RECORD_LENGTH / 2),
+		record_size - 1,
+	};
+	T_CORE_FS_log_t log;
+
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_create(&log, 3), "append log creation failed");
+	int64_t end = log.end;
+
+	for (size_t i = 0; i < (sizeof(torn_lengths) / sizeof(torn_lengths[0])); i++) {
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_log_append(&log, 1, T_CORE_FS_RECORD_LENGTH, torn_lengths[i], true));
+		TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, end, 3), "wrong recovered end of log");
+	}
+
+	// Group commit of 3 records torn in the third one: the first two are recovered
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_log_append(&log, 3, T_CORE_FS_RECORD_LENGTH, (2 * record_size) + 10, true));
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, end + (2 * record_size), 5), "wrong recovered end of log");
+
+	// The torn record is overwritten by the next one
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_log_append(&log, 1, T_CORE_FS_RECORD_LENGTH, -1, true));
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, end + (3 * record_size), 6), "wrong recovered end of log");
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(log.id));
+}
+
+static void T_CORE_FS_log_corruption(void)
+{
+	const int64_t record_size = (int64_t)sizeof(FS_log_record_header_t) + T_CORE_FS_RECORD_LENGTH;
+	const int64_t second_record = (int64_t)sizeof(FS_log_file_header_t) + record_size;
+	T_CORE_FS_log_t log;
+	uint8_t corrupted = 0xFF;
+
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_create(&log, 4), "append log creation failed");
+
+	// Flip a payload byte of the second record
+	FS_log_write_t* params = &T_CORE_FS_params.log_write;
+	params->log_id = log.id;
+	params->data = &corrupted;
+	params->length = 1;
+	params->position = second_record + (int64_t)sizeof(FS_log_record_header_t) + 10;
+	params->sync = true;
+	T_CORE_FS_execute(LLFS_LOG_IMPL_write_action);
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, params->result);
+
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, T_CORE_FS_log_read(&log, second_record));
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_reopen(&log, second_record, 1), "wrong recovered end of log");
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(log.id));
+}
+
+static void T_CORE_FS_log_not_a_log(void)
+{
+	T_CORE_FS_log_t log;
+
+	// The log file is replaced by a text file
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_LOG_PATH, "this is not an append log"), "file write failed");
+
+	// The error code depends on the file system (FatFs or LittleFS)
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, T_CORE_FS_log_open(&log));
+	TEST_ASSERT_EQUAL_STRING("not an append log", T_CORE_FS_params.log_open.error_message);
+	(void)T_CORE_FS_delete(T_CORE_FS_LOG_PATH);
+}
+
+/**
+ * @brief Appends records of T_CORE_FS_BENCH_RECORD_LENGTH bytes, committed by groups of group_size records, and
+ * prints the number of records per second.
+ */
+static void T_CORE_FS_log_append_rate(int32_t record_count, int32_t group_size)
+{
+	T_CORE_FS_log_t log;
+
+	TEST_ASSERT_MESSAGE(T_CORE_FS_log_create(&log, 0), "append log creation failed");
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int32_t i = 0; i < record_count; i += group_size) {
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_log_append(&log, group_size, T_CORE_FS_BENCH_RECORD_LENGTH, -1, true));
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_EQUAL_INT(record_count, (int)log.sequence);
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(log.id));
+
+	UTIL_print_string("Append log, ");
+	UTIL_print_integer(group_size);
+	UTIL_print_string(" record(s) of ");
+	UTIL_print_integer(T_CORE_FS_BENCH_RECORD_LENGTH);
+	UTIL_print_string(" bytes per commit: ");
+	UTIL_print_float(((double)record_count * 1000000.0) / (double)elapsed_time);
+	UTIL_print_string(" records/s\n");
+}
+
+static void T_CORE_FS_log_benchmark(void)
+{
+	T_CORE_FS_log_append_rate(T_CORE_FS_BENCH_RECORD_COUNT / T_CORE_FS_BENCH_GROUP_SIZE, 1);
+	T_CORE_FS_log_append_rate(T_CORE_FS_BENCH_RECORD_COUNT, T_CORE_FS_BENCH_GROUP_SIZE);
+	(void)T_CORE_FS_delete(T_CORE_FS_LOG_PATH);
+}
+
+static void T_CORE_FS_reopen(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, "reopened file"), "file write failed");
+	for (int32_t i = 0; i < T_CORE_FS_REOPEN_COUNT; i++) {
+		// The file is closed before its end: the next read must start at the beginning of the file
+		uint8_t buffer[4];
+		int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ);
+		TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "file open failed");
+		int32_t result = T_CORE_FS_transfer(file_id, buffer, (int32_t)sizeof(buffer), false);
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+		TEST_ASSERT_EQUAL_INT((int)sizeof(buffer), result);
+
+		file_id = T_CORE_FS_open_and_check(T_CORE_FS_FILE_PATH, "reopened file");
+		TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "wrong file content");
+		result = T_CORE_FS_transfer(file_id, buffer, 1, false);
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+		TEST_ASSERT_EQUAL_INT(LLFS_EOF, result);
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_FILE_PATH));
+}
+
+static void T_CORE_FS_reopen_after_modification(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, "first content"), "file write failed");
+	TEST_ASSERT_MESSAGE(T_CORE_FS_check_file(T_CORE_FS_FILE_PATH, "first content"), "wrong file content");
+
+	// Fails if the file kept open for reading still locks the file
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, "second content, longer"), "file write failed");
+	TEST_ASSERT_MESSAGE(T_CORE_FS_check_file(T_CORE_FS_FILE_PATH, "second content, longer"), "wrong file content");
+
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_FILE_PATH));
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ));
+}
+
+#ifndef FS_USE_LITTLEFS
+/**
+ * @brief Returns the path of the index-th test file, also used as its content. The path is overwritten by the next
+ * call.
+ */
+static const char* T_CORE_FS_indexed_path(int32_t index)
+{
+	static char path[] = "/t_core_fs_00.txt";
+	path[11] = (char)('0' + ((index / 10) % 10));
+	path[12] = (char)('0' + (index % 10));
+	return path;
+}
+
+/**
+ * @brief Opens the indexed files from the first index and checks their content, until FF_FS_LOCK files are open or
+ * an open fails.
+ *
+ * @return the number of files opened, their IDs are stored in file_ids.
+ */
+static int32_t T_CORE_FS_open_all(int32_t first_index, int32_t* file_ids)
+{
+	int32_t count = 0;
+	while (count < FF_FS_LOCK) {
+		const char* path = T_CORE_FS_indexed_path(first_index + count);
+		file_ids[count] = T_CORE_FS_open_and_check(path, path);
+		if (file_ids[count] == LLFS_NOK) {
+			break;
+		}
+		count++;
+	}
+	return count;
+}
+
+static void T_CORE_FS_open_cache_exhaustion(void)
+{
+	int32_t file_ids[FF_FS_LOCK];
+	const int32_t kept_count = 2;
+
+	for (int32_t i = 0; i < (FF_FS_LOCK + kept_count); i++) {
+		TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_indexed_path(i), T_CORE_FS_indexed_path(i)), "file write failed");
+	}
+
+	// Up to FS_OPEN_CACHE_SIZE of these files are kept open
+	for (int32_t i = 0; i < kept_count; i++) {
+		TEST_ASSERT_MESSAGE(T_CORE_FS_check_file(T_CORE_FS_indexed_path(i), T_CORE_FS_indexed_path(i)), "wrong file content");
+	}
+
+	// All the file slots and FatFs locks can still be used by other files, then the next open fails
+	int32_t open_count = T_CORE_FS_open_all(kept_count, file_ids);
+	int32_t extra_file_id = T_CORE_FS_open(T_CORE_FS_indexed_path(0), LLFS_FILE_MODE_READ);
+	for (int32_t i = 0; i < open_count; i++) {
+		(void)T_CORE_FS_close(file_ids[i]);
+	}
+	TEST_ASSERT_EQUAL_INT(FF_FS_LOCK, open_count);
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, extra_file_id);
+
+	// No file slot is leaked
+	open_count = T_CORE_FS_open_all(0, file_ids);
+	for (int32_t i = 0; i < open_count; i++) {
+		(void)T_CORE_FS_close(file_ids[i]);
+	}
+	TEST_ASSERT_EQUAL_INT(FF_FS_LOCK, open_count);
+
+	for (int32_t i = 0; i < (FF_FS_LOCK + kept_count); i++) {
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_indexed_path(i)));
+	}
+}
+#endif
+
+/**
+ * @brief Prints the average time to open, read and close a small file. The file system is modified before
+ * each open if flush is true, so the file is not kept open.
+ */
+static void T_CORE_FS_reopen_time(bool flush)
+{
+	int64_t elapsed_time = 0;
+
+	for (int32_t i = 0; i < T_CORE_FS_REOPEN_COUNT; i++) {
+		if (flush) {
+			(void)T_CORE_FS_delete(T_CORE_FS_LOG_PATH);
+		}
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		bool checked = T_CORE_FS_check_file(T_CORE_FS_FILE_PATH, "reopened file");
+		elapsed_time += UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_MESSAGE(checked, "wrong file content");
+	}
+
+	UTIL_print_string(flush ? "Open/read/close after a modification: " : "Open/read/close of the same file: ");
+	UTIL_print_float((double)elapsed_time / (double)T_CORE_FS_REOPEN_COUNT);
+	UTIL_print_string(" us\n");
+}
+
+static void T_CORE_FS_reopen_benchmark(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, "reopened file"), "file write failed");
+	T_CORE_FS_reopen_time(true);
+	T_CORE_FS_reopen_time(false);
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_FILE_PATH));
+}
+
+/**
+ * @brief Reads one byte through a file buffer as LLFS_File_IMPL_read_byte() does, running the jobs it requests
+ * in the current task.
+ *
+ * @return the byte, LLFS_EOF or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_buffer_read_byte(LLFS_File_buffer_t* buffer)
+{
+	int32_t result = LLFS_OK;
+	uint8_t byte;
+	int32_t read = 0;
+	LLFS_File_buffer_job_kind_t kind = LLFS_File_buffer_read_data(buffer, &byte, 1, &read);
+	while ((result == LLFS_OK) && (kind != LLFS_FILE_BUFFER_JOB_NONE)) {
+		int32_t error_code;
+		char* error_message;
+		T_CORE_FS_execute(LLFS_File_buffer_set_job_params(buffer, kind, &T_CORE_FS_params));
+		result = LLFS_File_buffer_job_done(buffer, kind, &T_CORE_FS_params, &error_code, &error_message);
+		if (result == LLFS_OK) {
+			kind = LLFS_File_buffer_read_data(buffer, &byte, 1, &read);
+		}
+	}
+	return (result == LLFS_OK) ? (int32_t)byte : result;
+}
+
+/**
+ * @brief Reads a pattern file byte per byte and prints the throughput. Without read-ahead, each byte is read by its
+ * own read action, as LLFS_File_IMPL_read_byte() does for a file without buffer. With read-ahead, the bytes are read
+ * through the file buffer logic of LLFS_File_impl.c (fs_helper_buffer.c), refilled by read actions of
+ * FS_FILE_BUFFER_SIZE bytes. The job round trips to the FS worker are not included: on the VM they add the same cost
+ * to each read action.
+ */
+static void T_CORE_FS_read_bytes(bool read_ahead)
+{
+	int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ);
+	TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "file open failed");
+	LLFS_File_buffer_initialize(&T_CORE_FS_buffer, file_id);
+
+	int32_t position = 0;
+	int32_t result = LLFS_OK;
+	bool valid = true;
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (valid) {
+		if (read_ahead) {
+			result = T_CORE_FS_buffer_read_byte(&T_CORE_FS_buffer);
+		}
+		else {
+			uint8_t byte;
+			result = T_CORE_FS_transfer(file_id, &byte, 1, false);
+			if (result == 1) {
+				result = (int32_t)byte;
+			}
+		}
+		if (result < 0) {
+			break;
+		}
+		valid = ((uint8_t)result == T_CORE_FS_pattern(position));
+		position++;
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+	LLFS_File_buffer_initialize(&T_CORE_FS_buffer, 0);
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+	TEST_ASSERT_MESSAGE(valid, "wrong file content");
+	TEST_ASSERT_EQUAL_INT(LLFS_EOF, result);
+	TEST_ASSERT_EQUAL_INT(T_CORE_FS_BYTE_FILE_SIZE, position);
+
+	UTIL_print_string(read_ahead ? "Byte-wise read with read-ahead: " : "Byte-wise read, one read per byte: ");
+	UTIL_print_float(((double)T_CORE_FS_BYTE_FILE_SIZE * 1000000.0) / (double)elapsed_time);
+	UTIL_print_string(" bytes/s\n");
+}
+
+static void T_CORE_FS_read_byte_benchmark(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_pattern(T_CORE_FS_FILE_PATH, T_CORE_FS_BYTE_FILE_SIZE), "file write failed");
+	T_CORE_FS_read_bytes(false);
+	T_CORE_FS_read_bytes(true);
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_FILE_PATH));
+}
+
+/**
+ * @brief Writes or reads a pattern file sequentially with the given data, as LLFS_File_IMPL_write() and
+ * LLFS_File_IMPL_read() do: in place (a single action) as for an immortal array, else through the bounce buffer
+ * selected by LLFS_bounce_buffer_select() for each job, the copy of SNI_retrieveArrayElements() or
+ * SNI_flushArrayElements() being a memcpy.
+ *
+ * @return the time of the transfer and of the close of the file in microseconds, or -1 on error.
+ */
+static int64_t T_CORE_FS_transfer_file(uint8_t* data, int32_t size, bool in_place, bool write)
+{
+	int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, write ? LLFS_FILE_MODE_WRITE : LLFS_FILE_MODE_READ);
+	if (file_id == LLFS_NOK) {
+		return -1;
+	}
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	int32_t position = 0;
+	while (position < size) {
+		int32_t length = size - position;
+		uint8_t* buffer = &data[position];
+		if (!in_place) {
+			uint32_t buffer_length = sizeof(T_CORE_FS_params.write.buffer);
+			buffer = LLFS_bounce_buffer_select(T_CORE_FS_params.write.buffer, &buffer_length, length);
+			length = (length < (int32_t)buffer_length) ? length : (int32_t)buffer_length;
+			if (write) {
+				(void)memcpy(buffer, &data[position], (size_t)length);
+			}
+		}
+		length = T_CORE_FS_transfer(file_id, buffer, length, write);
+		if ((length > 0) && !in_place && !write) {
+			(void)memcpy(&data[position], buffer, (size_t)length);
+		}
+		if (!in_place) {
+			LLFS_large_io_buffer_release(buffer);
+		}
+		if (length <= 0) {
+			break;
+		}
+		position += length;
+	}
+	bool closed = (T_CORE_FS_close(file_id) == LLFS_OK);
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+
+	return (closed && (position == size)) ? elapsed_time : -1;
+}
+
+static void T_CORE_FS_print_throughput(int32_t size, int64_t elapsed_time)
+{
+	UTIL_print_float(((double)size * 1000000.0) / ((double)elapsed_time * 1024.0));
+	UTIL_print_string(" KB/s");
+}
+
+static void T_CORE_FS_transfer_benchmark(void)
+{
+	// The largest transfers may not fit in the storage partition
+	FS_get_space_size* space_params = (FS_get_space_size*)&T_CORE_FS_params;
+	(void)T_CORE_FS_delete(T_CORE_FS_FILE_PATH);
+	(void)strncpy((char*)space_params->path, "/", FS_PATH_LENGTH);
+	space_params->space_type = LLFS_FREE_SPACE;
+	T_CORE_FS_execute(LLFS_IMPL_get_space_size_action);
+	TEST_ASSERT_MESSAGE(space_params->result > 0, "free space unknown");
+	int32_t max_size = T_CORE_FS_TRANSFER_SIZE_MAX;
+	while ((max_size > T_CORE_FS_TRANSFER_SIZE_MIN) && ((int64_t)max_size > space_params->result)) {
+		max_size /= 4;
+	}
+
+	uint8_t* data = (uint8_t*)malloc((size_t)max_size);
+	TEST_ASSERT_NOT_NULL(data);
+	// The bounce buffer for large transfers is allocated on first use and kept
+	uint8_t* large_io_buffer = LLFS_large_io_buffer_take();
+	LLFS_large_io_buffer_release(large_io_buffer);
+	bool valid = true;
+
+	for (int32_t size = T_CORE_FS_TRANSFER_SIZE_MIN; valid && (size <= T_CORE_FS_TRANSFER_SIZE_MAX); size *= 4) {
+		if (size > max_size) {
+			UTIL_print_string("Sequential transfer of ");
+			UTIL_print_integer(size);
+			UTIL_print_string(" bytes skipped: not enough free space\n");
+			continue;
+		}
+		// Job IO buffer (the bounce buffer for large transfers is used by another job), bounce buffer for large
+		// transfers, in place
+		for (int32_t mode = 0; valid && (mode < 3); mode++) {
+			bool in_place = (mode == 2);
+			uint8_t* taken_buffer = NULL;
+			if (mode == 0) {
+				taken_buffer = LLFS_large_io_buffer_take();
+			}
+			else if ((mode == 1) && (large_io_buffer == NULL)) {
+				// No bounce buffer for large transfers
+				continue;
+			}
+			else {
+				// In place
+			}
+			T_CORE_FS_fill_pattern(data, 0, size);
+			int64_t write_time = T_CORE_FS_transfer_file(data, size, in_place, true);
+			(void)memset(data, 0, (size_t)size);
+			int64_t read_time = T_CORE_FS_transfer_file(data, size, in_place, false);
+			LLFS_large_io_buffer_release(taken_buffer);
+			for (int32_t position = 0; valid && (position < size); position++) {
+				valid = (data[position] == T_CORE_FS_pattern(position));
+			}
+			valid = valid && (write_time >= 0) && (read_time >= 0);
+			if (valid) {
+				UTIL_print_string("Sequential transfer of ");
+				UTIL_print_integer(size);
+				if (!in_place) {
+					UTIL_print_string(" bytes, copies of ");
+					UTIL_print_integer((mode == 0) ? FS_IO_BUFFER_SIZE : FS_LARGE_IO_BUFFER_SIZE);
+					UTIL_print_string(" bytes: write ");
+				} else {
+					UTIL_print_string(" bytes, in place: write ");
+				}
+				T_CORE_FS_print_throughput(size, write_time);
+				UTIL_print_string(", read ");
+				T_CORE_FS_print_throughput(size, read_time);
+				UTIL_print_string("\n");
+			}
+		}
+	}
+
+	free(data);
+	(void)T_CORE_FS_delete(T_CORE_FS_FILE_PATH);
+	TEST_ASSERT_MESSAGE(valid, "sequential transfer failed");
+}
+
+/**
+ * @brief Returns the path of the index-th file of the test directory. The path is overwritten by the next call.
+ */
+static const char* T_CORE_FS_directory_path(int32_t index)
+{
+	static char path[] = T_CORE_FS_DIRECTORY_PATH "/f000.txt";
+	const int32_t digits = (int32_t)sizeof(T_CORE_FS_DIRECTORY_PATH) + 1;
+	path[digits] = (char)('0' + ((index / 100) % 10));
+	path[digits + 1] = (char)('0' + ((index / 10) % 10));
+	path[digits + 2] = (char)('0' + (index % 10));
+	return path;
+}
+
+/**
+ * @brief Lists the test directory with one read directory action per entry, as LLFS_IMPL_read_directory() does.
+ *
+ * @return the number of entries, or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_list_names(void)
+{
+	int32_t directory_ID = T_CORE_FS_path_operation(LLFS_IMPL_open_directory_action, T_CORE_FS_DIRECTORY_PATH);
+	if (directory_ID == LLFS_NOK) {
+		return LLFS_NOK;
+	}
+
+	FS_read_directory_t* params = &T_CORE_FS_params.read_directory;
+	int32_t count = 0;
+	do {
+		params->directory_ID = directory_ID;
+		T_CORE_FS_execute(LLFS_IMPL_read_directory_action);
+		if (params->result == LLFS_OK) {
+			count++;
+		}
+	} while (params->result == LLFS_OK);
+
+	T_CORE_FS_params.close_directory.directory_ID = directory_ID;
+	T_CORE_FS_execute(LLFS_IMPL_close_directory_action);
+	return count;
+}
+
+/**
+ * @brief Lists the test directory with read directory entries actions, as LLFS_IMPL_read_directory_entries() does.
+ * Each entry must be a file of 1 byte.
+ *
+ * @param[in] pattern the glob pattern of the listed entries, empty to list all the entries.
+ * @param[out] call_count the number of read directory entries actions.
+ *
+ * @return the number of entries, or LLFS_NOK.
+ */
+static int32_t T_CORE_FS_list_entries(const char* pattern, int32_t* call_count)
+{
+	int32_t directory_ID = T_CORE_FS_path_operation(LLFS_IMPL_open_directory_action, T_CORE_FS_DIRECTORY_PATH);
+	if (directory_ID == LLFS_NOK) {
+		return LLFS_NOK;
+	}
+
+	FS_read_directory_entries_t* params = &T_CORE_FS_params.read_directory_entries;
+	int32_t count = 0;
+	*call_count = 0;
+	do {
+		params->directory_ID = directory_ID;
+		params->length = (int32_t)sizeof(params->buffer);
+		(void)strncpy((char*)params->pattern, pattern, FS_DIRECTORY_PATTERN_LENGTH);
+		T_CORE_FS_execute(LLFS_IMPL_read_directory_entries_action);
+		(*call_count)++;
+
+		int32_t offset = 0;
+		for (int32_t i = 0; (count != LLFS_NOK) && (i < params->result); i++) {
+			const uint8_t* entry = &params->buffer[offset];
+			int32_t name_length = (int32_t)entry[LLFS_DIRECTORY_ENTRY_NAME_LENGTH_OFFSET]
+					| ((int32_t)entry[LLFS_DIRECTORY_ENTRY_NAME_LENGTH_OFFSET + 1] << 8);
+			if ((entry[LLFS_DIRECTORY_ENTRY_FLAGS_OFFSET] != LLFS_STAT_FLAG_EXISTS)
+					|| (entry[LLFS_DIRECTORY_ENTRY_LENGTH_OFFSET] != 1U) || (name_length != 8)) {
+				count = LLFS_NOK;
+			} else {
+				count++;
+			}
+			offset += LLFS_DIRECTORY_ENTRY_NAME_OFFSET + name_length;
+		}
+		if (params->result < 0) {
+			count = LLFS_NOK;
+		}
+	} while ((count != LLFS_NOK) && (params->result > 0));
+
+	T_CORE_FS_params.close_directory.directory_ID = directory_ID;
+	T_CORE_FS_execute(LLFS_IMPL_close_directory_action);
+	return count;
+}
+
+static void T_CORE_FS_directory_benchmark(void)
+{
+	const int32_t entry_counts[] = { 10, 100, 500 };
+	int32_t file_count = 0;
+
+	(void)T_CORE_FS_path_operation(LLFS_IMPL_make_directory_action, T_CORE_FS_DIRECTORY_PATH);
+	for (size_t i = 0; i < (sizeof(entry_counts) / sizeof(entry_counts[0])); i++) {
+		int32_t entry_count = entry_counts[i];
+		int32_t call_count;
+		while (file_count < entry_count) {
+			TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_directory_path(file_count), "x"), "file write failed");
+			file_count++;
+		}
+
+		// The job round trips to the FS worker are not included: on the VM they add the same cost to each action
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		int32_t count = T_CORE_FS_list_names();
+		int64_t names_time = UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(entry_count, count);
+
+		start_time = UTIL_TIME_BASE_getTime();
+		count = T_CORE_FS_list_entries("", &call_count);
+		int64_t entries_time = UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(entry_count, count);
+
+		// One file out of ten matches, the case is ignored
+		int32_t filtered_call_count;
+		count = T_CORE_FS_list_entries("F*5.TXT", &filtered_call_count);
+		TEST_ASSERT_EQUAL_INT(entry_count / 10, count);
+
+		UTIL_print_string("Listing of ");
+		UTIL_print_integer(entry_count);
+		UTIL_print_string(" entries: ");
+		UTIL_print_integer((int32_t)names_time);
+		UTIL_print_string(" us with one read per entry, ");
+		UTIL_print_integer((int32_t)entries_time);
+		UTIL_print_string(" us with ");
+		UTIL_print_integer(call_count);
+		UTIL_print_string(" bulk read(s)\n");
+	}
+
+	for (int32_t i = 0; i < file_count; i++) {
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_directory_path(i)));
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_DIRECTORY_PATH));
+}
+
+/**
+ * @brief Prints the average time of an operation of the file system comparison benchmark.
+ */
+static void T_CORE_FS_print_operation_time(const char* operation, int32_t count, int64_t elapsed_time)
+{
+	UTIL_print_string(T_CORE_FS_NAME ", ");
+	UTIL_print_string(operation);
+	UTIL_print_string(": ");
+	UTIL_print_float((double)elapsed_time / (double)count);
+	UTIL_print_string(" us per operation\n");
+}
+
+/**
+ * @brief Appends small chunks to a file, each chunk is flushed to the media.
+ */
+static void T_CORE_FS_compare_appends(void)
+{
+	(void)T_CORE_FS_delete(T_CORE_FS_FILE_PATH);
+	int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_APPEND);
+	TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "open failed");
+
+	bool valid = true;
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int32_t i = 0; valid && (i < T_CORE_FS_COMPARE_COUNT); i++) {
+		T_CORE_FS_fill_pattern(T_CORE_FS_file_buffer, i * T_CORE_FS_COMPARE_LENGTH, T_CORE_FS_COMPARE_LENGTH);
+		valid = (T_CORE_FS_transfer(file_id, T_CORE_FS_file_buffer, T_CORE_FS_COMPARE_LENGTH, true) == T_CORE_FS_COMPARE_LENGTH);
+		T_CORE_FS_params.flush.file_id = file_id;
+		T_CORE_FS_execute(LLFS_File_IMPL_flush_action);
+		valid = valid && (T_CORE_FS_params.flush.result == LLFS_OK);
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+	TEST_ASSERT_MESSAGE(valid, "append failed");
+
+	file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ);
+	TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "open failed");
+	uint8_t expected[T_CORE_FS_COMPARE_LENGTH];
+	for (int32_t i = 0; valid && (i < T_CORE_FS_COMPARE_COUNT); i++) {
+		T_CORE_FS_fill_pattern(expected, i * T_CORE_FS_COMPARE_LENGTH, T_CORE_FS_COMPARE_LENGTH);
+		valid = (T_CORE_FS_transfer(file_id, T_CORE_FS_file_buffer, T_CORE_FS_COMPARE_LENGTH, false) == T_CORE_FS_COMPARE_LENGTH)
+				&& (memcmp(expected, T_CORE_FS_file_buffer, T_CORE_FS_COMPARE_LENGTH) == 0);
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+	TEST_ASSERT_MESSAGE(valid, "appended data differ");
+
+	T_CORE_FS_print_operation_time("flushed small append", T_CORE_FS_COMPARE_COUNT, elapsed_time);
+}
+
+/**
+ * @brief Reads small chunks at pseudo-random positions of a file.
+ */
+static void T_CORE_FS_compare_random_reads(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_pattern(T_CORE_FS_FILE_PATH, T_CORE_FS_COMPARE_FILE_SIZE), "file write failed");
+	int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ);
+	TEST_ASSERT_MESSAGE(file_id != LLFS_NOK, "open failed");
+
+	bool valid = true;
+	uint32_t random = 12345U;
+	uint8_t expected[T_CORE_FS_COMPARE_LENGTH];
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int32_t i = 0; valid && (i < T_CORE_FS_COMPARE_COUNT); i++) {
+		random = (random * 1103515245U) + 12345U;
+		int32_t position = (int32_t)((random >> 8) % (uint32_t)(T_CORE_FS_COMPARE_FILE_SIZE - T_CORE_FS_COMPARE_LENGTH));
+		T_CORE_FS_params.seek.file_id = file_id;
+		T_CORE_FS_params.seek.n = position;
+		// The seek action only sets the result on failure
+		T_CORE_FS_params.seek.result = LLFS_OK;
+		T_CORE_FS_execute(LLFS_File_IMPL_seek_action);
+		valid = (T_CORE_FS_params.seek.result == LLFS_OK)
+				&& (T_CORE_FS_transfer(file_id, T_CORE_FS_file_buffer, T_CORE_FS_COMPARE_LENGTH, false) == T_CORE_FS_COMPARE_LENGTH);
+		T_CORE_FS_fill_pattern(expected, position, T_CORE_FS_COMPARE_LENGTH);
+		valid = valid && (memcmp(expected, T_CORE_FS_file_buffer, T_CORE_FS_COMPARE_LENGTH) == 0);
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+	TEST_ASSERT_MESSAGE(valid, "random read failed");
+
+	T_CORE_FS_print_operation_time("small random read", T_CORE_FS_COMPARE_COUNT, elapsed_time);
+}
+
+/**
+ * @brief Creates, renames and deletes files in a directory.
+ */
+static void T_CORE_FS_compare_directory_operations(void)
+{
+	int64_t create_time = 0;
+	int64_t rename_time = 0;
+	int64_t delete_time = 0;
+
+	(void)T_CORE_FS_path_operation(LLFS_IMPL_make_directory_action, T_CORE_FS_DIRECTORY_PATH);
+	for (int32_t i = 0; i < T_CORE_FS_COMPARE_FILE_COUNT; i++) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		TEST_ASSERT_MESSAGE(T_CORE_FS_write_file(T_CORE_FS_directory_path(i), "x"), "file creation failed");
+		create_time += UTIL_TIME_BASE_getTime() - start_time;
+	}
+	for (int32_t i = 0; i < T_CORE_FS_COMPARE_FILE_COUNT; i++) {
+		FS_rename_to_t* params = &T_CORE_FS_params.rename_to;
+		(void)strncpy((char*)params->path, T_CORE_FS_directory_path(i), FS_PATH_LENGTH);
+		(void)strncpy((char*)params->new_path, T_CORE_FS_directory_path(i + T_CORE_FS_COMPARE_FILE_COUNT), FS_PATH_LENGTH);
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		T_CORE_FS_execute(LLFS_IMPL_rename_to_action);
+		rename_time += UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, params->result);
+	}
+	for (int32_t i = 0; i < T_CORE_FS_COMPARE_FILE_COUNT; i++) {
+		const char* path = T_CORE_FS_directory_path(i + T_CORE_FS_COMPARE_FILE_COUNT);
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		int32_t result = T_CORE_FS_delete(path);
+		delete_time += UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(LLFS_OK, result);
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_DIRECTORY_PATH));
+
+	T_CORE_FS_print_operation_time("file creation", T_CORE_FS_COMPARE_FILE_COUNT, create_time);
+	T_CORE_FS_print_operation_time("rename", T_CORE_FS_COMPARE_FILE_COUNT, rename_time);
+	T_CORE_FS_print_operation_time("delete", T_CORE_FS_COMPARE_FILE_COUNT, delete_time);
+}
+
+/**
+ * @brief Small appends, random reads and directory operations, to compare FatFs and LittleFS: the same test is built
+ * with and without FS_USE_LITTLEFS.
+ */
+static void T_CORE_FS_compare_benchmark(void)
+{
+	T_CORE_FS_compare_appends();
+	T_CORE_FS_compare_random_reads();
+	(void)T_CORE_FS_delete(T_CORE_FS_FILE_PATH);
+	T_CORE_FS_compare_directory_operations();
+}
+
+/**
+ * @brief Generates a resource image in T_CORE_FS_resource_image_data, as scripts/make_resource_image.py does. The
+ * data of the index-th resource is T_CORE_FS_pattern() from the position index * 1000.
+ *
+ * @return the size of the image in bytes.
+ */
+static uint32_t T_CORE_FS_make_resource_image(void)
+{
+	LLFS_resource_image_header_t header = { LLFS_RESOURCE_IMAGE_MAGIC, LLFS_RESOURCE_IMAGE_VERSION, T_CORE_FS_RESOURCE_COUNT, 0 };
+	uint32_t size = sizeof(header) + (T_CORE_FS_RESOURCE_COUNT * sizeof(LLFS_resource_image_entry_t));
+
+	(void)memset(T_CORE_FS_resource_image_data, 0, sizeof(T_CORE_FS_resource_image_data));
+	(void)memcpy(T_CORE_FS_resource_image_data, &header, sizeof(header));
+	for (int32_t i = 0; i < T_CORE_FS_RESOURCE_COUNT; i++) {
+		LLFS_resource_image_entry_t entry;
+		(void)memset(&entry, 0, sizeof(entry));
+		(void)strncpy(entry.name, T_CORE_FS_resource_names[i], LLFS_RESOURCE_NAME_LENGTH - 1);
+		size = (size + 3U) & ~3U;
+		entry.offset = size;
+		entry.length = T_CORE_FS_resource_lengths[i];
+		T_CORE_FS_fill_pattern(&T_CORE_FS_resource_image_data[size], i * 1000, (int32_t)entry.length);
+		size += entry.length;
+		(void)memcpy(&T_CORE_FS_resource_image_data[sizeof(header) + (i * sizeof(entry))], &entry, sizeof(entry));
+	}
+	return size;
+}
+
+/**
+ * @brief Writes a generated resource image to the resource image storage and maps it: only the range used by the
+ * image must be mapped. Overwrites the resource image of the board.
+ */
+static void T_CORE_FS_resource_image(void)
+{
+	LLFS_resource_image_t image;
+	const char* error_message = NULL;
+	uint8_t expected[1000];
+
+	uint32_t size = T_CORE_FS_make_resource_image();
+	TEST_ASSERT_MESSAGE(LLFS_resource_storage_size() >= size, "no resource image storage");
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, LLFS_resource_storage_write(T_CORE_FS_resource_image_data, size));
+
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, LLFS_resource_image_map(&image, &error_message));
+	TEST_ASSERT_EQUAL_INT(size, image.size);
+	TEST_ASSERT_EQUAL_INT(T_CORE_FS_RESOURCE_COUNT, image.count);
+	bool valid = true;
+	for (int32_t i = 0; i < T_CORE_FS_RESOURCE_COUNT; i++) {
+		int32_t resource_id = LLFS_resource_image_find(&image, T_CORE_FS_resource_names[i]);
+		const LLFS_resource_image_entry_t* entry = LLFS_resource_image_get_entry(&image, resource_id);
+		T_CORE_FS_fill_pattern(expected, i * 1000, (int32_t)T_CORE_FS_resource_lengths[i]);
+		valid = valid && (resource_id == i) && (entry != NULL) && (entry->length == T_CORE_FS_resource_lengths[i])
+				&& ((entry->offset % 4U) == 0U) && (memcmp(&image.data[entry->offset], expected, entry->length) == 0);
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, LLFS_resource_image_find(&image, "fonts/sans"));
+	TEST_ASSERT_MESSAGE(LLFS_resource_image_get_entry(&image, T_CORE_FS_RESOURCE_COUNT) == NULL, "invalid resource ID accepted");
+	LLFS_resource_image_unmap(&image);
+	TEST_ASSERT_MESSAGE(valid, "mapped resources differ");
+
+	// A resource after the end of the storage
+	LLFS_resource_image_entry_t* entries = (LLFS_resource_image_entry_t*)&T_CORE_FS_resource_image_data[sizeof(LLFS_resource_image_header_t)];
+	entries[1].length = LLFS_resource_storage_size();
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, LLFS_resource_storage_write(T_CORE_FS_resource_image_data, size));
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, LLFS_resource_image_map(&image, &error_message));
+	TEST_ASSERT_EQUAL_STRING("Invalid resource image", error_message);
+
+	// Not a resource image
+	T_CORE_FS_resource_image_data[0] = 0;
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, LLFS_resource_storage_write(T_CORE_FS_resource_image_data, size));
+	TEST_ASSERT_EQUAL_INT(LLFS_NOK, LLFS_resource_image_map(&image, &error_message));
+	TEST_ASSERT_MESSAGE(image.data == NULL, "invalid image mapped");
+}
+
+/**
+ * @brief Starts the FS workers of the tests on first use. The workers run with a higher priority than the test task,
+ * as the FS workers with the VM task.
+ *
+ * @return true if the workers are running.
+ */
+static bool T_CORE_FS_start_workers(void)
+{
+	if (!T_CORE_FS_workers_initialized) {
+		int32_t priority = (int32_t)uxTaskPriorityGet(NULL) + 1;
+		T_CORE_FS_workers_initialized = (MICROEJ_ASYNC_WORKER_initialize_tasks(&T_CORE_FS_copy_worker, (uint8_t*)"test_fs_copy",
+				T_CORE_FS_worker_stacks, 1, priority, OSAL_NO_AFFINITY) == MICROEJ_ASYNC_WORKER_OK)
+				&& (MICROEJ_ASYNC_WORKER_initialize_tasks(&T_CORE_FS_read_worker, (uint8_t*)"test_fs_read",
+				T_CORE_FS_worker_stacks, 1, priority, OSAL_NO_AFFINITY) == MICROEJ_ASYNC_WORKER_OK);
+	}
+	return T_CORE_FS_workers_initialized;
+}
+
+/**
+ * @brief Copies a chunk of the source file of the bulk copy, at the position given by the extent of the job.
+ * Executed by the copy worker.
+ */
+static void T_CORE_FS_copy_chunk_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	FS_extents_t* params = (FS_extents_t*)job->params;
+	int32_t length = params->lengths[0];
+	params->file_id = T_CORE_FS_copy_source;
+	LLFS_File_IMPL_read_extents_action(job);
+	if (params->result == length) {
+		params->file_id = T_CORE_FS_copy_destination;
+		LLFS_File_IMPL_write_extents_action(job);
+	}
+	if (params->result != length) {
+		T_CORE_FS_copy_errors++;
+	}
+	T_CORE_FS_copied_chunk_count++;
+}
+
+/**
+ * @brief Reads a few bytes of the pattern file at the position given by the extent of the job and checks them.
+ */
+static void T_CORE_FS_small_read_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	FS_extents_t* params = (FS_extents_t*)job->params;
+	LLFS_File_IMPL_read_extents_action(job);
+	bool valid = (params->result == params->lengths[0]);
+	for (int32_t i = 0; valid && (i < params->result); i++) {
+		valid = (params->data[i] == T_CORE_FS_pattern((int32_t)params->positions[0] + i));
+	}
+	T_CORE_FS_small_read_valid = valid;
+	T_CORE_FS_small_read_done = true;
+}
+
+/**
+ * @brief Waits for a free job of the given worker and allocates it, as the VM task does when no job is free.
+ *
+ * @return the job, or NULL on timeout.
+ */
+static MICROEJ_ASYNC_WORKER_job_t* T_CORE_FS_allocate_job(MICROEJ_ASYNC_WORKER_handle_t* async_worker)
+{
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (async_worker->free_jobs == NULL) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_FS_STRESS_TIMEOUT_US) {
+			return NULL;
+		}
+	}
+	return MICROEJ_ASYNC_WORKER_allocate_job(async_worker, NULL);
+}
+
+/**
+ * @brief Sets the parameters of a job that transfers one extent to or from the job IO buffer.
+ */
+static void T_CORE_FS_set_extent(MICROEJ_ASYNC_WORKER_job_t* job, int32_t file_id, int32_t position, int32_t length)
+{
+	FS_extents_t* params = (FS_extents_t*)job->params;
+	params->file_id = file_id;
+	params->data = params->buffer;
+	params->length = length;
+	params->count = 1;
+	params->positions[0] = position;
+	params->lengths[0] = length;
+}
+
+/**
+ * @brief Posts the next chunks of the bulk copy while less than T_CORE_FS_COPY_DEPTH chunks are queued and a job is
+ * free, as a Java thread copying a file with one stream per file keeps one job on each.
+ *
+ * @return the number of chunks posted since the beginning of the copy.
+ */
+static int32_t T_CORE_FS_post_copy_chunks(int32_t posted_chunk_count)
+{
+	while (((posted_chunk_count - T_CORE_FS_copied_chunk_count) < T_CORE_FS_COPY_DEPTH)
+			&& (T_CORE_FS_copy_worker.free_jobs != NULL)) {
+		MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&T_CORE_FS_copy_worker, NULL);
+		int32_t position = (posted_chunk_count * FS_IO_BUFFER_SIZE) % T_CORE_FS_COPY_SIZE;
+		T_CORE_FS_set_extent(job, T_CORE_FS_copy_source, position, FS_IO_BUFFER_SIZE);
+		if (MICROEJ_ASYNC_WORKER_async_exec_no_wait(&T_CORE_FS_copy_worker, job, T_CORE_FS_copy_chunk_action) != MICROEJ_ASYNC_WORKER_OK) {
+			T_CORE_FS_copy_errors++;
+			break;
+		}
+		posted_chunk_count++;
+	}
+	return posted_chunk_count;
+}
+
+static int T_CORE_FS_compare_latencies(const void* latency1, const void* latency2)
+{
+	int64_t difference = *(const int64_t*)latency1 - *(const int64_t*)latency2;
+	return (difference > 0) - (difference < 0);
+}
+
+/**
+ * @brief Reads a few bytes of the pattern file T_CORE_FS_STRESS_READ_COUNT times on the given worker, one read after
+ * the other as a single Java thread, and prints the latency of the reads from the allocation of their job to their
+ * end. When copy is true, the bulk copy runs on the copy worker during the reads.
+ *
+ * @return the number of chunks copied, or -1 if a read failed.
+ */
+static int32_t T_CORE_FS_small_reads(MICROEJ_ASYNC_WORKER_handle_t* async_worker, int32_t file_id, bool copy, const char* label)
+{
+	int32_t posted_chunk_count = 0;
+	bool valid = true;
+	T_CORE_FS_copied_chunk_count = 0;
+
+	for (int32_t i = 0; valid && (i < T_CORE_FS_STRESS_READ_COUNT); i++) {
+		if (copy) {
+			posted_chunk_count = T_CORE_FS_post_copy_chunks(posted_chunk_count);
+		}
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		MICROEJ_ASYNC_WORKER_job_t* job = T_CORE_FS_allocate_job(async_worker);
+		if (job == NULL) {
+			valid = false;
+			break;
+		}
+		// Positions spread over the file, not aligned on the sectors
+		int32_t position = ((i * 997) % ((T_CORE_FS_BYTE_FILE_SIZE / T_CORE_FS_STRESS_READ_LENGTH) - 1)) * T_CORE_FS_STRESS_READ_LENGTH;
+		T_CORE_FS_set_extent(job, file_id, position + (i % 7), T_CORE_FS_STRESS_READ_LENGTH);
+		T_CORE_FS_small_read_done = false;
+		valid = (MICROEJ_ASYNC_WORKER_async_exec_no_wait(async_worker, job, T_CORE_FS_small_read_action) == MICROEJ_ASYNC_WORKER_OK);
+		while (valid && !T_CORE_FS_small_read_done) {
+			if (copy) {
+				posted_chunk_count = T_CORE_FS_post_copy_chunks(posted_chunk_count);
+			}
+			valid = ((UTIL_TIME_BASE_getTime() - start_time) <= T_CORE_FS_STRESS_TIMEOUT_US);
+		}
+		T_CORE_FS_small_read_latencies[i] = UTIL_TIME_BASE_getTime() - start_time;
+		valid = valid && T_CORE_FS_small_read_valid;
+	}
+
+	// Wait for the last chunks of the copy
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (T_CORE_FS_copied_chunk_count != posted_chunk_count) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_FS_STRESS_TIMEOUT_US) {
+			valid = false;
+			break;
+		}
+	}
+
+	if (valid) {
+		qsort(T_CORE_FS_small_read_latencies, T_CORE_FS_STRESS_READ_COUNT, sizeof(int64_t), T_CORE_FS_compare_latencies);
+		UTIL_print_string("Reads of ");
+		UTIL_print_integer(T_CORE_FS_STRESS_READ_LENGTH);
+		UTIL_print_string(" bytes, ");
+		UTIL_print_string(label);
+		UTIL_print_string(": median ");
+		UTIL_print_integer((int32_t)T_CORE_FS_small_read_latencies[T_CORE_FS_STRESS_READ_COUNT / 2]);
+		UTIL_print_string(" us, 99th percentile ");
+		UTIL_print_integer((int32_t)T_CORE_FS_small_read_latencies[(T_CORE_FS_STRESS_READ_COUNT * 99) / 100]);
+		UTIL_print_string(" us, max ");
+		UTIL_print_integer((int32_t)T_CORE_FS_small_read_latencies[T_CORE_FS_STRESS_READ_COUNT - 1]);
+		UTIL_print_string(" us");
+		if (copy) {
+			UTIL_print_string(", ");
+			UTIL_print_integer(posted_chunk_count);
+			UTIL_print_string(" chunks copied");
+		}
+		UTIL_print_string("\n");
+	}
+	return valid ? posted_chunk_count : -1;
+}
+
+/*
+ * The small reads are executed by the same worker as the bulk copy, as with a single FS worker, then by another worker,
+ * as when the pool of FS workers (FS_WORKER_COUNT) runs the operations on different files in parallel. The workers run
+ * with a higher priority than the test task, as the FS workers with the VM task. The accesses to the volume are
+ * serialized by the file system: a read on another worker only waits for the current chunk, not for the queued ones.
+ */
+static void T_CORE_FS_small_reads_stress(void)
+{
+	TEST_ASSERT_MESSAGE(T_CORE_FS_start_workers(), "FS workers start failed");
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_pattern(T_CORE_FS_FILE_PATH, T_CORE_FS_BYTE_FILE_SIZE), "file write failed");
+	TEST_ASSERT_MESSAGE(T_CORE_FS_write_pattern(T_CORE_FS_COPY_SOURCE_PATH, T_CORE_FS_COPY_SIZE), "file write failed");
+	int32_t file_id = T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ);
+	T_CORE_FS_copy_source = T_CORE_FS_open(T_CORE_FS_COPY_SOURCE_PATH, LLFS_FILE_MODE_READ);
+	T_CORE_FS_copy_destination = T_CORE_FS_open(T_CORE_FS_COPY_PATH, LLFS_FILE_MODE_WRITE);
+	TEST_ASSERT_MESSAGE((file_id != LLFS_NOK) && (T_CORE_FS_copy_source != LLFS_NOK) && (T_CORE_FS_copy_destination != LLFS_NOK), "open failed");
+	T_CORE_FS_copy_errors = 0;
+
+	bool valid = (T_CORE_FS_small_reads(&T_CORE_FS_read_worker, file_id, false, "idle") >= 0);
+	int32_t chunk_count = T_CORE_FS_small_reads(&T_CORE_FS_copy_worker, file_id, true, "bulk copy on the same worker");
+	valid = valid && (chunk_count >= 0);
+	int32_t other_chunk_count = T_CORE_FS_small_reads(&T_CORE_FS_read_worker, file_id, true, "bulk copy on another worker");
+	valid = valid && (other_chunk_count >= 0);
+	if (other_chunk_count > chunk_count) {
+		chunk_count = other_chunk_count;
+	}
+
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(file_id));
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(T_CORE_FS_copy_source));
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(T_CORE_FS_copy_destination));
+	TEST_ASSERT_MESSAGE(valid, "small read failed");
+	TEST_ASSERT_EQUAL_INT(0, T_CORE_FS_copy_errors);
+
+	// The copied chunks must not have been affected by the concurrent reads
+	int32_t copy_size = chunk_count * FS_IO_BUFFER_SIZE;
+	if (copy_size > T_CORE_FS_COPY_SIZE) {
+		copy_size = T_CORE_FS_COPY_SIZE;
+	}
+	int32_t copy_id = T_CORE_FS_open(T_CORE_FS_COPY_PATH, LLFS_FILE_MODE_READ);
+	TEST_ASSERT_MESSAGE(copy_id != LLFS_NOK, "open failed");
+	for (int32_t position = 0; valid && (position < copy_size); position += FS_FILE_BUFFER_SIZE) {
+		valid = (T_CORE_FS_transfer(copy_id, T_CORE_FS_file_buffer, FS_FILE_BUFFER_SIZE, false) == FS_FILE_BUFFER_SIZE);
+		for (int32_t i = 0; valid && (i < FS_FILE_BUFFER_SIZE); i++) {
+			valid = (T_CORE_FS_file_buffer[i] == T_CORE_FS_pattern(position + i));
+		}
+	}
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_close(copy_id));
+	TEST_ASSERT_MESSAGE(valid, "bulk copy corrupted");
+
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_COPY_PATH));
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_COPY_SOURCE_PATH));
+	TEST_ASSERT_EQUAL_INT(LLFS_OK, T_CORE_FS_delete(T_CORE_FS_FILE_PATH));
+}
+
+/**
+ * @brief Closes a file, executed by the read worker in parallel with a modification.
+ */
+static void T_CORE_FS_race_close_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	LLFS_File_IMPL_close_action(job);
+	T_CORE_FS_race_close_result = ((FS_close_t*)job->params)->result;
+	T_CORE_FS_race_close_done = true;
+}
+
+/**
+ * @brief Renames a file, executed by the copy worker in parallel with a close.
+ */
+static void T_CORE_FS_race_rename_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	LLFS_IMPL_rename_to_action(job);
+	T_CORE_FS_race_modification_result = ((FS_rename_to_t*)job->params)->result;
+	T_CORE_FS_race_modification_done = true;
+}
+
+/**
+ * @brief Deletes a file, executed by the copy worker in parallel with a close.
+ */
+static void T_CORE_FS_race_delete_action(MICROEJ_ASYNC_WORKER_job_t* job)
+{
+	LLFS_IMPL_delete_action(job);
+	T_CORE_FS_race_modification_result = ((FS_path_operation_t*)job->params)->result;
+	T_CORE_FS_race_modification_done = true;
+}
+
+/**
+ * @brief Reads a file, then closes it on the read worker while the copy worker renames or deletes it. Both jobs are
+ * held by the pool lock until both are posted, so the close reaches the open cache during the modification. The
+ * modification fails if the file is not closed yet: it is then retried once the close is done, and must succeed.
+ * The old path must then not be opened from a file kept open.
+ *
+ * @return true if the close and the modification succeeded and no stale file has been found.
+ */
+static bool T_CORE_FS_race_close(bool rename, int32_t* retry_count)
+{
+	if (!T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, T_CORE_FS_RACE_CONTENT)) {
+		return false;
+	}
+	int32_t file_id = T_CORE_FS_open_and_check(T_CORE_FS_FILE_PATH, T_CORE_FS_RACE_CONTENT);
+	MICROEJ_ASYNC_WORKER_job_t* close_job = T_CORE_FS_allocate_job(&T_CORE_FS_read_worker);
+	MICROEJ_ASYNC_WORKER_job_t* modification_job = T_CORE_FS_allocate_job(&T_CORE_FS_copy_worker);
+	if ((file_id == LLFS_NOK) || (close_job == NULL) || (modification_job == NULL)) {
+		return false;
+	}
+	((FS_worker_param_t*)close_job->params)->close.file_id = file_id;
+	FS_worker_param_t* modification_params = (FS_worker_param_t*)modification_job->params;
+	if (rename) {
+		(void)strncpy((char*)modification_params->rename_to.path, T_CORE_FS_FILE_PATH, FS_PATH_LENGTH);
+		(void)strncpy((char*)modification_params->rename_to.new_path, T_CORE_FS_RENAMED_PATH, FS_PATH_LENGTH);
+	} else {
+		(void)strncpy((char*)modification_params->path_operation.path, T_CORE_FS_FILE_PATH, FS_PATH_LENGTH);
+	}
+	T_CORE_FS_race_close_done = false;
+	T_CORE_FS_race_modification_done = false;
+
+	LLFS_pool_lock();
+	bool valid = (MICROEJ_ASYNC_WORKER_async_exec_no_wait(&T_CORE_FS_copy_worker, modification_job,
+			rename ? T_CORE_FS_race_rename_action : T_CORE_FS_race_delete_action) == MICROEJ_ASYNC_WORKER_OK)
+			&& (MICROEJ_ASYNC_WORKER_async_exec_no_wait(&T_CORE_FS_read_worker, close_job, T_CORE_FS_race_close_action) == MICROEJ_ASYNC_WORKER_OK);
+	LLFS_pool_unlock();
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (valid && !(T_CORE_FS_race_close_done && T_CORE_FS_race_modification_done)) {
+		valid = ((UTIL_TIME_BASE_getTime() - start_time) <= T_CORE_FS_STRESS_TIMEOUT_US);
+	}
+	if (!valid || (T_CORE_FS_race_close_result != LLFS_OK)) {
+		return false;
+	}
+
+	int32_t result = T_CORE_FS_race_modification_result;
+	if (result != LLFS_OK) {
+		// The file was still open: now that it is closed, it must not be locked by a kept file
+		(*retry_count)++;
+		if (rename) {
+			(void)strncpy((char*)T_CORE_FS_params.rename_to.path, T_CORE_FS_FILE_PATH, FS_PATH_LENGTH);
+			(void)strncpy((char*)T_CORE_FS_params.rename_to.new_path, T_CORE_FS_RENAMED_PATH, FS_PATH_LENGTH);
+			T_CORE_FS_execute(LLFS_IMPL_rename_to_action);
+			result = T_CORE_FS_params.rename_to.result;
+		} else {
+			result = T_CORE_FS_delete(T_CORE_FS_FILE_PATH);
+		}
+	}
+	valid = (result == LLFS_OK) && (T_CORE_FS_open(T_CORE_FS_FILE_PATH, LLFS_FILE_MODE_READ) == LLFS_NOK);
+	if (rename) {
+		valid = valid && T_CORE_FS_check_file(T_CORE_FS_RENAMED_PATH, T_CORE_FS_RACE_CONTENT)
+				&& (T_CORE_FS_delete(T_CORE_FS_RENAMED_PATH) == LLFS_OK);
+	}
+	// A new file on the old path must not be read from a file kept open
+	return valid && T_CORE_FS_write_file(T_CORE_FS_FILE_PATH, T_CORE_FS_FILE_PATH)
+			&& T_CORE_FS_check_file(T_CORE_FS_FILE_PATH, T_CORE_FS_FILE_PATH) && (T_CORE_FS_delete(T_CORE_FS_FILE_PATH) == LLFS_OK);
+}
+
+/*
+ * The close of a file open for reading and a modification of the same file are run in parallel by two FS workers, as
+ * when a Java thread closes a stream while another one renames or deletes the file.
+ */
+static void T_CORE_FS_close_during_modification(void)
+{
+	int32_t retry_count = 0;
+	TEST_ASSERT_MESSAGE(T_CORE_FS_start_workers(), "FS workers start failed");
+	for (int32_t i = 0; i < T_CORE_FS_RACE_COUNT; i++) {
+		TEST_ASSERT_MESSAGE(T_CORE_FS_race_close(true, &retry_count), "rename during a close failed");
+		TEST_ASSERT_MESSAGE(T_CORE_FS_race_close(false, &retry_count), "delete during a close failed");
+	}
+	UTIL_print_string("Modifications retried after the close: ");
+	UTIL_print_integer(retry_count);
+	UTIL_print_string(" of ");
+	UTIL_print_integer(2 * T_CORE_FS_RACE_COUNT);
+	UTIL_print_string("\n");
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_FS_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Append log recovery", T_CORE_FS_log_recovery),
+		new_TestFixture("Append log torn tails", T_CORE_FS_log_torn_tails),
+		new_TestFixture("Append log corrupted record", T_CORE_FS_log_corruption),
+		new_TestFixture("File that is not an append log", T_CORE_FS_log_not_a_log),
+		new_TestFixture("Append log benchmark", T_CORE_FS_log_benchmark),
+		new_TestFixture("Reopen of a file", T_CORE_FS_reopen),
+		new_TestFixture("Reopen of a modified file", T_CORE_FS_reopen_after_modification),
+#ifndef FS_USE_LITTLEFS
+		new_TestFixture("Open of all the files with kept files", T_CORE_FS_open_cache_exhaustion),
+#endif
+		new_TestFixture("Reopen benchmark", T_CORE_FS_reopen_benchmark),
+		new_TestFixture("Byte-wise read benchmark", T_CORE_FS_read_byte_benchmark),
+		new_TestFixture("Sequential transfer benchmark", T_CORE_FS_transfer_benchmark),
+		new_TestFixture("Directory listing benchmark", T_CORE_FS_directory_benchmark),
+		new_TestFixture("Small read latency during a bulk copy", T_CORE_FS_small_reads_stress),
+		new_TestFixture("Close during a rename or a delete", T_CORE_FS_close_during_modification),
+		new_TestFixture("File system comparison benchmark", T_CORE_FS_compare_benchmark),
+		new_TestFixture("Resource image", T_CORE_FS_resource_image),
+	};
+	UTIL_print_string("\nFile system tests:\n");
+	EMB_UNIT_TESTCALLER(fsTest, "FS_tests", T_CORE_FS_setUp, T_CORE_FS_tearDown, fixtures);
+
+	return (TestRef)&fsTest;
+}
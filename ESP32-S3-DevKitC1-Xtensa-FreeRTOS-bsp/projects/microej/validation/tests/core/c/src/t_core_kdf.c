@@ -0,0 +1,272 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mbedtls/md.h"
+#include "mbedtls/hkdf.h"
+
+#include "LLSEC_configuration.h"
+#include "LLSEC_SECRET_KEY_FACTORY_helper.h"
+#include "LLSEC_worker.h"
+
+/* Private constant declarations */
+
+#define T_CORE_KDF_MAX_OUTPUT_SIZE	(64)
+#define T_CORE_KDF_TIMEOUT_US		(10000000)
+#define T_CORE_KDF_BENCHMARK_ITERATIONS	(4096)
+
+/* Private structure declarations */
+
+typedef struct {
+	mbedtls_md_type_t md_type;
+	const char* ikm;
+	size_t ikm_length;
+	const uint8_t* salt;
+	size_t salt_length;
+	const uint8_t* info;
+	size_t info_length;
+	const char* prk;
+	const char* okm;
+} T_CORE_KDF_hkdf_vector_t;
+
+typedef struct {
+	const char* password;
+	size_t password_length;
+	const char* salt;
+	size_t salt_length;
+	unsigned int iterations;
+	const char* dk;
+} T_CORE_KDF_pbkdf2_vector_t;
+
+/* Private variable definitions */
+
+static const uint8_t T_CORE_KDF_hkdf_salt[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c
+};
+
+static const uint8_t T_CORE_KDF_hkdf_info[] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9
+};
+
+static const char T_CORE_KDF_hkdf_ikm[] =
+	"\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b";
+
+/* RFC 5869, appendix A: test cases 1 (SHA-256), 3 (SHA-256, empty salt and info) and 4 (SHA-1) */
+static const T_CORE_KDF_hkdf_vector_t T_CORE_KDF_hkdf_vectors[] = {
+	{
+		MBEDTLS_MD_SHA256, T_CORE_KDF_hkdf_ikm, 22,
+		T_CORE_KDF_hkdf_salt, sizeof(T_CORE_KDF_hkdf_salt), T_CORE_KDF_hkdf_info, sizeof(T_CORE_KDF_hkdf_info),
+		"077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+		"3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"
+	},
+	{
+		MBEDTLS_MD_SHA256, T_CORE_KDF_hkdf_ikm, 22,
+		NULL, 0, NULL, 0,
+		"19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+		"8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"
+	},
+	{
+		MBEDTLS_MD_SHA1, T_CORE_KDF_hkdf_ikm, 11,
+		T_CORE_KDF_hkdf_salt, sizeof(T_CORE_KDF_hkdf_salt), T_CORE_KDF_hkdf_info, sizeof(T_CORE_KDF_hkdf_info),
+		"9b6c18c432a7bf8f0e71c8eb88f4b30baa2ba243",
+		"085a01ea1b10f36933068b56efa5ad81a4f14b822f5b091568a9cdd4f155fda2c22e422478d305f3f896"
+	},
+};
+
+/* RFC 6070: PBKDF2 HMAC-SHA1 test vectors (the 16777216 iterations vector is skipped) */
+static const T_CORE_KDF_pbkdf2_vector_t T_CORE_KDF_pbkdf2_vectors[] = {
+	{ "password", 8, "salt", 4, 1, "0c60c80f961f0e71f3a9b524af6012062fe037a6" },
+	{ "password", 8, "salt", 4, 2, "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957" },
+	{ "password", 8, "salt", 4, 4096, "4b007901b765489abead49d926f721d065a429c1" },
+	{ "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038" },
+	{ "pass\0word", 9, "sa\0lt", 5, 4096, "56fa6aa75548099dcc37d7f03425e0c3" },
+};
+
+/* Private function definitions */
+
+/**
+ * @brief Decodes a hexadecimal string, returns the number of bytes.
+ */
+static size_t T_CORE_KDF_from_hex(const char* hex, uint8_t* output)
+{
+	size_t length = strlen(hex) / 2;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t byte = 0;
+		for (int j = 0; j < 2; j++) {
+			char c = hex[(2 * i) + j];
+			byte <<= 4;
+			if ((c >= '0') && (c <= '9')) {
+				byte |= (uint8_t)(c - '0');
+			} else {
+				byte |= (uint8_t)(c - 'a' + 10);
+			}
+		}
+		output[i] = byte;
+	}
+	return length;
+}
+
+static void T_CORE_KDF_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+}
+
+static void T_CORE_KDF_tearDown(void)
+{
+}
+
+/*
+ * Same calls as LLSEC_SECRET_KEY_FACTORY_IMPL_hkdf_extract/expand, which cannot be linked without the VM (SNI).
+ * This also checks that MBEDTLS_HKDF_C is enabled by microej_mbedtls_config.h.
+ */
+static void T_CORE_KDF_hkdf_rfc5869(void)
+{
+	uint8_t expected[T_CORE_KDF_MAX_OUTPUT_SIZE];
+	uint8_t output[T_CORE_KDF_MAX_OUTPUT_SIZE];
+
+	for (size_t i = 0; i < (sizeof(T_CORE_KDF_hkdf_vectors) / sizeof(T_CORE_KDF_hkdf_vectors[0])); i++) {
+		const T_CORE_KDF_hkdf_vector_t* vector = &T_CORE_KDF_hkdf_vectors[i];
+		const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(vector->md_type);
+		TEST_ASSERT_NOT_NULL(md_info);
+
+		uint8_t prk[MBEDTLS_MD_MAX_SIZE];
+		size_t prk_length = T_CORE_KDF_from_hex(vector->prk, expected);
+		TEST_ASSERT_EQUAL_INT(0, mbedtls_hkdf_extract(md_info, vector->salt, vector->salt_length,
+				(const unsigned char*)vector->ikm, vector->ikm_length, prk));
+		TEST_ASSERT_EQUAL_INT((int)prk_length, (int)mbedtls_md_get_size(md_info));
+		TEST_ASSERT_MESSAGE(0 == memcmp(expected, prk, prk_length), "HKDF-Extract: wrong PRK");
+
+		size_t okm_length = T_CORE_KDF_from_hex(vector->okm, expected);
+		TEST_ASSERT_EQUAL_INT(0, mbedtls_hkdf_expand(md_info, prk, prk_length, vector->info, vector->info_length,
+				output, okm_length));
+		TEST_ASSERT_MESSAGE(0 == memcmp(expected, output, okm_length), "HKDF-Expand: wrong OKM");
+	}
+}
+
+static void T_CORE_KDF_pbkdf2_rfc6070(void)
+{
+	uint8_t expected[T_CORE_KDF_MAX_OUTPUT_SIZE];
+	uint8_t output[T_CORE_KDF_MAX_OUTPUT_SIZE];
+
+	for (size_t i = 0; i < (sizeof(T_CORE_KDF_pbkdf2_vectors) / sizeof(T_CORE_KDF_pbkdf2_vectors[0])); i++) {
+		const T_CORE_KDF_pbkdf2_vector_t* vector = &T_CORE_KDF_pbkdf2_vectors[i];
+		size_t dk_length = T_CORE_KDF_from_hex(vector->dk, expected);
+
+		int rc = LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(MBEDTLS_MD_SHA1,
+				(const uint8_t*)vector->password, (int32_t)vector->password_length,
+				(const uint8_t*)vector->salt, (int32_t)vector->salt_length,
+				(int32_t)vector->iterations, output, (int32_t)dk_length);
+
+		TEST_ASSERT_EQUAL_INT(0, rc);
+		TEST_ASSERT_MESSAGE(0 == memcmp(expected, output, dk_length), "PBKDF2: wrong derived key");
+	}
+}
+
+static uint32_t T_CORE_KDF_executed_job_count(void)
+{
+	MICROEJ_ASYNC_WORKER_statistics_t statistics;
+	MICROEJ_ASYNC_WORKER_get_statistics(&llsec_worker, &statistics, false);
+	return statistics.executed_job_count;
+}
+
+/*
+ * Runs a derivation of LLSEC_SECRET_KEY_FACTORY_ASYNC_ITERATIONS iterations or more, as the secret key factory does,
+ * by the security worker. The job does not wait: no Java thread is suspended and the worker releases the job.
+ */
+static void T_CORE_KDF_pbkdf2_worker(void)
+{
+	const T_CORE_KDF_pbkdf2_vector_t* vector = &T_CORE_KDF_pbkdf2_vectors[3];
+	uint8_t expected[T_CORE_KDF_MAX_OUTPUT_SIZE];
+	uint8_t output[T_CORE_KDF_MAX_OUTPUT_SIZE];
+	size_t dk_length = T_CORE_KDF_from_hex(vector->dk, expected);
+	LLSEC_secret_key secret_key = { .key = output, .key_length = (int32_t)dk_length };
+
+	TEST_ASSERT_MESSAGE((int32_t)vector->iterations >= LLSEC_SECRET_KEY_FACTORY_ASYNC_ITERATIONS, "vector not derived by the worker");
+	TEST_ASSERT_EQUAL_INT(LLSEC_SUCCESS, llsec_worker_start());
+	uint32_t executed_job_count = T_CORE_KDF_executed_job_count();
+
+	// A free job is available: the worker does not suspend the current Java thread
+	MICROEJ_ASYNC_WORKER_job_t* job = MICROEJ_ASYNC_WORKER_allocate_job(&llsec_worker, NULL);
+	TEST_ASSERT_NOT_NULL(job);
+	LLSEC_SECRET_KEY_FACTORY_pbkdf2_param_t* params = &((LLSEC_worker_param_t*)job->params)->pbkdf2;
+	params->secret_key = &secret_key;
+	params->md_type = MBEDTLS_MD_SHA1;
+	params->password = (uint8_t*)vector->password;
+	params->password_length = (int32_t)vector->password_length;
+	params->salt = (uint8_t*)vector->salt;
+	params->salt_length = (int32_t)vector->salt_length;
+	params->iterations = (int32_t)vector->iterations;
+	(void)memset(output, 0, sizeof(output));
+	TEST_ASSERT_EQUAL_INT(MICROEJ_ASYNC_WORKER_OK, MICROEJ_ASYNC_WORKER_async_exec_no_wait(&llsec_worker, job, LLSEC_SECRET_KEY_FACTORY_PBKDF2_action));
+
+	// The job may already be released: only the key and the statistics are read
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	while (T_CORE_KDF_executed_job_count() == executed_job_count) {
+		if ((UTIL_TIME_BASE_getTime() - start_time) > T_CORE_KDF_TIMEOUT_US) {
+			TEST_FAIL("derivation not done by the security worker");
+		}
+		vTaskDelay(1);
+	}
+	TEST_ASSERT_MESSAGE(0 == memcmp(expected, output, dk_length), "PBKDF2 in the security worker: wrong derived key");
+}
+
+/*
+ * Prints the number of PBKDF2 iterations per second for the digests of the secret key factory: it sets the time a
+ * Java thread waits for a key of a given strength.
+ */
+static void T_CORE_KDF_pbkdf2_benchmark(void)
+{
+	static const struct {
+		const char* name;
+		mbedtls_md_type_t md_type;
+	} digests[] = {
+		{ "SHA-1", MBEDTLS_MD_SHA1 },
+		{ "SHA-256", MBEDTLS_MD_SHA256 },
+		{ "SHA-512", MBEDTLS_MD_SHA512 },
+	};
+	uint8_t output[32];
+
+	for (size_t i = 0; i < (sizeof(digests) / sizeof(digests[0])); i++) {
+		int64_t start_time = UTIL_TIME_BASE_getTime();
+		int rc = LLSEC_SECRET_KEY_FACTORY_PBKDF2_mbedtls_derive(digests[i].md_type, (const uint8_t*)"password", 8,
+				(const uint8_t*)"salt", 4, T_CORE_KDF_BENCHMARK_ITERATIONS, output, (int32_t)sizeof(output));
+		int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+		TEST_ASSERT_EQUAL_INT(0, rc);
+
+		UTIL_print_string("PBKDF2 HMAC-");
+		UTIL_print_string(digests[i].name);
+		UTIL_print_string(": ");
+		if (elapsed_time > 0) {
+			UTIL_print_integer((int)(((int64_t)T_CORE_KDF_BENCHMARK_ITERATIONS * 1000000) / elapsed_time));
+		} else {
+			UTIL_print_string("-");
+		}
+		UTIL_print_string(" iterations/s\n");
+	}
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_KDF_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("HKDF known answers (RFC 5869)", T_CORE_KDF_hkdf_rfc5869),
+		new_TestFixture("PBKDF2 known answers (RFC 6070)", T_CORE_KDF_pbkdf2_rfc6070),
+		new_TestFixture("PBKDF2 in the security worker", T_CORE_KDF_pbkdf2_worker),
+		new_TestFixture("PBKDF2 iterations per second", T_CORE_KDF_pbkdf2_benchmark),
+	};
+	UTIL_print_string("\nKey derivation tests:\n");
+	EMB_UNIT_TESTCALLER(kdfTest, "KDF_tests", T_CORE_KDF_setUp, T_CORE_KDF_tearDown, fixtures);
+
+	return (TestRef)&kdfTest;
+}
@@ -11,6 +11,14 @@
 #include "t_core_time_base.h"
 #include "t_core_ram.h"
 #include "t_core_core_benchmark.h"
+#include "t_core_kdf.h"
+#include "t_core_pool.h"
+#include "t_core_allocator.h"
+#include "t_core_async_worker.h"
+#include "t_core_fs.h"
+#include "t_core_x509.h"
+#include "t_core_ecc.h"
+#include "t_core_rsa.h"
 
 
 
@@ -21,6 +29,14 @@ void T_CORE_main(void) {
 	TestRunner_runTest(T_CORE_RAM_tests());
 	TestRunner_runTest(T_CORE_RAM_speed_tests());
 	TestRunner_runTest(T_CORE_COREBENCH_tests());
+	TestRunner_runTest(T_CORE_KDF_tests());
+	TestRunner_runTest(T_CORE_POOL_tests());
+	TestRunner_runTest(T_CORE_ALLOCATOR_tests());
+	TestRunner_runTest(T_CORE_ASYNC_WORKER_tests());
+	TestRunner_runTest(T_CORE_FS_tests());
+	TestRunner_runTest(T_CORE_X509_tests());
+	TestRunner_runTest(T_CORE_ECC_tests());
+	TestRunner_runTest(T_CORE_RSA_tests());
 	TestRunner_end();
 	return;
 }
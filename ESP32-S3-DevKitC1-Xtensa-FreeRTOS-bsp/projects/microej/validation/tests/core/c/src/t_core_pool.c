@@ -0,0 +1,206 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "microej_pool.h"
+
+/* Private constant declarations */
+
+#define T_CORE_POOL_SIZE			(8)
+#define T_CORE_POOL_BENCH_SIZE		(64)
+#define T_CORE_POOL_BENCH_LOOPS		(100000)
+
+/* Private structure declarations */
+
+typedef struct {
+	int id;
+	char payload[20];
+} T_CORE_POOL_item_t;
+
+/* Private variable definitions */
+
+POOL_declare(T_CORE_POOL_items, T_CORE_POOL_item_t, T_CORE_POOL_SIZE);
+POOL_declare(T_CORE_POOL_bytes, char, T_CORE_POOL_SIZE);
+POOL_declare(T_CORE_POOL_bench, T_CORE_POOL_item_t, T_CORE_POOL_BENCH_SIZE);
+
+/* Private function definitions */
+
+/**
+ * @brief Puts a pool back in its initial state, as declared by POOL_declare.
+ */
+static void T_CORE_POOL_reset(POOL_ctx_t* pool)
+{
+	(void)memset(pool->puc_item_status, 0, pool->uc_num_item_in_pool * sizeof(POOL_item_status_t));
+	(void)memset(&pool->st_internal, 0, sizeof(POOL_internal_t));
+}
+
+/**
+ * @brief Reserves all the items of a pool, checks that they are distinct and that the next reservation fails.
+ */
+static void T_CORE_POOL_fill(POOL_ctx_t* pool, void** items)
+{
+	for (unsigned int i = 0; i < pool->uc_num_item_in_pool; i++) {
+		items[i] = NULL;
+		TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_reserve_f(pool, &items[i]));
+		TEST_ASSERT_NOT_NULL(items[i]);
+		for (unsigned int j = 0; j < i; j++) {
+			TEST_ASSERT_MESSAGE(items[i] != items[j], "the same item is reserved twice");
+		}
+	}
+
+	void* item = NULL;
+	TEST_ASSERT_EQUAL_INT(POOL_NO_SPACE_AVAILABLE, POOL_reserve_f(pool, &item));
+	TEST_ASSERT_NULL(item);
+}
+
+static bool T_CORE_POOL_has_id(void* item, void* id)
+{
+	return ((T_CORE_POOL_item_t*)item)->id == *(int*)id;
+}
+
+static void T_CORE_POOL_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+	T_CORE_POOL_reset(&T_CORE_POOL_items);
+	T_CORE_POOL_reset(&T_CORE_POOL_bytes);
+	T_CORE_POOL_reset(&T_CORE_POOL_bench);
+}
+
+static void T_CORE_POOL_tearDown(void)
+{
+}
+
+static void T_CORE_POOL_full(void)
+{
+	void* items[T_CORE_POOL_SIZE];
+	POOL_statistics_t statistics;
+
+	T_CORE_POOL_fill(&T_CORE_POOL_items, items);
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_get_statistics_f(&T_CORE_POOL_items, &statistics));
+	TEST_ASSERT_EQUAL_INT(T_CORE_POOL_SIZE, (int)statistics.ui_num_item_used);
+	TEST_ASSERT_EQUAL_INT(T_CORE_POOL_SIZE, (int)statistics.ui_high_water_mark);
+	TEST_ASSERT_EQUAL_INT(1, (int)statistics.ui_num_reserve_failed);
+
+	/* the freed item is the next one reserved */
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_items, items[3]));
+	void* item = NULL;
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_reserve_f(&T_CORE_POOL_items, &item));
+	TEST_ASSERT_MESSAGE(item == items[3], "the freed item is not reused");
+
+	for (unsigned int i = 0; i < T_CORE_POOL_SIZE; i++) {
+		TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_items, items[i]));
+	}
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_get_statistics_f(&T_CORE_POOL_items, &statistics));
+	TEST_ASSERT_EQUAL_INT(0, (int)statistics.ui_num_item_used);
+	TEST_ASSERT_EQUAL_INT(T_CORE_POOL_SIZE, (int)statistics.ui_high_water_mark);
+
+	/* all the items are available again */
+	T_CORE_POOL_fill(&T_CORE_POOL_items, items);
+}
+
+static void T_CORE_POOL_double_free(void)
+{
+	void* items[T_CORE_POOL_SIZE];
+	void* item = NULL;
+	POOL_statistics_t statistics;
+
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_reserve_f(&T_CORE_POOL_items, &item));
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_items, item));
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL, POOL_free_f(&T_CORE_POOL_items, item));
+
+	/* addresses that are not items of the pool */
+	T_CORE_POOL_item_t outside;
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL, POOL_free_f(&T_CORE_POOL_items, &outside));
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL, POOL_free_f(&T_CORE_POOL_items, (char*)item + 1));
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL,
+			POOL_free_f(&T_CORE_POOL_items, &T_CORE_POOL_items_pool_array[T_CORE_POOL_SIZE]));
+	TEST_ASSERT_EQUAL_INT(POOL_ERROR_IN_ENTRY_PARAMETERS, POOL_free_f(&T_CORE_POOL_items, NULL));
+
+	/* the free list is not corrupted: the pool still holds exactly T_CORE_POOL_SIZE distinct items */
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_get_statistics_f(&T_CORE_POOL_items, &statistics));
+	TEST_ASSERT_EQUAL_INT(0, (int)statistics.ui_num_item_used);
+	T_CORE_POOL_fill(&T_CORE_POOL_items, items);
+}
+
+static void T_CORE_POOL_get(void)
+{
+	void* items[T_CORE_POOL_SIZE];
+	void* item = NULL;
+
+	T_CORE_POOL_fill(&T_CORE_POOL_items, items);
+	for (int i = 0; i < T_CORE_POOL_SIZE; i++) {
+		((T_CORE_POOL_item_t*)items[i])->id = i;
+	}
+	int id = 5;
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_get_f(&T_CORE_POOL_items, &item, T_CORE_POOL_has_id, &id));
+	TEST_ASSERT_MESSAGE(item == items[5], "wrong item retrieved");
+
+	/* freed items are not compared */
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_items, items[5]));
+	item = NULL;
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL, POOL_get_f(&T_CORE_POOL_items, &item, T_CORE_POOL_has_id, &id));
+	TEST_ASSERT_NULL(item);
+}
+
+static void T_CORE_POOL_small_items(void)
+{
+	void* items[T_CORE_POOL_SIZE];
+	void* item = NULL;
+
+	/* items smaller than a pointer are not chained in a free list */
+	T_CORE_POOL_fill(&T_CORE_POOL_bytes, items);
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_bytes, items[2]));
+	TEST_ASSERT_EQUAL_INT(POOL_ITEM_NOT_FOUND_IN_POOL, POOL_free_f(&T_CORE_POOL_bytes, items[2]));
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_reserve_f(&T_CORE_POOL_bytes, &item));
+	TEST_ASSERT_MESSAGE(item == items[2], "the freed item is not reused");
+	item = NULL;
+	TEST_ASSERT_EQUAL_INT(POOL_NO_SPACE_AVAILABLE, POOL_reserve_f(&T_CORE_POOL_bytes, &item));
+}
+
+static void T_CORE_POOL_benchmark(void)
+{
+	void* items[T_CORE_POOL_BENCH_SIZE];
+	void* item = NULL;
+
+	/* keep all the items but the last one in use: a scan would visit the whole pool */
+	T_CORE_POOL_fill(&T_CORE_POOL_bench, items);
+	TEST_ASSERT_EQUAL_INT(POOL_NO_ERROR, POOL_free_f(&T_CORE_POOL_bench, items[T_CORE_POOL_BENCH_SIZE - 1]));
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	for (int i = 0; i < T_CORE_POOL_BENCH_LOOPS; i++) {
+		(void)POOL_reserve_f(&T_CORE_POOL_bench, &item);
+		(void)POOL_free_f(&T_CORE_POOL_bench, item);
+	}
+	int64_t elapsed_time = UTIL_TIME_BASE_getTime() - start_time;
+
+	TEST_ASSERT_MESSAGE(item == items[T_CORE_POOL_BENCH_SIZE - 1], "wrong item reserved");
+	UTIL_print_string("Pool reserve/free pair (");
+	UTIL_print_integer(T_CORE_POOL_BENCH_SIZE);
+	UTIL_print_string(" items, 1 free): ");
+	UTIL_print_float(((double)elapsed_time * 1000.0) / T_CORE_POOL_BENCH_LOOPS);
+	UTIL_print_string(" ns\n");
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_POOL_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Full pool", T_CORE_POOL_full),
+		new_TestFixture("Double free and foreign addresses", T_CORE_POOL_double_free),
+		new_TestFixture("Get a reserved item", T_CORE_POOL_get),
+		new_TestFixture("Items smaller than a pointer", T_CORE_POOL_small_items),
+		new_TestFixture("Reserve/free benchmark", T_CORE_POOL_benchmark),
+	};
+	UTIL_print_string("\nPool tests:\n");
+	EMB_UNIT_TESTCALLER(poolTest, "POOL_tests", T_CORE_POOL_setUp, T_CORE_POOL_tearDown, fixtures);
+
+	return (TestRef)&poolTest;
+}
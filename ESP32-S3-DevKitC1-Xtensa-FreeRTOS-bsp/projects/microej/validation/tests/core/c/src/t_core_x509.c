@@ -0,0 +1,414 @@
+/*
+ * C
+ *
+ * Copyright 2024 MicroEJ Corp. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be found with this software.
+ */
+#include <string.h>
+#include "../../../../framework/c/embunit/embUnit/embUnit.h"
+#include "../../../../framework/c/utils/inc/u_print.h"
+#include "../../../../framework/c/utils/inc/u_time_base.h"
+
+#include "LLSEC_configuration.h"
+#include "LLSEC_X509_CERT_PATH_helper.h"
+
+/* Private constant declarations */
+
+#define T_CORE_X509_MAX_CERT_SIZE	(512)
+
+/* Private structure declarations */
+
+typedef struct {
+	const uint8_t* der;
+	int32_t length;
+} T_CORE_X509_cert_t;
+
+/* Private variable definitions */
+
+/*
+ * ECDSA P-256 / SHA-256 test chain, valid from 1970-01-01 to 2049-12-31 so that it does not depend on the board
+ * clock. Generated with "openssl ca -startdate 700101000000Z -enddate 491231235959Z" and the following extensions:
+ * root: CA:true, keyCertSign; intermediate: CA:true, pathlen:0, keyCertSign; sub-intermediate: CA:true, keyCertSign;
+ * no keyCertSign CA: CA:true, digitalSignature; end-entity certificates: CA:false, digitalSignature.
+ */
+
+/* Root CA, self-signed */
+static const uint8_t T_CORE_X509_root_der[] = {
+	0x30, 0x82, 0x01, 0x5f, 0x30, 0x82, 0x01, 0x05, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x01,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x17, 0x31, 0x15,
+	0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f,
+	0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30,
+	0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d, 0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33,
+	0x35, 0x39, 0x35, 0x39, 0x5a, 0x30, 0x17, 0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0c, 0x0c, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f, 0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x59,
+	0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48,
+	0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xed, 0x6f, 0x35, 0xc2, 0xd6, 0x08, 0xd1,
+	0xcb, 0xc3, 0x12, 0x8d, 0xe2, 0x0f, 0x92, 0xe2, 0xf5, 0xb6, 0x1c, 0xa4, 0x25, 0x01, 0xef, 0x42,
+	0x06, 0x6a, 0x0e, 0x41, 0x7b, 0x65, 0x81, 0xc8, 0xeb, 0xe9, 0xda, 0x86, 0x92, 0x0e, 0xa2, 0x6a,
+	0x26, 0x14, 0xaf, 0x2d, 0xb0, 0x9f, 0x66, 0xd8, 0xe3, 0x2d, 0xaa, 0xde, 0xff, 0xdd, 0xa3, 0xab,
+	0xa5, 0xc7, 0x5d, 0x79, 0x93, 0xe8, 0xa1, 0xde, 0xba, 0xa3, 0x42, 0x30, 0x40, 0x30, 0x0f, 0x06,
+	0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e,
+	0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d,
+	0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xa8, 0xe3, 0xea, 0xf1, 0xb9, 0xba, 0x66,
+	0xb7, 0x98, 0xe4, 0xa4, 0xea, 0xcf, 0x83, 0xe5, 0x2a, 0xda, 0x0d, 0xe2, 0x23, 0x30, 0x0a, 0x06,
+	0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21,
+	0x00, 0xe9, 0x78, 0x29, 0x9c, 0xb5, 0xcc, 0x7a, 0xe7, 0xb1, 0x0c, 0xcd, 0x9c, 0x9d, 0x70, 0x19,
+	0xc8, 0xb3, 0x64, 0x9e, 0x99, 0xd7, 0x9e, 0x80, 0xc6, 0x29, 0xd2, 0x19, 0x3e, 0xd5, 0xbd, 0xdf,
+	0xf2, 0x02, 0x20, 0x12, 0x29, 0x13, 0x50, 0xf9, 0x9c, 0x94, 0xc9, 0x18, 0xdb, 0x26, 0xab, 0x73,
+	0x46, 0x0b, 0x81, 0x67, 0xbe, 0x9b, 0x81, 0x37, 0x5e, 0xd9, 0xd5, 0x5d, 0x01, 0x47, 0xe9, 0x6c,
+	0x0b, 0xa9, 0xc5
+};
+
+/* Intermediate CA issued by the root, pathLenConstraint 0 */
+static const uint8_t T_CORE_X509_intermediate_der[] = {
+	0x30, 0x82, 0x01, 0x8a, 0x30, 0x82, 0x01, 0x31, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x02,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x17, 0x31, 0x15,
+	0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f,
+	0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30,
+	0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d, 0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33,
+	0x35, 0x39, 0x35, 0x39, 0x5a, 0x30, 0x1f, 0x31, 0x1d, 0x30, 0x1b, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0c, 0x14, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69,
+	0x61, 0x74, 0x65, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce,
+	0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00,
+	0x04, 0x84, 0xe9, 0x31, 0x30, 0x4e, 0xce, 0xa2, 0x50, 0xa6, 0x98, 0xf0, 0x44, 0xf9, 0x5b, 0x3f,
+	0xb7, 0x95, 0xda, 0xec, 0x80, 0x9a, 0x58, 0xd0, 0xdc, 0x5c, 0x19, 0x5b, 0x4e, 0x79, 0xe9, 0x90,
+	0x2a, 0xe8, 0xaa, 0x08, 0xa4, 0x1d, 0xda, 0x02, 0xd3, 0x80, 0xff, 0x3e, 0xaf, 0x09, 0x06, 0xee,
+	0xc7, 0xd9, 0xe3, 0x85, 0x06, 0x01, 0x07, 0xba, 0xd5, 0x89, 0x7b, 0x70, 0x13, 0x40, 0x7b, 0xc2,
+	0xb9, 0xa3, 0x66, 0x30, 0x64, 0x30, 0x12, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04,
+	0x08, 0x30, 0x06, 0x01, 0x01, 0xff, 0x02, 0x01, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f,
+	0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e,
+	0x04, 0x16, 0x04, 0x14, 0x64, 0xdd, 0x5c, 0x1f, 0x0a, 0x80, 0xbd, 0x67, 0xe6, 0x82, 0xd4, 0x3c,
+	0x0f, 0x69, 0xe2, 0x45, 0x44, 0xf5, 0xd5, 0xf5, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04,
+	0x18, 0x30, 0x16, 0x80, 0x14, 0xa8, 0xe3, 0xea, 0xf1, 0xb9, 0xba, 0x66, 0xb7, 0x98, 0xe4, 0xa4,
+	0xea, 0xcf, 0x83, 0xe5, 0x2a, 0xda, 0x0d, 0xe2, 0x23, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48,
+	0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x59, 0x0c, 0xe3, 0xed,
+	0x26, 0x0f, 0x14, 0x47, 0x49, 0x27, 0x12, 0x38, 0x14, 0xfb, 0x6b, 0x18, 0x94, 0x7b, 0xb1, 0xd3,
+	0x8a, 0x58, 0xe2, 0x61, 0x88, 0xa9, 0x83, 0x56, 0xa0, 0x73, 0x87, 0x72, 0x02, 0x20, 0x7b, 0x61,
+	0x37, 0xe0, 0x2b, 0x39, 0x5c, 0x8e, 0x26, 0x6f, 0xd2, 0x95, 0xab, 0x70, 0x49, 0x1c, 0x60, 0xa7,
+	0xc8, 0x6c, 0xd1, 0xc3, 0x78, 0x48, 0x1d, 0x37, 0xc8, 0xab, 0x6d, 0x55, 0xa2, 0xf5
+};
+
+/* End-entity certificate issued by the intermediate CA */
+static const uint8_t T_CORE_X509_leaf_der[] = {
+	0x30, 0x82, 0x01, 0x81, 0x30, 0x82, 0x01, 0x28, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x03,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x1f, 0x31, 0x1d,
+	0x30, 0x1b, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x14, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e,
+	0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17,
+	0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d,
+	0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33, 0x35, 0x39, 0x35, 0x39, 0x5a, 0x30, 0x14, 0x31,
+	0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4c,
+	0x65, 0x61, 0x66, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+	0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xef, 0x19,
+	0xec, 0x78, 0xc7, 0x4b, 0x0b, 0x9f, 0xbb, 0x25, 0x2a, 0xbb, 0xc0, 0xb8, 0x57, 0x91, 0xcf, 0x2e,
+	0x02, 0xd2, 0x91, 0xae, 0x80, 0x5c, 0x04, 0x02, 0xd8, 0xc3, 0x1f, 0xa7, 0x13, 0x0f, 0x40, 0x89,
+	0x64, 0x3b, 0xf2, 0x94, 0x82, 0xe4, 0xdf, 0x9d, 0xf6, 0x6c, 0xf3, 0x3c, 0x75, 0x9d, 0x1e, 0x4d,
+	0xd3, 0x32, 0x1b, 0xe0, 0x8c, 0x79, 0x24, 0x2c, 0xce, 0x13, 0xd8, 0x33, 0x7c, 0xea, 0xa3, 0x60,
+	0x30, 0x5e, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00,
+	0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80,
+	0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xe7, 0x8f, 0xa2, 0xa0, 0x03,
+	0x8f, 0x62, 0x7c, 0x8b, 0xce, 0x62, 0xc2, 0x86, 0x22, 0x36, 0x59, 0xf1, 0x83, 0xc2, 0x78, 0x30,
+	0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x64, 0xdd, 0x5c, 0x1f,
+	0x0a, 0x80, 0xbd, 0x67, 0xe6, 0x82, 0xd4, 0x3c, 0x0f, 0x69, 0xe2, 0x45, 0x44, 0xf5, 0xd5, 0xf5,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00, 0x30,
+	0x44, 0x02, 0x20, 0x41, 0xb3, 0x54, 0x15, 0xd8, 0xc7, 0x1b, 0x78, 0x63, 0xaf, 0x1c, 0x21, 0x24,
+	0x0f, 0xbb, 0x71, 0xff, 0x9c, 0xde, 0x4e, 0x68, 0xbc, 0xc3, 0xb5, 0x50, 0x7f, 0xf5, 0xf0, 0x7b,
+	0x66, 0x0d, 0xec, 0x02, 0x20, 0x17, 0x63, 0xb0, 0xfd, 0x90, 0xdb, 0xd6, 0xf7, 0x0a, 0x3e, 0x03,
+	0xea, 0x3d, 0x57, 0xb7, 0xb3, 0x07, 0x9f, 0x39, 0x29, 0xe3, 0xbf, 0xd6, 0xd8, 0x22, 0x46, 0x09,
+	0xdc, 0x03, 0xa3, 0x67, 0x93
+};
+
+/* CA issued by the intermediate CA, which violates its pathLenConstraint */
+static const uint8_t T_CORE_X509_sub_intermediate_der[] = {
+	0x30, 0x82, 0x01, 0x94, 0x30, 0x82, 0x01, 0x3a, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x04,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x1f, 0x31, 0x1d,
+	0x30, 0x1b, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x14, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e,
+	0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17,
+	0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d,
+	0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33, 0x35, 0x39, 0x35, 0x39, 0x5a, 0x30, 0x23, 0x31,
+	0x21, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x18, 0x54, 0x65, 0x73, 0x74, 0x20, 0x53,
+	0x75, 0x62, 0x20, 0x49, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x20,
+	0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+	0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xae, 0x10, 0xb8,
+	0x63, 0x6f, 0xe3, 0x61, 0x68, 0x43, 0x07, 0xaa, 0x80, 0x52, 0xc0, 0x1f, 0x34, 0xc6, 0x83, 0xa6,
+	0x82, 0x21, 0xc1, 0xa4, 0xe7, 0x1a, 0xa8, 0xc0, 0x98, 0x27, 0xf3, 0x76, 0x17, 0xfc, 0x96, 0xb0,
+	0x9a, 0xfd, 0xf2, 0x73, 0x7a, 0x47, 0x95, 0x53, 0xe3, 0xe2, 0x00, 0x73, 0xf2, 0x86, 0x8b, 0xc7,
+	0xd4, 0x2d, 0x14, 0xa1, 0x01, 0x3b, 0xda, 0xf1, 0x2d, 0x1d, 0x1b, 0x66, 0x84, 0xa3, 0x63, 0x30,
+	0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01,
+	0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02,
+	0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x2e, 0xca, 0xa8,
+	0x02, 0xdd, 0x75, 0xdd, 0x16, 0x2f, 0x03, 0xcc, 0x96, 0xbb, 0x9e, 0x58, 0x02, 0x60, 0x2f, 0x85,
+	0xba, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x64, 0xdd,
+	0x5c, 0x1f, 0x0a, 0x80, 0xbd, 0x67, 0xe6, 0x82, 0xd4, 0x3c, 0x0f, 0x69, 0xe2, 0x45, 0x44, 0xf5,
+	0xd5, 0xf5, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48,
+	0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xf3, 0xb2, 0x45, 0xc3, 0x9a, 0x6e, 0x4e, 0x6a, 0xe1, 0x29,
+	0xe2, 0x0d, 0x44, 0xcc, 0x82, 0x95, 0x96, 0x58, 0x26, 0x40, 0x9f, 0xbd, 0x35, 0x33, 0x08, 0x38,
+	0x7b, 0x92, 0x66, 0x15, 0x2e, 0x88, 0x02, 0x20, 0x18, 0x60, 0x23, 0xf0, 0x66, 0x20, 0x9a, 0x32,
+	0x13, 0xf7, 0x7d, 0xf5, 0x91, 0x15, 0x27, 0xaf, 0xe3, 0x21, 0xc4, 0x07, 0xb6, 0x59, 0x01, 0x4b,
+	0x40, 0x84, 0x73, 0xbf, 0xb2, 0x4b, 0x28, 0xb2
+};
+
+/* End-entity certificate issued by the sub-intermediate CA */
+static const uint8_t T_CORE_X509_deep_leaf_der[] = {
+	0x30, 0x82, 0x01, 0x8a, 0x30, 0x82, 0x01, 0x31, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x05,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x23, 0x31, 0x21,
+	0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x18, 0x54, 0x65, 0x73, 0x74, 0x20, 0x53, 0x75,
+	0x62, 0x20, 0x49, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x20, 0x43,
+	0x41, 0x30, 0x1e, 0x17, 0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30,
+	0x30, 0x5a, 0x17, 0x0d, 0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33, 0x35, 0x39, 0x35, 0x39,
+	0x5a, 0x30, 0x19, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x54, 0x65,
+	0x73, 0x74, 0x20, 0x44, 0x65, 0x65, 0x70, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x30, 0x59, 0x30, 0x13,
+	0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+	0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xc3, 0xc7, 0x1f, 0x94, 0xb1, 0x85, 0x45, 0x54, 0x7e,
+	0x77, 0x02, 0xfd, 0x87, 0xa8, 0x5a, 0x5b, 0xf5, 0xe0, 0x18, 0x10, 0xbb, 0x3b, 0x4a, 0xe9, 0x5f,
+	0x0f, 0xb3, 0xc9, 0x2a, 0x17, 0x2f, 0xf9, 0x7e, 0x47, 0x77, 0x02, 0xab, 0x23, 0x2b, 0x46, 0x7a,
+	0x46, 0xc3, 0x6f, 0x6d, 0xf1, 0x3f, 0x61, 0x70, 0xc4, 0x5f, 0x49, 0x4e, 0x04, 0x61, 0x99, 0x46,
+	0x0a, 0x81, 0x81, 0xcd, 0x79, 0x77, 0x1f, 0xa3, 0x60, 0x30, 0x5e, 0x30, 0x0c, 0x06, 0x03, 0x55,
+	0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f,
+	0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e,
+	0x04, 0x16, 0x04, 0x14, 0x20, 0xb0, 0xd3, 0xf0, 0x12, 0x81, 0xb1, 0xbc, 0x1f, 0xba, 0x7d, 0x3f,
+	0x96, 0xdc, 0x6a, 0xa6, 0x3f, 0xd3, 0xa8, 0x53, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04,
+	0x18, 0x30, 0x16, 0x80, 0x14, 0x2e, 0xca, 0xa8, 0x02, 0xdd, 0x75, 0xdd, 0x16, 0x2f, 0x03, 0xcc,
+	0x96, 0xbb, 0x9e, 0x58, 0x02, 0x60, 0x2f, 0x85, 0xba, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48,
+	0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x0a, 0x43, 0x16, 0x90,
+	0x4e, 0x19, 0x98, 0xe5, 0xd8, 0xc8, 0x22, 0x04, 0x46, 0xba, 0xe4, 0x3f, 0xbf, 0xad, 0xac, 0x30,
+	0x64, 0x50, 0xd9, 0x37, 0x78, 0x68, 0x9b, 0x50, 0xa9, 0xab, 0xb9, 0x1f, 0x02, 0x20, 0x6f, 0x06,
+	0xd1, 0x1b, 0x11, 0x5a, 0xd6, 0xad, 0x43, 0x78, 0xf4, 0x05, 0x38, 0x69, 0x51, 0x58, 0x45, 0x42,
+	0x83, 0x1e, 0x2b, 0x86, 0x80, 0x74, 0x2e, 0xfd, 0xe1, 0x96, 0x07, 0x6b, 0x35, 0x94
+};
+
+/* CA issued by the root whose key usage is digitalSignature only */
+static const uint8_t T_CORE_X509_no_key_cert_sign_der[] = {
+	0x30, 0x82, 0x01, 0x89, 0x30, 0x82, 0x01, 0x30, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x06,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x17, 0x31, 0x15,
+	0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f,
+	0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30,
+	0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d, 0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33,
+	0x35, 0x39, 0x35, 0x39, 0x5a, 0x30, 0x21, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0c, 0x16, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4e, 0x6f, 0x20, 0x4b, 0x65, 0x79, 0x43, 0x65, 0x72,
+	0x74, 0x53, 0x69, 0x67, 0x6e, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86,
+	0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+	0x42, 0x00, 0x04, 0x33, 0x09, 0xca, 0xfd, 0xba, 0x0e, 0x2b, 0x5c, 0x1c, 0x60, 0x20, 0x42, 0x36,
+	0xa5, 0xb6, 0x3b, 0x34, 0xce, 0x35, 0x79, 0x3f, 0xb8, 0xab, 0x0a, 0x7e, 0xd7, 0xd9, 0x76, 0x6a,
+	0x98, 0xef, 0x66, 0x47, 0x59, 0xfd, 0x00, 0x3e, 0xc4, 0x89, 0x44, 0x3d, 0x7b, 0x06, 0xe8, 0x4a,
+	0x21, 0xb1, 0xcb, 0xf2, 0xd7, 0x62, 0x20, 0x9d, 0xdc, 0x54, 0xe6, 0x42, 0x50, 0x1b, 0x8b, 0x7f,
+	0xfb, 0x37, 0xb8, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01,
+	0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01,
+	0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04,
+	0x16, 0x04, 0x14, 0xe6, 0x79, 0x7a, 0x9c, 0xc4, 0x34, 0x37, 0xde, 0x2b, 0xfc, 0xe6, 0x1f, 0xc5,
+	0xc1, 0x28, 0x11, 0x6a, 0x2e, 0x20, 0xd9, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18,
+	0x30, 0x16, 0x80, 0x14, 0xa8, 0xe3, 0xea, 0xf1, 0xb9, 0xba, 0x66, 0xb7, 0x98, 0xe4, 0xa4, 0xea,
+	0xcf, 0x83, 0xe5, 0x2a, 0xda, 0x0d, 0xe2, 0x23, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce,
+	0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x5d, 0x70, 0xd3, 0xf2, 0x76,
+	0x75, 0xba, 0xdb, 0xf3, 0x8d, 0xbd, 0xd0, 0xd5, 0x19, 0x80, 0xa8, 0x46, 0x28, 0x95, 0xb0, 0xbb,
+	0xde, 0xb7, 0xb0, 0xf8, 0x12, 0x3e, 0xc3, 0xa9, 0xa4, 0x74, 0xf3, 0x02, 0x20, 0x12, 0x56, 0xfd,
+	0x91, 0x66, 0xe0, 0xcd, 0xe0, 0x24, 0x41, 0xe4, 0x66, 0x71, 0x89, 0x7e, 0xd4, 0x95, 0x10, 0x70,
+	0x53, 0xfd, 0xaf, 0xff, 0x12, 0x83, 0x65, 0xdd, 0x69, 0x63, 0xd2, 0x92, 0x9e
+};
+
+/* End-entity certificate issued by the digitalSignature-only CA */
+static const uint8_t T_CORE_X509_no_key_cert_sign_leaf_der[] = {
+	0x30, 0x82, 0x01, 0x93, 0x30, 0x82, 0x01, 0x39, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x07,
+	0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x21, 0x31, 0x1f,
+	0x30, 0x1d, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x16, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4e, 0x6f,
+	0x20, 0x4b, 0x65, 0x79, 0x43, 0x65, 0x72, 0x74, 0x53, 0x69, 0x67, 0x6e, 0x20, 0x43, 0x41, 0x30,
+	0x1e, 0x17, 0x0d, 0x37, 0x30, 0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a,
+	0x17, 0x0d, 0x34, 0x39, 0x31, 0x32, 0x33, 0x31, 0x32, 0x33, 0x35, 0x39, 0x35, 0x39, 0x5a, 0x30,
+	0x23, 0x31, 0x21, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x18, 0x54, 0x65, 0x73, 0x74,
+	0x20, 0x4e, 0x6f, 0x20, 0x4b, 0x65, 0x79, 0x43, 0x65, 0x72, 0x74, 0x53, 0x69, 0x67, 0x6e, 0x20,
+	0x4c, 0x65, 0x61, 0x66, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+	0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xd6,
+	0xc0, 0x9e, 0x24, 0x1e, 0x81, 0x3b, 0x9e, 0x91, 0xfc, 0x3b, 0x78, 0x45, 0x49, 0x2f, 0xda, 0x8c,
+	0x90, 0xeb, 0x2d, 0xfa, 0x78, 0xb0, 0xbc, 0x63, 0xea, 0xff, 0x1e, 0x13, 0x1d, 0x8a, 0x28, 0x2c,
+	0xae, 0x33, 0x2f, 0xcb, 0x38, 0x9a, 0xe9, 0xab, 0x40, 0x9e, 0x09, 0x84, 0x30, 0xbd, 0xbf, 0x20,
+	0x50, 0x94, 0xc5, 0xa7, 0xe9, 0xf5, 0x6d, 0xde, 0x6d, 0xf6, 0x5c, 0x42, 0x87, 0xe3, 0xd3, 0xa3,
+	0x60, 0x30, 0x5e, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30,
+	0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07,
+	0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x80, 0x58, 0x3a, 0xee,
+	0x9a, 0xee, 0xc1, 0x89, 0x1f, 0x33, 0x88, 0xaa, 0xc7, 0x8f, 0x59, 0x85, 0x04, 0xe1, 0xe1, 0x2e,
+	0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0xe6, 0x79, 0x7a,
+	0x9c, 0xc4, 0x34, 0x37, 0xde, 0x2b, 0xfc, 0xe6, 0x1f, 0xc5, 0xc1, 0x28, 0x11, 0x6a, 0x2e, 0x20,
+	0xd9, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00,
+	0x30, 0x45, 0x02, 0x20, 0x5a, 0xa8, 0x7d, 0x74, 0xe7, 0xaa, 0x8b, 0xd7, 0x50, 0x3c, 0x65, 0x78,
+	0xd7, 0xcc, 0x8b, 0x36, 0x99, 0x20, 0xd6, 0xe5, 0xaf, 0xc9, 0x77, 0x80, 0x49, 0xd9, 0xd4, 0x4d,
+	0x88, 0x5a, 0x5d, 0xae, 0x02, 0x21, 0x00, 0xcf, 0xf2, 0x29, 0xb6, 0xff, 0x17, 0xf9, 0xde, 0x94,
+	0xa0, 0x44, 0xed, 0xcb, 0x66, 0x1c, 0x8b, 0x7e, 0x10, 0xdb, 0xdb, 0x45, 0x51, 0x44, 0x5b, 0x6f,
+	0x69, 0x09, 0x0e, 0x9c, 0x97, 0x06, 0x74
+};
+
+#define T_CORE_X509_CERT(der)	{ (der), (int32_t)sizeof(der) }
+
+static const T_CORE_X509_cert_t T_CORE_X509_root = T_CORE_X509_CERT(T_CORE_X509_root_der);
+static const T_CORE_X509_cert_t T_CORE_X509_intermediate = T_CORE_X509_CERT(T_CORE_X509_intermediate_der);
+static const T_CORE_X509_cert_t T_CORE_X509_leaf = T_CORE_X509_CERT(T_CORE_X509_leaf_der);
+static const T_CORE_X509_cert_t T_CORE_X509_sub_intermediate = T_CORE_X509_CERT(T_CORE_X509_sub_intermediate_der);
+static const T_CORE_X509_cert_t T_CORE_X509_deep_leaf = T_CORE_X509_CERT(T_CORE_X509_deep_leaf_der);
+static const T_CORE_X509_cert_t T_CORE_X509_no_key_cert_sign = T_CORE_X509_CERT(T_CORE_X509_no_key_cert_sign_der);
+static const T_CORE_X509_cert_t T_CORE_X509_no_key_cert_sign_leaf = T_CORE_X509_CERT(T_CORE_X509_no_key_cert_sign_leaf_der);
+
+/* The end-entity certificate with the last byte of its signature flipped */
+static uint8_t T_CORE_X509_broken_leaf_der[sizeof(T_CORE_X509_leaf_der)];
+static const T_CORE_X509_cert_t T_CORE_X509_broken_leaf = T_CORE_X509_CERT(T_CORE_X509_broken_leaf_der);
+
+/* Concatenated certificates given to LLSEC_X509_CERT_PATH_validate() */
+static int8_t T_CORE_X509_chain[LLSEC_X509_CERT_PATH_MAX_LENGTH * T_CORE_X509_MAX_CERT_SIZE];
+static int32_t T_CORE_X509_chain_lengths[LLSEC_X509_CERT_PATH_MAX_LENGTH];
+static int8_t T_CORE_X509_anchor[T_CORE_X509_MAX_CERT_SIZE];
+
+/* Private function declarations */
+
+static void T_CORE_X509_setUp(void);
+static void T_CORE_X509_tearDown(void);
+static int32_t T_CORE_X509_validate(const T_CORE_X509_cert_t* const* chain, int32_t count, const T_CORE_X509_cert_t* anchor);
+static uint8_t T_CORE_X509_is_link_verified(const T_CORE_X509_cert_t* issuer, const T_CORE_X509_cert_t* subject);
+static void T_CORE_X509_good_chain(void);
+static void T_CORE_X509_broken_signature(void);
+static void T_CORE_X509_path_length_violation(void);
+static void T_CORE_X509_missing_key_cert_sign(void);
+static void T_CORE_X509_cache_hit(void);
+static void T_CORE_X509_no_cache_after_failure(void);
+
+/* Private function definitions */
+
+static void T_CORE_X509_setUp(void)
+{
+	UTIL_TIME_BASE_initialize();
+	(void)memcpy(T_CORE_X509_broken_leaf_der, T_CORE_X509_leaf_der, sizeof(T_CORE_X509_leaf_der));
+	T_CORE_X509_broken_leaf_der[sizeof(T_CORE_X509_broken_leaf_der) - 1] ^= (uint8_t)0x01;
+	LLSEC_X509_CERT_PATH_clear_cache();
+}
+
+static void T_CORE_X509_tearDown(void)
+{
+	LLSEC_X509_CERT_PATH_clear_cache();
+}
+
+/**
+ * @brief Validates the given chain, end-entity certificate first, against a single trust anchor.
+ */
+static int32_t T_CORE_X509_validate(const T_CORE_X509_cert_t* const* chain, int32_t count, const T_CORE_X509_cert_t* anchor)
+{
+	int32_t offset = 0;
+	int32_t anchor_length = anchor->length;
+	int32_t i;
+
+	for (i = 0; i < count; i++) {
+		(void)memcpy(&T_CORE_X509_chain[offset], chain[i]->der, chain[i]->length);
+		T_CORE_X509_chain_lengths[i] = chain[i]->length;
+		offset += chain[i]->length;
+	}
+	(void)memcpy(T_CORE_X509_anchor, anchor->der, anchor->length);
+
+	return LLSEC_X509_CERT_PATH_validate(T_CORE_X509_chain, T_CORE_X509_chain_lengths, count,
+	                                     T_CORE_X509_anchor, &anchor_length, 1);
+}
+
+static uint8_t T_CORE_X509_is_link_verified(const T_CORE_X509_cert_t* issuer, const T_CORE_X509_cert_t* subject)
+{
+	return LLSEC_X509_CERT_PATH_is_link_verified(issuer->der, issuer->length, subject->der, subject->length);
+}
+
+static void T_CORE_X509_good_chain(void)
+{
+	const T_CORE_X509_cert_t* chain[] = { &T_CORE_X509_leaf, &T_CORE_X509_intermediate };
+	const T_CORE_X509_cert_t* anchor_only[] = { &T_CORE_X509_root };
+
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == T_CORE_X509_validate(chain, 2, &T_CORE_X509_root), "good chain rejected");
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == T_CORE_X509_validate(chain, 1, &T_CORE_X509_intermediate), "chain ending below a trusted intermediate rejected");
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == T_CORE_X509_validate(anchor_only, 1, &T_CORE_X509_root), "trusted certificate rejected");
+	TEST_ASSERT_MESSAGE(J_NO_TRUSTED_CERT == T_CORE_X509_validate(chain, 2, &T_CORE_X509_no_key_cert_sign), "chain accepted by an unrelated anchor");
+}
+
+static void T_CORE_X509_broken_signature(void)
+{
+	const T_CORE_X509_cert_t* chain[] = { &T_CORE_X509_broken_leaf, &T_CORE_X509_intermediate };
+
+	TEST_ASSERT_MESSAGE(J_VERIFY_CERT_ERROR == T_CORE_X509_validate(chain, 2, &T_CORE_X509_root), "broken signature not detected");
+}
+
+static void T_CORE_X509_path_length_violation(void)
+{
+	const T_CORE_X509_cert_t* chain[] = { &T_CORE_X509_deep_leaf, &T_CORE_X509_sub_intermediate, &T_CORE_X509_intermediate };
+	const T_CORE_X509_cert_t* short_chain[] = { &T_CORE_X509_deep_leaf };
+
+	TEST_ASSERT_MESSAGE(J_MAX_CHAIN_ERROR == T_CORE_X509_validate(chain, 3, &T_CORE_X509_root), "pathLenConstraint violation not detected");
+	/* The path is accepted when it does not go through the constrained CA */
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == T_CORE_X509_validate(short_chain, 1, &T_CORE_X509_sub_intermediate), "chain below the sub-intermediate CA rejected");
+}
+
+static void T_CORE_X509_missing_key_cert_sign(void)
+{
+#if defined(MBEDTLS_X509_CHECK_KEY_USAGE)
+	const T_CORE_X509_cert_t* chain[] = { &T_CORE_X509_no_key_cert_sign_leaf, &T_CORE_X509_no_key_cert_sign };
+
+	TEST_ASSERT_MESSAGE(J_NOT_CA_CERT == T_CORE_X509_validate(chain, 2, &T_CORE_X509_root), "CA without keyCertSign accepted");
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_no_key_cert_sign, &T_CORE_X509_no_key_cert_sign_leaf), "rejected link cached");
+#else
+	UTIL_print_string("MBEDTLS_X509_CHECK_KEY_USAGE is not defined: key usage not checked\n");
+#endif
+}
+
+static void T_CORE_X509_cache_hit(void)
+{
+	const T_CORE_X509_cert_t* chain[] = { &T_CORE_X509_leaf, &T_CORE_X509_intermediate };
+
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_intermediate, &T_CORE_X509_leaf), "link cached before validation");
+
+	int64_t start_time = UTIL_TIME_BASE_getTime();
+	int32_t first_result = T_CORE_X509_validate(chain, 2, &T_CORE_X509_root);
+	int64_t first_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == first_result, "good chain rejected");
+	TEST_ASSERT_MESSAGE(1 == T_CORE_X509_is_link_verified(&T_CORE_X509_intermediate, &T_CORE_X509_leaf), "verified link not cached");
+	TEST_ASSERT_MESSAGE(1 == T_CORE_X509_is_link_verified(&T_CORE_X509_root, &T_CORE_X509_intermediate), "verified anchor link not cached");
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_root, &T_CORE_X509_leaf), "unrelated link cached");
+
+	uint32_t hit_count = LLSEC_X509_CERT_PATH_get_cache_hit_count();
+	start_time = UTIL_TIME_BASE_getTime();
+	int32_t second_result = T_CORE_X509_validate(chain, 2, &T_CORE_X509_root);
+	int64_t second_time = UTIL_TIME_BASE_getTime() - start_time;
+	TEST_ASSERT_MESSAGE(J_SEC_NO_ERROR == second_result, "good chain rejected from the cache");
+	/* Both links (leaf to intermediate, intermediate to root) must come from the cache */
+	TEST_ASSERT_MESSAGE(2 == (LLSEC_X509_CERT_PATH_get_cache_hit_count() - hit_count), "signature checked again for a cached link");
+
+	UTIL_print_string("Chain of 2 + anchor, signatures checked: ");
+	UTIL_print_integer((int)first_time);
+	UTIL_print_string(" us, links cached: ");
+	UTIL_print_integer((int)second_time);
+	UTIL_print_string(" us\n");
+}
+
+static void T_CORE_X509_no_cache_after_failure(void)
+{
+	const T_CORE_X509_cert_t* broken_chain[] = { &T_CORE_X509_broken_leaf, &T_CORE_X509_intermediate };
+	const T_CORE_X509_cert_t* deep_chain[] = { &T_CORE_X509_deep_leaf, &T_CORE_X509_sub_intermediate, &T_CORE_X509_intermediate };
+
+	TEST_ASSERT_MESSAGE(J_VERIFY_CERT_ERROR == T_CORE_X509_validate(broken_chain, 2, &T_CORE_X509_root), "broken signature not detected");
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_intermediate, &T_CORE_X509_broken_leaf), "link with a broken signature cached");
+	/* Validation stops at the first failed link */
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_root, &T_CORE_X509_intermediate), "link after the failed one cached");
+	/* A failure must not be remembered either: the second attempt checks the signature again */
+	uint32_t hit_count = LLSEC_X509_CERT_PATH_get_cache_hit_count();
+	TEST_ASSERT_MESSAGE(J_VERIFY_CERT_ERROR == T_CORE_X509_validate(broken_chain, 2, &T_CORE_X509_root), "broken signature accepted on retry");
+	TEST_ASSERT_MESSAGE(hit_count == LLSEC_X509_CERT_PATH_get_cache_hit_count(), "failed link found in the cache");
+
+	TEST_ASSERT_MESSAGE(J_MAX_CHAIN_ERROR == T_CORE_X509_validate(deep_chain, 3, &T_CORE_X509_root), "pathLenConstraint violation not detected");
+	TEST_ASSERT_MESSAGE(1 == T_CORE_X509_is_link_verified(&T_CORE_X509_sub_intermediate, &T_CORE_X509_deep_leaf), "valid link before the failed one not cached");
+	TEST_ASSERT_MESSAGE(0 == T_CORE_X509_is_link_verified(&T_CORE_X509_intermediate, &T_CORE_X509_sub_intermediate), "link violating the pathLenConstraint cached");
+}
+
+/* Public function definitions */
+
+TestRef T_CORE_X509_tests(void)
+{
+	EMB_UNIT_TESTFIXTURES(fixtures) {
+		new_TestFixture("Good certificate chain", T_CORE_X509_good_chain),
+		new_TestFixture("Broken signature", T_CORE_X509_broken_signature),
+		new_TestFixture("Path length constraint violation", T_CORE_X509_path_length_violation),
+		new_TestFixture("CA without keyCertSign", T_CORE_X509_missing_key_cert_sign),
+		new_TestFixture("Link cache hit after a good link", T_CORE_X509_cache_hit),
+		new_TestFixture("No link cache entry after a failed link", T_CORE_X509_no_cache_after_failure),
+	};
+	UTIL_print_string("\nX509 certificate path tests:\n");
+	EMB_UNIT_TESTCALLER(x509Test, "X509_tests", T_CORE_X509_setUp, T_CORE_X509_tearDown, fixtures);
+
+	return (TestRef)&x509Test;
+}